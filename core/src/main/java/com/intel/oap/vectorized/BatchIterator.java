@@ -22,6 +22,7 @@ import org.apache.arrow.vector.ipc.message.ArrowRecordBatch;
 import org.apache.arrow.vector.types.pojo.Schema;
 import java.util.List;
 import io.netty.buffer.ArrowBuf;
+import org.apache.arrow.dataset.jni.NativeMemoryPool;
 import java.io.ByteArrayOutputStream;
 import java.nio.channels.Channels;
 import org.apache.arrow.gandiva.evaluator.SelectionVectorInt16;
@@ -31,6 +32,7 @@ import org.apache.arrow.vector.ipc.message.MessageSerializer;
 
 public class BatchIterator implements AutoCloseable {
   private native boolean nativeHasNext(long nativeHandler);
+  private native boolean nativeHasFlushedOutput(long nativeHandler);
   private native ArrowRecordBatchBuilder nativeNext(long nativeHandler);
   private native MetricsObject nativeFetchMetrics(long nativeHandler);
   private native ArrowRecordBatchBuilder nativeProcess(long nativeHandler,
@@ -48,6 +50,12 @@ public class BatchIterator implements AutoCloseable {
   private native void nativeSetHashRelation(
       long nativeHandler, long[] memoryAddrs, int[] sizes);
   private native void nativeClose(long nativeHandler);
+  private static native long nativeAcquireCachedHashRelation(long relationId);
+  private native long nativePublishCachedHashRelation(long nativeHandler, long relationId);
+  private static native void nativeAbortCachedHashRelation(long relationId);
+  private static native void nativeEvictCachedHashRelation(long relationId);
+  private static native void nativeSetCachedHashRelationPool(
+      long memoryPool, long capacity);
 
   private long nativeHandler = 0;
   private boolean closed = false;
@@ -63,6 +71,14 @@ public class BatchIterator implements AutoCloseable {
     return nativeHasNext(nativeHandler);
   }
 
+  /**
+   * Whether next() can return output before all input is processed, e.g. groups a
+   * partial aggregate flushed to bound its memory.
+   */
+  public boolean hasFlushedOutput() throws IOException {
+    return nativeHasFlushedOutput(nativeHandler);
+  }
+
   public ArrowRecordBatch next() throws IOException {
     if (nativeHandler == 0) {
       return null;
@@ -101,6 +117,56 @@ public class BatchIterator implements AutoCloseable {
     nativeSetHashRelation(nativeHandler, obj.getDirectMemoryAddrs(), obj.size);
   }
 
+  /**
+   * Acquire the hash relation shared by all tasks of this executor.
+   *
+   * @param relationId executor-local id of the broadcast relation.
+   * @return iterator over the cached relation, or null if the caller is elected to build
+   *     it, in which case publishCachedHashRelation or abortCachedHashRelation must be
+   *     called afterwards.
+   */
+  public static BatchIterator acquireCachedHashRelation(long relationId)
+      throws IOException {
+    JniUtils.getInstance();
+    long instanceId = nativeAcquireCachedHashRelation(relationId);
+    if (instanceId < 0) {
+      return null;
+    }
+    return new BatchIterator(instanceId);
+  }
+
+  /**
+   * Publish the hash relation built by this iterator to the executor cache.
+   *
+   * @return iterator over the cached relation, holding one reference until closed.
+   */
+  public BatchIterator publishCachedHashRelation(long relationId) throws IOException {
+    return new BatchIterator(nativePublishCachedHashRelation(nativeHandler, relationId));
+  }
+
+  public static void abortCachedHashRelation(long relationId) throws IOException {
+    JniUtils.getInstance();
+    nativeAbortCachedHashRelation(relationId);
+  }
+
+  public static void evictCachedHashRelation(long relationId) throws IOException {
+    JniUtils.getInstance();
+    nativeEvictCachedHashRelation(relationId);
+  }
+
+  /**
+   * Set the pool cached hash relations are moved to.
+   *
+   * @param memoryPool pool reporting to the JVM, it must outlive the executor cache.
+   * @param capacity bytes of cached relations, 0 means only limited by memoryPool. Unused
+   *     relations are evicted to make room for new ones.
+   */
+  public static void setCachedHashRelationPool(NativeMemoryPool memoryPool, long capacity)
+      throws IOException {
+    JniUtils.getInstance();
+    nativeSetCachedHashRelationPool(memoryPool.getNativeInstanceId(), capacity);
+  }
+
   public ArrowRecordBatch process(Schema schema, ArrowRecordBatch recordBatch)
       throws IOException {
     return process(schema, recordBatch, null);
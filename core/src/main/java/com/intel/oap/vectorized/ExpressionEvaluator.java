@@ -22,6 +22,7 @@ import com.intel.oap.spark.sql.execution.datasources.v2.arrow.Spiller;
 import io.netty.buffer.ArrowBuf;
 import java.io.ByteArrayOutputStream;
 import java.io.IOException;
+import java.lang.reflect.Field;
 import java.nio.channels.Channels;
 import java.util.List;
 
@@ -56,9 +57,64 @@ public class ExpressionEvaluator implements AutoCloseable {
     jniWrapper.nativeSetJavaTmpDir(jniWrapper.tmp_dir_path);
     jniWrapper.nativeSetBatchSize(ColumnarPluginConfig.getBatchSize());
     jniWrapper.nativeSetMetricsTime(ColumnarPluginConfig.getEnableMetricsTime());
+    jniWrapper.nativeSetBatchAccumulate(ColumnarPluginConfig.getEnableBatchAccumulate());
+    jniWrapper.nativeSetAdaptiveAggregate(ColumnarPluginConfig.getEnableAdaptiveAggregate(),
+        ColumnarPluginConfig.getAdaptiveAggregateMinRows(),
+        ColumnarPluginConfig.getAdaptiveAggregateRatio(),
+        ColumnarPluginConfig.getAggregateMemoryBudget());
+    jniWrapper.nativeSetAggregateThreads(ColumnarPluginConfig.getAggregateThreads());
+    jniWrapper.nativeSetDistinctAggregateMemoryBudget(
+        ColumnarPluginConfig.getDistinctAggregateMemoryBudget());
+    jniWrapper.nativeSetKahanSum(ColumnarPluginConfig.getEnableKahanSum());
+    jniWrapper.nativeSetSortNormalizedKey(
+        ColumnarPluginConfig.getEnableSortNormalizedKey());
+    jniWrapper.nativeSetSortThreads(ColumnarPluginConfig.getSortThreads());
+    setHllBiasData(jniWrapper);
     ColumnarPluginConfig.setRandomTempDir(jniWrapper.tmp_dir_path);
   }
 
+  private static boolean hllBiasDataSet = false;
+
+  /**
+   * Hands Spark's own HyperLogLog++ bias tables over to native code once, so that
+   * approx_count_distinct estimates are the same as Spark's. Native code keeps its
+   * built-in tables if Spark's can't be read.
+   */
+  private static synchronized void setHllBiasData(ExpressionEvaluatorJniWrapper jniWrapper) {
+    if (hllBiasDataSet) {
+      return;
+    }
+    hllBiasDataSet = true;
+    double[][] rawEstimateData = readSparkHllData("RAW_ESTIMATE_DATA");
+    double[][] biasData = readSparkHllData("BIAS_DATA");
+    if (rawEstimateData != null && biasData != null) {
+      jniWrapper.nativeSetHllBiasData(rawEstimateData, biasData);
+    }
+  }
+
+  /** Private table of Spark's HyperLogLog++ object, null if it is not found. */
+  private static double[][] readSparkHllData(String name) {
+    String[] classNames = {
+        "org.apache.spark.sql.catalyst.util.HyperLogLogPlusPlusHelper$",
+        "org.apache.spark.sql.catalyst.expressions.aggregate.HyperLogLogPlusPlus$"};
+    for (String className : classNames) {
+      try {
+        Class<?> cls = Class.forName(className);
+        Object module = cls.getField("MODULE$").get(null);
+        for (Field field : cls.getDeclaredFields()) {
+          // scalac may expand the name of a private member used by the companion class
+          if (field.getName().endsWith(name) && field.getType() == double[][].class) {
+            field.setAccessible(true);
+            return (double[][]) field.get(module);
+          }
+        }
+      } catch (ReflectiveOperationException | RuntimeException e) {
+        // not in this Spark version, try the next one
+      }
+    }
+    return null;
+  }
+
   long getInstanceId() {
     return nativeHandler;
   }
@@ -233,6 +289,22 @@ public class ExpressionEvaluator implements AutoCloseable {
     jniWrapper.nativeSetDependency(nativeHandler, child.getInstanceId(), index);
   }
 
+  /** Bytes of native memory the evaluator holds now. */
+  public long getBytesAllocated() throws RuntimeException {
+    if (nativeHandler == 0) {
+      return 0;
+    }
+    return jniWrapper.nativeGetMemoryUsage(nativeHandler)[0];
+  }
+
+  /** Most bytes of native memory the evaluator has held at once. */
+  public long getPeakMemory() throws RuntimeException {
+    if (nativeHandler == 0) {
+      return 0;
+    }
+    return jniWrapper.nativeGetMemoryUsage(nativeHandler)[1];
+  }
+
   @Override
   public void close() {
     jniWrapper.nativeClose(nativeHandler);
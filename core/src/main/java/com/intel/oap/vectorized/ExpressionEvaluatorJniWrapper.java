@@ -62,6 +62,73 @@ public class ExpressionEvaluatorJniWrapper {
          */
         native void nativeSetMetricsTime(boolean is_enable);
 
+        /**
+         * Set native env variables NATIVESQL_AGGR_BATCH_ACCUMULATE
+         *
+         * @param is_enable use typed batch accumulators in hash aggregate codegen
+         */
+        native void nativeSetBatchAccumulate(boolean is_enable);
+
+        /**
+         * Set native env variables NATIVESQL_AGGR_ADAPTIVE, NATIVESQL_AGGR_ADAPTIVE_MIN_ROWS,
+         * NATIVESQL_AGGR_ADAPTIVE_RATIO and NATIVESQL_AGGR_MEMORY_BUDGET
+         *
+         * @param is_enable let partial hash aggregate bypass or flush its groups
+         * @param min_rows rows to observe before deciding whether to bypass
+         * @param ratio bypass when groups / rows is above this ratio
+         * @param memory_budget bytes of hash table and aggregate state before flushing
+         *                      the groups, 0 is unlimited
+         */
+        native void nativeSetAdaptiveAggregate(boolean is_enable, long min_rows, double ratio,
+                long memory_budget);
+
+        /**
+         * Set native env variables NATIVESQL_AGGR_THREADS
+         *
+         * @param num_threads threads sharing one hash aggregate by partitioning its keys
+         */
+        native void nativeSetAggregateThreads(int num_threads);
+
+        /**
+         * Set native env variables NATIVESQL_AGGR_DISTINCT_MEMORY_BUDGET
+         *
+         * @param memory_budget bytes of distinct values of one aggregate before spilling
+         *                      them to disk, 0 is unlimited
+         */
+        native void nativeSetDistinctAggregateMemoryBudget(long memory_budget);
+
+        /**
+         * Set native env variables NATIVESQL_AGGR_KAHAN_SUM
+         *
+         * @param is_enable sum floating point values of an aggregate without grouping
+         *                  with Kahan summation
+         */
+        native void nativeSetKahanSum(boolean is_enable);
+
+        /**
+         * Set native env variables NATIVESQL_SORT_NORMALIZED_KEY
+         *
+         * @param is_enable sort on multiple keys by normalized keys when codegen is
+         *                  disabled
+         */
+        native void nativeSetSortNormalizedKey(boolean is_enable);
+
+        /**
+         * Set native env variables NATIVESQL_SORT_THREADS
+         *
+         * @param num_threads threads sharing one sort by sorting and merging chunks of
+         *                    its input
+         */
+        native void nativeSetSortThreads(int num_threads);
+
+        /**
+         * Set bias tables of approx_count_distinct, indexed by precision - 4
+         *
+         * @param raw_estimate_data raw estimates of each precision below 5 * m
+         * @param bias_data bias of each raw estimate
+         */
+        native void nativeSetHllBiasData(double[][] raw_estimate_data, double[][] bias_data);
+
 
         /**
          * Generates the projector module to evaluate the expressions with custom
@@ -127,6 +194,15 @@ public class ExpressionEvaluatorJniWrapper {
          */
         native long nativeSpill(long nativeHandler, long size, boolean callBySelf) throws RuntimeException;
 
+        /**
+         * Get the native memory held by the operator.
+         *
+         * @param nativeHandler nativeHandler representing expressions. Created using a
+         *                      call to buildNativeCode
+         * @return bytes allocated now and at the peak, in this order
+         */
+        native long[] nativeGetMemoryUsage(long nativeHandler) throws RuntimeException;
+
         /**
          * Evaluate the expressions represented by the nativeHandler on a record batch
          * and store the output in ValueVectors. Throws an exception in case of errors
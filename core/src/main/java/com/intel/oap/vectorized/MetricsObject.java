@@ -33,6 +33,8 @@ import io.netty.buffer.UnpooledByteBufAllocator;
 public class MetricsObject {
   public long[] process_time_list;
   public long[] output_length_list;
+  public long current_memory;
+  public long peak_memory;
 
   public MetricsObject() {}
 
@@ -42,8 +44,11 @@ public class MetricsObject {
    * @param memoryAddress native ArrowBuf data addr.
    * @param size ArrowBuf size.
    */
-  public MetricsObject(long[] _output_length_list, long[] _process_time_list) {
+  public MetricsObject(long[] _output_length_list, long[] _process_time_list,
+      long _current_memory, long _peak_memory) {
     output_length_list = _output_length_list;
     process_time_list = _process_time_list;
+    current_memory = _current_memory;
+    peak_memory = _peak_memory;
   }
 }
\ No newline at end of file
@@ -90,6 +90,9 @@ case class ColumnarGuardRule(conf: SparkConf) extends Rule[SparkPlan] {
         case plan: SortExec =>
           if (!enableColumnarSort) return false
           new ColumnarSortExec(plan.sortOrder, plan.global, plan.child, plan.testSpillFrequency)
+        case plan: TakeOrderedAndProjectExec =>
+          if (!enableColumnarSort) return false
+          new ColumnarSortExec(plan.sortOrder, false, plan.child, 0, plan.limit)
         case plan: ShuffleExchangeExec =>
           if (!enableColumnarShuffle) return false
           new ColumnarShuffleExchangeExec(
@@ -162,7 +165,7 @@ case class ColumnarGuardRule(conf: SparkConf) extends Rule[SparkPlan] {
             plan.windowExpression,
             plan.partitionSpec,
             plan.orderSpec,
-            plan.child)
+            plan.child)(streaming = false)
         case p =>
           p
       }
@@ -79,17 +79,25 @@ case class ColumnarPreOverrides(conf: SparkConf) extends Rule[SparkPlan] {
       val child = replaceWithColumnarPlan(plan.child)
       logDebug(s"Columnar Processing for ${plan.getClass} is currently supported.")
       ColumnarConditionProjectExec(plan.condition, null, child)
+    case ColumnarDistinctAggregate(collapsed) =>
+      replaceWithColumnarPlan(collapsed)
     case plan: HashAggregateExec =>
       val child = replaceWithColumnarPlan(plan.child)
       logDebug(s"Columnar Processing for ${plan.getClass} is currently supported.")
-      ColumnarHashAggregateExec(
-        plan.requiredChildDistributionExpressions,
-        plan.groupingExpressions,
-        plan.aggregateExpressions,
-        plan.aggregateAttributes,
-        plan.initialInputBufferOffset,
-        plan.resultExpressions,
-        child)
+      val groupingSetsAggregate = child match {
+        case expand: ColumnarExpandExec if columnarConf.enableGroupingSetsPreAggregate =>
+          ColumnarGroupingSets.preAggregate(plan, expand)
+        case _ => None
+      }
+      groupingSetsAggregate.getOrElse(
+        ColumnarHashAggregateExec(
+          plan.requiredChildDistributionExpressions,
+          plan.groupingExpressions,
+          plan.aggregateExpressions,
+          plan.aggregateAttributes,
+          plan.initialInputBufferOffset,
+          plan.resultExpressions,
+          child))
     case plan: UnionExec =>
       val children = plan.children.map(replaceWithColumnarPlan)
       logDebug(s"Columnar Processing for ${plan.getClass} is currently supported.")
@@ -107,6 +115,16 @@ case class ColumnarPreOverrides(conf: SparkConf) extends Rule[SparkPlan] {
         case _ =>
           ColumnarSortExec(plan.sortOrder, plan.global, child, plan.testSpillFrequency)
       }
+    case plan: TakeOrderedAndProjectExec =>
+      val child = replaceWithColumnarPlan(plan.child)
+      logDebug(s"Columnar Processing for ${plan.getClass} is currently supported.")
+      // each partition only passes its first limit rows on to the final take
+      val columnarChild = child match {
+        case CoalesceBatchesExec(fwdChild: SparkPlan) => fwdChild
+        case _ => child
+      }
+      plan.withNewChildren(
+        Seq(ColumnarSortExec(plan.sortOrder, false, columnarChild, 0, plan.limit)))
     case plan: ShuffleExchangeExec =>
       val child = replaceWithColumnarPlan(plan.child)
       logDebug(s"Columnar Processing for ${plan.getClass} is currently supported.")
@@ -220,19 +238,25 @@ case class ColumnarPreOverrides(conf: SparkConf) extends Rule[SparkPlan] {
 
     case plan: WindowExec =>
       if (columnarConf.enableColumnarWindow) {
+        // Window only streams when input below it is already sorted by partition keys,
+        // as a sort under Window would hold all input of the task anyway. That sort is
+        // removed either way, cached input needs no ordering.
         val child = plan.child match {
-          case sort: SortExec => // remove ordering requirements
+          case sort: SortExec =>
             replaceWithColumnarPlan(sort.child)
           case _ =>
             replaceWithColumnarPlan(plan.child)
         }
+        val streaming = columnarConf.enableColumnarWindowStreaming &&
+            ColumnarWindowExec.supportsStreaming(plan.partitionSpec) &&
+            SortOrder.orderingSatisfies(child.outputOrdering, plan.requiredChildOrdering.head)
         logDebug(s"Columnar Processing for ${plan.getClass} is currently supported.")
         try {
           return new ColumnarWindowExec(
             plan.windowExpression,
             plan.partitionSpec,
             plan.orderSpec,
-            child)
+            child)(streaming)
         } catch {
           case _: Throwable =>
             logInfo("Columnar Window: Falling back to regular Window...")
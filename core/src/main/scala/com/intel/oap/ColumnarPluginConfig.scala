@@ -55,12 +55,117 @@ class ColumnarPluginConfig(conf: SQLConf) {
     conf.getConfString(
       "spark.oap.sql.columnar.wholestagecodegen.breakdownTime",
       "false").toBoolean
+  // Use typed accumulators folding a whole batch at once in hash aggregate codegen,
+  // instead of one virtual action call per row.
+  val enableBatchAccumulate: Boolean =
+    conf.getConfString(
+      "spark.oap.sql.columnar.hashAggregate.batchAccumulate",
+      "false").toBoolean
+  // Let hash aggregate find groups by comparing adjacent keys instead of building a hash
+  // table when its child is already sorted on grouping keys. This is not a streaming
+  // aggregate: aggregate state of every group is kept and emitted after all input, so
+  // it is off by default.
+  val enableSortedInputAggregate: Boolean =
+    conf.getConfString(
+      "spark.oap.sql.columnar.hashAggregate.sortedInput",
+      "false").toBoolean
+  // Let partial hash aggregate stop pre-aggregating when keys are nearly unique, which is
+  // decided on groups / rows over the first minRows rows, and flush its groups to
+  // start over once they grow over memoryBudget bytes. memoryBudget 0 means unlimited.
+  val enableAdaptiveAggregate: Boolean =
+    conf.getConfString(
+      "spark.oap.sql.columnar.hashAggregate.adaptive",
+      "false").toBoolean
+  val adaptiveAggregateMinRows: Long =
+    conf.getConfString(
+      "spark.oap.sql.columnar.hashAggregate.adaptive.minRows",
+      "100000").toLong
+  val adaptiveAggregateRatio: Double =
+    conf.getConfString(
+      "spark.oap.sql.columnar.hashAggregate.adaptive.ratio",
+      "0.9").toDouble
+  // Bytes of hash table and aggregate state of one partial aggregate, past which its
+  // groups are output and their state is freed. 0 means unlimited.
+  val aggregateMemoryBudget: Long =
+    conf.getConfString(
+      "spark.oap.sql.columnar.hashAggregate.memoryBudget",
+      "0").toLong
+  // Threads of one hash aggregate, input rows are partitioned by group keys and each
+  // thread aggregates its own partitions.
+  val aggregateThreads: Int =
+    conf.getConfString(
+      "spark.oap.sql.columnar.hashAggregate.threads",
+      "1").toInt
+  // Bytes of distinct values kept in memory by count(DISTINCT) and sum(DISTINCT) of one
+  // aggregate before they are spilled to disk. 0 means unlimited.
+  val distinctAggregateMemoryBudget: Long =
+    conf.getConfString(
+      "spark.oap.sql.columnar.hashAggregate.distinct.memoryBudget",
+      "268435456").toLong
+  // Shuffle the input of count(DISTINCT) and sum(DISTINCT) once by grouping keys and
+  // deduplicate it natively, instead of Spark's two shuffles and four aggregates.
+  val enableDistinctAggregateCollapse: Boolean =
+    conf.getConfString(
+      "spark.oap.sql.columnar.hashAggregate.distinct.collapse",
+      "true").toBoolean
+  // Sum floating point values of an aggregate without grouping with Kahan summation,
+  // which loses less precision than a plain sum at the cost of a few more adds.
+  val enableKahanSum: Boolean =
+    conf.getConfString(
+      "spark.oap.sql.columnar.hashAggregate.kahanSum",
+      "false").toBoolean
+  // Let sort on multiple keys without codegen encode the keys of each row once into a
+  // memcmp comparable key and radix sort it, instead of comparing key by key.
+  val enableSortNormalizedKey: Boolean =
+    conf.getConfString(
+      "spark.oap.sql.columnar.sort.normalizedKey",
+      "true").toBoolean
+  // Threads of one sort, chunks of its input are sorted on their own threads and then
+  // merged.
+  val sortThreads: Int =
+    conf.getConfString(
+      "spark.oap.sql.columnar.sort.threads",
+      "1").toInt
+  // Let a sort feeding SortMergeJoin sort only key and row index and hand the join a
+  // relation over them, so payload columns are only read for rows the join reads.
+  val enableSortDeferPayload: Boolean =
+    conf.getConfString(
+      "spark.oap.sql.columnar.sort.deferPayload",
+      "true").toBoolean
+  // Aggregate grouping sets of ROLLUP, CUBE and GROUPING SETS on all grouping columns
+  // before Expand, so Expand copies groups instead of input rows.
+  val enableGroupingSetsPreAggregate: Boolean =
+    conf.getConfString(
+      "spark.oap.sql.columnar.hashAggregate.groupingSets.preAggregate",
+      "true").toBoolean
+  // Let window output each batch once its partitions end, instead of caching all input
+  // of the task until it is finished, when its input is already sorted by partition keys
+  // without a sort under window.
+  val enableColumnarWindowStreaming: Boolean =
+    conf.getConfString(
+      "spark.oap.sql.columnar.window.streaming",
+      "true").toBoolean
   val tmpFile: String =
     conf.getConfString("spark.sql.columnar.tmp_dir", null)
+  // Bytes of broadcast hash relations cached natively per executor, acquired from Spark
+  // off-heap storage memory. Relations no task uses are evicted to make room, one that
+  // doesn't fit is built by every task for itself. 0 means only limited by Spark.
+  val hashRelationCacheCapacity: Long =
+    conf.getConfString(
+      "spark.oap.sql.columnar.broadcastJoin.cacheCapacity",
+      "1073741824").toLong
   @deprecated val broadcastCacheTimeout: Int =
     conf.getConfString("spark.sql.columnar.sort.broadcast.cache.timeout", "-1").toInt
   val hashCompare: Boolean =
     conf.getConfString("spark.oap.sql.columnar.hashCompare", "false").toBoolean
+  // Number of threads used to build one hash relation, partitioned parallel build is
+  // used when this is larger than 1.
+  val hashRelationBuildThreads: Int =
+    conf.getConfString("spark.oap.sql.columnar.hashRelationBuildThreads", "1").toInt
+  // Minimal number of build rows to use the parallel build.
+  val hashRelationParallelBuildMinRows: Long =
+    conf.getConfString("spark.oap.sql.columnar.hashRelationParallelBuildMinRows", "1048576")
+      .toLong
   // Whether to spill the partition buffers when buffers are full.
   // If false, the partition buffers will be cached in memory first,
   // and the cached buffers will be spilled when reach maximum memory.
@@ -122,6 +227,90 @@ object ColumnarPluginConfig {
       ins.enableMetricsTime
     }
   }
+  def getEnableBatchAccumulate: Boolean = synchronized {
+    if (ins == null) {
+      false
+    } else {
+      ins.enableBatchAccumulate
+    }
+  }
+  def getEnableSortedInputAggregate: Boolean = synchronized {
+    if (ins == null) {
+      true
+    } else {
+      ins.enableSortedInputAggregate
+    }
+  }
+  def getEnableAdaptiveAggregate: Boolean = synchronized {
+    if (ins == null) {
+      false
+    } else {
+      ins.enableAdaptiveAggregate
+    }
+  }
+  def getAdaptiveAggregateMinRows: Long = synchronized {
+    if (ins == null) {
+      100000
+    } else {
+      ins.adaptiveAggregateMinRows
+    }
+  }
+  def getAdaptiveAggregateRatio: Double = synchronized {
+    if (ins == null) {
+      0.9
+    } else {
+      ins.adaptiveAggregateRatio
+    }
+  }
+  def getAggregateMemoryBudget: Long = synchronized {
+    if (ins == null) {
+      0
+    } else {
+      ins.aggregateMemoryBudget
+    }
+  }
+  def getAggregateThreads: Int = synchronized {
+    if (ins == null) {
+      1
+    } else {
+      ins.aggregateThreads
+    }
+  }
+  def getDistinctAggregateMemoryBudget: Long = synchronized {
+    if (ins == null) {
+      268435456
+    } else {
+      ins.distinctAggregateMemoryBudget
+    }
+  }
+  def getEnableDistinctAggregateCollapse: Boolean = synchronized {
+    if (ins == null) {
+      true
+    } else {
+      ins.enableDistinctAggregateCollapse
+    }
+  }
+  def getEnableKahanSum: Boolean = synchronized {
+    if (ins == null) {
+      false
+    } else {
+      ins.enableKahanSum
+    }
+  }
+  def getEnableSortNormalizedKey: Boolean = synchronized {
+    if (ins == null) {
+      true
+    } else {
+      ins.enableSortNormalizedKey
+    }
+  }
+  def getSortThreads: Int = synchronized {
+    if (ins == null) {
+      1
+    } else {
+      ins.sortThreads
+    }
+  }
   def getTempFile: String = synchronized {
     if (ins != null && ins.tmpFile != null) {
       ins.tmpFile
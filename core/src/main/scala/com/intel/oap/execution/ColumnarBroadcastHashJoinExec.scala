@@ -119,6 +119,11 @@ case class ColumnarBroadcastHashJoinExec(
     if (projectList == null || projectList.isEmpty) super.output
     else projectList.map(_.toAttribute)
   def getBuildPlan: SparkPlan = buildPlan
+
+  // identifies the native hash relation built from the broadcast, used as
+  // executor-side cache key since one broadcast may be joined on different keys
+  def hashRelationSignature: String =
+    s"${buildKeyExprs.mkString(",")}@${buildPlan.output.mkString(",")}"
   override def supportsColumnar = true
   override protected def doExecute(): RDD[InternalRow] = {
     throw new UnsupportedOperationException(
@@ -238,6 +243,7 @@ case class ColumnarBroadcastHashJoinExec(
     var build_elapse: Long = 0
     var eval_elapse: Long = 0
     val buildInputByteBuf = buildPlan.executeBroadcast[ColumnarHashedRelation]()
+    val relationSignature = hashRelationSignature
 
     streamedPlan.executeColumnar().mapPartitions { iter =>
       ExecutorManager.tryTaskSet(numaBindingInfo)
@@ -248,37 +254,55 @@ case class ColumnarBroadcastHashJoinExec(
       val relation = buildInputByteBuf.value.asReadOnlyCopy
       fetchTime += ((System.nanoTime() - beforeFetch) / 1000000)
       val beforeEval = System.nanoTime()
-      val hashRelationObject = relation.hashRelationObj
-      val depIter =
-        new CloseableColumnBatchIterator(relation.getColumnarBatchAsIter)
-      val hash_relation_function =
-        ColumnarConditionedProbeJoin.prepareHashBuildFunction(buildKeyExprs, buildPlan.output, 2)
-      val hash_relation_schema = ConverterUtils.toArrowSchema(buildPlan.output)
-      val hash_relation_expr =
-        TreeBuilder.makeExpression(
-          hash_relation_function,
-          Field.nullable("result", new ArrowType.Int(32, true)))
-      hashRelationKernel.build(hash_relation_schema, Lists.newArrayList(hash_relation_expr), true)
-      val hashRelationResultIterator = hashRelationKernel.finishByIterator()
+      // only the first task on this executor builds the native relation,
+      // others share it read-only through the executor cache
+      val cachedRelationId = relation.getCachedRelationId(relationSignature)
+      var hashRelationResultIterator =
+        BatchIterator.acquireCachedHashRelation(cachedRelationId)
+      if (hashRelationResultIterator == null) {
+        try {
+          val hashRelationObject = relation.hashRelationObj
+          val depIter =
+            new CloseableColumnBatchIterator(relation.getColumnarBatchAsIter)
+          val hash_relation_function =
+            ColumnarConditionedProbeJoin
+              .prepareHashBuildFunction(buildKeyExprs, buildPlan.output, 2)
+          val hash_relation_schema = ConverterUtils.toArrowSchema(buildPlan.output)
+          val hash_relation_expr =
+            TreeBuilder.makeExpression(
+              hash_relation_function,
+              Field.nullable("result", new ArrowType.Int(32, true)))
+          hashRelationKernel.build(
+            hash_relation_schema,
+            Lists.newArrayList(hash_relation_expr),
+            true)
+          val buildResultIterator = hashRelationKernel.finishByIterator()
+
+          // we need to set original recordBatch to hashRelationKernel
+          while (depIter.hasNext) {
+            val dep_cb = depIter.next()
+            if (dep_cb.numRows > 0) {
+              (0 until dep_cb.numCols).toList.foreach(i =>
+                dep_cb.column(i).asInstanceOf[ArrowWritableColumnVector].retain())
+              hashRelationBatchHolder += dep_cb
+              val dep_rb = ConverterUtils.createArrowRecordBatch(dep_cb)
+              buildResultIterator.processAndCacheOne(hash_relation_schema, dep_rb)
+              ConverterUtils.releaseArrowRecordBatch(dep_rb)
+            }
+          }
 
-      // we need to set original recordBatch to hashRelationKernel
-      var numRows = 0
-      while (depIter.hasNext) {
-        val dep_cb = depIter.next()
-        if (dep_cb.numRows > 0) {
-          (0 until dep_cb.numCols).toList.foreach(i =>
-            dep_cb.column(i).asInstanceOf[ArrowWritableColumnVector].retain())
-          hashRelationBatchHolder += dep_cb
-          val dep_rb = ConverterUtils.createArrowRecordBatch(dep_cb)
-          hashRelationResultIterator.processAndCacheOne(hash_relation_schema, dep_rb)
-          ConverterUtils.releaseArrowRecordBatch(dep_rb)
-          numRows += dep_cb.numRows
+          // we need to set hashRelationObject to hashRelationResultIterator
+          buildResultIterator.setHashRelationObject(hashRelationObject)
+          hashRelationResultIterator =
+            buildResultIterator.publishCachedHashRelation(cachedRelationId)
+          buildResultIterator.close()
+        } catch {
+          case e: Throwable =>
+            BatchIterator.abortCachedHashRelation(cachedRelationId)
+            throw e
         }
       }
 
-      // we need to set hashRelationObject to hashRelationResultIterator
-      hashRelationResultIterator.setHashRelationObject(hashRelationObject)
-
       val native_function = TreeBuilder.makeFunction(
         s"standalone",
         Lists.newArrayList(getKernelFunction),
@@ -0,0 +1,103 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.intel.oap.execution
+
+import com.intel.oap.ColumnarPluginConfig
+import org.apache.spark.internal.Logging
+import org.apache.spark.sql.catalyst.expressions.aggregate._
+import org.apache.spark.sql.execution.SparkPlan
+import org.apache.spark.sql.execution.aggregate.HashAggregateExec
+import org.apache.spark.sql.execution.exchange.ShuffleExchangeExec
+import org.apache.spark.sql.types._
+
+/**
+ * Distinct aggregate deduplicated natively.
+ *
+ * Spark plans an aggregate with one set of distinct columns, such as
+ * SELECT k, count(DISTINCT x), sum(y) ... GROUP BY k, as
+ *   1. a Partial aggregate of non-distinct functions grouped by k and x,
+ *   2. a shuffle on k and x, then a PartialMerge aggregate grouped by k and x,
+ *   3. a PartialMerge of non-distinct and Partial of distinct functions grouped by k,
+ *   4. a shuffle on k, then the Final aggregate of all functions.
+ * Native count(DISTINCT) and sum(DISTINCT) deduplicate the values of each group
+ * themselves, so the output of 1 is shuffled on k and consumed by the final aggregate
+ * with its distinct functions in Complete mode, skipping one shuffle and two
+ * aggregates. 1 still drops duplicated (k, x) pairs of one partition before shuffle.
+ */
+object ColumnarDistinctAggregate extends Logging {
+
+  def unapply(plan: SparkPlan): Option[HashAggregateExec] = plan match {
+    case aggregate: HashAggregateExec => collapse(aggregate)
+    case _ => None
+  }
+
+  // value types native sum(DISTINCT) takes, count(DISTINCT) also takes string and date
+  private def isNativeNumeric(dataType: DataType): Boolean = dataType match {
+    case ByteType | ShortType | IntegerType | LongType | FloatType | DoubleType => true
+    case _ => false
+  }
+
+  def collapse(plan: HashAggregateExec): Option[HashAggregateExec] = {
+    if (!ColumnarPluginConfig.getEnableDistinctAggregateCollapse) return None
+    val aggregateExpressions = plan.aggregateExpressions
+    val distinctExpressions = aggregateExpressions.filter(_.isDistinct)
+    if (distinctExpressions.isEmpty || !aggregateExpressions.forall(_.mode == Final)) {
+      return None
+    }
+    val supported = distinctExpressions.forall { expr =>
+      expr.filter.isEmpty && expr.aggregateFunction.children.size == 1 &&
+      (expr.aggregateFunction match {
+        case Sum(child) => isNativeNumeric(child.dataType)
+        case Count(Seq(child)) =>
+          isNativeNumeric(child.dataType) || child.dataType == StringType ||
+          child.dataType == DateType
+        case _ => false
+      })
+    }
+    if (!supported) return None
+
+    val partialAggregate = plan.child match {
+      case ShuffleExchangeExec(_, distinctAggregate: HashAggregateExec, _)
+          if distinctAggregate.aggregateExpressions.exists(e =>
+            e.isDistinct && e.mode == Partial) =>
+        distinctAggregate.child match {
+          case mergeAggregate: HashAggregateExec =>
+            mergeAggregate.child match {
+              case ShuffleExchangeExec(_, partial: HashAggregateExec, _)
+                  if partial.aggregateExpressions.forall(_.mode == Partial) =>
+                Some(partial)
+              case _ => None
+            }
+          case _ => None
+        }
+      case _ => None
+    }
+    // distinct columns are grouping columns of the partial aggregate
+    val distinctColumns = distinctExpressions.flatMap(_.aggregateFunction.references)
+    partialAggregate
+      .filter(partial => distinctColumns.forall(partial.outputSet.contains))
+      .map { partial =>
+        val exchange = plan.child.asInstanceOf[ShuffleExchangeExec]
+        logDebug(s"Distinct aggregate over ${partial.groupingExpressions} is collapsed.")
+        plan.copy(
+          aggregateExpressions = aggregateExpressions.map { expr =>
+            if (expr.isDistinct) expr.copy(mode = Complete) else expr
+          },
+          child = exchange.copy(child = partial))
+    }
+  }
+}
@@ -0,0 +1,134 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.intel.oap.execution
+
+import org.apache.spark.internal.Logging
+import org.apache.spark.sql.catalyst.expressions._
+import org.apache.spark.sql.catalyst.expressions.aggregate._
+import org.apache.spark.sql.execution.SparkPlan
+import org.apache.spark.sql.execution.aggregate.HashAggregateExec
+
+/**
+ * Grouping sets aggregate which consumes every input row once.
+ *
+ * Spark plans ROLLUP, CUBE and GROUPING SETS as a partial aggregate over an Expand,
+ * which emits each input row once per grouping set. When Expand only nulls out
+ * grouping columns and every aggregate function can merge its buffers, the same
+ * partial result is derived from the finest grouping set instead:
+ *   1. a partial aggregate of the input on all grouping columns,
+ *   2. an Expand of its groups, one copy per grouping set,
+ *   3. a PartialMerge aggregate on the grouping columns and grouping id.
+ * Output of 3 is what the original partial aggregate outputs, so the final aggregate
+ * after shuffle is unchanged.
+ */
+object ColumnarGroupingSets extends Logging {
+
+  def preAggregate(plan: HashAggregateExec, expand: ColumnarExpandExec): Option[SparkPlan] = {
+    val aggregateExpressions = plan.aggregateExpressions
+    val mergeable = aggregateExpressions.forall { expr =>
+      expr.mode == Partial && !expr.isDistinct && expr.filter.isEmpty &&
+      (expr.aggregateFunction match {
+        case Average(_) | Sum(_) | Count(_) | Max(_) | Min(_) => true
+        case _ => false
+      })
+    }
+    if (!mergeable) return None
+
+    val input = expand.child
+    val keyIndices = plan.groupingExpressions.map {
+      case attr: Attribute => expand.output.indexWhere(_.exprId == attr.exprId)
+      case _ => -1
+    }
+    if (keyIndices.isEmpty || keyIndices.contains(-1)) return None
+    // A grouping column is a literal in every projection, as grouping id is, or one
+    // input attribute which some projections replace with null.
+    val keySources = keyIndices.map { i =>
+      val exprs = expand.projections.map(_(i))
+      if (exprs.forall(_.isInstanceOf[Literal])) {
+        Some(None)
+      } else {
+        exprs.filterNot(isNullLiteral) match {
+          case Seq(attr: Attribute, others @ _*)
+              if input.outputSet.contains(attr) && others.forall(_.semanticEquals(attr)) =>
+            Some(Some(attr))
+          case _ => None
+        }
+      }
+    }
+    if (keySources.contains(None)) return None
+    val finestKeys = keySources.flatten.flatten.foldLeft(Seq.empty[Attribute]) {
+      (keys, attr) => if (keys.exists(_.semanticEquals(attr))) keys else keys :+ attr
+    }
+    if (finestKeys.isEmpty) return None
+
+    // aggregate inputs can only come from columns which Expand passes through as is
+    val passThrough = AttributeMap(expand.output.zipWithIndex.flatMap {
+      case (attr, i) =>
+        val exprs = expand.projections.map(_(i))
+        if (exprs.forall(_.semanticEquals(exprs.head))) Some(attr -> exprs.head) else None
+    })
+    val partialExpressions = aggregateExpressions.map { expr =>
+      val func = expr.aggregateFunction.transformUp {
+        case attr: Attribute if passThrough.contains(attr) => passThrough(attr)
+      }
+      expr.copy(
+        aggregateFunction = func.asInstanceOf[AggregateFunction],
+        resultId = NamedExpression.newExprId)
+    }
+    if (!partialExpressions.forall(_.references.subsetOf(input.outputSet))) return None
+
+    try {
+      val partialBufferAttributes =
+        partialExpressions.flatMap(_.aggregateFunction.inputAggBufferAttributes)
+      val partialAggregate = ColumnarHashAggregateExec(
+        None,
+        finestKeys,
+        partialExpressions,
+        partialExpressions.map(_.resultAttribute),
+        0,
+        finestKeys ++ partialBufferAttributes,
+        input)
+      // finest keys are passed through by the partial aggregate, so projections of the
+      // original Expand still refer to them
+      val projections = expand.projections.map { projection =>
+        keyIndices.map(projection(_)) ++ partialBufferAttributes
+      }
+      val expandOutput = keyIndices.map(expand.output(_)) ++
+        aggregateExpressions.flatMap(_.aggregateFunction.inputAggBufferAttributes)
+      val expandGroups = ColumnarExpandExec(projections, expandOutput, partialAggregate)
+      Some(
+        ColumnarHashAggregateExec(
+          plan.requiredChildDistributionExpressions,
+          plan.groupingExpressions,
+          aggregateExpressions.map(_.copy(mode = PartialMerge)),
+          plan.aggregateAttributes,
+          plan.groupingExpressions.size,
+          plan.resultExpressions,
+          expandGroups))
+    } catch {
+      case e: UnsupportedOperationException =>
+        logDebug(s"Grouping sets are not pre-aggregated: ${e.getMessage}")
+        None
+    }
+  }
+
+  private def isNullLiteral(expr: Expression): Boolean = expr match {
+    case Literal(null, _) => true
+    case _ => false
+  }
+}
@@ -174,8 +174,14 @@ case class ColumnarHashAggregateExec(
       val mode = expr.mode
       val aggregateFunction = expr.aggregateFunction
       aggregateFunction match {
+        case Sum(_) | Count(_) if mode == Complete =>
+          // distinct values of a group are deduplicated natively, Complete mode is planned
+          // by ColumnarDistinctAggregate in place of Spark's distinct aggregate stages
+          if (!expr.isDistinct || aggregateFunction.children.size != 1) {
+            throw new UnsupportedOperationException(s"not currently supported: $expr.")
+          }
         case Average(_) | Sum(_) | Count(_) | Max(_) | Min(_) =>
-        case StddevSamp(_) =>
+        case StddevSamp(_) | _: HyperLogLogPlusPlus =>
           mode match {
             case Partial | Final =>
             case other =>
@@ -185,7 +191,7 @@ case class ColumnarHashAggregateExec(
           throw new UnsupportedOperationException(s"not currently supported: $other.")
       }
       mode match {
-        case Partial | PartialMerge | Final =>
+        case Partial | PartialMerge | Final | Complete =>
         case other =>
           throw new UnsupportedOperationException(s"not currently supported: $other.")
       }
@@ -235,7 +241,16 @@ case class ColumnarHashAggregateExec(
       aggregateAttributes,
       resultExpressions,
       output,
-      sparkConf)
+      sparkConf,
+      isSortedInput)
+  }
+
+  /* Child is sorted on all grouping keys, in any order or direction of the keys. */
+  def isSortedInput: Boolean = {
+    val orderingKeys = child.outputOrdering.map(_.child).take(groupingExpressions.size)
+    ColumnarPluginConfig.getEnableSortedInputAggregate && groupingExpressions.nonEmpty &&
+    orderingKeys.size == groupingExpressions.size &&
+    groupingExpressions.forall(key => orderingKeys.exists(_.semanticEquals(key)))
   }
 
   override def doCodeGen: ColumnarCodegenContext = {
@@ -46,13 +46,15 @@ import org.apache.spark.sql.execution.metric.{SQLMetric, SQLMetrics}
 import org.apache.spark.sql.vectorized.{ColumnarBatch, ColumnVector}
 
 /**
- * Columnar Based SortExec.
+ * Columnar Based SortExec. With a limit, only the first limit rows of each partition
+ * are output, which native keeps in a heap instead of sorting all input.
  */
 case class ColumnarSortExec(
     sortOrder: Seq[SortOrder],
     global: Boolean,
     child: SparkPlan,
-    testSpillFrequency: Int = 0)
+    testSpillFrequency: Int = 0,
+    limit: Int = -1)
     extends UnaryExecNode
     with ColumnarCodegenSupport {
 
@@ -78,13 +80,15 @@ case class ColumnarSortExec(
     "sortTime" -> SQLMetrics.createTimingMetric(sparkContext, "time in sort process"),
     "shuffleTime" -> SQLMetrics.createTimingMetric(sparkContext, "time in shuffle process"),
     "numOutputRows" -> SQLMetrics.createMetric(sparkContext, "number of output rows"),
-    "numOutputBatches" -> SQLMetrics.createMetric(sparkContext, "output_batches"))
+    "numOutputBatches" -> SQLMetrics.createMetric(sparkContext, "output_batches"),
+    "peakMemory" -> SQLMetrics.createSizeMetric(sparkContext, "peak memory"))
 
   val elapse = longMetric("processTime")
   val sortTime = longMetric("sortTime")
   val shuffleTime = longMetric("shuffleTime")
   val numOutputRows = longMetric("numOutputRows")
   val numOutputBatches = longMetric("numOutputBatches")
+  val peakMemory = longMetric("peakMemory")
 
   buildCheck()
 
@@ -113,7 +117,8 @@ case class ColumnarSortExec(
       Seq(child.executeColumnar())
   }
 
-  override def supportColumnarCodegen: Boolean = true
+  // whole stage codegen caches and sorts all rows
+  override def supportColumnarCodegen: Boolean = limit < 0
 
   override def getBuildPlans: Seq[(SparkPlan, SparkPlan)] = child match {
     case c: ColumnarCodegenSupport if c.supportColumnarCodegen == true =>
@@ -166,7 +171,8 @@ case class ColumnarSortExec(
         numOutputRows,
         shuffleTime,
         elapse,
-        sparkConf)
+        sparkConf,
+        limit)
     } else {
       ""
     }
@@ -214,7 +220,9 @@ case class ColumnarSortExec(
           numOutputRows,
           shuffleTime,
           elapse,
-          sparkConf)
+          sparkConf,
+          limit,
+          peakMemory)
         SparkMemoryUtils.addLeakSafeTaskCompletionListener[Unit](_ => {
           sorter.close()
         })
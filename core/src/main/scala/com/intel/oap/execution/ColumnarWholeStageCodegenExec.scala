@@ -30,6 +30,7 @@ import org.apache.spark.sql.catalyst.plans.physical.Partitioning
 import org.apache.spark.sql.execution._
 import org.apache.spark.sql.execution.datasources.v2.arrow.SparkMemoryUtils
 import org.apache.spark.sql.execution.metric.SQLMetrics
+import org.apache.spark.sql.types.DecimalType
 import org.apache.spark.sql.util.ArrowUtils
 import org.apache.spark.sql.vectorized.{ColumnVector, ColumnarBatch}
 import org.apache.spark.util.{ExecutorManager, UserAddedJarUtils}
@@ -78,7 +79,8 @@ case class ColumnarWholeStageCodegenExec(child: SparkPlan)(val codegenStageId: I
     "numOutputRows" -> SQLMetrics.createMetric(sparkContext, "number of output rows"),
     "totalTime" -> SQLMetrics.createTimingMetric(sparkContext, "totaltime_wholestagecodegen"),
     "buildTime" -> SQLMetrics.createTimingMetric(sparkContext, "time to build dependencies"),
-    "pipelineTime" -> SQLMetrics.createTimingMetric(sparkContext, "duration"))
+    "pipelineTime" -> SQLMetrics.createTimingMetric(sparkContext, "duration"),
+    "peakMemory" -> SQLMetrics.createSizeMetric(sparkContext, "peak memory"))
 
   override def output: Seq[Attribute] = child.output
 
@@ -150,7 +152,9 @@ case class ColumnarWholeStageCodegenExec(child: SparkPlan)(val codegenStageId: I
   override def updateMetrics(out_num_rows: Long, process_time: Long): Unit = {}
 
   var metricsUpdated: Boolean = false
-  def updateMetrics(nativeIterator: BatchIterator): Unit = {
+  def updateMetrics(
+      nativeIterator: BatchIterator,
+      dependentKernels: Seq[ExpressionEvaluator]): Unit = {
     if (metricsUpdated == true) return
     val metrics = nativeIterator.getMetrics
     var curChild = child
@@ -166,6 +170,8 @@ case class ColumnarWholeStageCodegenExec(child: SparkPlan)(val codegenStageId: I
       idx -= 1
       curChild = curChild.asInstanceOf[ColumnarCodegenSupport].getChild
     }
+    // relations built for the stage are held by their own evaluators until it is done
+    longMetric("peakMemory") += metrics.peak_memory + dependentKernels.map(_.getPeakMemory).sum
     metricsUpdated = true
   }
 
@@ -280,6 +286,7 @@ case class ColumnarWholeStageCodegenExec(child: SparkPlan)(val codegenStageId: I
           val buildTime = p.longMetric("buildTime")
           val buildPlan = p.getBuildPlan
           val buildInputByteBuf = buildPlan.executeBroadcast[ColumnarHashedRelation]()
+          val relationSignature = p.hashRelationSignature
           curRDD.mapPartitions { iter =>
             ColumnarPluginConfig.getConf
             ExecutorManager.tryTaskSet(numaBindingInfo)
@@ -289,33 +296,49 @@ case class ColumnarWholeStageCodegenExec(child: SparkPlan)(val codegenStageId: I
             relationHolder += relation
             fetchTime += ((System.nanoTime() - beforeFetch) / 1000000)
             val beforeEval = System.nanoTime()
-            val hashRelationObject = relation.hashRelationObj
-            serializableObjectHolder += hashRelationObject
-            val depIter =
-              new CloseableColumnBatchIterator(relation.getColumnarBatchAsIter)
-            val ctx = curPlan.asInstanceOf[ColumnarCodegenSupport].dependentPlanCtx
-            val expression =
-              TreeBuilder.makeExpression(
-                ctx.root,
-                Field.nullable("result", new ArrowType.Int(32, true)))
             val hashRelationKernel = new ExpressionEvaluator()
-            hashRelationKernel.build(ctx.inputSchema, Lists.newArrayList(expression), true)
-            val hashRelationResultIterator = hashRelationKernel.finishByIterator()
-            dependentKernelIterators += hashRelationResultIterator
-            // we need to set original recordBatch to hashRelationKernel
-            while (depIter.hasNext) {
-              val dep_cb = depIter.next()
-              if (dep_cb.numRows > 0) {
-                (0 until dep_cb.numCols).toList.foreach(i =>
-                  dep_cb.column(i).asInstanceOf[ArrowWritableColumnVector].retain())
-                buildRelationBatchHolder += dep_cb
-                val dep_rb = ConverterUtils.createArrowRecordBatch(dep_cb)
-                hashRelationResultIterator.processAndCacheOne(ctx.inputSchema, dep_rb)
-                ConverterUtils.releaseArrowRecordBatch(dep_rb)
+            // only the first task on this executor builds the native relation,
+            // others share it read-only through the executor cache
+            val cachedRelationId = relation.getCachedRelationId(relationSignature)
+            val cachedResultIterator = BatchIterator.acquireCachedHashRelation(cachedRelationId)
+            if (cachedResultIterator != null) {
+              dependentKernelIterators += cachedResultIterator
+            } else {
+              try {
+                val hashRelationObject = relation.hashRelationObj
+                serializableObjectHolder += hashRelationObject
+                val depIter =
+                  new CloseableColumnBatchIterator(relation.getColumnarBatchAsIter)
+                val ctx = curPlan.asInstanceOf[ColumnarCodegenSupport].dependentPlanCtx
+                val expression =
+                  TreeBuilder.makeExpression(
+                    ctx.root,
+                    Field.nullable("result", new ArrowType.Int(32, true)))
+                hashRelationKernel.build(ctx.inputSchema, Lists.newArrayList(expression), true)
+                val hashRelationResultIterator = hashRelationKernel.finishByIterator()
+                // we need to set original recordBatch to hashRelationKernel
+                while (depIter.hasNext) {
+                  val dep_cb = depIter.next()
+                  if (dep_cb.numRows > 0) {
+                    (0 until dep_cb.numCols).toList.foreach(i =>
+                      dep_cb.column(i).asInstanceOf[ArrowWritableColumnVector].retain())
+                    buildRelationBatchHolder += dep_cb
+                    val dep_rb = ConverterUtils.createArrowRecordBatch(dep_cb)
+                    hashRelationResultIterator.processAndCacheOne(ctx.inputSchema, dep_rb)
+                    ConverterUtils.releaseArrowRecordBatch(dep_rb)
+                  }
+                }
+                // we need to set hashRelationObject to hashRelationResultIterator
+                hashRelationResultIterator.setHashRelationObject(hashRelationObject)
+                dependentKernelIterators +=
+                  hashRelationResultIterator.publishCachedHashRelation(cachedRelationId)
+                hashRelationResultIterator.close()
+              } catch {
+                case e: Throwable =>
+                  BatchIterator.abortCachedHashRelation(cachedRelationId)
+                  throw e
               }
             }
-            // we need to set hashRelationObject to hashRelationResultIterator
-            hashRelationResultIterator.setHashRelationObject(hashRelationObject)
             build_elapse += (System.nanoTime() - beforeEval)
             buildTime += ((System.nanoTime() - beforeEval) / 1000000)
             dependentKernels += hashRelationKernel
@@ -355,7 +378,33 @@ case class ColumnarWholeStageCodegenExec(child: SparkPlan)(val codegenStageId: I
           }
         case other =>
           /* we should cache result from this operator */
-          curRDD.zipPartitions(other.executeColumnar()) { (iter, depIter) =>
+          // A sort on exactly the join keys is done by the relation kernel itself, which
+          // only sorts row indices and lets SortMergeJoin read payload through them.
+          val deferredSort: Option[ColumnarSortExec] = (other, parentPlan) match {
+            case (s: ColumnarSortExec, parent: ColumnarSortMergeJoinExec)
+                if ColumnarPluginConfig.getConf.enableSortDeferPayload && s.limit < 0 =>
+              val joinKeys =
+                if (other.equals(parent.buildPlan)) parent.buildKeys else parent.streamedKeys
+              val sortKeys = s.sortOrder.map(_.child)
+              if (sortKeys.length == joinKeys.length &&
+                  !sortKeys.exists(_.dataType.isInstanceOf[DecimalType]) &&
+                  sortKeys.zip(joinKeys).forall { case (l, r) => l.semanticEquals(r) }) {
+                Some(s)
+              } else {
+                None
+              }
+            case _ => None
+          }
+          val depRDD = deferredSort match {
+            case Some(s) => s.child.executeColumnar()
+            case None => other.executeColumnar()
+          }
+          // the skipped sort never runs, so its metrics are filled from the relation kernel
+          val deferredSortMetrics = deferredSort.map { s =>
+            (s.longMetric("sortTime"), s.longMetric("processTime"),
+              s.longMetric("numOutputRows"))
+          }
+          curRDD.zipPartitions(depRDD) { (iter, depIter) =>
             ExecutorManager.tryTaskSet(numaBindingInfo)
             val curOutput = other match {
               case p: ColumnarSortMergeJoinExec => p.output_skip_alias
@@ -378,7 +427,15 @@ case class ColumnarWholeStageCodegenExec(child: SparkPlan)(val codegenStageId: I
               if (other.equals(parent.buildPlan))
                 parent.buildKeys.map(ConverterUtils.getAttrFromExpr(_))
               else parent.streamedKeys.map(ConverterUtils.getAttrFromExpr(_))
-            val cachedFunction = prepareRelationFunction(keyAttributes, curOutput)
+            val cachedFunction = deferredSort match {
+              case Some(s) =>
+                ColumnarSorter.prepareKernelFunction(
+                  s.sortOrder,
+                  curOutput,
+                  sparkConf,
+                  result_type = 1)
+              case None => prepareRelationFunction(keyAttributes, curOutput)
+            }
             val expression =
               TreeBuilder.makeExpression(
                 cachedFunction,
@@ -389,21 +446,33 @@ case class ColumnarWholeStageCodegenExec(child: SparkPlan)(val codegenStageId: I
               Lists.newArrayList(expression),
               outputSchema,
               true)
+            var sort_elapse: Long = 0
+            var sort_num_rows: Long = 0
             while (depIter.hasNext) {
               val dep_cb = depIter.next()
               if (dep_cb.numRows > 0) {
                 (0 until dep_cb.numCols).toList.foreach(i =>
                   dep_cb.column(i).asInstanceOf[ArrowWritableColumnVector].retain())
                 buildRelationBatchHolder += dep_cb
+                val beforeSort = System.nanoTime()
                 val dep_rb = ConverterUtils.createArrowRecordBatch(dep_cb)
                 cachedRelationKernel.evaluate(dep_rb)
                 ConverterUtils.releaseArrowRecordBatch(dep_rb)
+                sort_elapse += System.nanoTime() - beforeSort
+                sort_num_rows += dep_cb.numRows
               }
             }
             dependentKernels += cachedRelationKernel
             val beforeEval = System.nanoTime()
             dependentKernelIterators += cachedRelationKernel.finishByIterator()
             build_elapse += System.nanoTime() - beforeEval
+            sort_elapse += System.nanoTime() - beforeEval
+            deferredSortMetrics.foreach {
+              case (sortTime, processTime, numOutputRows) =>
+                sortTime += (sort_elapse / 1000000)
+                processTime += (sort_elapse / 1000000)
+                numOutputRows += sort_num_rows
+            }
             iter
           }
       }
@@ -447,7 +516,7 @@ case class ColumnarWholeStageCodegenExec(child: SparkPlan)(val codegenStageId: I
           new Iterator[ColumnarBatch] {
             override def hasNext: Boolean = {
               val res = nativeIterator.hasNext
-              if (res == false) updateMetrics(nativeIterator)
+              if (res == false) updateMetrics(nativeIterator, dependentKernels)
               res
             }
 
@@ -471,8 +540,10 @@ case class ColumnarWholeStageCodegenExec(child: SparkPlan)(val codegenStageId: I
         case _ if contains_aggregate =>
           new Iterator[ColumnarBatch] {
             var processed = false
+            // groups a partial aggregate flushed are handed out before more input is
+            // processed, so they don't pile up in native memory
             def process: Unit = {
-              while (iter.hasNext) {
+              while (iter.hasNext && !nativeIterator.hasFlushedOutput) {
                 val cb = iter.next()
                 if (cb.numRows == 0) {
                   val resultColumnVectors =
@@ -488,12 +559,12 @@ case class ColumnarWholeStageCodegenExec(child: SparkPlan)(val codegenStageId: I
                 ConverterUtils.releaseArrowRecordBatch(input_rb)
                 eval_elapse += System.nanoTime() - beforeEval
               }
-              processed = true
+              processed = !nativeIterator.hasFlushedOutput
             }
             override def hasNext: Boolean = {
               if (!processed) process
-              val res = nativeIterator.hasNext
-              if (res == false) updateMetrics(nativeIterator)
+              val res = !processed || nativeIterator.hasNext
+              if (res == false) updateMetrics(nativeIterator, dependentKernels)
               res
             }
 
@@ -520,7 +591,7 @@ case class ColumnarWholeStageCodegenExec(child: SparkPlan)(val codegenStageId: I
           new Iterator[ColumnarBatch] {
             override def hasNext: Boolean = {
               val res = iter.hasNext
-              if (res == false) updateMetrics(nativeIterator)
+              if (res == false) updateMetrics(nativeIterator, dependentKernels)
               res
             }
 
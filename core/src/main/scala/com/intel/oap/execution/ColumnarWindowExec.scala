@@ -19,41 +19,54 @@ package com.intel.oap.execution
 
 import java.util.concurrent.TimeUnit
 
+import com.google.common.collect.Lists
 import com.google.flatbuffers.FlatBufferBuilder
 import com.intel.oap.ColumnarPluginConfig
 import com.intel.oap.expression.{CodeGeneration, ConverterUtils}
 import com.intel.oap.vectorized.{ArrowWritableColumnVector, CloseableColumnBatchIterator, ExpressionEvaluator}
 import org.apache.arrow.gandiva.expression.TreeBuilder
+import org.apache.arrow.vector.ipc.message.ArrowRecordBatch
 import org.apache.arrow.vector.types.pojo.{ArrowType, Field, FieldType, Schema}
 import org.apache.arrow.vector.types.pojo.ArrowType.ArrowTypeID
 import org.apache.spark.rdd.RDD
-import org.apache.spark.sql.catalyst.expressions.{Alias, Ascending, Attribute, AttributeReference, Cast, Descending, Expression, NamedExpression, Rank, SortOrder, WindowExpression, WindowFunction}
-import org.apache.spark.sql.catalyst.expressions.aggregate.{AggregateExpression, Average, Sum}
+import org.apache.spark.sql.catalyst.expressions.{Alias, Ascending, Attribute, AttributeReference, Cast, CurrentRow, Descending, Expression, NamedExpression, NullsFirst, Rank, RangeFrame, SortOrder, SpecifiedWindowFrame, UnboundedFollowing, UnboundedPreceding, WindowExpression, WindowFunction}
+import org.apache.spark.sql.catalyst.expressions.aggregate.{AggregateExpression, Average, Count, Max, Min, Sum}
 import org.apache.spark.sql.execution.window.WindowExec
 import org.apache.spark.sql.execution.SparkPlan
 import org.apache.spark.sql.execution.datasources.v2.arrow.SparkMemoryUtils
 import org.apache.spark.sql.execution.metric.SQLMetrics
 import org.apache.spark.sql.internal.SQLConf
-import org.apache.spark.sql.types.ArrayType
+import org.apache.spark.sql.types.{ArrayType, BooleanType, ByteType, DataType, DateType, DoubleType, FloatType, IntegerType, LongType, ShortType, StringType}
 import org.apache.spark.sql.util.ArrowUtils
 import org.apache.spark.sql.vectorized.ColumnarBatch
 import org.apache.spark.util.ExecutorManager
 
 import scala.collection.JavaConverters._
-import scala.collection.mutable.ListBuffer
+import scala.collection.mutable
 
+/**
+ * streaming is decided by the rule that plans this node, as it also decides whether
+ * the sort under Window is kept.
+ */
 class ColumnarWindowExec(windowExpression: Seq[NamedExpression],
     partitionSpec: Seq[Expression],
     orderSpec: Seq[SortOrder],
-    child: SparkPlan) extends WindowExec(windowExpression,
+    child: SparkPlan)(val streaming: Boolean) extends WindowExec(windowExpression,
   partitionSpec, orderSpec, child) {
 
   override def supportsColumnar = true
 
   override def output: Seq[Attribute] = child.output ++ windowExpression.map(_.toAttribute)
 
-  // We no longer require for sorted input for columnar window
-  override def requiredChildOrdering: Seq[Seq[SortOrder]] = Seq.fill(children.size)(Nil)
+  override def otherCopyArgs: Seq[AnyRef] = Seq(streaming.asInstanceOf[java.lang.Boolean])
+
+  // Input sorted by partition keys lets window output batches before all input is read,
+  // otherwise sorted input is not required.
+  override def requiredChildOrdering: Seq[Seq[SortOrder]] = if (streaming) {
+    Seq(partitionSpec.map(SortOrder(_, Ascending)) ++ orderSpec)
+  } else {
+    Seq.fill(children.size)(Nil)
+  }
 
   override lazy val metrics = Map(
     "numOutputRows" -> SQLMetrics.createMetric(sparkContext, "number of output rows"),
@@ -85,6 +98,9 @@ class ColumnarWindowExec(windowExpression: Seq[NamedExpression],
         val name = f match {
           case _: Sum => "sum"
           case _: Average => "avg"
+          case _: Count => "count"
+          case _: Min => "min"
+          case _: Max => "max"
           case _: Rank =>
             val desc: Option[Boolean] = orderSpec.foldLeft[Option[Boolean]](None) {
               (desc, s) =>
@@ -116,6 +132,37 @@ class ColumnarWindowExec(windowExpression: Seq[NamedExpression],
         "specified in window")
   }
 
+  // Frames of aggregate functions as (isRange, lower, upper), bounds are offsets from the
+  // current row. None for rank, and for sum and avg over the whole partition.
+  val windowFrames: Seq[Option[(Boolean, Double, Double)]] = windowExpression
+      .map(e => e.asInstanceOf[Alias].child.asInstanceOf[WindowExpression])
+      .zip(windowFunctions)
+      .map { case (w, (name, f)) =>
+        w.windowSpec.frameSpecification match {
+          case _ if name.startsWith("rank") => None
+          case SpecifiedWindowFrame(_, UnboundedPreceding, UnboundedFollowing)
+              if name == "sum" || name == "avg" => None
+          case SpecifiedWindowFrame(frameType, lower, upper) =>
+            ColumnarWindowExec.checkFrameFunction(name, f)
+            val frame = (frameType == RangeFrame, ColumnarWindowExec.frameBound(lower),
+                ColumnarWindowExec.frameBound(upper))
+            val hasOffset = Seq(frame._2, frame._3).exists(b => b != 0 && !b.isInfinity)
+            if (frame._1 && hasOffset && !(orderSpec.size == 1 &&
+                ColumnarWindowExec.supportsRangeOffset(orderSpec.head.dataType))) {
+              throw new UnsupportedOperationException("unsupported RANGE frame order: " +
+                  orderSpec)
+            }
+            Some(frame)
+          case f => throw new UnsupportedOperationException("unsupported window frame: " + f)
+        }
+      }
+
+  if (windowFrames.exists(_.isDefined) && !orderSpec.forall(o =>
+    o.child.isInstanceOf[AttributeReference] &&
+        ColumnarWindowExec.supportsComparing(o.dataType))) {
+    throw new UnsupportedOperationException("unsupported window order: " + orderSpec)
+  }
+
   override protected def doExecuteColumnar(): RDD[ColumnarBatch] = {
     child.executeColumnar().mapPartitionsWithIndex { (partIndex, iter) =>
       ExecutorManager.tryTaskSet(numaBindingInfo)
@@ -123,9 +170,19 @@ class ColumnarWindowExec(windowExpression: Seq[NamedExpression],
         Iterator.empty
       } else {
         val prev1 = System.nanoTime()
-        val gWindowFunctions = windowFunctions.map { case (n, f) =>
+        val gWindowFunctions = windowFunctions.zip(windowFrames).map { case ((n, f), frame) =>
+          val gFrame = frame.map { case (isRange, lower, upper) =>
+            TreeBuilder.makeFunction("frameSpec",
+              Lists.newArrayList(
+                TreeBuilder.makeLiteral(isRange.asInstanceOf[java.lang.Boolean]),
+                TreeBuilder.makeLiteral(lower.asInstanceOf[java.lang.Double]),
+                TreeBuilder.makeLiteral(upper.asInstanceOf[java.lang.Double])),
+              NoneType.NONE_TYPE)
+          }
           TreeBuilder.makeFunction(n,
-            f.children
+            // count(1) counts rows, it has no parameter
+            (f.children
+                .filterNot(e => n == "count" && e.foldable)
                 .map(e =>
                   e match {
                     case a: AttributeReference =>
@@ -137,7 +194,7 @@ class ColumnarWindowExec(windowExpression: Seq[NamedExpression],
                         Field.nullable(c.child.asInstanceOf[AttributeReference].name,
                           CodeGeneration.getResultType(c.dataType))
                       )
-                  }).toList.asJava,
+                  }).toList ++ gFrame).asJava,
             NoneType.NONE_TYPE)
         }
         val groupingExpressions = partitionSpec.map(e => e.asInstanceOf[AttributeReference])
@@ -158,19 +215,49 @@ class ColumnarWindowExec(windowExpression: Seq[NamedExpression],
             Field.nullable(s"window_res_" + i, t)
           }.asJava)
 
+        val gOrderSpec = if (windowFrames.exists(_.isDefined)) {
+          List(TreeBuilder.makeFunction("orderSpec", Lists.newArrayList(
+            TreeBuilder.makeFunction("key_field",
+              orderSpec.map(o => o.child.asInstanceOf[AttributeReference]).map(a =>
+                TreeBuilder.makeField(Field.nullable(a.name,
+                  CodeGeneration.getResultType(a.dataType)))).toList.asJava,
+              NoneType.NONE_TYPE),
+            TreeBuilder.makeFunction("sort_directions",
+              orderSpec.map(o => TreeBuilder.makeLiteral(
+                (o.direction == Ascending).asInstanceOf[java.lang.Boolean])).toList.asJava,
+              NoneType.NONE_TYPE),
+            TreeBuilder.makeFunction("sort_nulls_order",
+              orderSpec.map(o => TreeBuilder.makeLiteral(
+                (o.nullOrdering == NullsFirst).asInstanceOf[java.lang.Boolean])).toList.asJava,
+              NoneType.NONE_TYPE)),
+            NoneType.NONE_TYPE))
+        } else {
+          Nil
+        }
+        val gStreaming = if (streaming) {
+          List(TreeBuilder.makeFunction("streaming", Lists.newArrayList(), NoneType.NONE_TYPE))
+        } else {
+          Nil
+        }
         val window = TreeBuilder.makeFunction("window",
-          (gWindowFunctions.toList ++ List(gPartitionSpec)).asJava, returnType)
+          (gWindowFunctions.toList ++ List(gPartitionSpec) ++ gOrderSpec ++ gStreaming).asJava,
+          returnType)
 
         val evaluator = new ExpressionEvaluator()
         val resultSchema = new Schema(resultField.getChildren)
         val arrowSchema = ArrowUtils.toArrowSchema(child.schema, SQLConf.get.sessionLocalTimeZone)
         evaluator.build(arrowSchema,
           List(TreeBuilder.makeExpression(window,
-            resultField)).asJava, resultSchema, true)
-        val inputCache = new ListBuffer[ColumnarBatch]()
+            resultField)).asJava, resultSchema, !streaming)
+        SparkMemoryUtils.addLeakSafeTaskCompletionListener[Unit](_ => evaluator.close())
+        // input batches waiting for their window results, which come out in input order
+        val inputCache = new mutable.Queue[ColumnarBatch]()
+        val outputCache = new mutable.Queue[ArrowRecordBatch]()
         val buildCost = System.nanoTime() - prev1
         totalTime += TimeUnit.NANOSECONDS.toMillis(buildCost)
-        iter.foreach(c => {
+        var finished = false
+
+        def evaluate(c: ColumnarBatch): Unit = {
           numInputBatches += 1
           val prev2 = System.nanoTime()
           inputCache += c
@@ -178,37 +265,62 @@ class ColumnarWindowExec(windowExpression: Seq[NamedExpression],
               .foreach(_.asInstanceOf[ArrowWritableColumnVector].retain())
           val recordBatch = ConverterUtils.createArrowRecordBatch(c)
           try {
-            evaluator.evaluate(recordBatch)
+            outputCache ++= evaluator.evaluate(recordBatch)
           } finally {
             recordBatch.close()
           }
           val evaluationCost = System.nanoTime() - prev2
           totalTime += TimeUnit.NANOSECONDS.toMillis(evaluationCost)
-        })
+        }
 
-        val prev3 = System.nanoTime()
-        val batches = evaluator.finish()
-        SparkMemoryUtils.addLeakSafeTaskCompletionListener[Unit](_ => evaluator.close())
-        val windowFinishCost = System.nanoTime() - prev3
-        totalTime += TimeUnit.NANOSECONDS.toMillis(windowFinishCost)
-        val itr = batches.zipWithIndex.map { case (recordBatch, i) => {
-          val prev4 = System.nanoTime()
-          val length = recordBatch.getLength
-          val vectors = try {
-             ArrowWritableColumnVector.loadColumns(length, resultSchema, recordBatch)
-          } finally {
-            recordBatch.close()
+        def finish(): Unit = {
+          val prev3 = System.nanoTime()
+          outputCache ++= evaluator.finish()
+          finished = true
+          val windowFinishCost = System.nanoTime() - prev3
+          totalTime += TimeUnit.NANOSECONDS.toMillis(windowFinishCost)
+        }
+
+        if (!streaming) {
+          iter.foreach(evaluate)
+          finish()
+        }
+
+        val itr = new Iterator[ColumnarBatch] {
+          override def hasNext: Boolean = {
+            while (outputCache.isEmpty && !finished) {
+              if (iter.hasNext) {
+                evaluate(iter.next())
+              } else {
+                finish()
+              }
+            }
+            outputCache.nonEmpty
           }
-          val correspondingInputBatch = inputCache(i)
-          val batch = new ColumnarBatch(
-            (0 until correspondingInputBatch.numCols()).map(i => correspondingInputBatch.column(i)).toArray
-                ++ vectors, correspondingInputBatch.numRows())
-          val emitCost = System.nanoTime() - prev4
-          totalTime += TimeUnit.NANOSECONDS.toMillis(emitCost)
-          numOutputRows += batch.numRows()
-          numOutputBatches += 1
-          batch
-        }}.toIterator
+
+          override def next(): ColumnarBatch = {
+            if (!hasNext) {
+              throw new NoSuchElementException
+            }
+            val recordBatch = outputCache.dequeue()
+            val prev4 = System.nanoTime()
+            val length = recordBatch.getLength
+            val vectors = try {
+              ArrowWritableColumnVector.loadColumns(length, resultSchema, recordBatch)
+            } finally {
+              recordBatch.close()
+            }
+            val correspondingInputBatch = inputCache.dequeue()
+            val batch = new ColumnarBatch(
+              (0 until correspondingInputBatch.numCols()).map(i => correspondingInputBatch.column(i)).toArray
+                  ++ vectors, correspondingInputBatch.numRows())
+            val emitCost = System.nanoTime() - prev4
+            totalTime += TimeUnit.NANOSECONDS.toMillis(emitCost)
+            numOutputRows += batch.numRows()
+            numOutputBatches += 1
+            batch
+          }
+        }
         new CloseableColumnBatchIterator(itr)
       }
     }
@@ -248,3 +360,62 @@ class ColumnarWindowExec(windowExpression: Seq[NamedExpression],
     override def isComplex: Boolean = false
   }
 }
+
+object ColumnarWindowExec {
+  // Key types whose rows native window can compare, as partition keys when streaming and
+  // as order keys of frames.
+  def supportsComparing(dataType: DataType): Boolean = dataType match {
+    case BooleanType | ByteType | ShortType | IntegerType | LongType | FloatType |
+         DoubleType | DateType | StringType => true
+    case _ => false
+  }
+
+  def supportsStreaming(partitionSpec: Seq[Expression]): Boolean = {
+    partitionSpec.forall { e =>
+      e.isInstanceOf[AttributeReference] && supportsComparing(e.dataType)
+    }
+  }
+
+  // Order key types of RANGE frames with offsets, dates are offset by days.
+  def supportsRangeOffset(dataType: DataType): Boolean = dataType match {
+    case ByteType | ShortType | IntegerType | LongType | FloatType | DoubleType |
+         DateType => true
+    case _ => false
+  }
+
+  // Unbounded frame ends are infinite offsets.
+  def frameBound(bound: Expression): Double = bound match {
+    case UnboundedPreceding => Double.NegativeInfinity
+    case UnboundedFollowing => Double.PositiveInfinity
+    case CurrentRow => 0.0
+    case e if e.foldable => e.eval() match {
+      case n: Number => n.doubleValue()
+      case v => throw new UnsupportedOperationException("unsupported frame bound: " + v)
+    }
+    case e => throw new UnsupportedOperationException("unsupported frame bound: " + e)
+  }
+
+  // Aggregates over frames take one numeric parameter, min and max also take dates, count
+  // also takes any type or a non null literal.
+  def checkFrameFunction(name: String, f: Expression): Unit = {
+    val params = f.children.filterNot(e => name == "count" && e.foldable && e.eval() != null)
+    val paramTypes = params.map {
+      case a: AttributeReference => Some(a.dataType)
+      case Cast(a: AttributeReference, _, _) => Some(a.dataType)
+      case _ => None
+    }
+    val supported = params.size <= 1 && paramTypes.forall(_.isDefined) &&
+        paramTypes.flatten.forall { t =>
+          (name, t) match {
+            case ("count", _) => true
+            case (_, ByteType | ShortType | IntegerType | LongType | FloatType |
+                     DoubleType) => true
+            case ("min" | "max", DateType) => true
+            case _ => false
+          }
+        } && (name == "count" || params.size == 1)
+    if (!supported) {
+      throw new UnsupportedOperationException("unsupported window frame function: " + f)
+    }
+  }
+}
@@ -92,6 +92,11 @@ class ColumnarAggregateExpression(
           }
         }
         case "stddev_samp" => ("stddev_samp_partial", 1, 3)
+        case "approx_count_distinct" => {
+          val hllpp = aggregateFunction.asInstanceOf[HyperLogLogPlusPlus]
+          (s"approx_count_distinct_partial_${hllpp.relativeSD}", 1,
+            hllpp.aggBufferAttributes.size)
+        }
         case other => (aggregateFunction.prettyName, 1, 1)
       }
     case PartialMerge =>
@@ -105,8 +110,20 @@ class ColumnarAggregateExpression(
         case "count" => ("sum", 1, 1)
         case "avg" => ("avgByCount", 2, 1)
         case "stddev_samp" => ("stddev_samp_final", 3, 1)
+        case "approx_count_distinct" => {
+          val hllpp = aggregateFunction.asInstanceOf[HyperLogLogPlusPlus]
+          (s"approx_count_distinct_final_${hllpp.relativeSD}",
+            hllpp.aggBufferAttributes.size, 1)
+        }
         case other => (aggregateFunction.prettyName, 1, 1)
       }
+    case Complete if isDistinct =>
+      aggregateFunction.prettyName match {
+        case "count" => ("count_distinct", 1, 1)
+        case "sum" => ("sum_distinct", 1, 1)
+        case other =>
+          throw new UnsupportedOperationException(s"doesn't support distinct $other")
+      }
     case _ =>
       throw new UnsupportedOperationException("doesn't support this mode")
   }
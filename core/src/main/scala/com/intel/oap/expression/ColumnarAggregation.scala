@@ -115,7 +115,7 @@ class ColumnarAggregation(
   // we need to remove ordinal used in partial mode expression
   val nonPartialProjectOrdinalList = (0 until originalInputAttributes.size).toList.filter(i => !groupingOrdinalList.contains(i)).to[ListBuffer]
   aggregateExpressions.zipWithIndex.foreach{case(expr, index) => expr.mode match {
-    case Partial => {
+    case Partial | Complete => {
       val internalExpressionList = expr.aggregateFunction.children
       val ordinalList = ColumnarProjection.binding(originalInputAttributes, internalExpressionList, index, skipLiteral = true)
       ordinalList.foreach{i => {
@@ -131,7 +131,7 @@ class ColumnarAggregation(
   } else {
     // we need to filter all Partial mode aggregation
     val columnarExprList = aggregateExpressions.toList.zipWithIndex.map{case(expr, index) => expr.mode match {
-      case Partial => {
+      case Partial | Complete => {
         val res = new ColumnarAggregateExpression(
           expr.aggregateFunction,
           expr.mode,
@@ -294,7 +294,7 @@ class ColumnarAggregation(
             aggregateAttr += attr
             res_index += 1
           }
-          case Final => {
+          case Final | Complete => {
             aggregateAttr += aggregateAttributeList(res_index)
             res_index += 1
           }
@@ -309,7 +309,7 @@ class ColumnarAggregation(
             aggregateAttr += attr
             res_index += 1
           }
-          case Final => {
+          case Final | Complete => {
             aggregateAttr += aggregateAttributeList(res_index)
             res_index += 1
           }
@@ -366,6 +366,22 @@ class ColumnarAggregation(
           case other =>
             throw new UnsupportedOperationException(s"not currently supported: $other.")
         }
+        case hllpp: HyperLogLogPlusPlus => mode match {
+          case Partial => {
+            val aggBufferAttr = hllpp.inputAggBufferAttributes
+            for (index <- 0 until aggBufferAttr.size) {
+              val attr = ConverterUtils.getAttrFromExpr(aggBufferAttr(index))
+              aggregateAttr += attr
+            }
+            res_index += aggBufferAttr.size
+          }
+          case Final => {
+            aggregateAttr += aggregateAttributeList(res_index)
+            res_index += 1
+          }
+          case other =>
+            throw new UnsupportedOperationException(s"not currently supported: $other.")
+        }
         case other =>
           throw new UnsupportedOperationException(s"not currently supported: $other.")
       }
@@ -81,9 +81,14 @@ object ColumnarConditionedProbeJoin extends Logging {
       buildKeysFunctionList.asJava,
       new ArrowType.Int(32, true) /*dummy ret type, won't be used*/ )
     val builder_type_node = TreeBuilder.makeLiteral(builder_type.asInstanceOf[Integer])
+    val build_threads_node = TreeBuilder.makeLiteral(
+      ColumnarPluginConfig.getSessionConf.hashRelationBuildThreads.asInstanceOf[Integer])
+    val build_min_rows_node = TreeBuilder.makeLiteral(
+      ColumnarPluginConfig.getSessionConf.hashRelationParallelBuildMinRows
+        .asInstanceOf[java.lang.Long])
     val build_keys_config_node = TreeBuilder.makeFunction(
       "build_keys_config_node",
-      Lists.newArrayList(builder_type_node),
+      Lists.newArrayList(builder_type_node, build_threads_node, build_min_rows_node),
       new ArrowType.Int(32, true) /*dummy ret type, won't be used*/ )
     // Make Expresion for conditionedProbe
     val hash_relation_kernel = TreeBuilder.makeFunction(
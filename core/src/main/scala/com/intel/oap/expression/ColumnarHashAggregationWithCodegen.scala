@@ -259,10 +259,14 @@ object ColumnarHashAggregationWithCodegen extends Logging {
               aggregateFunc.children.toList.map(expr => getColumnarFuncNode(expr))
             case Final | PartialMerge =>
               List(inputAttrQueue.dequeue).map(attr => getColumnarFuncNode(attr))
+            case Complete =>
+              aggregateFunc.children.toList.map(expr => getColumnarFuncNode(expr))
             case other =>
               throw new UnsupportedOperationException(s"not currently supported: $other.")
           }
-        TreeBuilder.makeFunction("action_sum", childrenColumnarFuncNodeList.asJava, resultType)
+        // only sum(DISTINCT) is planned as Complete, see ColumnarDistinctAggregate
+        val actionName = if (mode == Complete) "action_sum_distinct" else "action_sum"
+        TreeBuilder.makeFunction(actionName, childrenColumnarFuncNodeList.asJava, resultType)
       case Count(_) =>
         mode match {
           case Partial =>
@@ -282,6 +286,13 @@ object ColumnarHashAggregationWithCodegen extends Logging {
               List(inputAttrQueue.dequeue).map(attr => getColumnarFuncNode(attr))
             TreeBuilder
               .makeFunction("action_sum", childrenColumnarFuncNodeList.asJava, resultType)
+          case Complete =>
+            val childrenColumnarFuncNodeList =
+              aggregateFunc.children.toList.map(expr => getColumnarFuncNode(expr))
+            TreeBuilder.makeFunction(
+              "action_count_distinct",
+              childrenColumnarFuncNodeList.asJava,
+              resultType)
           case other =>
             throw new UnsupportedOperationException(s"not currently supported: $other.")
         }
@@ -329,6 +340,27 @@ object ColumnarHashAggregationWithCodegen extends Logging {
           case other =>
             throw new UnsupportedOperationException(s"not currently supported: $other.")
         }
+      case hllpp: HyperLogLogPlusPlus =>
+        // sketch is exchanged as the same int64 buffer columns as Spark uses
+        mode match {
+          case Partial =>
+            val childrenColumnarFuncNodeList =
+              aggregateFunc.children.toList.map(expr => getColumnarFuncNode(expr))
+            TreeBuilder.makeFunction(
+              s"action_approx_count_distinct_partial_${hllpp.relativeSD}",
+              childrenColumnarFuncNodeList.asJava,
+              resultType)
+          case Final =>
+            val childrenColumnarFuncNodeList =
+              hllpp.aggBufferAttributes.toList
+                .map(_ => getColumnarFuncNode(inputAttrQueue.dequeue))
+            TreeBuilder.makeFunction(
+              s"action_approx_count_distinct_final_${hllpp.relativeSD}",
+              childrenColumnarFuncNodeList.asJava,
+              resultType)
+          case other =>
+            throw new UnsupportedOperationException(s"not currently supported: $other.")
+        }
       case other =>
         throw new UnsupportedOperationException(s"not currently supported: $other.")
     }
@@ -381,7 +413,7 @@ object ColumnarHashAggregationWithCodegen extends Logging {
               aggregateAttr += attr
               res_index += 1
             }
-            case Final => {
+            case Final | Complete => {
               aggregateAttr += aggregateAttributeList(res_index)
               res_index += 1
             }
@@ -397,7 +429,7 @@ object ColumnarHashAggregationWithCodegen extends Logging {
               aggregateAttr += attr
               res_index += 1
             }
-            case Final => {
+            case Final | Complete => {
               aggregateAttr += aggregateAttributeList(res_index)
               res_index += 1
             }
@@ -457,6 +489,23 @@ object ColumnarHashAggregationWithCodegen extends Logging {
             case other =>
               throw new UnsupportedOperationException(s"not currently supported: $other.")
           }
+        case hllpp: HyperLogLogPlusPlus =>
+          mode match {
+            case Partial => {
+              val aggBufferAttr = hllpp.inputAggBufferAttributes
+              for (index <- 0 until aggBufferAttr.size) {
+                val attr = ConverterUtils.getAttrFromExpr(aggBufferAttr(index))
+                aggregateAttr += attr
+              }
+              res_index += aggBufferAttr.size
+            }
+            case Final => {
+              aggregateAttr += aggregateAttributeList(res_index)
+              res_index += 1
+            }
+            case other =>
+              throw new UnsupportedOperationException(s"not currently supported: $other.")
+          }
         case other =>
           throw new UnsupportedOperationException(s"not currently supported: $other.")
       }
@@ -471,7 +520,8 @@ object ColumnarHashAggregationWithCodegen extends Logging {
       aggregateAttributes: Seq[Attribute],
       resultExpressions: Seq[NamedExpression],
       output: Seq[Attribute],
-      sparkConf: SparkConf): TreeNode = {
+      sparkConf: SparkConf,
+      isSortedInput: Boolean = false): TreeNode = {
     // build gandiva projection here.
     ColumnarPluginConfig.getConf
 
@@ -512,7 +562,7 @@ object ColumnarHashAggregationWithCodegen extends Logging {
     aggregateExpressions.zipWithIndex.foreach {
       case (expr, index) =>
         expr.mode match {
-          case Partial => {
+          case Partial | Complete => {
             val internalExpressionList = expr.aggregateFunction.children
             val ordinalList = ColumnarProjection.binding(
               originalInputAttributes,
@@ -580,9 +630,32 @@ object ColumnarHashAggregationWithCodegen extends Logging {
       null,
       resultExpressions,
       allAggregateResultAttributes)
+    val kernelChildren =
+      Lists.newArrayList[TreeNode](
+        nativeSchemaNode,
+        aggrActionNode,
+        aggregateResultNode,
+        resultExprNode)
+    // partial results are merged after shuffle, so native side may emit one key more than
+    // once when pre-aggregation doesn't pay off
+    if (aggregateExpressions.nonEmpty && aggregateExpressions.forall(_.mode == Partial)) {
+      kernelChildren.add(
+        TreeBuilder.makeFunction(
+          "partialAggregate",
+          Lists.newArrayList(),
+          resultType /*dummy ret type, won't be used*/ ))
+    }
+    // rows of one group are adjacent, so native side needs no hash table
+    if (isSortedInput && groupingExpressions.nonEmpty) {
+      kernelChildren.add(
+        TreeBuilder.makeFunction(
+          "sortedAggregate",
+          Lists.newArrayList(),
+          resultType /*dummy ret type, won't be used*/ ))
+    }
     TreeBuilder.makeFunction(
       "hashAggregateArrays",
-      Lists.newArrayList(nativeSchemaNode, aggrActionNode, aggregateResultNode, resultExprNode),
+      kernelChildren,
       resultType /*dummy ret type, won't be used*/ )
 
   }
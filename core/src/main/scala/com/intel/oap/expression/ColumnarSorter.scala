@@ -59,7 +59,8 @@ class ColumnarSorter(
     outputRows: SQLMetric,
     shuffleTime: SQLMetric,
     elapse: SQLMetric,
-    sparkConf: SparkConf)
+    sparkConf: SparkConf,
+    peakMemory: SQLMetric = null)
     extends Logging {
   var processedNumRows: Long = 0
   var sort_elapse: Long = 0
@@ -95,6 +96,9 @@ class ColumnarSorter(
     inputBatchHolder.foreach(cb => cb.close())
     inputBatchHolder.clear
     if (sorter != null) {
+      if (peakMemory != null) {
+        peakMemory += sorter.getPeakMemory
+      }
       sorter.close()
     }
     if (sort_iterator != null) {
@@ -230,7 +234,8 @@ object ColumnarSorter extends Logging {
       sortOrder: Seq[SortOrder],
       outputAttributes: Seq[Attribute],
       sparkConf: SparkConf,
-      result_type: Int = 0): TreeNode = {
+      result_type: Int = 0,
+      limit: Int = -1): TreeNode = {
     logInfo(s"ColumnarSorter sortOrder is ${sortOrder}, outputAttributes is ${outputAttributes}")
     val NaNCheck = ColumnarPluginConfig.getConf.enableColumnarNaNCheck
     val codegen = ColumnarPluginConfig.getConf.enableColumnarCodegenSort
@@ -333,18 +338,26 @@ object ColumnarSorter extends Logging {
       Lists.newArrayList(TreeBuilder.makeLiteral(result_type.asInstanceOf[Integer])),
       new ArrowType.Int(32, true) /*dummy ret type, won't be used*/ )
 
+    val sortFuncArgs = Lists.newArrayList(
+      sort_keys_node,
+      key_args_node,
+      dir_node,
+      nulls_order_node,
+      NaN_check_node,
+      codegen_node,
+      result_type_node)
+    // with a limit, native only keeps the first limit rows of each partition
+    if (limit >= 0) {
+      sortFuncArgs.add(
+        TreeBuilder.makeFunction(
+          "sort_limit",
+          Lists.newArrayList(TreeBuilder.makeLiteral(limit.asInstanceOf[Integer])),
+          new ArrowType.Int(32, true) /*dummy ret type, won't be used*/ ))
+    }
     val sortFuncName = "sortArraysToIndices"
     val sort_func_node = TreeBuilder.makeFunction(
       sortFuncName,
-      Lists
-        .newArrayList(
-          sort_keys_node,
-          key_args_node,
-          dir_node,
-          nulls_order_node,
-          NaN_check_node,
-          codegen_node,
-          result_type_node),
+      sortFuncArgs,
       new ArrowType.Int(32, true) /*dummy ret type, won't be used*/ )
 
     TreeBuilder.makeFunction(
@@ -356,7 +369,8 @@ object ColumnarSorter extends Logging {
   def init(
       sortOrder: Seq[SortOrder],
       outputAttributes: Seq[Attribute],
-      _sparkConf: SparkConf): (ExpressionTree, Schema) = {
+      _sparkConf: SparkConf,
+      limit: Int): (ExpressionTree, Schema) = {
     val outputFieldList: List[Field] = outputAttributes.toList.map(expr => {
       val attr = ConverterUtils.getAttrFromExpr(expr)
       Field
@@ -364,7 +378,7 @@ object ColumnarSorter extends Logging {
     })
     val retType = Field.nullable("res", new ArrowType.Int(32, true))
     val sort_node =
-      prepareKernelFunction(sortOrder, outputAttributes, _sparkConf)
+      prepareKernelFunction(sortOrder, outputAttributes, _sparkConf, limit = limit)
 
     (TreeBuilder.makeExpression(sort_node, retType), new Schema(outputFieldList.asJava))
   }
@@ -377,8 +391,9 @@ object ColumnarSorter extends Logging {
       outputRows: SQLMetric,
       shuffleTime: SQLMetric,
       elapse: SQLMetric,
-      sparkConf: SparkConf): String = synchronized {
-    val (sort_expr, arrowSchema) = init(sortOrder, outputAttributes, sparkConf)
+      sparkConf: SparkConf,
+      limit: Int = -1): String = synchronized {
+    val (sort_expr, arrowSchema) = init(sortOrder, outputAttributes, sparkConf, limit)
     val sorter = new ExpressionEvaluator()
     val signature = sorter
       .build(arrowSchema, Lists.newArrayList(sort_expr), arrowSchema, true /*return at finish*/ )
@@ -395,8 +410,10 @@ object ColumnarSorter extends Logging {
       outputRows: SQLMetric,
       shuffleTime: SQLMetric,
       elapse: SQLMetric,
-      sparkConf: SparkConf): ColumnarSorter = synchronized {
-    val (sort_expr, arrowSchema) = init(sortOrder, outputAttributes, sparkConf)
+      sparkConf: SparkConf,
+      limit: Int = -1,
+      peakMemory: SQLMetric = null): ColumnarSorter = synchronized {
+    val (sort_expr, arrowSchema) = init(sortOrder, outputAttributes, sparkConf, limit)
     val sorter = new ExpressionEvaluator(listJars.toList.asJava)
     sorter
       .build(arrowSchema, Lists.newArrayList(sort_expr), arrowSchema, true /*return at finish*/ )
@@ -408,7 +425,8 @@ object ColumnarSorter extends Logging {
       outputRows,
       shuffleTime,
       elapse,
-      sparkConf)
+      sparkConf,
+      peakMemory)
   }
 
 }
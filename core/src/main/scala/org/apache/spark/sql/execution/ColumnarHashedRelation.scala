@@ -18,13 +18,22 @@
 package org.apache.spark.sql.execution
 
 import java.io._
+import java.util.UUID
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.atomic.AtomicLong
 
 import com.esotericsoftware.kryo.io.{Input, Output}
 import com.esotericsoftware.kryo.{Kryo, KryoSerializable}
+import com.intel.oap.ColumnarPluginConfig
 import com.intel.oap.expression.ConverterUtils
-import com.intel.oap.vectorized.{ArrowWritableColumnVector, SerializableObject}
+import com.intel.oap.vectorized.{ArrowWritableColumnVector, BatchIterator, SerializableObject}
+import org.apache.arrow.dataset.jni.{NativeMemoryPool, ReservationListener}
+import org.apache.arrow.memory.OutOfMemoryException
+import org.apache.spark.SparkEnv
+import org.apache.spark.memory.MemoryMode
 import org.apache.spark.sql.execution.ColumnarHashedRelation.Deallocator
 import org.apache.spark.sql.vectorized.ColumnarBatch
+import org.apache.spark.storage.TempLocalBlockId
 import org.apache.spark.util.KnownSizeEstimation
 import sun.misc.Cleaner
 
@@ -36,6 +45,10 @@ class ColumnarHashedRelation(
     with KryoSerializable
     with KnownSizeEstimation {
 
+  // executor-local ids of the native hash relations built on top of this copy,
+  // keyed by build signature since one broadcast may be joined on different keys.
+  @transient private var cachedRelationIds = new ConcurrentHashMap[String, java.lang.Long]()
+
   createCleaner(hashRelationObj, arrowColumnarBatch)
 
   def this() = {
@@ -47,7 +60,20 @@ class ColumnarHashedRelation(
       // no need to clean up
       return
     }
-    Cleaner.create(this, new Deallocator(obj, batch))
+    Cleaner.create(this, new Deallocator(cachedRelationIds, obj, batch))
+  }
+
+  /**
+   * Returns the id used to share one native hash relation built with
+   * buildSignature among all tasks of this executor.
+   */
+  def getCachedRelationId(buildSignature: String): Long = {
+    ColumnarHashedRelation.initCachedRelationPool()
+    cachedRelationIds.computeIfAbsent(
+      buildSignature,
+      new java.util.function.Function[String, java.lang.Long] {
+        override def apply(k: String): java.lang.Long = ColumnarHashedRelation.nextRelationId()
+      })
   }
 
 
@@ -76,6 +102,7 @@ class ColumnarHashedRelation(
     arrowColumnarBatchSize = rawArrowData.length
     arrowColumnarBatch =
       ConverterUtils.convertFromNetty(null, new ByteArrayInputStream(rawArrowData)).toArray
+    cachedRelationIds = new ConcurrentHashMap[String, java.lang.Long]()
     createCleaner(hashRelationObj, arrowColumnarBatch)
     // retain all cols
     /*arrowColumnarBatch.foreach(cb => {
@@ -91,6 +118,7 @@ class ColumnarHashedRelation(
     arrowColumnarBatchSize = rawArrowData.length
     arrowColumnarBatch =
       ConverterUtils.convertFromNetty(null, new ByteArrayInputStream(rawArrowData)).toArray
+    cachedRelationIds = new ConcurrentHashMap[String, java.lang.Long]()
     createCleaner(hashRelationObj, arrowColumnarBatch)
     // retain all cols
     /*arrowColumnarBatch.foreach(cb => {
@@ -123,12 +151,49 @@ class ColumnarHashedRelation(
 }
 object ColumnarHashedRelation {
 
+  private val relationIdGenerator = new AtomicLong(0)
+
+  def nextRelationId(): Long = relationIdGenerator.getAndIncrement()
+
+  // Native relations shared by the tasks of this executor outlive any task, so their
+  // memory is acquired from Spark storage memory instead of a task memory consumer.
+  private class CachedRelationReservationListener extends ReservationListener {
+    private val blockId = TempLocalBlockId(UUID.randomUUID())
+
+    override def reserve(size: Long): Unit = {
+      if (!SparkEnv.get.memoryManager.acquireStorageMemory(
+            blockId, size, MemoryMode.OFF_HEAP)) {
+        throw new OutOfMemoryException(
+          s"Not enough storage memory to cache hash relation of $size bytes")
+      }
+    }
+
+    override def unreserve(size: Long): Unit = {
+      SparkEnv.get.memoryManager.releaseStorageMemory(size, MemoryMode.OFF_HEAP)
+    }
+  }
+
+  private lazy val cachedRelationPool: NativeMemoryPool = {
+    val pool = NativeMemoryPool.createListenable(new CachedRelationReservationListener)
+    BatchIterator.setCachedHashRelationPool(
+      pool,
+      ColumnarPluginConfig.getConf.hashRelationCacheCapacity)
+    pool
+  }
+
+  def initCachedRelationPool(): Unit = cachedRelationPool
+
   private class Deallocator (
+      var cachedRelationIds: ConcurrentHashMap[String, java.lang.Long],
       var hashRelationObj: SerializableObject,
       var arrowColumnarBatch: Array[ColumnarBatch]) extends Runnable {
 
     override def run(): Unit = {
       try {
+        // drop the shared native relation before its memory is released
+        cachedRelationIds.values().forEach(new java.util.function.Consumer[java.lang.Long] {
+          override def accept(id: java.lang.Long): Unit = BatchIterator.evictCachedHashRelation(id)
+        })
         Option(hashRelationObj).foreach(_.close())
         Option(arrowColumnarBatch).foreach(_.foreach(_.close))
       } catch {
@@ -0,0 +1,132 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.apache.spark.sql
+
+import com.intel.oap.execution.{ColumnarExpandExec, ColumnarHashAggregateExec}
+import org.apache.spark.SparkConf
+import org.apache.spark.sql.catalyst.expressions.aggregate.{Partial, PartialMerge}
+import org.apache.spark.sql.execution.ExpandExec
+import org.apache.spark.sql.functions._
+import org.apache.spark.sql.internal.SQLConf
+import org.apache.spark.sql.test.SharedSparkSession
+
+/**
+ * ROLLUP, CUBE and GROUPING SETS pre-aggregated before Expand, checked against
+ * vanilla Spark.
+ */
+class ColumnarGroupingSetsSuite extends QueryTest with SharedSparkSession {
+  import testImplicits._
+
+  override def sparkConf: SparkConf =
+    super.sparkConf
+      .setAppName("test")
+      .set("spark.sql.parquet.columnarReaderBatchSize", "4096")
+      .set("spark.sql.sources.useV1SourceList", "avro")
+      .set("spark.sql.extensions", "com.intel.oap.ColumnarPlugin")
+      .set("spark.sql.execution.arrow.maxRecordsPerBatch", "4096")
+      .set("spark.memory.offHeap.enabled", "true")
+      .set("spark.memory.offHeap.size", "50m")
+      .set("spark.sql.join.preferSortMergeJoin", "false")
+      .set("spark.sql.columnar.codegen.hashAggregate", "false")
+      .set("spark.oap.sql.columnar.wholestagecodegen", "false")
+      .set("spark.sql.columnar.window", "false")
+      .set("spark.unsafe.exceptionOnMemoryLeak", "false")
+      .set("spark.sql.columnar.sort.broadcastJoin", "true")
+      .set("spark.oap.sql.columnar.preferColumnar", "true")
+      .set(SQLConf.ADAPTIVE_EXECUTION_ENABLED.key, "false")
+
+  private val columnarEnabledKey = "org.apache.spark.example.columnar.enabled"
+
+  // null grouping values must stay apart from the nulls Expand puts in coarser sets
+  private def data: DataFrame =
+    Seq[(Integer, String, Integer)](
+      (1, "a", 10),
+      (1, "b", 20),
+      (1, "b", null),
+      (null, "a", 30),
+      (2, null, 40),
+      (2, null, null),
+      (null, null, 50),
+      (null, null, 60)).toDF("k1", "k2", "v")
+
+  private def vanillaAnswer(query: DataFrame => DataFrame): Seq[Row] = {
+    var answer: Seq[Row] = Nil
+    withSQLConf(columnarEnabledKey -> "false") {
+      val vanilla = query(data)
+      assert(vanilla.queryExecution.executedPlan.collect { case e: ExpandExec => e }.size == 1)
+      answer = vanilla.collect().toSeq
+    }
+    answer
+  }
+
+  /* Runs query with and without the plugin, the plugin's plan has to aggregate the
+   * input before Expand and return the same rows. */
+  private def checkGroupingSets(query: DataFrame => DataFrame): Unit = {
+    val expected = vanillaAnswer(query)
+    val df = query(data)
+    val plan = df.queryExecution.executedPlan
+    val merges = plan.collect {
+      case agg @ ColumnarHashAggregateExec(_, _, _, _, _, _, expand: ColumnarExpandExec)
+          if agg.aggregateExpressions.forall(_.mode == PartialMerge) =>
+        expand.child
+    }
+    assert(merges.size == 1, plan)
+    merges.head match {
+      case partial: ColumnarHashAggregateExec =>
+        assert(partial.aggregateExpressions.forall(_.mode == Partial), plan)
+        assert(!partial.child.isInstanceOf[ColumnarExpandExec], plan)
+      case other => fail(s"Expected partial aggregate under Expand, got $other")
+    }
+    checkAnswer(df, expected)
+  }
+
+  test("rollup with null grouping values") {
+    checkGroupingSets(
+      _.rollup("k1", "k2")
+        .agg(avg("v"), count("*"), sum("v"), grouping_id()))
+  }
+
+  test("cube with null grouping values") {
+    checkGroupingSets(
+      _.cube("k1", "k2")
+        .agg(avg("v"), count("*"), count("v"), min("v"), max("v"), grouping_id()))
+  }
+
+  test("grouping sets") {
+    checkGroupingSets { df =>
+      df.createOrReplaceTempView("grouping_sets_data")
+      sql(
+        """SELECT k1, k2, avg(v), count(*), grouping_id() FROM grouping_sets_data
+          |GROUP BY k1, k2 GROUPING SETS ((k1, k2), (k2), ())""".stripMargin)
+    }
+  }
+
+  test("grouping sets are not pre-aggregated when disabled") {
+    val query = (df: DataFrame) => df.rollup("k1", "k2").agg(avg("v"), count("*"))
+    val expected = vanillaAnswer(query)
+    withSQLConf("spark.oap.sql.columnar.hashAggregate.groupingSets.preAggregate" -> "false") {
+      val df = query(data)
+      val expands = df.queryExecution.executedPlan.collect {
+        case expand: ColumnarExpandExec => expand
+      }
+      assert(expands.size == 1)
+      assert(!expands.head.child.isInstanceOf[ColumnarHashAggregateExec])
+      checkAnswer(df, expected)
+    }
+  }
+}
@@ -17,11 +17,13 @@
 
 package org.apache.spark.sql
 
+import com.intel.oap.execution.ColumnarHashAggregateExec
 import org.apache.spark.SparkConf
 
 import scala.util.Random
 import org.scalatest.Matchers.the
-import org.apache.spark.sql.execution.WholeStageCodegenExec
+import org.apache.spark.sql.catalyst.expressions.aggregate.Complete
+import org.apache.spark.sql.execution.{ColumnarShuffleExchangeExec, WholeStageCodegenExec}
 import org.apache.spark.sql.execution.adaptive.AdaptiveSparkPlanHelper
 import org.apache.spark.sql.execution.aggregate.{HashAggregateExec, ObjectHashAggregateExec, SortAggregateExec}
 import org.apache.spark.sql.execution.exchange.ShuffleExchangeExec
@@ -419,6 +421,71 @@ class DataFrameAggregateSuite extends QueryTest
     )
   }
 
+  test("distinct aggregate is deduplicated natively after one shuffle") {
+    withSQLConf(SQLConf.ADAPTIVE_EXECUTION_ENABLED.key -> "false") {
+      val df = testData2.union(testData2)
+        .groupBy("a").agg(countDistinct($"b"), sumDistinct($"b"), sum($"b"))
+      checkAnswer(df, Row(1, 2, 3, 6) :: Row(2, 2, 3, 6) :: Row(3, 2, 3, 6) :: Nil)
+
+      val plan = df.queryExecution.executedPlan
+      val distinctAggregates = plan.collect {
+        case agg: ColumnarHashAggregateExec
+            if agg.aggregateExpressions.exists(e => e.isDistinct && e.mode == Complete) =>
+          agg
+      }
+      assert(distinctAggregates.size == 1, plan)
+      val shuffles = plan.collect {
+        case s: ShuffleExchangeExec => s
+        case s: ColumnarShuffleExchangeExec => s
+      }
+      assert(shuffles.size == 1, plan)
+    }
+  }
+
+  test("distinct aggregate of types native distinct doesn't take is not collapsed") {
+    withSQLConf(SQLConf.ADAPTIVE_EXECUTION_ENABLED.key -> "false") {
+      val data = testData2.union(testData2)
+        .select($"a", ($"b" === 1).as("flag"), $"b".cast(DecimalType(10, 2)).as("d"))
+      Seq(
+        (data.groupBy("a").agg(countDistinct($"flag")),
+          Seq(Row(1, 2), Row(2, 2), Row(3, 2))),
+        (data.groupBy("a").agg(sumDistinct($"d")),
+          Seq(Row(1, BigDecimal("3.00")), Row(2, BigDecimal("3.00")),
+            Row(3, BigDecimal("3.00"))))).foreach { case (df, expected) =>
+        checkAnswer(df, expected)
+        val plan = df.queryExecution.executedPlan
+        val collapsed = plan.collect {
+          case agg: ColumnarHashAggregateExec
+              if agg.aggregateExpressions.exists(e => e.isDistinct && e.mode == Complete) =>
+            agg
+        }
+        assert(collapsed.isEmpty, plan)
+      }
+    }
+  }
+
+  private val columnarEnabledKey = "org.apache.spark.example.columnar.enabled"
+
+  test("approx_count_distinct is the same as vanilla Spark") {
+    // 20 groups of 200 to 4000 distinct values, most of them corrected by bias
+    val data = spark.range(0, 80000)
+      .select(($"id" % 20).as("g"), ($"id" % (($"id" % 20 + 1) * 4000)).as("v"))
+    Seq(0.01, 0.02, 0.05, 0.1, 0.3).foreach { rsd =>
+      val query = (df: DataFrame) => df.groupBy("g").agg(
+        approx_count_distinct($"v", rsd),
+        approx_count_distinct($"v".cast("string"), rsd),
+        approx_count_distinct($"v".cast("double"), rsd))
+      var expected: Seq[Row] = Nil
+      withSQLConf(columnarEnabledKey -> "false") {
+        expected = query(data).collect().toSeq
+      }
+      val df = query(data)
+      val plan = df.queryExecution.executedPlan
+      assert(plan.collect { case agg: ColumnarHashAggregateExec => agg }.nonEmpty, plan)
+      checkAnswer(df, expected)
+    }
+  }
+
   ignore("zero count") {
     val emptyTableData = Seq.empty[(Int, Int)].toDF("a", "b")
     checkAnswer(
@@ -19,9 +19,11 @@ package org.apache.spark.sql
 
 import java.sql.Date
 
+import com.intel.oap.execution.ColumnarWindowExec
 import org.apache.spark.SparkConf
-import org.apache.spark.sql.expressions.Window
+import org.apache.spark.sql.expressions.{Window, WindowSpec}
 import org.apache.spark.sql.functions._
+import org.apache.spark.sql.internal.SQLConf
 import org.apache.spark.sql.test.SharedSparkSession
 
 /**
@@ -376,6 +378,107 @@ class DataFrameWindowFramesSuite extends QueryTest with SharedSparkSession {
         Row(10, 6000) :: Nil)
   }
 
+  private val columnarEnabledKey = "org.apache.spark.example.columnar.enabled"
+
+  // 1 next to 1e20, Inf, -Inf and NaN values, and null and NaN order keys
+  private def frameData: DataFrame =
+    Seq[(Integer, java.lang.Double, java.lang.Double, Date)](
+      (1, 1.0, 1e20, Date.valueOf("2020-01-01")),
+      (1, 2.0, 1.0, Date.valueOf("2020-01-02")),
+      (1, 2.5, 1.0, Date.valueOf("2020-01-04")),
+      (1, 4.0, Double.PositiveInfinity, Date.valueOf("2020-01-05")),
+      (1, Double.NaN, 1.0, Date.valueOf("2020-01-05")),
+      (1, Double.NaN, Double.NegativeInfinity, Date.valueOf("2020-01-09")),
+      (1, null, null, null),
+      (1, null, 2.0, Date.valueOf("2020-01-03")),
+      (2, 1.0, Double.NaN, Date.valueOf("2020-01-01")),
+      (2, 2.0, 3.0, Date.valueOf("2020-01-01")),
+      (2, 3.0, 4.0, Date.valueOf("2020-01-02")),
+      (null, 1.0, 5.0, Date.valueOf("2020-01-01"))).toDF("k", "o", "v", "d")
+
+  /* Runs query with native window, streaming or not, which has to return the rows of
+   * vanilla Spark */
+  private def checkColumnarFrames(query: DataFrame => DataFrame): Unit = {
+    var expected: Seq[Row] = Nil
+    withSQLConf(columnarEnabledKey -> "false") {
+      expected = query(frameData).collect().toSeq
+    }
+    Seq("true", "false").foreach { streaming =>
+      withSQLConf("spark.sql.columnar.window" -> "true",
+        "spark.oap.sql.columnar.window.streaming" -> streaming) {
+        val df = query(frameData)
+        val plan = df.queryExecution.executedPlan
+        assert(plan.collect { case w: ColumnarWindowExec => w }.nonEmpty, plan)
+        checkAnswer(df, expected)
+      }
+    }
+  }
+
+  private def frameFunctions(window: WindowSpec): DataFrame => DataFrame = df =>
+    df.select($"k", $"o", $"v",
+      sum($"v").over(window), avg($"v").over(window), count($"v").over(window),
+      min($"v").over(window), max($"v").over(window))
+
+  test("columnar rows between against vanilla Spark") {
+    val window = Window.partitionBy($"k")
+    checkColumnarFrames(frameFunctions(window.orderBy($"o".asc_nulls_first)
+      .rowsBetween(-1, 0)))
+    checkColumnarFrames(frameFunctions(window.orderBy($"o".desc_nulls_last)
+      .rowsBetween(-1, 1)))
+    checkColumnarFrames(frameFunctions(window.orderBy($"o".asc_nulls_last)
+      .rowsBetween(Window.unboundedPreceding, Window.currentRow)))
+    // empty at the end of each partition
+    checkColumnarFrames(frameFunctions(window.orderBy($"o".desc_nulls_first)
+      .rowsBetween(1, 2)))
+  }
+
+  test("columnar range between against vanilla Spark") {
+    val window = Window.partitionBy($"k")
+    checkColumnarFrames(frameFunctions(window.orderBy($"o".asc_nulls_first)
+      .rangeBetween(-1, 0)))
+    checkColumnarFrames(frameFunctions(window.orderBy($"o".desc_nulls_first)
+      .rangeBetween(0, 2)))
+    checkColumnarFrames(frameFunctions(window.orderBy($"o".asc_nulls_last)
+      .rangeBetween(Window.currentRow, Window.unboundedFollowing)))
+    // empty where no key is 1 to 2 after the one of the row
+    checkColumnarFrames(frameFunctions(window.orderBy($"o".desc_nulls_last)
+      .rangeBetween(1, 2)))
+  }
+
+  test("columnar range between dates against vanilla Spark") {
+    checkColumnarFrames(_.selectExpr("k", "d", "v",
+      "sum(v) OVER (PARTITION BY k ORDER BY d RANGE BETWEEN 2 PRECEDING AND CURRENT ROW)",
+      "min(d) OVER (PARTITION BY k ORDER BY d DESC RANGE BETWEEN CURRENT ROW AND " +
+        "3 FOLLOWING)",
+      "count(v) OVER (PARTITION BY k ORDER BY d RANGE BETWEEN 1 FOLLOWING AND " +
+        "2 FOLLOWING)"))
+  }
+
+  test("columnar window streams only over input sorted without a sort") {
+    withSQLConf(SQLConf.ADAPTIVE_EXECUTION_ENABLED.key -> "false",
+      SQLConf.AUTO_BROADCASTJOIN_THRESHOLD.key -> "-1") {
+      val keys = frameData.select($"k".as("k2")).distinct()
+      val query = (df: DataFrame) =>
+        df.select($"k", $"v", sum($"v").over(Window.partitionBy($"k")))
+      // sort merge join output is already sorted by k, a sort for window is not
+      Seq((frameData.join(keys, $"k" === $"k2"), true), (frameData, false)).foreach {
+        case (input, streaming) =>
+          var expected: Seq[Row] = Nil
+          withSQLConf(columnarEnabledKey -> "false") {
+            expected = query(input).collect().toSeq
+          }
+          withSQLConf("spark.sql.columnar.window" -> "true",
+            "spark.oap.sql.columnar.window.streaming" -> "true") {
+            val df = query(input)
+            val plan = df.queryExecution.executedPlan
+            val windows = plan.collect { case w: ColumnarWindowExec => w }
+            assert(windows.nonEmpty && windows.forall(_.streaming == streaming), plan)
+            checkAnswer(df, expected)
+          }
+      }
+    }
+  }
+
   test("SPARK-24033: Analysis Failure of OffsetWindowFunction") {
     val ds = Seq((1, 1), (1, 2), (1, 3), (2, 1), (2, 2)).toDF("n", "i")
     val res =
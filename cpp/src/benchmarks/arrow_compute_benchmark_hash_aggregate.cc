@@ -29,6 +29,7 @@
 #include <parquet/file_reader.h>
 
 #include <chrono>
+#include <cstdlib>
 
 #include "codegen/code_generator.h"
 #include "codegen/code_generator_factory.h"
@@ -233,5 +234,93 @@ TEST_F(BenchmarkArrowComputeHashAggregate, GroupbyAggregateWithAvgBenchmark) {
   StartWithIterator(aggr_expr);
 }
 
+TEST_F(BenchmarkArrowComputeHashAggregate, GroupbyAggregateParallelBenchmark) {
+  ////////////////////// prepare expr_vector ///////////////////////
+  f_res = field("res", arrow::uint64());
+
+  std::vector<std::shared_ptr<::gandiva::Node>> gandiva_field_list;
+  for (auto field : field_list) {
+    gandiva_field_list.push_back(TreeExprBuilder::MakeField(field));
+  }
+  auto n_groupby = TreeExprBuilder::MakeFunction(
+      "action_groupby", {gandiva_field_list[primary_key_index]}, uint32());
+  auto n_sum_1 =
+      TreeExprBuilder::MakeFunction("action_sum", {gandiva_field_list[1]}, uint32());
+  auto n_sum_2 =
+      TreeExprBuilder::MakeFunction("action_sum", {gandiva_field_list[2]}, uint32());
+  auto n_proj = TreeExprBuilder::MakeFunction("aggregateExpressions", gandiva_field_list,
+                                              uint32());
+  auto n_action = TreeExprBuilder::MakeFunction("aggregateActions",
+                                                {n_groupby, n_sum_1, n_sum_2}, uint32());
+  auto n_aggr =
+      TreeExprBuilder::MakeFunction("hashAggregateArrays", {n_proj, n_action}, uint32());
+  auto n_child = TreeExprBuilder::MakeFunction("child", {n_aggr}, uint32());
+  auto n_wscg = TreeExprBuilder::MakeFunction("wholestagecodegen", {n_child}, uint32());
+
+  std::shared_ptr<arrow::Schema> schema;
+  schema = arrow::schema(field_list);
+  std::cout << schema->ToString() << std::endl;
+
+  ::gandiva::ExpressionPtr aggrArrays_expr;
+  aggrArrays_expr = TreeExprBuilder::MakeExpression(n_wscg, f_res);
+
+  auto f0_name = field_list[0]->name();
+  auto f1_name = field_list[1]->name();
+  auto f2_name = field_list[2]->name();
+  auto f0_type = field_list[0]->type();
+  ret_field_list = {field(f0_name, f0_type), field(f1_name + "_sum", int64()),
+                    field(f2_name + "_sum", int64())};
+
+  // read all input once, so every run only measures aggregation
+  std::vector<std::shared_ptr<arrow::RecordBatch>> input_batch_list;
+  std::shared_ptr<arrow::RecordBatch> record_batch;
+  do {
+    TIME_MICRO_OR_THROW(elapse_read, record_batch_reader->ReadNext(&record_batch));
+    if (record_batch) input_batch_list.push_back(record_batch);
+  } while (record_batch);
+
+  ///////////////////// Calculation //////////////////
+  uint64_t elapse_single_thread = 0;
+  for (auto num_threads : {1, 2, 4, 8}) {
+    elapse_gen = 0;
+    elapse_eval = 0;
+    elapse_aggr = 0;
+    setenv("NATIVESQL_AGGR_THREADS", std::to_string(num_threads).c_str(), 1);
+    std::shared_ptr<CodeGenerator> aggr_expr;
+    TIME_MICRO_OR_THROW(elapse_gen,
+                        CreateCodeGenerator(schema, {aggrArrays_expr}, ret_field_list,
+                                            &aggr_expr, true));
+    std::shared_ptr<ResultIteratorBase> aggr_result_iterator_base;
+    ASSERT_NOT_OK(aggr_expr->finish(&aggr_result_iterator_base));
+    auto aggr_result_iterator =
+        std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+            aggr_result_iterator_base);
+    unsetenv("NATIVESQL_AGGR_THREADS");
+
+    for (auto batch : input_batch_list) {
+      TIME_MICRO_OR_THROW(elapse_eval,
+                          aggr_result_iterator->ProcessAndCacheOne(batch->columns()));
+    }
+    std::shared_ptr<arrow::RecordBatch> result_batch;
+    uint64_t num_output_rows = 0;
+    while (aggr_result_iterator->HasNext()) {
+      TIME_MICRO_OR_THROW(elapse_aggr, aggr_result_iterator->Next(&result_batch));
+      num_output_rows += result_batch->num_rows();
+    }
+    auto elapse_total = elapse_eval + elapse_aggr;
+    if (num_threads == 1) elapse_single_thread = elapse_total;
+
+    std::cout << "==================== Summary ====================\n"
+              << "BenchmarkArrowComputeHashAggregate with " << num_threads
+              << " threads processed " << input_batch_list.size()
+              << " batches\nthen output " << num_output_rows
+              << " groups\nCodeGen took " << TIME_TO_STRING(elapse_gen)
+              << "\nEvaluation took " << TIME_TO_STRING(elapse_eval)
+              << "\nAggregate took " << TIME_TO_STRING(elapse_aggr) << "\nSpeedup is "
+              << (double)elapse_single_thread / elapse_total
+              << ".\n================================================" << std::endl;
+  }
+}
+
 }  // namespace codegen
 }  // namespace sparkcolumnarplugin
@@ -351,5 +351,56 @@ TEST_F(BenchmarkArrowComputeJoin, JoinBenchmarkWithCondition) {
             << "\nProbe and Shuffle took " << TIME_TO_STRING(elapse_probe_process) << "\n"
             << "===========================================" << std::endl;
 }
+
+TEST_F(BenchmarkArrowComputeJoin, HashRelationParallelBuildBenchmark) {
+  std::vector<std::shared_ptr<::gandiva::Node>> left_field_node_list;
+  for (auto field : left_field_list) {
+    left_field_node_list.push_back(TreeExprBuilder::MakeField(field));
+  }
+  auto n_left_key = TreeExprBuilder::MakeFunction(
+      "hash_key_schema", {left_field_node_list[left_primary_key_index]}, uint32());
+  auto f_res = field("res", uint32());
+  auto schema_table_0 = arrow::schema(left_field_list);
+
+  std::vector<std::shared_ptr<arrow::RecordBatch>> left_record_batch_list;
+  std::shared_ptr<arrow::RecordBatch> left_record_batch;
+  do {
+    ASSERT_NOT_OK(left_record_batch_reader->ReadNext(&left_record_batch));
+    if (left_record_batch) left_record_batch_list.push_back(left_record_batch);
+  } while (left_record_batch);
+  std::cout << "Readed left table with " << left_record_batch_list.size() << " batches."
+            << std::endl;
+
+  for (int num_threads : {1, 2, 4, 8}) {
+    auto n_hash_config = TreeExprBuilder::MakeFunction(
+        "build_keys_config_node",
+        {TreeExprBuilder::MakeLiteral((int)1), TreeExprBuilder::MakeLiteral(num_threads)},
+        uint32());
+    auto n_hash_kernel = TreeExprBuilder::MakeFunction(
+        "HashRelation", {n_left_key, n_hash_config}, uint32());
+    auto n_hash = TreeExprBuilder::MakeFunction("standalone", {n_hash_kernel}, uint32());
+    auto hashRelation_expr = TreeExprBuilder::MakeExpression(n_hash, f_res);
+    std::shared_ptr<CodeGenerator> expr_build;
+    ASSERT_NOT_OK(
+        CreateCodeGenerator(schema_table_0, {hashRelation_expr}, {}, &expr_build, true));
+
+    std::vector<std::shared_ptr<arrow::RecordBatch>> dummy_result_batches;
+    std::shared_ptr<ResultIteratorBase> build_result_iterator;
+    uint64_t elapse_eval = 0;
+    uint64_t elapse_finish = 0;
+    for (auto batch : left_record_batch_list) {
+      TIME_MICRO_OR_THROW(elapse_eval,
+                          expr_build->evaluate(batch, &dummy_result_batches));
+    }
+    TIME_MICRO_OR_THROW(elapse_finish, expr_build->finish(&build_result_iterator));
+
+    std::cout << "=========================================="
+              << "\nBenchmarkArrowComputeJoin HashRelation build with " << num_threads
+              << " threads"
+              << "\nLeft Table Evaluate took " << TIME_TO_STRING(elapse_eval)
+              << "\nHash Table Build took " << TIME_TO_STRING(elapse_finish) << "\n"
+              << "===========================================" << std::endl;
+  }
+}
 }  // namespace codegen
 }  // namespace sparkcolumnarplugin
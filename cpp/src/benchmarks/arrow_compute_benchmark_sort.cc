@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 
+#include <arrow/builder.h>
 #include <arrow/filesystem/filesystem.h>
 #include <arrow/io/interfaces.h>
 #include <arrow/memory_pool.h>
@@ -28,8 +29,12 @@
 #include <parquet/arrow/reader.h>
 #include <parquet/file_reader.h>
 
+#include <algorithm>
 #include <chrono>
+#include <random>
 
+#include "codegen/arrow_compute/ext/array_appender.h"
+#include "codegen/arrow_compute/ext/array_gather.h"
 #include "codegen/code_generator.h"
 #include "codegen/code_generator_factory.h"
 #include "codegen/common/result_iterator.h"
@@ -226,5 +231,133 @@ TEST_F(BenchmarkArrowComputeSort, SortBenchmarkWOPayLoad) {
   StartWithIterator(sort_expr);
 }
 
+TEST_F(BenchmarkArrowComputeSort, SortBenchmarkThreads) {
+  ////////////////////// prepare expr_vector ///////////////////////
+  f_res = field("res", arrow::uint64());
+
+  std::vector<std::shared_ptr<::gandiva::Node>> gandiva_field_list;
+  for (auto field : field_list) {
+    gandiva_field_list.push_back(TreeExprBuilder::MakeField(field));
+  }
+  auto n_sort_to_indices =
+      TreeExprBuilder::MakeFunction("sortArraysToIndicesNullsFirstAsc",
+                                    {gandiva_field_list[primary_key_index]}, uint64());
+  std::shared_ptr<arrow::Schema> schema;
+  schema = arrow::schema(field_list);
+
+  ::gandiva::ExpressionPtr sortArrays_expr;
+  sortArrays_expr = TreeExprBuilder::MakeExpression(n_sort_to_indices, f_res);
+
+  ///////////////////// Calculation //////////////////
+  for (auto num_threads : {1, 2, 4, 8}) {
+    elapse_gen = 0;
+    elapse_read = 0;
+    elapse_eval = 0;
+    elapse_sort = 0;
+    elapse_shuffle = 0;
+    num_batches = 0;
+    // every run reads the input from its start
+    ASSERT_NOT_OK(
+        parquet_reader->GetRecordBatchReader({0}, {0, 1, 2}, &record_batch_reader));
+    setenv("NATIVESQL_SORT_THREADS", std::to_string(num_threads).c_str(), 1);
+    std::cout << "Sort with " << num_threads << " threads" << std::endl;
+    std::shared_ptr<CodeGenerator> sort_expr;
+    TIME_MICRO_OR_THROW(elapse_gen,
+                        CreateCodeGenerator(schema, {sortArrays_expr}, ret_field_list,
+                                            &sort_expr, true));
+    StartWithIterator(sort_expr);
+    unsetenv("NATIVESQL_SORT_THREADS");
+  }
+}
+
+/* Builds sorted output batches from shuffled rows of cached batches, through
+ * ArrayGatherer and through the per row appender path it replaced */
+TEST(BenchmarkArrayGather, GatherVsAppender) {
+  using arrowcompute::extra::AppenderBase;
+  using arrowcompute::extra::ArrayGatherer;
+  using arrowcompute::extra::ArrayItemIndexS;
+  using arrowcompute::extra::GatherArrays;
+  using arrowcompute::extra::MakeAppender;
+  using arrowcompute::extra::MakeArrayGatherer;
+  const int num_batches = 256;
+  const int batch_size = 4096;
+  std::vector<std::shared_ptr<arrow::DataType>> types = {arrow::int64(), arrow::float64(),
+                                                         arrow::boolean(), arrow::utf8()};
+  std::mt19937 rng(42);
+  // every 10th value is null
+  std::vector<arrow::ArrayVector> cached(types.size());
+  for (int batch = 0; batch < num_batches; batch++) {
+    arrow::Int64Builder long_builder;
+    arrow::DoubleBuilder double_builder;
+    arrow::BooleanBuilder bool_builder;
+    arrow::StringBuilder string_builder;
+    for (int i = 0; i < batch_size; i++) {
+      auto value = rng();
+      if (value % 10 == 0) {
+        ASSERT_NOT_OK(long_builder.AppendNull());
+        ASSERT_NOT_OK(double_builder.AppendNull());
+        ASSERT_NOT_OK(bool_builder.AppendNull());
+        ASSERT_NOT_OK(string_builder.AppendNull());
+        continue;
+      }
+      ASSERT_NOT_OK(long_builder.Append(value));
+      ASSERT_NOT_OK(double_builder.Append(value / 3.0));
+      ASSERT_NOT_OK(bool_builder.Append(value % 2 == 0));
+      ASSERT_NOT_OK(string_builder.Append(std::string(value % 24, 'a' + value % 26)));
+    }
+    std::shared_ptr<arrow::Array> array;
+    ASSERT_NOT_OK(long_builder.Finish(&array));
+    cached[0].push_back(array);
+    ASSERT_NOT_OK(double_builder.Finish(&array));
+    cached[1].push_back(array);
+    ASSERT_NOT_OK(bool_builder.Finish(&array));
+    cached[2].push_back(array);
+    ASSERT_NOT_OK(string_builder.Finish(&array));
+    cached[3].push_back(array);
+  }
+  std::vector<ArrayItemIndexS> indices;
+  for (int batch = 0; batch < num_batches; batch++) {
+    for (int i = 0; i < batch_size; i++) indices.emplace_back(batch, i);
+  }
+  std::shuffle(indices.begin(), indices.end(), rng);
+  int64_t num_rows = indices.size();
+
+  arrow::compute::FunctionContext ctx;
+  for (int col = 0; col < types.size(); col++) {
+    std::shared_ptr<ArrayGatherer> gatherer;
+    ASSERT_NOT_OK(MakeArrayGatherer(ctx.memory_pool(), types[col], &gatherer));
+    for (auto& array : cached[col]) gatherer->AddArray(array);
+    uint64_t elapse_gather = 0;
+    for (int64_t offset = 0; offset < num_rows; offset += batch_size) {
+      std::vector<std::shared_ptr<arrow::Array>> out;
+      TIME_MICRO_OR_THROW(elapse_gather,
+                          GatherArrays({gatherer}, indices.data() + offset,
+                                       std::min<int64_t>(batch_size, num_rows - offset),
+                                       &out));
+    }
+
+    std::shared_ptr<AppenderBase> appender;
+    ASSERT_NOT_OK(MakeAppender(&ctx, types[col], AppenderBase::left, &appender));
+    for (auto& array : cached[col]) ASSERT_NOT_OK(appender->AddArray(array));
+    uint64_t elapse_append = 0;
+    auto append_batch = [&](int64_t offset) {
+      auto end = std::min<int64_t>(offset + batch_size, num_rows);
+      for (int64_t i = offset; i < end; i++) {
+        RETURN_NOT_OK(appender->Append(indices[i].array_id, indices[i].id));
+      }
+      std::shared_ptr<arrow::Array> out;
+      RETURN_NOT_OK(appender->Finish(&out));
+      return appender->Reset();
+    };
+    for (int64_t offset = 0; offset < num_rows; offset += batch_size) {
+      TIME_MICRO_OR_THROW(elapse_append, append_batch(offset));
+    }
+
+    std::cout << "Gather " << num_rows << " rows of " << types[col]->ToString()
+              << ": ArrayGatherer took " << TIME_TO_STRING(elapse_gather)
+              << ", appender took " << TIME_TO_STRING(elapse_append) << std::endl;
+  }
+}
+
 }  // namespace codegen
 }  // namespace sparkcolumnarplugin
@@ -22,9 +22,12 @@
 #include <arrow/type.h>
 
 #include <chrono>
+#include <memory>
+#include <utility>
 
 #include "codegen/arrow_compute/expr_visitor.h"
 #include "codegen/code_generator.h"
+#include "codegen/common/operator_memory_pool.h"
 #include "codegen/common/result_iterator.h"
 #include "utils/macros.h"
 
@@ -40,7 +43,8 @@ class ArrowComputeCodeGenerator : public CodeGenerator {
       std::vector<std::shared_ptr<gandiva::Expression>> expr_vector,
       std::vector<std::shared_ptr<arrow::Field>> ret_types, bool return_when_finish,
       std::vector<std::shared_ptr<::gandiva::Expression>> finish_exprs_vector)
-      : schema_(schema_ptr),
+      : memory_pool_(OperatorMemoryPool::Make(memory_pool)),
+        schema_(schema_ptr),
         ret_types_(ret_types),
         return_when_finish_(return_when_finish) {
     int i = 0;
@@ -50,13 +54,13 @@ class ArrowComputeCodeGenerator : public CodeGenerator {
     for (auto expr : expr_vector) {
       std::shared_ptr<ExprVisitor> root_visitor;
       if (finish_exprs_vector.empty()) {
-        auto visitor = MakeExprVisitor(memory_pool, schema_ptr, expr, ret_types_, &expr_visitor_cache_,
-                                       &root_visitor);
+        auto visitor = MakeExprVisitor(memory_pool_.get(), schema_ptr, expr, ret_types_,
+                                       &expr_visitor_cache_, &root_visitor);
         auto status = DistinctInsert(root_visitor, &visitor_list_);
       } else {
-        auto visitor =
-            MakeExprVisitor(memory_pool, schema_ptr, expr, ret_types_, finish_exprs_vector[i++],
-                            &expr_visitor_cache_, &root_visitor);
+        auto visitor = MakeExprVisitor(memory_pool_.get(), schema_ptr, expr, ret_types_,
+                                       finish_exprs_vector[i++], &expr_visitor_cache_,
+                                       &root_visitor);
         auto status = DistinctInsert(root_visitor, &visitor_list_);
       }
     }
@@ -246,6 +250,14 @@ class ArrowComputeCodeGenerator : public CodeGenerator {
       TIME_MICRO_OR_RAISE(finish_elapse_time_,
                           visitor->MakeResultIterator(arrow::schema(ret_types_), out));
     }
+    if (*out) {
+      // iterator may outlive this operator and still allocate, so it holds the pool
+      // too. Members of a pair are destroyed in reverse, so iterator goes first.
+      auto holder = std::make_shared<std::pair<std::shared_ptr<OperatorMemoryPool>,
+                                               std::shared_ptr<ResultIteratorBase>>>(
+          memory_pool_->Share(), *out);
+      *out = std::shared_ptr<ResultIteratorBase>(holder, holder->second.get());
+    }
     return arrow::Status::OK();
   }
 
@@ -269,7 +281,16 @@ class ArrowComputeCodeGenerator : public CodeGenerator {
     return arrow::Status::OK();
   }
 
+  arrow::Status GetMemoryUsage(int64_t* bytes_allocated, int64_t* peak_bytes) override {
+    *bytes_allocated = memory_pool_->bytes_allocated();
+    *peak_bytes = memory_pool_->max_memory();
+    return arrow::Status::OK();
+  }
+
  private:
+  // all visitors of this operator allocate from it, so it is declared first and
+  // released last
+  std::shared_ptr<OperatorMemoryPool> memory_pool_;
   std::vector<std::shared_ptr<ExprVisitor>> visitor_list_;
   std::shared_ptr<arrow::Schema> schema_;
   std::shared_ptr<arrow::Schema> res_schema_;
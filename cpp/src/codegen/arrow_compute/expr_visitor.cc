@@ -271,12 +271,16 @@ arrow::Status ExprVisitor::MakeWindow(
   std::shared_ptr<gandiva::FunctionNode> partition_spec;
   std::shared_ptr<gandiva::FunctionNode> order_spec;
   std::shared_ptr<gandiva::FunctionNode> frame_spec;
+  // input is sorted by partition keys, so partitions are computed as they end
+  bool streaming = false;
 
   for (const auto& child : node.children()) {
     auto child_function = std::dynamic_pointer_cast<gandiva::FunctionNode>(child);
     auto child_func_name = child_function->descriptor()->name();
     if (child_func_name == "sum" || child_func_name == "avg" ||
-        child_func_name == "rank_asc" || child_func_name == "rank_desc") {
+        child_func_name == "count" || child_func_name == "min" ||
+        child_func_name == "max" || child_func_name == "rank_asc" ||
+        child_func_name == "rank_desc") {
       window_functions.push_back(child_function);
     } else if (child_func_name == "partitionSpec") {
       partition_spec = child_function;
@@ -284,6 +288,8 @@ arrow::Status ExprVisitor::MakeWindow(
       order_spec = child_function;
     } else if (child_func_name == "frameSpec") {
       frame_spec = child_function;
+    } else if (child_func_name == "streaming") {
+      streaming = true;
     } else {
       return arrow::Status::Invalid("unsupported child function name in window: " +
                                     child_func_name);
@@ -294,8 +300,8 @@ arrow::Status ExprVisitor::MakeWindow(
     return arrow::Status::Invalid("no available function found in window");
   }
   RETURN_NOT_OK((*out)->MakeExprVisitorImpl(func_name, window_functions, partition_spec,
-                                            order_spec, frame_spec, ret_fields,
-                                            (*out).get()));
+                                            order_spec, frame_spec, streaming,
+                                            ret_fields, (*out).get()));
   return arrow::Status::OK();
 }
 
@@ -473,7 +479,10 @@ arrow::Status ExprVisitor::MakeExprVisitorImpl(const std::string& func_name,
       func_name.compare("min") == 0 || func_name.compare("max") == 0 ||
       func_name.compare("stddev_samp_partial") == 0 ||
       func_name.compare("stddev_samp_final") == 0 ||
-      func_name.compare("sum_count_merge") == 0) {
+      func_name.compare("sum_count_merge") == 0 ||
+      func_name.compare("count_distinct") == 0 ||
+      func_name.compare("sum_distinct") == 0 ||
+      func_name.compare(0, 22, "approx_count_distinct_") == 0) {
     RETURN_NOT_OK(AggregateVisitorImpl::Make(p, func_name, &impl_));
     goto finish;
   }
@@ -499,20 +508,37 @@ arrow::Status ExprVisitor::MakeExprVisitorImpl(
     std::vector<std::shared_ptr<gandiva::FunctionNode>> window_functions,
     std::shared_ptr<gandiva::FunctionNode> partition_spec,
     std::shared_ptr<gandiva::FunctionNode> order_spec,
-    std::shared_ptr<gandiva::FunctionNode> frame_spec,
+    std::shared_ptr<gandiva::FunctionNode> frame_spec, bool streaming,
     std::vector<std::shared_ptr<arrow::Field>> ret_fields, ExprVisitor* p) {
   std::vector<std::string> window_function_names;
   std::vector<std::vector<gandiva::FieldPtr>> function_param_fields;
+  std::vector<std::shared_ptr<extra::WindowFrame>> function_frames;
   for (auto window_function : window_functions) {
     std::string window_function_name = window_function->descriptor()->name();
     std::vector<gandiva::FieldPtr> function_param_fields_of_each;
+    // aggregates over a frame other than the whole partition have a frameSpec child
+    // holding is_range, lower and upper literals
+    std::shared_ptr<extra::WindowFrame> frame;
     for (std::shared_ptr<gandiva::Node> child : window_function->children()) {
+      auto frame_node = std::dynamic_pointer_cast<gandiva::FunctionNode>(child);
+      if (frame_node && frame_node->descriptor()->name() == "frameSpec") {
+        auto bounds = frame_node->children();
+        frame = std::make_shared<extra::WindowFrame>();
+        frame->is_range = arrow::util::get<bool>(
+            std::dynamic_pointer_cast<gandiva::LiteralNode>(bounds[0])->holder());
+        frame->lower = arrow::util::get<double>(
+            std::dynamic_pointer_cast<gandiva::LiteralNode>(bounds[1])->holder());
+        frame->upper = arrow::util::get<double>(
+            std::dynamic_pointer_cast<gandiva::LiteralNode>(bounds[2])->holder());
+        continue;
+      }
       std::shared_ptr<gandiva::FieldNode> field =
           std::dynamic_pointer_cast<gandiva::FieldNode>(child);
       function_param_fields_of_each.push_back(field->field());
     }
     window_function_names.push_back(window_function_name);
     function_param_fields.push_back(function_param_fields_of_each);
+    function_frames.push_back(frame);
   }
   std::vector<gandiva::FieldPtr> partition_fields;
   for (std::shared_ptr<gandiva::Node> child : partition_spec->children()) {
@@ -525,9 +551,34 @@ arrow::Status ExprVisitor::MakeExprVisitorImpl(
     std::shared_ptr<arrow::DataType> type = return_field->type();
     return_types.push_back(type);
   }
-  // todo order_spec frame_spec
-  RETURN_NOT_OK(WindowVisitorImpl::Make(p, window_function_names, return_types,
-                                        function_param_fields, partition_fields, &impl_));
+  // orderSpec children are key_field, sort_directions and sort_nulls_order as in sort
+  std::vector<gandiva::FieldPtr> order_fields;
+  std::vector<bool> sort_directions;
+  std::vector<bool> nulls_order;
+  if (order_spec) {
+    auto order_children = order_spec->children();
+    auto key_field_node =
+        std::dynamic_pointer_cast<gandiva::FunctionNode>(order_children[0]);
+    for (auto child : key_field_node->children()) {
+      auto field_node = std::dynamic_pointer_cast<gandiva::FieldNode>(child);
+      order_fields.push_back(field_node->field());
+    }
+    auto directions_node =
+        std::dynamic_pointer_cast<gandiva::FunctionNode>(order_children[1]);
+    for (auto child : directions_node->children()) {
+      auto lit_node = std::dynamic_pointer_cast<gandiva::LiteralNode>(child);
+      sort_directions.push_back(arrow::util::get<bool>(lit_node->holder()));
+    }
+    auto nulls_order_node =
+        std::dynamic_pointer_cast<gandiva::FunctionNode>(order_children[2]);
+    for (auto child : nulls_order_node->children()) {
+      auto lit_node = std::dynamic_pointer_cast<gandiva::LiteralNode>(child);
+      nulls_order.push_back(arrow::util::get<bool>(lit_node->holder()));
+    }
+  }
+  RETURN_NOT_OK(WindowVisitorImpl::Make(
+      p, window_function_names, return_types, function_param_fields, function_frames,
+      partition_fields, order_fields, sort_directions, nulls_order, streaming, &impl_));
   return arrow::Status();
 }
 
@@ -749,7 +800,8 @@ arrow::Status ExprVisitor::GetResult(
 arrow::Status ExprVisitor::GetResult(
     std::vector<ArrayList>* out, std::vector<int>* out_sizes,
     std::vector<std::shared_ptr<arrow::Field>>* out_fields) {
-  if (result_batch_list_.empty()) {
+  // a streaming visitor may have no batch ready after Eval
+  if (result_batch_list_.empty() && return_type_ != ArrowComputeResultType::BatchList) {
     return arrow::Status::Invalid(
         "ArrowComputeExprVisitor::GetResult result_batch_list was not generated ",
         func_name_);
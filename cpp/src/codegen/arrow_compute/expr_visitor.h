@@ -146,7 +146,7 @@ class ExprVisitor : public std::enable_shared_from_this<ExprVisitor> {
       std::vector<std::shared_ptr<gandiva::FunctionNode>> window_functions,
       std::shared_ptr<gandiva::FunctionNode> partition_spec,
       std::shared_ptr<gandiva::FunctionNode> order_spec,
-      std::shared_ptr<gandiva::FunctionNode> frame_spec,
+      std::shared_ptr<gandiva::FunctionNode> frame_spec, bool streaming,
       std::vector<std::shared_ptr<arrow::Field>> ret_fields,
       ExprVisitor* p);
   arrow::Status AppendAction(const std::string& func_name,
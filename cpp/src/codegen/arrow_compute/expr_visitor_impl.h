@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 
+#include <arrow/array/concatenate.h>
 #include <arrow/pretty_print.h>
 #include <arrow/status.h>
 #include <arrow/type_fwd.h>
@@ -25,8 +26,11 @@
 #include <unistd.h>
 
 #include <chrono>
+#include <deque>
 #include <memory>
 
+#include "codegen/arrow_compute/ext/cmp_function.h"
+#include "codegen/arrow_compute/ext/hyperloglog_plusplus.h"
 #include "codegen/arrow_compute/ext/kernels_ext.h"
 #include "codegen/common/hash_relation.h"
 #include "codegen/common/result_iterator.h"
@@ -260,6 +264,35 @@ class AggregateVisitorImpl : public ExprVisitorImpl {
       RETURN_NOT_OK(
           extra::StddevSampFinalArrayKernel::Make(&p_->ctx_, data_type, &kernel_));
       kernel_list_.push_back(kernel_);
+    } else if (func_name_.compare(0, 30, "approx_count_distinct_partial_") == 0) {
+      // sketch is output as num_words int64 columns
+      double relative_sd = std::stod(func_name_.substr(30));
+      auto num_words = extra::HyperLogLogPlusPlus(relative_sd).num_words();
+      p_->result_fields_.clear();
+      for (int i = 0; i < num_words; i++) {
+        p_->result_fields_.push_back(
+            arrow::field("MS[" + std::to_string(i) + "]", arrow::int64()));
+      }
+      RETURN_NOT_OK(extra::ApproxCountDistinctArrayKernel::Make(
+          &p_->ctx_, data_type, relative_sd, false, &kernel_));
+      kernel_list_.push_back(kernel_);
+    } else if (func_name_.compare(0, 28, "approx_count_distinct_final_") == 0) {
+      double relative_sd = std::stod(func_name_.substr(28));
+      p_->result_fields_.clear();
+      p_->result_fields_.push_back(arrow::field("approx_count_distinct", arrow::int64()));
+      RETURN_NOT_OK(extra::ApproxCountDistinctArrayKernel::Make(
+          &p_->ctx_, data_type, relative_sd, true, &kernel_));
+      kernel_list_.push_back(kernel_);
+    } else if (func_name_.compare("count_distinct") == 0) {
+      p_->result_fields_.clear();
+      p_->result_fields_.push_back(arrow::field("count_distinct", arrow::int64()));
+      RETURN_NOT_OK(
+          extra::DistinctArrayKernel::Make(&p_->ctx_, data_type, false, &kernel_));
+      kernel_list_.push_back(kernel_);
+    } else if (func_name_.compare("sum_distinct") == 0) {
+      RETURN_NOT_OK(
+          extra::DistinctArrayKernel::Make(&p_->ctx_, data_type, true, &kernel_));
+      kernel_list_.push_back(kernel_);
     }
     initialized_ = true;
     finish_return_type_ = ArrowComputeResultType::Batch;
@@ -319,27 +352,50 @@ class AggregateVisitorImpl : public ExprVisitorImpl {
   std::vector<std::shared_ptr<extra::KernalBase>> kernel_list_;
 };
 
+/** WindowVisitorImpl
+ *
+ * Without streaming, every input batch is encoded to partition ids and cached by the
+ * function kernels, which compute all partitions at Finish.
+ * With streaming, input is sorted by partition keys. A partition ends where the keys
+ * of two adjacent rows differ, so rows up to the start of the last partition of a
+ * batch are fed to the kernels, which are finished and reset for the rest. An
+ * input batch is output by the Eval which finishes its last partition, only the
+ * batches of the partition still open are kept.
+ **/
 class WindowVisitorImpl : public ExprVisitorImpl {
  public:
   WindowVisitorImpl(ExprVisitor* p, std::vector<std::string> window_function_names,
                     std::vector<std::shared_ptr<arrow::DataType>> return_types,
                     std::vector<std::vector<gandiva::FieldPtr>> function_param_fields,
-                    std::vector<gandiva::FieldPtr> partition_fields)
+                    std::vector<std::shared_ptr<extra::WindowFrame>> function_frames,
+                    std::vector<gandiva::FieldPtr> partition_fields,
+                    std::vector<gandiva::FieldPtr> order_fields,
+                    std::vector<bool> sort_directions, std::vector<bool> nulls_order,
+                    bool streaming)
       : ExprVisitorImpl(p) {
     this->window_function_names_ = window_function_names;
     this->return_types_ = return_types,
     this->function_param_fields_ = function_param_fields;
+    this->function_frames_ = function_frames;
     this->partition_fields_ = partition_fields;
+    this->order_fields_ = order_fields;
+    this->sort_directions_ = sort_directions;
+    this->nulls_order_ = nulls_order;
+    this->streaming_ = streaming;
   }
 
   static arrow::Status Make(
       ExprVisitor* p, std::vector<std::string> window_function_names,
       std::vector<std::shared_ptr<arrow::DataType>> return_types,
       std::vector<std::vector<gandiva::FieldPtr>> function_param_fields,
+      std::vector<std::shared_ptr<extra::WindowFrame>> function_frames,
       std::vector<gandiva::FieldPtr> partition_fields,
+      std::vector<gandiva::FieldPtr> order_fields, std::vector<bool> sort_directions,
+      std::vector<bool> nulls_order, bool streaming,
       std::shared_ptr<ExprVisitorImpl>* out) {
     auto impl = std::make_shared<WindowVisitorImpl>(
-        p, window_function_names, return_types, function_param_fields, partition_fields);
+        p, window_function_names, return_types, function_param_fields, function_frames,
+        partition_fields, order_fields, sort_directions, nulls_order, streaming);
     *out = impl;
     return arrow::Status::OK();
   }
@@ -356,6 +412,7 @@ class WindowVisitorImpl : public ExprVisitorImpl {
                                               &col_id, &field));
       partition_field_ids_.push_back(col_id);
       partition_type_list.push_back(field->type());
+      partition_key_fields_.push_back(field);
     }
     if (partition_type_list.size() > 1) {
       RETURN_NOT_OK(
@@ -364,12 +421,19 @@ class WindowVisitorImpl : public ExprVisitorImpl {
 
     RETURN_NOT_OK(extra::EncodeArrayKernel::Make(&p_->ctx_, &partition_kernel_));
 
+    std::vector<int> order_field_ids;
+    for (auto order_field : order_fields_) {
+      std::shared_ptr<arrow::Field> field;
+      int col_id;
+      RETURN_NOT_OK(
+          GetColumnIdAndFieldByName(p_->schema_, order_field->name(), &col_id, &field));
+      order_field_ids.push_back(col_id);
+      order_key_fields_.push_back(field);
+    }
+
     for (int func_id = 0; func_id < window_function_names_.size(); func_id++) {
-      std::string window_function_name = window_function_names_.at(func_id);
-      std::shared_ptr<arrow::DataType> return_type = return_types_.at(func_id);
       std::vector<gandiva::FieldPtr> function_param_fields_of_each =
           function_param_fields_.at(func_id);
-      std::shared_ptr<extra::KernalBase> function_kernel;
       std::vector<int> function_param_field_ids_of_each;
       std::vector<std::shared_ptr<arrow::DataType>> function_param_type_list;
       for (auto function_param_field : function_param_fields_of_each) {
@@ -380,32 +444,25 @@ class WindowVisitorImpl : public ExprVisitorImpl {
         function_param_field_ids_of_each.push_back(col_id);
         function_param_type_list.push_back(field->type());
       }
-      function_param_field_ids_.push_back(function_param_field_ids_of_each);
-
-      if (window_function_name == "sum" || window_function_name == "avg") {
-        RETURN_NOT_OK(extra::WindowAggregateFunctionKernel::Make(
-            &p_->ctx_, window_function_name, function_param_type_list, return_type,
-            &function_kernel));
-      } else if (window_function_name == "rank_asc") {
-        RETURN_NOT_OK(extra::WindowRankKernel::Make(&p_->ctx_, window_function_name,
-                                                    function_param_type_list,
-                                                    &function_kernel, false));
-      } else if (window_function_name == "rank_desc") {
-        RETURN_NOT_OK(extra::WindowRankKernel::Make(&p_->ctx_, window_function_name,
-                                                    function_param_type_list,
-                                                    &function_kernel, true));
-      } else {
-        return arrow::Status::Invalid("window function not supported: " +
-                                      window_function_name);
+      if (function_frames_.at(func_id)) {
+        // frame functions take order keys after their parameters
+        function_param_field_ids_of_each.insert(function_param_field_ids_of_each.end(),
+                                                order_field_ids.begin(),
+                                                order_field_ids.end());
       }
-      function_kernels_.push_back(function_kernel);
+      function_param_field_ids_.push_back(function_param_field_ids_of_each);
+      function_param_type_lists_.push_back(function_param_type_list);
     }
+    RETURN_NOT_OK(MakeFunctionKernels());
 
     initialized_ = true;
     return arrow::Status::OK();
   }
 
   arrow::Status Eval() override {
+    if (streaming_) {
+      return StreamingEval();
+    }
     std::shared_ptr<arrow::Array> out1;
     std::shared_ptr<arrow::Array> out2;
     if (partition_field_ids_.empty()) {
@@ -455,6 +512,14 @@ class WindowVisitorImpl : public ExprVisitorImpl {
   }
 
   arrow::Status Finish() override {
+    if (streaming_) {
+      if (!segment_piece_batch_ids_.empty()) {
+        RETURN_NOT_OK(FinishSegment());
+      }
+      RETURN_NOT_OK(EmitPendingBatches(pending_batches_.size()));
+      p_->return_type_ = ArrowComputeResultType::BatchList;
+      return ExprVisitorImpl::Finish();
+    }
     int32_t num_batches = -1;
     std::vector<ArrayList> outs;
     for (int func_id = 0; func_id < window_function_names_.size(); func_id++) {
@@ -507,12 +572,226 @@ class WindowVisitorImpl : public ExprVisitorImpl {
   std::vector<std::string> window_function_names_;
   std::vector<std::shared_ptr<arrow::DataType>> return_types_;
   std::vector<std::vector<gandiva::FieldPtr>> function_param_fields_;
+  std::vector<std::shared_ptr<extra::WindowFrame>> function_frames_;
   std::vector<gandiva::FieldPtr> partition_fields_;
+  std::vector<gandiva::FieldPtr> order_fields_;
+  std::vector<bool> sort_directions_;
+  std::vector<bool> nulls_order_;
+  std::vector<std::shared_ptr<arrow::Field>> order_key_fields_;
   std::vector<std::vector<int>> function_param_field_ids_;
+  std::vector<std::vector<std::shared_ptr<arrow::DataType>>> function_param_type_lists_;
   std::vector<int> partition_field_ids_;
+  std::vector<std::shared_ptr<arrow::Field>> partition_key_fields_;
   std::shared_ptr<extra::KernalBase> concat_kernel_;
   std::shared_ptr<extra::KernalBase> partition_kernel_;
   std::vector<std::shared_ptr<extra::KernalBase>> function_kernels_;
+  bool streaming_;
+  // streaming: keys of the last row evaluated, partition id of it among the rows fed
+  // to function kernels since they were reset, and the input batch of each piece fed
+  ArrayList last_partition_keys_;
+  int32_t segment_partition_id_ = -1;
+  std::vector<int64_t> segment_piece_batch_ids_;
+  // streaming: output pieces of each function for input batches not output yet, the
+  // first of them is input batch num_batches_output_
+  std::deque<std::vector<ArrayList>> pending_batches_;
+  std::deque<int64_t> pending_batch_lengths_;
+  int64_t num_batches_output_ = 0;
+
+  arrow::Status MakeFunctionKernels() {
+    function_kernels_.clear();
+    for (int func_id = 0; func_id < window_function_names_.size(); func_id++) {
+      std::string window_function_name = window_function_names_.at(func_id);
+      std::shared_ptr<arrow::DataType> return_type = return_types_.at(func_id);
+      auto function_param_type_list = function_param_type_lists_.at(func_id);
+      std::shared_ptr<extra::KernalBase> function_kernel;
+      auto frame = function_frames_.at(func_id);
+      if (frame) {
+        RETURN_NOT_OK(extra::WindowFrameAggregateKernel::Make(
+            &p_->ctx_, window_function_name, function_param_type_list,
+            order_key_fields_, sort_directions_, nulls_order_, *frame, return_type,
+            &function_kernel));
+      } else if (window_function_name == "sum" || window_function_name == "avg") {
+        RETURN_NOT_OK(extra::WindowAggregateFunctionKernel::Make(
+            &p_->ctx_, window_function_name, function_param_type_list, return_type,
+            &function_kernel));
+      } else if (window_function_name == "rank_asc") {
+        RETURN_NOT_OK(extra::WindowRankKernel::Make(&p_->ctx_, window_function_name,
+                                                    function_param_type_list,
+                                                    &function_kernel, false));
+      } else if (window_function_name == "rank_desc") {
+        RETURN_NOT_OK(extra::WindowRankKernel::Make(&p_->ctx_, window_function_name,
+                                                    function_param_type_list,
+                                                    &function_kernel, true));
+      } else {
+        return arrow::Status::Invalid("window function not supported: " +
+                                      window_function_name);
+      }
+      function_kernels_.push_back(function_kernel);
+    }
+    return arrow::Status::OK();
+  }
+
+  arrow::Status StreamingEval() {
+    auto in = p_->in_record_batch_;
+    int64_t length = in->num_rows();
+    pending_batches_.emplace_back(window_function_names_.size());
+    pending_batch_lengths_.push_back(length);
+    std::vector<bool> partition_starts;
+    RETURN_NOT_OK(FindPartitionStarts(in, &partition_starts));
+    int64_t last_start = -1;
+    for (int64_t i = length - 1; i >= 0; i--) {
+      if (partition_starts[i]) {
+        last_start = i;
+        break;
+      }
+    }
+    if (last_start == -1) {
+      // every row belongs to the partition still open
+      RETURN_NOT_OK(FeedPiece(in, 0, length, partition_starts));
+    } else {
+      // rows before last_start end every partition open so far
+      if (last_start > 0) {
+        RETURN_NOT_OK(FeedPiece(in, 0, last_start, partition_starts));
+      }
+      if (!segment_piece_batch_ids_.empty()) {
+        RETURN_NOT_OK(FinishSegment());
+      }
+      RETURN_NOT_OK(EmitPendingBatches(pending_batches_.size() - 1));
+      RETURN_NOT_OK(FeedPiece(in, last_start, length - last_start, partition_starts));
+    }
+    p_->return_type_ = ArrowComputeResultType::BatchList;
+    return arrow::Status::OK();
+  }
+
+  /* Marks each row of in whose partition keys differ from those of the row before */
+  arrow::Status FindPartitionStarts(const std::shared_ptr<arrow::RecordBatch>& in,
+                                    std::vector<bool>* out) {
+    int64_t length = in->num_rows();
+    out->assign(length, false);
+    bool has_last = !last_partition_keys_.empty();
+    if (length == 0) return arrow::Status::OK();
+    if (partition_field_ids_.empty()) {
+      // all rows are in one partition
+      (*out)[0] = segment_piece_batch_ids_.empty();
+      return arrow::Status::OK();
+    }
+    // array 0 holds the last row evaluated and array 1 this batch
+    std::vector<arrow::ArrayVector> key_arrays;
+    std::vector<int> key_index_list;
+    for (int i = 0; i < partition_field_ids_.size(); i++) {
+      auto col = in->column(partition_field_ids_[i]);
+      key_arrays.push_back({has_last ? last_partition_keys_[i] : col, col});
+      key_index_list.push_back(i);
+    }
+    std::vector<bool> directions(partition_field_ids_.size(), true);
+    std::vector<func::function<void(int, int, int64_t, int64_t, int&)>> cmp_functions;
+    RETURN_NOT_OK(extra::MakeCmpFunction(key_arrays, partition_key_fields_,
+                                         key_index_list, directions, directions, true,
+                                         cmp_functions));
+    if (cmp_functions.size() != partition_field_ids_.size()) {
+      return arrow::Status::NotImplemented(
+          "WindowVisitorImpl: streaming is not supported for the partition key types");
+    }
+    for (int64_t i = 0; i < length; i++) {
+      if (i == 0 && !has_last) {
+        (*out)[0] = true;
+        continue;
+      }
+      int cmp_res = 2;
+      for (auto& cmp_function : cmp_functions) {
+        if (i == 0) {
+          cmp_function(0, 1, 0, 0, cmp_res);
+        } else {
+          cmp_function(1, 1, i - 1, i, cmp_res);
+        }
+        if (cmp_res != 2) break;
+      }
+      (*out)[i] = cmp_res != 2;
+    }
+    last_partition_keys_.clear();
+    for (int i = 0; i < partition_field_ids_.size(); i++) {
+      last_partition_keys_.push_back(
+          in->column(partition_field_ids_[i])->Slice(length - 1, 1));
+    }
+    return arrow::Status::OK();
+  }
+
+  /* Feeds rows [offset, offset + length) of the last input batch to function kernels */
+  arrow::Status FeedPiece(const std::shared_ptr<arrow::RecordBatch>& in, int64_t offset,
+                          int64_t length, const std::vector<bool>& partition_starts) {
+    if (length == 0) return arrow::Status::OK();
+    arrow::Int32Builder partition_id_builder(p_->ctx_.memory_pool());
+    RETURN_NOT_OK(partition_id_builder.Reserve(length));
+    for (int64_t i = offset; i < offset + length; i++) {
+      if (partition_starts[i]) segment_partition_id_++;
+      partition_id_builder.UnsafeAppend(segment_partition_id_);
+    }
+    std::shared_ptr<arrow::Array> partition_ids;
+    RETURN_NOT_OK(partition_id_builder.Finish(&partition_ids));
+    for (int func_id = 0; func_id < window_function_names_.size(); func_id++) {
+      ArrayList function_in;
+      for (auto col_id : function_param_field_ids_.at(func_id)) {
+        function_in.push_back(in->column(col_id)->Slice(offset, length));
+      }
+      function_in.push_back(partition_ids);
+      RETURN_NOT_OK(function_kernels_.at(func_id)->Evaluate(function_in));
+    }
+    segment_piece_batch_ids_.push_back(num_batches_output_ + pending_batches_.size() - 1);
+    return arrow::Status::OK();
+  }
+
+  /* Computes every partition fed, and resets function kernels for the next */
+  arrow::Status FinishSegment() {
+    for (int func_id = 0; func_id < window_function_names_.size(); func_id++) {
+      ArrayList out0;
+      RETURN_NOT_OK(function_kernels_.at(func_id)->Finish(&out0));
+      if (out0.size() != segment_piece_batch_ids_.size()) {
+        return arrow::Status::Invalid(
+            "WindowVisitorImpl: Return piece count is not the same as input pieces");
+      }
+      for (int i = 0; i < out0.size(); i++) {
+        auto batch_id = segment_piece_batch_ids_[i] - num_batches_output_;
+        pending_batches_[batch_id][func_id].push_back(out0[i]);
+      }
+    }
+    for (auto& function_kernel : function_kernels_) {
+      RETURN_NOT_OK(function_kernel->Reset());
+    }
+    segment_piece_batch_ids_.clear();
+    segment_partition_id_ = -1;
+    return arrow::Status::OK();
+  }
+
+  /* Outputs the first num_batches pending input batches, all computed already */
+  arrow::Status EmitPendingBatches(int num_batches) {
+    for (int i = 0; i < num_batches; i++) {
+      auto& pieces = pending_batches_.front();
+      ArrayList out;
+      for (int func_id = 0; func_id < pieces.size(); func_id++) {
+        auto& function_pieces = pieces[func_id];
+        std::shared_ptr<arrow::Array> column;
+        if (function_pieces.empty()) {
+          // an empty input batch
+          std::unique_ptr<arrow::ArrayBuilder> builder;
+          RETURN_NOT_OK(arrow::MakeBuilder(p_->ctx_.memory_pool(),
+                                           return_types_.at(func_id), &builder));
+          RETURN_NOT_OK(builder->Finish(&column));
+        } else if (function_pieces.size() == 1) {
+          column = function_pieces[0];
+        } else {
+          RETURN_NOT_OK(
+              arrow::Concatenate(function_pieces, p_->ctx_.memory_pool(), &column));
+        }
+        out.push_back(column);
+      }
+      p_->result_batch_list_.push_back(out);
+      p_->result_batch_size_list_.push_back(pending_batch_lengths_.front());
+      pending_batches_.pop_front();
+      pending_batch_lengths_.pop_front();
+      num_batches_output_++;
+    }
+    return arrow::Status::OK();
+  }
 };
 
 ////////////////////////// EncodeVisitorImpl ///////////////////////
@@ -640,10 +919,16 @@ class SortArraysToIndicesVisitorImpl : public ExprVisitorImpl {
     auto codegen_lit_node =
         std::dynamic_pointer_cast<gandiva::LiteralNode>(codegen_func_node->children()[0]);
     do_codegen_ = arrow::util::get<bool>(codegen_lit_node->holder());
-    if (children.size() == 7) {
-      auto type_node = std::dynamic_pointer_cast<gandiva::LiteralNode>(
-          std::dynamic_pointer_cast<gandiva::FunctionNode>(children[6])->children()[0]);
-      result_type_ = arrow::util::get<int>(type_node->holder());
+    // optional children are result_type and sort_limit
+    for (int i = 6; i < children.size(); i++) {
+      auto option_node = std::dynamic_pointer_cast<gandiva::FunctionNode>(children[i]);
+      auto lit_node =
+          std::dynamic_pointer_cast<gandiva::LiteralNode>(option_node->children()[0]);
+      if (option_node->descriptor()->name() == "sort_limit") {
+        limit_ = arrow::util::get<int>(lit_node->holder());
+      } else {
+        result_type_ = arrow::util::get<int>(lit_node->holder());
+      }
     }
     result_schema_ = arrow::schema(ret_fields);
   }
@@ -664,7 +949,7 @@ class SortArraysToIndicesVisitorImpl : public ExprVisitorImpl {
     }
     RETURN_NOT_OK(extra::SortArraysToIndicesKernel::Make(
         &p_->ctx_, result_schema_, sort_key_node_, key_field_list_, sort_directions_,
-        nulls_order_, NaN_check_, do_codegen_, result_type_, &kernel_));
+        nulls_order_, NaN_check_, do_codegen_, result_type_, limit_, &kernel_));
     p_->signature_ = kernel_->GetSignature();
     initialized_ = true;
     finish_return_type_ = ArrowComputeResultType::BatchIterator;
@@ -696,6 +981,11 @@ class SortArraysToIndicesVisitorImpl : public ExprVisitorImpl {
           TIME_MICRO_OR_RAISE(p_->elapse_time_,
                               kernel_->MakeResultIterator(schema, &iter_out));
           *out = std::dynamic_pointer_cast<ResultIteratorBase>(iter_out);
+        } else {
+          std::shared_ptr<ResultIterator<SortRelation>> iter_out;
+          TIME_MICRO_OR_RAISE(p_->elapse_time_,
+                              kernel_->MakeResultIterator(schema, &iter_out));
+          *out = std::dynamic_pointer_cast<ResultIteratorBase>(iter_out);
         }
         p_->return_type_ = ArrowComputeResultType::BatchIterator;
       } break;
@@ -718,6 +1008,8 @@ class SortArraysToIndicesVisitorImpl : public ExprVisitorImpl {
   bool NaN_check_;
   bool do_codegen_;
   int result_type_ = 0;
+  // -1 if there is no limit
+  int64_t limit_ = -1;
   std::shared_ptr<arrow::Schema> result_schema_;
 };
 
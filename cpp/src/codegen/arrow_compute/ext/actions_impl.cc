@@ -20,6 +20,11 @@
 #include <arrow/builder.h>
 #include <arrow/type_traits.h>
 
+#include "codegen/arrow_compute/ext/aggregate_arena.h"
+#include "codegen/arrow_compute/ext/codegen_common.h"
+#include "codegen/arrow_compute/ext/distinct_set.h"
+#include "codegen/arrow_compute/ext/hyperloglog_plusplus.h"
+
 namespace sparkcolumnarplugin {
 namespace codegen {
 namespace arrowcompute {
@@ -86,6 +91,11 @@ arrow::Status ActionBase::Evaluate(int dest_group_id, void* data1, void* data2,
   return arrow::Status::NotImplemented("ActionBase Evaluate is abstract.");
 }
 
+arrow::Status ActionBase::Evaluate(int dest_group_id,
+                                   const std::vector<void*>& data_list) {
+  return arrow::Status::NotImplemented("ActionBase Evaluate is abstract.");
+}
+
 arrow::Status ActionBase::EvaluateNull(int dest_group_id) {
   return arrow::Status::NotImplemented("ActionBase Evaluate is abstract.");
 }
@@ -108,7 +118,12 @@ uint64_t ActionBase::GetResultLength() { return 0; }
 template <typename DataType, typename CType>
 class UniqueAction : public ActionBase {
  public:
-  UniqueAction(arrow::compute::FunctionContext* ctx) : ctx_(ctx) {
+  UniqueAction(arrow::compute::FunctionContext* ctx)
+      : ctx_(ctx),
+        arena_(ctx->memory_pool()),
+        cache_(&arena_),
+        cache_validity_(&arena_),
+        null_flag_(&arena_) {
 #ifdef DEBUG
     std::cout << "Construct UniqueAction" << std::endl;
 #endif
@@ -130,8 +145,9 @@ class UniqueAction : public ActionBase {
                        std::function<arrow::Status()>* on_null) override {
     // resize result data
     if (cache_validity_.size() <= max_group_id) {
-      cache_validity_.resize(max_group_id + 1, false);
-      null_flag_.resize(max_group_id + 1, false);
+      RETURN_NOT_OK(cache_.resize(max_group_id + 1));
+      RETURN_NOT_OK(cache_validity_.resize(max_group_id + 1, false));
+      RETURN_NOT_OK(null_flag_.resize(max_group_id + 1, false));
       length_ = cache_validity_.size();
     }
 
@@ -145,12 +161,10 @@ class UniqueAction : public ActionBase {
         if (cache_validity_[dest_group_id] == false) {
           if (!is_null) {
             cache_validity_[dest_group_id] = true;
-            cache_.emplace(cache_.begin() + dest_group_id, in_->GetView(row_id_));
+            RETURN_NOT_OK(CacheValue(dest_group_id, in_->GetView(row_id_)));
           } else {
             cache_validity_[dest_group_id] = true;
             null_flag_[dest_group_id] = true;
-            CType num;
-            cache_.emplace(cache_.begin() + dest_group_id, num);
           }
         }
         row_id_++;
@@ -160,7 +174,7 @@ class UniqueAction : public ActionBase {
       *on_valid = [this](int dest_group_id) {
         if (cache_validity_[dest_group_id] == false) {
           cache_validity_[dest_group_id] = true;
-          cache_.emplace(cache_.begin() + dest_group_id, in_->GetView(row_id_));
+          RETURN_NOT_OK(CacheValue(dest_group_id, in_->GetView(row_id_)));
         }
         row_id_++;
         return arrow::Status::OK();
@@ -174,38 +188,31 @@ class UniqueAction : public ActionBase {
     return arrow::Status::OK();
   }
 
-  arrow::Status GrowByFactor(int dest_group_id) {
-    int max_group_id;
-    if (cache_validity_.size() < 128) {
-      max_group_id = 128;
-    } else {
-      max_group_id = cache_validity_.size() * 2;
-    }
-    cache_validity_.resize(max_group_id, false);
-    null_flag_.resize(max_group_id, false);
+  arrow::Status Grow(int dest_group_id) {
+    RETURN_NOT_OK(cache_.Grow(dest_group_id));
+    RETURN_NOT_OK(cache_validity_.Grow(dest_group_id, false));
+    RETURN_NOT_OK(null_flag_.Grow(dest_group_id, false));
     return arrow::Status::OK();
   }
 
   arrow::Status Evaluate(int dest_group_id, void* data) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_validity_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     if (cache_validity_[dest_group_id] == false) {
       cache_validity_[dest_group_id] = true;
-      cache_.emplace(cache_.begin() + dest_group_id, *(CType*)data);
+      RETURN_NOT_OK(CacheValue(dest_group_id, *(CType*)data));
     }
     return arrow::Status::OK();
   }
 
   arrow::Status EvaluateNull(int dest_group_id) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_validity_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     if (cache_validity_[dest_group_id] == false) {
       cache_validity_[dest_group_id] = true;
       null_flag_[dest_group_id] = true;
-      CType num;
-      cache_.emplace(cache_.begin() + dest_group_id, num);
     }
     return arrow::Status::OK();
   }
@@ -237,7 +244,7 @@ class UniqueAction : public ActionBase {
     builder_->Reset();
     length = (offset + length) > length_ ? (length_ - offset) : length;
     for (uint64_t i = 0; i < length; i++) {
-      if (cache_validity_[i]) {
+      if (cache_validity_[offset + i]) {
         if (!null_flag_[offset + i]) {
           builder_->Append(cache_[offset + i]);
         } else {
@@ -253,15 +260,31 @@ class UniqueAction : public ActionBase {
  private:
   using ArrayType = typename arrow::TypeTraits<DataType>::ArrayType;
   using BuilderType = typename arrow::TypeTraits<DataType>::BuilderType;
+  // strings are copied into the arena, the cache only keeps views of them
+  using CacheType = typename std::conditional<std::is_same<CType, std::string>::value,
+                                              arrow::util::string_view, CType>::type;
+
+  arrow::Status CacheValue(int dest_group_id, arrow::util::string_view value) {
+    return arena_.CopyString(value, &cache_[dest_group_id]);
+  }
+
+  template <typename T, typename std::enable_if<!std::is_convertible<
+                            const T&, arrow::util::string_view>::value>::type* = nullptr>
+  arrow::Status CacheValue(int dest_group_id, const T& value) {
+    cache_[dest_group_id] = value;
+    return arrow::Status::OK();
+  }
+
   // input
   int row_id_ = 0;
   arrow::compute::FunctionContext* ctx_;
   std::shared_ptr<ArrayType> in_;
   // output
   std::unique_ptr<BuilderType> builder_;
-  std::vector<CType> cache_;
-  std::vector<bool> cache_validity_;
-  std::vector<bool> null_flag_;
+  AggregateArena arena_;
+  ArenaVector<CacheType> cache_;
+  ArenaVector<uint8_t> cache_validity_;
+  ArenaVector<uint8_t> null_flag_;
   uint64_t length_ = 0;
 };
 
@@ -269,7 +292,8 @@ class UniqueAction : public ActionBase {
 template <typename DataType>
 class CountAction : public ActionBase {
  public:
-  CountAction(arrow::compute::FunctionContext* ctx) : ctx_(ctx) {
+  CountAction(arrow::compute::FunctionContext* ctx)
+      : ctx_(ctx), arena_(ctx->memory_pool()), cache_(&arena_) {
 #ifdef DEBUG
     std::cout << "Construct CountAction" << std::endl;
 #endif
@@ -292,7 +316,7 @@ class CountAction : public ActionBase {
                        std::function<arrow::Status()>* on_null) override {
     // resize result data
     if (cache_.size() <= max_group_id) {
-      cache_.resize(max_group_id + 1, 0);
+      RETURN_NOT_OK(cache_.resize(max_group_id + 1, 0));
       length_ = cache_.size();
     }
 
@@ -322,20 +346,14 @@ class CountAction : public ActionBase {
     return arrow::Status::OK();
   }
 
-  arrow::Status GrowByFactor(int dest_group_id) {
-    int max_group_id;
-    if (cache_.size() < 128) {
-      max_group_id = 128;
-    } else {
-      max_group_id = cache_.size() * 2;
-    }
-    cache_.resize(max_group_id, 0);
+  arrow::Status Grow(int dest_group_id) {
+    RETURN_NOT_OK(cache_.Grow(dest_group_id, 0));
     return arrow::Status::OK();
   }
 
   arrow::Status Evaluate(int dest_group_id, void* data) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
 
     cache_[dest_group_id] += 1;
@@ -344,7 +362,7 @@ class CountAction : public ActionBase {
 
   arrow::Status EvaluateNull(int dest_group_id) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     return arrow::Status::OK();
   }
@@ -385,7 +403,8 @@ class CountAction : public ActionBase {
   int32_t row_id;
   // result
   using CType = typename arrow::TypeTraits<DataType>::CType;
-  std::vector<CType> cache_;
+  AggregateArena arena_;
+  ArenaVector<CType> cache_;
   std::unique_ptr<ResBuilderType> builder_;
   uint64_t length_ = 0;
 };
@@ -395,7 +414,7 @@ template <typename DataType>
 class CountLiteralAction : public ActionBase {
  public:
   CountLiteralAction(arrow::compute::FunctionContext* ctx, int arg)
-      : ctx_(ctx), arg_(arg) {
+      : ctx_(ctx), arg_(arg), arena_(ctx->memory_pool()), cache_(&arena_) {
 #ifdef DEBUG
     std::cout << "Construct CountLiteralAction" << std::endl;
 #endif
@@ -418,7 +437,7 @@ class CountLiteralAction : public ActionBase {
                        std::function<arrow::Status()>* on_null) override {
     // resize result data
     if (cache_.size() <= max_group_id) {
-      cache_.resize(max_group_id + 1, 0);
+      RETURN_NOT_OK(cache_.resize(max_group_id + 1, 0));
       length_ = cache_.size();
     }
 
@@ -432,20 +451,14 @@ class CountLiteralAction : public ActionBase {
     return arrow::Status::OK();
   }
 
-  arrow::Status GrowByFactor(int dest_group_id) {
-    int max_group_id;
-    if (cache_.size() < 128) {
-      max_group_id = 128;
-    } else {
-      max_group_id = cache_.size() * 2;
-    }
-    cache_.resize(max_group_id, 0);
+  arrow::Status Grow(int dest_group_id) {
+    RETURN_NOT_OK(cache_.Grow(dest_group_id, 0));
     return arrow::Status::OK();
   }
 
   arrow::Status Evaluate(int dest_group_id) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     cache_[dest_group_id] += arg_;
     return arrow::Status::OK();
@@ -453,7 +466,7 @@ class CountLiteralAction : public ActionBase {
 
   arrow::Status EvaluateNull(int dest_group_id) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     return arrow::Status::OK();
   }
@@ -494,7 +507,8 @@ class CountLiteralAction : public ActionBase {
   int arg_;
   // result
   using CType = typename arrow::TypeTraits<DataType>::CType;
-  std::vector<CType> cache_;
+  AggregateArena arena_;
+  ArenaVector<CType> cache_;
   std::unique_ptr<ResBuilderType> builder_;
   uint64_t length_ = 0;
 };
@@ -503,7 +517,8 @@ class CountLiteralAction : public ActionBase {
 template <typename DataType>
 class MinAction : public ActionBase {
  public:
-  MinAction(arrow::compute::FunctionContext* ctx) : ctx_(ctx) {
+  MinAction(arrow::compute::FunctionContext* ctx)
+      : ctx_(ctx), arena_(ctx->memory_pool()), cache_(&arena_), cache_validity_(&arena_) {
 #ifdef DEBUG
     std::cout << "Construct MinAction" << std::endl;
 #endif
@@ -525,8 +540,8 @@ class MinAction : public ActionBase {
                        std::function<arrow::Status()>* on_null) override {
     // resize result data
     if (cache_validity_.size() <= max_group_id) {
-      cache_validity_.resize(max_group_id + 1, false);
-      cache_.resize(max_group_id + 1, 0);
+      RETURN_NOT_OK(cache_validity_.resize(max_group_id + 1, false));
+      RETURN_NOT_OK(cache_.resize(max_group_id + 1, 0));
       length_ = cache_validity_.size();
     }
 
@@ -569,21 +584,15 @@ class MinAction : public ActionBase {
     return arrow::Status::OK();
   }
 
-  arrow::Status GrowByFactor(int dest_group_id) {
-    int max_group_id;
-    if (cache_validity_.size() < 128) {
-      max_group_id = 128;
-    } else {
-      max_group_id = cache_validity_.size() * 2;
-    }
-    cache_validity_.resize(max_group_id, false);
-    cache_.resize(max_group_id, 0);
+  arrow::Status Grow(int dest_group_id) {
+    RETURN_NOT_OK(cache_validity_.Grow(dest_group_id, false));
+    RETURN_NOT_OK(cache_.Grow(dest_group_id, 0));
     return arrow::Status::OK();
   }
 
   arrow::Status Evaluate(int dest_group_id, void* data) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_validity_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     if (!cache_validity_[dest_group_id]) {
       cache_[dest_group_id] = *(CType*)data;
@@ -597,17 +606,15 @@ class MinAction : public ActionBase {
 
   arrow::Status EvaluateNull(int dest_group_id) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_validity_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     return arrow::Status::OK();
   }
 
   arrow::Status Finish(ArrayList* out) override {
     auto length = GetResultLength();
-    cache_.resize(length);
-    cache_validity_.resize(length);
     std::shared_ptr<arrow::Array> arr_out;
-    RETURN_NOT_OK(builder_->AppendValues(cache_, cache_validity_));
+    RETURN_NOT_OK(AppendArenaValues(builder_.get(), cache_, cache_validity_, 0, length));
     RETURN_NOT_OK(builder_->Finish(&arr_out));
     out->push_back(arr_out);
 
@@ -643,8 +650,9 @@ class MinAction : public ActionBase {
   CType* data_;
   int row_id;
   // result
-  std::vector<CType> cache_;
-  std::vector<bool> cache_validity_;
+  AggregateArena arena_;
+  ArenaVector<CType> cache_;
+  ArenaVector<uint8_t> cache_validity_;
   std::unique_ptr<BuilderType> builder_;
   uint64_t length_ = 0;
 };
@@ -653,7 +661,8 @@ class MinAction : public ActionBase {
 template <typename DataType>
 class MaxAction : public ActionBase {
  public:
-  MaxAction(arrow::compute::FunctionContext* ctx) : ctx_(ctx) {
+  MaxAction(arrow::compute::FunctionContext* ctx)
+      : ctx_(ctx), arena_(ctx->memory_pool()), cache_(&arena_), cache_validity_(&arena_) {
 #ifdef DEBUG
     std::cout << "Construct MaxAction" << std::endl;
 #endif
@@ -675,8 +684,8 @@ class MaxAction : public ActionBase {
                        std::function<arrow::Status()>* on_null) override {
     // resize result data
     if (cache_validity_.size() <= max_group_id) {
-      cache_validity_.resize(max_group_id + 1, false);
-      cache_.resize(max_group_id + 1, 0);
+      RETURN_NOT_OK(cache_validity_.resize(max_group_id + 1, false));
+      RETURN_NOT_OK(cache_.resize(max_group_id + 1, 0));
       length_ = cache_validity_.size();
     }
 
@@ -719,21 +728,15 @@ class MaxAction : public ActionBase {
     return arrow::Status::OK();
   }
 
-  arrow::Status GrowByFactor(int dest_group_id) {
-    int max_group_id;
-    if (cache_validity_.size() < 128) {
-      max_group_id = 128;
-    } else {
-      max_group_id = cache_validity_.size() * 2;
-    }
-    cache_validity_.resize(max_group_id, false);
-    cache_.resize(max_group_id, 0);
+  arrow::Status Grow(int dest_group_id) {
+    RETURN_NOT_OK(cache_validity_.Grow(dest_group_id, false));
+    RETURN_NOT_OK(cache_.Grow(dest_group_id, 0));
     return arrow::Status::OK();
   }
 
   arrow::Status Evaluate(int dest_group_id, void* data) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_validity_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     if (!cache_validity_[dest_group_id]) {
       cache_[dest_group_id] = *(CType*)data;
@@ -747,7 +750,7 @@ class MaxAction : public ActionBase {
 
   arrow::Status EvaluateNull(int dest_group_id) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_validity_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     return arrow::Status::OK();
   }
@@ -755,9 +758,7 @@ class MaxAction : public ActionBase {
   arrow::Status Finish(ArrayList* out) override {
     std::shared_ptr<arrow::Array> arr_out;
     auto length = GetResultLength();
-    cache_.resize(length);
-    cache_validity_.resize(length);
-    RETURN_NOT_OK(builder_->AppendValues(cache_, cache_validity_));
+    RETURN_NOT_OK(AppendArenaValues(builder_.get(), cache_, cache_validity_, 0, length));
     RETURN_NOT_OK(builder_->Finish(&arr_out));
     out->push_back(arr_out);
 
@@ -792,8 +793,9 @@ class MaxAction : public ActionBase {
   CType* data_;
   int row_id;
   // result
-  std::vector<CType> cache_;
-  std::vector<bool> cache_validity_;
+  AggregateArena arena_;
+  ArenaVector<CType> cache_;
+  ArenaVector<uint8_t> cache_validity_;
   std::unique_ptr<BuilderType> builder_;
   uint64_t length_ = 0;
 };
@@ -802,7 +804,8 @@ class MaxAction : public ActionBase {
 template <typename DataType>
 class SumAction : public ActionBase {
  public:
-  SumAction(arrow::compute::FunctionContext* ctx) : ctx_(ctx) {
+  SumAction(arrow::compute::FunctionContext* ctx)
+      : ctx_(ctx), arena_(ctx->memory_pool()), cache_(&arena_), cache_validity_(&arena_) {
 #ifdef DEBUG
     std::cout << "Construct SumAction" << std::endl;
 #endif
@@ -825,8 +828,8 @@ class SumAction : public ActionBase {
                        std::function<arrow::Status()>* on_null) override {
     // resize result data
     if (cache_validity_.size() <= max_group_id) {
-      cache_validity_.resize(max_group_id + 1, false);
-      cache_.resize(max_group_id + 1, 0);
+      RETURN_NOT_OK(cache_validity_.resize(max_group_id + 1, false));
+      RETURN_NOT_OK(cache_.resize(max_group_id + 1, 0));
       length_ = cache_validity_.size();
     }
 
@@ -859,21 +862,15 @@ class SumAction : public ActionBase {
     return arrow::Status::OK();
   }
 
-  arrow::Status GrowByFactor(int dest_group_id) {
-    int max_group_id;
-    if (cache_validity_.size() < 128) {
-      max_group_id = 128;
-    } else {
-      max_group_id = cache_validity_.size() * 2;
-    }
-    cache_validity_.resize(max_group_id, false);
-    cache_.resize(max_group_id, 0);
+  arrow::Status Grow(int dest_group_id) {
+    RETURN_NOT_OK(cache_validity_.Grow(dest_group_id, false));
+    RETURN_NOT_OK(cache_.Grow(dest_group_id, 0));
     return arrow::Status::OK();
   }
 
   arrow::Status Evaluate(int dest_group_id, void* data) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_validity_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     cache_validity_[dest_group_id] = true;
     cache_[dest_group_id] += *(CType*)data;
@@ -882,7 +879,7 @@ class SumAction : public ActionBase {
 
   arrow::Status EvaluateNull(int dest_group_id) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_validity_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     return arrow::Status::OK();
   }
@@ -890,9 +887,7 @@ class SumAction : public ActionBase {
   arrow::Status Finish(ArrayList* out) override {
     std::shared_ptr<arrow::Array> arr_out;
     auto length = GetResultLength();
-    cache_.resize(length);
-    cache_validity_.resize(length);
-    RETURN_NOT_OK(builder_->AppendValues(cache_, cache_validity_));
+    RETURN_NOT_OK(AppendArenaValues(builder_.get(), cache_, cache_validity_, 0, length));
     RETURN_NOT_OK(builder_->Finish(&arr_out));
     out->push_back(arr_out);
 
@@ -930,8 +925,9 @@ class SumAction : public ActionBase {
   CType* data_;
   int row_id;
   // result
-  std::vector<ResCType> cache_;
-  std::vector<bool> cache_validity_;
+  AggregateArena arena_;
+  ArenaVector<ResCType> cache_;
+  ArenaVector<uint8_t> cache_validity_;
   std::unique_ptr<ResBuilderType> builder_;
   uint64_t length_ = 0;
 };
@@ -940,7 +936,12 @@ class SumAction : public ActionBase {
 template <typename DataType>
 class AvgAction : public ActionBase {
  public:
-  AvgAction(arrow::compute::FunctionContext* ctx) : ctx_(ctx) {
+  AvgAction(arrow::compute::FunctionContext* ctx)
+      : ctx_(ctx),
+        arena_(ctx->memory_pool()),
+        cache_sum_(&arena_),
+        cache_count_(&arena_),
+        cache_validity_(&arena_) {
     std::unique_ptr<arrow::ArrayBuilder> builder;
     arrow::MakeBuilder(ctx_->memory_pool(),
                        arrow::TypeTraits<arrow::DoubleType>::type_singleton(), &builder);
@@ -963,9 +964,9 @@ class AvgAction : public ActionBase {
                        std::function<arrow::Status()>* on_null) override {
     // resize result data
     if (cache_validity_.size() <= max_group_id) {
-      cache_validity_.resize(max_group_id + 1, false);
-      cache_sum_.resize(max_group_id + 1, 0);
-      cache_count_.resize(max_group_id + 1, 0);
+      RETURN_NOT_OK(cache_validity_.resize(max_group_id + 1, false));
+      RETURN_NOT_OK(cache_sum_.resize(max_group_id + 1, 0));
+      RETURN_NOT_OK(cache_count_.resize(max_group_id + 1, 0));
       length_ = cache_validity_.size();
     }
 
@@ -1000,22 +1001,16 @@ class AvgAction : public ActionBase {
     return arrow::Status::OK();
   }
 
-  arrow::Status GrowByFactor(int dest_group_id) {
-    int max_group_id;
-    if (cache_validity_.size() < 128) {
-      max_group_id = 128;
-    } else {
-      max_group_id = cache_validity_.size() * 2;
-    }
-    cache_validity_.resize(max_group_id, false);
-    cache_sum_.resize(max_group_id, 0);
-    cache_count_.resize(max_group_id, 0);
+  arrow::Status Grow(int dest_group_id) {
+    RETURN_NOT_OK(cache_validity_.Grow(dest_group_id, false));
+    RETURN_NOT_OK(cache_sum_.Grow(dest_group_id, 0));
+    RETURN_NOT_OK(cache_count_.Grow(dest_group_id, 0));
     return arrow::Status::OK();
   }
 
   arrow::Status Evaluate(int dest_group_id, void* data) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_validity_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     cache_validity_[dest_group_id] = true;
     cache_sum_[dest_group_id] += *(CType*)data;
@@ -1025,7 +1020,7 @@ class AvgAction : public ActionBase {
 
   arrow::Status EvaluateNull(int dest_group_id) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_validity_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     return arrow::Status::OK();
   }
@@ -1036,9 +1031,8 @@ class AvgAction : public ActionBase {
       cache_sum_[i] /= cache_count_[i];
     }
     std::shared_ptr<arrow::Array> arr_out;
-    cache_sum_.resize(length);
-    cache_validity_.resize(length);
-    RETURN_NOT_OK(builder_->AppendValues(cache_sum_, cache_validity_));
+    RETURN_NOT_OK(
+        AppendArenaValues(builder_.get(), cache_sum_, cache_validity_, 0, length));
     RETURN_NOT_OK(builder_->Finish(&arr_out));
     out->push_back(arr_out);
 
@@ -1079,9 +1073,10 @@ class AvgAction : public ActionBase {
   std::shared_ptr<arrow::Array> in_;
   int row_id;
   // result
-  std::vector<double> cache_sum_;
-  std::vector<uint64_t> cache_count_;
-  std::vector<bool> cache_validity_;
+  AggregateArena arena_;
+  ArenaVector<double> cache_sum_;
+  ArenaVector<uint64_t> cache_count_;
+  ArenaVector<uint8_t> cache_validity_;
   uint64_t length_ = 0;
 };
 
@@ -1089,7 +1084,11 @@ class AvgAction : public ActionBase {
 template <typename DataType>
 class SumCountAction : public ActionBase {
  public:
-  SumCountAction(arrow::compute::FunctionContext* ctx) : ctx_(ctx) {
+  SumCountAction(arrow::compute::FunctionContext* ctx)
+      : ctx_(ctx),
+        arena_(ctx->memory_pool()),
+        cache_sum_(&arena_),
+        cache_count_(&arena_) {
     std::unique_ptr<arrow::ArrayBuilder> sum_builder;
     std::unique_ptr<arrow::ArrayBuilder> count_builder;
     arrow::MakeBuilder(ctx_->memory_pool(),
@@ -1120,8 +1119,8 @@ class SumCountAction : public ActionBase {
                        std::function<arrow::Status()>* on_null) override {
     // resize result data
     if (cache_sum_.size() <= max_group_id) {
-      cache_sum_.resize(max_group_id + 1, 0);
-      cache_count_.resize(max_group_id + 1, 0);
+      RETURN_NOT_OK(cache_sum_.resize(max_group_id + 1, 0));
+      RETURN_NOT_OK(cache_count_.resize(max_group_id + 1, 0));
       length_ = cache_sum_.size();
     }
 
@@ -1154,21 +1153,15 @@ class SumCountAction : public ActionBase {
     return arrow::Status::OK();
   }
 
-  arrow::Status GrowByFactor(int dest_group_id) {
-    int max_group_id;
-    if (cache_sum_.size() < 128) {
-      max_group_id = 128;
-    } else {
-      max_group_id = cache_sum_.size() * 2;
-    }
-    cache_sum_.resize(max_group_id, 0);
-    cache_count_.resize(max_group_id, 0);
+  arrow::Status Grow(int dest_group_id) {
+    RETURN_NOT_OK(cache_sum_.Grow(dest_group_id, 0));
+    RETURN_NOT_OK(cache_count_.Grow(dest_group_id, 0));
     return arrow::Status::OK();
   }
 
   arrow::Status Evaluate(int dest_group_id, void* data) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_sum_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     cache_sum_[dest_group_id] += *(CType*)data;
     cache_count_[dest_group_id] += 1;
@@ -1177,7 +1170,7 @@ class SumCountAction : public ActionBase {
 
   arrow::Status EvaluateNull(int dest_group_id) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_sum_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     return arrow::Status::OK();
   }
@@ -1231,8 +1224,9 @@ class SumCountAction : public ActionBase {
   std::shared_ptr<arrow::Array> in_;
   int row_id;
   // result
-  std::vector<double> cache_sum_;
-  std::vector<int64_t> cache_count_;
+  AggregateArena arena_;
+  ArenaVector<double> cache_sum_;
+  ArenaVector<int64_t> cache_count_;
   uint64_t length_ = 0;
 };
 
@@ -1240,7 +1234,11 @@ class SumCountAction : public ActionBase {
 template <typename DataType>
 class SumCountMergeAction : public ActionBase {
  public:
-  SumCountMergeAction(arrow::compute::FunctionContext* ctx) : ctx_(ctx) {
+  SumCountMergeAction(arrow::compute::FunctionContext* ctx)
+      : ctx_(ctx),
+        arena_(ctx->memory_pool()),
+        cache_sum_(&arena_),
+        cache_count_(&arena_) {
     std::unique_ptr<arrow::ArrayBuilder> sum_builder;
     std::unique_ptr<arrow::ArrayBuilder> count_builder;
     arrow::MakeBuilder(ctx_->memory_pool(),
@@ -1270,8 +1268,8 @@ class SumCountMergeAction : public ActionBase {
                        std::function<arrow::Status()>* on_null) override {
     // resize result data
     if (cache_sum_.size() <= max_group_id) {
-      cache_sum_.resize(max_group_id + 1, 0);
-      cache_count_.resize(max_group_id + 1, 0);
+      RETURN_NOT_OK(cache_sum_.resize(max_group_id + 1, 0));
+      RETURN_NOT_OK(cache_count_.resize(max_group_id + 1, 0));
       length_ = cache_sum_.size();
     }
 
@@ -1306,21 +1304,15 @@ class SumCountMergeAction : public ActionBase {
     return arrow::Status::OK();
   }
 
-  arrow::Status GrowByFactor(int dest_group_id) {
-    int max_group_id;
-    if (cache_sum_.size() < 128) {
-      max_group_id = 128;
-    } else {
-      max_group_id = cache_sum_.size() * 2;
-    }
-    cache_sum_.resize(max_group_id, 0);
-    cache_count_.resize(max_group_id, 0);
+  arrow::Status Grow(int dest_group_id) {
+    RETURN_NOT_OK(cache_sum_.Grow(dest_group_id, 0));
+    RETURN_NOT_OK(cache_count_.Grow(dest_group_id, 0));
     return arrow::Status::OK();
   }
 
   arrow::Status Evaluate(int dest_group_id, void* data, void* data2) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_sum_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     cache_sum_[dest_group_id] += *(double*)data;
     cache_count_[dest_group_id] += *(int64_t*)data2;
@@ -1329,7 +1321,7 @@ class SumCountMergeAction : public ActionBase {
 
   arrow::Status EvaluateNull(int dest_group_id) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_sum_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     return arrow::Status::OK();
   }
@@ -1386,8 +1378,9 @@ class SumCountMergeAction : public ActionBase {
   std::shared_ptr<arrow::Array> in_sum_;
   std::shared_ptr<arrow::Array> in_count_;
   // result
-  std::vector<double> cache_sum_;
-  std::vector<int64_t> cache_count_;
+  AggregateArena arena_;
+  ArenaVector<double> cache_sum_;
+  ArenaVector<int64_t> cache_count_;
   uint64_t length_ = 0;
 };
 
@@ -1395,7 +1388,12 @@ class SumCountMergeAction : public ActionBase {
 template <typename DataType>
 class AvgByCountAction : public ActionBase {
  public:
-  AvgByCountAction(arrow::compute::FunctionContext* ctx) : ctx_(ctx) {
+  AvgByCountAction(arrow::compute::FunctionContext* ctx)
+      : ctx_(ctx),
+        arena_(ctx->memory_pool()),
+        cache_sum_(&arena_),
+        cache_count_(&arena_),
+        cache_validity_(&arena_) {
     std::unique_ptr<arrow::ArrayBuilder> builder;
     arrow::MakeBuilder(ctx_->memory_pool(),
                        arrow::TypeTraits<arrow::DoubleType>::type_singleton(), &builder);
@@ -1418,9 +1416,9 @@ class AvgByCountAction : public ActionBase {
                        std::function<arrow::Status()>* on_null) override {
     // resize result data
     if (cache_validity_.size() <= max_group_id) {
-      cache_validity_.resize(max_group_id + 1, false);
-      cache_sum_.resize(max_group_id + 1, 0);
-      cache_count_.resize(max_group_id + 1, 0);
+      RETURN_NOT_OK(cache_validity_.resize(max_group_id + 1, false));
+      RETURN_NOT_OK(cache_sum_.resize(max_group_id + 1, 0));
+      RETURN_NOT_OK(cache_count_.resize(max_group_id + 1, 0));
       length_ = cache_validity_.size();
     }
 
@@ -1455,22 +1453,16 @@ class AvgByCountAction : public ActionBase {
     return arrow::Status::OK();
   }
 
-  arrow::Status GrowByFactor(int dest_group_id) {
-    int max_group_id;
-    if (cache_validity_.size() < 128) {
-      max_group_id = 128;
-    } else {
-      max_group_id = cache_validity_.size() * 2;
-    }
-    cache_validity_.resize(max_group_id, false);
-    cache_sum_.resize(max_group_id, 0);
-    cache_count_.resize(max_group_id, 0);
+  arrow::Status Grow(int dest_group_id) {
+    RETURN_NOT_OK(cache_validity_.Grow(dest_group_id, false));
+    RETURN_NOT_OK(cache_sum_.Grow(dest_group_id, 0));
+    RETURN_NOT_OK(cache_count_.Grow(dest_group_id, 0));
     return arrow::Status::OK();
   }
 
   arrow::Status Evaluate(int dest_group_id, void* data, void* data2) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_validity_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     cache_sum_[dest_group_id] += *(double*)data;
     cache_count_[dest_group_id] += *(int64_t*)data2;
@@ -1479,7 +1471,7 @@ class AvgByCountAction : public ActionBase {
 
   arrow::Status EvaluateNull(int dest_group_id) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_validity_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     return arrow::Status::OK();
   }
@@ -1494,9 +1486,8 @@ class AvgByCountAction : public ActionBase {
         cache_sum_[i] /= cache_count_[i];
       }
     }
-    cache_sum_.resize(length_);
-    cache_validity_.resize(length_);
-    RETURN_NOT_OK(builder_->AppendValues(cache_sum_, cache_validity_));
+    RETURN_NOT_OK(
+        AppendArenaValues(builder_.get(), cache_sum_, cache_validity_, 0, length_));
     RETURN_NOT_OK(builder_->Finish(&out_arr));
     out->push_back(out_arr);
 
@@ -1545,9 +1536,10 @@ class AvgByCountAction : public ActionBase {
   std::shared_ptr<arrow::Array> in_sum_;
   std::shared_ptr<arrow::Array> in_count_;
   // result
-  std::vector<double> cache_sum_;
-  std::vector<int64_t> cache_count_;
-  std::vector<bool> cache_validity_;
+  AggregateArena arena_;
+  ArenaVector<double> cache_sum_;
+  ArenaVector<int64_t> cache_count_;
+  ArenaVector<uint8_t> cache_validity_;
   uint64_t length_ = 0;
 };
 
@@ -1555,7 +1547,13 @@ class AvgByCountAction : public ActionBase {
 template <typename DataType>
 class StddevSampPartialAction : public ActionBase {
  public:
-  StddevSampPartialAction(arrow::compute::FunctionContext* ctx) : ctx_(ctx) {
+  StddevSampPartialAction(arrow::compute::FunctionContext* ctx)
+      : ctx_(ctx),
+        arena_(ctx->memory_pool()),
+        cache_sum_(&arena_),
+        cache_count_(&arena_),
+        cache_m2_(&arena_),
+        cache_validity_(&arena_) {
     std::unique_ptr<arrow::ArrayBuilder> count_builder;
     std::unique_ptr<arrow::ArrayBuilder> avg_builder;
     std::unique_ptr<arrow::ArrayBuilder> m2_builder;
@@ -1591,10 +1589,10 @@ class StddevSampPartialAction : public ActionBase {
                        std::function<arrow::Status()>* on_null) override {
     // resize result data
     if (cache_validity_.size() <= max_group_id) {
-      cache_validity_.resize(max_group_id + 1, false);
-      cache_sum_.resize(max_group_id + 1, 0);
-      cache_count_.resize(max_group_id + 1, 0);
-      cache_m2_.resize(max_group_id + 1, 0);
+      RETURN_NOT_OK(cache_validity_.resize(max_group_id + 1, false));
+      RETURN_NOT_OK(cache_sum_.resize(max_group_id + 1, 0));
+      RETURN_NOT_OK(cache_count_.resize(max_group_id + 1, 0));
+      RETURN_NOT_OK(cache_m2_.resize(max_group_id + 1, 0));
       length_ = max_group_id;
     }
 
@@ -1641,23 +1639,17 @@ class StddevSampPartialAction : public ActionBase {
     return arrow::Status::OK();
   }
 
-  arrow::Status GrowByFactor(int dest_group_id) {
-    int max_group_id;
-    if (cache_validity_.size() < 128) {
-      max_group_id = 128;
-    } else {
-      max_group_id = cache_validity_.size() * 2;
-    }
-    cache_validity_.resize(max_group_id, false);
-    cache_sum_.resize(max_group_id, 0);
-    cache_count_.resize(max_group_id, 0);
-    cache_m2_.resize(max_group_id, 0);
+  arrow::Status Grow(int dest_group_id) {
+    RETURN_NOT_OK(cache_validity_.Grow(dest_group_id, false));
+    RETURN_NOT_OK(cache_sum_.Grow(dest_group_id, 0));
+    RETURN_NOT_OK(cache_count_.Grow(dest_group_id, 0));
+    RETURN_NOT_OK(cache_m2_.Grow(dest_group_id, 0));
     return arrow::Status::OK();
   }
 
   arrow::Status Evaluate(int dest_group_id, void* data) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_validity_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     cache_validity_[dest_group_id] = true;
     double pre_avg = cache_sum_[dest_group_id] * 1.0 /
@@ -1672,19 +1664,16 @@ class StddevSampPartialAction : public ActionBase {
 
   arrow::Status EvaluateNull(int dest_group_id) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_validity_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     return arrow::Status::OK();
   }
 
   arrow::Status Finish(ArrayList* out) override {
     // get count
-    cache_count_.resize(length_);
-    cache_sum_.resize(length_);
-    cache_m2_.resize(length_);
-    cache_validity_.resize(length_);
     std::shared_ptr<arrow::Array> count_array;
-    RETURN_NOT_OK(count_builder_->AppendValues(cache_count_, cache_validity_));
+    RETURN_NOT_OK(AppendArenaValues(count_builder_.get(), cache_count_, cache_validity_,
+                                    0, length_));
     RETURN_NOT_OK(count_builder_->Finish(&count_array));
     // get avg
     std::shared_ptr<arrow::Array> avg_array;
@@ -1695,11 +1684,13 @@ class StddevSampPartialAction : public ActionBase {
         cache_sum_[i] /= cache_count_[i] * 1.0;
       }
     }
-    RETURN_NOT_OK(avg_builder_->AppendValues(cache_sum_, cache_validity_));
+    RETURN_NOT_OK(
+        AppendArenaValues(avg_builder_.get(), cache_sum_, cache_validity_, 0, length_));
     RETURN_NOT_OK(avg_builder_->Finish(&avg_array));
     // get m2
     std::shared_ptr<arrow::Array> m2_array;
-    RETURN_NOT_OK(m2_builder_->AppendValues(cache_m2_, cache_validity_));
+    RETURN_NOT_OK(
+        AppendArenaValues(m2_builder_.get(), cache_m2_, cache_validity_, 0, length_));
     RETURN_NOT_OK(m2_builder_->Finish(&m2_array));
 
     out->push_back(count_array);
@@ -1763,10 +1754,11 @@ class StddevSampPartialAction : public ActionBase {
   std::shared_ptr<arrow::Array> in_;
   int row_id;
   // result
-  std::vector<double> cache_sum_;
-  std::vector<double> cache_count_;
-  std::vector<double> cache_m2_;
-  std::vector<bool> cache_validity_;
+  AggregateArena arena_;
+  ArenaVector<double> cache_sum_;
+  ArenaVector<double> cache_count_;
+  ArenaVector<double> cache_m2_;
+  ArenaVector<uint8_t> cache_validity_;
   uint64_t length_ = 0;
 };
 
@@ -1774,7 +1766,13 @@ class StddevSampPartialAction : public ActionBase {
 template <typename DataType>
 class StddevSampFinalAction : public ActionBase {
  public:
-  StddevSampFinalAction(arrow::compute::FunctionContext* ctx) : ctx_(ctx) {
+  StddevSampFinalAction(arrow::compute::FunctionContext* ctx)
+      : ctx_(ctx),
+        arena_(ctx->memory_pool()),
+        cache_count_(&arena_),
+        cache_avg_(&arena_),
+        cache_m2_(&arena_),
+        cache_validity_(&arena_) {
     std::unique_ptr<arrow::ArrayBuilder> builder;
     arrow::MakeBuilder(ctx_->memory_pool(),
                        arrow::TypeTraits<arrow::DoubleType>::type_singleton(), &builder);
@@ -1797,10 +1795,10 @@ class StddevSampFinalAction : public ActionBase {
                        std::function<arrow::Status()>* on_null) override {
     // resize result data
     if (cache_validity_.size() <= max_group_id) {
-      cache_validity_.resize(max_group_id + 1, false);
-      cache_count_.resize(max_group_id + 1, 0);
-      cache_avg_.resize(max_group_id + 1, 0);
-      cache_m2_.resize(max_group_id + 1, 0);
+      RETURN_NOT_OK(cache_validity_.resize(max_group_id + 1, false));
+      RETURN_NOT_OK(cache_count_.resize(max_group_id + 1, 0));
+      RETURN_NOT_OK(cache_avg_.resize(max_group_id + 1, 0));
+      RETURN_NOT_OK(cache_m2_.resize(max_group_id + 1, 0));
       length_ = cache_count_.size();
     }
     in_count_ = in_list[0];
@@ -1852,23 +1850,17 @@ class StddevSampFinalAction : public ActionBase {
     return arrow::Status::OK();
   }
 
-  arrow::Status GrowByFactor(int dest_group_id) {
-    int max_group_id;
-    if (cache_validity_.size() < 128) {
-      max_group_id = 128;
-    } else {
-      max_group_id = cache_validity_.size() * 2;
-    }
-    cache_validity_.resize(max_group_id, false);
-    cache_count_.resize(max_group_id, 0);
-    cache_avg_.resize(max_group_id, 0);
-    cache_m2_.resize(max_group_id, 0);
+  arrow::Status Grow(int dest_group_id) {
+    RETURN_NOT_OK(cache_validity_.Grow(dest_group_id, false));
+    RETURN_NOT_OK(cache_count_.Grow(dest_group_id, 0));
+    RETURN_NOT_OK(cache_avg_.Grow(dest_group_id, 0));
+    RETURN_NOT_OK(cache_m2_.Grow(dest_group_id, 0));
     return arrow::Status::OK();
   }
 
   arrow::Status Evaluate(int dest_group_id, void* data, void* data2, void* data3) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_validity_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     cache_validity_[dest_group_id] = true;
     double pre_avg = cache_avg_[dest_group_id];
@@ -1884,7 +1876,7 @@ class StddevSampFinalAction : public ActionBase {
 
   arrow::Status EvaluateNull(int dest_group_id) {
     auto target_group_size = dest_group_id + 1;
-    if (cache_validity_.size() <= target_group_size) GrowByFactor(target_group_size);
+    RETURN_NOT_OK(Grow(dest_group_id));
     if (length_ < target_group_size) length_ = target_group_size;
     return arrow::Status::OK();
   }
@@ -1895,9 +1887,8 @@ class StddevSampFinalAction : public ActionBase {
       cache_m2_[i] =
           sqrt(cache_m2_[i] / (cache_count_[i] > 1 ? (cache_count_[i] - 1) : 1));
     }
-    cache_m2_.resize(length_);
-    cache_validity_.resize(length_);
-    RETURN_NOT_OK(builder_->AppendValues(cache_m2_, cache_validity_));
+    RETURN_NOT_OK(
+        AppendArenaValues(builder_.get(), cache_m2_, cache_validity_, 0, length_));
     RETURN_NOT_OK(builder_->Finish(&out_arr));
     out->push_back(out_arr);
 
@@ -1949,10 +1940,479 @@ class StddevSampFinalAction : public ActionBase {
   std::shared_ptr<arrow::Array> in_avg_;
   std::shared_ptr<arrow::Array> in_m2_;
   // result
-  std::vector<double> cache_count_;
-  std::vector<double> cache_avg_;
-  std::vector<double> cache_m2_;
-  std::vector<bool> cache_validity_;
+  AggregateArena arena_;
+  ArenaVector<double> cache_count_;
+  ArenaVector<double> cache_avg_;
+  ArenaVector<double> cache_m2_;
+  ArenaVector<uint8_t> cache_validity_;
+  uint64_t length_ = 0;
+};
+
+//////////////// CountDistinctAction ///////////////
+template <typename DataType, typename CType>
+class CountDistinctAction : public ActionBase {
+ public:
+  CountDistinctAction(arrow::compute::FunctionContext* ctx)
+      : ctx_(ctx),
+        distinct_set_(GetDistinctAggregateMemoryBudget()),
+        arena_(ctx->memory_pool()),
+        cache_count_(&arena_) {
+#ifdef DEBUG
+    std::cout << "Construct CountDistinctAction" << std::endl;
+#endif
+  }
+  ~CountDistinctAction() {
+#ifdef DEBUG
+    std::cout << "Destruct CountDistinctAction" << std::endl;
+#endif
+  }
+
+  int RequiredColNum() { return 1; }
+
+  arrow::Status Submit(ArrayList in_list, int max_group_id,
+                       std::function<arrow::Status(int)>* on_valid,
+                       std::function<arrow::Status()>* on_null) override {
+    if (length_ <= max_group_id) length_ = max_group_id + 1;
+
+    in_ = std::dynamic_pointer_cast<ArrayType>(in_list[0]);
+    row_id_ = 0;
+    // prepare evaluate lambda
+    if (in_->null_count()) {
+      *on_valid = [this](int dest_group_id) {
+        arrow::Status status;
+        if (!in_->IsNull(row_id_)) {
+          status = distinct_set_.Insert(dest_group_id,
+                                        ToDistinctValue(in_->GetView(row_id_)));
+        }
+        row_id_++;
+        return status;
+      };
+    } else {
+      *on_valid = [this](int dest_group_id) {
+        auto status =
+            distinct_set_.Insert(dest_group_id, ToDistinctValue(in_->GetView(row_id_)));
+        row_id_++;
+        return status;
+      };
+    }
+    *on_null = [this]() {
+      row_id_++;
+      return arrow::Status::OK();
+    };
+    return arrow::Status::OK();
+  }
+
+  arrow::Status Evaluate(int dest_group_id, void* data) {
+    if (length_ <= dest_group_id) length_ = dest_group_id + 1;
+    return distinct_set_.Insert(dest_group_id, *(CType*)data);
+  }
+
+  arrow::Status EvaluateNull(int dest_group_id) {
+    if (length_ <= dest_group_id) length_ = dest_group_id + 1;
+    return arrow::Status::OK();
+  }
+
+  arrow::Status Finish(ArrayList* out) override { return Finish(0, length_, out); }
+
+  uint64_t GetResultLength() { return length_; }
+
+  arrow::Status Finish(uint64_t offset, uint64_t length, ArrayList* out) override {
+    // distinct values are counted once all input is inserted
+    if (!folded_) {
+      RETURN_NOT_OK(cache_count_.resize(length_, 0));
+      RETURN_NOT_OK(distinct_set_.Fold(
+          [this](int32_t group_id, const CType& value) { cache_count_[group_id]++; }));
+      folded_ = true;
+    }
+    length = (offset + length) > length_ ? (length_ - offset) : length;
+    arrow::Int64Builder builder(ctx_->memory_pool());
+    RETURN_NOT_OK(AppendArenaValues(&builder, cache_count_, offset, length));
+    std::shared_ptr<arrow::Array> out_arr;
+    RETURN_NOT_OK(builder.Finish(&out_arr));
+    out->push_back(out_arr);
+    return arrow::Status::OK();
+  }
+
+ private:
+  using ArrayType = typename arrow::TypeTraits<DataType>::ArrayType;
+  // input
+  arrow::compute::FunctionContext* ctx_;
+  std::shared_ptr<ArrayType> in_;
+  int row_id_;
+  // result
+  DistinctSet<CType> distinct_set_;
+  AggregateArena arena_;
+  ArenaVector<int64_t> cache_count_;
+  bool folded_ = false;
+  uint64_t length_ = 0;
+};
+
+//////////////// SumDistinctAction ///////////////
+template <typename DataType>
+class SumDistinctAction : public ActionBase {
+ public:
+  SumDistinctAction(arrow::compute::FunctionContext* ctx)
+      : ctx_(ctx),
+        distinct_set_(GetDistinctAggregateMemoryBudget()),
+        arena_(ctx->memory_pool()),
+        cache_sum_(&arena_),
+        cache_validity_(&arena_) {
+#ifdef DEBUG
+    std::cout << "Construct SumDistinctAction" << std::endl;
+#endif
+  }
+  ~SumDistinctAction() {
+#ifdef DEBUG
+    std::cout << "Destruct SumDistinctAction" << std::endl;
+#endif
+  }
+
+  int RequiredColNum() { return 1; }
+
+  arrow::Status Submit(ArrayList in_list, int max_group_id,
+                       std::function<arrow::Status(int)>* on_valid,
+                       std::function<arrow::Status()>* on_null) override {
+    if (length_ <= max_group_id) length_ = max_group_id + 1;
+
+    in_ = std::dynamic_pointer_cast<ArrayType>(in_list[0]);
+    row_id_ = 0;
+    // prepare evaluate lambda
+    if (in_->null_count()) {
+      *on_valid = [this](int dest_group_id) {
+        arrow::Status status;
+        if (!in_->IsNull(row_id_)) {
+          status = distinct_set_.Insert(dest_group_id, in_->GetView(row_id_));
+        }
+        row_id_++;
+        return status;
+      };
+    } else {
+      *on_valid = [this](int dest_group_id) {
+        auto status = distinct_set_.Insert(dest_group_id, in_->GetView(row_id_));
+        row_id_++;
+        return status;
+      };
+    }
+    *on_null = [this]() {
+      row_id_++;
+      return arrow::Status::OK();
+    };
+    return arrow::Status::OK();
+  }
+
+  arrow::Status Evaluate(int dest_group_id, void* data) {
+    if (length_ <= dest_group_id) length_ = dest_group_id + 1;
+    return distinct_set_.Insert(dest_group_id, *(CType*)data);
+  }
+
+  arrow::Status EvaluateNull(int dest_group_id) {
+    if (length_ <= dest_group_id) length_ = dest_group_id + 1;
+    return arrow::Status::OK();
+  }
+
+  arrow::Status Finish(ArrayList* out) override { return Finish(0, length_, out); }
+
+  uint64_t GetResultLength() { return length_; }
+
+  arrow::Status Finish(uint64_t offset, uint64_t length, ArrayList* out) override {
+    // distinct values are summed once all input is inserted
+    if (!folded_) {
+      RETURN_NOT_OK(cache_sum_.resize(length_, 0));
+      RETURN_NOT_OK(cache_validity_.resize(length_, false));
+      RETURN_NOT_OK(
+          distinct_set_.Fold([this](int32_t group_id, const CType& value) {
+            cache_sum_[group_id] += value;
+            cache_validity_[group_id] = true;
+          }));
+      folded_ = true;
+    }
+    length = (offset + length) > length_ ? (length_ - offset) : length;
+    // sum of a group without any non-null value is null
+    ResBuilderType builder(ctx_->memory_pool());
+    RETURN_NOT_OK(AppendArenaValues(&builder, cache_sum_, cache_validity_, offset, length));
+    std::shared_ptr<arrow::Array> out_arr;
+    RETURN_NOT_OK(builder.Finish(&out_arr));
+    out->push_back(out_arr);
+    return arrow::Status::OK();
+  }
+
+ private:
+  using CType = typename arrow::TypeTraits<DataType>::CType;
+  using ArrayType = typename arrow::TypeTraits<DataType>::ArrayType;
+  using ResDataType = typename FindAccumulatorType<DataType>::Type;
+  using ResCType = typename arrow::TypeTraits<ResDataType>::CType;
+  using ResBuilderType = typename arrow::TypeTraits<ResDataType>::BuilderType;
+  // input
+  arrow::compute::FunctionContext* ctx_;
+  std::shared_ptr<ArrayType> in_;
+  int row_id_;
+  // result
+  DistinctSet<CType> distinct_set_;
+  AggregateArena arena_;
+  ArenaVector<ResCType> cache_sum_;
+  ArenaVector<uint8_t> cache_validity_;
+  bool folded_ = false;
+  uint64_t length_ = 0;
+};
+
+//////////////// ApproxCountDistinctPartialAction ///////////////
+/* Outputs the HLL++ sketch of each group as num_words int64 columns, which is the
+ * aggregation buffer layout of Spark's HyperLogLogPlusPlus. */
+template <typename DataType, typename CType>
+class ApproxCountDistinctPartialAction : public ActionBase {
+ public:
+  ApproxCountDistinctPartialAction(arrow::compute::FunctionContext* ctx,
+                                   double relative_sd)
+      : ctx_(ctx),
+        hll_(relative_sd),
+        num_words_(hll_.num_words()),
+        arena_(ctx->memory_pool()),
+        sketches_(&arena_) {
+#ifdef DEBUG
+    std::cout << "Construct ApproxCountDistinctPartialAction" << std::endl;
+#endif
+  }
+  ~ApproxCountDistinctPartialAction() {
+#ifdef DEBUG
+    std::cout << "Destruct ApproxCountDistinctPartialAction" << std::endl;
+#endif
+  }
+
+  int RequiredColNum() { return 1; }
+
+  arrow::Status Submit(ArrayList in_list, int max_group_id,
+                       std::function<arrow::Status(int)>* on_valid,
+                       std::function<arrow::Status()>* on_null) override {
+    // resize result data
+    if (length_ <= max_group_id) {
+      length_ = max_group_id + 1;
+      RETURN_NOT_OK(sketches_.resize(length_, nullptr));
+    }
+
+    in_ = std::dynamic_pointer_cast<ArrayType>(in_list[0]);
+    row_id_ = 0;
+    // prepare evaluate lambda
+    if (in_->null_count()) {
+      *on_valid = [this](int dest_group_id) {
+        arrow::Status status;
+        if (!in_->IsNull(row_id_)) {
+          int64_t* sketch;
+          status = GetSketch(dest_group_id, &sketch);
+          if (status.ok()) {
+            hll_.Update(sketch, HyperLogLogPlusPlus::Hash(in_->GetView(row_id_)));
+          }
+        }
+        row_id_++;
+        return status;
+      };
+    } else {
+      *on_valid = [this](int dest_group_id) {
+        int64_t* sketch;
+        RETURN_NOT_OK(GetSketch(dest_group_id, &sketch));
+        hll_.Update(sketch, HyperLogLogPlusPlus::Hash(in_->GetView(row_id_)));
+        row_id_++;
+        return arrow::Status::OK();
+      };
+    }
+    *on_null = [this]() {
+      row_id_++;
+      return arrow::Status::OK();
+    };
+    return arrow::Status::OK();
+  }
+
+  arrow::Status Grow(int dest_group_id) {
+    return sketches_.Grow(dest_group_id, nullptr);
+  }
+
+  /* registers of a group are allocated from arena once the group gets a value */
+  arrow::Status GetSketch(int dest_group_id, int64_t** out) {
+    auto& sketch = sketches_[dest_group_id];
+    if (sketch == nullptr) {
+      uint8_t* words;
+      RETURN_NOT_OK(arena_.Allocate(num_words_ * sizeof(int64_t), &words));
+      std::memset(words, 0, num_words_ * sizeof(int64_t));
+      sketch = reinterpret_cast<int64_t*>(words);
+    }
+    *out = sketch;
+    return arrow::Status::OK();
+  }
+
+  arrow::Status Evaluate(int dest_group_id, void* data) {
+    auto target_group_size = dest_group_id + 1;
+    RETURN_NOT_OK(Grow(dest_group_id));
+    if (length_ < target_group_size) length_ = target_group_size;
+    int64_t* sketch;
+    RETURN_NOT_OK(GetSketch(dest_group_id, &sketch));
+    hll_.Update(sketch, HyperLogLogPlusPlus::Hash(*(CType*)data));
+    return arrow::Status::OK();
+  }
+
+  arrow::Status EvaluateNull(int dest_group_id) {
+    auto target_group_size = dest_group_id + 1;
+    RETURN_NOT_OK(Grow(dest_group_id));
+    if (length_ < target_group_size) length_ = target_group_size;
+    return arrow::Status::OK();
+  }
+
+  arrow::Status Finish(ArrayList* out) override { return Finish(0, length_, out); }
+
+  uint64_t GetResultLength() { return length_; }
+
+  arrow::Status Finish(uint64_t offset, uint64_t length, ArrayList* out) override {
+    length = (offset + length) > length_ ? (length_ - offset) : length;
+    // sketch of a group with only null input is all zero, as Spark initializes it
+    for (int w = 0; w < num_words_; w++) {
+      arrow::Int64Builder builder(ctx_->memory_pool());
+      RETURN_NOT_OK(builder.Resize(length));
+      for (uint64_t i = 0; i < length; i++) {
+        auto sketch = sketches_[offset + i];
+        builder.UnsafeAppend(sketch == nullptr ? 0 : sketch[w]);
+      }
+      std::shared_ptr<arrow::Array> out_arr;
+      RETURN_NOT_OK(builder.Finish(&out_arr));
+      out->push_back(out_arr);
+    }
+    return arrow::Status::OK();
+  }
+
+ private:
+  using ArrayType = typename arrow::TypeTraits<DataType>::ArrayType;
+  // input
+  arrow::compute::FunctionContext* ctx_;
+  std::shared_ptr<ArrayType> in_;
+  int row_id_;
+  // result, num_words_ registers words per group, which stay contiguous
+  HyperLogLogPlusPlus hll_;
+  int num_words_;
+  AggregateArena arena_;
+  ArenaVector<int64_t*> sketches_;
+  uint64_t length_ = 0;
+};
+
+//////////////// ApproxCountDistinctFinalAction ///////////////
+/* Merges the sketches of partial aggregation and outputs the estimated count. */
+class ApproxCountDistinctFinalAction : public ActionBase {
+ public:
+  ApproxCountDistinctFinalAction(arrow::compute::FunctionContext* ctx,
+                                 double relative_sd)
+      : ctx_(ctx),
+        hll_(relative_sd),
+        num_words_(hll_.num_words()),
+        arena_(ctx->memory_pool()),
+        sketches_(&arena_) {
+    sketch_.resize(num_words_);
+#ifdef DEBUG
+    std::cout << "Construct ApproxCountDistinctFinalAction" << std::endl;
+#endif
+  }
+  ~ApproxCountDistinctFinalAction() {
+#ifdef DEBUG
+    std::cout << "Destruct ApproxCountDistinctFinalAction" << std::endl;
+#endif
+  }
+
+  int RequiredColNum() { return num_words_; }
+
+  arrow::Status Submit(ArrayList in_list, int max_group_id,
+                       std::function<arrow::Status(int)>* on_valid,
+                       std::function<arrow::Status()>* on_null) override {
+    // resize result data
+    if (length_ <= max_group_id) {
+      length_ = max_group_id + 1;
+      RETURN_NOT_OK(sketches_.resize(length_, nullptr));
+    }
+
+    in_list_.clear();
+    for (auto arr : in_list) {
+      in_list_.push_back(arr->data()->GetValues<int64_t>(1));
+    }
+    row_id_ = 0;
+    // prepare evaluate lambda, sketch words are never null
+    *on_valid = [this](int dest_group_id) {
+      for (int w = 0; w < num_words_; w++) {
+        sketch_[w] = in_list_[w][row_id_];
+      }
+      int64_t* sketch;
+      RETURN_NOT_OK(GetSketch(dest_group_id, &sketch));
+      hll_.Merge(sketch, sketch_.data());
+      row_id_++;
+      return arrow::Status::OK();
+    };
+    *on_null = [this]() {
+      row_id_++;
+      return arrow::Status::OK();
+    };
+    return arrow::Status::OK();
+  }
+
+  arrow::Status Grow(int dest_group_id) {
+    return sketches_.Grow(dest_group_id, nullptr);
+  }
+
+  /* registers of a group are allocated from arena once the group gets a value */
+  arrow::Status GetSketch(int dest_group_id, int64_t** out) {
+    auto& sketch = sketches_[dest_group_id];
+    if (sketch == nullptr) {
+      uint8_t* words;
+      RETURN_NOT_OK(arena_.Allocate(num_words_ * sizeof(int64_t), &words));
+      std::memset(words, 0, num_words_ * sizeof(int64_t));
+      sketch = reinterpret_cast<int64_t*>(words);
+    }
+    *out = sketch;
+    return arrow::Status::OK();
+  }
+
+  arrow::Status Evaluate(int dest_group_id, const std::vector<void*>& data_list) {
+    auto target_group_size = dest_group_id + 1;
+    RETURN_NOT_OK(Grow(dest_group_id));
+    if (length_ < target_group_size) length_ = target_group_size;
+    for (int w = 0; w < num_words_; w++) {
+      sketch_[w] = *(int64_t*)data_list[w];
+    }
+    int64_t* sketch;
+    RETURN_NOT_OK(GetSketch(dest_group_id, &sketch));
+    hll_.Merge(sketch, sketch_.data());
+    return arrow::Status::OK();
+  }
+
+  arrow::Status EvaluateNull(int dest_group_id) {
+    auto target_group_size = dest_group_id + 1;
+    RETURN_NOT_OK(Grow(dest_group_id));
+    if (length_ < target_group_size) length_ = target_group_size;
+    return arrow::Status::OK();
+  }
+
+  arrow::Status Finish(ArrayList* out) override { return Finish(0, length_, out); }
+
+  uint64_t GetResultLength() { return length_; }
+
+  arrow::Status Finish(uint64_t offset, uint64_t length, ArrayList* out) override {
+    length = (offset + length) > length_ ? (length_ - offset) : length;
+    arrow::Int64Builder builder(ctx_->memory_pool());
+    RETURN_NOT_OK(builder.Resize(length));
+    // a group without any sketch has an empty sketch, whose estimate is 0
+    for (uint64_t i = 0; i < length; i++) {
+      auto sketch = sketches_[offset + i];
+      builder.UnsafeAppend(sketch == nullptr ? 0 : hll_.Query(sketch));
+    }
+    std::shared_ptr<arrow::Array> out_arr;
+    RETURN_NOT_OK(builder.Finish(&out_arr));
+    out->push_back(out_arr);
+    return arrow::Status::OK();
+  }
+
+ private:
+  // input
+  arrow::compute::FunctionContext* ctx_;
+  std::vector<const int64_t*> in_list_;
+  std::vector<int64_t> sketch_;
+  int row_id_;
+  // result, num_words_ registers words per group, which stay contiguous
+  HyperLogLogPlusPlus hll_;
+  int num_words_;
+  AggregateArena arena_;
+  ArenaVector<int64_t*> sketches_;
   uint64_t length_ = 0;
 };
 
@@ -2166,6 +2626,95 @@ arrow::Status MakeStddevSampFinalAction(arrow::compute::FunctionContext* ctx,
   return arrow::Status::OK();
 }
 
+arrow::Status MakeCountDistinctAction(arrow::compute::FunctionContext* ctx,
+                                      std::shared_ptr<arrow::DataType> type,
+                                      std::shared_ptr<ActionBase>* out) {
+  switch (type->id()) {
+#define PROCESS(InType)                                                          \
+  case InType::type_id: {                                                        \
+    using CType = typename arrow::TypeTraits<InType>::CType;                     \
+    auto action_ptr = std::make_shared<CountDistinctAction<InType, CType>>(ctx); \
+    *out = std::dynamic_pointer_cast<ActionBase>(action_ptr);                    \
+  } break;
+    PROCESS_SUPPORTED_TYPES(PROCESS)
+#undef PROCESS
+    case arrow::StringType::type_id: {
+      auto action_ptr =
+          std::make_shared<CountDistinctAction<arrow::StringType, std::string>>(ctx);
+      *out = std::dynamic_pointer_cast<ActionBase>(action_ptr);
+    } break;
+    case arrow::Date32Type::type_id: {
+      auto action_ptr =
+          std::make_shared<CountDistinctAction<arrow::Date32Type, int32_t>>(ctx);
+      *out = std::dynamic_pointer_cast<ActionBase>(action_ptr);
+    } break;
+    default:
+      return arrow::Status::NotImplemented("CountDistinctAction doesn't support type ",
+                                           type->ToString());
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status MakeSumDistinctAction(arrow::compute::FunctionContext* ctx,
+                                    std::shared_ptr<arrow::DataType> type,
+                                    std::shared_ptr<ActionBase>* out) {
+  switch (type->id()) {
+#define PROCESS(InType)                                                 \
+  case InType::type_id: {                                               \
+    auto action_ptr = std::make_shared<SumDistinctAction<InType>>(ctx); \
+    *out = std::dynamic_pointer_cast<ActionBase>(action_ptr);           \
+  } break;
+    PROCESS_SUPPORTED_TYPES(PROCESS)
+#undef PROCESS
+    default:
+      return arrow::Status::NotImplemented("SumDistinctAction doesn't support type ",
+                                           type->ToString());
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status MakeApproxCountDistinctPartialAction(arrow::compute::FunctionContext* ctx,
+                                                   std::shared_ptr<arrow::DataType> type,
+                                                   double relative_sd,
+                                                   std::shared_ptr<ActionBase>* out) {
+  switch (type->id()) {
+#define PROCESS(InType)                                                    \
+  case InType::type_id: {                                                  \
+    using CType = typename arrow::TypeTraits<InType>::CType;               \
+    auto action_ptr =                                                      \
+        std::make_shared<ApproxCountDistinctPartialAction<InType, CType>>( \
+            ctx, relative_sd);                                             \
+    *out = std::dynamic_pointer_cast<ActionBase>(action_ptr);              \
+  } break;
+    PROCESS_SUPPORTED_TYPES(PROCESS)
+#undef PROCESS
+    case arrow::StringType::type_id: {
+      auto action_ptr = std::make_shared<
+          ApproxCountDistinctPartialAction<arrow::StringType, std::string>>(
+          ctx, relative_sd);
+      *out = std::dynamic_pointer_cast<ActionBase>(action_ptr);
+    } break;
+    case arrow::Date32Type::type_id: {
+      auto action_ptr =
+          std::make_shared<ApproxCountDistinctPartialAction<arrow::Date32Type, int32_t>>(
+              ctx, relative_sd);
+      *out = std::dynamic_pointer_cast<ActionBase>(action_ptr);
+    } break;
+    default:
+      return arrow::Status::NotImplemented(
+          "ApproxCountDistinctPartialAction doesn't support type ", type->ToString());
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status MakeApproxCountDistinctFinalAction(arrow::compute::FunctionContext* ctx,
+                                                 double relative_sd,
+                                                 std::shared_ptr<ActionBase>* out) {
+  auto action_ptr = std::make_shared<ApproxCountDistinctFinalAction>(ctx, relative_sd);
+  *out = std::dynamic_pointer_cast<ActionBase>(action_ptr);
+  return arrow::Status::OK();
+}
+
 #undef PROCESS_SUPPORTED_TYPES
 
 }  // namespace extra
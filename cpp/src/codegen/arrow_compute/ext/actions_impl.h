@@ -57,6 +57,8 @@ class ActionBase {
   virtual arrow::Status Evaluate(int dest_group_id, void* data1, void* data2);
   virtual arrow::Status Evaluate(int dest_group_id, void* data1, void* data2,
                                  void* data3);
+  /* for actions with more inputs than the fixed arity overloads above */
+  virtual arrow::Status Evaluate(int dest_group_id, const std::vector<void*>& data_list);
   virtual arrow::Status EvaluateNull(int dest_group_id);
   virtual arrow::Status Finish(ArrayList* out);
   virtual arrow::Status Finish(uint64_t offset, uint64_t length, ArrayList* out);
@@ -109,6 +111,23 @@ arrow::Status MakeStddevSampPartialAction(arrow::compute::FunctionContext* ctx,
 arrow::Status MakeStddevSampFinalAction(arrow::compute::FunctionContext* ctx,
                                         std::shared_ptr<arrow::DataType> type,
                                         std::shared_ptr<ActionBase>* out);
+
+arrow::Status MakeCountDistinctAction(arrow::compute::FunctionContext* ctx,
+                                      std::shared_ptr<arrow::DataType> type,
+                                      std::shared_ptr<ActionBase>* out);
+
+arrow::Status MakeSumDistinctAction(arrow::compute::FunctionContext* ctx,
+                                    std::shared_ptr<arrow::DataType> type,
+                                    std::shared_ptr<ActionBase>* out);
+
+arrow::Status MakeApproxCountDistinctPartialAction(arrow::compute::FunctionContext* ctx,
+                                                   std::shared_ptr<arrow::DataType> type,
+                                                   double relative_sd,
+                                                   std::shared_ptr<ActionBase>* out);
+
+arrow::Status MakeApproxCountDistinctFinalAction(arrow::compute::FunctionContext* ctx,
+                                                 double relative_sd,
+                                                 std::shared_ptr<ActionBase>* out);
 }  // namespace extra
 }  // namespace arrowcompute
 }  // namespace codegen
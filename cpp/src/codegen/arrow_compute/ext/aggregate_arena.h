@@ -0,0 +1,192 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/memory_pool.h>
+#include <arrow/status.h>
+#include <arrow/util/string_view.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sparkcolumnarplugin {
+namespace codegen {
+namespace arrowcompute {
+namespace extra {
+
+/** AggregateArena
+ *
+ * Bump allocator of aggregate state. Memory comes from the memory pool in chunks,
+ * which start at 64KB and double up to 4MB, so the pool sees every byte the state
+ * uses and a high cardinality aggregate makes one pool call per chunk instead of one
+ * per key or per vector growth. Nothing is freed on its own, all chunks are returned
+ * to the pool at once by Release or by the destructor.
+ **/
+class AggregateArena {
+ public:
+  explicit AggregateArena(arrow::MemoryPool* pool) : pool_(pool) {}
+  ~AggregateArena() { Release(); }
+  AggregateArena(const AggregateArena&) = delete;
+  AggregateArena& operator=(const AggregateArena&) = delete;
+
+  /* size bytes aligned to 8 bytes */
+  arrow::Status Allocate(int64_t size, uint8_t** out) {
+    size = (size + 7) & ~static_cast<int64_t>(7);
+    if (end_ - cur_ < size) {
+      int64_t chunk_size = std::max(next_chunk_size_, size);
+      uint8_t* chunk;
+      RETURN_NOT_OK(pool_->Allocate(chunk_size, &chunk));
+      chunks_.emplace_back(chunk, chunk_size);
+      bytes_allocated_ += chunk_size;
+      cur_ = chunk;
+      end_ = chunk + chunk_size;
+      if (next_chunk_size_ < kMaxChunkSize) next_chunk_size_ *= 2;
+    }
+    *out = cur_;
+    cur_ += size;
+    return arrow::Status::OK();
+  }
+
+  /* Copies value into arena, out points to the copy */
+  arrow::Status CopyString(arrow::util::string_view value, arrow::util::string_view* out) {
+    uint8_t* data = nullptr;
+    if (value.size() > 0) {
+      RETURN_NOT_OK(Allocate(value.size(), &data));
+      std::memcpy(data, value.data(), value.size());
+    }
+    *out = arrow::util::string_view(reinterpret_cast<const char*>(data), value.size());
+    return arrow::Status::OK();
+  }
+
+  void Release() {
+    for (auto& chunk : chunks_) pool_->Free(chunk.first, chunk.second);
+    chunks_.clear();
+    bytes_allocated_ = 0;
+    cur_ = end_ = nullptr;
+    next_chunk_size_ = kMinChunkSize;
+  }
+
+  int64_t bytes_allocated() const { return bytes_allocated_; }
+
+ private:
+  static constexpr int64_t kMinChunkSize = 64 * 1024;
+  static constexpr int64_t kMaxChunkSize = 4 * 1024 * 1024;
+
+  arrow::MemoryPool* pool_;
+  std::vector<std::pair<uint8_t*, int64_t>> chunks_;
+  uint8_t* cur_ = nullptr;
+  uint8_t* end_ = nullptr;
+  int64_t next_chunk_size_ = kMinChunkSize;
+  int64_t bytes_allocated_ = 0;
+};
+
+/** ArenaVector
+ *
+ * Per group state of an action, indexed by group id like std::vector. Elements live
+ * in slabs of kSlabSize allocated from an AggregateArena, so growing never copies
+ * what is already stored. Vectors of different element types have the same slab
+ * boundaries, which lets values and validity of a range be appended slab by slab.
+ **/
+template <typename T>
+class ArenaVector {
+  static_assert(std::is_trivially_destructible<T>::value,
+                "ArenaVector never runs destructors of its elements");
+
+ public:
+  static constexpr int kSlabShift = 12;
+  static constexpr size_t kSlabSize = 1 << kSlabShift;
+  static constexpr size_t kSlabMask = kSlabSize - 1;
+
+  explicit ArenaVector(AggregateArena* arena) : arena_(arena) {}
+
+  size_t size() const { return size_; }
+
+  T& operator[](size_t i) { return slabs_[i >> kSlabShift][i & kSlabMask]; }
+  const T& operator[](size_t i) const { return slabs_[i >> kSlabShift][i & kSlabMask]; }
+
+  /* Same as std::vector::resize, elements after size are set to value */
+  arrow::Status resize(size_t size, const T& value = T()) {
+    while (slabs_.size() * kSlabSize < size) {
+      uint8_t* slab;
+      RETURN_NOT_OK(arena_->Allocate(kSlabSize * sizeof(T), &slab));
+      slabs_.push_back(reinterpret_cast<T*>(slab));
+    }
+    for (size_t i = size_; i < size; i++) (*this)[i] = value;
+    size_ = size;
+    return arrow::Status::OK();
+  }
+
+  /* Grows to hold index, a whole slab at a time */
+  arrow::Status Grow(size_t index, const T& value = T()) {
+    if (index < size_) return arrow::Status::OK();
+    return resize((index + kSlabSize) & ~kSlabMask, value);
+  }
+
+  /* Contiguous elements starting at i, until the end of its slab */
+  const T* SlabData(size_t i, size_t* slab_remaining) const {
+    *slab_remaining = kSlabSize - (i & kSlabMask);
+    return &(*this)[i];
+  }
+
+ private:
+  AggregateArena* arena_;
+  std::vector<T*> slabs_;
+  size_t size_ = 0;
+};
+
+/* Appends values[offset, offset + length) to builder, validity holds 0 for nulls */
+template <typename BuilderType, typename T>
+arrow::Status AppendArenaValues(BuilderType* builder, const ArenaVector<T>& values,
+                                const ArenaVector<uint8_t>& validity, size_t offset,
+                                size_t length) {
+  RETURN_NOT_OK(builder->Reserve(length));
+  size_t end = offset + length;
+  for (size_t i = offset; i < end;) {
+    size_t slab_remaining;
+    auto data = values.SlabData(i, &slab_remaining);
+    auto n = std::min(slab_remaining, end - i);
+    RETURN_NOT_OK(builder->AppendValues(data, n, &validity[i]));
+    i += n;
+  }
+  return arrow::Status::OK();
+}
+
+/* Appends values[offset, offset + length) to builder, none of them is null */
+template <typename BuilderType, typename T>
+arrow::Status AppendArenaValues(BuilderType* builder, const ArenaVector<T>& values,
+                                size_t offset, size_t length) {
+  RETURN_NOT_OK(builder->Reserve(length));
+  size_t end = offset + length;
+  for (size_t i = offset; i < end;) {
+    size_t slab_remaining;
+    auto data = values.SlabData(i, &slab_remaining);
+    auto n = std::min(slab_remaining, end - i);
+    RETURN_NOT_OK(builder->AppendValues(data, n));
+    i += n;
+  }
+  return arrow::Status::OK();
+}
+
+}  // namespace extra
+}  // namespace arrowcompute
+}  // namespace codegen
+}  // namespace sparkcolumnarplugin
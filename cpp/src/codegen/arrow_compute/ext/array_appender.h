@@ -17,18 +17,60 @@
 
 #pragma once
 
+#include <arrow/array.h>
 #include <arrow/status.h>
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "codegen/arrow_compute/ext/array_item_index.h"
+#include "codegen/common/result_iterator.h"
 
 namespace sparkcolumnarplugin {
 namespace codegen {
 namespace arrowcompute {
 namespace extra {
 
+/* Row pairs produced by one probe batch. Probe functions only record which probe
+ * row matched which build row, result columns are gathered afterwards one column
+ * at a time by AppenderBase::AppendMatches. */
+struct JoinMatchList {
+  std::vector<int32_t> probe_ids;
+  std::vector<ArrayItemIndex> build_ids;
+  // false if build side of this row should be null, e.g. unmatched outer row
+  std::vector<bool> build_valid;
+  std::vector<bool> existence;
+
+  void Append(int32_t probe_id, const std::vector<ArrayItemIndex>& index_list) {
+    for (auto& tmp : index_list) {
+      probe_ids.push_back(probe_id);
+      build_ids.push_back(tmp);
+      build_valid.push_back(true);
+    }
+  }
+
+  void AppendUnmatched(int32_t probe_id) {
+    probe_ids.push_back(probe_id);
+    build_ids.emplace_back();
+    build_valid.push_back(false);
+  }
+
+  void AppendExistence(int32_t probe_id, bool exists) {
+    AppendUnmatched(probe_id);
+    existence.push_back(exists);
+  }
+
+  int64_t size() const { return probe_ids.size(); }
+
+  void Reset() {
+    probe_ids.clear();
+    build_ids.clear();
+    build_valid.clear();
+    existence.clear();
+  }
+};
+
 class AppenderBase {
  public:
   virtual ~AppenderBase() {}
@@ -72,8 +114,49 @@ class AppenderBase {
   virtual arrow::Status AppendExistence(bool is_exist) {
     return arrow::Status::NotImplemented("AppenderBase AppendExistence is abstract.");
   }
+
+  virtual arrow::Status AppendMatches(const JoinMatchList& matches) {
+    return arrow::Status::NotImplemented("AppenderBase AppendMatches is abstract.");
+  }
 };
 
+/* Gather one result column for all recorded matches. Left appenders read build
+ * side rows, right appenders read the probe batch which is the only cached array
+ * while probing. */
+template <typename ArrayType, typename BuilderType>
+arrow::Status GatherMatches(const JoinMatchList& matches,
+                            AppenderBase::AppenderType type,
+                            const std::vector<std::shared_ptr<ArrayType>>& cached_arr,
+                            bool has_null, BuilderType* builder) {
+  auto length = matches.size();
+  RETURN_NOT_OK(builder->Reserve(length));
+  if (type == AppenderBase::right) {
+    auto& arr = cached_arr[0];
+    for (int64_t i = 0; i < length; i++) {
+      auto id = matches.probe_ids[i];
+      if (has_null && arr->IsNull(id)) {
+        RETURN_NOT_OK(builder->AppendNull());
+      } else {
+        RETURN_NOT_OK(builder->Append(arr->GetView(id)));
+      }
+    }
+  } else {
+    for (int64_t i = 0; i < length; i++) {
+      if (!matches.build_valid[i]) {
+        RETURN_NOT_OK(builder->AppendNull());
+        continue;
+      }
+      auto& tmp = matches.build_ids[i];
+      if (has_null && cached_arr[tmp.array_id]->IsNull(tmp.id)) {
+        RETURN_NOT_OK(builder->AppendNull());
+      } else {
+        RETURN_NOT_OK(builder->Append(cached_arr[tmp.array_id]->GetView(tmp.id)));
+      }
+    }
+  }
+  return arrow::Status::OK();
+}
+
 template <typename DataType, typename Enable = void>
 class ArrayAppender {};
 
@@ -146,6 +229,10 @@ class ArrayAppender<DataType, enable_if_number_or_date<DataType>> : public Appen
 
   arrow::Status AppendNull() override { return builder_->AppendNull(); }
 
+  arrow::Status AppendMatches(const JoinMatchList& matches) override {
+    return GatherMatches(matches, type_, cached_arr_, has_null_, builder_.get());
+  }
+
   arrow::Status Finish(std::shared_ptr<arrow::Array>* out_) override {
     auto status = builder_->Finish(out_);
     return status;
@@ -230,6 +317,10 @@ class ArrayAppender<DataType, arrow::enable_if_string_like<DataType>>
 
   arrow::Status AppendNull() override { return builder_->AppendNull(); }
 
+  arrow::Status AppendMatches(const JoinMatchList& matches) override {
+    return GatherMatches(matches, type_, cached_arr_, has_null_, builder_.get());
+  }
+
   arrow::Status Finish(std::shared_ptr<arrow::Array>* out_) override {
     auto status = builder_->Finish(out_);
     return status;
@@ -314,6 +405,17 @@ class ArrayAppender<DataType, arrow::enable_if_boolean<DataType>> : public Appen
 
   arrow::Status AppendExistence(bool is_exist) { return builder_->Append(is_exist); }
 
+  arrow::Status AppendMatches(const JoinMatchList& matches) override {
+    if (type_ != exist) {
+      return GatherMatches(matches, type_, cached_arr_, has_null_, builder_.get());
+    }
+    RETURN_NOT_OK(builder_->Reserve(matches.existence.size()));
+    for (bool exists : matches.existence) {
+      RETURN_NOT_OK(builder_->Append(exists));
+    }
+    return arrow::Status::OK();
+  }
+
   arrow::Status Finish(std::shared_ptr<arrow::Array>* out_) override {
     auto status = builder_->Finish(out_);
     return status;
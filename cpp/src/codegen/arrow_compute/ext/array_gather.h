@@ -0,0 +1,326 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <arrow/memory_pool.h>
+#include <arrow/status.h>
+#include <arrow/type.h>
+#include <arrow/type_traits.h>
+#include <arrow/util/bit_util.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "codegen/arrow_compute/ext/array_item_index.h"
+
+namespace sparkcolumnarplugin {
+namespace codegen {
+namespace arrowcompute {
+namespace extra {
+
+/* Indices of one block, small enough to stay in cache while every column reads them */
+static constexpr int64_t kGatherBlockSize = 1024;
+/* How many rows ahead the source value of a row is prefetched */
+static constexpr int64_t kGatherPrefetchDistance = 16;
+
+/** ArrayGatherer
+ *
+ * Builds one output column from rows of cached arrays, in the order of a list of
+ * ArrayItemIndexS. Reserve allocates the output for all rows of the list, Gather
+ * copies the rows of one block of it, Finish hands out the array. Values are copied
+ * with plain loads and stores instead of a builder call per row, and validity is only
+ * touched when some cached array has nulls.
+ **/
+class ArrayGatherer {
+ public:
+  virtual ~ArrayGatherer() {}
+  virtual void AddArray(const std::shared_ptr<arrow::Array>& array) = 0;
+  virtual arrow::Status Reserve(const ArrayItemIndexS* indices, int64_t length) = 0;
+  /* Copies rows indices[0, length) to output rows [offset, offset + length) */
+  virtual void Gather(const ArrayItemIndexS* indices, int64_t offset,
+                      int64_t length) = 0;
+  virtual arrow::Status Finish(std::shared_ptr<arrow::Array>* out) = 0;
+
+ protected:
+  explicit ArrayGatherer(arrow::MemoryPool* pool, std::shared_ptr<arrow::DataType> type)
+      : pool_(pool), type_(type) {}
+
+  void AddValidity(const std::shared_ptr<arrow::Array>& array) {
+    validity_.push_back(array->null_count() > 0 ? array->null_bitmap_data() : nullptr);
+    validity_offsets_.push_back(array->offset());
+    if (array->null_count() > 0) has_null_ = true;
+  }
+
+  arrow::Status ReserveValidity(int64_t length) {
+    length_ = length;
+    null_count_ = 0;
+    out_validity_buf_ = nullptr;
+    if (!has_null_) return arrow::Status::OK();
+    auto size = arrow::BitUtil::BytesForBits(length);
+    RETURN_NOT_OK(arrow::AllocateBuffer(pool_, size, &out_validity_buf_));
+    std::memset(out_validity_buf_->mutable_data(), 0, size);
+    return arrow::Status::OK();
+  }
+
+  void GatherValidity(const ArrayItemIndexS* indices, int64_t offset, int64_t length) {
+    if (!has_null_) return;
+    auto out_validity = out_validity_buf_->mutable_data();
+    for (int64_t i = 0; i < length; i++) {
+      auto validity = validity_[indices[i].array_id];
+      bool is_valid =
+          validity == nullptr ||
+          arrow::BitUtil::GetBit(
+              validity, validity_offsets_[indices[i].array_id] + indices[i].id);
+      arrow::BitUtil::SetBitTo(out_validity, offset + i, is_valid);
+      null_count_ += !is_valid;
+    }
+  }
+
+  arrow::MemoryPool* pool_;
+  std::shared_ptr<arrow::DataType> type_;
+  bool has_null_ = false;
+  int64_t length_ = 0;
+  int64_t null_count_ = 0;
+  std::shared_ptr<arrow::Buffer> out_validity_buf_;
+
+ private:
+  std::vector<const uint8_t*> validity_;
+  std::vector<int64_t> validity_offsets_;
+};
+
+template <typename DataType, typename Enable = void>
+class TypedArrayGatherer {};
+
+template <typename DataType>
+using enable_if_fixed_width_value =
+    std::enable_if_t<arrow::is_number_type<DataType>::value ||
+                     arrow::is_date_type<DataType>::value>;
+
+/* Fixed width values, each source value is prefetched a few rows before its copy */
+template <typename DataType>
+class TypedArrayGatherer<DataType, enable_if_fixed_width_value<DataType>>
+    : public ArrayGatherer {
+ public:
+  TypedArrayGatherer(arrow::MemoryPool* pool, std::shared_ptr<arrow::DataType> type)
+      : ArrayGatherer(pool, type) {}
+
+  void AddArray(const std::shared_ptr<arrow::Array>& array) override {
+    values_.push_back(std::static_pointer_cast<ArrayType>(array)->raw_values());
+    AddValidity(array);
+  }
+
+  arrow::Status Reserve(const ArrayItemIndexS* indices, int64_t length) override {
+    RETURN_NOT_OK(ReserveValidity(length));
+    return arrow::AllocateBuffer(pool_, length * sizeof(CType), &out_values_buf_);
+  }
+
+  void Gather(const ArrayItemIndexS* indices, int64_t offset, int64_t length) override {
+    auto out_values = reinterpret_cast<CType*>(out_values_buf_->mutable_data()) + offset;
+    for (int64_t i = 0; i < length; i++) {
+      if (i + kGatherPrefetchDistance < length) {
+        auto& ahead = indices[i + kGatherPrefetchDistance];
+        __builtin_prefetch(values_[ahead.array_id] + ahead.id);
+      }
+      out_values[i] = values_[indices[i].array_id][indices[i].id];
+    }
+    GatherValidity(indices, offset, length);
+  }
+
+  arrow::Status Finish(std::shared_ptr<arrow::Array>* out) override {
+    *out = arrow::MakeArray(arrow::ArrayData::Make(
+        type_, length_, {out_validity_buf_, out_values_buf_}, null_count_));
+    return arrow::Status::OK();
+  }
+
+ private:
+  using ArrayType = typename arrow::TypeTraits<DataType>::ArrayType;
+  using CType = typename arrow::TypeTraits<DataType>::CType;
+  std::vector<const CType*> values_;
+  std::shared_ptr<arrow::Buffer> out_values_buf_;
+};
+
+template <typename DataType>
+class TypedArrayGatherer<DataType, arrow::enable_if_boolean<DataType>>
+    : public ArrayGatherer {
+ public:
+  TypedArrayGatherer(arrow::MemoryPool* pool, std::shared_ptr<arrow::DataType> type)
+      : ArrayGatherer(pool, type) {}
+
+  void AddArray(const std::shared_ptr<arrow::Array>& array) override {
+    auto typed_array = std::static_pointer_cast<arrow::BooleanArray>(array);
+    values_.push_back(typed_array->values()->data());
+    values_offsets_.push_back(array->offset());
+    AddValidity(array);
+  }
+
+  arrow::Status Reserve(const ArrayItemIndexS* indices, int64_t length) override {
+    RETURN_NOT_OK(ReserveValidity(length));
+    auto size = arrow::BitUtil::BytesForBits(length);
+    RETURN_NOT_OK(arrow::AllocateBuffer(pool_, size, &out_values_buf_));
+    std::memset(out_values_buf_->mutable_data(), 0, size);
+    return arrow::Status::OK();
+  }
+
+  void Gather(const ArrayItemIndexS* indices, int64_t offset, int64_t length) override {
+    auto out_values = out_values_buf_->mutable_data();
+    for (int64_t i = 0; i < length; i++) {
+      auto array_id = indices[i].array_id;
+      arrow::BitUtil::SetBitTo(
+          out_values, offset + i,
+          arrow::BitUtil::GetBit(values_[array_id],
+                                 values_offsets_[array_id] + indices[i].id));
+    }
+    GatherValidity(indices, offset, length);
+  }
+
+  arrow::Status Finish(std::shared_ptr<arrow::Array>* out) override {
+    *out = arrow::MakeArray(arrow::ArrayData::Make(
+        type_, length_, {out_validity_buf_, out_values_buf_}, null_count_));
+    return arrow::Status::OK();
+  }
+
+ private:
+  std::vector<const uint8_t*> values_;
+  std::vector<int64_t> values_offsets_;
+  std::shared_ptr<arrow::Buffer> out_values_buf_;
+};
+
+/* Strings take two passes: Reserve sums value lengths, so the offsets are known and
+ * the data is allocated once, then Gather copies values with memcpy. */
+template <typename DataType>
+class TypedArrayGatherer<DataType, arrow::enable_if_string_like<DataType>>
+    : public ArrayGatherer {
+ public:
+  TypedArrayGatherer(arrow::MemoryPool* pool, std::shared_ptr<arrow::DataType> type)
+      : ArrayGatherer(pool, type) {}
+
+  void AddArray(const std::shared_ptr<arrow::Array>& array) override {
+    auto typed_array = std::static_pointer_cast<ArrayType>(array);
+    offsets_.push_back(typed_array->raw_value_offsets());
+    data_.push_back(typed_array->value_data() ? typed_array->value_data()->data()
+                                              : nullptr);
+    AddValidity(array);
+  }
+
+  arrow::Status Reserve(const ArrayItemIndexS* indices, int64_t length) override {
+    RETURN_NOT_OK(ReserveValidity(length));
+    RETURN_NOT_OK(
+        arrow::AllocateBuffer(pool_, (length + 1) * sizeof(int32_t), &out_offsets_buf_));
+    auto out_offsets = reinterpret_cast<int32_t*>(out_offsets_buf_->mutable_data());
+    out_offsets[0] = 0;
+    for (int64_t i = 0; i < length; i++) {
+      auto offsets = offsets_[indices[i].array_id] + indices[i].id;
+      out_offsets[i + 1] = out_offsets[i] + (offsets[1] - offsets[0]);
+    }
+    return arrow::AllocateBuffer(pool_, out_offsets[length], &out_data_buf_);
+  }
+
+  void Gather(const ArrayItemIndexS* indices, int64_t offset, int64_t length) override {
+    auto out_offsets =
+        reinterpret_cast<const int32_t*>(out_offsets_buf_->data()) + offset;
+    auto out_data = out_data_buf_->mutable_data();
+    for (int64_t i = 0; i < length; i++) {
+      auto array_id = indices[i].array_id;
+      auto offsets = offsets_[array_id] + indices[i].id;
+      std::memcpy(out_data + out_offsets[i], data_[array_id] + offsets[0],
+                  offsets[1] - offsets[0]);
+    }
+    GatherValidity(indices, offset, length);
+  }
+
+  arrow::Status Finish(std::shared_ptr<arrow::Array>* out) override {
+    *out = arrow::MakeArray(arrow::ArrayData::Make(
+        type_, length_, {out_validity_buf_, out_offsets_buf_, out_data_buf_},
+        null_count_));
+    return arrow::Status::OK();
+  }
+
+ private:
+  using ArrayType = typename arrow::TypeTraits<DataType>::ArrayType;
+  std::vector<const int32_t*> offsets_;
+  std::vector<const uint8_t*> data_;
+  std::shared_ptr<arrow::Buffer> out_offsets_buf_;
+  std::shared_ptr<arrow::Buffer> out_data_buf_;
+};
+
+#define PROCESS_SUPPORTED_TYPES(PROCESS) \
+  PROCESS(arrow::BooleanType)            \
+  PROCESS(arrow::UInt8Type)              \
+  PROCESS(arrow::Int8Type)               \
+  PROCESS(arrow::UInt16Type)             \
+  PROCESS(arrow::Int16Type)              \
+  PROCESS(arrow::UInt32Type)             \
+  PROCESS(arrow::Int32Type)              \
+  PROCESS(arrow::UInt64Type)             \
+  PROCESS(arrow::Int64Type)              \
+  PROCESS(arrow::FloatType)              \
+  PROCESS(arrow::DoubleType)             \
+  PROCESS(arrow::Date32Type)             \
+  PROCESS(arrow::Date64Type)             \
+  PROCESS(arrow::StringType)
+static arrow::Status MakeArrayGatherer(arrow::MemoryPool* pool,
+                                       std::shared_ptr<arrow::DataType> type,
+                                       std::shared_ptr<ArrayGatherer>* out) {
+  switch (type->id()) {
+#define PROCESS(InType)                                             \
+  case InType::type_id: {                                           \
+    *out = std::make_shared<TypedArrayGatherer<InType>>(pool, type); \
+  } break;
+    PROCESS_SUPPORTED_TYPES(PROCESS)
+#undef PROCESS
+    default: {
+      return arrow::Status::NotImplemented(
+          "MakeArrayGatherer type not supported, type is ", type->ToString());
+    } break;
+  }
+  return arrow::Status::OK();
+}
+#undef PROCESS_SUPPORTED_TYPES
+
+/* Gathers rows indices[0, length) of every column, block by block, so each block of
+ * indices is read from memory once for all columns */
+static arrow::Status GatherArrays(
+    const std::vector<std::shared_ptr<ArrayGatherer>>& gatherers,
+    const ArrayItemIndexS* indices, int64_t length,
+    std::vector<std::shared_ptr<arrow::Array>>* out) {
+  for (auto& gatherer : gatherers) {
+    RETURN_NOT_OK(gatherer->Reserve(indices, length));
+  }
+  for (int64_t offset = 0; offset < length; offset += kGatherBlockSize) {
+    auto block_length = std::min(kGatherBlockSize, length - offset);
+    for (auto& gatherer : gatherers) {
+      gatherer->Gather(indices + offset, offset, block_length);
+    }
+  }
+  for (auto& gatherer : gatherers) {
+    std::shared_ptr<arrow::Array> array;
+    RETURN_NOT_OK(gatherer->Finish(&array));
+    out->push_back(array);
+  }
+  return arrow::Status::OK();
+}
+
+}  // namespace extra
+}  // namespace arrowcompute
+}  // namespace codegen
+}  // namespace sparkcolumnarplugin
@@ -0,0 +1,483 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/type_traits.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(COLUMNAR_PLUGIN_USE_AVX512) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace sparkcolumnarplugin {
+namespace codegen {
+namespace arrowcompute {
+namespace extra {
+
+/** Reductions over one array
+ *
+ * Values are visited 64 at a time along with one word of the validity bitmap. A word
+ * whose values are all valid goes to Reducer::Dense, any other word with valid values
+ * goes to Reducer::Masked, which only reads the values of set bits. Dense and Masked
+ * use AVX-512 for the common types when built with USE_AVX512, otherwise AVX2 on x86-64
+ * CPUs that have it.
+ **/
+
+/* Result type of sum without grouping, same as arrow::compute::Sum */
+template <typename I, typename Enable = void>
+struct SumResultType {};
+
+template <typename I>
+struct SumResultType<I, arrow::enable_if_signed_integer<I>> {
+  using Type = arrow::Int64Type;
+};
+
+template <typename I>
+struct SumResultType<I, arrow::enable_if_unsigned_integer<I>> {
+  using Type = arrow::UInt64Type;
+};
+
+template <typename I>
+struct SumResultType<I, arrow::enable_if_floating_point<I>> {
+  using Type = arrow::DoubleType;
+};
+
+/* num_bits validity bits starting at bit_offset, higher bits of the word are clear */
+inline uint64_t LoadValidityWord(const uint8_t* bitmap, int64_t bit_offset,
+                                 int64_t num_bits) {
+  const uint8_t* bytes = bitmap + bit_offset / 8;
+  int shift = bit_offset % 8;
+  int num_bytes = (shift + num_bits + 7) / 8;
+  uint64_t word = 0;
+  std::memcpy(&word, bytes, std::min(num_bytes, 8));
+  word >>= shift;
+  if (num_bytes > 8) word |= static_cast<uint64_t>(bytes[8]) << (64 - shift);
+  if (num_bits < 64) word &= (1ULL << num_bits) - 1;
+  return word;
+}
+
+template <typename AccType>
+struct SumState {
+  AccType sum = 0;
+  AccType Result() const { return sum; }
+};
+
+/* Kahan summation, compensation holds the low order bits lost by sum */
+struct KahanSumState {
+  double sum = 0;
+  double compensation = 0;
+
+  void Add(double value) {
+    double y = value - compensation;
+    double t = sum + y;
+    compensation = (t - sum) - y;
+    sum = t;
+  }
+  double Result() const { return sum - compensation; }
+};
+
+/* Sum of decimal128 unscaled values, overflow is set once sum doesn't fit 128 bits */
+struct Decimal128SumState {
+  __int128 sum = 0;
+  bool overflow = false;
+
+  void Add(__int128 value) {
+    if (__builtin_add_overflow(sum, value, &sum)) overflow = true;
+  }
+};
+
+template <typename CType, typename AccType>
+struct SumReducer {
+  using State = SumState<AccType>;
+
+  static void Dense(const CType* values, int64_t length, State* state) {
+    ScalarDense(values, length, state);
+  }
+
+  static void Masked(const CType* values, uint64_t word, State* state) {
+    ScalarMasked(values, word, state);
+  }
+
+  static void ScalarDense(const CType* values, int64_t length, State* state) {
+    AccType sum = 0;
+    for (int64_t i = 0; i < length; i++) sum += values[i];
+    state->sum += sum;
+  }
+
+  static void ScalarMasked(const CType* values, uint64_t word, State* state) {
+    for (; word != 0; word &= word - 1) state->sum += values[__builtin_ctzll(word)];
+  }
+};
+
+/* Each SIMD lane keeps its own compensation, lanes are merged by compensated adds */
+template <typename CType>
+struct KahanSumReducer {
+  using State = KahanSumState;
+
+  static void Dense(const CType* values, int64_t length, State* state) {
+    ScalarDense(values, length, state);
+  }
+
+  static void Masked(const CType* values, uint64_t word, State* state) {
+    for (; word != 0; word &= word - 1) state->Add(values[__builtin_ctzll(word)]);
+  }
+
+  static void ScalarDense(const CType* values, int64_t length, State* state) {
+    for (int64_t i = 0; i < length; i++) state->Add(values[i]);
+  }
+};
+
+#if defined(COLUMNAR_PLUGIN_USE_AVX512)
+template <>
+inline void SumReducer<double, double>::Dense(const double* values, int64_t length,
+                                              State* state) {
+  __m512d acc = _mm512_setzero_pd();
+  int64_t i = 0;
+  for (; i + 8 <= length; i += 8) acc = _mm512_add_pd(acc, _mm512_loadu_pd(values + i));
+  double sum = _mm512_reduce_add_pd(acc);
+  for (; i < length; i++) sum += values[i];
+  state->sum += sum;
+}
+
+template <>
+inline void SumReducer<double, double>::Masked(const double* values, uint64_t word,
+                                               State* state) {
+  // masked loads don't touch the values of clear bits, which may be out of array
+  __m512d acc = _mm512_setzero_pd();
+  for (int i = 0; i < 64 && (word >> i) != 0; i += 8) {
+    acc = _mm512_add_pd(
+        acc, _mm512_maskz_loadu_pd(static_cast<__mmask8>(word >> i), values + i));
+  }
+  state->sum += _mm512_reduce_add_pd(acc);
+}
+
+template <>
+inline void SumReducer<int64_t, int64_t>::Dense(const int64_t* values, int64_t length,
+                                                State* state) {
+  __m512i acc = _mm512_setzero_si512();
+  int64_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    acc = _mm512_add_epi64(acc, _mm512_loadu_si512(values + i));
+  }
+  int64_t sum = _mm512_reduce_add_epi64(acc);
+  for (; i < length; i++) sum += values[i];
+  state->sum += sum;
+}
+
+template <>
+inline void SumReducer<int64_t, int64_t>::Masked(const int64_t* values, uint64_t word,
+                                                 State* state) {
+  __m512i acc = _mm512_setzero_si512();
+  for (int i = 0; i < 64 && (word >> i) != 0; i += 8) {
+    acc = _mm512_add_epi64(
+        acc, _mm512_maskz_loadu_epi64(static_cast<__mmask8>(word >> i), values + i));
+  }
+  state->sum += _mm512_reduce_add_epi64(acc);
+}
+
+template <>
+inline void SumReducer<int32_t, int64_t>::Dense(const int32_t* values, int64_t length,
+                                                State* state) {
+  __m512i acc = _mm512_setzero_si512();
+  int64_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+    acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(v));
+  }
+  int64_t sum = _mm512_reduce_add_epi64(acc);
+  for (; i < length; i++) sum += values[i];
+  state->sum += sum;
+}
+
+template <>
+inline void SumReducer<int32_t, int64_t>::Masked(const int32_t* values, uint64_t word,
+                                                 State* state) {
+  __m512i acc = _mm512_setzero_si512();
+  for (int i = 0; i < 64 && (word >> i) != 0; i += 8) {
+    auto v = _mm256_maskz_loadu_epi32(static_cast<__mmask8>(word >> i), values + i);
+    acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(v));
+  }
+  state->sum += _mm512_reduce_add_epi64(acc);
+}
+
+template <>
+inline void KahanSumReducer<double>::Dense(const double* values, int64_t length,
+                                           State* state) {
+  constexpr int kLanes = 8;
+  __m512d sum = _mm512_setzero_pd();
+  __m512d compensation = _mm512_setzero_pd();
+  int64_t i = 0;
+  for (; i + kLanes <= length; i += kLanes) {
+    auto y = _mm512_sub_pd(_mm512_loadu_pd(values + i), compensation);
+    auto t = _mm512_add_pd(sum, y);
+    compensation = _mm512_sub_pd(_mm512_sub_pd(t, sum), y);
+    sum = t;
+  }
+  double sum_lanes[kLanes];
+  double compensation_lanes[kLanes];
+  _mm512_storeu_pd(sum_lanes, sum);
+  _mm512_storeu_pd(compensation_lanes, compensation);
+  for (int lane = 0; lane < kLanes; lane++) {
+    state->Add(sum_lanes[lane]);
+    state->Add(-compensation_lanes[lane]);
+  }
+  for (; i < length; i++) state->Add(values[i]);
+}
+#elif defined(__x86_64__)
+/* Without USE_AVX512 the library is built for baseline x86-64, so the AVX2 kernels
+ * below are compiled for AVX2 alone and only called once the CPU is known to have it */
+#define ARRAY_REDUCE_AVX2 __attribute__((target("avx2")))
+
+inline bool CpuSupportsAvx2() {
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+
+/* all ones in 64-bit lane j if bit j of bits is set, for 4 lanes */
+ARRAY_REDUCE_AVX2 inline __m256i ExpandBitsx4(uint64_t bits) {
+  const __m256i lane_bits = _mm256_setr_epi64x(1, 2, 4, 8);
+  auto v = _mm256_and_si256(_mm256_set1_epi64x(bits & 0xf), lane_bits);
+  return _mm256_cmpeq_epi64(v, lane_bits);
+}
+
+ARRAY_REDUCE_AVX2 inline void SumDenseAvx2(const double* values, int64_t length,
+                                           SumState<double>* state) {
+  __m256d acc = _mm256_setzero_pd();
+  int64_t i = 0;
+  for (; i + 4 <= length; i += 4) acc = _mm256_add_pd(acc, _mm256_loadu_pd(values + i));
+  double lanes[4];
+  _mm256_storeu_pd(lanes, acc);
+  double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+  for (; i < length; i++) sum += values[i];
+  state->sum += sum;
+}
+
+ARRAY_REDUCE_AVX2 inline void SumMaskedAvx2(const double* values, uint64_t word,
+                                            SumState<double>* state) {
+  // masked loads don't touch the values of clear bits, which may be out of array
+  __m256d acc = _mm256_setzero_pd();
+  for (int i = 0; i < 64 && (word >> i) != 0; i += 4) {
+    acc = _mm256_add_pd(acc, _mm256_maskload_pd(values + i, ExpandBitsx4(word >> i)));
+  }
+  double lanes[4];
+  _mm256_storeu_pd(lanes, acc);
+  state->sum += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+ARRAY_REDUCE_AVX2 inline void SumDenseAvx2(const int64_t* values, int64_t length,
+                                           SumState<int64_t>* state) {
+  __m256i acc = _mm256_setzero_si256();
+  int64_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    acc = _mm256_add_epi64(
+        acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)));
+  }
+  int64_t lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+  int64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+  for (; i < length; i++) sum += values[i];
+  state->sum += sum;
+}
+
+ARRAY_REDUCE_AVX2 inline void SumMaskedAvx2(const int64_t* values, uint64_t word,
+                                            SumState<int64_t>* state) {
+  __m256i acc = _mm256_setzero_si256();
+  for (int i = 0; i < 64 && (word >> i) != 0; i += 4) {
+    auto v = _mm256_maskload_epi64(reinterpret_cast<const long long*>(values + i),
+                                   ExpandBitsx4(word >> i));
+    acc = _mm256_add_epi64(acc, v);
+  }
+  int64_t lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+  state->sum += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+ARRAY_REDUCE_AVX2 inline void SumDenseAvx2(const int32_t* values, int64_t length,
+                                           SumState<int64_t>* state) {
+  __m256i acc = _mm256_setzero_si256();
+  int64_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(v));
+  }
+  int64_t lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+  int64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+  for (; i < length; i++) sum += values[i];
+  state->sum += sum;
+}
+
+ARRAY_REDUCE_AVX2 inline void SumMaskedAvx2(const int32_t* values, uint64_t word,
+                                            SumState<int64_t>* state) {
+  const __m128i lane_bits = _mm_setr_epi32(1, 2, 4, 8);
+  __m256i acc = _mm256_setzero_si256();
+  for (int i = 0; i < 64 && (word >> i) != 0; i += 4) {
+    auto bits = _mm_and_si128(_mm_set1_epi32((word >> i) & 0xf), lane_bits);
+    auto v = _mm_maskload_epi32(values + i, _mm_cmpeq_epi32(bits, lane_bits));
+    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(v));
+  }
+  int64_t lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+  state->sum += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+ARRAY_REDUCE_AVX2 inline void KahanSumDenseAvx2(const double* values, int64_t length,
+                                                KahanSumState* state) {
+  constexpr int kLanes = 4;
+  __m256d sum = _mm256_setzero_pd();
+  __m256d compensation = _mm256_setzero_pd();
+  int64_t i = 0;
+  for (; i + kLanes <= length; i += kLanes) {
+    auto y = _mm256_sub_pd(_mm256_loadu_pd(values + i), compensation);
+    auto t = _mm256_add_pd(sum, y);
+    compensation = _mm256_sub_pd(_mm256_sub_pd(t, sum), y);
+    sum = t;
+  }
+  double sum_lanes[kLanes];
+  double compensation_lanes[kLanes];
+  _mm256_storeu_pd(sum_lanes, sum);
+  _mm256_storeu_pd(compensation_lanes, compensation);
+  for (int lane = 0; lane < kLanes; lane++) {
+    state->Add(sum_lanes[lane]);
+    state->Add(-compensation_lanes[lane]);
+  }
+  for (; i < length; i++) state->Add(values[i]);
+}
+#undef ARRAY_REDUCE_AVX2
+
+template <>
+inline void SumReducer<double, double>::Dense(const double* values, int64_t length,
+                                              State* state) {
+  if (CpuSupportsAvx2()) return SumDenseAvx2(values, length, state);
+  ScalarDense(values, length, state);
+}
+
+template <>
+inline void SumReducer<double, double>::Masked(const double* values, uint64_t word,
+                                               State* state) {
+  if (CpuSupportsAvx2()) return SumMaskedAvx2(values, word, state);
+  ScalarMasked(values, word, state);
+}
+
+template <>
+inline void SumReducer<int64_t, int64_t>::Dense(const int64_t* values, int64_t length,
+                                                State* state) {
+  if (CpuSupportsAvx2()) return SumDenseAvx2(values, length, state);
+  ScalarDense(values, length, state);
+}
+
+template <>
+inline void SumReducer<int64_t, int64_t>::Masked(const int64_t* values, uint64_t word,
+                                                 State* state) {
+  if (CpuSupportsAvx2()) return SumMaskedAvx2(values, word, state);
+  ScalarMasked(values, word, state);
+}
+
+template <>
+inline void SumReducer<int32_t, int64_t>::Dense(const int32_t* values, int64_t length,
+                                                State* state) {
+  if (CpuSupportsAvx2()) return SumDenseAvx2(values, length, state);
+  ScalarDense(values, length, state);
+}
+
+template <>
+inline void SumReducer<int32_t, int64_t>::Masked(const int32_t* values, uint64_t word,
+                                                 State* state) {
+  if (CpuSupportsAvx2()) return SumMaskedAvx2(values, word, state);
+  ScalarMasked(values, word, state);
+}
+
+template <>
+inline void KahanSumReducer<double>::Dense(const double* values, int64_t length,
+                                           State* state) {
+  if (CpuSupportsAvx2()) return KahanSumDenseAvx2(values, length, state);
+  ScalarDense(values, length, state);
+}
+#endif
+
+/* Decimal128 values are little endian two's complement as arrow stores them */
+struct Decimal128SumReducer {
+  using State = Decimal128SumState;
+
+  static __int128 Load(const uint8_t* value) {
+    __int128 v;
+    std::memcpy(&v, value, sizeof(v));
+    return v;
+  }
+
+  static void Dense(const uint8_t* values, int64_t length, State* state) {
+    for (int64_t i = 0; i < length; i++) state->Add(Load(values + i * 16));
+  }
+
+  static void Masked(const uint8_t* values, uint64_t word, State* state) {
+    for (; word != 0; word &= word - 1) {
+      state->Add(Load(values + __builtin_ctzll(word) * 16));
+    }
+  }
+};
+
+template <typename Reducer>
+struct ReducerValueStride {
+  static constexpr int value = 1;
+};
+
+template <>
+struct ReducerValueStride<Decimal128SumReducer> {
+  static constexpr int value = 16;
+};
+
+/* Feeds valid values of values[0, length) to Reducer and returns the number of them,
+ * bitmap is null if all values are valid */
+template <typename Reducer, typename CType>
+int64_t ReduceValid(const CType* values, const uint8_t* bitmap, int64_t bit_offset,
+                    int64_t length, typename Reducer::State* state) {
+  constexpr int stride = ReducerValueStride<Reducer>::value;
+  if (bitmap == nullptr) {
+    Reducer::Dense(values, length, state);
+    return length;
+  }
+  int64_t count = 0;
+  for (int64_t i = 0; i < length; i += 64) {
+    auto num_bits = std::min<int64_t>(64, length - i);
+    auto word = LoadValidityWord(bitmap, bit_offset + i, num_bits);
+    auto full_word = num_bits == 64 ? ~0ULL : (1ULL << num_bits) - 1;
+    if (word == full_word) {
+      Reducer::Dense(values + i * stride, num_bits, state);
+      count += num_bits;
+    } else if (word != 0) {
+      Reducer::Masked(values + i * stride, word, state);
+      count += __builtin_popcountll(word);
+    }
+  }
+  return count;
+}
+
+template <typename Reducer, typename ArrayType>
+int64_t ReduceArray(const ArrayType& in, typename Reducer::State* state) {
+  auto bitmap = in.null_count() > 0 ? in.null_bitmap_data() : nullptr;
+  return ReduceValid<Reducer>(in.raw_values(), bitmap, in.offset(), in.length(), state);
+}
+
+}  // namespace extra
+}  // namespace arrowcompute
+}  // namespace codegen
+}  // namespace sparkcolumnarplugin
@@ -0,0 +1,340 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/builder.h>
+#include <arrow/compute/context.h>
+#include <arrow/status.h>
+#include <arrow/type.h>
+#include <arrow/type_traits.h>
+#include <arrow/util/checked_cast.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace sparkcolumnarplugin {
+namespace codegen {
+namespace arrowcompute {
+namespace extra {
+
+using ArrayList = std::vector<std::shared_ptr<arrow::Array>>;
+
+/** Batch accumulators
+ *
+ * Non-virtual, typed counterparts of sum/count/min/max/avg in actions_impl.cc, used
+ * by HashAggregateKernel codegen when NATIVESQL_AGGR_BATCH_ACCUMULATE is true.
+ * Generated code only stages each row's input by Stage/StageNull and its group id
+ * into a memo array, UpdateBatch then folds the whole batch in one tight loop.
+ * Group states are kept as struct-of-arrays with byte validity, so the loops stay
+ * branch-free where possible. Results are the same as the corresponding action.
+ **/
+
+template <typename I, typename Enable = void>
+struct BatchAccumulatorType {};
+
+template <typename I>
+struct BatchAccumulatorType<I, arrow::enable_if_integer<I>> {
+  using Type = arrow::Int64Type;
+};
+
+template <typename I>
+struct BatchAccumulatorType<I, arrow::enable_if_floating_point<I>> {
+  using Type = arrow::DoubleType;
+};
+
+template <typename DataType>
+inline std::unique_ptr<typename arrow::TypeTraits<DataType>::BuilderType>
+MakeAccumulatorBuilder(arrow::compute::FunctionContext* ctx) {
+  using BuilderType = typename arrow::TypeTraits<DataType>::BuilderType;
+  std::unique_ptr<arrow::ArrayBuilder> array_builder;
+  arrow::MakeBuilder(ctx->memory_pool(), arrow::TypeTraits<DataType>::type_singleton(),
+                     &array_builder);
+  return std::unique_ptr<BuilderType>(
+      arrow::internal::checked_cast<BuilderType*>(array_builder.release()));
+}
+
+inline int GetMaxGroupId(const int* memo_index, int64_t length) {
+  int max_group_id = -1;
+  for (int64_t i = 0; i < length; i++) {
+    max_group_id = std::max(max_group_id, memo_index[i]);
+  }
+  return max_group_id;
+}
+
+/* clip [offset, offset + length) to result length */
+inline uint64_t GetFinishLength(uint64_t offset, uint64_t length,
+                                uint64_t result_length) {
+  if (offset >= result_length) return 0;
+  return std::min(length, result_length - offset);
+}
+
+//////////////// SumBatchAccumulator ///////////////
+template <typename DataType>
+class SumBatchAccumulator {
+ public:
+  using CType = typename arrow::TypeTraits<DataType>::CType;
+  using ResDataType = typename BatchAccumulatorType<DataType>::Type;
+  using ResCType = typename arrow::TypeTraits<ResDataType>::CType;
+  using ResBuilderType = typename arrow::TypeTraits<ResDataType>::BuilderType;
+
+  SumBatchAccumulator(arrow::compute::FunctionContext* ctx)
+      : builder_(MakeAccumulatorBuilder<ResDataType>(ctx)) {}
+
+  void Stage(const CType& value) {
+    staged_.push_back(value);
+    staged_validity_.push_back(1);
+  }
+
+  void StageNull() {
+    staged_.push_back(0);
+    staged_validity_.push_back(0);
+  }
+
+  void UpdateBatch(const int* memo_index, int64_t length) {
+    Resize(GetMaxGroupId(memo_index, length) + 1);
+    auto values = staged_.data();
+    auto values_validity = staged_validity_.data();
+    auto sum = cache_.data();
+    auto validity = cache_validity_.data();
+    // null rows are staged as 0, so no branch is needed here
+    for (int64_t i = 0; i < length; i++) {
+      auto group_id = memo_index[i];
+      sum[group_id] += values[i];
+      validity[group_id] |= values_validity[i];
+    }
+    staged_.clear();
+    staged_validity_.clear();
+  }
+
+  uint64_t GetResultLength() { return cache_.size(); }
+
+  arrow::Status Finish(uint64_t offset, uint64_t length, ArrayList* out) {
+    length = GetFinishLength(offset, length, GetResultLength());
+    std::shared_ptr<arrow::Array> arr_out;
+    builder_->Reset();
+    RETURN_NOT_OK(builder_->AppendValues(cache_.data() + offset, length,
+                                         cache_validity_.data() + offset));
+    RETURN_NOT_OK(builder_->Finish(&arr_out));
+    out->push_back(arr_out);
+    return arrow::Status::OK();
+  }
+
+ private:
+  void Resize(int num_groups) {
+    if (num_groups <= static_cast<int>(cache_.size())) return;
+    cache_.resize(num_groups, 0);
+    cache_validity_.resize(num_groups, 0);
+  }
+
+  std::unique_ptr<ResBuilderType> builder_;
+  // staged input of current batch
+  std::vector<CType> staged_;
+  std::vector<uint8_t> staged_validity_;
+  // per group state
+  std::vector<ResCType> cache_;
+  std::vector<uint8_t> cache_validity_;
+};
+
+//////////////// CountBatchAccumulator ///////////////
+class CountBatchAccumulator {
+ public:
+  CountBatchAccumulator(arrow::compute::FunctionContext* ctx)
+      : builder_(MakeAccumulatorBuilder<arrow::UInt64Type>(ctx)) {}
+
+  void Stage() { staged_validity_.push_back(1); }
+
+  void StageNull() { staged_validity_.push_back(0); }
+
+  void UpdateBatch(const int* memo_index, int64_t length) {
+    auto num_groups = GetMaxGroupId(memo_index, length) + 1;
+    if (num_groups > static_cast<int>(cache_.size())) cache_.resize(num_groups, 0);
+    auto values_validity = staged_validity_.data();
+    auto count = cache_.data();
+    for (int64_t i = 0; i < length; i++) {
+      count[memo_index[i]] += values_validity[i];
+    }
+    staged_validity_.clear();
+  }
+
+  uint64_t GetResultLength() { return cache_.size(); }
+
+  arrow::Status Finish(uint64_t offset, uint64_t length, ArrayList* out) {
+    length = GetFinishLength(offset, length, GetResultLength());
+    std::shared_ptr<arrow::Array> arr_out;
+    builder_->Reset();
+    RETURN_NOT_OK(builder_->AppendValues(cache_.data() + offset, length));
+    RETURN_NOT_OK(builder_->Finish(&arr_out));
+    out->push_back(arr_out);
+    return arrow::Status::OK();
+  }
+
+ private:
+  std::unique_ptr<arrow::UInt64Builder> builder_;
+  std::vector<uint8_t> staged_validity_;
+  std::vector<uint64_t> cache_;
+};
+
+//////////////// ExtremumBatchAccumulator ///////////////
+template <typename DataType, typename Compare>
+class ExtremumBatchAccumulator {
+ public:
+  using CType = typename arrow::TypeTraits<DataType>::CType;
+  using BuilderType = typename arrow::TypeTraits<DataType>::BuilderType;
+
+  ExtremumBatchAccumulator(arrow::compute::FunctionContext* ctx)
+      : builder_(MakeAccumulatorBuilder<DataType>(ctx)) {}
+
+  void Stage(const CType& value) {
+    staged_.push_back(value);
+    staged_validity_.push_back(1);
+  }
+
+  void StageNull() {
+    staged_.push_back(0);
+    staged_validity_.push_back(0);
+  }
+
+  void UpdateBatch(const int* memo_index, int64_t length) {
+    auto num_groups = GetMaxGroupId(memo_index, length) + 1;
+    if (num_groups > static_cast<int>(cache_.size())) {
+      cache_.resize(num_groups, 0);
+      cache_validity_.resize(num_groups, 0);
+    }
+    Compare compare;
+    auto values = staged_.data();
+    auto values_validity = staged_validity_.data();
+    auto extremum = cache_.data();
+    auto validity = cache_validity_.data();
+    for (int64_t i = 0; i < length; i++) {
+      if (!values_validity[i]) continue;
+      auto group_id = memo_index[i];
+      if (!validity[group_id] || compare(values[i], extremum[group_id])) {
+        extremum[group_id] = values[i];
+      }
+      validity[group_id] = 1;
+    }
+    staged_.clear();
+    staged_validity_.clear();
+  }
+
+  uint64_t GetResultLength() { return cache_.size(); }
+
+  arrow::Status Finish(uint64_t offset, uint64_t length, ArrayList* out) {
+    length = GetFinishLength(offset, length, GetResultLength());
+    std::shared_ptr<arrow::Array> arr_out;
+    builder_->Reset();
+    RETURN_NOT_OK(builder_->AppendValues(cache_.data() + offset, length,
+                                         cache_validity_.data() + offset));
+    RETURN_NOT_OK(builder_->Finish(&arr_out));
+    out->push_back(arr_out);
+    return arrow::Status::OK();
+  }
+
+ private:
+  std::unique_ptr<BuilderType> builder_;
+  std::vector<CType> staged_;
+  std::vector<uint8_t> staged_validity_;
+  std::vector<CType> cache_;
+  std::vector<uint8_t> cache_validity_;
+};
+
+template <typename DataType>
+using MinBatchAccumulator =
+    ExtremumBatchAccumulator<DataType,
+                             std::less<typename arrow::TypeTraits<DataType>::CType>>;
+
+template <typename DataType>
+using MaxBatchAccumulator =
+    ExtremumBatchAccumulator<DataType,
+                             std::greater<typename arrow::TypeTraits<DataType>::CType>>;
+
+//////////////// AvgBatchAccumulator ///////////////
+template <typename DataType>
+class AvgBatchAccumulator {
+ public:
+  using CType = typename arrow::TypeTraits<DataType>::CType;
+
+  AvgBatchAccumulator(arrow::compute::FunctionContext* ctx)
+      : builder_(MakeAccumulatorBuilder<arrow::DoubleType>(ctx)) {}
+
+  void Stage(const CType& value) {
+    staged_.push_back(value);
+    staged_validity_.push_back(1);
+  }
+
+  void StageNull() {
+    staged_.push_back(0);
+    staged_validity_.push_back(0);
+  }
+
+  void UpdateBatch(const int* memo_index, int64_t length) {
+    auto num_groups = GetMaxGroupId(memo_index, length) + 1;
+    if (num_groups > static_cast<int>(cache_sum_.size())) {
+      cache_sum_.resize(num_groups, 0);
+      cache_count_.resize(num_groups, 0);
+      cache_validity_.resize(num_groups, 0);
+    }
+    auto values = staged_.data();
+    auto values_validity = staged_validity_.data();
+    auto sum = cache_sum_.data();
+    auto count = cache_count_.data();
+    auto validity = cache_validity_.data();
+    for (int64_t i = 0; i < length; i++) {
+      auto group_id = memo_index[i];
+      sum[group_id] += values[i];
+      count[group_id] += values_validity[i];
+      validity[group_id] |= values_validity[i];
+    }
+    staged_.clear();
+    staged_validity_.clear();
+  }
+
+  uint64_t GetResultLength() { return cache_sum_.size(); }
+
+  arrow::Status Finish(uint64_t offset, uint64_t length, ArrayList* out) {
+    length = GetFinishLength(offset, length, GetResultLength());
+    std::vector<double> avg(length);
+    for (uint64_t i = 0; i < length; i++) {
+      avg[i] = cache_sum_[offset + i] / cache_count_[offset + i];
+    }
+    std::shared_ptr<arrow::Array> arr_out;
+    builder_->Reset();
+    RETURN_NOT_OK(
+        builder_->AppendValues(avg.data(), length, cache_validity_.data() + offset));
+    RETURN_NOT_OK(builder_->Finish(&arr_out));
+    out->push_back(arr_out);
+    return arrow::Status::OK();
+  }
+
+ private:
+  std::unique_ptr<arrow::DoubleBuilder> builder_;
+  std::vector<CType> staged_;
+  std::vector<uint8_t> staged_validity_;
+  std::vector<double> cache_sum_;
+  std::vector<uint64_t> cache_count_;
+  std::vector<uint8_t> cache_validity_;
+};
+
+}  // namespace extra
+}  // namespace arrowcompute
+}  // namespace codegen
+}  // namespace sparkcolumnarplugin
@@ -66,6 +66,10 @@ class CodeGenBase {
     return arrow::Status::NotImplemented(
         "CodeGenBase MakeResultIterator is an abstract interface.");
   }
+
+  virtual arrow::Status Reset() {
+    return arrow::Status::NotImplemented("CodeGenBase Reset is an abstract interface.");
+  }
 };
 }  // namespace extra
 }  // namespace arrowcompute
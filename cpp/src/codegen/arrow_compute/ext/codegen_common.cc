@@ -28,6 +28,7 @@
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <thread>
 
 #include "utils/macros.h"
 
@@ -491,6 +492,116 @@ bool GetEnableTimeMetrics() {
   return is_enable;
 }
 
+bool GetEnableBatchAccumulate() {
+  bool is_enable = false;
+  const char* env_batch_accumulate = std::getenv("NATIVESQL_AGGR_BATCH_ACCUMULATE");
+  if (env_batch_accumulate != nullptr) {
+    auto is_enable_str = std::string(env_batch_accumulate);
+    if (is_enable_str.compare("true") == 0) is_enable = true;
+  }
+  return is_enable;
+}
+
+bool GetEnableAdaptiveAggregate() {
+  bool is_enable = false;
+  const char* env_adaptive_aggregate = std::getenv("NATIVESQL_AGGR_ADAPTIVE");
+  if (env_adaptive_aggregate != nullptr) {
+    auto is_enable_str = std::string(env_adaptive_aggregate);
+    if (is_enable_str.compare("true") == 0) is_enable = true;
+  }
+  return is_enable;
+}
+
+int64_t GetAdaptiveAggregateMinRows() {
+  int64_t min_rows;
+  const char* env_min_rows = std::getenv("NATIVESQL_AGGR_ADAPTIVE_MIN_ROWS");
+  if (env_min_rows != nullptr) {
+    min_rows = atoll(env_min_rows);
+  } else {
+    min_rows = 100000;
+  }
+  return min_rows;
+}
+
+double GetAdaptiveAggregateRatio() {
+  double ratio;
+  const char* env_ratio = std::getenv("NATIVESQL_AGGR_ADAPTIVE_RATIO");
+  if (env_ratio != nullptr) {
+    ratio = atof(env_ratio);
+  } else {
+    ratio = 0.9;
+  }
+  return ratio;
+}
+
+int64_t GetAggregateMemoryBudget() {
+  int64_t budget;
+  const char* env_budget = std::getenv("NATIVESQL_AGGR_MEMORY_BUDGET");
+  if (env_budget != nullptr) {
+    budget = atoll(env_budget);
+  } else {
+    budget = 0;
+  }
+  return budget;
+}
+
+int64_t GetDistinctAggregateMemoryBudget() {
+  int64_t budget;
+  const char* env_budget = std::getenv("NATIVESQL_AGGR_DISTINCT_MEMORY_BUDGET");
+  if (env_budget != nullptr) {
+    budget = atoll(env_budget);
+  } else {
+    budget = 268435456;
+  }
+  return budget;
+}
+
+bool GetEnableKahanSum() {
+  bool is_enable = false;
+  const char* env_kahan_sum = std::getenv("NATIVESQL_AGGR_KAHAN_SUM");
+  if (env_kahan_sum != nullptr) {
+    auto is_enable_str = std::string(env_kahan_sum);
+    if (is_enable_str.compare("true") == 0) is_enable = true;
+  }
+  return is_enable;
+}
+
+bool GetEnableSortNormalizedKey() {
+  bool is_enable = true;
+  const char* env_normalized_key = std::getenv("NATIVESQL_SORT_NORMALIZED_KEY");
+  if (env_normalized_key != nullptr) {
+    auto is_enable_str = std::string(env_normalized_key);
+    if (is_enable_str.compare("false") == 0) is_enable = false;
+  }
+  return is_enable;
+}
+
+int GetAggregateThreads() {
+  int num_threads;
+  const char* env_threads = std::getenv("NATIVESQL_AGGR_THREADS");
+  if (env_threads != nullptr) {
+    num_threads = atoi(env_threads);
+  } else {
+    num_threads = 1;
+  }
+  int max_threads = std::thread::hardware_concurrency();
+  if (max_threads > 0 && num_threads > max_threads) num_threads = max_threads;
+  return num_threads;
+}
+
+int GetSortThreads() {
+  int num_threads;
+  const char* env_threads = std::getenv("NATIVESQL_SORT_THREADS");
+  if (env_threads != nullptr) {
+    num_threads = atoi(env_threads);
+  } else {
+    num_threads = 1;
+  }
+  int max_threads = std::thread::hardware_concurrency();
+  if (max_threads > 0 && num_threads > max_threads) num_threads = max_threads;
+  return num_threads;
+}
+
 int GetBatchSize() {
   int batch_size;
   const char* env_batch_size = std::getenv("NATIVESQL_BATCH_SIZE");
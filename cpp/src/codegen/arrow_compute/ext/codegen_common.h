@@ -39,6 +39,16 @@ void FileSpinUnLock(int fd);
 
 int GetBatchSize();
 bool GetEnableTimeMetrics();
+bool GetEnableBatchAccumulate();
+bool GetEnableAdaptiveAggregate();
+int64_t GetAdaptiveAggregateMinRows();
+double GetAdaptiveAggregateRatio();
+int64_t GetAggregateMemoryBudget();
+int64_t GetDistinctAggregateMemoryBudget();
+bool GetEnableKahanSum();
+bool GetEnableSortNormalizedKey();
+int GetAggregateThreads();
+int GetSortThreads();
 std::string exec(const char* cmd);
 std::string GetTempPath();
 std::string GetArrowTypeDefString(std::shared_ptr<arrow::DataType> type);
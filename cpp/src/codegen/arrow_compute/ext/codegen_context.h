@@ -29,6 +29,8 @@ struct CodeGenContext {
   std::string unsafe_row_prepare_codes;
   std::string process_codes;
   std::string finish_codes;
+  // codes run once after all rows of an input batch are processed
+  std::string process_batch_end_codes;
   std::string definition_codes;
   std::string aggregate_prepare_codes;
   std::string aggregate_finish_condition_codes;
@@ -458,27 +458,27 @@ class ConditionedProbeKernel::Impl {
         switch (join_type_) {
           case 0: { /*Inner Join*/
             auto func = std::make_shared<UnsafeInnerProbeFunction>(hash_relation_,
-                                                                   appender_list_);
+                                                                   match_list_);
             probe_func_ = std::dynamic_pointer_cast<ProbeFunctionBase>(func);
           } break;
           case 1: { /*Outer Join*/
             auto func = std::make_shared<UnsafeOuterProbeFunction>(hash_relation_,
-                                                                   appender_list_);
+                                                                   match_list_);
             probe_func_ = std::dynamic_pointer_cast<ProbeFunctionBase>(func);
           } break;
           case 2: { /*Anti Join*/
             auto func =
-                std::make_shared<UnsafeAntiProbeFunction>(hash_relation_, appender_list_);
+                std::make_shared<UnsafeAntiProbeFunction>(hash_relation_, match_list_);
             probe_func_ = std::dynamic_pointer_cast<ProbeFunctionBase>(func);
           } break;
           case 3: { /*Semi Join*/
             auto func =
-                std::make_shared<UnsafeSemiProbeFunction>(hash_relation_, appender_list_);
+                std::make_shared<UnsafeSemiProbeFunction>(hash_relation_, match_list_);
             probe_func_ = std::dynamic_pointer_cast<ProbeFunctionBase>(func);
           } break;
           case 4: { /*Existence Join*/
             auto func = std::make_shared<UnsafeExistenceProbeFunction>(hash_relation_,
-                                                                       appender_list_);
+                                                                       match_list_);
             probe_func_ = std::dynamic_pointer_cast<ProbeFunctionBase>(func);
           } break;
           default:
@@ -494,27 +494,27 @@ class ConditionedProbeKernel::Impl {
     switch (join_type_) {                                                                \
       case 0: { /*Inner Join*/                                                           \
         auto func = std::make_shared<InnerProbeFunction<InType>>(hash_relation_,         \
-                                                                 appender_list_);        \
+                                                                 match_list_);           \
         probe_func_ = std::dynamic_pointer_cast<ProbeFunctionBase>(func);                \
       } break;                                                                           \
       case 1: { /*Outer Join*/                                                           \
         auto func = std::make_shared<OuterProbeFunction<InType>>(hash_relation_,         \
-                                                                 appender_list_);        \
+                                                                 match_list_);           \
         probe_func_ = std::dynamic_pointer_cast<ProbeFunctionBase>(func);                \
       } break;                                                                           \
       case 2: { /*Anti Join*/                                                            \
         auto func =                                                                      \
-            std::make_shared<AntiProbeFunction<InType>>(hash_relation_, appender_list_); \
+            std::make_shared<AntiProbeFunction<InType>>(hash_relation_, match_list_);    \
         probe_func_ = std::dynamic_pointer_cast<ProbeFunctionBase>(func);                \
       } break;                                                                           \
       case 3: { /*Semi Join*/                                                            \
         auto func =                                                                      \
-            std::make_shared<SemiProbeFunction<InType>>(hash_relation_, appender_list_); \
+            std::make_shared<SemiProbeFunction<InType>>(hash_relation_, match_list_);    \
         probe_func_ = std::dynamic_pointer_cast<ProbeFunctionBase>(func);                \
       } break;                                                                           \
       case 4: { /*Existence Join*/                                                       \
         auto func = std::make_shared<ExistenceProbeFunction<InType>>(hash_relation_,     \
-                                                                     appender_list_);    \
+                                                                     match_list_);       \
         probe_func_ = std::dynamic_pointer_cast<ProbeFunctionBase>(func);                \
       } break;                                                                           \
       default:                                                                           \
@@ -568,7 +568,14 @@ class ConditionedProbeKernel::Impl {
           key_array = in[right_key_index_list_[0]];
         }
       }
-      // put in to ArrayAppender then doing evaluate
+      // probe only records matched row pairs, result columns are gathered afterwards
+      match_list_->Reset();
+      if (hash_map_type_ == 0) {
+        probe_func_->Evaluate(key_array);
+      } else if (hash_map_type_ == 1) {
+        probe_func_->Evaluate(key_array, projected_keys_outputs);
+      }
+      arrow::ArrayVector out_arr_list;
       for (int tmp_idx = 0; tmp_idx < appender_list_.size(); tmp_idx++) {
         auto appender = appender_list_[tmp_idx];
         if (appender->GetType() == AppenderBase::right) {
@@ -577,15 +584,7 @@ class ConditionedProbeKernel::Impl {
           auto right_in_idx = result_schema_index_list_[idx_exclude_exist].second;
           RETURN_NOT_OK(appender->AddArray(in[right_in_idx]));
         }
-      }
-      uint64_t out_length = 0;
-      if (hash_map_type_ == 0) {
-        out_length = probe_func_->Evaluate(key_array);
-      } else if (hash_map_type_ == 1) {
-        out_length = probe_func_->Evaluate(key_array, projected_keys_outputs);
-      }
-      arrow::ArrayVector out_arr_list;
-      for (auto appender : appender_list_) {
+        RETURN_NOT_OK(appender->AppendMatches(*match_list_));
         std::shared_ptr<arrow::Array> out_arr;
         RETURN_NOT_OK(appender->Finish(&out_arr));
         out_arr_list.push_back(out_arr);
@@ -594,7 +593,7 @@ class ConditionedProbeKernel::Impl {
         }
         RETURN_NOT_OK(appender->Reset());
       }
-      *out = arrow::RecordBatch::Make(result_schema_, out_length, out_arr_list);
+      *out = arrow::RecordBatch::Make(result_schema_, match_list_->size(), out_arr_list);
       return arrow::Status::OK();
     }
 
@@ -625,8 +624,8 @@ class ConditionedProbeKernel::Impl {
     class UnsafeInnerProbeFunction : public ProbeFunctionBase {
      public:
       UnsafeInnerProbeFunction(std::shared_ptr<HashRelation> hash_relation,
-                               std::vector<std::shared_ptr<AppenderBase>> appender_list)
-          : hash_relation_(hash_relation), appender_list_(appender_list) {}
+                               std::shared_ptr<JoinMatchList> matches)
+          : hash_relation_(hash_relation), matches_(matches) {}
       uint64_t Evaluate(std::shared_ptr<arrow::Array> key_array,
                         const arrow::ArrayVector& key_payloads) override {
         struct timespec start, end;
@@ -709,13 +708,7 @@ class ConditionedProbeKernel::Impl {
             continue;
           }
           auto index_list = hash_relation_->GetItemListByIndex(index);
-          for (auto appender : appender_list_) {
-            if (appender->GetType() == AppenderBase::left) {
-              THROW_NOT_OK(appender->Append(index_list));
-            } else {
-              THROW_NOT_OK(appender->Append(0, i, index_list.size()));
-            }
-          }
+          matches_->Append(i, index_list);
           out_length += index_list.size();
         }
         return out_length;
@@ -724,7 +717,7 @@ class ConditionedProbeKernel::Impl {
      private:
       using ArrayType = arrow::Int32Array;
       std::shared_ptr<HashRelation> hash_relation_;
-      std::vector<std::shared_ptr<AppenderBase>> appender_list_;
+      std::shared_ptr<JoinMatchList> matches_;
     };
 #define PROCESS_SUPPORTED_TYPES(PROCESS) \
   PROCESS(arrow::BooleanType)            \
@@ -743,8 +736,8 @@ class ConditionedProbeKernel::Impl {
     class UnsafeOuterProbeFunction : public ProbeFunctionBase {
      public:
       UnsafeOuterProbeFunction(std::shared_ptr<HashRelation> hash_relation,
-                               std::vector<std::shared_ptr<AppenderBase>> appender_list)
-          : hash_relation_(hash_relation), appender_list_(appender_list) {}
+                               std::shared_ptr<JoinMatchList> matches)
+          : hash_relation_(hash_relation), matches_(matches) {}
       uint64_t Evaluate(std::shared_ptr<arrow::Array> key_array,
                         const arrow::ArrayVector& key_payloads) override {
         auto typed_key_array = std::dynamic_pointer_cast<ArrayType>(key_array);
@@ -823,24 +816,12 @@ class ConditionedProbeKernel::Impl {
             index = hash_relation_->Get(typed_key_array->GetView(i), unsafe_key_row);
           }
           if (index == -1) {
-            for (auto appender : appender_list_) {
-              if (appender->GetType() == AppenderBase::left) {
-                THROW_NOT_OK(appender->AppendNull());
-              } else {
-                THROW_NOT_OK(appender->Append(0, i));
-              }
-            }
+            matches_->AppendUnmatched(i);
             out_length += 1;
             continue;
           }
           auto index_list = hash_relation_->GetItemListByIndex(index);
-          for (auto appender : appender_list_) {
-            if (appender->GetType() == AppenderBase::left) {
-              THROW_NOT_OK(appender->Append(index_list));
-            } else {
-              THROW_NOT_OK(appender->Append(0, i, index_list.size()));
-            }
-          }
+          matches_->Append(i, index_list);
           out_length += index_list.size();
         }
         return out_length;
@@ -849,7 +830,7 @@ class ConditionedProbeKernel::Impl {
      private:
       using ArrayType = arrow::Int32Array;
       std::shared_ptr<HashRelation> hash_relation_;
-      std::vector<std::shared_ptr<AppenderBase>> appender_list_;
+      std::shared_ptr<JoinMatchList> matches_;
     };
 #define PROCESS_SUPPORTED_TYPES(PROCESS) \
   PROCESS(arrow::BooleanType)            \
@@ -868,8 +849,8 @@ class ConditionedProbeKernel::Impl {
     class UnsafeAntiProbeFunction : public ProbeFunctionBase {
      public:
       UnsafeAntiProbeFunction(std::shared_ptr<HashRelation> hash_relation,
-                              std::vector<std::shared_ptr<AppenderBase>> appender_list)
-          : hash_relation_(hash_relation), appender_list_(appender_list) {}
+                              std::shared_ptr<JoinMatchList> matches)
+          : hash_relation_(hash_relation), matches_(matches) {}
       uint64_t Evaluate(std::shared_ptr<arrow::Array> key_array,
                         const arrow::ArrayVector& key_payloads) override {
         auto typed_key_array = std::dynamic_pointer_cast<ArrayType>(key_array);
@@ -948,13 +929,7 @@ class ConditionedProbeKernel::Impl {
             index = hash_relation_->IfExists(typed_key_array->GetView(i), unsafe_key_row);
           }
           if (index == -1) {
-            for (auto appender : appender_list_) {
-              if (appender->GetType() == AppenderBase::left) {
-                THROW_NOT_OK(appender->AppendNull());
-              } else {
-                THROW_NOT_OK(appender->Append(0, i));
-              }
-            }
+            matches_->AppendUnmatched(i);
             out_length += 1;
           }
         }
@@ -964,14 +939,14 @@ class ConditionedProbeKernel::Impl {
      private:
       using ArrayType = arrow::Int32Array;
       std::shared_ptr<HashRelation> hash_relation_;
-      std::vector<std::shared_ptr<AppenderBase>> appender_list_;
+      std::shared_ptr<JoinMatchList> matches_;
     };
 
     class UnsafeSemiProbeFunction : public ProbeFunctionBase {
      public:
       UnsafeSemiProbeFunction(std::shared_ptr<HashRelation> hash_relation,
-                              std::vector<std::shared_ptr<AppenderBase>> appender_list)
-          : hash_relation_(hash_relation), appender_list_(appender_list) {}
+                              std::shared_ptr<JoinMatchList> matches)
+          : hash_relation_(hash_relation), matches_(matches) {}
 #define PROCESS_SUPPORTED_TYPES(PROCESS) \
   PROCESS(arrow::BooleanType)            \
   PROCESS(arrow::UInt8Type)              \
@@ -1069,13 +1044,7 @@ class ConditionedProbeKernel::Impl {
           if (index == -1) {
             continue;
           }
-          for (auto appender : appender_list_) {
-            if (appender->GetType() == AppenderBase::left) {
-              THROW_NOT_OK(appender->AppendNull());
-            } else {
-              THROW_NOT_OK(appender->Append(0, i));
-            }
-          }
+          matches_->AppendUnmatched(i);
           out_length += 1;
         }
         return out_length;
@@ -1083,7 +1052,7 @@ class ConditionedProbeKernel::Impl {
 
      private:
       std::shared_ptr<HashRelation> hash_relation_;
-      std::vector<std::shared_ptr<AppenderBase>> appender_list_;
+      std::shared_ptr<JoinMatchList> matches_;
     };
 #define PROCESS_SUPPORTED_TYPES(PROCESS) \
   PROCESS(arrow::BooleanType)            \
@@ -1103,8 +1072,8 @@ class ConditionedProbeKernel::Impl {
      public:
       UnsafeExistenceProbeFunction(
           std::shared_ptr<HashRelation> hash_relation,
-          std::vector<std::shared_ptr<AppenderBase>> appender_list)
-          : hash_relation_(hash_relation), appender_list_(appender_list) {}
+          std::shared_ptr<JoinMatchList> matches)
+          : hash_relation_(hash_relation), matches_(matches) {}
       uint64_t Evaluate(std::shared_ptr<arrow::Array> key_array,
                         const arrow::ArrayVector& key_payloads) override {
         auto typed_key_array = std::dynamic_pointer_cast<ArrayType>(key_array);
@@ -1186,15 +1155,7 @@ class ConditionedProbeKernel::Impl {
           if (index == -1) {
             exists = false;
           }
-          for (auto appender : appender_list_) {
-            if (appender->GetType() == AppenderBase::exist) {
-              THROW_NOT_OK(appender->AppendExistence(exists));
-            } else if (appender->GetType() == AppenderBase::right) {
-              THROW_NOT_OK(appender->Append(0, i));
-            } else {
-              THROW_NOT_OK(appender->AppendNull());
-            }
-          }
+          matches_->AppendExistence(i, exists);
           out_length += 1;
         }
         return out_length;
@@ -1203,15 +1164,15 @@ class ConditionedProbeKernel::Impl {
      private:
       using ArrayType = arrow::Int32Array;
       std::shared_ptr<HashRelation> hash_relation_;
-      std::vector<std::shared_ptr<AppenderBase>> appender_list_;
+      std::shared_ptr<JoinMatchList> matches_;
     };
 
     template <typename DataType>
     class InnerProbeFunction : public ProbeFunctionBase {
      public:
       InnerProbeFunction(std::shared_ptr<HashRelation> hash_relation,
-                         std::vector<std::shared_ptr<AppenderBase>> appender_list)
-          : appender_list_(appender_list) {
+                         std::shared_ptr<JoinMatchList> matches)
+          : matches_(matches) {
         typed_hash_relation_ =
             std::dynamic_pointer_cast<TypedHashRelation<DataType>>(hash_relation);
       }
@@ -1230,13 +1191,7 @@ class ConditionedProbeKernel::Impl {
             continue;
           }
           auto index_list = typed_hash_relation_->GetItemListByIndex(index);
-          for (auto appender : appender_list_) {
-            if (appender->GetType() == AppenderBase::left) {
-              THROW_NOT_OK(appender->Append(index_list));
-            } else {
-              THROW_NOT_OK(appender->Append(0, i, index_list.size()));
-            }
-          }
+          matches_->Append(i, index_list);
           out_length += index_list.size();
         }
         return out_length;
@@ -1245,15 +1200,15 @@ class ConditionedProbeKernel::Impl {
      private:
       using ArrayType = typename arrow::TypeTraits<DataType>::ArrayType;
       std::shared_ptr<TypedHashRelation<DataType>> typed_hash_relation_;
-      std::vector<std::shared_ptr<AppenderBase>> appender_list_;
+      std::shared_ptr<JoinMatchList> matches_;
     };
 
     template <typename DataType>
     class OuterProbeFunction : public ProbeFunctionBase {
      public:
       OuterProbeFunction(std::shared_ptr<HashRelation> hash_relation,
-                         std::vector<std::shared_ptr<AppenderBase>> appender_list)
-          : appender_list_(appender_list) {
+                         std::shared_ptr<JoinMatchList> matches)
+          : matches_(matches) {
         typed_hash_relation_ =
             std::dynamic_pointer_cast<TypedHashRelation<DataType>>(hash_relation);
       }
@@ -1268,24 +1223,12 @@ class ConditionedProbeKernel::Impl {
             index = typed_hash_relation_->Get(typed_key_array->GetView(i));
           }
           if (index == -1) {
-            for (auto appender : appender_list_) {
-              if (appender->GetType() == AppenderBase::left) {
-                THROW_NOT_OK(appender->AppendNull());
-              } else {
-                THROW_NOT_OK(appender->Append(0, i));
-              }
-            }
+            matches_->AppendUnmatched(i);
             out_length += 1;
             continue;
           }
           auto index_list = typed_hash_relation_->GetItemListByIndex(index);
-          for (auto appender : appender_list_) {
-            if (appender->GetType() == AppenderBase::left) {
-              THROW_NOT_OK(appender->Append(index_list));
-            } else {
-              THROW_NOT_OK(appender->Append(0, i, index_list.size()));
-            }
-          }
+          matches_->Append(i, index_list);
           out_length += index_list.size();
         }
         return out_length;
@@ -1294,15 +1237,15 @@ class ConditionedProbeKernel::Impl {
      private:
       using ArrayType = typename arrow::TypeTraits<DataType>::ArrayType;
       std::shared_ptr<TypedHashRelation<DataType>> typed_hash_relation_;
-      std::vector<std::shared_ptr<AppenderBase>> appender_list_;
+      std::shared_ptr<JoinMatchList> matches_;
     };
 
     template <typename DataType>
     class AntiProbeFunction : public ProbeFunctionBase {
      public:
       AntiProbeFunction(std::shared_ptr<HashRelation> hash_relation,
-                        std::vector<std::shared_ptr<AppenderBase>> appender_list)
-          : appender_list_(appender_list) {
+                        std::shared_ptr<JoinMatchList> matches)
+          : matches_(matches) {
         typed_hash_relation_ =
             std::dynamic_pointer_cast<TypedHashRelation<DataType>>(hash_relation);
       }
@@ -1317,13 +1260,7 @@ class ConditionedProbeKernel::Impl {
             index = typed_hash_relation_->Get(typed_key_array->GetView(i));
           }
           if (index == -1) {
-            for (auto appender : appender_list_) {
-              if (appender->GetType() == AppenderBase::left) {
-                THROW_NOT_OK(appender->AppendNull());
-              } else {
-                THROW_NOT_OK(appender->Append(0, i));
-              }
-            }
+            matches_->AppendUnmatched(i);
             out_length += 1;
           }
         }
@@ -1333,15 +1270,15 @@ class ConditionedProbeKernel::Impl {
      private:
       using ArrayType = typename arrow::TypeTraits<DataType>::ArrayType;
       std::shared_ptr<TypedHashRelation<DataType>> typed_hash_relation_;
-      std::vector<std::shared_ptr<AppenderBase>> appender_list_;
+      std::shared_ptr<JoinMatchList> matches_;
     };
 
     template <typename DataType>
     class SemiProbeFunction : public ProbeFunctionBase {
      public:
       SemiProbeFunction(std::shared_ptr<HashRelation> hash_relation,
-                        std::vector<std::shared_ptr<AppenderBase>> appender_list)
-          : appender_list_(appender_list) {
+                        std::shared_ptr<JoinMatchList> matches)
+          : matches_(matches) {
         typed_hash_relation_ =
             std::dynamic_pointer_cast<TypedHashRelation<DataType>>(hash_relation);
       }
@@ -1358,13 +1295,7 @@ class ConditionedProbeKernel::Impl {
           if (index == -1) {
             continue;
           }
-          for (auto appender : appender_list_) {
-            if (appender->GetType() == AppenderBase::left) {
-              THROW_NOT_OK(appender->AppendNull());
-            } else {
-              THROW_NOT_OK(appender->Append(0, i));
-            }
-          }
+          matches_->AppendUnmatched(i);
           out_length += 1;
         }
         return out_length;
@@ -1373,15 +1304,15 @@ class ConditionedProbeKernel::Impl {
      private:
       using ArrayType = typename arrow::TypeTraits<DataType>::ArrayType;
       std::shared_ptr<TypedHashRelation<DataType>> typed_hash_relation_;
-      std::vector<std::shared_ptr<AppenderBase>> appender_list_;
+      std::shared_ptr<JoinMatchList> matches_;
     };
 
     template <typename DataType>
     class ExistenceProbeFunction : public ProbeFunctionBase {
      public:
       ExistenceProbeFunction(std::shared_ptr<HashRelation> hash_relation,
-                             std::vector<std::shared_ptr<AppenderBase>> appender_list)
-          : appender_list_(appender_list) {
+                             std::shared_ptr<JoinMatchList> matches)
+          : matches_(matches) {
         typed_hash_relation_ =
             std::dynamic_pointer_cast<TypedHashRelation<DataType>>(hash_relation);
       }
@@ -1399,15 +1330,7 @@ class ConditionedProbeKernel::Impl {
           if (index == -1) {
             exists = false;
           }
-          for (auto appender : appender_list_) {
-            if (appender->GetType() == AppenderBase::exist) {
-              THROW_NOT_OK(appender->AppendExistence(exists));
-            } else if (appender->GetType() == AppenderBase::right) {
-              THROW_NOT_OK(appender->Append(0, i));
-            } else {
-              THROW_NOT_OK(appender->AppendNull());
-            }
-          }
+          matches_->AppendExistence(i, exists);
           out_length += 1;
         }
         return out_length;
@@ -1416,7 +1339,7 @@ class ConditionedProbeKernel::Impl {
      private:
       using ArrayType = typename arrow::TypeTraits<DataType>::ArrayType;
       std::shared_ptr<TypedHashRelation<DataType>> typed_hash_relation_;
-      std::vector<std::shared_ptr<AppenderBase>> appender_list_;
+      std::shared_ptr<JoinMatchList> matches_;
     };
 
     arrow::compute::FunctionContext* ctx_;
@@ -1434,6 +1357,7 @@ class ConditionedProbeKernel::Impl {
     std::vector<std::pair<int, int>> result_schema_index_list_;
     int exist_index_;
     std::vector<std::shared_ptr<AppenderBase>> appender_list_;
+    std::shared_ptr<JoinMatchList> match_list_ = std::make_shared<JoinMatchList>();
 
     gandiva::FieldVector left_field_list_;
     gandiva::FieldVector right_field_list_;
@@ -0,0 +1,328 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/status.h>
+#include <arrow/util/string_view.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "sparsehash/dense_hash_set"
+
+namespace sparkcolumnarplugin {
+namespace codegen {
+namespace arrowcompute {
+namespace extra {
+
+template <typename T>
+inline T ToDistinctValue(const T& value) {
+  return value;
+}
+
+inline std::string ToDistinctValue(arrow::util::string_view value) {
+  return std::string(value.data(), value.size());
+}
+
+/** DistinctSet
+ *
+ * Distinct (group_id, value) pairs of count_distinct and sum_distinct actions. All
+ * groups share one open addressing table, so a group with few values costs a few
+ * entries instead of a whole hash set.
+ * Once the table is over memory budget, its pairs are appended to kNumPartitions
+ * spill files by hash and the table is cleared. A pair always goes to the same
+ * partition, so Fold only needs to deduplicate one partition at a time. A partition
+ * still over budget while it is read back is split again by the next hash bits, up
+ * to kMaxSpillLevels deep.
+ **/
+template <typename CType>
+class DistinctSet {
+ public:
+  static constexpr int kPartitionBits = 4;
+  static constexpr int kNumPartitions = 1 << kPartitionBits;
+  static constexpr int kMaxSpillLevels = 4;
+
+  explicit DistinctSet(int64_t memory_budget) : memory_budget_(memory_budget) {
+    Entry empty_key;
+    empty_key.group_id = -1;
+    set_.set_empty_key(empty_key);
+  }
+
+  ~DistinctSet() {
+    for (auto file : spill_files_) {
+      if (file != nullptr) fclose(file);
+    }
+  }
+
+  arrow::Status Insert(int32_t group_id, const CType& value) {
+    Entry entry;
+    entry.group_id = group_id;
+    entry.value = Normalize(value);
+    if (set_.insert(entry).second) {
+      var_width_bytes_ += VarWidthBytes(entry.value);
+      if (memory_budget_ > 0 && MemoryUsage() > memory_budget_) {
+        RETURN_NOT_OK(Spill());
+      }
+    }
+    return arrow::Status::OK();
+  }
+
+  int64_t MemoryUsage() const {
+    return static_cast<int64_t>(set_.bucket_count() * sizeof(Entry)) + var_width_bytes_;
+  }
+
+  bool spilled() const { return !spill_files_.empty(); }
+
+  /* Calls func(group_id, value) once for every distinct pair and clears the set */
+  template <typename Func>
+  arrow::Status Fold(Func&& func) {
+    if (!spilled()) {
+      for (auto& entry : set_) func(entry.group_id, entry.value);
+      Clear();
+      return arrow::Status::OK();
+    }
+    RETURN_NOT_OK(Spill());
+    auto spill_files = std::move(spill_files_);
+    spill_files_.clear();
+    for (size_t i = 0; i < spill_files.size(); i++) {
+      auto status = FoldPartition(spill_files[i], 0, func);
+      if (!status.ok()) {
+        for (size_t j = i + 1; j < spill_files.size(); j++) fclose(spill_files[j]);
+        return status;
+      }
+    }
+    return arrow::Status::OK();
+  }
+
+ private:
+  struct Entry {
+    int32_t group_id = 0;
+    CType value = CType();
+  };
+
+  static inline uint64_t Mix(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+  }
+
+  template <typename T>
+  static uint64_t HashValue(const T& value) {
+    static_assert(sizeof(T) <= 8, "fixed width distinct value is at most 8 bytes");
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(T));
+    return bits;
+  }
+  static uint64_t HashValue(const std::string& value) {
+    return std::hash<std::string>()(value);
+  }
+
+  /* fixed width values are compared by bits, so every NaN is the same value */
+  template <typename T>
+  static bool ValueEquals(const T& a, const T& b) {
+    return std::memcmp(&a, &b, sizeof(T)) == 0;
+  }
+  static bool ValueEquals(const std::string& a, const std::string& b) { return a == b; }
+
+  template <typename T>
+  static T Normalize(const T& value) {
+    return value;
+  }
+  static float Normalize(float value) {
+    if (std::isnan(value)) return std::numeric_limits<float>::quiet_NaN();
+    return value == 0.0f ? 0.0f : value;
+  }
+  static double Normalize(double value) {
+    if (std::isnan(value)) return std::numeric_limits<double>::quiet_NaN();
+    return value == 0.0 ? 0.0 : value;
+  }
+
+  template <typename T>
+  static int64_t VarWidthBytes(const T& value) {
+    return 0;
+  }
+  static int64_t VarWidthBytes(const std::string& value) { return value.size(); }
+
+  struct EntryHash {
+    size_t operator()(const Entry& entry) const {
+      return Mix(HashValue(entry.value) + 0x9e3779b97f4a7c15ULL * (entry.group_id + 1));
+    }
+  };
+
+  struct EntryEqual {
+    bool operator()(const Entry& a, const Entry& b) const {
+      return a.group_id == b.group_id && ValueEquals(a.value, b.value);
+    }
+  };
+
+  template <typename T>
+  static bool WriteValue(FILE* file, const T& value) {
+    return fwrite(&value, sizeof(T), 1, file) == 1;
+  }
+  static bool WriteValue(FILE* file, const std::string& value) {
+    int32_t size = value.size();
+    return fwrite(&size, sizeof(size), 1, file) == 1 &&
+           (size == 0 || fwrite(value.data(), size, 1, file) == 1);
+  }
+
+  template <typename T>
+  static bool ReadValue(FILE* file, T* value) {
+    return fread(value, sizeof(T), 1, file) == 1;
+  }
+  static bool ReadValue(FILE* file, std::string* value) {
+    int32_t size;
+    if (fread(&size, sizeof(size), 1, file) != 1) return false;
+    value->resize(size);
+    return size == 0 || fread(&(*value)[0], size, 1, file) == 1;
+  }
+
+  static bool ReadEntry(FILE* file, Entry* entry) {
+    return fread(&entry->group_id, sizeof(int32_t), 1, file) == 1 &&
+           ReadValue(file, &entry->value);
+  }
+
+  static bool WriteEntry(FILE* file, const Entry& entry) {
+    return fwrite(&entry.group_id, sizeof(int32_t), 1, file) == 1 &&
+           WriteValue(file, entry.value);
+  }
+
+  /* high bits pick the partition of level 0, each deeper level takes the next bits,
+   * while low bits still spread a partition over hash table */
+  static int GetPartition(const Entry& entry, int level) {
+    return (EntryHash()(entry) >> (64 - kPartitionBits * (level + 1))) % kNumPartitions;
+  }
+
+  /* spill file is unlinked once opened, so it is gone when it is closed */
+  static FILE* OpenSpillFile() {
+    const char* env_tmp_dir = std::getenv("NATIVESQL_TMP_DIR");
+    if (env_tmp_dir == nullptr) return tmpfile();
+    std::string path = std::string(env_tmp_dir) + "/distinct_spill_XXXXXX";
+    std::vector<char> path_buf(path.begin(), path.end());
+    path_buf.push_back('\0');
+    int fd = mkstemp(path_buf.data());
+    if (fd < 0) return tmpfile();
+    unlink(path_buf.data());
+    return fdopen(fd, "w+b");
+  }
+
+  static arrow::Status OpenSpillFiles(std::vector<FILE*>* files) {
+    for (int i = 0; i < kNumPartitions; i++) {
+      auto file = OpenSpillFile();
+      if (file == nullptr) {
+        return arrow::Status::IOError("DistinctSet failed to open spill file.");
+      }
+      files->push_back(file);
+    }
+    return arrow::Status::OK();
+  }
+
+  static void CloseSpillFiles(std::vector<FILE*>* files) {
+    for (auto file : *files) fclose(file);
+    files->clear();
+  }
+
+  /* Appends the pairs of the table to files by their partition of level */
+  arrow::Status SpillTo(const std::vector<FILE*>& files, int level) {
+    for (auto& entry : set_) {
+      if (!WriteEntry(files[GetPartition(entry, level)], entry)) {
+        return arrow::Status::IOError("DistinctSet failed to write spill file.");
+      }
+    }
+    Clear();
+    return arrow::Status::OK();
+  }
+
+  arrow::Status Spill() {
+    if (spill_files_.empty()) {
+      RETURN_NOT_OK(OpenSpillFiles(&spill_files_));
+    }
+    return SpillTo(spill_files_, 0);
+  }
+
+  /* Deduplicates the pairs of a spill file of level and closes it. Once its pairs go
+   * over budget they are split into the partitions of level + 1, which are folded one
+   * by one, so memory stays bounded unless kMaxSpillLevels is reached. */
+  template <typename Func>
+  arrow::Status FoldPartition(FILE* file, int level, Func& func) {
+    rewind(file);
+    std::vector<FILE*> sub_files;
+    auto status = arrow::Status::OK();
+    Entry entry;
+    while (status.ok() && ReadEntry(file, &entry)) {
+      if (!sub_files.empty()) {
+        if (!WriteEntry(sub_files[GetPartition(entry, level + 1)], entry)) {
+          status = arrow::Status::IOError("DistinctSet failed to write spill file.");
+        }
+        continue;
+      }
+      if (!set_.insert(entry).second) continue;
+      var_width_bytes_ += VarWidthBytes(entry.value);
+      if (memory_budget_ > 0 && MemoryUsage() > memory_budget_ &&
+          level + 1 < kMaxSpillLevels) {
+        status = OpenSpillFiles(&sub_files);
+        if (status.ok()) status = SpillTo(sub_files, level + 1);
+      }
+    }
+    fclose(file);
+    if (!status.ok()) {
+      Clear();
+      CloseSpillFiles(&sub_files);
+      return status;
+    }
+    if (sub_files.empty()) {
+      for (auto& e : set_) func(e.group_id, e.value);
+      Clear();
+      return arrow::Status::OK();
+    }
+    for (size_t i = 0; i < sub_files.size(); i++) {
+      status = FoldPartition(sub_files[i], level + 1, func);
+      if (!status.ok()) {
+        for (size_t j = i + 1; j < sub_files.size(); j++) fclose(sub_files[j]);
+        return status;
+      }
+    }
+    return arrow::Status::OK();
+  }
+
+  void Clear() {
+    set_.clear();
+    var_width_bytes_ = 0;
+  }
+
+  int64_t memory_budget_;
+  int64_t var_width_bytes_ = 0;
+  google::dense_hash_set<Entry, EntryHash, EntryEqual> set_;
+  std::vector<FILE*> spill_files_;
+};
+
+}  // namespace extra
+}  // namespace arrowcompute
+}  // namespace codegen
+}  // namespace sparkcolumnarplugin
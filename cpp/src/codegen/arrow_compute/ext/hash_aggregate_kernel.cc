@@ -51,8 +51,12 @@ class HashAggregateKernel::Impl {
        std::vector<std::shared_ptr<gandiva::Node>> input_field_list,
        std::vector<std::shared_ptr<gandiva::Node>> action_list,
        std::vector<std::shared_ptr<gandiva::Node>> result_field_node_list,
-       std::vector<std::shared_ptr<gandiva::Node>> result_expr_node_list)
-      : ctx_(ctx), action_list_(action_list) {
+       std::vector<std::shared_ptr<gandiva::Node>> result_expr_node_list,
+       bool is_partial, bool is_sorted)
+      : ctx_(ctx),
+        action_list_(action_list),
+        is_partial_(is_partial),
+        is_sorted_(is_sorted) {
     // if there is projection inside aggregate, we need to extract them into
     // projector_list
     for (auto node : input_field_list) {
@@ -97,6 +101,11 @@ class HashAggregateKernel::Impl {
         R"(#include "codegen/arrow_compute/ext/array_item_index.h")");
     codegen_ctx->header_codes.push_back(
         R"(#include "codegen/arrow_compute/ext/actions_impl.h")");
+    auto batch_accumulate = GetEnableBatchAccumulate();
+    if (batch_accumulate) {
+      codegen_ctx->header_codes.push_back(
+          R"(#include "codegen/arrow_compute/ext/batch_accumulators.h")");
+    }
 
     std::vector<std::string> prepare_list;
     // 1.0 prepare aggregate input expressions
@@ -106,6 +115,7 @@ class HashAggregateKernel::Impl {
     std::stringstream finish_ss;
     std::stringstream finish_condition_ss;
     std::stringstream process_ss;
+    std::stringstream process_batch_end_ss;
     std::stringstream action_list_define_function_ss;
     std::vector<std::pair<std::string, gandiva::DataTypePtr>> action_name_list;
     std::vector<std::vector<int>> action_prepare_index_list;
@@ -163,24 +173,46 @@ class HashAggregateKernel::Impl {
       }
     }
 
-    if (key_node_list.size() > 1 ||
-        (key_node_list.size() > 0 &&
-         key_node_list[0]->return_type()->id() == arrow::Type::STRING)) {
+    // multi-column keys are packed into integers if all of them are fixed width
+    std::vector<std::pair<int, int>> packed_key_layout;
+    int packed_key_words = 0;
+    if (key_node_list.size() > 1) {
+      packed_key_words = GetPackedKeyLayout(key_node_list, &packed_key_layout);
+    }
+    std::string packed_key_type = packed_key_words == 1 ? "uint64_t" : "PackedKey128";
+    // hash table type, and estimated bytes of one entry for the table which does not
+    // allocate from the memory pool, the others are seen by the pool already
+    std::string hash_table_type;
+    int hash_entry_bytes = 0;
+    if (packed_key_words > 0) {
+      codegen_ctx->header_codes.push_back(
+          R"(#include "precompile/packed_key_hash_map.h")");
+      hash_table_type = "PackedKeyHashMap<" + packed_key_type + ">";
+    } else if (key_node_list.size() > 1) {
+      codegen_ctx->header_codes.push_back(
+          R"(#include "precompile/packed_key_hash_map.h")");
+      hash_table_type = "NormalizedKeyHashMap";
+    } else if (key_node_list.size() > 0 &&
+               key_node_list[0]->return_type()->id() == arrow::Type::STRING) {
       codegen_ctx->header_codes.push_back(R"(#include "precompile/hash_map.h")");
-      aggr_prepare_ss << "aggr_hash_table_" << level << " = std::make_shared<"
-                      << GetTypeString(arrow::utf8(), "")
-                      << "HashMap>(ctx_->memory_pool());" << std::endl;
-      define_ss << "std::shared_ptr<" << GetTypeString(arrow::utf8(), "")
-                << "HashMap> aggr_hash_table_" << level << ";" << std::endl;
-
+      hash_table_type = GetTypeString(arrow::utf8(), "") + "HashMap";
     } else if (key_node_list.size() > 0) {
       auto type = key_node_list[0]->return_type();
       codegen_ctx->header_codes.push_back(R"(#include "precompile/sparse_hash_map.h")");
-      aggr_prepare_ss << "aggr_hash_table_" << level << " = std::make_shared<"
-                      << "SparseHashMap<" << GetCTypeString(type)
-                      << ">>(ctx_->memory_pool());" << std::endl;
-      define_ss << "std::shared_ptr<SparseHashMap<" << GetCTypeString(type)
-                << ">> aggr_hash_table_" << level << ";" << std::endl;
+      hash_table_type = "SparseHashMap<" + GetCTypeString(type) + ">";
+      hash_entry_bytes = 16;
+    }
+    // input sorted on keys only needs to compare each key with the previous one, no
+    // hash table is built, while action state and output are as in hash aggregate
+    auto sorted = is_sorted_ && key_node_list.size() > 0;
+    auto hash_table_name = "aggr_hash_table_" + std::to_string(level);
+    std::stringstream make_hash_table_ss;
+    make_hash_table_ss << hash_table_name << " = std::make_shared<" << hash_table_type
+                       << ">(ctx_->memory_pool());" << std::endl;
+    if (!hash_table_type.empty() && !sorted) {
+      aggr_prepare_ss << make_hash_table_ss.str();
+      define_ss << "std::shared_ptr<" << hash_table_type << "> " << hash_table_name << ";"
+                << std::endl;
     }
     // 2. create key_hash_project_node and prepare_gandiva_project_node_list
 
@@ -219,6 +251,33 @@ class HashAggregateKernel::Impl {
                    << project_output_list[i].first.first << ";" << std::endl;
         prepare_ss << "auto " << unsafe_row_name_validity << " = "
                    << project_output_list[i].first.first << "_validity;" << std::endl;
+      } else if (packed_key_words > 0) {
+        prepare_ss << packed_key_type << " " << unsafe_row_name
+                   << (packed_key_words == 1 ? " = 0;" : ";") << std::endl;
+        prepare_ss << "auto " << unsafe_row_name_validity << " = "
+                   << "true;" << std::endl;
+        auto num_keys = key_index_list.size();
+        std::string null_word = unsafe_row_name;
+        if (packed_key_words == 2) null_word += ".hi";
+        int idx = 0;
+        for (auto i : key_index_list) {
+          prepare_ss << project_output_list[i].first.second << std::endl;
+          project_output_list[i].first.second = "";
+          auto key_name = project_output_list[i].first.first;
+          auto validity_name = key_name + "_validity";
+          auto word = unsafe_row_name;
+          if (packed_key_words == 2) {
+            word += packed_key_layout[idx].first == 0 ? ".lo" : ".hi";
+          }
+          prepare_ss << "if (" << validity_name << ") {" << std::endl;
+          prepare_ss << word << " |= ToPackedBits(" << key_name << ") << "
+                     << packed_key_layout[idx].second << ";" << std::endl;
+          prepare_ss << "} else {" << std::endl;
+          prepare_ss << null_word << " |= (uint64_t)1 << " << (64 - num_keys + idx) << ";"
+                     << std::endl;
+          prepare_ss << "}" << std::endl;
+          idx++;
+        }
       } else {
         codegen_ctx->header_codes.push_back(
             R"(#include "third_party/row_wise_memory/unsafe_row.h")");
@@ -245,16 +304,29 @@ class HashAggregateKernel::Impl {
           prepare_ss << "}" << std::endl;
           idx++;
         }
-        prepare_ss << "auto " << unsafe_row_name << " = std::string(" << unsafe_row_name
-                   << "_unsafe_row->data, " << unsafe_row_name << "_unsafe_row->cursor);"
-                   << std::endl;
+        // the hash table copies the key into its arena only when inserting a new group
+        prepare_ss << "auto " << unsafe_row_name << " = arrow::util::string_view("
+                   << unsafe_row_name << "_unsafe_row->data, " << unsafe_row_name
+                   << "_unsafe_row->cursor);" << std::endl;
       }
     }
 
     // 5. create codes for hash aggregate GetOrInsert
     std::vector<std::string> action_name_str_list;
     std::vector<std::string> action_type_str_list;
+    // accumulator type of each action, empty if the action goes through ActionBase
+    std::vector<std::string> accumulator_list;
+    bool has_accumulator = false;
     for (auto action_pair : action_name_list) {
+      std::string accumulator;
+      if (batch_accumulate) {
+        accumulator = GetBatchAccumulatorString(action_pair.first, action_pair.second);
+      }
+      accumulator_list.push_back(accumulator);
+      if (!accumulator.empty()) {
+        has_accumulator = true;
+        continue;
+      }
       action_name_str_list.push_back("\"" + action_pair.first + "\"");
       action_type_str_list.push_back("arrow::" +
                                      GetArrowTypeDefString(action_pair.second));
@@ -265,20 +337,61 @@ class HashAggregateKernel::Impl {
     define_ss << "bool do_hash_aggr_finish_" << level << " = false;" << std::endl;
     define_ss << "uint64_t do_hash_aggr_finish_" << level << "_offset = 0;" << std::endl;
     define_ss << "int do_hash_aggr_finish_" << level << "_num_groups = -1;" << std::endl;
-    aggr_prepare_ss << "std::vector<std::string> action_name_list_" << level << " = {"
-                    << GetParameterList(action_name_str_list, false) << "};" << std::endl;
-    aggr_prepare_ss << "auto action_type_list_" << level << " = {"
-                    << GetParameterList(action_type_str_list, false) << "};" << std::endl;
-    aggr_prepare_ss << "PrepareActionList(action_name_list_" << level
-                    << ", action_type_list_" << level << ", &aggr_action_list_" << level
-                    << ");" << std::endl;
+    define_ss << "uint64_t do_hash_aggr_finish_" << level << "_flushed_rows = 0;"
+              << std::endl;
+    // action list is kept to build the actions again after their groups are flushed
+    std::stringstream make_action_list_ss;
+    if (!action_name_str_list.empty()) {
+      define_ss << "std::vector<std::string> action_name_list_" << level << " = {"
+                << GetParameterList(action_name_str_list, false) << "};" << std::endl;
+      define_ss << "std::vector<std::shared_ptr<arrow::DataType>> action_type_list_"
+                << level << " = {" << GetParameterList(action_type_str_list, false)
+                << "};" << std::endl;
+      aggr_prepare_ss << "PrepareActionList(action_name_list_" << level
+                      << ", action_type_list_" << level << ", &aggr_action_list_"
+                      << level << ");" << std::endl;
+      make_action_list_ss << "aggr_action_list_" << level << ".clear();" << std::endl;
+      make_action_list_ss << "RETURN_NOT_OK(PrepareActionList(action_name_list_"
+                          << level << ", action_type_list_" << level
+                          << ", &aggr_action_list_" << level << "));" << std::endl;
+    }
+    auto memo_batch_name = "aggr_memo_batch_" + std::to_string(level);
+    if (has_accumulator) {
+      define_ss << "std::vector<int> " << memo_batch_name << ";" << std::endl;
+    }
     std::stringstream action_codes_ss;
     int action_idx = 0;
+    int base_action_idx = 0;
     for (auto idx_v : action_prepare_index_list) {
       for (auto i : idx_v) {
         action_codes_ss << project_output_list[i].first.second << std::endl;
         project_output_list[i].first.second = "";
       }
+      auto accumulator = accumulator_list[action_idx];
+      if (!accumulator.empty()) {
+        // typed accumulator only stages its input, batch is folded at batch end
+        auto accumulator_name = "aggr_accumulator_" + std::to_string(level) + "_" +
+                                std::to_string(action_idx);
+        define_ss << "std::shared_ptr<" << accumulator << "> " << accumulator_name << ";"
+                  << std::endl;
+        make_action_list_ss << accumulator_name << " = std::make_shared<" << accumulator
+                            << ">(ctx_);" << std::endl;
+        aggr_prepare_ss << accumulator_name << " = std::make_shared<" << accumulator
+                        << ">(ctx_);" << std::endl;
+        auto input_name = project_output_list[idx_v[0]].first.first;
+        auto stage_param = accumulator == "CountBatchAccumulator" ? "" : input_name;
+        action_codes_ss << "if (" << input_name << "_validity) {" << std::endl;
+        action_codes_ss << accumulator_name << "->Stage(" << stage_param << ");"
+                        << std::endl;
+        action_codes_ss << "} else {" << std::endl;
+        action_codes_ss << accumulator_name << "->StageNull();" << std::endl;
+        action_codes_ss << "}" << std::endl;
+        process_batch_end_ss << accumulator_name << "->UpdateBatch(" << memo_batch_name
+                             << ".data(), " << memo_batch_name << ".size());"
+                             << std::endl;
+        action_idx++;
+        continue;
+      }
       if (idx_v.size() > 0)
         action_codes_ss << "if (" << project_output_list[idx_v[0]].first.first
                         << "_validity) {" << std::endl;
@@ -286,20 +399,87 @@ class HashAggregateKernel::Impl {
       for (auto i : idx_v) {
         parameter_list.push_back("(void*)&" + project_output_list[i].first.first);
       }
-      action_codes_ss << "RETURN_NOT_OK(aggr_action_list_" << level << "[" << action_idx
-                      << "]->Evaluate(memo_index" << GetParameterList(parameter_list)
-                      << "));" << std::endl;
+      if (parameter_list.size() > 3) {
+        // inputs are passed by a member list, so no allocation happens per row
+        auto args_name = "aggr_action_args_" + std::to_string(level) + "_" +
+                         std::to_string(action_idx);
+        define_ss << "std::vector<void*> " << args_name << " = std::vector<void*>("
+                  << parameter_list.size() << ");" << std::endl;
+        for (int j = 0; j < parameter_list.size(); j++) {
+          action_codes_ss << args_name << "[" << j << "] = " << parameter_list[j] << ";"
+                          << std::endl;
+        }
+        action_codes_ss << "RETURN_NOT_OK(aggr_action_list_" << level << "["
+                        << base_action_idx << "]->Evaluate(memo_index, " << args_name
+                        << "));" << std::endl;
+      } else {
+        action_codes_ss << "RETURN_NOT_OK(aggr_action_list_" << level << "["
+                        << base_action_idx << "]->Evaluate(memo_index"
+                        << GetParameterList(parameter_list) << "));" << std::endl;
+      }
       if (idx_v.size() > 0) {
         action_codes_ss << "} else {" << std::endl;
-        action_codes_ss << "RETURN_NOT_OK(aggr_action_list_" << level << "[" << action_idx
-                        << "]->EvaluateNull(memo_index));" << std::endl;
+        action_codes_ss << "RETURN_NOT_OK(aggr_action_list_" << level << "["
+                        << base_action_idx << "]->EvaluateNull(memo_index));"
+                        << std::endl;
         action_codes_ss << "}" << std::endl;
       }
+      base_action_idx++;
       action_idx++;
     }
+    if (has_accumulator) {
+      action_codes_ss << memo_batch_name << ".push_back(memo_index);" << std::endl;
+      process_batch_end_ss << memo_batch_name << ".clear();" << std::endl;
+    }
     process_ss << "int memo_index = 0;" << std::endl;
 
-    if (key_index_list.size() > 0) {
+    // partial aggregation may stop pre-aggregating or flush its groups to start over,
+    // since one key showing up in several partial rows is merged by final aggregation
+    auto adaptive = is_partial_ && key_index_list.size() > 0 && !sorted &&
+                    GetEnableAdaptiveAggregate();
+    auto num_groups_name = "do_hash_aggr_finish_" + std::to_string(level) + "_num_groups";
+    auto flushed_out_name = "aggr_flushed_out_" + std::to_string(level);
+    if (adaptive) {
+      codegen_ctx->header_codes.push_back("#include <deque>");
+      define_ss << "bool aggr_bypass_" << level << " = false;" << std::endl;
+      define_ss << "bool aggr_adaptive_checked_" << level << " = false;" << std::endl;
+      define_ss << "int64_t aggr_input_rows_" << level << " = 0;" << std::endl;
+      define_ss << "int aggr_table_groups_" << level << " = 0;" << std::endl;
+      define_ss << "int64_t aggr_table_bytes_" << level << " = 0;" << std::endl;
+      define_ss << "int64_t aggr_pool_base_bytes_" << level << " = 0;" << std::endl;
+      define_ss << "std::deque<std::vector<std::shared_ptr<arrow::Array>>> "
+                << flushed_out_name << ";" << std::endl;
+      // in bypass mode every row becomes its own group without touching hash table
+      process_ss << "if (aggr_bypass_" << level << ") {" << std::endl;
+      process_ss << "memo_index = " << num_groups_name << " + 1;" << std::endl;
+      process_ss << "} else {" << std::endl;
+      process_ss << "aggr_input_rows_" << level << "++;" << std::endl;
+    }
+
+    if (sorted) {
+      std::string key_type;
+      if (key_node_list.size() == 1) {
+        key_type = GetCTypeString(key_node_list[0]->return_type());
+      } else if (packed_key_words > 0) {
+        key_type = packed_key_type;
+      } else {
+        key_type = "std::string";
+      }
+      auto is_unsafe_row_key = key_node_list.size() > 1 && packed_key_words == 0;
+      auto is_float_key =
+          key_node_list.size() == 1 &&
+          (key_node_list[0]->return_type()->id() == arrow::Type::FLOAT ||
+           key_node_list[0]->return_type()->id() == arrow::Type::DOUBLE);
+      RETURN_NOT_OK(GetSortedGroupCodes(level, key_type, is_unsafe_row_key, is_float_key,
+                                        &define_ss, &process_ss));
+      if (is_float_key) codegen_ctx->header_codes.push_back("#include <cmath>");
+      process_ss << action_codes_ss.str() << std::endl;
+      process_ss << "if (memo_index > do_hash_aggr_finish_" << level << "_num_groups) {"
+                 << std::endl;
+      process_ss << "do_hash_aggr_finish_" << level << "_num_groups = memo_index;"
+                 << std::endl;
+      process_ss << "}" << std::endl;
+    } else if (key_index_list.size() > 0) {
       process_ss << "if (!aggr_key_" << level << "_validity) {" << std::endl;
       process_ss << "  memo_index = aggr_hash_table_" << level
                  << "->GetOrInsertNull([](int){}, [](int){});" << std::endl;
@@ -307,6 +487,88 @@ class HashAggregateKernel::Impl {
       process_ss << "   aggr_hash_table_" << level << "->GetOrInsert(aggr_key_" << level
                  << ",[](int){}, [](int){}, &memo_index);" << std::endl;
       process_ss << " }" << std::endl;
+      if (adaptive) {
+        // hash table hands out dense indices, so a new group gets the next one
+        process_ss << "if (memo_index == aggr_table_groups_" << level << ") {"
+                   << std::endl;
+        process_ss << "aggr_table_groups_" << level << "++;" << std::endl;
+        if (hash_entry_bytes > 0) {
+          process_ss << "aggr_table_bytes_" << level << " += " << hash_entry_bytes << ";"
+                     << std::endl;
+        }
+        process_ss << "}" << std::endl;
+        process_ss << "}" << std::endl;
+
+        auto min_rows = GetAdaptiveAggregateMinRows();
+        auto ratio = GetAdaptiveAggregateRatio();
+        auto memory_budget = GetAggregateMemoryBudget();
+        process_batch_end_ss << "if (!aggr_bypass_" << level
+                             << " && !aggr_adaptive_checked_" << level
+                             << " && aggr_input_rows_" << level << " >= " << min_rows
+                             << ") {" << std::endl;
+        process_batch_end_ss << "aggr_adaptive_checked_" << level << " = true;"
+                             << std::endl;
+        // rows out are the groups flushed so far plus the ones not flushed yet
+        process_batch_end_ss << "if (do_hash_aggr_finish_" << level << "_flushed_rows + "
+                             << num_groups_name << " + 1 > " << ratio
+                             << " * aggr_input_rows_" << level << ") {" << std::endl;
+        process_batch_end_ss << "aggr_bypass_" << level << " = true;" << std::endl;
+        process_batch_end_ss << hash_table_name << ".reset();" << std::endl;
+        process_batch_end_ss << "}" << std::endl;
+        process_batch_end_ss << "}" << std::endl;
+        // in bypass mode rows of a batch are flushed as they are, otherwise groups are
+        // flushed when the memory pool holds more for the table and the action state
+        // than budget, plus the estimate of a table not allocated from the pool
+        process_batch_end_ss << "if (aggr_bypass_" << level;
+        if (memory_budget > 0) {
+          process_batch_end_ss << " || aggr_table_bytes_" << level
+                               << " + ctx_->memory_pool()->bytes_allocated() - "
+                               << "aggr_pool_base_bytes_" << level << " > "
+                               << memory_budget;
+        }
+        process_batch_end_ss << ") {" << std::endl;
+        process_batch_end_ss << "RETURN_NOT_OK(FlushAggregate_" << level << "());"
+                             << std::endl;
+        process_batch_end_ss << "}" << std::endl;
+
+        // groups are finished into output as in Next(), then the actions are built
+        // again, which frees their state, and memory is measured from there on
+        std::stringstream flush_ss;
+        flush_ss << "arrow::Status FlushAggregate_" << level << "() {" << std::endl;
+        flush_ss << "int64_t num_groups = " << num_groups_name << " + 1;" << std::endl;
+        flush_ss << "for (int64_t offset = 0; offset < num_groups; offset += 10000) {"
+                 << std::endl;
+        flush_ss << "std::vector<std::shared_ptr<arrow::Array>> out;" << std::endl;
+        int flush_action_idx = 0;
+        for (int i = 0; i < action_idx; i++) {
+          if (!accumulator_list[i].empty()) {
+            flush_ss << "RETURN_NOT_OK(aggr_accumulator_" << level << "_" << i;
+          } else {
+            flush_ss << "RETURN_NOT_OK(aggr_action_list_" << level << "["
+                     << flush_action_idx++ << "]";
+          }
+          flush_ss << "->Finish(offset, 10000, &out));" << std::endl;
+        }
+        flush_ss << flushed_out_name << ".push_back(out);" << std::endl;
+        flush_ss << "}" << std::endl;
+        flush_ss << "do_hash_aggr_finish_" << level << "_flushed_rows += num_groups;"
+                 << std::endl;
+        flush_ss << num_groups_name << " = -1;" << std::endl;
+        flush_ss << make_action_list_ss.str();
+        flush_ss << "if (!aggr_bypass_" << level << ") {" << std::endl;
+        flush_ss << make_hash_table_ss.str();
+        flush_ss << "}" << std::endl;
+        flush_ss << "aggr_table_groups_" << level << " = 0;" << std::endl;
+        flush_ss << "aggr_table_bytes_" << level << " = 0;" << std::endl;
+        flush_ss << "aggr_pool_base_bytes_" << level
+                 << " = ctx_->memory_pool()->bytes_allocated();" << std::endl;
+        flush_ss << "return arrow::Status::OK();" << std::endl;
+        flush_ss << "}" << std::endl;
+        codegen_ctx->function_list.push_back(flush_ss.str());
+        codegen_ctx->function_list.push_back(
+            "bool HasFlushedOutput() override { return !" + flushed_out_name +
+            ".empty(); }");
+      }
       process_ss << action_codes_ss.str() << std::endl;
       process_ss << "if (memo_index > do_hash_aggr_finish_" << level << "_num_groups) {"
                  << std::endl;
@@ -353,6 +615,19 @@ class HashAggregateKernel::Impl {
         RETURN_NOT_OK(MakeStddevSampPartialAction(ctx_, type_list[type_id], &action));
       } else if (action_name_list[action_id].compare("action_stddev_samp_final") == 0) {
         RETURN_NOT_OK(MakeStddevSampFinalAction(ctx_, type_list[type_id], &action));
+      } else if (action_name_list[action_id].compare("action_count_distinct") == 0) {
+        RETURN_NOT_OK(MakeCountDistinctAction(ctx_, type_list[type_id], &action));
+      } else if (action_name_list[action_id].compare("action_sum_distinct") == 0) {
+        RETURN_NOT_OK(MakeSumDistinctAction(ctx_, type_list[type_id], &action));
+      } else if (action_name_list[action_id].compare(
+                     0, 37, "action_approx_count_distinct_partial_") == 0) {
+        double relative_sd = std::stod(action_name_list[action_id].substr(37));
+        RETURN_NOT_OK(MakeApproxCountDistinctPartialAction(ctx_, type_list[type_id],
+                                                           relative_sd, &action));
+      } else if (action_name_list[action_id].compare(
+                     0, 35, "action_approx_count_distinct_final_") == 0) {
+        double relative_sd = std::stod(action_name_list[action_id].substr(35));
+        RETURN_NOT_OK(MakeApproxCountDistinctFinalAction(ctx_, relative_sd, &action));
       } else {
         return arrow::Status::NotImplemented(action_name_list[action_id],
                                              " is not implementetd.");
@@ -369,10 +644,25 @@ class HashAggregateKernel::Impl {
     finish_ss << "should_stop_ = false;" << std::endl;
     finish_ss << "std::vector<std::shared_ptr<arrow::Array>> do_hash_aggr_finish_"
               << level << "_out;" << std::endl;
+    if (adaptive) {
+      // flushed groups go first, they may be fetched before input is all processed
+      finish_ss << "if (!" << flushed_out_name << ".empty()) {" << std::endl;
+      finish_ss << "do_hash_aggr_finish_" << level << "_out = std::move("
+                << flushed_out_name << ".front());" << std::endl;
+      finish_ss << flushed_out_name << ".pop_front();" << std::endl;
+      finish_ss << "out_length = do_hash_aggr_finish_" << level << "_out[0]->length();"
+                << std::endl;
+      finish_ss << "} else {" << std::endl;
+    }
     finish_ss << "if(do_hash_aggr_finish_" << level << ") {";
+    base_action_idx = 0;
     for (int i = 0; i < action_idx; i++) {
-      finish_ss << "aggr_action_list_" << level << "[" << i
-                << "]->Finish(do_hash_aggr_finish_" << level
+      if (!accumulator_list[i].empty()) {
+        finish_ss << "aggr_accumulator_" << level << "_" << i;
+      } else {
+        finish_ss << "aggr_action_list_" << level << "[" << base_action_idx++ << "]";
+      }
+      finish_ss << "->Finish(do_hash_aggr_finish_" << level
                 << "_offset, 10000, &do_hash_aggr_finish_" << level << "_out);"
                 << std::endl;
     }
@@ -389,6 +679,7 @@ class HashAggregateKernel::Impl {
     finish_ss << "should_stop_ = true;" << std::endl;
     finish_ss << "}" << std::endl;
     finish_ss << "}" << std::endl;
+    if (adaptive) finish_ss << "}" << std::endl;
 
     // 7. Do GandivaProjector if result_expr_list is not empty
     if (!result_expr_list_.empty()) {
@@ -405,7 +696,13 @@ class HashAggregateKernel::Impl {
     codegen_ctx->function_list.push_back(action_list_define_function_ss.str());
     codegen_ctx->prepare_codes += prepare_ss.str();
     codegen_ctx->process_codes += process_ss.str();
+    codegen_ctx->process_batch_end_codes += process_batch_end_ss.str();
     codegen_ctx->definition_codes += define_ss.str();
+    if (adaptive) {
+      // pool usage before the first row, as the pool may be shared with other kernels
+      aggr_prepare_ss << "aggr_pool_base_bytes_" << level
+                      << " = ctx_->memory_pool()->bytes_allocated();" << std::endl;
+    }
     codegen_ctx->aggregate_prepare_codes += aggr_prepare_ss.str();
     codegen_ctx->aggregate_finish_codes += finish_ss.str();
     codegen_ctx->aggregate_finish_condition_codes += finish_condition_ss.str();
@@ -417,6 +714,150 @@ class HashAggregateKernel::Impl {
   }
 
  private:
+  /* Group index of a row whose input is sorted on keys. A new group starts whenever
+   * the key differs from the previous row's, nulls are one group as in hash table.
+   * This only replaces the key lookup: groups still get dense indices into action
+   * state and are emitted by Next() after all input, since whole stage aggregate
+   * iterator has no output until input is exhausted. */
+  arrow::Status GetSortedGroupCodes(int level, const std::string& key_type,
+                                    bool is_unsafe_row_key, bool is_float_key,
+                                    std::stringstream* define_ss,
+                                    std::stringstream* process_ss) {
+    auto key_name = "aggr_key_" + std::to_string(level);
+    auto last_key_name = "aggr_last_key_" + std::to_string(level);
+    auto group_name = "aggr_sorted_group_" + std::to_string(level);
+    *define_ss << key_type << " " << last_key_name << ";" << std::endl;
+    *define_ss << "bool " << last_key_name << "_validity = false;" << std::endl;
+    *define_ss << "int " << group_name << " = -1;" << std::endl;
+
+    std::string last_key_view = last_key_name;
+    if (is_unsafe_row_key) {
+      last_key_view = "arrow::util::string_view(" + last_key_name + ")";
+    }
+    std::string key_equals = key_name + " == " + last_key_view;
+    if (is_float_key) {
+      // NaN keys are one group
+      key_equals += " || (std::isnan(" + key_name + ") && std::isnan(" + last_key_name +
+                    "))";
+    }
+    *process_ss << "if (" << group_name << " < 0 || " << key_name
+                << "_validity != " << last_key_name << "_validity || (" << key_name
+                << "_validity && !(" << key_equals << "))) {" << std::endl;
+    *process_ss << last_key_name << "_validity = " << key_name << "_validity;"
+                << std::endl;
+    *process_ss << "if (" << key_name << "_validity) {" << std::endl;
+    if (is_unsafe_row_key) {
+      *process_ss << last_key_name << ".assign(" << key_name << ".data(), " << key_name
+                  << ".size());" << std::endl;
+    } else {
+      *process_ss << last_key_name << " = " << key_name << ";" << std::endl;
+    }
+    *process_ss << "}" << std::endl;
+    *process_ss << group_name << "++;" << std::endl;
+    *process_ss << "}" << std::endl;
+    *process_ss << "memo_index = " << group_name << ";" << std::endl;
+    return arrow::Status::OK();
+  }
+
+  /* Bit width of a key column inside packed key, 0 if it is not fixed width. */
+  int GetPackedKeyBitWidth(std::shared_ptr<arrow::DataType> type) {
+    switch (type->id()) {
+      case arrow::BooleanType::type_id:
+      case arrow::UInt8Type::type_id:
+      case arrow::Int8Type::type_id:
+        return 8;
+      case arrow::UInt16Type::type_id:
+      case arrow::Int16Type::type_id:
+        return 16;
+      case arrow::UInt32Type::type_id:
+      case arrow::Int32Type::type_id:
+      case arrow::FloatType::type_id:
+      case arrow::Date32Type::type_id:
+        return 32;
+      case arrow::UInt64Type::type_id:
+      case arrow::Int64Type::type_id:
+      case arrow::DoubleType::type_id:
+      case arrow::Date64Type::type_id:
+        return 64;
+      default:
+        return 0;
+    }
+  }
+
+  /* Assign each key a (word, bit offset) inside the packed key, a key never crosses
+   * a word and wider keys are placed first. The highest num_keys bits of the last
+   * word are null flags. Returns the number of 64-bit words used, or 0 if keys can't
+   * be packed into 128 bits. */
+  int GetPackedKeyLayout(const std::vector<gandiva::NodePtr>& key_node_list,
+                         std::vector<std::pair<int, int>>* layout) {
+    int num_keys = key_node_list.size();
+    std::vector<int> widths;
+    for (auto key_node : key_node_list) {
+      auto width = GetPackedKeyBitWidth(key_node->return_type());
+      if (width == 0) return 0;
+      widths.push_back(width);
+    }
+    std::vector<int> key_order(num_keys);
+    std::iota(key_order.begin(), key_order.end(), 0);
+    std::stable_sort(key_order.begin(), key_order.end(),
+                     [&widths](int l, int r) { return widths[l] > widths[r]; });
+    for (int num_words = 1; num_words <= 2; num_words++) {
+      std::vector<int> capacity(num_words, 64);
+      std::vector<int> offset(num_words, 0);
+      capacity[num_words - 1] -= num_keys;
+      layout->assign(num_keys, std::make_pair(-1, 0));
+      int num_placed = 0;
+      for (auto key_idx : key_order) {
+        for (int word = 0; word < num_words; word++) {
+          if (offset[word] + widths[key_idx] <= capacity[word]) {
+            (*layout)[key_idx] = std::make_pair(word, offset[word]);
+            offset[word] += widths[key_idx];
+            num_placed++;
+            break;
+          }
+        }
+      }
+      if (num_placed == num_keys) return num_words;
+    }
+    layout->clear();
+    return 0;
+  }
+
+  /* Typed accumulator replacing the ActionBase of this action in batch accumulate
+   * mode, returns empty string if the action is not supported. */
+  std::string GetBatchAccumulatorString(const std::string& action_name,
+                                        std::shared_ptr<arrow::DataType> type) {
+    if (action_name == "action_count") return "CountBatchAccumulator";
+    switch (type->id()) {
+      case arrow::UInt8Type::type_id:
+      case arrow::Int8Type::type_id:
+      case arrow::UInt16Type::type_id:
+      case arrow::Int16Type::type_id:
+      case arrow::UInt32Type::type_id:
+      case arrow::Int32Type::type_id:
+      case arrow::UInt64Type::type_id:
+      case arrow::Int64Type::type_id:
+      case arrow::FloatType::type_id:
+      case arrow::DoubleType::type_id:
+        break;
+      default:
+        return "";
+    }
+    std::string accumulator;
+    if (action_name == "action_sum") {
+      accumulator = "SumBatchAccumulator";
+    } else if (action_name == "action_avg") {
+      accumulator = "AvgBatchAccumulator";
+    } else if (action_name == "action_min") {
+      accumulator = "MinBatchAccumulator";
+    } else if (action_name == "action_max") {
+      accumulator = "MaxBatchAccumulator";
+    } else {
+      return "";
+    }
+    return accumulator + "<arrow::" + GetTypeString(type, "Type") + ">";
+  }
+
   arrow::compute::FunctionContext* ctx_;
   arrow::MemoryPool* pool_;
   std::string signature_;
@@ -425,6 +866,8 @@ class HashAggregateKernel::Impl {
   std::vector<std::shared_ptr<gandiva::Node>> action_list_;
   std::vector<std::shared_ptr<arrow::Field>> result_field_list_;
   std::vector<std::shared_ptr<gandiva::Node>> result_expr_list_;
+  bool is_partial_;
+  bool is_sorted_;
 };
 
 arrow::Status HashAggregateKernel::Make(
@@ -433,9 +876,11 @@ arrow::Status HashAggregateKernel::Make(
     std::vector<std::shared_ptr<gandiva::Node>> action_list,
     std::vector<std::shared_ptr<gandiva::Node>> result_field_node_list,
     std::vector<std::shared_ptr<gandiva::Node>> result_expr_node_list,
-    std::shared_ptr<KernalBase>* out) {
-  *out = std::make_shared<HashAggregateKernel>(
-      ctx, input_field_list, action_list, result_field_node_list, result_expr_node_list);
+    std::shared_ptr<KernalBase>* out, bool is_partial, bool is_sorted) {
+  *out = std::make_shared<HashAggregateKernel>(ctx, input_field_list, action_list,
+                                               result_field_node_list,
+                                               result_expr_node_list, is_partial,
+                                               is_sorted);
   return arrow::Status::OK();
 }
 
@@ -444,9 +889,10 @@ HashAggregateKernel::HashAggregateKernel(
     std::vector<std::shared_ptr<gandiva::Node>> input_field_list,
     std::vector<std::shared_ptr<gandiva::Node>> action_list,
     std::vector<std::shared_ptr<gandiva::Node>> result_field_node_list,
-    std::vector<std::shared_ptr<gandiva::Node>> result_expr_node_list) {
+    std::vector<std::shared_ptr<gandiva::Node>> result_expr_node_list, bool is_partial,
+    bool is_sorted) {
   impl_.reset(new Impl(ctx, input_field_list, action_list, result_field_node_list,
-                       result_expr_node_list));
+                       result_expr_node_list, is_partial, is_sorted));
   kernel_name_ = "HashAggregateKernelKernel";
 }
 #undef PROCESS_SUPPORTED_TYPES
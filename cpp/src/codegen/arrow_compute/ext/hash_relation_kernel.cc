@@ -29,6 +29,8 @@
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <thread>
 #include <unordered_map>
 
 #include "codegen/arrow_compute/ext/codegen_common.h"
@@ -36,6 +38,8 @@
 #include "codegen/arrow_compute/ext/typed_node_visitor.h"
 #include "codegen/common/hash_relation_number.h"
 #include "codegen/common/hash_relation_string.h"
+#include "codegen/common/thread_pool.h"
+#include "precompile/hash_arrays_kernel.h"
 #include "utils/macros.h"
 
 namespace sparkcolumnarplugin {
@@ -73,6 +77,22 @@ class HashRelationKernel::Impl {
       auto builder_type_str = gandiva::ToString(
           std::dynamic_pointer_cast<gandiva::LiteralNode>(parameter_nodes[0])->holder());
       builder_type_ = std::stoi(builder_type_str);
+      if (parameter_nodes.size() > 1) {
+        auto num_threads_str = gandiva::ToString(
+            std::dynamic_pointer_cast<gandiva::LiteralNode>(parameter_nodes[1])
+                ->holder());
+        num_build_threads_ = std::stoi(num_threads_str);
+        int max_threads = std::thread::hardware_concurrency();
+        if (max_threads > 0 && num_build_threads_ > max_threads) {
+          num_build_threads_ = max_threads;
+        }
+      }
+      if (parameter_nodes.size() > 2) {
+        auto min_rows_str = gandiva::ToString(
+            std::dynamic_pointer_cast<gandiva::LiteralNode>(parameter_nodes[2])
+                ->holder());
+        parallel_build_min_rows_ = std::stoull(min_rows_str);
+      }
     }
     if (builder_type_ == 0) {
       if (key_nodes.size() == 1) {
@@ -114,8 +134,16 @@ class HashRelationKernel::Impl {
         key_hash_field_list.push_back(expr->result());
       }
       hash_input_schema_ = arrow::schema(key_hash_field_list);
-      THROW_NOT_OK(gandiva::Projector::Make(hash_input_schema_, {key_hash_expr},
-                                            configuration, &key_projector_));
+      use_vectorized_hash_ = true;
+      for (auto field : key_hash_field_list) {
+        if (!precompile::IsVectorizedHashSupported(field->type())) {
+          use_vectorized_hash_ = false;
+        }
+      }
+      if (!use_vectorized_hash_) {
+        THROW_NOT_OK(gandiva::Projector::Make(hash_input_schema_, {key_hash_expr},
+                                              configuration, &key_projector_));
+      }
       if (key_hash_field_list.size() == 1 &&
           key_hash_field_list[0]->type()->id() != arrow::Type::STRING) {
         // If single key case, we can put key in KeyArray
@@ -163,12 +191,17 @@ class HashRelationKernel::Impl {
                                                      &project_outputs));
       keys_cached_.push_back(project_outputs);
       /* Process key Hash projection */
-      arrow::ArrayVector hash_outputs;
-      auto hash_in_batch =
-          arrow::RecordBatch::Make(hash_input_schema_, length, project_outputs);
-      RETURN_NOT_OK(
-          key_projector_->Evaluate(*hash_in_batch, ctx_->memory_pool(), &hash_outputs));
-      key_array = hash_outputs[0];
+      if (use_vectorized_hash_) {
+        RETURN_NOT_OK(precompile::Murmur3HashArrays(ctx_->memory_pool(),
+                                                    project_outputs, &key_array));
+      } else {
+        arrow::ArrayVector hash_outputs;
+        auto hash_in_batch =
+            arrow::RecordBatch::Make(hash_input_schema_, length, project_outputs);
+        RETURN_NOT_OK(key_projector_->Evaluate(*hash_in_batch, ctx_->memory_pool(),
+                                               &hash_outputs));
+        key_array = hash_outputs[0];
+      }
       key_hash_cached_.push_back(key_array);
     }
     return arrow::Status::OK();
@@ -176,27 +209,101 @@ class HashRelationKernel::Impl {
 
   arrow::Status FinishInternal() {
     if (builder_type_ == 2) return arrow::Status::OK();
+    if (builder_type_ == 1 && num_build_threads_ > 1 &&
+        num_total_cached_ >= parallel_build_min_rows_) {
+      return ParallelFinishInternal();
+    }
     // Decide init hashmap size
     if (builder_type_ == 1) {
-      int init_key_capacity = 128;
-      int init_bytes_map_capacity = init_key_capacity * 256;
-      if (num_total_cached_ > 32) {
-        init_key_capacity = pow(2, ceil(log2(num_total_cached_)) + 1);
-      }
-      if (key_size_ != -1) {
-        init_bytes_map_capacity = init_key_capacity * 12;
-      } else {
-        init_bytes_map_capacity = init_key_capacity * 128;
-      }
+      int init_key_capacity;
+      int init_bytes_map_capacity;
+      GetInitCapacity(num_total_cached_, &init_key_capacity, &init_bytes_map_capacity);
       RETURN_NOT_OK(
           hash_relation_->InitHashTable(init_key_capacity, init_bytes_map_capacity));
     }
     for (int idx = 0; idx < key_hash_cached_.size(); idx++) {
-      auto key_array = key_hash_cached_[idx];
-      if (builder_type_ == 0) {
-        RETURN_NOT_OK(hash_relation_->AppendKeyColumn(key_array));
-      } else {
-        auto project_outputs = keys_cached_[idx];
+      RETURN_NOT_OK(AppendKeyBatch(hash_relation_, idx));
+    }
+    return arrow::Status::OK();
+  }
+
+  /* Partitioned parallel build: row ids of each batch are scattered once by the top
+   * bits of their hash, then every partition builds its own hash table from its rows
+   * only. Partitions are handed to hash_relation_ as they are, probe side selects
+   * the partition by the same hash bits. */
+  arrow::Status ParallelFinishInternal() {
+    int partition_bits = 0;
+    while ((2 << partition_bits) <= num_build_threads_) partition_bits++;
+    int num_partitions = 1 << partition_bits;
+    int num_batches = key_hash_cached_.size();
+    auto thread_pool = ThreadPool::Default();
+
+    // partition_rows[p][idx] holds row ids of batch idx belonging to partition p
+    std::vector<std::vector<std::vector<int32_t>>> partition_rows(
+        num_partitions, std::vector<std::vector<int32_t>>(num_batches));
+    thread_pool->ParallelFor(num_batches, [this, partition_bits,
+                                           &partition_rows](int idx) {
+      auto typed_array = std::make_shared<precompile::Int32Array>(key_hash_cached_[idx]);
+      for (int i = 0; i < typed_array->length(); i++) {
+        auto p = (uint32_t)typed_array->GetView(i) >> (32 - partition_bits);
+        partition_rows[p][idx].push_back(i);
+      }
+    });
+
+    std::vector<std::shared_ptr<HashRelation>> sub_relation_list(num_partitions);
+    std::vector<arrow::Status> status_list(num_partitions);
+    thread_pool->ParallelFor(num_partitions, [this, &partition_rows, &sub_relation_list,
+                                              &status_list](int p) {
+      status_list[p] = BuildHashPartition(partition_rows[p], &sub_relation_list[p]);
+    });
+    for (auto status : status_list) {
+      RETURN_NOT_OK(status);
+    }
+    return hash_relation_->SetHashPartitions(partition_bits, sub_relation_list);
+  }
+
+  arrow::Status BuildHashPartition(const std::vector<std::vector<int32_t>>& rows,
+                                   std::shared_ptr<HashRelation>* out) {
+    auto sub_relation = std::make_shared<HashRelation>(
+        ctx_, std::vector<std::shared_ptr<HashRelationColumn>>(), key_size_);
+    uint64_t num_rows = 0;
+    for (auto& batch_rows : rows) {
+      num_rows += batch_rows.size();
+    }
+    int init_key_capacity;
+    int init_bytes_map_capacity;
+    GetInitCapacity(num_rows, &init_key_capacity, &init_bytes_map_capacity);
+    RETURN_NOT_OK(
+        sub_relation->InitHashTable(init_key_capacity, init_bytes_map_capacity));
+    // empty batches are appended as well to keep array ids in step with batches
+    for (int idx = 0; idx < key_hash_cached_.size(); idx++) {
+      RETURN_NOT_OK(AppendKeyBatch(sub_relation, idx, &rows[idx]));
+    }
+    *out = sub_relation;
+    return arrow::Status::OK();
+  }
+
+  void GetInitCapacity(uint64_t num_rows, int* init_key_capacity,
+                       int* init_bytes_map_capacity) {
+    *init_key_capacity = 128;
+    if (num_rows > 32) {
+      *init_key_capacity = pow(2, ceil(log2(num_rows)) + 1);
+    }
+    if (key_size_ != -1) {
+      *init_bytes_map_capacity = *init_key_capacity * 12;
+    } else {
+      *init_bytes_map_capacity = *init_key_capacity * 128;
+    }
+  }
+
+  /* rows, if not null, selects the rows of batch idx to be inserted */
+  arrow::Status AppendKeyBatch(const std::shared_ptr<HashRelation>& hash_relation,
+                               int idx, const std::vector<int32_t>* rows = nullptr) {
+    auto key_array = key_hash_cached_[idx];
+    if (builder_type_ == 0) {
+      RETURN_NOT_OK(hash_relation->AppendKeyColumn(key_array));
+    } else {
+      auto project_outputs = keys_cached_[idx];
 
 /* For single field fixed_size key, we simply insert to HashMap without append to unsafe
  * Row */
@@ -215,35 +322,35 @@ class HashRelationKernel::Impl {
   PROCESS(arrow::Date32Type)             \
   PROCESS(arrow::Date64Type)             \
   PROCESS(arrow::StringType)
-        if (project_outputs.size() == 1) {
-          switch (project_outputs[0]->type_id()) {
-#define PROCESS(InType)                                                       \
-  case TypeTraits<InType>::type_id: {                                         \
-    using ArrayType = precompile::TypeTraits<InType>::ArrayType;              \
-    auto typed_key_arr = std::make_shared<ArrayType>(project_outputs[0]);     \
-    RETURN_NOT_OK(hash_relation_->AppendKeyColumn(key_array, typed_key_arr)); \
+      if (project_outputs.size() == 1) {
+        switch (project_outputs[0]->type_id()) {
+#define PROCESS(InType)                                                      \
+  case TypeTraits<InType>::type_id: {                                        \
+    using ArrayType = precompile::TypeTraits<InType>::ArrayType;             \
+    auto typed_key_arr = std::make_shared<ArrayType>(project_outputs[0]);    \
+    RETURN_NOT_OK(                                                           \
+        hash_relation->AppendKeyColumn(key_array, typed_key_arr, rows));     \
   } break;
-            PROCESS_SUPPORTED_TYPES(PROCESS)
+          PROCESS_SUPPORTED_TYPES(PROCESS)
 #undef PROCESS
-            default: {
-              return arrow::Status::NotImplemented(
-                  "HashRelation Evaluate doesn't support single key type ",
-                  project_outputs[0]->type_id());
-            } break;
-          }
+          default: {
+            return arrow::Status::NotImplemented(
+                "HashRelation Evaluate doesn't support single key type ",
+                project_outputs[0]->type_id());
+          } break;
+        }
 #undef PROCESS_SUPPORTED_TYPES
 
-        } else {
-          /* Append key array to UnsafeArray for later UnsafeRow projection */
-          std::vector<std::shared_ptr<UnsafeArray>> payloads;
-          int i = 0;
-          for (auto arr : project_outputs) {
-            std::shared_ptr<UnsafeArray> payload;
-            RETURN_NOT_OK(MakeUnsafeArray(arr->type(), i++, arr, &payload));
-            payloads.push_back(payload);
-          }
-          RETURN_NOT_OK(hash_relation_->AppendKeyColumn(key_array, payloads));
+      } else {
+        /* Append key array to UnsafeArray for later UnsafeRow projection */
+        std::vector<std::shared_ptr<UnsafeArray>> payloads;
+        int i = 0;
+        for (auto arr : project_outputs) {
+          std::shared_ptr<UnsafeArray> payload;
+          RETURN_NOT_OK(MakeUnsafeArray(arr->type(), i++, arr, &payload));
+          payloads.push_back(payload);
         }
+        RETURN_NOT_OK(hash_relation->AppendKeyColumn(key_array, payloads, rows));
       }
     }
     return arrow::Status::OK();
@@ -266,12 +373,17 @@ class HashRelationKernel::Impl {
   std::shared_ptr<gandiva::Projector> key_projector_;
   std::shared_ptr<gandiva::Projector> key_prepare_projector_;
   std::shared_ptr<arrow::Schema> hash_input_schema_;
+  // hash keys in one pass per column instead of a Gandiva hash32 projection
+  bool use_vectorized_hash_ = false;
   std::shared_ptr<HashRelation> hash_relation_;
   std::vector<arrow::ArrayVector> keys_cached_;
   std::vector<std::shared_ptr<arrow::Array>> key_hash_cached_;
   uint64_t num_total_cached_ = 0;
   int builder_type_ = 0;
   int key_size_ = -1;  // If key_size_ != 0, key will be stored directly in key_map
+  int num_build_threads_ = 1;
+  // Parallel build only pays off when there are enough rows to be inserted
+  uint64_t parallel_build_min_rows_ = 1 << 20;
 
   class HashRelationResultIterator : public ResultIterator<HashRelation> {
    public:
@@ -332,4 +444,4 @@ std::string HashRelationKernel::GetSignature() { return impl_->GetSignature(); }
 }  // namespace extra
 }  // namespace arrowcompute
 }  // namespace codegen
-}  // namespace sparkcolumnarplugin
\ No newline at end of file
+}  // namespace sparkcolumnarplugin
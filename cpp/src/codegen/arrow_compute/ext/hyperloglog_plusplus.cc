@@ -0,0 +1,75 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "codegen/arrow_compute/ext/hyperloglog_plusplus.h"
+
+#include <mutex>
+
+#include "codegen/arrow_compute/ext/hyperloglog_plusplus_bias.h"
+
+namespace sparkcolumnarplugin {
+namespace codegen {
+namespace arrowcompute {
+namespace extra {
+
+namespace {
+// one table per precision from 4 to 18
+constexpr int kNumHllBiasTables = 15;
+
+std::mutex hll_bias_tables_mutex;
+std::shared_ptr<const std::vector<HllBiasTable>> hll_bias_tables;
+}  // namespace
+
+std::shared_ptr<const std::vector<HllBiasTable>> GetHllBiasTables() {
+  std::lock_guard<std::mutex> lock(hll_bias_tables_mutex);
+  if (!hll_bias_tables) {
+    auto tables = std::make_shared<std::vector<HllBiasTable>>(kNumHllBiasTables);
+    for (int i = 0; i < kNumHllBiasTables; i++) {
+      auto size = kHllBiasDataSize[i];
+      (*tables)[i].raw_estimates.assign(kHllRawEstimateData[i],
+                                        kHllRawEstimateData[i] + size);
+      (*tables)[i].biases.assign(kHllBiasData[i], kHllBiasData[i] + size);
+    }
+    hll_bias_tables = tables;
+  }
+  return hll_bias_tables;
+}
+
+arrow::Status SetHllBiasTables(std::vector<HllBiasTable> tables) {
+  if (tables.size() != kNumHllBiasTables) {
+    return arrow::Status::Invalid("Expected ", kNumHllBiasTables,
+                                  " HyperLogLogPlusPlus bias tables, got ",
+                                  tables.size());
+  }
+  for (auto& table : tables) {
+    if (table.raw_estimates.empty() ||
+        table.raw_estimates.size() != table.biases.size()) {
+      return arrow::Status::Invalid(
+          "HyperLogLogPlusPlus bias table has ", table.raw_estimates.size(),
+          " raw estimates and ", table.biases.size(), " biases");
+    }
+  }
+  std::lock_guard<std::mutex> lock(hll_bias_tables_mutex);
+  hll_bias_tables =
+      std::make_shared<const std::vector<HllBiasTable>>(std::move(tables));
+  return arrow::Status::OK();
+}
+
+}  // namespace extra
+}  // namespace arrowcompute
+}  // namespace codegen
+}  // namespace sparkcolumnarplugin
@@ -0,0 +1,240 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/status.h>
+#include <arrow/util/string_view.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define XXH_INLINE_ALL
+#define XXH_PRIVATE_API
+#define XXH_NAMESPACE arrow_hashing_
+#include "third_party/arrow/vendored/xxhash/xxhash.h"
+
+namespace sparkcolumnarplugin {
+namespace codegen {
+namespace arrowcompute {
+namespace extra {
+
+/* Raw estimates of one precision below 5 * m, and the bias of each */
+struct HllBiasTable {
+  std::vector<double> raw_estimates;
+  std::vector<double> biases;
+};
+
+/* Bias tables of precision 4 to 18 in use, indexed by p - 4. They are the ones of
+ * hyperloglog_plusplus_bias.h until Spark's own tables are set. */
+std::shared_ptr<const std::vector<HllBiasTable>> GetHllBiasTables();
+
+/* Replaces the bias tables, the JVM hands over the ones of Spark's
+ * HyperLogLogPlusPlusHelper so estimates are the same as Spark's. Sketches created
+ * before keep the tables they started with. */
+arrow::Status SetHllBiasTables(std::vector<HllBiasTable> tables);
+
+/** HyperLogLogPlusPlus
+ *
+ * Sketch layout and estimator of Spark's HyperLogLogPlusPlusHelper, so a partial
+ * sketch built here can be merged by Spark and the other way around.
+ * 2^p registers of 6 bits are packed 10 per int64 word, values are hashed by
+ * XxHash64 with seed 42 as Spark does.
+ * An estimate above the linear counting threshold and below 5 * m is corrected by the
+ * bias of its 6 nearest raw estimates in GetHllBiasTables(), as in Spark.
+ **/
+class HyperLogLogPlusPlus {
+ public:
+  static constexpr int kRegisterSize = 6;
+  static constexpr int kRegistersPerWord = 10;
+  static constexpr int kRegisterWordBits = kRegisterSize * kRegistersPerWord;
+  static constexpr uint64_t kRegisterWordMask = (1ULL << kRegisterSize) - 1;
+  static constexpr uint64_t kSeed = 42;
+
+  explicit HyperLogLogPlusPlus(double relative_sd) {
+    p_ = static_cast<int>(
+        std::ceil(2.0 * std::log(1.106 / relative_sd) / std::log(2.0)));
+    p_ = std::max(p_, 4);
+    m_ = 1 << p_;
+    num_words_ = m_ / kRegistersPerWord + 1;
+    switch (p_) {
+      case 4:
+        alpha_m2_ = 0.673 * m_ * m_;
+        break;
+      case 5:
+        alpha_m2_ = 0.697 * m_ * m_;
+        break;
+      case 6:
+        alpha_m2_ = 0.709 * m_ * m_;
+        break;
+      default:
+        alpha_m2_ = (0.7213 / (1.0 + 1.079 / m_)) * m_ * m_;
+        break;
+    }
+    bias_tables_ = GetHllBiasTables();
+  }
+
+  int num_words() const { return num_words_; }
+
+  /* Spark hashes every integral type narrower than long as an int */
+  template <typename CType>
+  static uint64_t Hash(CType value) {
+    if (sizeof(CType) <= 4) {
+      int32_t v = static_cast<int32_t>(value);
+      return XXH64(&v, sizeof(v), kSeed);
+    }
+    int64_t v = static_cast<int64_t>(value);
+    return XXH64(&v, sizeof(v), kSeed);
+  }
+
+  static uint64_t Hash(float value) {
+    // -0.0 is hashed as 0.0 and NaN is canonicalized as floatToIntBits does
+    int32_t bits = 0x7fc00000;
+    if (value == 0.0f) {
+      bits = 0;
+    } else if (!std::isnan(value)) {
+      std::memcpy(&bits, &value, sizeof(bits));
+    }
+    return XXH64(&bits, sizeof(bits), kSeed);
+  }
+
+  static uint64_t Hash(double value) {
+    int64_t bits = 0x7ff8000000000000LL;
+    if (value == 0.0) {
+      bits = 0;
+    } else if (!std::isnan(value)) {
+      std::memcpy(&bits, &value, sizeof(bits));
+    }
+    return XXH64(&bits, sizeof(bits), kSeed);
+  }
+
+  static uint64_t Hash(arrow::util::string_view value) {
+    return XXH64(value.data(), value.size(), kSeed);
+  }
+
+  static uint64_t Hash(const std::string& value) {
+    return XXH64(value.data(), value.size(), kSeed);
+  }
+
+  void Update(int64_t* words, uint64_t hash) const {
+    auto idx = static_cast<int>(hash >> (64 - p_));
+    uint64_t w = (hash << p_) | (1ULL << (p_ - 1));
+    uint64_t pw = __builtin_clzll(w) + 1;
+    auto word_offset = idx / kRegistersPerWord;
+    auto shift = kRegisterSize * (idx - word_offset * kRegistersPerWord);
+    uint64_t word = words[word_offset];
+    uint64_t mask = kRegisterWordMask << shift;
+    if (pw > ((word & mask) >> shift)) {
+      words[word_offset] = static_cast<int64_t>((word & ~mask) | (pw << shift));
+    }
+  }
+
+  /* Keeps the larger register of both sketches */
+  void Merge(int64_t* words, const int64_t* other) const {
+    int idx = 0;
+    for (int i = 0; i < num_words_; i++) {
+      uint64_t word1 = words[i];
+      uint64_t word2 = other[i];
+      uint64_t word = 0;
+      uint64_t mask = kRegisterWordMask;
+      for (int shift = 0; idx < m_ && shift < kRegisterWordBits;
+           shift += kRegisterSize, idx++) {
+        word |= std::max(word1 & mask, word2 & mask);
+        mask <<= kRegisterSize;
+      }
+      words[i] = static_cast<int64_t>(word);
+    }
+  }
+
+  int64_t Query(const int64_t* words) const {
+    double z_inverse = 0.0;
+    double v = 0.0;
+    int idx = 0;
+    for (int i = 0; i < num_words_; i++) {
+      uint64_t word = words[i];
+      for (int shift = 0; idx < m_ && shift < kRegisterWordBits;
+           shift += kRegisterSize, idx++) {
+        auto m_idx = (word >> shift) & kRegisterWordMask;
+        z_inverse += 1.0 / static_cast<double>(1ULL << m_idx);
+        if (m_idx == 0) v += 1.0;
+      }
+    }
+    double estimate = alpha_m2_ / z_inverse;
+    if (estimate < 5.0 * m_) {
+      estimate -= EstimateBias(estimate);
+    }
+    if (v > 0) {
+      // linear counting for small cardinalities
+      double h = m_ * std::log(m_ / v);
+      if (h <= Threshold(p_)) {
+        estimate = h;
+      }
+    }
+    return static_cast<int64_t>(std::llround(estimate));
+  }
+
+ private:
+  // neighbors of the raw estimate whose biases are averaged
+  static constexpr int kNearestNeighbors = 6;
+
+  /* Mean bias of the kNearestNeighbors raw estimates closest to e */
+  double EstimateBias(double e) const {
+    if (p_ > 18) return 0.0;
+    const auto& table = (*bias_tables_)[p_ - 4];
+    auto estimates = table.raw_estimates.data();
+    auto biases = table.biases.data();
+    int num_estimates = table.raw_estimates.size();
+    int nearest = std::lower_bound(estimates, estimates + num_estimates, e) - estimates;
+    auto distance = [&](int i) { return (e - estimates[i]) * (e - estimates[i]); };
+    // move the window while its exclusive high bound is closer than its low bound
+    int low = std::max(nearest - kNearestNeighbors + 1, 0);
+    int high = std::min(low + kNearestNeighbors, num_estimates);
+    while (high < num_estimates && distance(high) < distance(low)) {
+      low++;
+      high++;
+    }
+    double bias_sum = 0.0;
+    for (int i = low; i < high; i++) {
+      bias_sum += biases[i];
+    }
+    return bias_sum / (high - low);
+  }
+
+  /* cardinality under which linear counting is preferred, indexed by p - 4 */
+  static double Threshold(int p) {
+    static const double kThresholds[] = {10,   20,   40,    80,    220,
+                                         400,  900,  1800,  3100,  6500,
+                                         11500, 20000, 50000, 120000, 350000};
+    return kThresholds[std::min(p, 18) - 4];
+  }
+
+  int p_;
+  int m_;
+  int num_words_;
+  double alpha_m2_;
+  std::shared_ptr<const std::vector<HllBiasTable>> bias_tables_;
+};
+
+}  // namespace extra
+}  // namespace arrowcompute
+}  // namespace codegen
+}  // namespace sparkcolumnarplugin
@@ -0,0 +1,842 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+namespace sparkcolumnarplugin {
+namespace codegen {
+namespace arrowcompute {
+namespace extra {
+
+/** Bias correction data of HyperLogLogPlusPlus
+ *
+ * Mean raw estimate and its bias at sampled cardinalities below 5 * m, for precision
+ * 4 to 18, used for k nearest neighbor interpolation of the bias as in HLL++ and
+ * Spark's HyperLogLogPlusPlusHelper. These are only the fallback until the JVM sets
+ * Spark's own tables by SetHllBiasTables. Tables were produced with the procedure of the
+ * HLL++ paper: for each precision, distinct int64 values hashed by XxHash64 with seed
+ * 42 are inserted into empty sketches and the raw estimate is averaged over 20000
+ * (p <= 8) down to 200 (p >= 17) runs at cardinality 1 and every ceil(5 * m / 200).
+ **/
+static const double kHllRawEstimateData4[] = {
+    11.2378, 11.723, 12.2263, 12.7398, 13.2717, 13.8192, 14.3783, 14.9546, 15.5466,
+    16.1594, 16.7885, 17.4326, 18.0935, 18.7697, 19.4686, 20.177, 20.8865, 21.6138,
+    22.358, 23.108, 23.8677, 24.6471, 25.4423, 26.2464, 27.0758, 27.9035, 28.7419,
+    29.6009, 30.4666, 31.3535, 32.2515, 33.1281, 34.0233, 34.9353, 35.8605, 36.7734,
+    37.6999, 38.6281, 39.5621, 40.4941, 41.4542, 42.4139, 43.3884, 44.3568, 45.3278,
+    46.2969, 47.2673, 48.2258, 49.1973, 50.1593, 51.1512, 52.1486, 53.1384, 54.1281,
+    55.1246, 56.0612, 57.052, 58.0385, 59.0246, 60.0197, 61.0427, 62.0425, 63.0234,
+    64.0386, 65.0209, 66.0125, 67.0202, 68.0242, 69.0344, 70.0339, 71.0302, 72.0382,
+    73.0437, 74.0149, 75.0357, 76.0143, 76.9942, 77.9716, 78.9912};
+
+static const double kHllBiasData4[] = {
+    10.2378, 9.723, 9.2263, 8.7398, 8.2717, 7.8192, 7.3783, 6.9546, 6.5466, 6.1594,
+    5.7885, 5.4326, 5.0935, 4.7697, 4.4686, 4.177, 3.8865, 3.6138, 3.358, 3.108, 2.8677,
+    2.6471, 2.4423, 2.2464, 2.0758, 1.9035, 1.7419, 1.6009, 1.4666, 1.3535, 1.2515,
+    1.1281, 1.0233, 0.9353, 0.8605, 0.7734, 0.6999, 0.6281, 0.5621, 0.4941, 0.4542,
+    0.4139, 0.3884, 0.3568, 0.3278, 0.2969, 0.2673, 0.2258, 0.1973, 0.1593, 0.1512,
+    0.1486, 0.1384, 0.1281, 0.1246, 0.0612, 0.052, 0.0385, 0.0246, 0.0197, 0.0427,
+    0.0425, 0.0234, 0.0386, 0.0209, 0.0125, 0.0202, 0.0242, 0.0344, 0.0339, 0.0302,
+    0.0382, 0.0437, 0.0149, 0.0357, 0.0143, -0.0058, -0.0284, -0.0088};
+
+static const double kHllRawEstimateData5[] = {
+    22.7791, 23.2627, 23.7518, 24.2493, 24.7545, 25.2663, 25.7825, 26.3085, 26.842,
+    27.387, 27.9374, 28.4963, 29.0656, 29.6377, 30.2193, 30.8089, 31.3993, 32.0037,
+    32.6155, 33.2319, 33.8525, 34.4846, 35.1294, 35.7772, 36.4331, 37.0958, 37.7624,
+    38.4356, 39.1199, 39.8139, 40.521, 41.2228, 41.9337, 42.656, 43.3806, 44.1091,
+    44.8531, 45.5857, 46.3422, 47.0946, 47.8617, 48.6368, 49.4213, 50.2111, 51.0073,
+    51.8018, 52.6036, 53.4215, 54.2316, 55.0455, 55.8622, 56.6919, 57.5199, 58.3568,
+    59.1949, 60.0207, 60.8855, 61.7264, 62.5781, 63.4615, 64.3432, 65.2218, 66.1064,
+    66.9939, 67.8726, 68.7542, 69.641, 70.5431, 71.4533, 72.3402, 73.2508, 74.1695,
+    75.0814, 75.9923, 76.9291, 77.8489, 78.7806, 79.7109, 80.651, 81.6016, 82.5423,
+    83.5055, 84.4342, 85.3673, 86.325, 87.2681, 88.2211, 89.1552, 90.1124, 91.0785,
+    92.0434, 93.0073, 93.9669, 94.9587, 95.8893, 96.8652, 97.8394, 98.798, 99.7638,
+    100.7537, 101.7114, 102.6726, 103.6691, 104.654, 105.6247, 106.5985, 107.5636,
+    108.5582, 109.495, 110.4686, 111.4487, 112.4396, 113.4116, 114.3635, 115.3372,
+    116.3374, 117.3493, 118.3421, 119.3496, 120.3799, 121.3857, 122.3716, 123.3906,
+    124.3777, 125.3494, 126.2952, 127.3115, 128.3196, 129.3203, 130.3202, 131.3086,
+    132.2955, 133.2922, 134.2658, 135.2228, 136.2053, 137.2054, 138.2461, 139.2755,
+    140.2555, 141.2427, 142.2578, 143.2381, 144.2269, 145.2242, 146.2202, 147.1887,
+    148.1734, 149.1551, 150.2012, 151.1807, 152.1352, 153.1239, 154.1178, 155.1059,
+    156.0973, 157.1003, 158.0585, 159.0499};
+
+static const double kHllBiasData5[] = {
+    21.7791, 21.2627, 20.7518, 20.2493, 19.7545, 19.2663, 18.7825, 18.3085, 17.842,
+    17.387, 16.9374, 16.4963, 16.0656, 15.6377, 15.2193, 14.8089, 14.3993, 14.0037,
+    13.6155, 13.2319, 12.8525, 12.4846, 12.1294, 11.7772, 11.4331, 11.0958, 10.7624,
+    10.4356, 10.1199, 9.8139, 9.521, 9.2228, 8.9337, 8.656, 8.3806, 8.1091, 7.8531,
+    7.5857, 7.3422, 7.0946, 6.8617, 6.6368, 6.4213, 6.2111, 6.0073, 5.8018, 5.6036,
+    5.4215, 5.2316, 5.0455, 4.8622, 4.6919, 4.5199, 4.3568, 4.1949, 4.0207, 3.8855,
+    3.7264, 3.5781, 3.4615, 3.3432, 3.2218, 3.1064, 2.9939, 2.8726, 2.7542, 2.641,
+    2.5431, 2.4533, 2.3402, 2.2508, 2.1695, 2.0814, 1.9923, 1.9291, 1.8489, 1.7806,
+    1.7109, 1.651, 1.6016, 1.5423, 1.5055, 1.4342, 1.3673, 1.325, 1.2681, 1.2211, 1.1552,
+    1.1124, 1.0785, 1.0434, 1.0073, 0.9669, 0.9587, 0.8893, 0.8652, 0.8394, 0.798,
+    0.7638, 0.7537, 0.7114, 0.6726, 0.6691, 0.654, 0.6247, 0.5985, 0.5636, 0.5582, 0.495,
+    0.4686, 0.4487, 0.4396, 0.4116, 0.3635, 0.3372, 0.3374, 0.3493, 0.3421, 0.3496,
+    0.3799, 0.3857, 0.3716, 0.3906, 0.3777, 0.3494, 0.2952, 0.3115, 0.3196, 0.3203,
+    0.3202, 0.3086, 0.2955, 0.2922, 0.2658, 0.2228, 0.2053, 0.2054, 0.2461, 0.2755,
+    0.2555, 0.2427, 0.2578, 0.2381, 0.2269, 0.2242, 0.2202, 0.1887, 0.1734, 0.1551,
+    0.2012, 0.1807, 0.1352, 0.1239, 0.1178, 0.1059, 0.0973, 0.1003, 0.0585, 0.0499};
+
+static const double kHllRawEstimateData6[] = {
+    45.8546, 46.3368, 47.3094, 48.2962, 49.296, 50.3184, 51.3537, 52.4022, 53.4602,
+    54.5362, 55.6234, 56.7266, 57.8449, 58.9816, 60.1319, 61.3059, 62.4868, 63.6786,
+    64.892, 66.1137, 67.3519, 68.6065, 69.8795, 71.1713, 72.4802, 73.7866, 75.1083,
+    76.4394, 77.7747, 79.1374, 80.5236, 81.9163, 83.3189, 84.7292, 86.1641, 87.6083,
+    89.0695, 90.5399, 92.0316, 93.5264, 95.0451, 96.5792, 98.1083, 99.6483, 101.1872,
+    102.7487, 104.3242, 105.9292, 107.5172, 109.1069, 110.7333, 112.3379, 113.9729,
+    115.6238, 117.2951, 118.9291, 120.6133, 122.2945, 123.9975, 125.7443, 127.4746,
+    129.1847, 130.9322, 132.6696, 134.4353, 136.1995, 137.9761, 139.745, 141.4819,
+    143.2919, 145.0964, 146.9205, 148.7125, 150.5298, 152.3377, 154.1585, 155.964,
+    157.8008, 159.6354, 161.4686, 163.3461, 165.1987, 167.0533, 168.939, 170.7786,
+    172.66, 174.5442, 176.4172, 178.3135, 180.1819, 182.0837, 183.9615, 185.8742,
+    187.7864, 189.6947, 191.5627, 193.493, 195.4629, 197.3581, 199.2844, 201.234,
+    203.1898, 205.0965, 207.0363, 208.9747, 210.8995, 212.8591, 214.8353, 216.8224,
+    218.7888, 220.7483, 222.7489, 224.6564, 226.6353, 228.5659, 230.5497, 232.5434,
+    234.5024, 236.4323, 238.4466, 240.3787, 242.3239, 244.2803, 246.2121, 248.2045,
+    250.2341, 252.2192, 254.2203, 256.189, 258.1816, 260.1437, 262.1579, 264.1533,
+    266.1484, 268.1677, 270.1517, 272.1646, 274.1779, 276.2183, 278.1445, 280.1161,
+    282.1418, 284.1265, 286.1626, 288.1349, 290.1241, 292.1025, 294.1025, 296.1642,
+    298.1522, 300.15, 302.1889, 304.2131, 306.2023, 308.1997, 310.1862, 312.1825,
+    314.1606, 316.1428, 318.0586};
+
+static const double kHllBiasData6[] = {
+    44.8546, 44.3368, 43.3094, 42.2962, 41.296, 40.3184, 39.3537, 38.4022, 37.4602,
+    36.5362, 35.6234, 34.7266, 33.8449, 32.9816, 32.1319, 31.3059, 30.4868, 29.6786,
+    28.892, 28.1137, 27.3519, 26.6065, 25.8795, 25.1713, 24.4802, 23.7866, 23.1083,
+    22.4394, 21.7747, 21.1374, 20.5236, 19.9163, 19.3189, 18.7292, 18.1641, 17.6083,
+    17.0695, 16.5399, 16.0316, 15.5264, 15.0451, 14.5792, 14.1083, 13.6483, 13.1872,
+    12.7487, 12.3242, 11.9292, 11.5172, 11.1069, 10.7333, 10.3379, 9.9729, 9.6238,
+    9.2951, 8.9291, 8.6133, 8.2945, 7.9975, 7.7443, 7.4746, 7.1847, 6.9322, 6.6696,
+    6.4353, 6.1995, 5.9761, 5.745, 5.4819, 5.2919, 5.0964, 4.9205, 4.7125, 4.5298,
+    4.3377, 4.1585, 3.964, 3.8008, 3.6354, 3.4686, 3.3461, 3.1987, 3.0533, 2.939, 2.7786,
+    2.66, 2.5442, 2.4172, 2.3135, 2.1819, 2.0837, 1.9615, 1.8742, 1.7864, 1.6947, 1.5627,
+    1.493, 1.4629, 1.3581, 1.2844, 1.234, 1.1898, 1.0965, 1.0363, 0.9747, 0.8995, 0.8591,
+    0.8353, 0.8224, 0.7888, 0.7483, 0.7489, 0.6564, 0.6353, 0.5659, 0.5497, 0.5434,
+    0.5024, 0.4323, 0.4466, 0.3787, 0.3239, 0.2803, 0.2121, 0.2045, 0.2341, 0.2192,
+    0.2203, 0.189, 0.1816, 0.1437, 0.1579, 0.1533, 0.1484, 0.1677, 0.1517, 0.1646,
+    0.1779, 0.2183, 0.1445, 0.1161, 0.1418, 0.1265, 0.1626, 0.1349, 0.1241, 0.1025,
+    0.1025, 0.1642, 0.1522, 0.15, 0.1889, 0.2131, 0.2023, 0.1997, 0.1862, 0.1825, 0.1606,
+    0.1428, 0.0586};
+
+static const double kHllRawEstimateData7[] = {
+    92.0336, 93.4811, 95.438, 97.4313, 99.4474, 101.4957, 103.5656, 105.6728, 107.8064,
+    109.969, 112.1574, 114.3793, 116.64, 118.9228, 121.2212, 123.5687, 125.9282,
+    128.3157, 130.7519, 133.2041, 135.6847, 138.1972, 140.7294, 143.2828, 145.8771,
+    148.4937, 151.1237, 153.8066, 156.5028, 159.2246, 162.0008, 164.7767, 167.5952,
+    170.453, 173.3004, 176.1976, 179.1226, 182.077, 185.0187, 187.9816, 190.9757,
+    193.9933, 197.045, 200.1369, 203.2492, 206.3681, 209.4962, 212.648, 215.8215,
+    219.0544, 222.3033, 225.5644, 228.8327, 232.1223, 235.4408, 238.7577, 242.0961,
+    245.4335, 248.8255, 252.2254, 255.6333, 259.0594, 262.5071, 265.9921, 269.469,
+    272.9977, 276.5194, 280.0883, 283.6766, 287.2854, 290.8169, 294.4076, 298.0148,
+    301.6087, 305.2635, 308.9202, 312.5895, 316.2499, 319.9021, 323.6049, 327.2477,
+    330.9286, 334.6608, 338.4432, 342.1897, 345.9416, 349.7272, 353.5216, 357.2709,
+    361.0461, 364.8322, 368.6529, 372.4196, 376.212, 380.0173, 383.8035, 387.6111,
+    391.4408, 395.3685, 399.1533, 402.9676, 406.831, 410.728, 414.5478, 418.4506,
+    422.3656, 426.2368, 430.1891, 434.094, 437.8919, 441.862, 445.7356, 449.6936,
+    453.6031, 457.5175, 461.5111, 465.4073, 469.364, 473.2515, 477.1458, 481.1086,
+    484.9977, 488.9774, 492.953, 496.8589, 500.7592, 504.7334, 508.786, 512.7437,
+    516.6143, 520.5536, 524.5016, 528.5231, 532.457, 536.4511, 540.517, 544.4418,
+    548.4001, 552.4118, 556.3845, 560.3791, 564.2935, 568.2471, 572.154, 576.1206,
+    580.1373, 584.1387, 588.0028, 592.0213, 595.9916, 600.0302, 604.0073, 607.9676,
+    611.941, 615.9945, 620.0031, 624.0222, 628.0238, 632.0416, 636.1131};
+
+static const double kHllBiasData7[] = {
+    91.0336, 89.4811, 87.438, 85.4313, 83.4474, 81.4957, 79.5656, 77.6728, 75.8064,
+    73.969, 72.1574, 70.3793, 68.64, 66.9228, 65.2212, 63.5687, 61.9282, 60.3157,
+    58.7519, 57.2041, 55.6847, 54.1972, 52.7294, 51.2828, 49.8771, 48.4937, 47.1237,
+    45.8066, 44.5028, 43.2246, 42.0008, 40.7767, 39.5952, 38.453, 37.3004, 36.1976,
+    35.1226, 34.077, 33.0187, 31.9816, 30.9757, 29.9933, 29.045, 28.1369, 27.2492,
+    26.3681, 25.4962, 24.648, 23.8215, 23.0544, 22.3033, 21.5644, 20.8327, 20.1223,
+    19.4408, 18.7577, 18.0961, 17.4335, 16.8255, 16.2254, 15.6333, 15.0594, 14.5071,
+    13.9921, 13.469, 12.9977, 12.5194, 12.0883, 11.6766, 11.2854, 10.8169, 10.4076,
+    10.0148, 9.6087, 9.2635, 8.9202, 8.5895, 8.2499, 7.9021, 7.6049, 7.2477, 6.9286,
+    6.6608, 6.4432, 6.1897, 5.9416, 5.7272, 5.5216, 5.2709, 5.0461, 4.8322, 4.6529,
+    4.4196, 4.212, 4.0173, 3.8035, 3.6111, 3.4408, 3.3685, 3.1533, 2.9676, 2.831, 2.728,
+    2.5478, 2.4506, 2.3656, 2.2368, 2.1891, 2.094, 1.8919, 1.862, 1.7356, 1.6936, 1.6031,
+    1.5175, 1.5111, 1.4073, 1.364, 1.2515, 1.1458, 1.1086, 0.9977, 0.9774, 0.953, 0.8589,
+    0.7592, 0.7334, 0.786, 0.7437, 0.6143, 0.5536, 0.5016, 0.5231, 0.457, 0.4511, 0.517,
+    0.4418, 0.4001, 0.4118, 0.3845, 0.3791, 0.2935, 0.2471, 0.154, 0.1206, 0.1373,
+    0.1387, 0.0028, 0.0213, -0.0084, 0.0302, 0.0073, -0.0324, -0.059, -0.0055, 0.0031,
+    0.0222, 0.0238, 0.0416, 0.1131};
+
+static const double kHllRawEstimateData8[] = {
+    184.3576, 187.2547, 190.6806, 194.1518, 197.6699, 201.2283, 204.8299, 208.4775,
+    212.1682, 215.9088, 219.6817, 223.5169, 227.3865, 231.2896, 235.2425, 239.2347,
+    243.2774, 247.366, 251.5046, 255.686, 259.9045, 264.1853, 268.4766, 272.8205,
+    277.2126, 281.6544, 286.1347, 290.6558, 295.2324, 299.835, 304.481, 309.1799,
+    313.9072, 318.6588, 323.4858, 328.3303, 333.2094, 338.1262, 343.0713, 348.0912,
+    353.1376, 358.2273, 363.3286, 368.5112, 373.7024, 378.9649, 384.2173, 389.5121,
+    394.8811, 400.2524, 405.6913, 411.1293, 416.6236, 422.1389, 427.6409, 433.1863,
+    438.8538, 444.4386, 450.1029, 455.7887, 461.5676, 467.3322, 473.1014, 478.8788,
+    484.7355, 490.5813, 496.4818, 502.4178, 508.3599, 514.3248, 520.3543, 526.3979,
+    532.48, 538.6304, 544.7287, 550.8591, 557.0693, 563.2886, 569.4788, 575.7184,
+    581.9835, 588.2032, 594.4854, 600.7563, 607.0871, 613.4439, 619.8356, 626.2053,
+    632.6061, 639.0531, 645.5307, 651.9926, 658.4513, 664.8721, 671.3843, 677.927,
+    684.4304, 691.0341, 697.604, 704.1888, 710.7654, 717.413, 724.0274, 730.6764,
+    737.3395, 744.011, 750.6774, 757.3081, 763.9927, 770.6706, 777.3007, 784.0532,
+    790.797, 797.5276, 804.2673, 810.9914, 817.72, 824.5029, 831.296, 838.0777, 844.9216,
+    851.7901, 858.5786, 865.4136, 872.2858, 879.138, 885.9347, 892.8144, 899.6688,
+    906.5882, 913.4852, 920.3419, 927.2281, 934.1987, 941.1696, 947.9923, 954.9512,
+    961.7835, 968.7879, 975.7388, 982.6158, 989.499, 996.3073, 1003.2739, 1010.227,
+    1017.2005, 1024.0436, 1030.9741, 1037.9137, 1044.8507, 1051.7656, 1058.7331,
+    1065.6117, 1072.5058, 1079.3774, 1086.3471, 1093.3005, 1100.3272, 1107.3005,
+    1114.237, 1121.2142, 1128.2077, 1135.24, 1142.2389, 1149.116, 1156.059, 1163.0017,
+    1170.0077, 1176.8211, 1183.7679, 1190.7823, 1197.823, 1204.935, 1211.8832, 1218.8968,
+    1225.8979, 1232.9012, 1239.9096, 1247.0521, 1253.9827, 1260.8404, 1267.8462,
+    1274.8882};
+
+static const double kHllBiasData8[] = {
+    183.3576, 180.2547, 176.6806, 173.1518, 169.6699, 166.2283, 162.8299, 159.4775,
+    156.1682, 152.9088, 149.6817, 146.5169, 143.3865, 140.2896, 137.2425, 134.2347,
+    131.2774, 128.366, 125.5046, 122.686, 119.9045, 117.1853, 114.4766, 111.8205,
+    109.2126, 106.6544, 104.1347, 101.6558, 99.2324, 96.835, 94.481, 92.1799, 89.9072,
+    87.6588, 85.4858, 83.3303, 81.2094, 79.1262, 77.0713, 75.0912, 73.1376, 71.2273,
+    69.3286, 67.5112, 65.7024, 63.9649, 62.2173, 60.5121, 58.8811, 57.2524, 55.6913,
+    54.1293, 52.6236, 51.1389, 49.6409, 48.1863, 46.8538, 45.4386, 44.1029, 42.7887,
+    41.5676, 40.3322, 39.1014, 37.8788, 36.7355, 35.5813, 34.4818, 33.4178, 32.3599,
+    31.3248, 30.3543, 29.3979, 28.48, 27.6304, 26.7287, 25.8591, 25.0693, 24.2886,
+    23.4788, 22.7184, 21.9835, 21.2032, 20.4854, 19.7563, 19.0871, 18.4439, 17.8356,
+    17.2053, 16.6061, 16.0531, 15.5307, 14.9926, 14.4513, 13.8721, 13.3843, 12.927,
+    12.4304, 12.0341, 11.604, 11.1888, 10.7654, 10.413, 10.0274, 9.6764, 9.3395, 9.011,
+    8.6774, 8.3081, 7.9927, 7.6706, 7.3007, 7.0532, 6.797, 6.5276, 6.2673, 5.9914, 5.72,
+    5.5029, 5.296, 5.0777, 4.9216, 4.7901, 4.5786, 4.4136, 4.2858, 4.138, 3.9347, 3.8144,
+    3.6688, 3.5882, 3.4852, 3.3419, 3.2281, 3.1987, 3.1696, 2.9923, 2.9512, 2.7835,
+    2.7879, 2.7388, 2.6158, 2.499, 2.3073, 2.2739, 2.227, 2.2005, 2.0436, 1.9741, 1.9137,
+    1.8507, 1.7656, 1.7331, 1.6117, 1.5058, 1.3774, 1.3471, 1.3005, 1.3272, 1.3005,
+    1.237, 1.2142, 1.2077, 1.24, 1.2389, 1.116, 1.059, 1.0017, 1.0077, 0.8211, 0.7679,
+    0.7823, 0.823, 0.935, 0.8832, 0.8968, 0.8979, 0.9012, 0.9096, 1.0521, 0.9827, 0.8404,
+    0.8462, 0.8882};
+
+static const double kHllRawEstimateData9[] = {
+    369.0101, 374.7987, 381.1556, 387.5955, 394.1133, 400.7153, 407.3639, 414.1164,
+    420.9169, 427.7915, 434.747, 441.7957, 448.8988, 456.1056, 463.3761, 470.7102,
+    478.114, 485.5978, 493.1812, 500.8407, 508.5472, 516.3483, 524.2156, 532.1788,
+    540.2032, 548.2854, 556.4149, 564.6353, 572.9462, 581.2978, 589.7727, 598.245,
+    606.8491, 615.521, 624.2714, 633.1361, 642.0543, 651.0163, 660.0232, 669.1722,
+    678.3884, 687.6333, 696.9475, 706.3109, 715.679, 725.1851, 734.8172, 744.4621,
+    754.1843, 764.0008, 773.7942, 783.7231, 793.6867, 803.6945, 813.7145, 823.8238,
+    834.0608, 844.3717, 854.6362, 864.9711, 875.3865, 885.9039, 896.4967, 907.0025,
+    917.6099, 928.3908, 939.0951, 949.8629, 960.6774, 971.5437, 982.4282, 993.2231,
+    1004.3182, 1015.3765, 1026.557, 1037.7372, 1048.9195, 1060.1288, 1071.4787, 1082.734,
+    1094.1368, 1105.4798, 1116.8887, 1128.3828, 1140.1429, 1151.801, 1163.431, 1175.0906,
+    1186.7923, 1198.4111, 1210.1344, 1221.8316, 1233.6871, 1245.5451, 1257.3764,
+    1269.3052, 1281.3882, 1293.3494, 1305.3347, 1317.3868, 1329.3706, 1341.4797,
+    1353.7143, 1365.8523, 1378.0455, 1390.2169, 1402.4447, 1414.78, 1426.9855, 1439.1637,
+    1451.4924, 1463.7555, 1476.0173, 1488.3594, 1500.6721, 1513.0741, 1525.5254,
+    1538.1461, 1550.8274, 1563.3855, 1575.8213, 1588.1872, 1600.6649, 1613.1695,
+    1625.7742, 1638.208, 1650.672, 1663.3314, 1676.0452, 1688.797, 1701.2897, 1713.9769,
+    1726.4859, 1738.946, 1751.6533, 1764.4103, 1777.1492, 1789.9645, 1802.6439,
+    1815.2866, 1827.9083, 1840.5734, 1853.3925, 1866.1375, 1879.1746, 1891.9284,
+    1904.6168, 1917.5272, 1930.0766, 1942.8999, 1955.8815, 1968.6171, 1981.3911,
+    1994.1108, 2006.9821, 2019.9357, 2032.9044, 2045.6429, 2058.5979, 2071.3476,
+    2084.1364, 2097.2163, 2109.966, 2122.7078, 2135.4724, 2148.3114, 2161.1351, 2174.131,
+    2187.1022, 2199.9098, 2212.9058, 2225.7509, 2238.3211, 2251.3867, 2264.3553,
+    2276.8701, 2289.9583, 2302.709, 2315.4497, 2328.3292, 2341.2989, 2354.412, 2367.2534,
+    2380.3205, 2393.3433, 2406.3894, 2418.9979, 2431.8994, 2444.818, 2457.6975,
+    2470.8758, 2483.8523, 2497.1183, 2510.0099, 2523.178, 2536.3395, 2549.4775};
+
+static const double kHllBiasData9[] = {
+    368.0101, 361.7987, 355.1556, 348.5955, 342.1133, 335.7153, 329.3639, 323.1164,
+    316.9169, 310.7915, 304.747, 298.7957, 292.8988, 287.1056, 281.3761, 275.7102,
+    270.114, 264.5978, 259.1812, 253.8407, 248.5472, 243.3483, 238.2156, 233.1788,
+    228.2032, 223.2854, 218.4149, 213.6353, 208.9462, 204.2978, 199.7727, 195.245,
+    190.8491, 186.521, 182.2714, 178.1361, 174.0543, 170.0163, 166.0232, 162.1722,
+    158.3884, 154.6333, 150.9475, 147.3109, 143.679, 140.1851, 136.8172, 133.4621,
+    130.1843, 127.0008, 123.7942, 120.7231, 117.6867, 114.6945, 111.7145, 108.8238,
+    106.0608, 103.3717, 100.6362, 97.9711, 95.3865, 92.9039, 90.4967, 88.0025, 85.6099,
+    83.3908, 81.0951, 78.8629, 76.6774, 74.5437, 72.4282, 70.2231, 68.3182, 66.3765,
+    64.557, 62.7372, 60.9195, 59.1288, 57.4787, 55.734, 54.1368, 52.4798, 50.8887,
+    49.3828, 48.1429, 46.801, 45.431, 44.0906, 42.7923, 41.4111, 40.1344, 38.8316,
+    37.6871, 36.5451, 35.3764, 34.3052, 33.3882, 32.3494, 31.3347, 30.3868, 29.3706,
+    28.4797, 27.7143, 26.8523, 26.0455, 25.2169, 24.4447, 23.78, 22.9855, 22.1637,
+    21.4924, 20.7555, 20.0173, 19.3594, 18.6721, 18.0741, 17.5254, 17.1461, 16.8274,
+    16.3855, 15.8213, 15.1872, 14.6649, 14.1695, 13.7742, 13.208, 12.672, 12.3314,
+    12.0452, 11.797, 11.2897, 10.9769, 10.4859, 9.946, 9.6533, 9.4103, 9.1492, 8.9645,
+    8.6439, 8.2866, 7.9083, 7.5734, 7.3925, 7.1375, 7.1746, 6.9284, 6.6168, 6.5272,
+    6.0766, 5.8999, 5.8815, 5.6171, 5.3911, 5.1108, 4.9821, 4.9357, 4.9044, 4.6429,
+    4.5979, 4.3476, 4.1364, 4.2163, 3.966, 3.7078, 3.4724, 3.3114, 3.1351, 3.131, 3.1022,
+    2.9098, 2.9058, 2.7509, 2.3211, 2.3867, 2.3553, 1.8701, 1.9583, 1.709, 1.4497,
+    1.3292, 1.2989, 1.412, 1.2534, 1.3205, 1.3433, 1.3894, 0.9979, 0.8994, 0.818, 0.6975,
+    0.8758, 0.8523, 1.1183, 1.0099, 1.178, 1.3395, 1.4775};
+
+static const double kHllRawEstimateData10[] = {
+    738.3134, 750.4092, 763.1381, 776.0081, 789.0287, 802.1936, 815.5075, 828.9837,
+    842.6112, 856.3997, 870.311, 884.4029, 898.6552, 913.0351, 927.6051, 942.2889,
+    957.0944, 972.1197, 987.2435, 1002.5531, 1018.0813, 1033.6812, 1049.4202, 1065.3133,
+    1081.3561, 1097.5389, 1113.9311, 1130.3775, 1147.0721, 1163.828, 1180.7595,
+    1197.9164, 1215.0941, 1232.5374, 1250.049, 1267.694, 1285.3909, 1303.348, 1321.4131,
+    1339.6116, 1357.8973, 1376.2463, 1394.9563, 1413.6959, 1432.5971, 1451.5514,
+    1470.7447, 1489.9712, 1509.4314, 1528.9301, 1548.5648, 1568.3831, 1588.3167,
+    1608.3402, 1628.4225, 1648.5708, 1668.878, 1689.3554, 1709.9202, 1730.7469,
+    1751.6255, 1772.5625, 1793.7391, 1814.6653, 1836.0813, 1857.3744, 1878.8608,
+    1900.4534, 1922.2301, 1944.0293, 1965.7337, 1987.6244, 2009.74, 2031.7721, 2053.8381,
+    2076.25, 2098.6234, 2121.1377, 2143.842, 2166.368, 2188.8781, 2211.7329, 2234.5952,
+    2257.4072, 2280.5954, 2303.7003, 2326.7, 2349.9958, 2373.2125, 2396.4414, 2420.0411,
+    2443.6419, 2467.3421, 2491.0463, 2514.6604, 2538.5124, 2562.4133, 2586.4338,
+    2610.5148, 2634.6371, 2658.602, 2682.5765, 2706.6596, 2731.2054, 2755.1863,
+    2779.4105, 2803.9499, 2828.2133, 2852.8594, 2877.1236, 2901.7821, 2926.2358,
+    2951.0381, 2975.6732, 3000.3767, 3025.3994, 3050.4941, 3075.4731, 3100.6854,
+    3125.6144, 3150.7496, 3175.9076, 3201.1666, 3226.2996, 3251.2543, 3276.3263,
+    3301.3512, 3326.4639, 3351.6131, 3377.1259, 3401.9713, 3427.4207, 3452.7832,
+    3478.0282, 3503.4979, 3528.6986, 3554.0621, 3579.701, 3604.8979, 3630.2483,
+    3655.8557, 3681.1764, 3706.6188, 3732.0018, 3757.49, 3783.1427, 3808.6839, 3834.2179,
+    3859.5793, 3884.8223, 3910.4824, 3936.1959, 3961.8733, 3987.362, 4013.1182,
+    4038.5093, 4063.9748, 4089.8076, 4115.338, 4140.9188, 4166.8023, 4192.631, 4218.4598,
+    4244.2189, 4269.871, 4295.8693, 4321.4895, 4347.21, 4373.049, 4398.6819, 4424.6319,
+    4450.2873, 4476.1536, 4501.9718, 4527.8007, 4553.3119, 4579.4105, 4605.4057,
+    4631.2978, 4657.4607, 4683.2891, 4709.0776, 4734.8387, 4760.3831, 4786.4164,
+    4812.1543, 4837.8857, 4863.6666, 4889.7947, 4915.8433, 4941.5377, 4967.2897,
+    4992.7822, 5018.3121, 5044.4545, 5070.1668, 5096.1975};
+
+static const double kHllBiasData10[] = {
+    737.3134, 724.4092, 711.1381, 698.0081, 685.0287, 672.1936, 659.5075, 646.9837,
+    634.6112, 622.3997, 610.311, 598.4029, 586.6552, 575.0351, 563.6051, 552.2889,
+    541.0944, 530.1197, 519.2435, 508.5531, 498.0813, 487.6812, 477.4202, 467.3133,
+    457.3561, 447.5389, 437.9311, 428.3775, 419.0721, 409.828, 400.7595, 391.9164,
+    383.0941, 374.5374, 366.049, 357.694, 349.3909, 341.348, 333.4131, 325.6116,
+    317.8973, 310.2463, 302.9563, 295.6959, 288.5971, 281.5514, 274.7447, 267.9712,
+    261.4314, 254.9301, 248.5648, 242.3831, 236.3167, 230.3402, 224.4225, 218.5708,
+    212.878, 207.3554, 201.9202, 196.7469, 191.6255, 186.5625, 181.7391, 176.6653,
+    172.0813, 167.3744, 162.8608, 158.4534, 154.2301, 150.0293, 145.7337, 141.6244,
+    137.74, 133.7721, 129.8381, 126.25, 122.6234, 119.1377, 115.842, 112.368, 108.8781,
+    105.7329, 102.5952, 99.4072, 96.5954, 93.7003, 90.7, 87.9958, 85.2125, 82.4414,
+    80.0411, 77.6419, 75.3421, 73.0463, 70.6604, 68.5124, 66.4133, 64.4338, 62.5148,
+    60.6371, 58.602, 56.5765, 54.6596, 53.2054, 51.1863, 49.4105, 47.9499, 46.2133,
+    44.8594, 43.1236, 41.7821, 40.2358, 39.0381, 37.6732, 36.3767, 35.3994, 34.4941,
+    33.4731, 32.6854, 31.6144, 30.7496, 29.9076, 29.1666, 28.2996, 27.2543, 26.3263,
+    25.3512, 24.4639, 23.6131, 23.1259, 21.9713, 21.4207, 20.7832, 20.0282, 19.4979,
+    18.6986, 18.0621, 17.701, 16.8979, 16.2483, 15.8557, 15.1764, 14.6188, 14.0018,
+    13.49, 13.1427, 12.6839, 12.2179, 11.5793, 10.8223, 10.4824, 10.1959, 9.8733, 9.362,
+    9.1182, 8.5093, 7.9748, 7.8076, 7.338, 6.9188, 6.8023, 6.631, 6.4598, 6.2189, 5.871,
+    5.8693, 5.4895, 5.21, 5.049, 4.6819, 4.6319, 4.2873, 4.1536, 3.9718, 3.8007, 3.3119,
+    3.4105, 3.4057, 3.2978, 3.4607, 3.2891, 3.0776, 2.8387, 2.3831, 2.4164, 2.1543,
+    1.8857, 1.6666, 1.7947, 1.8433, 1.5377, 1.2897, 0.7822, 0.3121, 0.4545, 0.1668,
+    0.1975};
+
+static const double kHllRawEstimateData11[] = {
+    1476.9251, 1501.5795, 1527.012, 1552.7534, 1578.8266, 1605.1784, 1631.8583,
+    1658.8125, 1686.0754, 1713.6541, 1741.5832, 1769.7487, 1798.251, 1827.0435,
+    1856.1833, 1885.5382, 1915.2523, 1945.3008, 1975.5689, 2006.1779, 2037.1131,
+    2068.3194, 2099.8521, 2131.6848, 2163.8718, 2196.2203, 2228.939, 2261.955, 2295.1028,
+    2328.6836, 2362.5975, 2396.8421, 2431.3066, 2466.0856, 2501.2249, 2536.5488,
+    2572.1532, 2607.9442, 2643.9752, 2680.5641, 2717.1973, 2754.2067, 2791.3243,
+    2828.6689, 2866.4184, 2904.5661, 2942.8842, 2981.4574, 3020.2053, 3059.358,
+    3098.6575, 3137.9687, 3177.6687, 3217.7339, 3257.9502, 3298.4749, 3339.1519,
+    3380.0206, 3421.3402, 3463.0397, 3504.8374, 3546.6483, 3588.7402, 3631.1275,
+    3673.558, 3716.1856, 3759.2516, 3802.168, 3845.453, 3888.784, 3932.4626, 3976.29,
+    4020.1207, 4064.2734, 4108.7368, 4153.497, 4198.1482, 4243.0157, 4287.9802,
+    4333.1947, 4378.7132, 4424.3359, 4469.9706, 4515.9578, 4561.9496, 4608.0386,
+    4654.3586, 4700.8721, 4747.3484, 4794.163, 4841.2805, 4888.168, 4935.3906, 4982.5935,
+    5030.0253, 5077.6257, 5125.0511, 5172.347, 5220.3178, 5268.2119, 5316.5559,
+    5364.7644, 5413.1833, 5461.6839, 5510.1581, 5558.7724, 5607.5113, 5656.398,
+    5705.0082, 5754.0496, 5802.9496, 5851.9713, 5901.1983, 5950.5006, 6000.2229,
+    6049.7186, 6099.548, 6149.5392, 6198.871, 6248.947, 6298.9127, 6348.6789, 6399.0082,
+    6448.6571, 6498.4884, 6548.6785, 6598.6671, 6649.0621, 6699.1959, 6749.7585,
+    6800.0968, 6850.4914, 6901.1431, 6951.8313, 7002.4057, 7052.6986, 7103.4169,
+    7153.8607, 7205.0217, 7256.2128, 7307.3161, 7358.2582, 7408.983, 7460.2866,
+    7511.8616, 7563.0482, 7614.3232, 7666.0315, 7717.7701, 7769.2286, 7820.2984,
+    7871.7472, 7922.8678, 7973.66, 8024.8366, 8076.1211, 8127.817, 8179.0013, 8230.9425,
+    8282.1425, 8333.6868, 8385.5717, 8436.8511, 8488.5095, 8540.0703, 8591.6232,
+    8643.1577, 8694.3636, 8745.9899, 8796.9187, 8848.6929, 8900.3558, 8951.7624,
+    9003.4159, 9055.622, 9107.0601, 9158.955, 9210.0982, 9261.7466, 9313.5436, 9365.2594,
+    9417.1559, 9468.6331, 9520.7119, 9572.5671, 9624.0243, 9675.7015, 9727.5248,
+    9779.4359, 9831.7117, 9883.4208, 9935.1202, 9987.1085, 10038.9674, 10090.4563,
+    10142.4868, 10194.347};
+
+static const double kHllBiasData11[] = {
+    1475.9251, 1449.5795, 1423.012, 1396.7534, 1370.8266, 1345.1784, 1319.8583,
+    1294.8125, 1270.0754, 1245.6541, 1221.5832, 1197.7487, 1174.251, 1151.0435,
+    1128.1833, 1105.5382, 1083.2523, 1061.3008, 1039.5689, 1018.1779, 997.1131, 976.3194,
+    955.8521, 935.6848, 915.8718, 896.2203, 876.939, 857.955, 839.1028, 820.6836,
+    802.5975, 784.8421, 767.3066, 750.0856, 733.2249, 716.5488, 700.1532, 683.9442,
+    667.9752, 652.5641, 637.1973, 622.2067, 607.3243, 592.6689, 578.4184, 564.5661,
+    550.8842, 537.4574, 524.2053, 511.358, 498.6575, 485.9687, 473.6687, 461.7339,
+    449.9502, 438.4749, 427.1519, 416.0206, 405.3402, 395.0397, 384.8374, 374.6483,
+    364.7402, 355.1275, 345.558, 336.1856, 327.2516, 318.168, 309.453, 300.784, 292.4626,
+    284.29, 276.1207, 268.2734, 260.7368, 253.497, 246.1482, 239.0157, 231.9802,
+    225.1947, 218.7132, 212.3359, 205.9706, 199.9578, 193.9496, 188.0386, 182.3586,
+    176.8721, 171.3484, 166.163, 161.2805, 156.168, 151.3906, 146.5935, 142.0253,
+    137.6257, 133.0511, 128.347, 124.3178, 120.2119, 116.5559, 112.7644, 109.1833,
+    105.6839, 102.1581, 98.7724, 95.5113, 92.398, 89.0082, 86.0496, 82.9496, 79.9713,
+    77.1983, 74.5006, 72.2229, 69.7186, 67.548, 65.5392, 62.871, 60.947, 58.9127,
+    56.6789, 55.0082, 52.6571, 50.4884, 48.6785, 46.6671, 45.0621, 43.1959, 41.7585,
+    40.0968, 38.4914, 37.1431, 35.8313, 34.4057, 32.6986, 31.4169, 29.8607, 29.0217,
+    28.2128, 27.3161, 26.2582, 24.983, 24.2866, 23.8616, 23.0482, 22.3232, 22.0315,
+    21.7701, 21.2286, 20.2984, 19.7472, 18.8678, 17.66, 16.8366, 16.1211, 15.817,
+    15.0013, 14.9425, 14.1425, 13.6868, 13.5717, 12.8511, 12.5095, 12.0703, 11.6232,
+    11.1577, 10.3636, 9.9899, 8.9187, 8.6929, 8.3558, 7.7624, 7.4159, 7.622, 7.0601,
+    6.955, 6.0982, 5.7466, 5.5436, 5.2594, 5.1559, 4.6331, 4.7119, 4.5671, 4.0243,
+    3.7015, 3.5248, 3.4359, 3.7117, 3.4208, 3.1202, 3.1085, 2.9674, 2.4563, 2.4868,
+    2.347};
+
+static const double kHllRawEstimateData12[] = {
+    2954.1506, 3003.4477, 3053.8602, 3104.8514, 3156.4749, 3208.6838, 3261.4845,
+    3314.8811, 3368.8729, 3423.4174, 3478.6074, 3534.3797, 3590.8057, 3647.8322,
+    3705.3604, 3763.5053, 3822.3335, 3881.7977, 3941.7684, 4002.3541, 4063.496,
+    4125.2182, 4187.4998, 4250.2889, 4313.8111, 4377.995, 4442.5369, 4507.7531,
+    4573.5312, 4639.9487, 4706.9922, 4774.6992, 4842.7433, 4911.416, 4980.6292,
+    5050.3296, 5120.6375, 5191.5547, 5263.0967, 5334.9738, 5407.2945, 5480.3204,
+    5553.7608, 5627.8081, 5702.4102, 5777.4819, 5852.9593, 5929.0367, 6005.6541,
+    6082.5399, 6159.9903, 6238.1097, 6316.6113, 6395.5893, 6475.0834, 6554.8084,
+    6635.1649, 6716.0018, 6797.2016, 6879.0198, 6961.2527, 7043.6742, 7126.5982,
+    7209.9967, 7293.7858, 7377.9492, 7462.7423, 7547.659, 7632.8789, 7718.4686,
+    7804.6452, 7891.2945, 7978.3875, 8065.8849, 8153.8161, 8242.0152, 8330.7123,
+    8419.4087, 8508.3871, 8597.6518, 8687.5185, 8777.6753, 8867.9953, 8958.9439,
+    9050.2414, 9141.5591, 9232.9915, 9324.9631, 9416.7032, 9509.0884, 9601.889,
+    9694.5935, 9787.6919, 9881.2686, 9974.875, 10069.245, 10163.5825, 10258.0159,
+    10352.4973, 10447.6317, 10542.6858, 10637.771, 10733.6655, 10829.5517, 10925.7361,
+    11021.6544, 11117.6257, 11214.5711, 11310.7864, 11407.713, 11505.0244, 11602.9667,
+    11700.2306, 11798.1132, 11895.6801, 11993.466, 12091.7188, 12189.3726, 12287.4569,
+    12386.4032, 12485.0418, 12583.173, 12682.366, 12780.9171, 12879.7457, 12979.3023,
+    13078.7093, 13178.3685, 13278.2691, 13377.4553, 13477.2069, 13576.9181, 13677.512,
+    13777.8362, 13877.7859, 13978.044, 14077.828, 14178.0993, 14278.8412, 14379.7238,
+    14480.1856, 14581.8482, 14682.02, 14783.4736, 14884.3061, 14984.856, 15085.8915,
+    15186.9534, 15288.0167, 15389.3805, 15490.4076, 15591.8719, 15693.0974, 15794.673,
+    15895.7533, 15996.9516, 16098.8969, 16200.844, 16302.7782, 16404.8389, 16507.0039,
+    16609.448, 16711.6199, 16813.2921, 16915.6241, 17017.2771, 17119.0642, 17220.8406,
+    17322.7427, 17424.4957, 17527.3272, 17629.4661, 17731.6385, 17834.0913, 17936.066,
+    18038.5109, 18141.3361, 18243.7079, 18346.3315, 18448.9538, 18551.563, 18654.7468,
+    18757.5276, 18860.077, 18962.5715, 19065.2062, 19167.4021, 19269.0802, 19372.1248,
+    19475.2313, 19577.1837, 19680.4147, 19783.5975, 19886.3527, 19989.0763, 20092.0401,
+    20194.476, 20297.0069, 20399.2265};
+
+static const double kHllBiasData12[] = {
+    2953.1506, 2900.4477, 2847.8602, 2795.8514, 2744.4749, 2693.6838, 2643.4845,
+    2593.8811, 2544.8729, 2496.4174, 2448.6074, 2401.3797, 2354.8057, 2308.8322,
+    2263.3604, 2218.5053, 2174.3335, 2130.7977, 2087.7684, 2045.3541, 2003.496,
+    1962.2182, 1921.4998, 1881.2889, 1841.8111, 1802.995, 1764.5369, 1726.7531,
+    1689.5312, 1652.9487, 1616.9922, 1581.6992, 1546.7433, 1512.416, 1478.6292,
+    1445.3296, 1412.6375, 1380.5547, 1349.0967, 1317.9738, 1287.2945, 1257.3204,
+    1227.7608, 1198.8081, 1170.4102, 1142.4819, 1114.9593, 1088.0367, 1061.6541,
+    1035.5399, 1009.9903, 985.1097, 960.6113, 936.5893, 913.0834, 889.8084, 867.1649,
+    845.0018, 823.2016, 802.0198, 781.2527, 760.6742, 740.5982, 720.9967, 701.7858,
+    682.9492, 664.7423, 646.659, 628.8789, 611.4686, 594.6452, 578.2945, 562.3875,
+    546.8849, 531.8161, 517.0152, 502.7123, 488.4087, 474.3871, 460.6518, 447.5185,
+    434.6753, 421.9953, 409.9439, 398.2414, 386.5591, 374.9915, 363.9631, 352.7032,
+    342.0884, 331.889, 321.5935, 311.6919, 302.2686, 292.875, 284.245, 275.5825,
+    267.0159, 258.4973, 250.6317, 242.6858, 234.771, 227.6655, 220.5517, 213.7361,
+    206.6544, 199.6257, 193.5711, 186.7864, 180.713, 175.0244, 169.9667, 164.2306,
+    159.1132, 153.6801, 148.466, 143.7188, 138.3726, 133.4569, 129.4032, 125.0418,
+    120.173, 116.366, 111.9171, 107.7457, 104.3023, 100.7093, 97.3685, 94.2691, 90.4553,
+    87.2069, 83.9181, 81.512, 78.8362, 75.7859, 73.044, 69.828, 67.0993, 64.8412,
+    62.7238, 60.1856, 58.8482, 56.02, 54.4736, 52.3061, 49.856, 47.8915, 45.9534,
+    44.0167, 42.3805, 40.4076, 38.8719, 37.0974, 35.673, 33.7533, 31.9516, 30.8969,
+    29.844, 28.7782, 27.8389, 27.0039, 26.448, 25.6199, 24.2921, 23.6241, 22.2771,
+    21.0642, 19.8406, 18.7427, 17.4957, 17.3272, 16.4661, 15.6385, 15.0913, 14.066,
+    13.5109, 13.3361, 12.7079, 12.3315, 11.9538, 11.563, 11.7468, 11.5276, 11.077,
+    10.5715, 10.2062, 9.4021, 8.0802, 8.1248, 8.2313, 7.1837, 7.4147, 7.5975, 7.3527,
+    7.0763, 7.0401, 6.476, 6.0069, 5.2265};
+
+static const double kHllRawEstimateData13[] = {
+    5908.5937, 6007.3431, 6107.7596, 6209.2415, 6311.9409, 6415.8534, 6521.0482,
+    6627.2894, 6734.6933, 6843.2894, 6953.0796, 7064.0444, 7176.3061, 7289.7824, 7404.2,
+    7520.0468, 7637.0615, 7755.051, 7874.142, 7994.8392, 8116.6624, 8239.3082, 8363.2831,
+    8488.4333, 8614.6914, 8741.8065, 8870.3098, 8999.8723, 9130.405, 9262.3074,
+    9395.3811, 9529.5569, 9664.9063, 9801.0399, 9938.7164, 10077.0403, 10216.452,
+    10357.4428, 10499.0778, 10642.1068, 10786.202, 10931.032, 11077.164, 11224.808,
+    11372.761, 11521.6415, 11671.6046, 11822.7735, 11975.0098, 12128.5533, 12282.8794,
+    12438.1525, 12594.5809, 12751.3054, 12909.3142, 13068.1678, 13228.0778, 13388.8525,
+    13551.0027, 13713.3729, 13876.0857, 14039.9101, 14204.8704, 14370.5755, 14537.009,
+    14704.0601, 14872.2976, 15041.6656, 15211.7903, 15382.8914, 15554.7515, 15727.0643,
+    15900.4869, 16073.4343, 16247.8772, 16423.4302, 16598.6945, 16774.2544, 16951.3925,
+    17129.1002, 17307.8312, 17487.1659, 17667.0681, 17847.0917, 18028.0234, 18209.6279,
+    18393.6538, 18577.1585, 18760.6383, 18943.0885, 19127.5334, 19312.904, 19498.4413,
+    19683.9789, 19869.8099, 20056.8717, 20244.2147, 20432.5189, 20621.2168, 20809.4562,
+    20998.0801, 21186.9707, 21376.8466, 21568.1379, 21758.0143, 21949.0673, 22140.0242,
+    22331.7418, 22523.789, 22716.3843, 22909.5768, 23103.1779, 23296.1489, 23491.0037,
+    23685.461, 23881.2268, 24076.6023, 24270.7029, 24466.3675, 24661.0603, 24857.0443,
+    25053.4241, 25248.2173, 25445.778, 25643.0868, 25840.3141, 26038.2364, 26236.1242,
+    26433.3751, 26630.9853, 26830.2374, 27029.5958, 27228.4677, 27428.111, 27627.7393,
+    27826.3131, 28026.0691, 28225.295, 28425.5687, 28625.3533, 28824.7898, 29025.4436,
+    29225.7678, 29425.8538, 29627.8101, 29828.8751, 30030.0177, 30230.8625, 30431.1127,
+    30632.7668, 30835.0983, 31038.2455, 31240.8062, 31442.1727, 31645.7147, 31848.6722,
+    32049.8416, 32251.6673, 32454.8953, 32655.9527, 32858.7059, 33061.6358, 33265.7269,
+    33469.5117, 33673.0332, 33877.2272, 34079.9105, 34282.4632, 34485.6228, 34690.1736,
+    34893.8022, 35095.7589, 35298.9809, 35503.2401, 35707.8678, 35912.0254, 36116.2366,
+    36319.2588, 36524.2114, 36727.9356, 36931.9063, 37134.5384, 37341.1092, 37544.2667,
+    37748.513, 37951.1747, 38155.7253, 38360.6736, 38563.8254, 38767.1642, 38970.0161,
+    39173.487, 39376.3762, 39580.7934, 39786.3031, 39992.0707, 40196.2133, 40401.0646,
+    40605.3031, 40810.2861};
+
+static const double kHllBiasData13[] = {
+    5907.5937, 5802.3431, 5697.7596, 5594.2415, 5491.9409, 5390.8534, 5291.0482,
+    5192.2894, 5094.6933, 4998.2894, 4903.0796, 4809.0444, 4716.3061, 4624.7824, 4534.2,
+    4445.0468, 4357.0615, 4270.051, 4184.142, 4099.8392, 4016.6624, 3934.3082, 3853.2831,
+    3773.4333, 3694.6914, 3616.8065, 3540.3098, 3464.8723, 3390.405, 3317.3074,
+    3245.3811, 3174.5569, 3104.9063, 3036.0399, 2968.7164, 2902.0403, 2836.452,
+    2772.4428, 2709.0778, 2647.1068, 2586.202, 2526.032, 2467.164, 2409.808, 2352.761,
+    2296.6415, 2241.6046, 2187.7735, 2135.0098, 2083.5533, 2032.8794, 1983.1525,
+    1934.5809, 1886.3054, 1839.3142, 1793.1678, 1748.0778, 1703.8525, 1661.0027,
+    1618.3729, 1576.0857, 1534.9101, 1494.8704, 1455.5755, 1417.009, 1379.0601,
+    1342.2976, 1306.6656, 1271.7903, 1237.8914, 1204.7515, 1172.0643, 1140.4869,
+    1108.4343, 1077.8772, 1048.4302, 1018.6945, 989.2544, 961.3925, 934.1002, 907.8312,
+    882.1659, 857.0681, 832.0917, 808.0234, 784.6279, 763.6538, 742.1585, 720.6383,
+    698.0885, 677.5334, 657.904, 638.4413, 618.9789, 599.8099, 581.8717, 564.2147,
+    547.5189, 531.2168, 514.4562, 498.0801, 481.9707, 466.8466, 453.1379, 438.0143,
+    424.0673, 410.0242, 396.7418, 383.789, 371.3843, 359.5768, 348.1779, 336.1489,
+    326.0037, 315.461, 306.2268, 296.6023, 285.7029, 276.3675, 266.0603, 257.0443,
+    248.4241, 238.2173, 230.778, 223.0868, 215.3141, 208.2364, 201.1242, 193.3751,
+    185.9853, 180.2374, 174.5958, 168.4677, 163.111, 157.7393, 151.3131, 146.0691,
+    140.295, 135.5687, 130.3533, 124.7898, 120.4436, 115.7678, 110.8538, 107.8101,
+    103.8751, 100.0177, 95.8625, 91.1127, 87.7668, 85.0983, 83.2455, 80.8062, 77.1727,
+    75.7147, 73.6722, 69.8416, 66.6673, 64.8953, 60.9527, 58.7059, 56.6358, 55.7269,
+    54.5117, 53.0332, 52.2272, 49.9105, 47.4632, 45.6228, 45.1736, 43.8022, 40.7589,
+    38.9809, 38.2401, 37.8678, 37.0254, 36.2366, 34.2588, 34.2114, 32.9356, 31.9063,
+    29.5384, 31.1092, 29.2667, 28.513, 26.1747, 25.7253, 25.6736, 23.8254, 22.1642,
+    20.0161, 18.487, 16.3762, 15.7934, 16.3031, 17.0707, 16.2133, 16.0646, 15.3031,
+    15.2861};
+
+static const double kHllRawEstimateData14[] = {
+    11817.4858, 12015.4496, 12216.2147, 12419.5003, 12624.9187, 12832.6397, 13042.6191,
+    13255.1433, 13470.2126, 13687.3452, 13907.3602, 14129.4119, 14353.8085, 14580.5177,
+    14809.4659, 15040.9594, 15274.7653, 15510.6578, 15749.1119, 15990.0007, 16233.2292,
+    16478.8217, 16726.8167, 16976.5446, 17229.2492, 17484.039, 17741.4022, 18000.8699,
+    18262.7476, 18526.8758, 18792.7653, 19060.8024, 19331.2207, 19603.6387, 19878.7858,
+    20156.0815, 20435.5361, 20716.999, 21001.1017, 21287.1475, 21575.6843, 21866.0111,
+    22158.238, 22452.8329, 22749.5593, 23047.242, 23347.7641, 23649.5388, 23953.5502,
+    24259.8485, 24567.9319, 24878.3808, 25189.8862, 25503.5805, 25819.2602, 26137.0382,
+    26456.5533, 26778.225, 27101.6443, 27425.4062, 27751.9384, 28079.0715, 28409.8784,
+    28741.91, 29074.9667, 29409.4363, 29745.732, 30082.9599, 30422.4338, 30763.9824,
+    31107.0724, 31450.6551, 31795.9427, 32142.7039, 32490.194, 32840.4937, 33192.0852,
+    33543.8886, 33898.0572, 34253.8457, 34609.6988, 34967.585, 35327.61, 35688.5461,
+    36049.6856, 36412.554, 36775.8035, 37141.7683, 37508.1036, 37875.5368, 38244.0385,
+    38613.2115, 38983.3785, 39354.768, 39727.5724, 40100.7268, 40475.1087, 40850.6608,
+    41228.3368, 41605.6325, 41982.7582, 42362.0786, 42742.6894, 43122.7159, 43506.2,
+    43887.7099, 44271.5725, 44656.7827, 45040.901, 45425.352, 45809.766, 46195.5702,
+    46583.3726, 46972.3192, 47362.3054, 47753.5638, 48143.5814, 48533.9666, 48925.198,
+    49317.1647, 49708.7186, 50100.589, 50494.6295, 50888.7232, 51283.6803, 51678.3481,
+    52073.6859, 52469.8837, 52866.1766, 53263.7236, 53662.9744, 54061.9172, 54458.8198,
+    54857.2436, 55256.4432, 55657.5908, 56056.3909, 56454.5984, 56856.5894, 57258.4484,
+    57658.4567, 58060.6069, 58461.3793, 58862.4901, 59264.4965, 59666.5599, 60070.7504,
+    60473.5425, 60877.3273, 61280.6581, 61684.7595, 62087.5908, 62490.1378, 62893.9028,
+    63298.3313, 63703.3086, 64107.5579, 64510.9543, 64913.614, 65318.8676, 65724.205,
+    66128.9575, 66532.1428, 66939.0675, 67343.0674, 67749.2884, 68155.1253, 68561.7603,
+    68965.7977, 69372.0523, 69778.956, 70187.7466, 70594.2144, 71001.166, 71407.7494,
+    71814.6672, 72219.389, 72627.0478, 73036.0604, 73444.5387, 73852.9173, 74261.4326,
+    74669.7482, 75077.9241, 75484.2633, 75891.342, 76297.2213, 76703.7523, 77112.8179,
+    77522.1764, 77931.3594, 78341.7346, 78750.5557, 79159.8258, 79570.6535, 79978.0125,
+    80388.6803, 80799.6858, 81206.3786, 81615.6113};
+
+static const double kHllBiasData14[] = {
+    11816.4858, 11605.4496, 11396.2147, 11189.5003, 10984.9187, 10782.6397, 10582.6191,
+    10385.1433, 10190.2126, 9997.3452, 9807.3602, 9619.4119, 9433.8085, 9250.5177,
+    9069.4659, 8890.9594, 8714.7653, 8540.6578, 8369.1119, 8200.0007, 8033.2292,
+    7868.8217, 7706.8167, 7546.5446, 7389.2492, 7234.039, 7081.4022, 6930.8699,
+    6782.7476, 6636.8758, 6492.7653, 6350.8024, 6211.2207, 6073.6387, 5938.7858,
+    5806.0815, 5675.5361, 5546.999, 5421.1017, 5297.1475, 5175.6843, 5056.0111, 4938.238,
+    4822.8329, 4709.5593, 4597.242, 4487.7641, 4379.5388, 4273.5502, 4169.8485,
+    4067.9319, 3968.3808, 3869.8862, 3773.5805, 3679.2602, 3587.0382, 3496.5533,
+    3408.225, 3321.6443, 3235.4062, 3151.9384, 3069.0715, 2989.8784, 2911.91, 2834.9667,
+    2759.4363, 2685.732, 2612.9599, 2542.4338, 2473.9824, 2407.0724, 2340.6551,
+    2275.9427, 2212.7039, 2150.194, 2090.4937, 2032.0852, 1973.8886, 1918.0572,
+    1863.8457, 1809.6988, 1757.585, 1707.61, 1658.5461, 1609.6856, 1562.554, 1515.8035,
+    1471.7683, 1428.1036, 1385.5368, 1344.0385, 1303.2115, 1263.3785, 1224.768,
+    1187.5724, 1150.7268, 1115.1087, 1080.6608, 1048.3368, 1015.6325, 982.7582, 952.0786,
+    922.6894, 892.7159, 866.2, 837.7099, 811.5725, 786.7827, 760.901, 735.352, 709.766,
+    685.5702, 663.3726, 642.3192, 622.3054, 603.5638, 583.5814, 563.9666, 545.198,
+    527.1647, 508.7186, 490.589, 474.6295, 458.7232, 443.6803, 428.3481, 413.6859,
+    399.8837, 386.1766, 373.7236, 362.9744, 351.9172, 338.8198, 327.2436, 316.4432,
+    307.5908, 296.3909, 284.5984, 276.5894, 268.4484, 258.4567, 250.6069, 241.3793,
+    232.4901, 224.4965, 216.5599, 210.7504, 203.5425, 197.3273, 190.6581, 184.7595,
+    177.5908, 170.1378, 163.9028, 158.3313, 153.3086, 147.5579, 140.9543, 133.614,
+    128.8676, 124.205, 118.9575, 112.1428, 109.0675, 103.0674, 99.2884, 95.1253, 91.7603,
+    85.7977, 82.0523, 78.956, 77.7466, 74.2144, 71.166, 67.7494, 64.6672, 59.389,
+    57.0478, 56.0604, 54.5387, 52.9173, 51.4326, 49.7482, 47.9241, 44.2633, 41.342,
+    37.2213, 33.7523, 32.8179, 32.1764, 31.3594, 31.7346, 30.5557, 29.8258, 30.6535,
+    28.0125, 28.6803, 29.6858, 26.3786, 25.6113};
+
+static const double kHllRawEstimateData15[] = {
+    23635.2599, 24031.3352, 24432.9971, 24839.2141, 25250.0565, 25665.7966, 26086.1262,
+    26510.7776, 26940.4913, 27374.8277, 27814.1313, 28257.8684, 28706.2375, 29159.9876,
+    29617.751, 30080.4694, 30548.4062, 31020.4934, 31496.8809, 31979.3933, 32465.8033,
+    32957.0466, 33452.8847, 33953.073, 34458.6519, 34969.1199, 35484.3512, 36002.8771,
+    36525.0463, 37052.8229, 37584.0442, 38120.3971, 38662.2676, 39208.6656, 39758.2838,
+    40312.5401, 40872.169, 41433.5025, 42004.0718, 42575.4632, 43151.4283, 43731.3738,
+    44316.1437, 44904.6947, 45498.2355, 46096.0351, 46696.5459, 47302.2215, 47912.838,
+    48524.5722, 49140.5929, 49761.5127, 50386.4503, 51013.4459, 51644.2815, 52279.7072,
+    52919.1756, 53562.0336, 54210.5318, 54860.8122, 55512.3602, 56170.6054, 56828.9956,
+    57493.9694, 58159.8145, 58831.4298, 59503.2104, 60180.1321, 60859.8155, 61543.0723,
+    62231.3033, 62916.4297, 63608.7622, 64302.3713, 64999.8183, 65702.6156, 66405.423,
+    67111.3563, 67823.4471, 68531.437, 69246.5405, 69964.8653, 70681.0599, 71398.2866,
+    72120.0716, 72844.9793, 73572.8379, 74302.6131, 75031.9828, 75763.556, 76498.3647,
+    77233.7169, 77969.5556, 78719.64, 79463.4812, 80210.9305, 80959.6909, 81711.9049,
+    82462.7773, 83217.2807, 83977.4467, 84735.9853, 85493.1868, 86252.7612, 87014.4381,
+    87777.209, 88538.6007, 89302.4893, 90072.6558, 90841.8311, 91611.9621, 92381.8167,
+    93157.0013, 93930.9869, 94704.1303, 95482.2345, 96262.3839, 97048.4771, 97830.8403,
+    98611.7886, 99398.1939, 100183.42, 100972.2311, 101755.4148, 102542.8075,
+    103331.7296, 104118.2036, 104901.5088, 105695.4545, 106483.1375, 107275.0403,
+    108070.4277, 108868.327, 109664.4953, 110455.3329, 111249.8954, 112048.4728,
+    112850.9815, 113652.9952, 114459.4289, 115257.3165, 116068.754, 116869.8383,
+    117676.2117, 118480.1979, 119289.2677, 120094.3525, 120901.4738, 121709.4938,
+    122514.8832, 123325.3806, 124136.0524, 124939.6654, 125744.926, 126550.6228,
+    127357.2302, 128163.2044, 128972.2169, 129781.2533, 130596.4051, 131405.6977,
+    132222.1354, 133029.5326, 133837.8457, 134651.3066, 135463.8417, 136273.6532,
+    137083.5722, 137896.0679, 138707.5429, 139518.8451, 140330.025, 141144.0179,
+    141956.266, 142770.6908, 143586.2187, 144404.1196, 145224.6586, 146035.2149,
+    146846.6132, 147662.9322, 148472.8419, 149284.7938, 150105.7759, 150918.7005,
+    151738.5931, 152557.0352, 153374.6855, 154193.7732, 155004.9845, 155823.0857,
+    156637.2213, 157450.7706, 158268.6719, 159079.927, 159895.9492, 160712.7876,
+    161531.5038, 162341.1166, 163159.6861};
+
+static const double kHllBiasData15[] = {
+    23634.2599, 23211.3352, 22792.9971, 22379.2141, 21970.0565, 21565.7966, 21166.1262,
+    20770.7776, 20380.4913, 19994.8277, 19614.1313, 19237.8684, 18866.2375, 18499.9876,
+    18137.751, 17780.4694, 17428.4062, 17080.4934, 16736.8809, 16399.3933, 16065.8033,
+    15737.0466, 15412.8847, 15093.073, 14778.6519, 14469.1199, 14164.3512, 13862.8771,
+    13565.0463, 13272.8229, 12984.0442, 12700.3971, 12422.2676, 12148.6656, 11878.2838,
+    11612.5401, 11352.169, 11093.5025, 10844.0718, 10595.4632, 10351.4283, 10111.3738,
+    9876.1437, 9644.6947, 9418.2355, 9196.0351, 8976.5459, 8762.2215, 8552.838,
+    8344.5722, 8140.5929, 7941.5127, 7746.4503, 7553.4459, 7364.2815, 7179.7072,
+    6999.1756, 6822.0336, 6650.5318, 6480.8122, 6312.3602, 6150.6054, 5988.9956,
+    5833.9694, 5679.8145, 5531.4298, 5383.2104, 5240.1321, 5099.8155, 4963.0723,
+    4831.3033, 4696.4297, 4568.7622, 4442.3713, 4319.8183, 4202.6156, 4085.423,
+    3971.3563, 3863.4471, 3751.437, 3646.5405, 3544.8653, 3441.0599, 3338.2866,
+    3240.0716, 3144.9793, 3052.8379, 2962.6131, 2871.9828, 2783.556, 2698.3647,
+    2613.7169, 2529.5556, 2459.64, 2383.4812, 2310.9305, 2239.6909, 2171.9049, 2102.7773,
+    2037.2807, 1977.4467, 1915.9853, 1853.1868, 1792.7612, 1734.4381, 1677.209,
+    1618.6007, 1562.4893, 1512.6558, 1461.8311, 1411.9621, 1361.8167, 1317.0013,
+    1270.9869, 1224.1303, 1182.2345, 1142.3839, 1108.4771, 1070.8403, 1031.7886,
+    998.1939, 963.42, 932.2311, 895.4148, 862.8075, 831.7296, 798.2036, 761.5088,
+    735.4545, 703.1375, 675.0403, 650.4277, 628.327, 604.4953, 575.3329, 549.8954,
+    528.4728, 510.9815, 492.9952, 479.4289, 457.3165, 448.754, 429.8383, 416.2117,
+    400.1979, 389.2677, 374.3525, 361.4738, 349.4938, 334.8832, 325.3806, 316.0524,
+    299.6654, 284.926, 270.6228, 257.2302, 243.2044, 232.2169, 221.2533, 216.4051,
+    205.6977, 202.1354, 189.5326, 177.8457, 171.3066, 163.8417, 153.6532, 143.5722,
+    136.0679, 127.5429, 118.8451, 110.025, 104.0179, 96.266, 90.6908, 86.2187, 84.1196,
+    84.6586, 75.2149, 66.6132, 62.9322, 52.8419, 44.7938, 45.7759, 38.7005, 38.5931,
+    37.0352, 34.6855, 33.7732, 24.9845, 23.0857, 17.2213, 10.7706, 8.6719, -0.073,
+    -4.0508, -7.2124, -8.4962, -18.8834, -20.3139};
+
+static const double kHllRawEstimateData16[] = {
+    47270.8118, 48063.2145, 48865.575, 49677.5063, 50498.1175, 51328.7017, 52168.8991,
+    53017.8665, 53876.3784, 54744.7707, 55623.4725, 56510.1679, 57406.9748, 58313.9657,
+    59228.7867, 60153.147, 61087.9727, 62031.2634, 62984.0394, 63947.9452, 64919.3418,
+    65900.6027, 66891.8877, 67892.8381, 68901.5892, 69920.2796, 70947.9735, 71984.6811,
+    73028.8639, 74083.5918, 75146.331, 76218.9178, 77301.618, 78393.2774, 79492.55,
+    80601.6772, 81717.1764, 82841.9381, 83975.2869, 85118.7735, 86270.6822, 87429.1987,
+    88595.4605, 89772.6982, 90958.8514, 92149.5896, 93345.8557, 94555.971, 95772.8421,
+    96999.0072, 98231.9609, 99472.1417, 100718.0778, 101972.3361, 103233.0573,
+    104500.6102, 105777.7108, 107060.6927, 108352.4699, 109649.6607, 110954.573,
+    112267.664, 113586.2669, 114907.7031, 116236.7468, 117571.8967, 118913.4126,
+    120261.7536, 121618.3957, 122984.7429, 124356.1225, 125733.8289, 127117.9083,
+    128506.8268, 129900.6218, 131300.3351, 132705.8043, 134110.3889, 135522.2796,
+    136942.3011, 138367.9484, 139801.2778, 141236.2355, 142679.7187, 144125.1681,
+    145571.5805, 147025.0938, 148484.2657, 149948.3915, 151418.9732, 152886.9848,
+    154359.4417, 155836.966, 157324.6585, 158816.4067, 160307.5409, 161802.1981,
+    163301.6105, 164802.9697, 166310.3807, 167821.8371, 169342.9333, 170861.6508,
+    172382.7565, 173905.5318, 175433.1801, 176966.6004, 178493.7296, 180033.1643,
+    181571.9276, 183113.1123, 184657.7141, 186209.6903, 187759.1645, 189317.14,
+    190872.9328, 192431.4732, 193997.8125, 195561.0509, 197130.5173, 198698.0951,
+    200267.605, 201844.7267, 203416.5343, 204993.1815, 206572.9765, 208154.3688,
+    209733.8097, 211309.488, 212896.1977, 214487.3707, 216079.8373, 217671.6018,
+    219268.444, 220858.9432, 222448.2847, 224049.9576, 225657.135, 227260.5156,
+    228868.8825, 230468.4652, 232072.3009, 233675.6343, 235283.5037, 236882.6867,
+    238485.501, 240091.9204, 241696.3853, 243313.9721, 244934.6447, 246550.2008,
+    248163.545, 249779.0019, 251392.6984, 253005.2171, 254618.3516, 256239.5875,
+    257850.734, 259471.2364, 261091.3938, 262718.6857, 264330.0521, 265945.5842,
+    267572.1465, 269196.43, 270813.9652, 272433.737, 274065.6728, 275690.5006,
+    277317.0517, 278937.5068, 280560.4397, 282191.5674, 283818.7745, 285446.4027,
+    287081.4882, 288707.5644, 290332.6744, 291962.9078, 293600.9877, 295231.359,
+    296860.2342, 298502.7553, 300126.0017, 301752.7831, 303389.8465, 305028.0359,
+    306655.5056, 308287.6748, 309918.9541, 311551.2326, 313183.7833, 314825.5014,
+    316455.4313, 318086.7798, 319720.2815, 321344.6045, 322975.531, 324608.3843,
+    326253.7434};
+
+static const double kHllBiasData16[] = {
+    47269.8118, 46424.2145, 45587.575, 44760.5063, 43942.1175, 43133.7017, 42334.8991,
+    41544.8665, 40764.3784, 39993.7707, 39233.4725, 38481.1679, 37738.9748, 37006.9657,
+    36282.7867, 35568.147, 34863.9727, 34168.2634, 33482.0394, 32806.9452, 32139.3418,
+    31481.6027, 30833.8877, 30195.8381, 29565.5892, 28945.2796, 28333.9735, 27731.6811,
+    27136.8639, 26552.5918, 25976.331, 25409.9178, 24853.618, 24306.2774, 23766.55,
+    23236.6772, 22713.1764, 22198.9381, 21693.2869, 21197.7735, 20710.6822, 20230.1987,
+    19757.4605, 19295.6982, 18842.8514, 18394.5896, 17951.8557, 17522.971, 17100.8421,
+    16688.0072, 16281.9609, 15883.1417, 15490.0778, 15105.3361, 14727.0573, 14355.6102,
+    13993.7108, 13637.6927, 13290.4699, 12948.6607, 12614.573, 12288.664, 11968.2669,
+    11650.7031, 11340.7468, 11036.8967, 10739.4126, 10448.7536, 10166.3957, 9893.7429,
+    9626.1225, 9364.8289, 9109.9083, 8859.8268, 8614.6218, 8375.3351, 8141.8043,
+    7907.3889, 7680.2796, 7461.3011, 7247.9484, 7042.2778, 6838.2355, 6642.7187,
+    6449.1681, 6256.5805, 6071.0938, 5891.2657, 5716.3915, 5547.9732, 5376.9848,
+    5210.4417, 5048.966, 4897.6585, 4750.4067, 4602.5409, 4458.1981, 4318.6105,
+    4180.9697, 4049.3807, 3921.8371, 3803.9333, 3683.6508, 3565.7565, 3449.5318,
+    3338.1801, 3232.6004, 3120.7296, 3021.1643, 2920.9276, 2823.1123, 2728.7141,
+    2641.6903, 2552.1645, 2471.14, 2387.9328, 2307.4732, 2234.8125, 2159.0509, 2089.5173,
+    2018.0951, 1948.605, 1886.7267, 1819.5343, 1757.1815, 1697.9765, 1640.3688,
+    1580.8097, 1517.488, 1465.1977, 1417.3707, 1370.8373, 1323.6018, 1281.444, 1232.9432,
+    1183.2847, 1145.9576, 1114.135, 1078.5156, 1047.8825, 1008.4652, 973.3009, 937.6343,
+    906.5037, 866.6867, 830.501, 797.9204, 763.3853, 741.9721, 723.6447, 700.2008,
+    674.545, 651.0019, 625.6984, 599.2171, 573.3516, 555.5875, 527.734, 509.2364,
+    490.3938, 478.6857, 451.0521, 427.5842, 415.1465, 400.43, 378.9652, 359.737,
+    352.6728, 338.5006, 326.0517, 307.5068, 291.4397, 283.5674, 271.7745, 260.4027,
+    256.4882, 243.5644, 229.6744, 220.9078, 219.9877, 211.359, 201.2342, 204.7553,
+    189.0017, 176.7831, 174.8465, 174.0359, 162.5056, 155.6748, 147.9541, 141.2326,
+    134.7833, 137.5014, 128.4313, 120.7798, 115.2815, 100.6045, 92.531, 86.3843,
+    92.7434};
+
+static const double kHllRawEstimateData17[] = {
+    94541.9393, 96127.2156, 97730.0912, 99353.8096, 100995.5983, 102657.5888,
+    104336.9692, 106035.1641, 107751.8758, 109489.2355, 111243.3864, 113017.4654,
+    114808.7164, 116620.9825, 118450.533, 120299.5016, 122171.0988, 124056.7106,
+    125965.2311, 127891.1727, 129833.6722, 131794.0609, 133774.4633, 135771.8612,
+    137791.596, 139830.5016, 141884.8591, 143956.6129, 146049.5354, 148158.6602,
+    150286.2568, 152423.9914, 154583.1634, 156758.1213, 158954.7085, 161168.4301,
+    163401.2424, 165654.4411, 167919.4755, 170202.2222, 172498.985, 174815.4213,
+    177151.3679, 179498.7028, 181871.4588, 184248.6113, 186640.2234, 189058.3533,
+    191485.1175, 193933.9383, 196401.3809, 198888.8029, 201380.0058, 203889.5533,
+    206410.7038, 208934.745, 211491.4754, 214061.1723, 216649.0617, 219249.7116,
+    221861.6252, 224489.1796, 227125.2355, 229773.9923, 232427.369, 235094.7783,
+    237779.3891, 240476.2192, 243189.4779, 245928.7036, 248667.6712, 251417.7857,
+    254173.4093, 256952.9136, 259737.3417, 262539.7569, 265335.6925, 268158.9565,
+    270982.7603, 273816.7282, 276668.3689, 279528.7654, 282397.5597, 285264.4244,
+    288157.6882, 291044.7873, 293950.1199, 296861.395, 299790.0161, 302724.2703,
+    305673.5358, 308624.0004, 311586.3281, 314556.7324, 317531.6449, 320511.0978,
+    323503.5539, 326511.3792, 329524.3196, 332533.8696, 335555.2334, 338592.4228,
+    341634.3224, 344685.0545, 347732.0393, 350771.5675, 353823.9447, 356878.1728,
+    359968.8483, 363046.6254, 366126.4499, 369217.7259, 372301.7084, 375392.7234,
+    378506.2261, 381611.2675, 384718.3366, 387830.9441, 390945.8151, 394081.2474,
+    397216.6442, 400361.034, 403503.8452, 406652.302, 409790.3315, 412957.7316,
+    416123.3606, 419285.4243, 422477.1666, 425644.1321, 428821.308, 432000.0233,
+    435183.0213, 438354.3351, 441539.5498, 444727.6051, 447929.1589, 451132.3217,
+    454339.2741, 457544.7492, 460742.3499, 463940.1976, 467133.7141, 470340.9481,
+    473565.2874, 476776.9615, 479986.5761, 483205.4238, 486424.1591, 489643.6714,
+    492873.3529, 496115.8391, 499335.2927, 502554.9963, 505775.1566, 508996.4497,
+    512223.6959, 515442.3755, 518673.6337, 521916.6551, 525166.1014, 528408.7223,
+    531652.3856, 534889.4511, 538137.9213, 541403.7857, 544668.2296, 547905.045,
+    551166.695, 554412.5534, 557664.4388, 560921.3346, 564169.6691, 567452.6092,
+    570697.389, 573953.3436, 577212.5247, 580457.6748, 583717.065, 586968.9866,
+    590235.279, 593495.0884, 596782.7922, 600057.4141, 603326.5864, 606585.0584,
+    609857.125, 613127.5217, 616411.8929, 619677.5015, 622933.6727, 626225.2233,
+    629487.304, 632751.7617, 636008.3219, 639293.3116, 642563.349, 645814.4215,
+    649078.5722, 652331.4523};
+
+static const double kHllBiasData17[] = {
+    94540.9393, 92850.2156, 91176.0912, 89522.8096, 87887.5983, 86272.5888, 84674.9692,
+    83096.1641, 81535.8758, 79996.2355, 78473.3864, 76970.4654, 75484.7164, 74019.9825,
+    72572.533, 71144.5016, 69739.0988, 68347.7106, 66979.2311, 65628.1727, 64293.6722,
+    62977.0609, 61680.4633, 60400.8612, 59143.596, 57905.5016, 56682.8591, 55477.6129,
+    54293.5354, 53125.6602, 51976.2568, 50836.9914, 49719.1634, 48617.1213, 47536.7085,
+    46473.4301, 45429.2424, 44405.4411, 43393.4755, 42399.2222, 41418.985, 40458.4213,
+    39517.3679, 38587.7028, 37683.4588, 36783.6113, 35898.2234, 35039.3533, 34189.1175,
+    33360.9383, 32551.3809, 31761.8029, 30976.0058, 30208.5533, 29452.7038, 28699.745,
+    27979.4754, 27272.1723, 26583.0617, 25906.7116, 25241.6252, 24592.1796, 23951.2355,
+    23322.9923, 22699.369, 22089.7783, 21497.3891, 20917.2192, 20353.4779, 19815.7036,
+    19277.6712, 18750.7857, 18229.4093, 17731.9136, 17239.3417, 16764.7569, 16283.6925,
+    15829.9565, 15376.7603, 14933.7282, 14508.3689, 14091.7654, 13683.5597, 13273.4244,
+    12889.6882, 12499.7873, 12128.1199, 11762.395, 11414.0161, 11071.2703, 10743.5358,
+    10417.0004, 10102.3281, 9795.7324, 9493.6449, 9196.0978, 8911.5539, 8642.3792,
+    8378.3196, 8110.8696, 7855.2334, 7615.4228, 7380.3224, 7154.0545, 6924.0393,
+    6686.5675, 6461.9447, 6239.1728, 6052.8483, 5853.6254, 5656.4499, 5470.7259,
+    5277.7084, 5091.7234, 4928.2261, 4756.2675, 4586.3366, 4421.9441, 4259.8151,
+    4118.2474, 3976.6442, 3844.034, 3709.8452, 3581.302, 3442.3315, 3332.7316, 3221.3606,
+    3106.4243, 3021.1666, 2911.1321, 2811.308, 2713.0233, 2619.0213, 2513.3351,
+    2421.5498, 2332.6051, 2257.1589, 2183.3217, 2113.2741, 2041.7492, 1962.3499,
+    1883.1976, 1799.7141, 1729.9481, 1677.2874, 1611.9615, 1544.5761, 1486.4238,
+    1428.1591, 1370.6714, 1323.3529, 1288.8391, 1231.2927, 1173.9963, 1117.1566,
+    1061.4497, 1011.6959, 953.3755, 907.6337, 873.6551, 846.1014, 811.7223, 778.3856,
+    738.4511, 709.9213, 698.7857, 686.2296, 646.045, 630.695, 599.5534, 574.4388,
+    554.3346, 525.6691, 531.6092, 499.389, 478.3436, 460.5247, 428.6748, 411.065,
+    385.9866, 375.279, 358.0884, 368.7922, 366.4141, 358.5864, 340.0584, 335.125,
+    328.5217, 335.8929, 324.5015, 303.6727, 318.2233, 303.304, 290.7617, 270.3219,
+    278.3116, 271.349, 245.4215, 232.5722, 208.4523};
+
+static const double kHllRawEstimateData18[] = {
+    189084.1631, 192254.832, 195461.4668, 198708.4587, 201992.2409, 205314.8565,
+    208673.6173, 212069.724, 215507.5079, 218979.5854, 222489.5864, 226036.8599,
+    229622.1849, 233247.4425, 236909.3354, 240608.0188, 244338.7094, 248110.7451,
+    251924.1212, 255771.0303, 259654.9626, 263584.8196, 267546.7054, 271539.4819,
+    275575.7888, 279652.9575, 283761.9142, 287903.1943, 292085.7285, 296312.1365,
+    300567.7177, 304861.2618, 309178.0942, 313533.4329, 317927.4497, 322366.6194,
+    326827.2533, 331328.6173, 335860.6756, 340427.0394, 345024.4784, 349665.9774,
+    354334.5229, 359031.7616, 363770.4986, 368541.2711, 373341.5345, 378174.9864,
+    383036.9055, 387934.615, 392860.1224, 397817.0217, 402808.6492, 407813.9584,
+    412859.2959, 417934.1946, 423034.9975, 428167.0334, 433320.9594, 438506.2845,
+    443730.4605, 448986.9856, 454254.5279, 459556.053, 464897.4183, 470256.6415,
+    475640.3026, 481034.2656, 486470.7291, 491929.1155, 497413.439, 502918.4257,
+    508446.9926, 513987.9487, 519551.7819, 525161.8928, 530771.0009, 536398.1603,
+    542041.6061, 547723.3856, 553435.1171, 559150.9724, 564890.8056, 570671.499,
+    576440.3663, 582229.9017, 588051.537, 593894.509, 599758.8112, 605620.2012,
+    611503.039, 617423.6001, 623350.3292, 629307.2263, 635284.1469, 641239.8739,
+    647225.6958, 653217.0299, 659241.6258, 665259.0388, 671274.2222, 677327.6679,
+    683407.9676, 689482.982, 695564.2443, 701660.1142, 707789.5918, 713917.1381,
+    720047.9053, 726229.992, 732392.4452, 738563.204, 744749.0857, 750954.0162,
+    757151.8337, 763369.8719, 769602.5099, 775824.8114, 782075.2113, 788336.7155,
+    794604.9789, 800882.2085, 807170.2683, 813476.9066, 819802.4809, 826093.0763,
+    832410.7883, 838742.3623, 845072.1254, 851408.8067, 857772.6322, 864128.5098,
+    870471.6848, 876833.0616, 883210.069, 889600.4651, 895994.6534, 902369.1666,
+    908768.0926, 915178.2216, 921611.3559, 928028.7791, 934427.9511, 940829.3644,
+    947272.6201, 953675.7334, 960098.0398, 966530.9047, 972967.2597, 979418.4323,
+    985881.4273, 992306.3139, 998738.2598, 1005187.5635, 1011639.8595, 1018111.597,
+    1024610.6922, 1031066.1806, 1037576.188, 1044069.9957, 1050549.5903, 1057024.646,
+    1063494.0622, 1069968.628, 1076472.5691, 1082980.9386, 1089483.1343, 1095966.9356,
+    1102478.0858, 1108988.2664, 1115492.6024, 1122005.4155, 1128530.8055, 1135031.2281,
+    1141506.2201, 1148016.382, 1154561.1328, 1161080.9334, 1167635.482, 1174142.4814,
+    1180643.0262, 1187148.0968, 1193686.8607, 1200217.1314, 1206794.6853, 1213361.8363,
+    1219863.4752, 1226351.0042, 1232901.7783, 1239420.9802, 1245936.7152, 1252481.7898,
+    1259017.057, 1265536.439, 1272060.1239, 1278589.8457, 1285129.1451, 1291672.1833,
+    1298196.6944, 1304725.9096};
+
+static const double kHllBiasData18[] = {
+    189083.1631, 185700.832, 182353.4668, 179046.4587, 175776.2409, 172544.8565,
+    169349.6173, 166191.724, 163075.5079, 159993.5854, 156949.5864, 153942.8599,
+    150974.1849, 148045.4425, 145153.3354, 142298.0188, 139474.7094, 136692.7451,
+    133952.1212, 131245.0303, 128574.9626, 125950.8196, 123358.7054, 120797.4819,
+    118279.7888, 115802.9575, 113357.9142, 110945.1943, 108573.7285, 106246.1365,
+    103947.7177, 101687.2618, 99450.0942, 97251.4329, 95091.4497, 92976.6194, 90883.2533,
+    88830.6173, 86808.6756, 84821.0394, 82864.4784, 80951.9774, 79066.5229, 77209.7616,
+    75394.4986, 73611.2711, 71857.5345, 70136.9864, 68444.9055, 66788.615, 65160.1224,
+    63563.0217, 62000.6492, 60451.9584, 58943.2959, 57464.1946, 56010.9975, 54589.0334,
+    53188.9594, 51820.2845, 50490.4605, 49192.9856, 47906.5279, 46654.053, 45441.4183,
+    44246.6415, 43076.3026, 41916.2656, 40798.7291, 39703.1155, 38633.439, 37584.4257,
+    36558.9926, 35545.9487, 34555.7819, 33611.8928, 32667.0009, 31740.1603, 30829.6061,
+    29957.3856, 29115.1171, 28276.9724, 27462.8056, 26689.499, 25904.3663, 25139.9017,
+    24407.537, 23696.509, 23006.8112, 22314.2012, 21643.039, 21009.6001, 20382.3292,
+    19785.2263, 19208.1469, 18609.8739, 18041.6958, 17479.0299, 16949.6258, 16413.0388,
+    15874.2222, 15373.6679, 14899.9676, 14420.982, 13948.2443, 13490.1142, 13065.5918,
+    12639.1381, 12215.9053, 11843.992, 11452.4452, 11069.204, 10701.0857, 10352.0162,
+    9995.8337, 9659.8719, 9338.5099, 9006.8114, 8703.2113, 8410.7155, 8124.9789,
+    7848.2085, 7582.2683, 7334.9066, 7106.4809, 6843.0763, 6606.7883, 6384.3623,
+    6160.1254, 5942.8067, 5752.6322, 5554.5098, 5343.6848, 5151.0616, 4974.069,
+    4810.4651, 4650.6534, 4471.1666, 4316.0926, 4172.2216, 4051.3559, 3914.7791,
+    3759.9511, 3607.3644, 3496.6201, 3345.7334, 3214.0398, 3092.9047, 2975.2597,
+    2872.4323, 2781.4273, 2652.3139, 2530.2598, 2425.5635, 2323.8595, 2241.597,
+    2186.6922, 2088.1806, 2044.188, 1983.9957, 1909.5903, 1830.646, 1746.0622, 1666.628,
+    1616.5691, 1570.9386, 1519.1343, 1448.9356, 1406.0858, 1362.2664, 1312.6024,
+    1271.4155, 1242.8055, 1189.2281, 1110.2201, 1066.382, 1057.1328, 1022.9334, 1023.482,
+    976.4814, 923.0262, 874.0968, 858.8607, 835.1314, 858.6853, 871.8363, 819.4752,
+    753.0042, 749.7783, 714.9802, 676.7152, 667.7898, 649.057, 614.439, 584.1239,
+    559.8457, 545.1451, 534.1833, 504.6944, 479.9096};
+
+/* indexed by p - 4 */
+static const double* const kHllRawEstimateData[] = {
+    kHllRawEstimateData4, kHllRawEstimateData5, kHllRawEstimateData6,
+    kHllRawEstimateData7, kHllRawEstimateData8, kHllRawEstimateData9,
+    kHllRawEstimateData10, kHllRawEstimateData11, kHllRawEstimateData12,
+    kHllRawEstimateData13, kHllRawEstimateData14, kHllRawEstimateData15,
+    kHllRawEstimateData16, kHllRawEstimateData17, kHllRawEstimateData18};
+
+static const double* const kHllBiasData[] = {
+    kHllBiasData4, kHllBiasData5, kHllBiasData6, kHllBiasData7, kHllBiasData8,
+    kHllBiasData9, kHllBiasData10, kHllBiasData11, kHllBiasData12, kHllBiasData13,
+    kHllBiasData14, kHllBiasData15, kHllBiasData16, kHllBiasData17, kHllBiasData18};
+
+static const int kHllBiasDataSize[] = {
+    79, 159, 160, 160, 183, 197, 197, 197, 199, 200, 200, 200, 200, 200, 200};
+
+}  // namespace extra
+}  // namespace arrowcompute
+}  // namespace codegen
+}  // namespace sparkcolumnarplugin
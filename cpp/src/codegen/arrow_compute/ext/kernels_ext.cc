@@ -51,6 +51,7 @@
 
 #include "codegen/arrow_compute/ext/actions_impl.h"
 #include "codegen/arrow_compute/ext/array_item_index.h"
+#include "codegen/arrow_compute/ext/array_reduce.h"
 #include "codegen/arrow_compute/ext/codegen_common.h"
 //#include "codegen/arrow_compute/ext/codegen_node_visitor.h"
 #include "third_party/arrow/utils/hashing.h"
@@ -109,6 +110,19 @@ class SplitArrayListWithActionKernel::Impl {
         RETURN_NOT_OK(MakeStddevSampPartialAction(ctx_, type_list[type_id], &action));
       } else if (action_name_list_[action_id].compare("action_stddev_samp_final") == 0) {
         RETURN_NOT_OK(MakeStddevSampFinalAction(ctx_, type_list[type_id], &action));
+      } else if (action_name_list_[action_id].compare("action_count_distinct") == 0) {
+        RETURN_NOT_OK(MakeCountDistinctAction(ctx_, type_list[type_id], &action));
+      } else if (action_name_list_[action_id].compare("action_sum_distinct") == 0) {
+        RETURN_NOT_OK(MakeSumDistinctAction(ctx_, type_list[type_id], &action));
+      } else if (action_name_list_[action_id].compare(
+                     0, 37, "action_approx_count_distinct_partial_") == 0) {
+        double relative_sd = std::stod(action_name_list_[action_id].substr(37));
+        RETURN_NOT_OK(MakeApproxCountDistinctPartialAction(ctx_, type_list[type_id],
+                                                           relative_sd, &action));
+      } else if (action_name_list_[action_id].compare(
+                     0, 35, "action_approx_count_distinct_final_") == 0) {
+        double relative_sd = std::stod(action_name_list_[action_id].substr(35));
+        RETURN_NOT_OK(MakeApproxCountDistinctFinalAction(ctx_, relative_sd, &action));
       } else {
         return arrow::Status::NotImplemented(action_name_list_[action_id],
                                              " is not implementetd.");
@@ -339,51 +353,89 @@ arrow::Status UniqueArrayKernel::Finish(std::shared_ptr<arrow::Array>* out) {
 ///////////////  SumArray  ////////////////
 class SumArrayKernel::Impl {
  public:
-  Impl(arrow::compute::FunctionContext* ctx, std::shared_ptr<arrow::DataType> data_type)
-      : ctx_(ctx), data_type_(data_type) {}
+  Impl() {}
   virtual ~Impl() {}
-  arrow::Status Evaluate(const ArrayList& in) {
-    arrow::compute::Datum output;
-    RETURN_NOT_OK(arrow::compute::Sum(ctx_, *in[0].get(), &output));
-    res_data_type_ = output.scalar()->type;
-    scalar_list_.push_back(output.scalar());
+  virtual arrow::Status Evaluate(const ArrayList& in) = 0;
+  virtual arrow::Status Finish(ArrayList* out) = 0;
+};
+
+/* Sum is null if no value is valid, as Spark does */
+template <typename InType, typename Reducer>
+class SumArrayTypedImpl : public SumArrayKernel::Impl {
+ public:
+  SumArrayTypedImpl(arrow::compute::FunctionContext* ctx) : ctx_(ctx) {}
+  arrow::Status Evaluate(const ArrayList& in) override {
+    auto typed_in = std::dynamic_pointer_cast<ArrayType>(in[0]);
+    count_ += ReduceArray<Reducer>(*typed_in.get(), &state_);
     return arrow::Status::OK();
   }
 
-  arrow::Status Finish(ArrayList* out) {
-    switch (res_data_type_->id()) {
-#define PROCESS(DataType)                         \
-  case DataType::type_id: {                       \
-    RETURN_NOT_OK(FinishInternal<DataType>(out)); \
-  } break;
-      PROCESS_SUPPORTED_TYPES(PROCESS)
-#undef PROCESS
+  arrow::Status Finish(ArrayList* out) override {
+    ResBuilderType builder(ctx_->memory_pool());
+    if (count_ > 0) {
+      RETURN_NOT_OK(builder.Append(state_.Result()));
+    } else {
+      RETURN_NOT_OK(builder.AppendNull());
     }
+    std::shared_ptr<arrow::Array> arr_out;
+    RETURN_NOT_OK(builder.Finish(&arr_out));
+    out->push_back(arr_out);
     return arrow::Status::OK();
   }
 
-  template <typename DataType>
-  arrow::Status FinishInternal(ArrayList* out) {
-    using ScalarType = typename arrow::TypeTraits<DataType>::ScalarType;
-    using CType = typename arrow::TypeTraits<DataType>::CType;
-    CType res = 0;
-    for (auto scalar_item : scalar_list_) {
-      auto typed_scalar = std::dynamic_pointer_cast<ScalarType>(scalar_item);
-      res += typed_scalar->value;
+ private:
+  using ArrayType = typename arrow::TypeTraits<InType>::ArrayType;
+  using ResDataType = typename SumResultType<InType>::Type;
+  using ResBuilderType = typename arrow::TypeTraits<ResDataType>::BuilderType;
+  arrow::compute::FunctionContext* ctx_;
+  typename Reducer::State state_;
+  int64_t count_ = 0;
+};
+
+/* Result precision grows by 10 as Spark does, the sum is null once it overflows
+ * the result precision */
+template <typename InType>
+class SumArrayDecimalImpl : public SumArrayKernel::Impl {
+ public:
+  SumArrayDecimalImpl(arrow::compute::FunctionContext* ctx,
+                      std::shared_ptr<arrow::DataType> data_type)
+      : ctx_(ctx) {
+    auto decimal_type = std::dynamic_pointer_cast<arrow::Decimal128Type>(data_type);
+    auto precision = std::min(38, decimal_type->precision() + 10);
+    res_type_ = arrow::decimal128(precision, decimal_type->scale());
+    max_unscaled_ = 1;
+    for (int i = 0; i < precision; i++) max_unscaled_ *= 10;
+    max_unscaled_ -= 1;
+  }
+  arrow::Status Evaluate(const ArrayList& in) override {
+    auto typed_in = std::dynamic_pointer_cast<arrow::Decimal128Array>(in[0]);
+    auto bitmap = typed_in->null_count() > 0 ? typed_in->null_bitmap_data() : nullptr;
+    count_ += ReduceValid<Decimal128SumReducer>(
+        typed_in->raw_values(), bitmap, typed_in->offset(), typed_in->length(), &state_);
+    return arrow::Status::OK();
+  }
+
+  arrow::Status Finish(ArrayList* out) override {
+    arrow::Decimal128Builder builder(res_type_, ctx_->memory_pool());
+    auto sum = state_.sum;
+    if (count_ == 0 || state_.overflow || sum > max_unscaled_ || sum < -max_unscaled_) {
+      RETURN_NOT_OK(builder.AppendNull());
+    } else {
+      RETURN_NOT_OK(builder.Append(arrow::Decimal128(static_cast<int64_t>(sum >> 64),
+                                                     static_cast<uint64_t>(sum))));
     }
     std::shared_ptr<arrow::Array> arr_out;
-    std::shared_ptr<arrow::Scalar> scalar_out;
-    scalar_out = arrow::MakeScalar(res);
-    RETURN_NOT_OK(arrow::MakeArrayFromScalar(*scalar_out.get(), 1, &arr_out));
+    RETURN_NOT_OK(builder.Finish(&arr_out));
     out->push_back(arr_out);
     return arrow::Status::OK();
   }
 
  private:
   arrow::compute::FunctionContext* ctx_;
-  std::shared_ptr<arrow::DataType> data_type_;
-  std::shared_ptr<arrow::DataType> res_data_type_;
-  std::vector<std::shared_ptr<arrow::Scalar>> scalar_list_;
+  std::shared_ptr<arrow::DataType> res_type_;
+  __int128 max_unscaled_;
+  Decimal128SumState state_;
+  int64_t count_ = 0;
 };
 
 arrow::Status SumArrayKernel::Make(arrow::compute::FunctionContext* ctx,
@@ -395,7 +447,28 @@ arrow::Status SumArrayKernel::Make(arrow::compute::FunctionContext* ctx,
 
 SumArrayKernel::SumArrayKernel(arrow::compute::FunctionContext* ctx,
                                std::shared_ptr<arrow::DataType> data_type) {
-  impl_.reset(new Impl(ctx, data_type));
+  switch (data_type->id()) {
+#define PROCESS(InType)                                                             \
+  case InType::type_id: {                                                           \
+    using CType = typename arrow::TypeTraits<InType>::CType;                        \
+    using ResCType =                                                                \
+        typename arrow::TypeTraits<typename SumResultType<InType>::Type>::CType;    \
+    if (std::is_floating_point<CType>::value && GetEnableKahanSum()) {              \
+      impl_.reset(new SumArrayTypedImpl<InType, KahanSumReducer<CType>>(ctx));      \
+    } else {                                                                        \
+      impl_.reset(new SumArrayTypedImpl<InType, SumReducer<CType, ResCType>>(ctx)); \
+    }                                                                               \
+  } break;
+    PROCESS_SUPPORTED_TYPES(PROCESS)
+#undef PROCESS
+    case arrow::Decimal128Type::type_id: {
+      impl_.reset(new SumArrayDecimalImpl<arrow::Decimal128Type>(ctx, data_type));
+    } break;
+    default: {
+      THROW_NOT_OK(arrow::Status::NotImplemented(
+          "SumArrayKernel type not supported, type is ", data_type->ToString()));
+    } break;
+  }
   kernel_name_ = "SumArrayKernel";
 }
 
@@ -412,31 +485,16 @@ class CountArrayKernel::Impl {
       : ctx_(ctx), data_type_(data_type) {}
   virtual ~Impl() {}
   arrow::Status Evaluate(const ArrayList& in) {
-    arrow::compute::Datum output;
-    arrow::compute::CountOptions option(arrow::compute::CountOptions::COUNT_ALL);
-    RETURN_NOT_OK(arrow::compute::Count(ctx_, option, *in[0].get(), &output));
-    scalar_list_.push_back(output.scalar());
+    // null_count is kept by the array, so there is nothing to scan
+    count_ += in[0]->length() - in[0]->null_count();
     return arrow::Status::OK();
   }
 
   arrow::Status Finish(ArrayList* out) {
-    RETURN_NOT_OK(FinishInternal<arrow::Int64Type>(out));
-    return arrow::Status::OK();
-  }
-
-  template <typename DataType>
-  arrow::Status FinishInternal(ArrayList* out) {
-    using CType = typename arrow::TypeTraits<DataType>::CType;
-    using ScalarType = typename arrow::TypeTraits<DataType>::ScalarType;
-    CType res = 0;
-    for (auto scalar_item : scalar_list_) {
-      auto typed_scalar = std::dynamic_pointer_cast<ScalarType>(scalar_item);
-      res += typed_scalar->value;
-    }
+    arrow::Int64Builder builder(ctx_->memory_pool());
+    RETURN_NOT_OK(builder.Append(count_));
     std::shared_ptr<arrow::Array> arr_out;
-    std::shared_ptr<arrow::Scalar> scalar_out;
-    scalar_out = arrow::MakeScalar(res);
-    RETURN_NOT_OK(arrow::MakeArrayFromScalar(*scalar_out.get(), 1, &arr_out));
+    RETURN_NOT_OK(builder.Finish(&arr_out));
     out->push_back(arr_out);
     return arrow::Status::OK();
   }
@@ -444,7 +502,7 @@ class CountArrayKernel::Impl {
  private:
   arrow::compute::FunctionContext* ctx_;
   std::shared_ptr<arrow::DataType> data_type_;
-  std::vector<std::shared_ptr<arrow::Scalar>> scalar_list_;
+  int64_t count_ = 0;
 };
 
 arrow::Status CountArrayKernel::Make(arrow::compute::FunctionContext* ctx,
@@ -470,46 +528,38 @@ arrow::Status CountArrayKernel::Finish(ArrayList* out) { return impl_->Finish(ou
 class SumCountArrayKernel::Impl {
  public:
   Impl(arrow::compute::FunctionContext* ctx, std::shared_ptr<arrow::DataType> data_type)
-      : ctx_(ctx), data_type_(data_type) {}
+      : ctx_(ctx), data_type_(data_type), kahan_(GetEnableKahanSum()) {}
   virtual ~Impl() {}
   arrow::Status Evaluate(const ArrayList& in) {
-    arrow::compute::Datum sum_out;
-    arrow::compute::Datum cnt_out;
-    arrow::compute::CountOptions option(arrow::compute::CountOptions::COUNT_ALL);
-    RETURN_NOT_OK(arrow::compute::Sum(ctx_, *in[0].get(), &sum_out));
-    RETURN_NOT_OK(arrow::compute::Count(ctx_, option, *in[0].get(), &cnt_out));
-    res_data_type_ = sum_out.scalar()->type;
-    sum_scalar_list_.push_back(sum_out.scalar());
-    cnt_scalar_list_.push_back(cnt_out.scalar());
-    return arrow::Status::OK();
-  }
-
-  arrow::Status Finish(ArrayList* out) {
-    switch (res_data_type_->id()) {
-#define PROCESS(DataType)                         \
-  case DataType::type_id: {                       \
-    RETURN_NOT_OK(FinishInternal<DataType>(out)); \
+    switch (data_type_->id()) {
+#define PROCESS(DataType)                             \
+  case DataType::type_id: {                           \
+    RETURN_NOT_OK(EvaluateInternal<DataType>(in[0])); \
   } break;
       PROCESS_SUPPORTED_TYPES(PROCESS)
 #undef PROCESS
+      default:
+        return arrow::Status::NotImplemented("SumCountArrayKernel type not supported, ",
+                                             data_type_->ToString());
     }
     return arrow::Status::OK();
   }
 
   template <typename DataType>
-  arrow::Status FinishInternal(ArrayList* out) {
+  arrow::Status EvaluateInternal(const std::shared_ptr<arrow::Array>& in) {
     using CType = typename arrow::TypeTraits<DataType>::CType;
-    using ScalarType = typename arrow::TypeTraits<DataType>::ScalarType;
-    using CntScalarType = typename arrow::TypeTraits<arrow::Int64Type>::ScalarType;
-    double sum_res = 0;
-    int64_t cnt_res = 0;
-    for (size_t i = 0; i < sum_scalar_list_.size(); i++) {
-      auto sum_typed_scalar = std::dynamic_pointer_cast<ScalarType>(sum_scalar_list_[i]);
-      auto cnt_typed_scalar =
-          std::dynamic_pointer_cast<CntScalarType>(cnt_scalar_list_[i]);
-      sum_res += sum_typed_scalar->value;
-      cnt_res += cnt_typed_scalar->value;
+    using ArrayType = typename arrow::TypeTraits<DataType>::ArrayType;
+    auto typed_in = std::dynamic_pointer_cast<ArrayType>(in);
+    if (kahan_) {
+      count_ += ReduceArray<KahanSumReducer<CType>>(*typed_in.get(), &kahan_state_);
+    } else {
+      count_ += ReduceArray<SumReducer<CType, double>>(*typed_in.get(), &sum_state_);
     }
+    return arrow::Status::OK();
+  }
+
+  arrow::Status Finish(ArrayList* out) {
+    double sum_res = kahan_ ? kahan_state_.Result() : sum_state_.Result();
     std::shared_ptr<arrow::Array> sum_out;
     std::shared_ptr<arrow::Scalar> sum_scalar_out;
     sum_scalar_out = arrow::MakeScalar(sum_res);
@@ -517,7 +567,7 @@ class SumCountArrayKernel::Impl {
 
     std::shared_ptr<arrow::Array> cnt_out;
     std::shared_ptr<arrow::Scalar> cnt_scalar_out;
-    cnt_scalar_out = arrow::MakeScalar(cnt_res);
+    cnt_scalar_out = arrow::MakeScalar(count_);
     RETURN_NOT_OK(arrow::MakeArrayFromScalar(*cnt_scalar_out.get(), 1, &cnt_out));
 
     out->push_back(sum_out);
@@ -528,10 +578,11 @@ class SumCountArrayKernel::Impl {
 
  private:
   arrow::compute::FunctionContext* ctx_;
-  std::shared_ptr<arrow::DataType> res_data_type_;
   std::shared_ptr<arrow::DataType> data_type_;
-  std::vector<std::shared_ptr<arrow::Scalar>> sum_scalar_list_;
-  std::vector<std::shared_ptr<arrow::Scalar>> cnt_scalar_list_;
+  bool kahan_;
+  SumState<double> sum_state_;
+  KahanSumState kahan_state_;
+  int64_t count_ = 0;
 };
 
 arrow::Status SumCountArrayKernel::Make(arrow::compute::FunctionContext* ctx,
@@ -1164,6 +1215,118 @@ arrow::Status StddevSampFinalArrayKernel::Finish(ArrayList* out) {
 
 #undef PROCESS_SUPPORTED_TYPES
 
+///////////////  ApproxCountDistinctArray  ////////////////
+class ApproxCountDistinctArrayKernel::Impl {
+ public:
+  Impl(arrow::compute::FunctionContext* ctx, std::shared_ptr<arrow::DataType> data_type,
+       double relative_sd, bool is_final)
+      : ctx_(ctx) {
+    if (is_final) {
+      THROW_NOT_OK(MakeApproxCountDistinctFinalAction(ctx_, relative_sd, &action_));
+    } else {
+      THROW_NOT_OK(
+          MakeApproxCountDistinctPartialAction(ctx_, data_type, relative_sd, &action_));
+    }
+    // whole input is one group, which still outputs one row if input is empty
+    THROW_NOT_OK(action_->EvaluateNull(0));
+  }
+  virtual ~Impl() {}
+
+  arrow::Status Evaluate(const ArrayList& in) {
+    std::function<arrow::Status(int)> on_valid;
+    std::function<arrow::Status()> on_null;
+    RETURN_NOT_OK(action_->Submit(in, 0, &on_valid, &on_null));
+    auto length = in[0]->length();
+    for (int64_t i = 0; i < length; i++) {
+      RETURN_NOT_OK(on_valid(0));
+    }
+    return arrow::Status::OK();
+  }
+
+  arrow::Status Finish(ArrayList* out) { return action_->Finish(out); }
+
+ private:
+  arrow::compute::FunctionContext* ctx_;
+  std::shared_ptr<ActionBase> action_;
+};
+
+arrow::Status ApproxCountDistinctArrayKernel::Make(
+    arrow::compute::FunctionContext* ctx, std::shared_ptr<arrow::DataType> data_type,
+    double relative_sd, bool is_final, std::shared_ptr<KernalBase>* out) {
+  *out = std::make_shared<ApproxCountDistinctArrayKernel>(ctx, data_type, relative_sd,
+                                                          is_final);
+  return arrow::Status::OK();
+}
+
+ApproxCountDistinctArrayKernel::ApproxCountDistinctArrayKernel(
+    arrow::compute::FunctionContext* ctx, std::shared_ptr<arrow::DataType> data_type,
+    double relative_sd, bool is_final) {
+  impl_.reset(new Impl(ctx, data_type, relative_sd, is_final));
+  kernel_name_ = "ApproxCountDistinctArrayKernel";
+}
+
+arrow::Status ApproxCountDistinctArrayKernel::Evaluate(const ArrayList& in) {
+  return impl_->Evaluate(in);
+}
+
+arrow::Status ApproxCountDistinctArrayKernel::Finish(ArrayList* out) {
+  return impl_->Finish(out);
+}
+
+///////////////  DistinctArray  ////////////////
+class DistinctArrayKernel::Impl {
+ public:
+  Impl(arrow::compute::FunctionContext* ctx, std::shared_ptr<arrow::DataType> data_type,
+       bool is_sum)
+      : ctx_(ctx) {
+    if (is_sum) {
+      THROW_NOT_OK(MakeSumDistinctAction(ctx_, data_type, &action_));
+    } else {
+      THROW_NOT_OK(MakeCountDistinctAction(ctx_, data_type, &action_));
+    }
+    // whole input is one group, which still outputs one row if input is empty
+    THROW_NOT_OK(action_->EvaluateNull(0));
+  }
+  virtual ~Impl() {}
+
+  arrow::Status Evaluate(const ArrayList& in) {
+    std::function<arrow::Status(int)> on_valid;
+    std::function<arrow::Status()> on_null;
+    RETURN_NOT_OK(action_->Submit(in, 0, &on_valid, &on_null));
+    auto length = in[0]->length();
+    for (int64_t i = 0; i < length; i++) {
+      RETURN_NOT_OK(on_valid(0));
+    }
+    return arrow::Status::OK();
+  }
+
+  arrow::Status Finish(ArrayList* out) { return action_->Finish(out); }
+
+ private:
+  arrow::compute::FunctionContext* ctx_;
+  std::shared_ptr<ActionBase> action_;
+};
+
+arrow::Status DistinctArrayKernel::Make(arrow::compute::FunctionContext* ctx,
+                                        std::shared_ptr<arrow::DataType> data_type,
+                                        bool is_sum, std::shared_ptr<KernalBase>* out) {
+  *out = std::make_shared<DistinctArrayKernel>(ctx, data_type, is_sum);
+  return arrow::Status::OK();
+}
+
+DistinctArrayKernel::DistinctArrayKernel(arrow::compute::FunctionContext* ctx,
+                                         std::shared_ptr<arrow::DataType> data_type,
+                                         bool is_sum) {
+  impl_.reset(new Impl(ctx, data_type, is_sum));
+  kernel_name_ = "DistinctArrayKernel";
+}
+
+arrow::Status DistinctArrayKernel::Evaluate(const ArrayList& in) {
+  return impl_->Evaluate(in);
+}
+
+arrow::Status DistinctArrayKernel::Finish(ArrayList* out) { return impl_->Finish(out); }
+
 ///////////////  EncodeArray  ////////////////
 class EncodeArrayKernel::Impl {
  public:
@@ -1493,19 +1656,6 @@ class CachedRelationKernel::Impl {
   std::vector<int> length_list_;
   std::vector<arrow::ArrayVector> cached_;
   uint64_t items_total_ = 0;
-
-  class SortRelationResultIterator : public ResultIterator<SortRelation> {
-   public:
-    SortRelationResultIterator(std::shared_ptr<SortRelation> sort_relation)
-        : sort_relation_(sort_relation) {}
-    arrow::Status Next(std::shared_ptr<SortRelation>* out) {
-      *out = sort_relation_;
-      return arrow::Status::OK();
-    }
-
-   private:
-    std::shared_ptr<SortRelation> sort_relation_;
-  };
 };
 
 arrow::Status CachedRelationKernel::Make(
@@ -75,6 +75,12 @@ class KernalBase {
     return arrow::Status::NotImplemented("Finish is abstract interface for ",
                                          kernel_name_, ", output is arrayList");
   }
+  /* Drops the input evaluated so far, so that the kernel can be reused for the next
+   * input once it is finished */
+  virtual arrow::Status Reset() {
+    return arrow::Status::NotImplemented("Reset is abstract interface for ",
+                                         kernel_name_);
+  }
   virtual arrow::Status MakeResultIterator(
       std::shared_ptr<arrow::Schema> schema,
       std::shared_ptr<ResultIterator<arrow::RecordBatch>>* out) {
@@ -157,6 +163,7 @@ class WindowAggregateFunctionKernel : public KernalBase {
                             std::shared_ptr<KernalBase>* out);
   arrow::Status Evaluate(const ArrayList& in) override;
   arrow::Status Finish(ArrayList* out) override;
+  arrow::Status Reset() override;
   template <typename ArrowType>
   arrow::Status Finish0(ArrayList* out);
 
@@ -168,6 +175,41 @@ class WindowAggregateFunctionKernel : public KernalBase {
   std::shared_ptr<arrow::DataType> result_type_;
 };
 
+/* Frame of a window function, lower and upper are offsets from the current row in
+ * rows, or in order key values when is_range, unbounded ones are infinite. */
+struct WindowFrame {
+  bool is_range;
+  double lower;
+  double upper;
+};
+
+class WindowFrameAggregateKernel : public KernalBase {
+ public:
+  static arrow::Status Make(arrow::compute::FunctionContext* ctx,
+                            std::string function_name,
+                            std::vector<std::shared_ptr<arrow::DataType>> type_list,
+                            std::vector<std::shared_ptr<arrow::Field>> order_key_fields,
+                            std::vector<bool> sort_directions,
+                            std::vector<bool> nulls_order, WindowFrame frame,
+                            std::shared_ptr<arrow::DataType> result_type,
+                            std::shared_ptr<KernalBase>* out);
+  WindowFrameAggregateKernel(arrow::compute::FunctionContext* ctx,
+                             std::string function_name,
+                             std::vector<std::shared_ptr<arrow::DataType>> type_list,
+                             std::vector<std::shared_ptr<arrow::Field>> order_key_fields,
+                             std::vector<bool> sort_directions,
+                             std::vector<bool> nulls_order, WindowFrame frame,
+                             std::shared_ptr<arrow::DataType> result_type);
+  arrow::Status Evaluate(const ArrayList& in) override;
+  arrow::Status Finish(ArrayList* out) override;
+  arrow::Status Reset() override;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+  arrow::compute::FunctionContext* ctx_;
+};
+
 class HashArrayKernel : public KernalBase {
  public:
   static arrow::Status Make(arrow::compute::FunctionContext* ctx,
@@ -312,6 +354,44 @@ class StddevSampFinalArrayKernel : public KernalBase {
   arrow::compute::FunctionContext* ctx_;
 };
 
+/* approx_count_distinct without grouping, partial kernel outputs one HLL++ sketch as
+ * int64 columns and final kernel merges sketch columns into the estimated count */
+class ApproxCountDistinctArrayKernel : public KernalBase {
+ public:
+  static arrow::Status Make(arrow::compute::FunctionContext* ctx,
+                            std::shared_ptr<arrow::DataType> data_type,
+                            double relative_sd, bool is_final,
+                            std::shared_ptr<KernalBase>* out);
+  ApproxCountDistinctArrayKernel(arrow::compute::FunctionContext* ctx,
+                                 std::shared_ptr<arrow::DataType> data_type,
+                                 double relative_sd, bool is_final);
+  arrow::Status Evaluate(const ArrayList& in) override;
+  arrow::Status Finish(ArrayList* out) override;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+  arrow::compute::FunctionContext* ctx_;
+};
+
+/* count_distinct and sum_distinct without grouping, distinct values are kept in one
+ * DistinctSet which spills to disk once over memory budget */
+class DistinctArrayKernel : public KernalBase {
+ public:
+  static arrow::Status Make(arrow::compute::FunctionContext* ctx,
+                            std::shared_ptr<arrow::DataType> data_type, bool is_sum,
+                            std::shared_ptr<KernalBase>* out);
+  DistinctArrayKernel(arrow::compute::FunctionContext* ctx,
+                      std::shared_ptr<arrow::DataType> data_type, bool is_sum);
+  arrow::Status Evaluate(const ArrayList& in) override;
+  arrow::Status Finish(ArrayList* out) override;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+  arrow::compute::FunctionContext* ctx_;
+};
+
 class SortArraysToIndicesKernel : public KernalBase {
  public:
   static arrow::Status Make(arrow::compute::FunctionContext* ctx,
@@ -323,6 +403,7 @@ class SortArraysToIndicesKernel : public KernalBase {
                             bool NaN_check,
                             bool do_codegen,
                             int result_type,
+                            int64_t limit,
                             std::shared_ptr<KernalBase>* out);
   SortArraysToIndicesKernel(arrow::compute::FunctionContext* ctx,
                             std::shared_ptr<arrow::Schema> result_schema,
@@ -332,7 +413,8 @@ class SortArraysToIndicesKernel : public KernalBase {
                             std::vector<bool> nulls_order, 
                             bool NaN_check,
                             bool do_codegen,
-                            int result_type);
+                            int result_type,
+                            int64_t limit);
   arrow::Status Evaluate(const ArrayList& in) override;
   arrow::Status MakeResultIterator(
       std::shared_ptr<arrow::Schema> schema,
@@ -400,12 +482,13 @@ class HashAggregateKernel : public KernalBase {
       std::vector<std::shared_ptr<gandiva::Node>> action_list,
       std::vector<std::shared_ptr<gandiva::Node>> result_field_node_list,
       std::vector<std::shared_ptr<gandiva::Node>> result_expr_node_list,
-      std::shared_ptr<KernalBase>* out);
+      std::shared_ptr<KernalBase>* out, bool is_partial = false, bool is_sorted = false);
   HashAggregateKernel(arrow::compute::FunctionContext* ctx,
                       std::vector<std::shared_ptr<gandiva::Node>> input_field_list,
                       std::vector<std::shared_ptr<gandiva::Node>> action_list,
                       std::vector<std::shared_ptr<gandiva::Node>> result_field_node_list,
-                      std::vector<std::shared_ptr<gandiva::Node>> result_expr_node_list);
+                      std::vector<std::shared_ptr<gandiva::Node>> result_expr_node_list,
+                      bool is_partial = false, bool is_sorted = false);
   arrow::Status MakeResultIterator(
       std::shared_ptr<arrow::Schema> schema,
       std::shared_ptr<ResultIterator<arrow::RecordBatch>>* out) override;
@@ -433,6 +516,7 @@ class WindowRankKernel : public KernalBase {
                             std::shared_ptr<KernalBase>* out, bool desc);
   arrow::Status Evaluate(const ArrayList& in) override;
   arrow::Status Finish(ArrayList* out) override;
+  arrow::Status Reset() override;
 
   arrow::Status SortToIndicesPrepare(std::vector<ArrayList> values);
   arrow::Status SortToIndicesFinish(
@@ -0,0 +1,124 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/buffer.h>
+#include <arrow/memory_pool.h>
+#include <arrow/status.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace sparkcolumnarplugin {
+namespace codegen {
+namespace arrowcompute {
+namespace extra {
+
+/** LoserTree
+ *
+ * Tournament tree of a k-way merge. Every inner node keeps the run that lost the
+ * match played there and the winner moves up, so the root winner is the next item to
+ * output. Once it is taken, only the log(k) matches on the path of its run are played
+ * again. Equal items are taken from the run added first, so merges are stable.
+ **/
+template <typename T, typename Compare>
+class LoserTree {
+ public:
+  LoserTree(const std::vector<std::pair<const T*, const T*>>& runs, Compare comp)
+      : runs_(runs), comp_(comp) {
+    num_leaves_ = 1;
+    while (num_leaves_ < static_cast<int>(runs_.size())) num_leaves_ *= 2;
+    // leaves past the runs are empty runs, they lose every match
+    runs_.resize(num_leaves_, std::make_pair(nullptr, nullptr));
+    tree_.resize(num_leaves_);
+    std::vector<int> winners(num_leaves_ * 2);
+    for (int i = 0; i < num_leaves_; i++) winners[num_leaves_ + i] = i;
+    for (int node = num_leaves_ - 1; node >= 1; node--) {
+      int left = winners[node * 2];
+      int right = winners[node * 2 + 1];
+      if (Beats(left, right)) {
+        winners[node] = left;
+        tree_[node] = right;
+      } else {
+        winners[node] = right;
+        tree_[node] = left;
+      }
+    }
+    tree_[0] = winners[1];
+  }
+
+  bool Empty() const { return IsExhausted(tree_[0]); }
+
+  /* Takes the next item in merge order, the tree must not be empty */
+  const T& Pop() {
+    int winner = tree_[0];
+    const T& item = *runs_[winner].first++;
+    for (int node = (winner + num_leaves_) / 2; node >= 1; node /= 2) {
+      if (Beats(tree_[node], winner)) std::swap(tree_[node], winner);
+    }
+    tree_[0] = winner;
+    return item;
+  }
+
+ private:
+  bool IsExhausted(int run) const { return runs_[run].first == runs_[run].second; }
+
+  bool Beats(int x, int y) {
+    if (IsExhausted(x)) return false;
+    if (IsExhausted(y)) return true;
+    if (comp_(*runs_[y].first, *runs_[x].first)) return false;
+    if (comp_(*runs_[x].first, *runs_[y].first)) return true;
+    return x < y;
+  }
+
+  std::vector<std::pair<const T*, const T*>> runs_;
+  std::vector<int> tree_;
+  int num_leaves_;
+  Compare comp_;
+};
+
+/* Merges consecutive runs of begin, run i holds run_lengths[i] items sorted by comp,
+ * so that all of them are sorted by comp. */
+template <typename T, typename Compare>
+arrow::Status MergeSortedRuns(arrow::MemoryPool* pool, T* begin,
+                              const std::vector<int64_t>& run_lengths, Compare comp) {
+  std::vector<std::pair<const T*, const T*>> runs;
+  int64_t length = 0;
+  for (auto run_length : run_lengths) {
+    if (run_length > 0) {
+      runs.emplace_back(begin + length, begin + length + run_length);
+    }
+    length += run_length;
+  }
+  if (runs.size() <= 1) return arrow::Status::OK();
+  std::shared_ptr<arrow::Buffer> out_buf;
+  RETURN_NOT_OK(arrow::AllocateBuffer(pool, length * sizeof(T), &out_buf));
+  T* out = reinterpret_cast<T*>(out_buf->mutable_data());
+  LoserTree<T, Compare> tree(runs, comp);
+  for (int64_t i = 0; i < length; i++) out[i] = tree.Pop();
+  std::memcpy(begin, out, length * sizeof(T));
+  return arrow::Status::OK();
+}
+
+}  // namespace extra
+}  // namespace arrowcompute
+}  // namespace codegen
+}  // namespace sparkcolumnarplugin
@@ -0,0 +1,387 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <arrow/memory_pool.h>
+#include <arrow/status.h>
+#include <arrow/type.h>
+#include <arrow/type_traits.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "codegen/arrow_compute/ext/array_item_index.h"
+#include "codegen/arrow_compute/ext/parallel_sort.h"
+#include "codegen/arrow_compute/ext/string_dictionary.h"
+#include "third_party/timsort.hpp"
+
+namespace sparkcolumnarplugin {
+namespace codegen {
+namespace arrowcompute {
+namespace extra {
+
+/** NormalizedKeySorter
+ *
+ * Sorts rows on multiple keys by a normalized key: the sort keys of a row encoded
+ * once into at most 16 bytes, which compare with memcmp in the order of the keys.
+ * Per key, the encoding is
+ *   - one byte ordering null against valid, only if the key has nulls,
+ *   - the value as unsigned big endian, with the sign bit of integers flipped and
+ *     floating point mapped to its total order (-0.0 as 0.0, NaN the largest),
+ *   - all value bytes inverted for a descending key.
+ * A string key with few distinct values takes 4 bytes, the order preserving code of
+ * its value in a StringDictionary. Any other string key takes the rest of the 16
+ * bytes as a zero padded prefix and ends the encoded keys. Keys which don't fit are
+ * not encoded.
+ *
+ * (normalized key, row index) pairs are sorted by a stable LSD radix sort, which
+ * skips bytes that are the same in all rows. When some key is a string or is not
+ * encoded, runs of equal normalized keys are then sorted again by the comparator of
+ * all keys. As both sorts are stable the result is what timsort with the comparator
+ * returns.
+ **/
+class NormalizedKeySorter {
+ public:
+  static constexpr int kMaxKeyWidth = 16;
+
+  /* out is null if the first key can't be encoded */
+  static arrow::Status Make(arrow::MemoryPool* pool,
+                            const std::vector<arrow::ArrayVector>& key_columns,
+                            const std::vector<std::shared_ptr<arrow::DataType>>& key_types,
+                            const std::vector<bool>& sort_directions,
+                            const std::vector<bool>& nulls_order,
+                            std::shared_ptr<NormalizedKeySorter>* out) {
+    std::vector<KeyLayout> layouts;
+    int width = 0;
+    bool tie_break = false;
+    for (int i = 0; i < key_columns.size(); i++) {
+      int64_t null_total = 0;
+      for (auto& array : key_columns[i]) null_total += array->null_count();
+      KeyLayout layout;
+      layout.type_id = key_types[i]->id();
+      layout.offset = width;
+      layout.has_null_byte = null_total > 0;
+      layout.asc = sort_directions[i];
+      layout.nulls_first = nulls_order[i];
+      int remaining = kMaxKeyWidth - width - (layout.has_null_byte ? 1 : 0);
+      int value_width = FixedValueWidth(layout.type_id);
+      if (layout.type_id == arrow::Type::STRING &&
+          remaining >= static_cast<int>(sizeof(uint32_t))) {
+        RETURN_NOT_OK(StringDictionary::Make(pool, key_columns[i], &layout.dictionary));
+        if (layout.dictionary) value_width = sizeof(uint32_t);
+      }
+      if (layout.type_id == arrow::Type::STRING && !layout.dictionary && remaining > 0) {
+        // a prefix doesn't order the keys after it
+        layout.value_width = remaining;
+        layouts.push_back(layout);
+        width = kMaxKeyWidth;
+        tie_break = true;
+        break;
+      }
+      if (value_width == 0 || value_width > remaining) {
+        tie_break = true;
+        break;
+      }
+      layout.value_width = value_width;
+      layouts.push_back(layout);
+      width += (layout.has_null_byte ? 1 : 0) + value_width;
+    }
+    if (layouts.empty()) {
+      *out = nullptr;
+      return arrow::Status::OK();
+    }
+    *out = std::shared_ptr<NormalizedKeySorter>(
+        new NormalizedKeySorter(key_columns, std::move(layouts), width, tie_break));
+    return arrow::Status::OK();
+  }
+
+  /* Sorts indices in place, comp orders rows on all keys as the sort is asked to */
+  template <typename Compare>
+  arrow::Status Sort(arrow::MemoryPool* pool, ArrayItemIndexS* indices_begin,
+                     int64_t length, int num_threads, Compare comp) {
+    if (width_ <= 8) {
+      return SortInternal<8>(pool, indices_begin, length, num_threads, comp);
+    }
+    return SortInternal<kMaxKeyWidth>(pool, indices_begin, length, num_threads, comp);
+  }
+
+ private:
+  struct KeyLayout {
+    arrow::Type::type type_id;
+    int offset;
+    int value_width;
+    bool has_null_byte;
+    bool asc;
+    bool nulls_first;
+    std::shared_ptr<StringDictionary> dictionary;
+  };
+
+  template <int kWidth>
+  struct Item {
+    uint8_t key[kWidth];
+    ArrayItemIndexS index;
+  };
+
+  NormalizedKeySorter(const std::vector<arrow::ArrayVector>& key_columns,
+                      std::vector<KeyLayout> layouts, int width, bool tie_break)
+      : key_columns_(key_columns),
+        layouts_(std::move(layouts)),
+        width_(width),
+        tie_break_(tie_break) {}
+
+  static int FixedValueWidth(arrow::Type::type type_id) {
+    switch (type_id) {
+      case arrow::Type::BOOL:
+      case arrow::Type::UINT8:
+      case arrow::Type::INT8:
+        return 1;
+      case arrow::Type::UINT16:
+      case arrow::Type::INT16:
+        return 2;
+      case arrow::Type::UINT32:
+      case arrow::Type::INT32:
+      case arrow::Type::FLOAT:
+      case arrow::Type::DATE32:
+        return 4;
+      case arrow::Type::UINT64:
+      case arrow::Type::INT64:
+      case arrow::Type::DOUBLE:
+      case arrow::Type::DATE64:
+        return 8;
+      default:
+        return 0;
+    }
+  }
+
+  static void StoreBigEndian(uint8_t value, uint8_t* dst) { *dst = value; }
+  static void StoreBigEndian(uint16_t value, uint8_t* dst) {
+    value = __builtin_bswap16(value);
+    std::memcpy(dst, &value, sizeof(value));
+  }
+  static void StoreBigEndian(uint32_t value, uint8_t* dst) {
+    value = __builtin_bswap32(value);
+    std::memcpy(dst, &value, sizeof(value));
+  }
+  static void StoreBigEndian(uint64_t value, uint8_t* dst) {
+    value = __builtin_bswap64(value);
+    std::memcpy(dst, &value, sizeof(value));
+  }
+
+  template <typename CType>
+  static typename std::enable_if<std::is_integral<CType>::value>::type EncodeValue(
+      CType value, int width, uint8_t* dst) {
+    using UType = typename std::make_unsigned<CType>::type;
+    auto bits = static_cast<UType>(value);
+    if (std::is_signed<CType>::value) {
+      bits ^= static_cast<UType>(UType(1) << (sizeof(UType) * 8 - 1));
+    }
+    StoreBigEndian(bits, dst);
+  }
+
+  template <typename CType>
+  static typename std::enable_if<std::is_floating_point<CType>::value>::type EncodeValue(
+      CType value, int width, uint8_t* dst) {
+    using UType = typename std::conditional<sizeof(CType) == 4, uint32_t, uint64_t>::type;
+    const UType sign_bit = UType(1) << (sizeof(UType) * 8 - 1);
+    if (std::isnan(value)) {
+      value = std::numeric_limits<CType>::quiet_NaN();
+    } else if (value == 0) {
+      value = 0;
+    }
+    UType bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    bits = (bits & sign_bit) ? ~bits : (bits | sign_bit);
+    StoreBigEndian(bits, dst);
+  }
+
+  static void EncodeValue(bool value, int width, uint8_t* dst) { *dst = value; }
+
+  static void EncodeValue(arrow::util::string_view value, int width, uint8_t* dst) {
+    auto prefix_size = std::min(static_cast<int>(value.size()), width);
+    std::memcpy(dst, value.data(), prefix_size);
+  }
+
+  template <int kWidth, typename DataType>
+  void EncodeColumn(const KeyLayout& layout, const arrow::ArrayVector& arrays,
+                    Item<kWidth>* items) {
+    using ArrayType = typename arrow::TypeTraits<DataType>::ArrayType;
+    const uint8_t null_byte = layout.nulls_first ? 0 : 1;
+    auto item = items;
+    for (auto& array : arrays) {
+      auto typed_array = std::dynamic_pointer_cast<ArrayType>(array);
+      bool has_null = typed_array->null_count() > 0;
+      for (int64_t i = 0; i < typed_array->length(); i++, item++) {
+        uint8_t* dst = item->key + layout.offset;
+        if (layout.has_null_byte) {
+          if (has_null && typed_array->IsNull(i)) {
+            *dst = null_byte;
+            continue;
+          }
+          *dst++ = 1 - null_byte;
+        }
+        EncodeValue(typed_array->GetView(i), layout.value_width, dst);
+        if (!layout.asc) {
+          for (int b = 0; b < layout.value_width; b++) dst[b] = ~dst[b];
+        }
+      }
+    }
+  }
+
+  template <int kWidth>
+  void EncodeDictionaryColumn(const KeyLayout& layout, const arrow::ArrayVector& arrays,
+                              Item<kWidth>* items) {
+    const uint8_t null_byte = layout.nulls_first ? 0 : 1;
+    auto item = items;
+    for (int array_id = 0; array_id < arrays.size(); array_id++) {
+      auto& array = arrays[array_id];
+      bool has_null = array->null_count() > 0;
+      for (int64_t i = 0; i < array->length(); i++, item++) {
+        uint8_t* dst = item->key + layout.offset;
+        if (layout.has_null_byte) {
+          if (has_null && array->IsNull(i)) {
+            *dst = null_byte;
+            continue;
+          }
+          *dst++ = 1 - null_byte;
+        }
+        EncodeValue(layout.dictionary->GetCode(array_id, i), layout.value_width, dst);
+        if (!layout.asc) {
+          for (int b = 0; b < layout.value_width; b++) dst[b] = ~dst[b];
+        }
+      }
+    }
+  }
+
+  template <int kWidth>
+  void Encode(Item<kWidth>* items) {
+    for (int i = 0; i < layouts_.size(); i++) {
+      auto& layout = layouts_[i];
+      if (layout.dictionary) {
+        EncodeDictionaryColumn<kWidth>(layout, key_columns_[i], items);
+        continue;
+      }
+      switch (layout.type_id) {
+#define PROCESS(InType)                                               \
+  case InType::type_id: {                                             \
+    EncodeColumn<kWidth, InType>(layout, key_columns_[i], items);     \
+  } break;
+        PROCESS(arrow::BooleanType)
+        PROCESS(arrow::UInt8Type)
+        PROCESS(arrow::Int8Type)
+        PROCESS(arrow::UInt16Type)
+        PROCESS(arrow::Int16Type)
+        PROCESS(arrow::UInt32Type)
+        PROCESS(arrow::Int32Type)
+        PROCESS(arrow::UInt64Type)
+        PROCESS(arrow::Int64Type)
+        PROCESS(arrow::FloatType)
+        PROCESS(arrow::DoubleType)
+        PROCESS(arrow::Date32Type)
+        PROCESS(arrow::Date64Type)
+        PROCESS(arrow::StringType)
+#undef PROCESS
+        default:
+          break;
+      }
+    }
+  }
+
+  /* Stable LSD radix sort on the first width bytes, result is left in items */
+  template <int kWidth>
+  static void RadixSort(Item<kWidth>* items, Item<kWidth>* tmp, int64_t length,
+                        int width) {
+    if (length == 0) return;
+    std::vector<int64_t> histograms(width * 256, 0);
+    for (int64_t i = 0; i < length; i++) {
+      for (int b = 0; b < width; b++) histograms[b * 256 + items[i].key[b]]++;
+    }
+    auto src = items;
+    auto dst = tmp;
+    for (int b = width - 1; b >= 0; b--) {
+      int64_t* counts = histograms.data() + b * 256;
+      if (counts[src[0].key[b]] == length) continue;
+      int64_t offset = 0;
+      for (int v = 0; v < 256; v++) {
+        auto count = counts[v];
+        counts[v] = offset;
+        offset += count;
+      }
+      for (int64_t i = 0; i < length; i++) dst[counts[src[i].key[b]]++] = src[i];
+      std::swap(src, dst);
+    }
+    if (src != items) std::memcpy(items, src, length * sizeof(Item<kWidth>));
+  }
+
+  template <int kWidth, typename Compare>
+  arrow::Status SortInternal(arrow::MemoryPool* pool, ArrayItemIndexS* indices_begin,
+                             int64_t length, int num_threads, Compare comp) {
+    if (length == 0) return arrow::Status::OK();
+    std::shared_ptr<arrow::Buffer> items_buf;
+    std::shared_ptr<arrow::Buffer> tmp_buf;
+    RETURN_NOT_OK(
+        arrow::AllocateBuffer(pool, length * sizeof(Item<kWidth>), &items_buf));
+    RETURN_NOT_OK(arrow::AllocateBuffer(pool, length * sizeof(Item<kWidth>), &tmp_buf));
+    auto items = reinterpret_cast<Item<kWidth>*>(items_buf->mutable_data());
+    auto tmp = reinterpret_cast<Item<kWidth>*>(tmp_buf->mutable_data());
+    std::memset(items, 0, length * sizeof(Item<kWidth>));
+    for (int64_t i = 0; i < length; i++) items[i].index = indices_begin[i];
+    Encode<kWidth>(items);
+
+    // chunks sorted on different threads are merged in normalized key order
+    auto width = width_;
+    RETURN_NOT_OK(ParallelSort(
+        pool, items, items + length, num_threads,
+        [items, tmp, width](Item<kWidth>* begin, Item<kWidth>* end) {
+          RadixSort<kWidth>(begin, tmp + (begin - items), end - begin, width);
+        },
+        [width](const Item<kWidth>& x, const Item<kWidth>& y) {
+          return std::memcmp(x.key, y.key, width) < 0;
+        }));
+    for (int64_t i = 0; i < length; i++) indices_begin[i] = items[i].index;
+    if (!tie_break_) return arrow::Status::OK();
+    int64_t run_begin = 0;
+    for (int64_t i = 1; i <= length; i++) {
+      if (i < length && std::memcmp(items[i].key, items[run_begin].key, width_) == 0) {
+        continue;
+      }
+      if (i - run_begin > 1) {
+        gfx::timsort(indices_begin + run_begin, indices_begin + i, comp);
+      }
+      run_begin = i;
+    }
+    return arrow::Status::OK();
+  }
+
+  std::vector<arrow::ArrayVector> key_columns_;
+  std::vector<KeyLayout> layouts_;
+  int width_;
+  bool tie_break_;
+};
+
+}  // namespace extra
+}  // namespace arrowcompute
+}  // namespace codegen
+}  // namespace sparkcolumnarplugin
@@ -0,0 +1,152 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/buffer.h>
+#include <arrow/memory_pool.h>
+#include <arrow/status.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "codegen/common/thread_pool.h"
+
+namespace sparkcolumnarplugin {
+namespace codegen {
+namespace arrowcompute {
+namespace extra {
+
+/* Smallest number of rows worth sorting on a thread of its own */
+static constexpr int64_t kMinParallelSortRows = 1 << 16;
+
+/* Rows of a taken from the first k rows of the stable merge of a and b */
+template <typename T, typename Compare>
+int64_t MergePathSplit(T* a, int64_t a_length, T* b, int64_t b_length, int64_t k,
+                       Compare& comp) {
+  int64_t lo = std::max(static_cast<int64_t>(0), k - b_length);
+  int64_t hi = std::min(k, a_length);
+  while (lo < hi) {
+    int64_t mid = lo + (hi - lo) / 2;
+    if (!comp(b[k - mid - 1], a[mid])) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/** ParallelSort
+ *
+ * Sorts [begin, end) as sort(begin, end) does, on up to num_threads threads of
+ * ThreadPool::Default(). The input is cut into one chunk per thread and each chunk is
+ * sorted by sort as a task of its own.
+ * Sorted chunks are then merged pairwise with comp, which must be the order sort
+ * produces, until one is left. Every round of merges keeps all threads busy, as each
+ * merge is cut by merge path into parts of the same size. Merges take equal rows from
+ * the left first, so the result is stable when sort is.
+ * Inputs shorter than min_rows_per_thread per thread are sorted on fewer threads.
+ **/
+template <typename T, typename Sort, typename Compare>
+arrow::Status ParallelSort(arrow::MemoryPool* pool, T* begin, T* end, int num_threads,
+                           Sort sort, Compare comp,
+                           int64_t min_rows_per_thread = kMinParallelSortRows) {
+  int64_t length = end - begin;
+  int num_chunks = static_cast<int>(
+      std::min(static_cast<int64_t>(num_threads), length / min_rows_per_thread));
+  if (num_chunks <= 1) {
+    sort(begin, end);
+    return arrow::Status::OK();
+  }
+  std::shared_ptr<arrow::Buffer> tmp_buf;
+  RETURN_NOT_OK(arrow::AllocateBuffer(pool, length * sizeof(T), &tmp_buf));
+  T* tmp = reinterpret_cast<T*>(tmp_buf->mutable_data());
+
+  std::vector<int64_t> bounds;
+  for (int i = 0; i <= num_chunks; i++) bounds.push_back(length * i / num_chunks);
+  auto thread_pool = ThreadPool::Default();
+  thread_pool->ParallelFor(num_chunks,
+                           [&](int i) { sort(begin + bounds[i], begin + bounds[i + 1]); });
+
+  struct MergePart {
+    int64_t a_begin;
+    int64_t a_end;
+    int64_t b_begin;
+    int64_t b_end;
+    int64_t out_begin;
+  };
+  T* src = begin;
+  T* dst = tmp;
+  while (bounds.size() > 2) {
+    std::vector<int64_t> next_bounds;
+    std::vector<MergePart> parts;
+    for (int i = 0; i + 1 < bounds.size(); i += 2) {
+      int64_t a_begin = bounds[i];
+      int64_t b_begin = bounds[i + 1];
+      int64_t b_end = i + 2 < bounds.size() ? bounds[i + 2] : b_begin;
+      int64_t a_length = b_begin - a_begin;
+      int64_t b_length = b_end - b_begin;
+      int64_t merge_length = a_length + b_length;
+      int num_parts = static_cast<int>(
+          std::max(static_cast<int64_t>(1), num_threads * merge_length / length));
+      int64_t a_prev = 0;
+      for (int p = 1; p <= num_parts; p++) {
+        int64_t k = merge_length * p / num_parts;
+        int64_t a_split = p == num_parts ? a_length
+                                         : MergePathSplit(src + a_begin, a_length,
+                                                          src + b_begin, b_length, k, comp);
+        int64_t k_prev = merge_length * (p - 1) / num_parts;
+        parts.push_back({a_begin + a_prev, a_begin + a_split, b_begin + (k_prev - a_prev),
+                         b_begin + (k - a_split), a_begin + k_prev});
+        a_prev = a_split;
+      }
+      next_bounds.push_back(a_begin);
+    }
+    next_bounds.push_back(length);
+    int num_workers = static_cast<int>(std::min<size_t>(num_threads, parts.size()));
+    thread_pool->ParallelFor(num_workers, [&](int w) {
+      for (int p = w; p < parts.size(); p += num_workers) {
+        auto& part = parts[p];
+        std::merge(src + part.a_begin, src + part.a_end, src + part.b_begin,
+                   src + part.b_end, dst + part.out_begin, comp);
+      }
+    });
+    std::swap(src, dst);
+    bounds.swap(next_bounds);
+  }
+  if (src != begin) std::memcpy(begin, src, length * sizeof(T));
+  return arrow::Status::OK();
+}
+
+/* ParallelSort with std::sort on each chunk */
+template <typename T, typename Compare>
+arrow::Status ParallelSort(arrow::MemoryPool* pool, T* begin, T* end, int num_threads,
+                           Compare comp,
+                           int64_t min_rows_per_thread = kMinParallelSortRows) {
+  return ParallelSort(
+      pool, begin, end, num_threads, [&comp](T* b, T* e) { std::sort(b, e, comp); },
+      comp, min_rows_per_thread);
+}
+
+}  // namespace extra
+}  // namespace arrowcompute
+}  // namespace codegen
+}  // namespace sparkcolumnarplugin
@@ -33,10 +33,15 @@
 
 #include "array_appender.h"
 #include "cmp_function.h"
+#include "codegen/arrow_compute/ext/array_gather.h"
 #include "codegen/arrow_compute/ext/array_item_index.h"
 #include "codegen/arrow_compute/ext/code_generator_base.h"
 #include "codegen/arrow_compute/ext/codegen_common.h"
 #include "codegen/arrow_compute/ext/kernels_ext.h"
+#include "codegen/arrow_compute/ext/loser_tree.h"
+#include "codegen/arrow_compute/ext/normalized_key.h"
+#include "codegen/arrow_compute/ext/parallel_sort.h"
+#include "codegen/arrow_compute/ext/string_dictionary.h"
 #include "codegen/arrow_compute/ext/typed_node_visitor.h"
 #include "precompile/array.h"
 #include "precompile/type.h"
@@ -60,7 +65,20 @@
  * If sorting for multiple keys, there are two kernels to use. When enabling codegen,
  * SortArraysToIndicesKernel is used, which will do codegen. When disabling codegen, 
  * SortMultiplekeyKernel is used, which uses std::function to do comparison. In both 
- * kernels, timsort is used.
+ * kernels, timsort is used. SortMultiplekeyKernel radix sorts normalized keys first
+ * when the leading keys can be encoded, see NormalizedKeySorter, and only uses the
+ * comparison to order rows whose encoded keys are equal.
+ * SortOnekeyKernel and SortMultiplekeyKernel check whether each batch is already in
+   sort order as it arrives. If all of them are, sorted batches are only merged, by
+   a loser tree (MergeSortedRuns), in O(n log k) for k batches.
+ * With a thread budget over 1 (NATIVESQL_SORT_THREADS), all the four kernels sort
+   chunks of the input on their own threads and merge them, see ParallelSort.
+ * With a limit (ORDER BY ... LIMIT), TopKKernel is used for any keys instead. It only
+   keeps the first limit rows in a heap, using the comparison of SortMultiplekeyKernel.
+ * When a SortRelation is asked for (result_type 1, a sort feeding SortMergeJoin),
+   SortOnekeyKernel or SortMultiplekeyKernel is used, and only the row indices are
+   sorted. Payload cols are not gathered, the relation reads them through the sorted
+   indices only for rows the consumer asks for.
  * Projection is supported in all the four kernels. If projection is required,
    projection is completed before sort, and the projected cols are used to do
    comparison.
@@ -122,6 +140,7 @@ class SortArraysToIndicesKernel::Impl {
       func_args_ss << "[sort_key_" << i << "]" << field->type()->ToString();
     }
 
+    func_args_ss << "[threads]" << GetSortThreads();
     func_args_ss << "[schema]";
     for (auto field : result_schema->fields()) {
       func_args_ss << field->type()->ToString();
@@ -257,6 +276,10 @@ class SortArraysToIndicesKernel::Impl {
         GetCompFunction(key_index_list_, key_projector_, projected_types_,
                         key_field_list_, sort_directions_, nulls_order_);
 
+    std::string make_dictionary_str = GetMakeStringDictionary();
+
+    std::string dictionary_define_str = GetStringDictionaryDefine();
+
     std::string pre_sort_valid_str = GetPreSortValid();
 
     std::string pre_sort_null_str = GetPreSortNull();
@@ -302,6 +325,8 @@ class SortArraysToIndicesKernel::Impl {
 #include <cmath>
 
 #include "codegen/arrow_compute/ext/array_item_index.h"
+#include "codegen/arrow_compute/ext/parallel_sort.h"
+#include "codegen/arrow_compute/ext/string_dictionary.h"
 #include "codegen/common/sort_relation.h"
 #include "precompile/builder.h"
 #include "precompile/type.h"
@@ -328,7 +353,7 @@ class TypedSorterImpl : public CodeGenBase {
   arrow::Status FinishInternal(std::shared_ptr<FixedSizeBinaryArray>* out) {
     // we should support nulls first and nulls last here
     // we should also support desc and asc here
-    )" + comp_func_str +
+    )" + make_dictionary_str + comp_func_str +
            R"(
     // initiate buffer for all arrays
     std::shared_ptr<arrow::Buffer> indices_buf;
@@ -368,7 +393,7 @@ class TypedSorterImpl : public CodeGenBase {
   
  private:
   )" + cached_variables_define_str +
-           projected_variables_str +
+           projected_variables_str + dictionary_define_str +
            R"(
   std::vector<int64_t> length_list_;
   arrow::compute::FunctionContext* ctx_;
@@ -376,19 +401,6 @@ class TypedSorterImpl : public CodeGenBase {
   uint64_t items_total_ = 0;
   uint64_t nulls_total_ = 0;
 
-  class SortRelationResultIterator : public ResultIterator<SortRelation> {
-   public:
-    SortRelationResultIterator(std::shared_ptr<SortRelation> sort_relation)
-        : sort_relation_(sort_relation) {}
-    arrow::Status Next(std::shared_ptr<SortRelation>* out) {
-      *out = sort_relation_;
-      return arrow::Status::OK();
-    }
-
-   private:
-    std::shared_ptr<SortRelation> sort_relation_;
-  };
-
   class SorterResultIterator : public ResultIterator<arrow::RecordBatch> {
    public:
     SorterResultIterator(arrow::compute::FunctionContext* ctx,
@@ -461,6 +473,41 @@ extern "C" void MakeCodeGen(arrow::compute::FunctionContext* ctx,
     }
     return ss.str();
   }
+  /* Cached arrays of string keys, as named in the codes */
+  std::vector<std::string> GetStringKeyArrays() {
+    std::vector<std::string> key_arrays;
+    for (int i = 0; i < key_field_list_.size(); i++) {
+      if (key_projector_) {
+        if (projected_types_[i]->id() == arrow::Type::STRING) {
+          key_arrays.push_back("projected_" + std::to_string(i) + "_");
+        }
+      } else if (key_field_list_[i]->type()->id() == arrow::Type::STRING) {
+        key_arrays.push_back("cached_" + std::to_string(key_index_list_[i]) + "_");
+      }
+    }
+    return key_arrays;
+  }
+  std::string GetStringDictionaryDefine() {
+    std::stringstream ss;
+    for (auto& key_array : GetStringKeyArrays()) {
+      ss << "std::shared_ptr<StringDictionary> " << key_array << "dictionary_;"
+         << std::endl;
+    }
+    return ss.str();
+  }
+  std::string GetMakeStringDictionary() {
+    std::stringstream ss;
+    for (auto& key_array : GetStringKeyArrays()) {
+      ss << "{" << std::endl;
+      ss << "arrow::ArrayVector arrays;" << std::endl;
+      ss << "for (auto& arr : " << key_array << ") arrays.push_back(arr->cache_);"
+         << std::endl;
+      ss << "RETURN_NOT_OK(StringDictionary::Make(ctx_->memory_pool(), arrays, &"
+         << key_array << "dictionary_));" << std::endl;
+      ss << "}" << std::endl;
+    }
+    return ss.str();
+  }
   std::string GetCompFunction(
       const std::vector<int>& sort_key_index_list,
       const std::shared_ptr<gandiva::Projector>& key_projector,
@@ -513,6 +560,10 @@ extern "C" void MakeCodeGen(arrow::compute::FunctionContext* ctx,
         array + std::to_string(cur_key_id) + "_[y.array_id]->GetView(y.id)";
     auto y_str_value =
         array + std::to_string(cur_key_id) + "_[y.array_id]->GetString(y.id)";
+    // string keys with few distinct values compare by the codes of their dictionary
+    auto dictionary = array + std::to_string(cur_key_id) + "_dictionary_";
+    auto x_code = dictionary + "->GetCode(x.array_id, x.id)";
+    auto y_code = dictionary + "->GetCode(y.array_id, y.id)";
     auto is_x_null = array + std::to_string(cur_key_id) + "_[x.array_id]->IsNull(x.id)";
     auto is_y_null = array + std::to_string(cur_key_id) + "_[y.array_id]->IsNull(y.id)";
     auto is_x_nan = "std::isnan(" + x_num_value + ")";
@@ -560,13 +611,15 @@ extern "C" void MakeCodeGen(arrow::compute::FunctionContext* ctx,
     // For string type of data, GetString should be used instead of GetView.
     if (asc) {
       if (data_type->id() == arrow::Type::STRING) {
-        ss << "return " << x_str_value << " < " << y_str_value << ";\n}\n";
+        ss << "return " << dictionary << " ? " << x_code << " < " << y_code << " : "
+           << x_str_value << " < " << y_str_value << ";\n}\n";
       } else {
         ss << "return " << x_num_value << " < " << y_num_value << ";\n}\n";
       }
     } else {
       if (data_type->id() == arrow::Type::STRING) {
-        ss << "return " << x_str_value << " > " << y_str_value << ";\n}\n";
+        ss << "return " << dictionary << " ? " << x_code << " > " << y_code << " : "
+           << x_str_value << " > " << y_str_value << ";\n}\n";
       } else {
         ss << "return " << x_num_value << " > " << y_num_value << ";\n}\n";
       }
@@ -578,7 +631,8 @@ extern "C" void MakeCodeGen(arrow::compute::FunctionContext* ctx,
     // clear the contents of stringstream
     ss.str(std::string());
     if (data_type->id() == arrow::Type::STRING) {
-      ss << "if ((" << is_x_null << " && " << is_y_null << ") || (" << x_str_value
+      ss << "if ((" << is_x_null << " && " << is_y_null << ") || (" << dictionary
+         << " ? " << x_code << " == " << y_code << " : " << x_str_value
          << " == " << y_str_value << ")) {";
     } else {
       if (NaN_check_ && (data_type->id() == arrow::Type::DOUBLE ||
@@ -620,6 +674,14 @@ extern "C" void MakeCodeGen(arrow::compute::FunctionContext* ctx,
     }
   }
   std::string GetSortFunction() {
+    auto num_threads = GetSortThreads();
+    if (num_threads > 1) {
+      return "RETURN_NOT_OK(ParallelSort(ctx_->memory_pool(), indices_begin, "
+             "indices_begin + items_total_, " +
+             std::to_string(num_threads) +
+             ", [&comp](ArrayItemIndexS* begin, ArrayItemIndexS* end) { "
+             "gfx::timsort(begin, end, comp); }, comp));";
+    }
     return "gfx::timsort(indices_begin, indices_begin + "
            "items_total_, "
            "comp);";
@@ -800,7 +862,8 @@ class SortInplaceKernel : public SortArraysToIndicesKernel::Impl {
         asc_(sort_directions[0]),
         result_schema_(result_schema),
         key_projector_(key_projector),
-        NaN_check_(NaN_check) {}
+        NaN_check_(NaN_check),
+        num_threads_(GetSortThreads()) {}
 
   arrow::Status Evaluate(const ArrayList& in) override {
     num_batches_++;
@@ -825,14 +888,16 @@ class SortInplaceKernel : public SortArraysToIndicesKernel::Impl {
   // If NaN_check_ is true, we need to do partition for NaN before sort.
   template <typename TYPE>
   auto SortNoNull(TYPE* indices_begin, TYPE* indices_end) ->
-      typename std::enable_if_t<std::is_floating_point<TYPE>::value> {
+      typename std::enable_if_t<std::is_floating_point<TYPE>::value, arrow::Status> {
     if (asc_) {
       auto sort_end = indices_end;
       if (NaN_check_) {
         sort_end = std::partition(indices_begin, indices_end,
                                   [](TYPE i) { return !std::isnan(i); });
       }
-      ska_sort(indices_begin, sort_end);
+      return ParallelSort(
+          ctx_->memory_pool(), indices_begin, sort_end, num_threads_,
+          [](TYPE* begin, TYPE* end) { ska_sort(begin, end); }, std::less<TYPE>());
     } else {
       auto sort_begin = indices_begin;
       if (NaN_check_) {
@@ -840,19 +905,23 @@ class SortInplaceKernel : public SortArraysToIndicesKernel::Impl {
                                     [](TYPE i) { return std::isnan(i); });
       }
       auto desc_comp = [this](TYPE& x, TYPE& y) { return x > y; };
-      std::sort(sort_begin, indices_end, desc_comp);
+      return ParallelSort(ctx_->memory_pool(), sort_begin, indices_end, num_threads_,
+                          desc_comp);
     }
   }
 
   // This function is used for non-float and non-double data without null value.
   template <typename TYPE>
   auto SortNoNull(TYPE* indices_begin, TYPE* indices_end) ->
-      typename std::enable_if_t<!std::is_floating_point<TYPE>::value> {
+      typename std::enable_if_t<!std::is_floating_point<TYPE>::value, arrow::Status> {
     if (asc_) {
-      ska_sort(indices_begin, indices_end);
+      return ParallelSort(
+          ctx_->memory_pool(), indices_begin, indices_end, num_threads_,
+          [](TYPE* begin, TYPE* end) { ska_sort(begin, end); }, std::less<TYPE>());
     } else {
       auto desc_comp = [this](TYPE& x, TYPE& y) { return x > y; };
-      std::sort(indices_begin, indices_end, desc_comp);
+      return ParallelSort(ctx_->memory_pool(), indices_begin, indices_end, num_threads_,
+                          desc_comp);
     }
   }
 
@@ -860,8 +929,15 @@ class SortInplaceKernel : public SortArraysToIndicesKernel::Impl {
   // We should do partition for null and NaN (if (NaN_check_ is true).
   template <typename TYPE, typename ArrayType>
   auto Sort(int64_t* indices_begin, int64_t* indices_end, const ArrayType& values) ->
-      typename std::enable_if_t<std::is_floating_point<TYPE>::value> {
+      typename std::enable_if_t<std::is_floating_point<TYPE>::value, arrow::Status> {
     std::iota(indices_begin, indices_end, 0);
+    auto asc_comp = [&values](int64_t left, int64_t right) {
+      return values.GetView(left) < values.GetView(right);
+    };
+    auto ska_sort_values = [&values](int64_t* begin, int64_t* end) {
+      ska_sort(begin, end,
+               [&values](auto& x) -> decltype(auto) { return values.GetView(x); });
+    };
     auto sort_begin = indices_begin;
     auto sort_end = indices_end;
 
@@ -877,8 +953,8 @@ class SortInplaceKernel : public SortArraysToIndicesKernel::Impl {
             return !std::isnan(values.GetView(ind));
           });
         }
-        ska_sort(sort_begin, sort_end,
-                 [&values](auto& x) -> decltype(auto) { return values.GetView(x); });
+        return ParallelSort(ctx_->memory_pool(), sort_begin, sort_end, num_threads_,
+                            ska_sort_values, asc_comp);
       } else {
         sort_end = std::partition(indices_begin, indices_end, [&values](uint64_t ind) {
           return !values.IsNull(ind);
@@ -890,11 +966,11 @@ class SortInplaceKernel : public SortArraysToIndicesKernel::Impl {
             return !std::isnan(values.GetView(ind));
           });
         }
-        ska_sort(indices_begin, sort_end,
-                 [&values](auto& x) -> decltype(auto) { return values.GetView(x); });
+        return ParallelSort(ctx_->memory_pool(), indices_begin, sort_end, num_threads_,
+                            ska_sort_values, asc_comp);
       }
     } else {
-      auto comp = [&values](uint64_t left, uint64_t right) {
+      auto comp = [&values](int64_t left, int64_t right) {
         return values.GetView(left) > values.GetView(right);
       };
       if (nulls_first_) {
@@ -908,7 +984,8 @@ class SortInplaceKernel : public SortArraysToIndicesKernel::Impl {
             return std::isnan(values.GetView(ind));
           });
         }
-        std::sort(sort_begin, indices_end, comp);
+        return ParallelSort(ctx_->memory_pool(), sort_begin, indices_end, num_threads_,
+                            comp);
       } else {
         sort_end = std::partition(indices_begin, indices_end, [&values](uint64_t ind) {
           return !values.IsNull(ind);
@@ -920,7 +997,8 @@ class SortInplaceKernel : public SortArraysToIndicesKernel::Impl {
             return std::isnan(values.GetView(ind));
           });
         }
-        std::sort(sort_begin, sort_end, comp);
+        return ParallelSort(ctx_->memory_pool(), sort_begin, sort_end, num_threads_,
+                            comp);
       }
     }
   }
@@ -929,36 +1007,45 @@ class SortInplaceKernel : public SortArraysToIndicesKernel::Impl {
   // We should do partition for null.
   template <typename TYPE, typename ArrayType>
   auto Sort(int64_t* indices_begin, int64_t* indices_end, const ArrayType& values) ->
-      typename std::enable_if_t<!std::is_floating_point<TYPE>::value> {
+      typename std::enable_if_t<!std::is_floating_point<TYPE>::value, arrow::Status> {
     std::iota(indices_begin, indices_end, 0);
+    auto asc_comp = [&values](int64_t left, int64_t right) {
+      return values.GetView(left) < values.GetView(right);
+    };
+    auto ska_sort_values = [&values](int64_t* begin, int64_t* end) {
+      ska_sort(begin, end,
+               [&values](auto& x) -> decltype(auto) { return values.GetView(x); });
+    };
     if (asc_) {
       if (nulls_first_) {
         auto nulls_end =
             std::partition(indices_begin, indices_end,
                            [&values](uint64_t ind) { return values.IsNull(ind); });
-        ska_sort(nulls_end, indices_end,
-                 [&values](auto& x) -> decltype(auto) { return values.GetView(x); });
+        return ParallelSort(ctx_->memory_pool(), nulls_end, indices_end, num_threads_,
+                            ska_sort_values, asc_comp);
       } else {
         auto nulls_begin =
             std::partition(indices_begin, indices_end,
                            [&values](uint64_t ind) { return !values.IsNull(ind); });
-        ska_sort(indices_begin, nulls_begin,
-                 [&values](auto& x) -> decltype(auto) { return values.GetView(x); });
+        return ParallelSort(ctx_->memory_pool(), indices_begin, nulls_begin,
+                            num_threads_, ska_sort_values, asc_comp);
       }
     } else {
-      auto comp = [&values](uint64_t left, uint64_t right) {
+      auto comp = [&values](int64_t left, int64_t right) {
         return values.GetView(left) > values.GetView(right);
       };
       if (nulls_first_) {
         auto nulls_end =
             std::partition(indices_begin, indices_end,
                            [&values](uint64_t ind) { return values.IsNull(ind); });
-        std::sort(nulls_end, indices_end, comp);
+        return ParallelSort(ctx_->memory_pool(), nulls_end, indices_end, num_threads_,
+                            comp);
       } else {
         auto nulls_begin =
             std::partition(indices_begin, indices_end,
                            [&values](uint64_t ind) { return !values.IsNull(ind); });
-        std::sort(indices_begin, nulls_begin, comp);
+        return ParallelSort(ctx_->memory_pool(), indices_begin, nulls_begin,
+                            num_threads_, comp);
       }
     }
   }
@@ -979,7 +1066,8 @@ class SortInplaceKernel : public SortArraysToIndicesKernel::Impl {
       int64_t* indices_begin = reinterpret_cast<int64_t*>(indices_buf->mutable_data());
       int64_t* indices_end = indices_begin + typed_array->length();
 
-      Sort<CTYPE, ArrayType_0>(indices_begin, indices_end, *typed_array.get());
+      RETURN_NOT_OK(
+          Sort<CTYPE, ArrayType_0>(indices_begin, indices_end, *typed_array.get()));
       indices_out = std::make_shared<arrow::UInt64Array>(typed_array->length(),
                                                          std::move(indices_buf));
       std::shared_ptr<arrow::Array> sort_out;
@@ -993,7 +1081,7 @@ class SortInplaceKernel : public SortArraysToIndicesKernel::Impl {
       CTYPE* indices_begin = concatenated_array_->data()->GetMutableValues<CTYPE>(1);
       CTYPE* indices_end = indices_begin + concatenated_array_->length();
 
-      SortNoNull<CTYPE>(indices_begin, indices_end);
+      RETURN_NOT_OK(SortNoNull<CTYPE>(indices_begin, indices_end));
       *out = std::make_shared<SorterResultIterator>(ctx_, schema, concatenated_array_,
                                                     nulls_first_, asc_);
     }
@@ -1010,6 +1098,7 @@ class SortInplaceKernel : public SortArraysToIndicesKernel::Impl {
   bool nulls_first_;
   bool asc_;
   bool NaN_check_;
+  int num_threads_;
   uint64_t num_batches_ = 0;
   uint64_t items_total_ = 0;
   uint64_t nulls_total_ = 0;
@@ -1194,6 +1283,17 @@ class SortInplaceKernel : public SortArraysToIndicesKernel::Impl {
   };
 };
 
+/* Cached batches of one col as a RelationColumn, arrays are referenced but not copied */
+arrow::Status MakeCachedRelationColumn(arrow::Type::type type_id,
+                                       const arrow::ArrayVector& arrays,
+                                       std::shared_ptr<RelationColumn>* out) {
+  RETURN_NOT_OK(MakeRelationColumn(type_id, out));
+  for (auto& arr : arrays) {
+    RETURN_NOT_OK((*out)->AppendColumn(arr));
+  }
+  return arrow::Status::OK();
+}
+
 ///////////////  SortArraysOneKey  ////////////////
 template <typename DATATYPE, typename CTYPE>
 class SortOnekeyKernel : public SortArraysToIndicesKernel::Impl {
@@ -1209,7 +1309,8 @@ class SortOnekeyKernel : public SortArraysToIndicesKernel::Impl {
         asc_(sort_directions[0]),
         result_schema_(result_schema),
         key_projector_(key_projector),
-        NaN_check_(NaN_check) {
+        NaN_check_(NaN_check),
+        num_threads_(GetSortThreads()) {
 #ifdef DEBUG
     std::cout << "UseSortOnekeyKernel" << std::endl;
 #endif
@@ -1239,6 +1340,9 @@ class SortOnekeyKernel : public SortArraysToIndicesKernel::Impl {
       cached_key_.push_back(std::dynamic_pointer_cast<ArrayType_key>(in[key_id_]));
       nulls_total_ += in[key_id_]->null_count();
     }
+    if (batches_sorted_) {
+      CheckLastBatchSorted();
+    }
 
     items_total_ += in[key_id_]->length();
     length_list_.push_back(in[key_id_]->length());
@@ -1251,6 +1355,55 @@ class SortOnekeyKernel : public SortArraysToIndicesKernel::Impl {
     return arrow::Status::OK();
   }
 
+  template <typename T>
+  auto IsPartitionedNaN(T value)
+      -> typename std::enable_if_t<std::is_floating_point<T>::value, bool> {
+    return NaN_check_ && std::isnan(value);
+  }
+
+  template <typename T>
+  auto IsPartitionedNaN(T value)
+      -> typename std::enable_if_t<!std::is_floating_point<T>::value, bool> {
+    return false;
+  }
+
+  /* Clears batches_sorted_ unless the keys of the last batch which Partition doesn't
+   * put aside are in sort order */
+  void CheckLastBatchSorted() {
+    auto& key = cached_key_.back();
+    int64_t valid_length = 0;
+    int64_t prev = -1;
+    for (int64_t i = 0; i < key->length(); i++) {
+      if (key->IsNull(i) || IsPartitionedNaN(key->GetView(i))) continue;
+      if (prev >= 0 && (asc_ ? key->GetView(i) < key->GetView(prev)
+                             : key->GetView(prev) < key->GetView(i))) {
+        batches_sorted_ = false;
+        return;
+      }
+      prev = i;
+      valid_length++;
+    }
+    valid_length_list_.push_back(valid_length);
+  }
+
+  /* Merges the sorted keys of all batches, which Partition leaves batch by batch */
+  arrow::Status MergeBatches(ArrayItemIndexS* indices_begin) {
+    auto merge_begin = nulls_first_ ? indices_begin + nulls_total_ : indices_begin;
+    if (asc_) {
+      return MergeSortedRuns(ctx_->memory_pool(), merge_begin, valid_length_list_,
+                             [this](ArrayItemIndexS x, ArrayItemIndexS y) {
+                               return cached_key_[x.array_id]->GetView(x.id) <
+                                      cached_key_[y.array_id]->GetView(y.id);
+                             });
+    } else {
+      return MergeSortedRuns(ctx_->memory_pool(), merge_begin, valid_length_list_,
+                             [this](ArrayItemIndexS x, ArrayItemIndexS y) {
+                               return cached_key_[x.array_id]->GetView(x.id) >
+                                      cached_key_[y.array_id]->GetView(y.id);
+                             });
+    }
+  }
+
   void PartitionNulls(ArrayItemIndexS* indices_begin, ArrayItemIndexS* indices_end) {
     int64_t indices_i = 0;
     int64_t indices_null = 0;
@@ -1397,18 +1550,25 @@ class SortOnekeyKernel : public SortArraysToIndicesKernel::Impl {
 
   template <typename T>
   auto Sort(ArrayItemIndexS* indices_begin, ArrayItemIndexS* indices_end, int64_t num_nan)
-      -> typename std::enable_if_t<!std::is_same<T, std::string>::value> {
+      -> typename std::enable_if_t<!std::is_same<T, std::string>::value, arrow::Status> {
     if (asc_) {
+      auto comp = [this](ArrayItemIndexS x, ArrayItemIndexS y) {
+        return cached_key_[x.array_id]->GetView(x.id) <
+               cached_key_[y.array_id]->GetView(y.id);
+      };
+      auto ska_sort_key = [this](ArrayItemIndexS* begin, ArrayItemIndexS* end) {
+        ska_sort(begin, end, [this](auto& x) -> decltype(auto) {
+          return cached_key_[x.array_id]->GetView(x.id);
+        });
+      };
       if (nulls_first_) {
-        ska_sort(indices_begin + nulls_total_, indices_begin + items_total_ - num_nan,
-                 [this](auto& x) -> decltype(auto) {
-                   return cached_key_[x.array_id]->GetView(x.id);
-                 });
+        return ParallelSort(ctx_->memory_pool(), indices_begin + nulls_total_,
+                            indices_begin + items_total_ - num_nan, num_threads_,
+                            ska_sort_key, comp);
       } else {
-        ska_sort(indices_begin, indices_begin + items_total_ - nulls_total_ - num_nan,
-                 [this](auto& x) -> decltype(auto) {
-                   return cached_key_[x.array_id]->GetView(x.id);
-                 });
+        return ParallelSort(ctx_->memory_pool(), indices_begin,
+                            indices_begin + items_total_ - nulls_total_ - num_nan,
+                            num_threads_, ska_sort_key, comp);
       }
     } else {
       auto comp = [this](ArrayItemIndexS x, ArrayItemIndexS y) {
@@ -1416,38 +1576,53 @@ class SortOnekeyKernel : public SortArraysToIndicesKernel::Impl {
                cached_key_[y.array_id]->GetView(y.id);
       };
       if (nulls_first_) {
-        std::sort(indices_begin + nulls_total_ + num_nan, indices_begin + items_total_,
-                  comp);
+        return ParallelSort(ctx_->memory_pool(), indices_begin + nulls_total_ + num_nan,
+                            indices_begin + items_total_, num_threads_, comp);
       } else {
-        std::sort(indices_begin + num_nan, indices_begin + items_total_ - nulls_total_,
-                  comp);
+        return ParallelSort(ctx_->memory_pool(), indices_begin + num_nan,
+                            indices_begin + items_total_ - nulls_total_, num_threads_,
+                            comp);
       }
     }
   }
 
   template <typename T>
   auto Sort(ArrayItemIndexS* indices_begin, ArrayItemIndexS* indices_end, int64_t num_nan)
-      -> typename std::enable_if_t<std::is_same<T, std::string>::value> {
-    if (asc_) {
-      auto comp = [this](ArrayItemIndexS x, ArrayItemIndexS y) {
-        return cached_key_[x.array_id]->GetString(x.id) <
-               cached_key_[y.array_id]->GetString(y.id);
+      -> typename std::enable_if_t<std::is_same<T, std::string>::value, arrow::Status> {
+    auto sort_begin = nulls_first_ ? indices_begin + nulls_total_ : indices_begin;
+    auto sort_end = sort_begin + items_total_ - nulls_total_;
+    std::shared_ptr<StringDictionary> dictionary;
+    arrow::ArrayVector key_arrays(cached_key_.begin(), cached_key_.end());
+    RETURN_NOT_OK(StringDictionary::Make(ctx_->memory_pool(), key_arrays, &dictionary));
+    if (dictionary) {
+      // codes are inverted for desc, so ska_sort always sorts them ascending
+      uint32_t code_mask = asc_ ? 0 : ~static_cast<uint32_t>(0);
+      auto code_of = [&dictionary, code_mask](const ArrayItemIndexS& x) -> uint32_t {
+        return dictionary->GetCode(x.array_id, x.id) ^ code_mask;
       };
-      if (nulls_first_) {
-        std::sort(indices_begin + nulls_total_, indices_begin + items_total_, comp);
-      } else {
-        std::sort(indices_begin, indices_begin + items_total_ - nulls_total_, comp);
-      }
-    } else {
-      auto comp = [this](ArrayItemIndexS x, ArrayItemIndexS y) {
-        return cached_key_[x.array_id]->GetString(x.id) >
-               cached_key_[y.array_id]->GetString(y.id);
+      auto comp = [&code_of](ArrayItemIndexS x, ArrayItemIndexS y) {
+        return code_of(x) < code_of(y);
       };
-      if (nulls_first_) {
-        std::sort(indices_begin + nulls_total_, indices_begin + items_total_, comp);
-      } else {
-        std::sort(indices_begin, indices_begin + items_total_ - nulls_total_, comp);
-      }
+      auto ska_sort_code = [&code_of](ArrayItemIndexS* begin, ArrayItemIndexS* end) {
+        ska_sort(begin, end, code_of);
+      };
+      return ParallelSort(ctx_->memory_pool(), sort_begin, sort_end, num_threads_,
+                          ska_sort_code, comp);
+    }
+    auto asc_comp = [this](ArrayItemIndexS x, ArrayItemIndexS y) {
+      return cached_key_[x.array_id]->GetString(x.id) <
+             cached_key_[y.array_id]->GetString(y.id);
+    };
+    auto desc_comp = [this](ArrayItemIndexS x, ArrayItemIndexS y) {
+      return cached_key_[x.array_id]->GetString(x.id) >
+             cached_key_[y.array_id]->GetString(y.id);
+    };
+    if (asc_) {
+      return ParallelSort(ctx_->memory_pool(), sort_begin, sort_end, num_threads_,
+                          asc_comp);
+    } else {
+      return ParallelSort(ctx_->memory_pool(), sort_begin, sort_end, num_threads_,
+                          desc_comp);
     }
   }
 
@@ -1462,7 +1637,13 @@ class SortOnekeyKernel : public SortArraysToIndicesKernel::Impl {
     // do partition and sort here
     int64_t num_nan = 0;
     Partition<CTYPE>(indices_begin, indices_end, num_nan);
-    Sort<CTYPE>(indices_begin, indices_end, num_nan);
+    // NaNs of a desc key are partitioned in reverse, so batches are not left in order
+    bool reversed = NaN_check_ && std::is_floating_point<CTYPE>::value && !asc_;
+    if (batches_sorted_ && !reversed) {
+      RETURN_NOT_OK(MergeBatches(indices_begin));
+    } else {
+      RETURN_NOT_OK(Sort<CTYPE>(indices_begin, indices_end, num_nan));
+    }
     std::shared_ptr<arrow::FixedSizeBinaryType> out_type;
     RETURN_NOT_OK(
         MakeFixedSizeBinaryType(sizeof(ArrayItemIndexS) / sizeof(int32_t), &out_type));
@@ -1479,6 +1660,34 @@ class SortOnekeyKernel : public SortArraysToIndicesKernel::Impl {
     return arrow::Status::OK();
   }
 
+  arrow::Status MakeResultIterator(
+      std::shared_ptr<arrow::Schema> schema,
+      std::shared_ptr<ResultIterator<SortRelation>>* out) override {
+    std::shared_ptr<FixedSizeBinaryArray> indices_out;
+    RETURN_NOT_OK(FinishInternal(&indices_out));
+    std::vector<std::shared_ptr<RelationColumn>> payload_relation_list;
+    for (int i = 0; i < col_num_; i++) {
+      std::shared_ptr<RelationColumn> col_out;
+      RETURN_NOT_OK(MakeCachedRelationColumn(result_schema_->field(i)->type()->id(),
+                                             cached_[i], &col_out));
+      payload_relation_list.push_back(col_out);
+    }
+    std::vector<std::shared_ptr<RelationColumn>> key_relation_list;
+    if (key_projector_) {
+      arrow::ArrayVector key_arrays(cached_key_.begin(), cached_key_.end());
+      std::shared_ptr<RelationColumn> key_out;
+      RETURN_NOT_OK(MakeCachedRelationColumn(DATATYPE::type_id, key_arrays, &key_out));
+      key_relation_list.push_back(key_out);
+    } else {
+      key_relation_list.push_back(payload_relation_list[key_id_]);
+    }
+    auto sort_relation = std::make_shared<SortRelation>(
+        ctx_, items_total_, indices_out->cache_->data()->buffers[1], key_relation_list,
+        payload_relation_list);
+    *out = std::make_shared<SortRelationResultIterator>(sort_relation);
+    return arrow::Status::OK();
+  }
+
  private:
   using ArrayType_key = typename arrow::TypeTraits<DATATYPE>::ArrayType;
   std::vector<std::shared_ptr<ArrayType_key>> cached_key_;
@@ -1489,25 +1698,16 @@ class SortOnekeyKernel : public SortArraysToIndicesKernel::Impl {
   bool nulls_first_;
   bool asc_;
   bool NaN_check_;
+  int num_threads_;
   std::vector<int64_t> length_list_;
+  // whether each batch is in sort order, and its rows left to sort if so
+  bool batches_sorted_ = true;
+  std::vector<int64_t> valid_length_list_;
   uint64_t num_batches_ = 0;
   uint64_t items_total_ = 0;
   uint64_t nulls_total_ = 0;
   int col_num_;
-  int key_id_;
-  class SortRelationResultIterator : public ResultIterator<SortRelation> {
-   public:
-    SortRelationResultIterator(std::shared_ptr<SortRelation> sort_relation)
-        : sort_relation_(sort_relation) {}
-    arrow::Status Next(std::shared_ptr<SortRelation>* out) {
-      *out = sort_relation_;
-      return arrow::Status::OK();
-    }
-
-   private:
-    std::shared_ptr<SortRelation> sort_relation_;
-  };
-  class SorterResultIterator : public ResultIterator<arrow::RecordBatch> {
+  int key_id_;  class SorterResultIterator : public ResultIterator<arrow::RecordBatch> {
    public:
     SorterResultIterator(arrow::compute::FunctionContext* ctx,
                          std::shared_ptr<arrow::Schema> schema,
@@ -1520,21 +1720,14 @@ class SortOnekeyKernel : public SortArraysToIndicesKernel::Impl {
           cached_in_(cached) {
       col_num_ = schema->num_fields();
       indices_begin_ = (ArrayItemIndexS*)indices_in->value_data();
-      // appender_type won't be used
-      AppenderBase::AppenderType appender_type = AppenderBase::left;
       for (int i = 0; i < col_num_; i++) {
         auto field = schema->field(i);
-        std::shared_ptr<AppenderBase> appender;
-        MakeAppender(ctx_, field->type(), appender_type, &appender);
-        appender_list_.push_back(appender);
-      }
-      for (int i = 0; i < col_num_; i++) {
-        arrow::ArrayVector array_vector = cached_in_[i];
-        int array_num = array_vector.size();
-        for (int array_id = 0; array_id < array_num; array_id++) {
-          auto arr = array_vector[array_id];
-          appender_list_[i]->AddArray(arr);
+        std::shared_ptr<ArrayGatherer> gatherer;
+        THROW_NOT_OK(MakeArrayGatherer(ctx_->memory_pool(), field->type(), &gatherer));
+        for (auto& arr : cached_in_[i]) {
+          gatherer->AddArray(arr);
         }
+        gatherer_list_.push_back(gatherer);
       }
       batch_size_ = GetBatchSize();
     }
@@ -1552,22 +1745,10 @@ class SortOnekeyKernel : public SortArraysToIndicesKernel::Impl {
     arrow::Status Next(std::shared_ptr<arrow::RecordBatch>* out) {
       auto length = (total_length_ - offset_) > batch_size_ ? batch_size_
                                                             : (total_length_ - offset_);
-      uint64_t count = 0;
-      for (int i = 0; i < col_num_; i++) {
-        while (count < length) {
-          auto item = indices_begin_ + offset_ + count++;
-          RETURN_NOT_OK(appender_list_[i]->Append(item->array_id, item->id));
-        }
-        count = 0;
-      }
-      offset_ += length;
       ArrayList arrays;
-      for (int i = 0; i < col_num_; i++) {
-        std::shared_ptr<arrow::Array> out_array;
-        RETURN_NOT_OK(appender_list_[i]->Finish(&out_array));
-        arrays.push_back(out_array);
-        appender_list_[i]->Reset();
-      }
+      RETURN_NOT_OK(
+          GatherArrays(gatherer_list_, indices_begin_ + offset_, length, &arrays));
+      offset_ += length;
 
       *out = arrow::RecordBatch::Make(schema_, length, arrays);
       return arrow::Status::OK();
@@ -1583,7 +1764,7 @@ class SortOnekeyKernel : public SortArraysToIndicesKernel::Impl {
     ArrayItemIndexS* indices_begin_;
     std::vector<arrow::ArrayVector> cached_in_;
     std::vector<std::shared_ptr<arrow::DataType>> type_list_;
-    std::vector<std::shared_ptr<AppenderBase>> appender_list_;
+    std::vector<std::shared_ptr<ArrayGatherer>> gatherer_list_;
     std::vector<std::shared_ptr<arrow::Array>> array_list_;
     std::shared_ptr<FixedSizeBinaryArray> indices_in_cache_;
   };
@@ -1606,7 +1787,8 @@ class SortMultiplekeyKernel  : public SortArraysToIndicesKernel::Impl {
         result_schema_(result_schema), 
         key_projector_(key_projector),
         key_field_list_(key_field_list),
-        NaN_check_(NaN_check) {
+        NaN_check_(NaN_check),
+        num_threads_(GetSortThreads()) {
       #ifdef DEBUG
           std::cout << "UseSortMultiplekeyKernel" << std::endl;
       #endif
@@ -1656,6 +1838,47 @@ class SortMultiplekeyKernel  : public SortArraysToIndicesKernel::Impl {
     }
     items_total_ += in[0]->length();
     length_list_.push_back(in[0]->length());
+    if (batches_sorted_) {
+      RETURN_NOT_OK(CheckLastBatchSorted());
+    }
+    return arrow::Status::OK();
+  }
+
+  /* Clears batches_sorted_ unless rows of the last batch are in sort order */
+  arrow::Status CheckLastBatchSorted() {
+    std::vector<arrow::ArrayVector> batch_columns;
+    std::vector<func::function<void(int, int, int64_t, int64_t, int&)>>
+        batch_cmp_functions;
+    if (key_projector_) {
+      std::vector<int> projected_key_idx_list;
+      for (int i = 0; i < projected_field_list_.size(); i++) {
+        projected_key_idx_list.push_back(i);
+        batch_columns.push_back({projected_[i].back()});
+      }
+      RETURN_NOT_OK(MakeCmpFunction(batch_columns, projected_field_list_,
+                                    projected_key_idx_list, sort_directions_,
+                                    nulls_order_, NaN_check_, batch_cmp_functions));
+    } else {
+      for (int i = 0; i < col_num_; i++) {
+        batch_columns.push_back({cached_[i].back()});
+      }
+      RETURN_NOT_OK(MakeCmpFunction(batch_columns, key_field_list_, key_index_list_,
+                                    sort_directions_, nulls_order_, NaN_check_,
+                                    batch_cmp_functions));
+    }
+    auto length = length_list_.back();
+    for (int64_t i = 1; i < length; i++) {
+      // In comparison, 1 represents for true, 0 for false, and 2 for equal.
+      int cmp_res = 2;
+      for (auto& cmp_function : batch_cmp_functions) {
+        cmp_function(0, 0, i, i - 1, cmp_res);
+        if (cmp_res != 2) break;
+      }
+      if (cmp_res == 1) {
+        batches_sorted_ = false;
+        break;
+      }
+    }
     return arrow::Status::OK();
   }
 
@@ -1684,11 +1907,26 @@ class SortMultiplekeyKernel  : public SortArraysToIndicesKernel::Impl {
     return false;
   }
 
-  auto Sort(ArrayItemIndexS* indices_begin, ArrayItemIndexS* indices_end) {
+  arrow::Status Sort(ArrayItemIndexS* indices_begin, ArrayItemIndexS* indices_end) {
     int keys_num = sort_directions_.size();
     auto comp = [this, &keys_num](ArrayItemIndexS x, ArrayItemIndexS y) {
         return compareRow(x.array_id, x.id, y.array_id, y.id, keys_num);};
-    gfx::timsort(indices_begin, indices_begin + items_total_, comp);
+    return ParallelSort(
+        ctx_->memory_pool(), indices_begin, indices_begin + items_total_, num_threads_,
+        [&comp](ArrayItemIndexS* begin, ArrayItemIndexS* end) {
+          gfx::timsort(begin, end, comp);
+        },
+        comp);
+  }
+
+  arrow::Status SortByNormalizedKey(NormalizedKeySorter* key_sorter,
+                                    ArrayItemIndexS* indices_begin) {
+    int keys_num = sort_directions_.size();
+    auto comp = [this, keys_num](ArrayItemIndexS x, ArrayItemIndexS y) {
+      return compareRow(x.array_id, x.id, y.array_id, y.id, keys_num);
+    };
+    return key_sorter->Sort(ctx_->memory_pool(), indices_begin, items_total_,
+                            num_threads_, comp);
   }
 
   void Partition(ArrayItemIndexS* indices_begin, 
@@ -1714,20 +1952,48 @@ class SortMultiplekeyKernel  : public SortArraysToIndicesKernel::Impl {
     ArrayItemIndexS* indices_end = indices_begin + items_total_;
     // do partition and sort here
     Partition(indices_begin, indices_end);
+    std::vector<arrow::ArrayVector> key_columns;
+    std::vector<std::shared_ptr<arrow::DataType>> key_types;
     if (key_projector_) {
       std::vector<int> projected_key_idx_list;
       for (int i = 0; i < projected_field_list_.size(); i++) {
         projected_key_idx_list.push_back(i);
+        key_columns.push_back(projected_[i]);
+        key_types.push_back(projected_field_list_[i]->type());
       }
       MakeCmpFunction(
           projected_, projected_field_list_, projected_key_idx_list, sort_directions_, 
           nulls_order_, NaN_check_, cmp_functions_);
     } else {
+      for (int i = 0; i < key_field_list_.size(); i++) {
+        key_columns.push_back(cached_[key_index_list_[i]]);
+        key_types.push_back(key_field_list_[i]->type());
+      }
       MakeCmpFunction(
           cached_, key_field_list_, key_index_list_, sort_directions_, 
           nulls_order_, NaN_check_, cmp_functions_);
     }
-    Sort(indices_begin, indices_end);
+    if (batches_sorted_) {
+      // every batch is in sort order, so merging them is enough
+      int keys_num = sort_directions_.size();
+      auto comp = [this, keys_num](ArrayItemIndexS x, ArrayItemIndexS y) {
+        return compareRow(x.array_id, x.id, y.array_id, y.id, keys_num);
+      };
+      RETURN_NOT_OK(
+          MergeSortedRuns(ctx_->memory_pool(), indices_begin, length_list_, comp));
+    } else {
+      std::shared_ptr<NormalizedKeySorter> key_sorter;
+      if (GetEnableSortNormalizedKey()) {
+        RETURN_NOT_OK(NormalizedKeySorter::Make(ctx_->memory_pool(), key_columns,
+                                                key_types, sort_directions_,
+                                                nulls_order_, &key_sorter));
+      }
+      if (key_sorter) {
+        RETURN_NOT_OK(SortByNormalizedKey(key_sorter.get(), indices_begin));
+      } else {
+        RETURN_NOT_OK(Sort(indices_begin, indices_end));
+      }
+    }
     std::shared_ptr<arrow::FixedSizeBinaryType> out_type;
     RETURN_NOT_OK(
         MakeFixedSizeBinaryType(sizeof(ArrayItemIndexS) / sizeof(int32_t), &out_type));
@@ -1744,7 +2010,39 @@ class SortMultiplekeyKernel  : public SortArraysToIndicesKernel::Impl {
     return arrow::Status::OK();
   }
 
- private:
+  arrow::Status MakeResultIterator(
+      std::shared_ptr<arrow::Schema> schema,
+      std::shared_ptr<ResultIterator<SortRelation>>* out) override {
+    std::shared_ptr<FixedSizeBinaryArray> indices_out;
+    RETURN_NOT_OK(FinishInternal(&indices_out));
+    std::vector<std::shared_ptr<RelationColumn>> payload_relation_list;
+    for (int i = 0; i < col_num_; i++) {
+      std::shared_ptr<RelationColumn> col_out;
+      RETURN_NOT_OK(MakeCachedRelationColumn(result_schema_->field(i)->type()->id(),
+                                             cached_[i], &col_out));
+      payload_relation_list.push_back(col_out);
+    }
+    std::vector<std::shared_ptr<RelationColumn>> key_relation_list;
+    if (key_projector_) {
+      for (int i = 0; i < projected_field_list_.size(); i++) {
+        std::shared_ptr<RelationColumn> key_out;
+        RETURN_NOT_OK(MakeCachedRelationColumn(projected_field_list_[i]->type()->id(),
+                                               projected_[i], &key_out));
+        key_relation_list.push_back(key_out);
+      }
+    } else {
+      for (auto key_id : key_index_list_) {
+        key_relation_list.push_back(payload_relation_list[key_id]);
+      }
+    }
+    auto sort_relation = std::make_shared<SortRelation>(
+        ctx_, items_total_, indices_out->cache_->data()->buffers[1], key_relation_list,
+        payload_relation_list);
+    *out = std::make_shared<SortRelationResultIterator>(sort_relation);
+    return arrow::Status::OK();
+  }
+
+ protected:
   std::vector<arrow::ArrayVector> cached_;
   std::vector<arrow::ArrayVector> projected_;
   arrow::compute::FunctionContext* ctx_;
@@ -1756,10 +2054,13 @@ class SortMultiplekeyKernel  : public SortArraysToIndicesKernel::Impl {
   std::vector<bool> sort_directions_;
   std::vector<int> key_index_list_;
   bool NaN_check_;
+  int num_threads_;
   std::vector<int64_t> length_list_;
   uint64_t num_batches_ = 0;
   uint64_t items_total_ = 0;
   int col_num_;
+  // whether each batch is in sort order, checked as it arrives
+  bool batches_sorted_ = true;
   std::vector<func::function<void(int, int, int64_t, int64_t, int&)>> cmp_functions_;                             
 
   class SorterResultIterator : public ResultIterator<arrow::RecordBatch> {
@@ -1775,21 +2076,14 @@ class SortMultiplekeyKernel  : public SortArraysToIndicesKernel::Impl {
           cached_in_(cached) {
       col_num_ = schema->num_fields();
       indices_begin_ = (ArrayItemIndexS*)indices_in->value_data();
-      // appender_type won't be used
-      AppenderBase::AppenderType appender_type = AppenderBase::left;
       for (int i = 0; i < col_num_; i++) {
         auto field = schema->field(i);
-        std::shared_ptr<AppenderBase> appender;
-        MakeAppender(ctx_, field->type(), appender_type, &appender);
-        appender_list_.push_back(appender);
-      }
-      for (int i = 0; i < col_num_; i++) {
-        arrow::ArrayVector array_vector = cached_in_[i];
-        int array_num = array_vector.size();
-        for (int array_id = 0; array_id < array_num; array_id++) {
-          auto arr = array_vector[array_id];
-          appender_list_[i]->AddArray(arr);
+        std::shared_ptr<ArrayGatherer> gatherer;
+        THROW_NOT_OK(MakeArrayGatherer(ctx_->memory_pool(), field->type(), &gatherer));
+        for (auto& arr : cached_in_[i]) {
+          gatherer->AddArray(arr);
         }
+        gatherer_list_.push_back(gatherer);
       }
       batch_size_ = GetBatchSize();
     }
@@ -1807,22 +2101,10 @@ class SortMultiplekeyKernel  : public SortArraysToIndicesKernel::Impl {
     arrow::Status Next(std::shared_ptr<arrow::RecordBatch>* out) {
       auto length = (total_length_ - offset_) > batch_size_ ? batch_size_
                                                             : (total_length_ - offset_);
-      uint64_t count = 0;
-      for (int i = 0; i < col_num_; i++) {
-        while (count < length) {
-          auto item = indices_begin_ + offset_ + count++;
-          RETURN_NOT_OK(appender_list_[i]->Append(item->array_id, item->id));
-        }
-        count = 0;
-      }
-      offset_ += length;
       ArrayList arrays;
-      for (int i = 0; i < col_num_; i++) {
-        std::shared_ptr<arrow::Array> out_array;
-        RETURN_NOT_OK(appender_list_[i]->Finish(&out_array));
-        arrays.push_back(out_array);
-        appender_list_[i]->Reset();
-      }
+      RETURN_NOT_OK(
+          GatherArrays(gatherer_list_, indices_begin_ + offset_, length, &arrays));
+      offset_ += length;
 
       *out = arrow::RecordBatch::Make(schema_, length, arrays);
       return arrow::Status::OK();
@@ -1838,12 +2120,241 @@ class SortMultiplekeyKernel  : public SortArraysToIndicesKernel::Impl {
     ArrayItemIndexS* indices_begin_;
     std::vector<arrow::ArrayVector> cached_in_;
     std::vector<std::shared_ptr<arrow::DataType>> type_list_;
-    std::vector<std::shared_ptr<AppenderBase>> appender_list_;
+    std::vector<std::shared_ptr<ArrayGatherer>> gatherer_list_;
     std::vector<std::shared_ptr<arrow::Array>> array_list_;
     std::shared_ptr<FixedSizeBinaryArray> indices_in_cache_;
   };
 };
 
+///////////////  TopK  ////////////////
+/* Keeps the first limit rows of ORDER BY ... LIMIT limit. Retained rows are a max heap
+ * in sort order, so the top of the heap is the k-th row so far. A batch whose first
+ * sort key is after the k-th row's in every row is dropped on arrival by one typed pass
+ * over that key. Other batches are cached and only pushed into the heap once retained
+ * batches hold twice max(limit, batch size) rows, so the comparison functions are made
+ * once for all of them. Rows still in the heap are then copied into new batches and
+ * the rest are released, so memory is O(limit) for any input size. */
+class TopKKernel : public SortMultiplekeyKernel {
+ public:
+  TopKKernel(arrow::compute::FunctionContext* ctx,
+             std::shared_ptr<arrow::Schema> result_schema,
+             std::shared_ptr<gandiva::Projector> key_projector,
+             std::vector<std::shared_ptr<arrow::DataType>> projected_types,
+             std::vector<std::shared_ptr<arrow::Field>> key_field_list,
+             std::vector<bool> sort_directions, std::vector<bool> nulls_order,
+             bool NaN_check, int64_t limit)
+      : SortMultiplekeyKernel(ctx, result_schema, key_projector, projected_types,
+                              key_field_list, sort_directions, nulls_order, NaN_check),
+        limit_(limit),
+        batch_size_(GetBatchSize()) {
+#ifdef DEBUG
+    std::cout << "UseTopKKernel" << std::endl;
+#endif
+    cached_.resize(col_num_);
+    projected_.resize(projected_field_list_.size());
+    for (int i = 0; i < projected_field_list_.size(); i++) {
+      projected_key_idx_list_.push_back(i);
+    }
+  }
+
+  arrow::Status Evaluate(const ArrayList& in) override {
+    auto length = in.size() > 0 ? in[0]->length() : 0;
+    if (length == 0 || limit_ == 0) {
+      return arrow::Status::OK();
+    }
+    std::vector<std::shared_ptr<arrow::Array>> projected_batch;
+    if (key_projector_) {
+      auto in_batch = arrow::RecordBatch::Make(result_schema_, length, in);
+      RETURN_NOT_OK(
+          key_projector_->Evaluate(*in_batch, ctx_->memory_pool(), &projected_batch));
+    }
+    auto first_key = key_projector_ ? projected_batch[0] : in[key_index_list_[0]];
+    if (heap_.size() == limit_ && !MayBeBeforeKth(*first_key)) {
+      return arrow::Status::OK();
+    }
+    for (int i = 0; i < col_num_; i++) {
+      cached_[i].push_back(in[i]);
+    }
+    for (int i = 0; i < projected_batch.size(); i++) {
+      projected_[i].push_back(projected_batch[i]);
+    }
+    retained_rows_ += length;
+    if (retained_rows_ >= 2 * std::max(limit_, batch_size_) ||
+        cached_[0].size() >= kMaxCachedBatches) {
+      RETURN_NOT_OK(Compact());
+    }
+    return arrow::Status::OK();
+  }
+
+  arrow::Status MakeResultIterator(
+      std::shared_ptr<arrow::Schema> schema,
+      std::shared_ptr<ResultIterator<arrow::RecordBatch>>* out) override {
+    RETURN_NOT_OK(SelectPending());
+    int keys_num = sort_directions_.size();
+    auto comp = [this, keys_num](ArrayItemIndexS x, ArrayItemIndexS y) {
+      return compareRow(x.array_id, x.id, y.array_id, y.id, keys_num);
+    };
+    std::sort_heap(heap_.begin(), heap_.end(), comp);
+    std::shared_ptr<arrow::Buffer> indices_buf;
+    int64_t buf_size = heap_.size() * sizeof(ArrayItemIndexS);
+    RETURN_NOT_OK(arrow::AllocateBuffer(ctx_->memory_pool(), buf_size, &indices_buf));
+    std::copy(heap_.begin(), heap_.end(),
+              reinterpret_cast<ArrayItemIndexS*>(indices_buf->mutable_data()));
+    std::shared_ptr<arrow::FixedSizeBinaryType> out_type;
+    RETURN_NOT_OK(
+        MakeFixedSizeBinaryType(sizeof(ArrayItemIndexS) / sizeof(int32_t), &out_type));
+    std::shared_ptr<FixedSizeBinaryArray> indices_out;
+    RETURN_NOT_OK(MakeFixedSizeBinaryArray(out_type, heap_.size(), indices_buf,
+                                           &indices_out));
+    *out = std::make_shared<SorterResultIterator>(ctx_, schema, indices_out, cached_);
+    return arrow::Status::OK();
+  }
+
+ private:
+  // array_id of ArrayItemIndexS is 16 bits
+  static constexpr int kMaxCachedBatches = 1 << 15;
+
+  int64_t limit_;
+  int64_t batch_size_;
+  int64_t retained_rows_ = 0;
+  // batches from this one on are cached but not pushed into the heap yet
+  int first_pending_batch_ = 0;
+  std::vector<int> projected_key_idx_list_;
+  std::vector<ArrayItemIndexS> heap_;
+
+  /* False if the first sort key of every row in batch_key is after the k-th row's.
+   * Decided on values of the first key only, ties and NaN are kept. Batches dropped
+   * against a k-th row that is not final are after the final one as well. */
+  bool MayBeBeforeKth(const arrow::Array& batch_key) {
+    auto& kth_keys = key_projector_ ? projected_[0] : cached_[key_index_list_[0]];
+    auto& kth_key = *kth_keys[heap_.front().array_id];
+    int64_t kth_id = heap_.front().id;
+    bool asc = sort_directions_[0];
+    bool nulls_first = nulls_order_[0];
+    switch (batch_key.type_id()) {
+#define PROCESS(InType)                                                               \
+  case InType::type_id: {                                                             \
+    using ArrayType = typename arrow::TypeTraits<InType>::ArrayType;                  \
+    return MayBeBeforeKth(static_cast<const ArrayType&>(batch_key),                   \
+                          static_cast<const ArrayType&>(kth_key), kth_id, asc,       \
+                          nulls_first);                                               \
+  } break;
+      PROCESS(arrow::BooleanType)
+      PROCESS(arrow::UInt8Type)
+      PROCESS(arrow::Int8Type)
+      PROCESS(arrow::UInt16Type)
+      PROCESS(arrow::Int16Type)
+      PROCESS(arrow::UInt32Type)
+      PROCESS(arrow::Int32Type)
+      PROCESS(arrow::UInt64Type)
+      PROCESS(arrow::Int64Type)
+      PROCESS(arrow::FloatType)
+      PROCESS(arrow::DoubleType)
+      PROCESS(arrow::Date32Type)
+      PROCESS(arrow::Date64Type)
+      PROCESS(arrow::StringType)
+#undef PROCESS
+      default:
+        return true;
+    }
+  }
+
+  template <typename ArrayType>
+  static bool MayBeBeforeKth(const ArrayType& batch_key, const ArrayType& kth_key,
+                             int64_t kth_id, bool asc, bool nulls_first) {
+    if (kth_key.IsNull(kth_id)) return true;
+    if (batch_key.null_count() > 0 && nulls_first) return true;
+    auto kth_value = kth_key.GetView(kth_id);
+    for (int64_t i = 0; i < batch_key.length(); i++) {
+      if (batch_key.IsNull(i)) continue;
+      auto value = batch_key.GetView(i);
+      // NaN is placed by NaN_check, keep the batch
+      if (value != value) return true;
+      if (asc ? !(kth_value < value) : !(value < kth_value)) return true;
+    }
+    return false;
+  }
+
+  arrow::Status UpdateCmpFunction() {
+    // comparators hold the arrays they were made from
+    cmp_functions_.clear();
+    if (key_projector_) {
+      return MakeCmpFunction(projected_, projected_field_list_, projected_key_idx_list_,
+                             sort_directions_, nulls_order_, NaN_check_,
+                             cmp_functions_);
+    }
+    return MakeCmpFunction(cached_, key_field_list_, key_index_list_, sort_directions_,
+                           nulls_order_, NaN_check_, cmp_functions_);
+  }
+
+  /* Pushes rows of pending batches into the heap, comparators are made once here */
+  arrow::Status SelectPending() {
+    int num_batches = cached_[0].size();
+    if (first_pending_batch_ == num_batches) {
+      return arrow::Status::OK();
+    }
+    RETURN_NOT_OK(UpdateCmpFunction());
+    int keys_num = sort_directions_.size();
+    auto comp = [this, keys_num](ArrayItemIndexS x, ArrayItemIndexS y) {
+      return compareRow(x.array_id, x.id, y.array_id, y.id, keys_num);
+    };
+    for (int array_id = first_pending_batch_; array_id < num_batches; array_id++) {
+      auto length = cached_[0][array_id]->length();
+      for (int64_t i = 0; i < length; i++) {
+        ArrayItemIndexS item(array_id, i);
+        if (heap_.size() < limit_) {
+          heap_.push_back(item);
+          std::push_heap(heap_.begin(), heap_.end(), comp);
+        } else if (comp(item, heap_.front())) {
+          std::pop_heap(heap_.begin(), heap_.end(), comp);
+          heap_.back() = item;
+          std::push_heap(heap_.begin(), heap_.end(), comp);
+        }
+      }
+    }
+    first_pending_batch_ = num_batches;
+    return arrow::Status::OK();
+  }
+
+  /* Copies rows in heap into batches of batch_size_ rows, in heap order */
+  arrow::Status Gather(const arrow::ArrayVector& arrays,
+                       std::shared_ptr<arrow::DataType> type, arrow::ArrayVector* out) {
+    std::shared_ptr<ArrayGatherer> gatherer;
+    RETURN_NOT_OK(MakeArrayGatherer(ctx_->memory_pool(), type, &gatherer));
+    for (auto& array : arrays) {
+      gatherer->AddArray(array);
+    }
+    int64_t num_rows = heap_.size();
+    for (int64_t offset = 0; offset < num_rows; offset += batch_size_) {
+      auto length = std::min(num_rows - offset, batch_size_);
+      RETURN_NOT_OK(GatherArrays({gatherer}, heap_.data() + offset, length, out));
+    }
+    return arrow::Status::OK();
+  }
+
+  arrow::Status Compact() {
+    RETURN_NOT_OK(SelectPending());
+    std::vector<arrow::ArrayVector> cached(col_num_);
+    for (int i = 0; i < col_num_; i++) {
+      RETURN_NOT_OK(Gather(cached_[i], result_schema_->field(i)->type(), &cached[i]));
+    }
+    std::vector<arrow::ArrayVector> projected(projected_.size());
+    for (int i = 0; i < projected_.size(); i++) {
+      RETURN_NOT_OK(
+          Gather(projected_[i], projected_field_list_[i]->type(), &projected[i]));
+    }
+    cached_.swap(cached);
+    projected_.swap(projected);
+    // moving rows keeps their keys, so the heap is still a heap
+    for (int64_t i = 0; i < heap_.size(); i++) {
+      heap_[i] = ArrayItemIndexS(i / batch_size_, i % batch_size_);
+    }
+    retained_rows_ = heap_.size();
+    first_pending_batch_ = cached_[0].size();
+    return arrow::Status::OK();
+  }
+};
+
 arrow::Status SortArraysToIndicesKernel::Make(
     arrow::compute::FunctionContext* ctx, 
     std::shared_ptr<arrow::Schema> result_schema,
@@ -1854,10 +2365,11 @@ arrow::Status SortArraysToIndicesKernel::Make(
     bool NaN_check,
     bool do_codegen,
     int result_type, 
+    int64_t limit,
     std::shared_ptr<KernalBase>* out) {
   *out = std::make_shared<SortArraysToIndicesKernel>(
       ctx, result_schema, sort_key_node, key_field_list, sort_directions, nulls_order, 
-      NaN_check, do_codegen, result_type);
+      NaN_check, do_codegen, result_type, limit);
   return arrow::Status::OK();
 }
 #define PROCESS_SUPPORTED_TYPES(PROCESS) \
@@ -1883,7 +2395,8 @@ SortArraysToIndicesKernel::SortArraysToIndicesKernel(
     std::vector<bool> nulls_order, 
     bool NaN_check,
     bool do_codegen,
-    int result_type) {
+    int result_type,
+    int64_t limit) {
   // sort_key_node may need to do projection
   bool pre_processed_key_ = false;
   gandiva::NodePtr key_project;
@@ -1911,9 +2424,14 @@ SortArraysToIndicesKernel::SortArraysToIndicesKernel(
     }
   }
 
-  if (key_field_list.size() == 1 && result_schema->num_fields() == 1 &&
-      key_field_list[0]->type()->id() != arrow::Type::STRING &&
-      key_field_list[0]->type()->id() != arrow::Type::BOOL) {
+  if (limit >= 0) {
+    // Will use TopK for ORDER BY ... LIMIT, whatever the keys are
+    impl_.reset(new TopKKernel(ctx, result_schema, key_projector, projected_types,
+                               key_field_list, sort_directions, nulls_order, NaN_check,
+                               limit));
+  } else if (key_field_list.size() == 1 && result_schema->num_fields() == 1 &&
+             result_type == 0 && key_field_list[0]->type()->id() != arrow::Type::STRING &&
+             key_field_list[0]->type()->id() != arrow::Type::BOOL) {
     // Will use SortInplace when sorting for one non-string and non-boolean col
 #ifdef DEBUG
     std::cout << "UseSortInplace" << std::endl;
@@ -1986,7 +2504,7 @@ SortArraysToIndicesKernel::SortArraysToIndicesKernel(
       }
     }
   } else {
-    if (do_codegen) {
+    if (do_codegen && result_type == 0) {
       // Will use Sort Codegen for multiple-key sort
       impl_.reset(new Impl(ctx, result_schema, key_projector, projected_types,
                           key_field_list, sort_directions, nulls_order, NaN_check));
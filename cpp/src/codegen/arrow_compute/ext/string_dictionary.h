@@ -0,0 +1,116 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/memory_pool.h>
+#include <arrow/status.h>
+#include <arrow/util/string_view.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "precompile/hash_map.h"
+
+namespace sparkcolumnarplugin {
+namespace codegen {
+namespace arrowcompute {
+namespace extra {
+
+/* Fewest rows per distinct value for a string key to be dictionary encoded */
+static constexpr int64_t kMinRowsPerStringCode = 8;
+
+/** StringDictionary
+ *
+ * Order preserving codes of a string sort key: the code of a row is the rank of its
+ * value among the distinct values of the key, so codes compare as the strings do.
+ * Every value is hashed once and only the distinct values are sorted by string
+ * comparison, rows can then be sorted on the integer codes. A key with more than one
+ * distinct value per kMinRowsPerStringCode rows is not encoded, as sorting its
+ * distinct values would cost about as much as sorting the rows.
+ * Null rows have code 0, callers put them aside before looking at codes.
+ **/
+class StringDictionary {
+ public:
+  /* out is null if arrays have too many distinct values */
+  static arrow::Status Make(arrow::MemoryPool* pool, const arrow::ArrayVector& arrays,
+                            std::shared_ptr<StringDictionary>* out) {
+    *out = nullptr;
+    int64_t length = 0;
+    for (auto& array : arrays) length += array->length();
+    uint64_t max_values = length / kMinRowsPerStringCode;
+    if (max_values == 0) return arrow::Status::OK();
+
+    auto dictionary = std::shared_ptr<StringDictionary>(new StringDictionary());
+    auto& codes = dictionary->codes_;
+    codes.resize(length, 0);
+    precompile::StringHashMap hash_table(pool);
+    std::vector<arrow::util::string_view> values;
+    int64_t code_i = 0;
+    for (auto& array : arrays) {
+      dictionary->array_offsets_.push_back(code_i);
+      auto typed_array = std::dynamic_pointer_cast<arrow::StringArray>(array);
+      bool has_null = typed_array->null_count() > 0;
+      for (int64_t i = 0; i < typed_array->length(); i++, code_i++) {
+        if (has_null && typed_array->IsNull(i)) continue;
+        auto value = typed_array->GetView(i);
+        int32_t memo_index;
+        RETURN_NOT_OK(hash_table.GetOrInsert(
+            value, [](int32_t) {}, [](int32_t) {}, &memo_index));
+        if (static_cast<size_t>(memo_index) == values.size()) {
+          if (values.size() == max_values) return arrow::Status::OK();
+          values.push_back(value);
+        }
+        codes[code_i] = memo_index;
+      }
+    }
+    if (!values.empty()) {
+      std::vector<uint32_t> order(values.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(order.begin(), order.end(),
+                [&values](uint32_t x, uint32_t y) { return values[x] < values[y]; });
+      std::vector<uint32_t> ranks(values.size());
+      for (uint32_t rank = 0; rank < order.size(); rank++) ranks[order[rank]] = rank;
+      for (auto& code : codes) code = ranks[code];
+    }
+    dictionary->num_values_ = values.size();
+    *out = dictionary;
+    return arrow::Status::OK();
+  }
+
+  uint32_t GetCode(int array_id, int64_t id) const {
+    return codes_[array_offsets_[array_id] + id];
+  }
+
+  int64_t num_values() const { return num_values_; }
+
+ private:
+  StringDictionary() {}
+
+  std::vector<uint32_t> codes_;
+  std::vector<int64_t> array_offsets_;
+  int64_t num_values_ = 0;
+};
+
+}  // namespace extra
+}  // namespace arrowcompute
+}  // namespace codegen
+}  // namespace sparkcolumnarplugin
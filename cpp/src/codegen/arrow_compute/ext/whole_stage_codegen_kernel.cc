@@ -16,7 +16,9 @@
  */
 
 #include <arrow/array.h>
+#include <arrow/buffer.h>
 #include <arrow/compute/context.h>
+#include <arrow/compute/kernels/take.h>
 #include <arrow/pretty_print.h>
 #include <arrow/status.h>
 #include <arrow/type.h>
@@ -34,6 +36,8 @@
 #include "codegen/arrow_compute/ext/codegen_common.h"
 #include "codegen/arrow_compute/ext/kernels_ext.h"
 #include "codegen/common/hash_relation.h"
+#include "codegen/common/thread_pool.h"
+#include "precompile/hash_arrays_kernel.h"
 #include "utils/macros.h"
 //#include "codegen/arrow_compute/ext/codegen_node_visitor.h"
 
@@ -44,6 +48,198 @@ namespace extra {
 
 using ArrayList = std::vector<std::shared_ptr<arrow::Array>>;
 
+/* Runs one generated aggregate iterator per partition. Rows are radix partitioned by
+ * murmur3 hash of the group keys, so one key always lands in the same partition and
+ * each worker only touches its private hash table. Partitioned batches are cached and
+ * handed over in bulk to a persistent thread pool, whose workers are attached to the
+ * JVM, results of partitions are concatenated. */
+class ParallelAggregateResultIterator : public ResultIterator<arrow::RecordBatch> {
+ public:
+  ParallelAggregateResultIterator(
+      arrow::compute::FunctionContext* ctx, const std::vector<int>& key_index_list,
+      int partition_bits,
+      const std::vector<std::shared_ptr<ResultIterator<arrow::RecordBatch>>>& iter_list)
+      : ctx_(ctx),
+        key_index_list_(key_index_list),
+        partition_bits_(partition_bits),
+        iter_list_(iter_list),
+        pending_list_(iter_list.size()),
+        thread_pool_(new ThreadPool(iter_list.size() - 1)) {}
+
+  arrow::Status SetDependencies(
+      const std::vector<std::shared_ptr<ResultIteratorBase>>& dependent_iter_list)
+      override {
+    for (auto iter : iter_list_) {
+      RETURN_NOT_OK(iter->SetDependencies(dependent_iter_list));
+    }
+    return arrow::Status::OK();
+  }
+
+  arrow::Status ProcessAndCacheOne(
+      const ArrayList& in,
+      const std::shared_ptr<arrow::Array>& selection = nullptr) override {
+    // rows to aggregate, all of them or the ones listed in selection
+    const uint16_t* selected = nullptr;
+    if (selection) {
+      if (selection->type_id() != arrow::Type::UINT16) {
+        return arrow::Status::Invalid(
+            "ParallelAggregateResultIterator doesn't support selection type ",
+            selection->type()->ToString());
+      }
+      selected = std::static_pointer_cast<arrow::UInt16Array>(selection)->raw_values();
+    }
+    int64_t length = selected ? selection->length() : in[0]->length();
+    ArrayList key_list;
+    for (auto i : key_index_list_) {
+      key_list.push_back(in[i]);
+    }
+    std::shared_ptr<arrow::Array> hash_array;
+    RETURN_NOT_OK(
+        precompile::Murmur3HashArrays(ctx_->memory_pool(), key_list, &hash_array));
+    auto hashes = std::dynamic_pointer_cast<arrow::Int32Array>(hash_array)->raw_values();
+
+    // counting pass then scatter, so indices of one partition are contiguous
+    int num_partitions = iter_list_.size();
+    std::vector<int64_t> offsets(num_partitions + 1, 0);
+    for (int64_t i = 0; i < length; i++) {
+      int64_t row = selected ? selected[i] : i;
+      offsets[GetPartition(hashes[row]) + 1]++;
+    }
+    for (int p = 0; p < num_partitions; p++) {
+      offsets[p + 1] += offsets[p];
+    }
+    std::shared_ptr<arrow::Buffer> indices_buf;
+    RETURN_NOT_OK(arrow::AllocateBuffer(ctx_->memory_pool(), length * sizeof(int32_t),
+                                        &indices_buf));
+    auto indices = reinterpret_cast<int32_t*>(indices_buf->mutable_data());
+    std::vector<int64_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (int64_t i = 0; i < length; i++) {
+      int64_t row = selected ? selected[i] : i;
+      indices[cursor[GetPartition(hashes[row])]++] = row;
+    }
+    auto indices_array = std::make_shared<arrow::Int32Array>(length, indices_buf);
+
+    for (int p = 0; p < num_partitions; p++) {
+      auto num_rows = offsets[p + 1] - offsets[p];
+      if (num_rows == 0) continue;
+      auto partition_indices = indices_array->Slice(offsets[p], num_rows);
+      ArrayList partition_in;
+      for (auto col : in) {
+        std::shared_ptr<arrow::Array> partition_col;
+        RETURN_NOT_OK(arrow::compute::Take(ctx_, *col.get(), *partition_indices.get(),
+                                           arrow::compute::TakeOptions(),
+                                           &partition_col));
+        partition_in.push_back(partition_col);
+      }
+      pending_list_[p].push_back(partition_in);
+    }
+    pending_rows_ += length;
+    if (pending_rows_ >= kMaxPendingRows) {
+      RETURN_NOT_OK(ProcessPending());
+    }
+    return arrow::Status::OK();
+  }
+
+  bool HasFlushedOutput() override {
+    for (auto iter : iter_list_) {
+      if (iter->HasFlushedOutput()) return true;
+    }
+    return false;
+  }
+
+  bool HasNext() override {
+    while (cur_iter_ < iter_list_.size() && !iter_list_[cur_iter_]->HasNext()) {
+      cur_iter_++;
+    }
+    return cur_iter_ < iter_list_.size();
+  }
+
+  arrow::Status Next(std::shared_ptr<arrow::RecordBatch>* out) override {
+    if (pending_rows_ > 0) {
+      RETURN_NOT_OK(ProcessPending());
+    }
+    for (auto iter : iter_list_) {
+      if (iter->HasFlushedOutput()) return iter->Next(out);
+    }
+    if (!HasNext()) {
+      return arrow::Status::Invalid("ParallelAggregateResultIterator has no next.");
+    }
+    // skip empty output of partitions without any group
+    while (true) {
+      RETURN_NOT_OK(iter_list_[cur_iter_]->Next(out));
+      if ((*out)->num_rows() > 0 || !HasNext()) break;
+    }
+    return arrow::Status::OK();
+  }
+
+  arrow::Status GetMetrics(std::shared_ptr<Metrics>* out) override {
+    std::shared_ptr<Metrics> metrics;
+    for (auto iter : iter_list_) {
+      std::shared_ptr<Metrics> iter_metrics;
+      RETURN_NOT_OK(iter->GetMetrics(&iter_metrics));
+      if (!metrics) {
+        metrics = std::make_shared<Metrics>(iter_metrics->num_metrics);
+        for (int i = 0; i < metrics->num_metrics; i++) {
+          metrics->process_time[i] = 0;
+          metrics->output_length[i] = 0;
+        }
+      }
+      for (int i = 0; i < metrics->num_metrics; i++) {
+        metrics->process_time[i] += iter_metrics->process_time[i];
+        metrics->output_length[i] += iter_metrics->output_length[i];
+      }
+    }
+    // partitions share one memory pool, so its bytes are not summed
+    metrics->current_memory = ctx_->memory_pool()->bytes_allocated();
+    metrics->peak_memory = ctx_->memory_pool()->max_memory();
+    *out = metrics;
+    return arrow::Status::OK();
+  }
+
+  std::string ToString() override { return "ParallelAggregateResultIterator"; }
+
+ private:
+  // rows cached before waking up workers, bounds the extra copy of input
+  static constexpr int64_t kMaxPendingRows = 1 << 20;
+
+  arrow::compute::FunctionContext* ctx_;
+  std::vector<int> key_index_list_;
+  int partition_bits_;
+  std::vector<std::shared_ptr<ResultIterator<arrow::RecordBatch>>> iter_list_;
+  std::vector<std::vector<ArrayList>> pending_list_;
+  int64_t pending_rows_ = 0;
+  size_t cur_iter_ = 0;
+  // calling thread takes a partition too, so one worker less than partitions
+  std::unique_ptr<ThreadPool> thread_pool_;
+
+  int GetPartition(int32_t hash) {
+    return (uint32_t)hash >> (32 - partition_bits_);
+  }
+
+  arrow::Status ProcessPending() {
+    std::vector<int> partition_list;
+    for (int p = 0; p < iter_list_.size(); p++) {
+      if (!pending_list_[p].empty()) partition_list.push_back(p);
+    }
+    std::vector<arrow::Status> status_list(iter_list_.size());
+    thread_pool_->ParallelFor(partition_list.size(), [&](int i) {
+      auto p = partition_list[i];
+      for (auto& partition_in : pending_list_[p]) {
+        status_list[p] = iter_list_[p]->ProcessAndCacheOne(partition_in);
+        if (!status_list[p].ok()) return;
+      }
+    });
+    for (auto& pending : pending_list_) {
+      pending.clear();
+    }
+    pending_rows_ = 0;
+    for (auto status : status_list) {
+      RETURN_NOT_OK(status);
+    }
+    return arrow::Status::OK();
+  }
+};
+
 ///////////////  WholeStageCodeGen  ////////////////
 class WholeStageCodeGenKernel::Impl {
  public:
@@ -57,12 +253,30 @@ class WholeStageCodeGenKernel::Impl {
     THROW_NOT_OK(ParseNodeTree(root_node, &hash_relation_idx, &kernel_list_));
     THROW_NOT_OK(LoadJITFunction(input_field_list, output_field_list, kernel_list_,
                                  &wscg_kernel_));
+    // a standalone aggregate can be split across threads by its group keys
+    auto num_aggr_threads = GetAggregateThreads();
+    if (num_aggr_threads > 1 && is_aggr_ && !is_smj_ && kernel_list_.size() == 1) {
+      aggr_key_index_list_ = GetParallelAggregateKeys(input_field_list);
+      while ((2 << aggr_partition_bits_) <= num_aggr_threads) aggr_partition_bits_++;
+    }
   }
 
   arrow::Status MakeResultIterator(
       std::shared_ptr<arrow::Schema> schema,
       std::shared_ptr<ResultIterator<arrow::RecordBatch>>* out) {
-    return wscg_kernel_->MakeResultIterator(schema, gandiva_projector_list_, out);
+    if (aggr_key_index_list_.empty()) {
+      return wscg_kernel_->MakeResultIterator(schema, gandiva_projector_list_, out);
+    }
+    std::vector<std::shared_ptr<ResultIterator<arrow::RecordBatch>>> iter_list;
+    for (int p = 0; p < (1 << aggr_partition_bits_); p++) {
+      std::shared_ptr<ResultIterator<arrow::RecordBatch>> iter;
+      RETURN_NOT_OK(
+          wscg_kernel_->MakeResultIterator(schema, gandiva_projector_list_, &iter));
+      iter_list.push_back(iter);
+    }
+    *out = std::make_shared<ParallelAggregateResultIterator>(
+        ctx_, aggr_key_index_list_, aggr_partition_bits_, iter_list);
+    return arrow::Status::OK();
   }
 
   std::string GetSignature() { return signature_; }
@@ -79,6 +293,39 @@ class WholeStageCodeGenKernel::Impl {
   bool enable_time_metrics_;
   std::vector<std::shared_ptr<GandivaProjector>> gandiva_projector_list_;
   std::vector<std::string> aggr_out_length_idxs;
+  gandiva::NodeVector aggr_action_node_list_;
+  std::vector<int> aggr_key_index_list_;
+  int aggr_partition_bits_ = 0;
+
+  /* Input column index of each group key. Empty if any key is not a plain input
+   * column whose hash partitioning keeps equal keys together. */
+  std::vector<int> GetParallelAggregateKeys(
+      const std::vector<std::shared_ptr<arrow::Field>>& input_field_list) {
+    std::vector<int> key_index_list;
+    for (auto node : aggr_action_node_list_) {
+      auto func_node = std::dynamic_pointer_cast<gandiva::FunctionNode>(node);
+      if (func_node->descriptor()->name() != "action_groupby") continue;
+      auto field_node =
+          std::dynamic_pointer_cast<gandiva::FieldNode>(func_node->children()[0]);
+      if (!field_node) return {};
+      auto type = field_node->field()->type();
+      // -0.0 and 0.0 hash differently but belong to one group
+      if (!precompile::IsVectorizedHashSupported(type) ||
+          type->id() == arrow::Type::FLOAT || type->id() == arrow::Type::DOUBLE) {
+        return {};
+      }
+      int key_index = -1;
+      for (int i = 0; i < input_field_list.size(); i++) {
+        if (input_field_list[i]->name() == field_node->field()->name()) {
+          key_index = i;
+          break;
+        }
+      }
+      if (key_index == -1) return {};
+      key_index_list.push_back(key_index);
+    }
+    return key_index_list;
+  }
 
   arrow::Status GetArguments(std::shared_ptr<gandiva::Node> node, int i,
                              gandiva::NodeVector* node_list) {
@@ -198,7 +445,7 @@ class WholeStageCodeGenKernel::Impl {
 
       gandiva::NodeVector result_field_node_list;
       gandiva::NodeVector result_expr_node_list;
-      if (function_node->children().size() == 4) {
+      if (function_node->children().size() >= 4) {
         result_field_node_list =
             std::dynamic_pointer_cast<gandiva::FunctionNode>(function_node->children()[2])
                 ->children();
@@ -206,9 +453,22 @@ class WholeStageCodeGenKernel::Impl {
             std::dynamic_pointer_cast<gandiva::FunctionNode>(function_node->children()[3])
                 ->children();
       }
+      aggr_action_node_list_ = action_node_list;
+      // optional hints follow resultExpressions
+      bool is_partial = false;
+      bool is_sorted = false;
+      for (int i = 4; i < function_node->children().size(); i++) {
+        auto hint_name =
+            std::dynamic_pointer_cast<gandiva::FunctionNode>(function_node->children()[i])
+                ->descriptor()
+                ->name();
+        if (hint_name == "partialAggregate") is_partial = true;
+        if (hint_name == "sortedAggregate") is_sorted = true;
+      }
       RETURN_NOT_OK(HashAggregateKernel::Make(ctx_, field_node_list, action_node_list,
                                               result_field_node_list,
-                                              result_expr_node_list, out));
+                                              result_expr_node_list, out, is_partial,
+                                              is_sorted));
     } else {
       return arrow::Status::NotImplemented("Not supported function name:", func_name);
     }
@@ -362,6 +622,9 @@ class TypedWholeStageCodeGenImpl : public CodeGenBase {
       codes_ss << "metrics->process_time[" << i << "] = " << process_time_name << ";"
                << std::endl;
     }
+    codes_ss << "metrics->current_memory = ctx_->memory_pool()->bytes_allocated();"
+             << std::endl;
+    codes_ss << "metrics->peak_memory = ctx_->memory_pool()->max_memory();" << std::endl;
     codes_ss << "*out = metrics;" << std::endl;
     codes_ss << "return arrow::Status::OK();" << std::endl;
     codes_ss << "}" << std::endl;
@@ -488,6 +751,9 @@ class TypedWholeStageCodeGenImpl : public CodeGenBase {
       }
     }
     codes_ss << "} // end of for loop" << std::endl;
+    for (auto codegen_ctx : codegen_ctx_list) {
+      codes_ss << codegen_ctx->process_batch_end_codes << std::endl;
+    }
     if (is_aggr_ && !is_smj_) {
       codes_ss << "return arrow::Status::OK();" << std::endl;
       codes_ss << "} // End of ProcessAndCacheOne" << std::endl << std::endl;
@@ -509,7 +775,8 @@ class TypedWholeStageCodeGenImpl : public CodeGenBase {
         codes_ss << codegen_ctx->aggregate_finish_codes << std::endl;
         if (!codegen_ctx->aggregate_finish_codes.empty())
           codes_ss << aggr_out_length_idxs[idx++] << " = " << aggr_finish_condition_
-                   << "_offset;" << std::endl;
+                   << "_offset + " << aggr_finish_condition_ << "_flushed_rows;"
+                   << std::endl;
       }
       output_arr_list_ss << aggr_finish_condition_ << "_out";
     } else {
@@ -15,7 +15,17 @@
  * limitations under the License.
  */
 
+#include <arrow/builder.h>
+
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+
 #include "codegen/arrow_compute/ext/actions_impl.h"
+#include "codegen/arrow_compute/ext/cmp_function.h"
 #include "codegen/arrow_compute/ext/kernels_ext.h"
 #include "codegen/arrow_compute/ext/window_sort_kernel.h"
 
@@ -26,7 +36,12 @@ namespace extra {
 
 class WindowAggregateFunctionKernel::ActionFactory {
  public:
-  ActionFactory(std::shared_ptr<ActionBase> action) {
+  ActionFactory(std::string action_name, arrow::compute::FunctionContext *ctx,
+                std::shared_ptr<arrow::DataType> type,
+                std::shared_ptr<ActionBase> action) {
+    action_name_ = action_name;
+    ctx_ = ctx;
+    type_ = type;
     action_ = action;
   }
 
@@ -35,14 +50,8 @@ class WindowAggregateFunctionKernel::ActionFactory {
                             std::shared_ptr<arrow::DataType> type,
                             std::shared_ptr<ActionFactory> *out) {
     std::shared_ptr<ActionBase> action;
-    if (action_name == "sum") {
-      RETURN_NOT_OK(MakeSumAction(ctx, type, &action));
-    } else if (action_name == "avg") {
-      RETURN_NOT_OK(MakeAvgAction(ctx, type, &action));
-    } else {
-      return arrow::Status::Invalid("window aggregate function: unsupported action name: " + action_name);
-    }
-    *out = std::make_shared<ActionFactory>(action);
+    RETURN_NOT_OK(MakeAction(action_name, ctx, type, &action));
+    *out = std::make_shared<ActionFactory>(action_name, ctx, type, action);
     return arrow::Status::OK();
   }
 
@@ -50,7 +59,30 @@ class WindowAggregateFunctionKernel::ActionFactory {
     return action_;
   }
 
+  // actions have no way to drop their groups, so a fresh one is made
+  arrow::Status Reset() {
+    RETURN_NOT_OK(MakeAction(action_name_, ctx_, type_, &action_));
+    return arrow::Status::OK();
+  }
+
  private:
+  static arrow::Status MakeAction(std::string action_name,
+                                  arrow::compute::FunctionContext *ctx,
+                                  std::shared_ptr<arrow::DataType> type,
+                                  std::shared_ptr<ActionBase> *out) {
+    if (action_name == "sum") {
+      RETURN_NOT_OK(MakeSumAction(ctx, type, out));
+    } else if (action_name == "avg") {
+      RETURN_NOT_OK(MakeAvgAction(ctx, type, out));
+    } else {
+      return arrow::Status::Invalid("window aggregate function: unsupported action name: " + action_name);
+    }
+    return arrow::Status::OK();
+  }
+
+  std::string action_name_;
+  arrow::compute::FunctionContext *ctx_;
+  std::shared_ptr<arrow::DataType> type_;
   std::shared_ptr<ActionBase> action_;
 };
 
@@ -182,6 +214,12 @@ arrow::Status WindowAggregateFunctionKernel::Finish0(ArrayList *out) {
   return arrow::Status::OK();
 }
 
+arrow::Status WindowAggregateFunctionKernel::Reset() {
+  accumulated_group_ids_.clear();
+  RETURN_NOT_OK(action_->Reset());
+  return arrow::Status::OK();
+}
+
 WindowRankKernel::WindowRankKernel(arrow::compute::FunctionContext *ctx,
                                    std::vector<std::shared_ptr<arrow::DataType>> type_list,
                                    std::shared_ptr<WindowSortKernel::Impl> sorter,
@@ -246,6 +284,12 @@ arrow::Status WindowRankKernel::Evaluate(const ArrayList &in) {
   return arrow::Status::OK();
 }
 
+arrow::Status WindowRankKernel::Reset() {
+  input_cache_.clear();
+  RETURN_NOT_OK(sorter_->Reset());
+  return arrow::Status::OK();
+}
+
 arrow::Status WindowRankKernel::Finish(ArrayList *out) {
   std::vector<ArrayList> values;
   std::vector<std::shared_ptr<arrow::Int32Array>> group_ids;
@@ -425,6 +469,533 @@ arrow::Status WindowRankKernel::AreTheSameValue(std::vector<ArrayList> values, i
   return arrow::Status::OK();
 }
 
+#define PROCESS_FRAME_SUPPORTED_TYPES(PROCESS) \
+  PROCESS_SUPPORTED_TYPES(PROCESS)             \
+  PROCESS(arrow::Date32Type)
+
+/** WindowFrameAggregateKernel
+ *
+ * sum, avg, count, min and max of a frame around each row, rows of a partition are
+ * ordered by order keys. Both ends of the frame only move forward from a row to the
+ * next one, so rows are added as they enter the frame and removed as they leave it,
+ * instead of aggregating the whole frame of every row: sum, avg and count keep a
+ * running sum and count, min and max keep a monotonic deque of the rows in the frame.
+ * Floating sums of frames whose start moves are read from FloatingFrameSum instead.
+ * RANGE frames with offsets need one numeric or date order key, nulls and NaNs of the
+ * key are only peers of each other.
+ **/
+class WindowFrameAggregateKernel::Impl {
+ public:
+  Impl(arrow::compute::FunctionContext* ctx, std::string function_name,
+       std::vector<std::shared_ptr<arrow::DataType>> type_list,
+       std::vector<std::shared_ptr<arrow::Field>> order_key_fields,
+       std::vector<bool> sort_directions, std::vector<bool> nulls_order,
+       WindowFrame frame, std::shared_ptr<arrow::DataType> result_type)
+      : ctx_(ctx),
+        function_name_(function_name),
+        type_list_(type_list),
+        order_key_fields_(order_key_fields),
+        sort_directions_(sort_directions),
+        nulls_order_(nulls_order),
+        frame_(frame),
+        result_type_(result_type) {}
+
+  arrow::Status Evaluate(const ArrayList& in) {
+    input_cache_.push_back(in);
+    return arrow::Status::OK();
+  }
+
+  arrow::Status Finish(ArrayList* out) {
+    if (type_list_.empty()) {
+      // count(*), values are never read
+      return Finish0<arrow::Int64Type>(out);
+    }
+    switch (type_list_[0]->id()) {
+#define PROCESS(InType)                   \
+  case InType::type_id: {                 \
+    RETURN_NOT_OK(Finish0<InType>(out));  \
+  } break;
+      PROCESS_FRAME_SUPPORTED_TYPES(PROCESS)
+#undef PROCESS
+      default: {
+        if (function_name_ != "count") {
+          return arrow::Status::Invalid("window frame function: unsupported input type " +
+                                        type_list_[0]->ToString());
+        }
+        RETURN_NOT_OK(Finish0<arrow::Int64Type>(out));
+      } break;
+    }
+    return arrow::Status::OK();
+  }
+
+  arrow::Status Reset() {
+    input_cache_.clear();
+    order_keys_.clear();
+    cmp_functions_.clear();
+    return arrow::Status::OK();
+  }
+
+ private:
+  struct RowIndex {
+    int32_t array_id;
+    int32_t id;
+  };
+
+  arrow::compute::FunctionContext* ctx_;
+  std::string function_name_;
+  std::vector<std::shared_ptr<arrow::DataType>> type_list_;
+  std::vector<std::shared_ptr<arrow::Field>> order_key_fields_;
+  std::vector<bool> sort_directions_;
+  std::vector<bool> nulls_order_;
+  WindowFrame frame_;
+  std::shared_ptr<arrow::DataType> result_type_;
+  std::vector<ArrayList> input_cache_;
+  // order keys of all cached batches and comparators over them
+  std::vector<arrow::ArrayVector> order_keys_;
+  std::vector<func::function<void(int, int, int64_t, int64_t, int&)>> cmp_functions_;
+
+  template <typename T>
+  static typename std::enable_if<std::is_floating_point<T>::value, bool>::type Greater(
+      T x, T y) {
+    // NaN is greater than any other value as in Spark
+    return std::isnan(x) ? !std::isnan(y) : x > y;
+  }
+
+  template <typename T>
+  static typename std::enable_if<!std::is_floating_point<T>::value, bool>::type Greater(
+      T x, T y) {
+    return x > y;
+  }
+
+  int Compare(const RowIndex& x, const RowIndex& y) {
+    int cmp_res = 2;
+    for (auto& cmp_function : cmp_functions_) {
+      cmp_function(x.array_id, y.array_id, x.id, y.id, cmp_res);
+      if (cmp_res != 2) break;
+    }
+    return cmp_res;
+  }
+
+  template <typename InType>
+  arrow::Status Finish0(ArrayList* out) {
+    using CType = typename arrow::TypeTraits<InType>::CType;
+    using AccType = typename std::conditional<std::is_floating_point<CType>::value,
+                                              double, int64_t>::type;
+    if (function_name_ == "avg") {
+      return Finish1<InType, double>(out);
+    }
+    return Finish1<InType, AccType>(out);
+  }
+
+  template <typename InType, typename ResultCType>
+  arrow::Status Finish1(ArrayList* out) {
+    using CType = typename arrow::TypeTraits<InType>::CType;
+    using ArrayType = typename arrow::TypeTraits<InType>::ArrayType;
+    int num_keys = order_key_fields_.size();
+    bool has_value = !type_list_.empty();
+    arrow::ArrayVector values;
+    std::vector<std::shared_ptr<ArrayType>> typed_values;
+    std::vector<std::shared_ptr<arrow::Int32Array>> group_ids;
+    order_keys_.assign(num_keys, {});
+    for (auto& batch : input_cache_) {
+      if (has_value) {
+        values.push_back(batch[0]);
+        typed_values.push_back(std::dynamic_pointer_cast<ArrayType>(batch[0]));
+      }
+      for (int i = 0; i < num_keys; i++) {
+        order_keys_[i].push_back(batch[has_value + i]);
+      }
+      group_ids.push_back(std::dynamic_pointer_cast<arrow::Int32Array>(batch.back()));
+    }
+    if (num_keys > 0) {
+      std::vector<int> key_index_list(num_keys);
+      std::iota(key_index_list.begin(), key_index_list.end(), 0);
+      cmp_functions_.clear();
+      RETURN_NOT_OK(MakeCmpFunction(order_keys_, order_key_fields_, key_index_list,
+                                    sort_directions_, nulls_order_, true,
+                                    cmp_functions_));
+      if (cmp_functions_.size() != num_keys) {
+        return arrow::Status::Invalid(
+            "window frame function: unsupported order key type");
+      }
+    }
+
+    // rows of each partition in input order
+    std::vector<std::vector<RowIndex>> partitions;
+    std::vector<std::vector<ResultCType>> results(input_cache_.size());
+    std::vector<std::vector<bool>> result_validity(input_cache_.size());
+    for (int array_id = 0; array_id < group_ids.size(); array_id++) {
+      auto& slice = group_ids[array_id];
+      results[array_id].resize(slice->length());
+      result_validity[array_id].resize(slice->length(), false);
+      for (int32_t id = 0; id < slice->length(); id++) {
+        if (slice->IsNull(id)) continue;
+        auto group_id = slice->GetView(id);
+        if (group_id >= partitions.size()) partitions.resize(group_id + 1);
+        partitions[group_id].push_back({array_id, id});
+      }
+    }
+
+    bool need_values = function_name_ != "count";
+    std::vector<int64_t> frame_starts;
+    std::vector<int64_t> frame_ends;
+    std::vector<CType> partition_values;
+    std::vector<bool> partition_validity;
+    for (auto& rows : partitions) {
+      if (num_keys > 0) {
+        auto less = [this](const RowIndex& x, const RowIndex& y) {
+          return Compare(x, y) == 1;
+        };
+        // streaming input is sorted already
+        if (!std::is_sorted(rows.begin(), rows.end(), less)) {
+          std::stable_sort(rows.begin(), rows.end(), less);
+        }
+      }
+      RETURN_NOT_OK(GetFrames(rows, &frame_starts, &frame_ends));
+      int64_t length = rows.size();
+      partition_values.resize(length);
+      partition_validity.resize(length);
+      for (int64_t i = 0; i < length; i++) {
+        auto& row = rows[i];
+        partition_validity[i] = !has_value || !values[row.array_id]->IsNull(row.id);
+        if (need_values && partition_validity[i]) {
+          partition_values[i] = typed_values[row.array_id]->GetView(row.id);
+        }
+      }
+      AggregateFrames(rows, partition_values, partition_validity, frame_starts,
+                      frame_ends, &results, &result_validity);
+    }
+
+    switch (result_type_->id()) {
+#define PROCESS(OutType)                                                          \
+  case OutType::type_id: {                                                        \
+    RETURN_NOT_OK(BuildResults<OutType>(results, result_validity, out));          \
+  } break;
+      PROCESS_FRAME_SUPPORTED_TYPES(PROCESS)
+#undef PROCESS
+      default:
+        return arrow::Status::Invalid("window frame function: unsupported result type " +
+                                      result_type_->ToString());
+    }
+    input_cache_.clear();
+    order_keys_.clear();
+    return arrow::Status::OK();
+  }
+
+  /* Sets [start, end) of the frame of each row of a sorted partition */
+  arrow::Status GetFrames(const std::vector<RowIndex>& rows, std::vector<int64_t>* starts,
+                          std::vector<int64_t>* ends) {
+    int64_t length = rows.size();
+    starts->resize(length);
+    ends->resize(length);
+    bool unbounded_preceding = std::isinf(frame_.lower) && frame_.lower < 0;
+    bool unbounded_following = std::isinf(frame_.upper) && frame_.upper > 0;
+    if (!frame_.is_range) {
+      for (int64_t i = 0; i < length; i++) {
+        (*starts)[i] = unbounded_preceding
+                           ? 0
+                           : std::min<double>(std::max<double>(i + frame_.lower, 0),
+                                              length);
+        (*ends)[i] = unbounded_following
+                         ? length
+                         : std::min<double>(std::max<double>(i + frame_.upper + 1, 0),
+                                            length);
+      }
+      return arrow::Status::OK();
+    }
+    bool lower_offset = !unbounded_preceding && frame_.lower != 0;
+    bool upper_offset = !unbounded_following && frame_.upper != 0;
+    if (lower_offset || upper_offset) {
+      if (order_key_fields_.size() != 1) {
+        return arrow::Status::Invalid(
+            "window frame function: RANGE frame with offsets needs one order key");
+      }
+      switch (order_key_fields_[0]->type()->id()) {
+#define PROCESS(KeyType)                                                      \
+  case KeyType::type_id: {                                                    \
+    return GetRangeFrames<KeyType>(rows, unbounded_preceding,                 \
+                                   unbounded_following, starts, ends);        \
+  } break;
+        PROCESS_FRAME_SUPPORTED_TYPES(PROCESS)
+#undef PROCESS
+        default:
+          return arrow::Status::Invalid(
+              "window frame function: unsupported RANGE frame order key type " +
+              order_key_fields_[0]->type()->ToString());
+      }
+    }
+    // CURRENT ROW of a RANGE frame is the first or the last peer of the row
+    int64_t peer_start = 0;
+    for (int64_t i = 0; i < length; i++) {
+      if (i > 0 && Compare(rows[i - 1], rows[i]) != 2) peer_start = i;
+      (*starts)[i] = unbounded_preceding ? 0 : peer_start;
+    }
+    int64_t peer_end = length;
+    for (int64_t i = length - 1; i >= 0; i--) {
+      if (i < length - 1 && Compare(rows[i], rows[i + 1]) != 2) peer_end = i + 1;
+      (*ends)[i] = unbounded_following ? length : peer_end;
+    }
+    return arrow::Status::OK();
+  }
+
+  template <typename KeyType>
+  arrow::Status GetRangeFrames(const std::vector<RowIndex>& rows,
+                               bool unbounded_preceding, bool unbounded_following,
+                               std::vector<int64_t>* starts, std::vector<int64_t>* ends) {
+    using CType = typename arrow::TypeTraits<KeyType>::CType;
+    using ArrayType = typename arrow::TypeTraits<KeyType>::ArrayType;
+    using KeyCType = typename std::conditional<std::is_floating_point<CType>::value,
+                                               double, int64_t>::type;
+    int64_t length = rows.size();
+    bool asc = sort_directions_[0];
+    std::vector<std::shared_ptr<ArrayType>> keys;
+    for (auto& array : order_keys_[0]) {
+      keys.push_back(std::dynamic_pointer_cast<ArrayType>(array));
+    }
+    // keys in sort order, nulls and NaNs are kept apart as kind 1 and 2
+    std::vector<KeyCType> sorted_keys(length);
+    std::vector<int> kinds(length, 0);
+    int64_t first_value = length;
+    int64_t last_value = -1;
+    for (int64_t i = 0; i < length; i++) {
+      auto& key_array = keys[rows[i].array_id];
+      if (key_array->IsNull(rows[i].id)) {
+        kinds[i] = 1;
+        continue;
+      }
+      KeyCType key = key_array->GetView(rows[i].id);
+      if (std::isnan(static_cast<double>(key))) {
+        kinds[i] = 2;
+        continue;
+      }
+      sorted_keys[i] = asc ? key : -key;
+      first_value = std::min(first_value, i);
+      last_value = i;
+    }
+    KeyCType lower = unbounded_preceding ? 0 : static_cast<KeyCType>(frame_.lower);
+    KeyCType upper = unbounded_following ? 0 : static_cast<KeyCType>(frame_.upper);
+    int64_t start = first_value;
+    int64_t end = first_value;
+    int64_t block_start = 0;
+    for (int64_t i = 0; i < length; i++) {
+      if (i > 0 && kinds[i] != kinds[i - 1]) block_start = i;
+      if (kinds[i] != 0) {
+        int64_t block_end = i;
+        while (block_end < length && kinds[block_end] == kinds[i]) block_end++;
+        (*starts)[i] = unbounded_preceding ? 0 : block_start;
+        (*ends)[i] = unbounded_following ? length : block_end;
+        continue;
+      }
+      if (unbounded_preceding) {
+        (*starts)[i] = 0;
+      } else {
+        while (start <= last_value && sorted_keys[start] < sorted_keys[i] + lower) {
+          start++;
+        }
+        (*starts)[i] = start;
+      }
+      if (unbounded_following) {
+        (*ends)[i] = length;
+      } else {
+        end = std::max(end, start);
+        while (end <= last_value && !(sorted_keys[end] > sorted_keys[i] + upper)) end++;
+        (*ends)[i] = end;
+      }
+    }
+    return arrow::Status::OK();
+  }
+
+  /* Sums of floating values of a partition over any [start, end). A running sum would
+   * subtract the values leaving the frame, which loses small values added next to a
+   * large one and never gets out of Inf or NaN. So finite values are summed by a
+   * segment tree and NaN, +Inf and -Inf are counted apart. Tree nodes add values in
+   * pairs rather than left to right as Spark sums each frame, so a sum may differ from
+   * Spark's in the last bits when values are not exactly representable. */
+  class FloatingFrameSum {
+   public:
+    template <typename CType>
+    FloatingFrameSum(const std::vector<CType>& values, const std::vector<bool>& validity)
+        : length_(values.size()),
+          tree_(2 * values.size(), 0),
+          nans_(values.size() + 1, 0),
+          pos_infs_(values.size() + 1, 0),
+          neg_infs_(values.size() + 1, 0) {
+      for (int64_t i = 0; i < length_; i++) {
+        double value = validity[i] ? static_cast<double>(values[i]) : 0;
+        bool is_nan = std::isnan(value);
+        bool is_inf = std::isinf(value);
+        nans_[i + 1] = nans_[i] + is_nan;
+        pos_infs_[i + 1] = pos_infs_[i] + (is_inf && value > 0);
+        neg_infs_[i + 1] = neg_infs_[i] + (is_inf && value < 0);
+        tree_[length_ + i] = is_nan || is_inf ? 0 : value;
+      }
+      for (int64_t i = length_ - 1; i > 0; i--) {
+        tree_[i] = tree_[2 * i] + tree_[2 * i + 1];
+      }
+    }
+
+    double Sum(int64_t start, int64_t end) const {
+      if (nans_[end] - nans_[start] > 0) return std::numeric_limits<double>::quiet_NaN();
+      bool pos_inf = pos_infs_[end] - pos_infs_[start] > 0;
+      bool neg_inf = neg_infs_[end] - neg_infs_[start] > 0;
+      if (pos_inf && neg_inf) return std::numeric_limits<double>::quiet_NaN();
+      if (pos_inf) return std::numeric_limits<double>::infinity();
+      if (neg_inf) return -std::numeric_limits<double>::infinity();
+      double sum = 0;
+      for (start += length_, end += length_; start < end; start /= 2, end /= 2) {
+        if (start & 1) sum += tree_[start++];
+        if (end & 1) sum += tree_[--end];
+      }
+      return sum;
+    }
+
+   private:
+    int64_t length_;
+    std::vector<double> tree_;
+    std::vector<int64_t> nans_;
+    std::vector<int64_t> pos_infs_;
+    std::vector<int64_t> neg_infs_;
+  };
+
+  template <typename CType, typename ResultCType>
+  void AggregateFrames(const std::vector<RowIndex>& rows,
+                       const std::vector<CType>& values,
+                       const std::vector<bool>& validity,
+                       const std::vector<int64_t>& starts,
+                       const std::vector<int64_t>& ends,
+                       std::vector<std::vector<ResultCType>>* results,
+                       std::vector<std::vector<bool>>* result_validity) {
+    using AccType = typename std::conditional<std::is_floating_point<CType>::value,
+                                              double, int64_t>::type;
+    bool is_min = function_name_ == "min";
+    bool is_extreme = is_min || function_name_ == "max";
+    // floating sums of frames whose start moves are not kept by add and remove
+    std::unique_ptr<FloatingFrameSum> frame_sum;
+    if (std::is_floating_point<CType>::value && !is_extreme &&
+        function_name_ != "count" && !starts.empty() && starts.back() > 0) {
+      frame_sum.reset(new FloatingFrameSum(values, validity));
+    }
+    // true if the value of row x wins over the one of row y
+    auto better = [&](int64_t x, int64_t y) {
+      return is_min ? Greater(values[y], values[x]) : Greater(values[x], values[y]);
+    };
+    AccType sum = 0;
+    int64_t count = 0;
+    std::deque<int64_t> extremes;
+    auto add = [&](int64_t i) {
+      if (!validity[i]) return;
+      count++;
+      if (is_extreme) {
+        while (!extremes.empty() && !better(extremes.back(), i)) extremes.pop_back();
+        extremes.push_back(i);
+      } else if (!frame_sum) {
+        sum += values[i];
+      }
+    };
+    auto remove = [&](int64_t i) {
+      if (!validity[i]) return;
+      count--;
+      if (is_extreme) {
+        if (!extremes.empty() && extremes.front() == i) extremes.pop_front();
+      } else if (!frame_sum) {
+        sum -= values[i];
+      }
+    };
+    int64_t frame_start = 0;
+    int64_t frame_end = 0;
+    for (int64_t i = 0; i < rows.size(); i++) {
+      for (; frame_start < starts[i]; frame_start++) {
+        if (frame_start < frame_end) remove(frame_start);
+      }
+      frame_end = std::max(frame_end, frame_start);
+      for (; frame_end < ends[i]; frame_end++) add(frame_end);
+      if (frame_sum) sum = frame_sum->Sum(frame_start, frame_end);
+      auto& row = rows[i];
+      bool valid = true;
+      ResultCType result = 0;
+      if (function_name_ == "count") {
+        result = count;
+      } else if (count == 0) {
+        valid = false;
+      } else if (is_extreme) {
+        result = values[extremes.front()];
+      } else if (function_name_ == "avg") {
+        result = static_cast<double>(sum) / count;
+      } else {
+        result = sum;
+      }
+      (*results)[row.array_id][row.id] = result;
+      (*result_validity)[row.array_id][row.id] = valid;
+    }
+  }
+
+  template <typename OutType, typename ResultCType>
+  arrow::Status BuildResults(const std::vector<std::vector<ResultCType>>& results,
+                             const std::vector<std::vector<bool>>& result_validity,
+                             ArrayList* out) {
+    using OutCType = typename arrow::TypeTraits<OutType>::CType;
+    for (int array_id = 0; array_id < results.size(); array_id++) {
+      arrow::NumericBuilder<OutType> builder(result_type_, ctx_->memory_pool());
+      auto& batch_results = results[array_id];
+      RETURN_NOT_OK(builder.Reserve(batch_results.size()));
+      for (int64_t i = 0; i < batch_results.size(); i++) {
+        if (result_validity[array_id][i]) {
+          builder.UnsafeAppend(static_cast<OutCType>(batch_results[i]));
+        } else {
+          builder.UnsafeAppendNull();
+        }
+      }
+      std::shared_ptr<arrow::Array> out_array;
+      RETURN_NOT_OK(builder.Finish(&out_array));
+      out->push_back(out_array);
+    }
+    return arrow::Status::OK();
+  }
+};
+
+arrow::Status WindowFrameAggregateKernel::Make(
+    arrow::compute::FunctionContext* ctx, std::string function_name,
+    std::vector<std::shared_ptr<arrow::DataType>> type_list,
+    std::vector<std::shared_ptr<arrow::Field>> order_key_fields,
+    std::vector<bool> sort_directions, std::vector<bool> nulls_order, WindowFrame frame,
+    std::shared_ptr<arrow::DataType> result_type, std::shared_ptr<KernalBase>* out) {
+  if (function_name != "sum" && function_name != "avg" && function_name != "count" &&
+      function_name != "min" && function_name != "max") {
+    return arrow::Status::Invalid("window frame function not supported: " +
+                                  function_name);
+  }
+  if (type_list.size() > 1 || (type_list.empty() && function_name != "count")) {
+    return arrow::Status::Invalid("given invalid input arguments for window function: " +
+                                  function_name);
+  }
+  *out = std::make_shared<WindowFrameAggregateKernel>(
+      ctx, function_name, type_list, order_key_fields, sort_directions, nulls_order,
+      frame, result_type);
+  return arrow::Status::OK();
+}
+
+WindowFrameAggregateKernel::WindowFrameAggregateKernel(
+    arrow::compute::FunctionContext* ctx, std::string function_name,
+    std::vector<std::shared_ptr<arrow::DataType>> type_list,
+    std::vector<std::shared_ptr<arrow::Field>> order_key_fields,
+    std::vector<bool> sort_directions, std::vector<bool> nulls_order, WindowFrame frame,
+    std::shared_ptr<arrow::DataType> result_type) {
+  impl_.reset(new Impl(ctx, function_name, type_list, order_key_fields, sort_directions,
+                       nulls_order, frame, result_type));
+  kernel_name_ = "WindowFrameAggregateKernel";
+  ctx_ = ctx;
+}
+
+arrow::Status WindowFrameAggregateKernel::Evaluate(const ArrayList& in) {
+  return impl_->Evaluate(in);
+}
+
+arrow::Status WindowFrameAggregateKernel::Finish(ArrayList* out) {
+  return impl_->Finish(out);
+}
+
+arrow::Status WindowFrameAggregateKernel::Reset() { return impl_->Reset(); }
+
 }
 }
 }
@@ -187,6 +187,12 @@ class WindowSortKernel::Impl {
   virtual arrow::Status Finish(std::shared_ptr<arrow::Array>* out) {
     return arrow::Status::OK();
   }
+
+  /* Drops the cached batches, the loaded sorter is kept for the next partitions */
+  virtual arrow::Status Reset() {
+    RETURN_NOT_OK(sorter->Reset());
+    return arrow::Status::OK();
+  }
   std::string GetSignature() { return signature_; }
 
  protected:
@@ -251,6 +257,7 @@ class WindowSortKernel::Impl {
       indice++;
     }
     std::string cached_insert_str = GetCachedInsert(shuffle_typed_codegen_list.size());
+    std::string cached_clear_str = GetCachedClear(shuffle_typed_codegen_list.size());
     std::string comp_func_str = GetCompFunction(key_index_list_);
 
     std::string sort_func_str = GetSortFunction(key_index_list_);
@@ -300,6 +307,13 @@ class TypedSorterImpl : public CodeGenBase {
     return arrow::Status::OK();
   }
 
+  arrow::Status Reset() override {
+    num_batches_ = 0;
+    )" + cached_clear_str +
+        R"(
+    return arrow::Status::OK();
+  }
+
   arrow::Status FinishInternal(std::shared_ptr<arrow::Array> in, std::shared_ptr<FixedSizeBinaryArray>* out) {
     )" + comp_func_str +
         R"(
@@ -423,6 +437,13 @@ extern "C" void MakeCodeGen(arrow::compute::FunctionContext* ctx,
     }
     return ss.str();
   }
+  std::string GetCachedClear(int shuffle_size) {
+    std::stringstream ss;
+    for (int i = 0; i < shuffle_size; i++) {
+      ss << "cached_" << i << "_.clear();" << std::endl;
+    }
+    return ss.str();
+  }
   std::string GetCompFunction(std::vector<int> sort_key_index_list) {
     std::stringstream ss;
     ss << "auto comp = [this](ArrayItemIndex x, ArrayItemIndex y) {"
@@ -591,6 +612,14 @@ class WindowSortOnekeyKernel : public WindowSortKernel::Impl {
     return arrow::Status::OK();
   }
 
+  arrow::Status Reset() override {
+    num_batches_ = 0;
+    cached_key_.clear();
+    length_list_.clear();
+    cached_.clear();
+    return arrow::Status::OK();
+  }
+
   arrow::Status FinishInternal(std::shared_ptr<arrow::Array> in,
       std::shared_ptr<FixedSizeBinaryArray>* out) {
     int items_total = 0;
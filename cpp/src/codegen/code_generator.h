@@ -59,6 +59,12 @@ class CodeGenerator {
     *spilled_size = 0;
     return arrow::Status::OK();
   }
+  /* Bytes held by the memory pool of this operator, now and at its peak */
+  virtual arrow::Status GetMemoryUsage(int64_t* bytes_allocated, int64_t* peak_bytes) {
+    *bytes_allocated = 0;
+    *peak_bytes = 0;
+    return arrow::Status::OK();
+  }
   virtual std::string ToString() { return ""; }
 };
 }  // namespace codegen
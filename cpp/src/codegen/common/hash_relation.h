@@ -17,11 +17,16 @@
 
 #pragma once
 
+#include <arrow/buffer.h>
 #include <arrow/compute/context.h>
+#include <arrow/io/file.h>
 #include <arrow/memory_pool.h>
 #include <arrow/status.h>
 #include <arrow/type_fwd.h>
 
+#include <algorithm>
+#include <limits>
+
 #include "codegen/arrow_compute/ext/array_item_index.h"
 #include "precompile/type_traits.h"
 #include "precompile/unsafe_array.h"
@@ -119,9 +124,33 @@ using is_number_alike =
 
 /////////////////////////////////////////////////////////////////////////
 
+/* Position independent layout of a serialized hash table:
+ * |header|pad to 64|keyArray|pad to 64|bytesMap|
+ * sections are addressed by offset from the beginning, so the whole table can be
+ * shipped as one buffer or mmap-ed from a file and probed in place. Offsets stored
+ * inside keyArray and bytesMap are already relative to bytesMap. */
+struct HashRelationTableHeader {
+  uint32_t magic;
+  uint32_t version;
+  int32_t array_capacity;
+  int32_t bytes_in_key_array;
+  int32_t num_keys;
+  int32_t cursor;
+  int64_t key_array_offset;
+  int64_t key_array_length;
+  int64_t bytes_map_offset;
+  int64_t bytes_map_length;
+};
+
+static constexpr uint32_t kHashRelationTableMagic = 0x54524853;  // "SHRT"
+static constexpr uint32_t kHashRelationTableVersion = 1;
+static constexpr int64_t kHashRelationTableAlignment = 64;
+
+/////////////////////////////////////////////////////////////////////////
+
 class HashRelation {
  public:
-  HashRelation(arrow::compute::FunctionContext* ctx) : ctx_(ctx) {}
+  HashRelation(arrow::compute::FunctionContext* ctx) : pool_(ctx->memory_pool()) {}
 
   HashRelation(
       const std::vector<std::shared_ptr<HashRelationColumn>>& hash_relation_list) {
@@ -134,20 +163,18 @@ class HashRelation {
       int key_size = -1)
       : HashRelation(hash_relation_column) {
     key_size_ = key_size;
-    ctx_ = ctx;
+    pool_ = ctx->memory_pool();
     arrayid_list_.reserve(64);
   }
 
-  ~HashRelation() {
-    if (hash_table_ != nullptr && !unsafe_set) {
-      destroyHashMap(hash_table_);
-      hash_table_ = nullptr;
-    }
-  }
+  ~HashRelation() { DestroyHashTables(); }
 
   arrow::Status InitHashTable(int init_key_capacity, int initial_bytesmap_capacity) {
-    hash_table_ = createUnsafeHashMap(ctx_->memory_pool(), init_key_capacity,
+    hash_table_ = createUnsafeHashMap(pool_, init_key_capacity,
                                       initial_bytesmap_capacity, key_size_);
+    if (hash_table_ == nullptr) {
+      return arrow::Status::OutOfMemory("HashRelation InitHashTable failed.");
+    }
     return arrow::Status::OK();
   }
 
@@ -155,34 +182,103 @@ class HashRelation {
     return arrow::Status::NotImplemented("HashRelation AppendKeyColumn is abstract.");
   }
 
+  /* Used by partitioned parallel build. Every partition was built into its own
+   * relation from the rows whose hash top partition_bits equal to its index, their
+   * hash tables are taken over here and probed directly, no merge is needed. */
+  arrow::Status SetHashPartitions(
+      int partition_bits, const std::vector<std::shared_ptr<HashRelation>>& partitions) {
+    if (partitions.size() != ((size_t)1 << partition_bits)) {
+      return arrow::Status::Invalid("HashRelation expects ", 1 << partition_bits,
+                                    " partitions, got ", partitions.size());
+    }
+    DestroyHashTables();
+    for (auto partition : partitions) {
+      if (partition->hash_table_ == nullptr || partition->partition_bits_ != 0) {
+        return arrow::Status::Invalid("HashRelation partition hash_table is null.");
+      }
+      partition_tables_.push_back(partition->hash_table_);
+      partition->hash_table_ = nullptr;
+      if (partition->num_arrays_ > num_arrays_) num_arrays_ = partition->num_arrays_;
+    }
+    partition_bits_ = partition_bits;
+    hash_table_ = partition_tables_[0];
+    unsafe_set = false;
+    return arrow::Status::OK();
+  }
+
+  /* Merge partitions into one hash table, only needed when the table is shipped as
+   * one piece, probing works on partitions directly. */
+  arrow::Status MergeHashPartitions() {
+    if (partition_bits_ == 0) return arrow::Status::OK();
+    int64_t num_keys = 0;
+    int64_t bytes_map_size = 8;
+    for (auto table : partition_tables_) {
+      num_keys += table->numKeys;
+      bytes_map_size += table->cursor;
+    }
+    if (bytes_map_size > std::numeric_limits<int>::max()) {
+      return arrow::Status::Invalid("HashRelation bytes map size ", bytes_map_size,
+                                    " exceeds the limit of one hash table.");
+    }
+    int key_capacity = 128;
+    while (key_capacity * loadFactor < num_keys && key_capacity < MAX_HASH_MAP_CAPACITY) {
+      key_capacity <<= 1;
+    }
+    auto merged_table =
+        createUnsafeHashMap(pool_, key_capacity, (int)bytes_map_size, key_size_);
+    if (merged_table == nullptr) {
+      return arrow::Status::OutOfMemory("HashRelation MergeHashPartitions failed.");
+    }
+    for (auto table : partition_tables_) {
+      if (!mergeIntoHashMap(merged_table, table)) {
+        destroyHashMap(merged_table);
+        return arrow::Status::CapacityError("Merge to HashMap failed.");
+      }
+    }
+    DestroyHashTables();
+    hash_table_ = merged_table;
+    unsafe_set = false;
+    return arrow::Status::OK();
+  }
+
   arrow::Status Minimize() {
     if (hash_table_ == nullptr) {
       return arrow::Status::OK();
     }
-    if (shrinkToFit(hash_table_)) {
-      return arrow::Status::OK();
+    if (partition_bits_ == 0) {
+      if (shrinkToFit(hash_table_)) {
+        return arrow::Status::OK();
+      }
+      return arrow::Status::Invalid("Error minimizing hash table");
     }
-    return arrow::Status::Invalid("Error minimizing hash table");
+    for (auto table : partition_tables_) {
+      if (!shrinkToFit(table)) {
+        return arrow::Status::Invalid("Error minimizing hash table");
+      }
+    }
+    return arrow::Status::OK();
   }
 
+  /* rows, if not null, are the only rows of in to be inserted */
   arrow::Status AppendKeyColumn(
       std::shared_ptr<arrow::Array> in,
-      const std::vector<std::shared_ptr<UnsafeArray>>& payloads) {
+      const std::vector<std::shared_ptr<UnsafeArray>>& payloads,
+      const std::vector<int32_t>* rows = nullptr) {
     if (hash_table_ == nullptr) {
       throw std::runtime_error("HashRelation Get failed, hash_table is null.");
     }
     // This Key should be Hash Key
     auto typed_array = std::make_shared<ArrayType>(in);
     std::shared_ptr<UnsafeRow> payload = std::make_shared<UnsafeRow>(payloads.size());
-    for (int i = 0; i < typed_array->length(); i++) {
+    RETURN_NOT_OK(VisitRows(typed_array->length(), rows, [&](int i) {
       payload->reset();
       for (auto payload_arr : payloads) {
         payload_arr->Append(i, &payload);
       }
       // chendi: Since spark won't join rows contain null, we will skip null row.
-      if (payload->isNullExists()) continue;
-      RETURN_NOT_OK(Insert(typed_array->GetView(i), payload, num_arrays_, i));
-    }
+      if (payload->isNullExists()) return arrow::Status::OK();
+      return Insert(typed_array->GetView(i), payload, num_arrays_, i);
+    }));
 
     num_arrays_++;
     // DumpHashMap();
@@ -193,26 +289,24 @@ class HashRelation {
             typename std::enable_if_t<!std::is_same<KeyArrayType, StringArray>::value>* =
                 nullptr>
   arrow::Status AppendKeyColumn(std::shared_ptr<arrow::Array> in,
-                                std::shared_ptr<KeyArrayType> original_key) {
+                                std::shared_ptr<KeyArrayType> original_key,
+                                const std::vector<int32_t>* rows = nullptr) {
     if (hash_table_ == nullptr) {
       throw std::runtime_error("HashRelation Get failed, hash_table is null.");
     }
     // This Key should be Hash Key
     auto typed_array = std::make_shared<ArrayType>(in);
     if (original_key->null_count() == 0) {
-      for (int i = 0; i < typed_array->length(); i++) {
-        RETURN_NOT_OK(
-            Insert(typed_array->GetView(i), original_key->GetView(i), num_arrays_, i));
-      }
+      RETURN_NOT_OK(VisitRows(typed_array->length(), rows, [&](int i) {
+        return Insert(typed_array->GetView(i), original_key->GetView(i), num_arrays_, i);
+      }));
     } else {
-      for (int i = 0; i < typed_array->length(); i++) {
+      RETURN_NOT_OK(VisitRows(typed_array->length(), rows, [&](int i) {
         if (original_key->IsNull(i)) {
-          RETURN_NOT_OK(InsertNull(num_arrays_, i));
-        } else {
-          RETURN_NOT_OK(
-              Insert(typed_array->GetView(i), original_key->GetView(i), num_arrays_, i));
+          return InsertNull(num_arrays_, i);
         }
-      }
+        return Insert(typed_array->GetView(i), original_key->GetView(i), num_arrays_, i);
+      }));
     }
 
     num_arrays_++;
@@ -221,28 +315,26 @@ class HashRelation {
   }
 
   arrow::Status AppendKeyColumn(std::shared_ptr<arrow::Array> in,
-                                std::shared_ptr<StringArray> original_key) {
+                                std::shared_ptr<StringArray> original_key,
+                                const std::vector<int32_t>* rows = nullptr) {
     if (hash_table_ == nullptr) {
       throw std::runtime_error("HashRelation Get failed, hash_table is null.");
     }
     // This Key should be Hash Key
     auto typed_array = std::make_shared<ArrayType>(in);
     if (original_key->null_count() == 0) {
-      for (int i = 0; i < typed_array->length(); i++) {
+      RETURN_NOT_OK(VisitRows(typed_array->length(), rows, [&](int i) {
         auto str = original_key->GetString(i);
-        RETURN_NOT_OK(
-            Insert(typed_array->GetView(i), str.data(), str.size(), num_arrays_, i));
-      }
+        return Insert(typed_array->GetView(i), str.data(), str.size(), num_arrays_, i);
+      }));
     } else {
-      for (int i = 0; i < typed_array->length(); i++) {
+      RETURN_NOT_OK(VisitRows(typed_array->length(), rows, [&](int i) {
         if (original_key->IsNull(i)) {
-          RETURN_NOT_OK(InsertNull(num_arrays_, i));
-        } else {
-          auto str = original_key->GetString(i);
-          RETURN_NOT_OK(
-              Insert(typed_array->GetView(i), str.data(), str.size(), num_arrays_, i));
+          return InsertNull(num_arrays_, i);
         }
-      }
+        auto str = original_key->GetString(i);
+        return Insert(typed_array->GetView(i), str.data(), str.size(), num_arrays_, i);
+      }));
     }
 
     num_arrays_++;
@@ -256,7 +348,7 @@ class HashRelation {
     if (hash_table_ == nullptr) {
       throw std::runtime_error("HashRelation Get failed, hash_table is null.");
     }
-    auto res = safeLookup(hash_table_, payload, v, &arrayid_list_);
+    auto res = safeLookup(LookupTable(v), payload, v, &arrayid_list_);
     if (res == -1) return -1;
 
     return 0;
@@ -266,7 +358,8 @@ class HashRelation {
     if (hash_table_ == nullptr) {
       throw std::runtime_error("HashRelation Get failed, hash_table is null.");
     }
-    auto res = safeLookup(hash_table_, payload.data(), payload.size(), v, &arrayid_list_);
+    auto res =
+        safeLookup(LookupTable(v), payload.data(), payload.size(), v, &arrayid_list_);
     if (res == -1) return -1;
     return 0;
   }
@@ -275,7 +368,7 @@ class HashRelation {
     if (hash_table_ == nullptr) {
       throw std::runtime_error("HashRelation Get failed, hash_table is null.");
     }
-    auto res = safeLookup(hash_table_, payload, v, &arrayid_list_);
+    auto res = safeLookup(LookupTable(v), payload, v, &arrayid_list_);
     if (res == -1) return -1;
     return 0;
   }
@@ -286,21 +379,21 @@ class HashRelation {
     if (hash_table_ == nullptr) {
       throw std::runtime_error("HashRelation Get failed, hash_table is null.");
     }
-    return safeLookup(hash_table_, payload, v);
+    return safeLookup(LookupTable(v), payload, v);
   }
 
   int IfExists(int32_t v, std::string payload) {
     if (hash_table_ == nullptr) {
       throw std::runtime_error("HashRelation Get failed, hash_table is null.");
     }
-    return safeLookup(hash_table_, payload.data(), payload.size(), v);
+    return safeLookup(LookupTable(v), payload.data(), payload.size(), v);
   }
 
   int IfExists(int32_t v, std::shared_ptr<UnsafeRow> payload) {
     if (hash_table_ == nullptr) {
       throw std::runtime_error("HashRelation Get failed, hash_table is null.");
     }
-    return safeLookup(hash_table_, payload, v);
+    return safeLookup(LookupTable(v), payload, v);
   }
 
   template <typename CType,
@@ -312,7 +405,7 @@ class HashRelation {
     if (*(CType*)recent_cached_key_ == payload) return 0;
     *(CType*)recent_cached_key_ = payload;
     int32_t v = hash32(payload, true);
-    auto res = safeLookup(hash_table_, payload, v, &arrayid_list_);
+    auto res = safeLookup(LookupTable(v), payload, v, &arrayid_list_);
     if (res == -1) {
       arrayid_list_.clear();
       return -1;
@@ -326,7 +419,8 @@ class HashRelation {
       throw std::runtime_error("HashRelation Get failed, hash_table is null.");
     }
     int32_t v = hash32(payload, true);
-    auto res = safeLookup(hash_table_, payload.data(), payload.size(), v, &arrayid_list_);
+    auto res =
+        safeLookup(LookupTable(v), payload.data(), payload.size(), v, &arrayid_list_);
     if (res == -1) return -1;
     return 0;
   }
@@ -338,7 +432,7 @@ class HashRelation {
       throw std::runtime_error("HashRelation Get failed, hash_table is null.");
     }
     int32_t v = hash32(payload, true);
-    return safeLookup(hash_table_, payload, v);
+    return safeLookup(LookupTable(v), payload, v);
   }
 
   int IfExists(std::string payload) {
@@ -346,7 +440,7 @@ class HashRelation {
       throw std::runtime_error("HashRelation Get failed, hash_table is null.");
     }
     int32_t v = hash32(payload, true);
-    return safeLookup(hash_table_, payload.data(), payload.size(), v);
+    return safeLookup(LookupTable(v), payload.data(), payload.size(), v);
   }
 
   int GetNull() {
@@ -374,6 +468,7 @@ class HashRelation {
     if (hash_table_ == nullptr) {
       return arrow::Status::Invalid("UnsafeGetHashTableObject hash_table is null");
     }
+    RETURN_NOT_OK(MergeHashPartitions());
     // dump(hash_table_);
     addrs[0] = (int64_t)hash_table_;
     sizes[0] = (int)sizeof(unsafeHashMap);
@@ -387,6 +482,11 @@ class HashRelation {
   }
 
   arrow::Status UnsafeSetHashTableObject(int len, int64_t* addrs, int* sizes) {
+    if (len == 1) {
+      // serialized table produced by SerializeHashTable, probed in place
+      return ImportHashTable(
+          std::make_shared<arrow::Buffer>((const uint8_t*)addrs[0], sizes[0]));
+    }
     assert(len == 3);
     hash_table_ = (unsafeHashMap*)addrs[0];
     hash_table_->cursor = sizes[2];
@@ -397,7 +497,174 @@ class HashRelation {
     return arrow::Status::OK();
   }
 
+  /* Serialize hash table into one contiguous buffer in HashRelationTableHeader
+   * layout, the buffer is kept by this relation until it is destroyed. */
+  arrow::Status SerializeHashTable(std::shared_ptr<arrow::Buffer>* out) {
+    if (hash_table_ == nullptr) {
+      return arrow::Status::Invalid("SerializeHashTable hash_table is null");
+    }
+    RETURN_NOT_OK(MergeHashPartitions());
+    HashRelationTableHeader header;
+    header.magic = kHashRelationTableMagic;
+    header.version = kHashRelationTableVersion;
+    header.array_capacity = hash_table_->arrayCapacity;
+    header.bytes_in_key_array = hash_table_->bytesInKeyArray;
+    header.num_keys = hash_table_->numKeys;
+    header.cursor = hash_table_->cursor;
+    header.key_array_offset = AlignTableOffset(sizeof(HashRelationTableHeader));
+    header.key_array_length =
+        (int64_t)hash_table_->arrayCapacity * hash_table_->bytesInKeyArray;
+    header.bytes_map_offset =
+        AlignTableOffset(header.key_array_offset + header.key_array_length);
+    header.bytes_map_length = hash_table_->cursor;
+    auto total_size = header.bytes_map_offset + header.bytes_map_length;
+
+    std::shared_ptr<arrow::Buffer> buf;
+    RETURN_NOT_OK(arrow::AllocateBuffer(pool_, total_size, &buf));
+    auto data = buf->mutable_data();
+    memset(data, 0, header.bytes_map_offset);
+    memcpy(data, &header, sizeof(HashRelationTableHeader));
+    memcpy(data + header.key_array_offset, hash_table_->keyArray,
+           header.key_array_length);
+    memcpy(data + header.bytes_map_offset, hash_table_->bytesMap,
+           header.bytes_map_length);
+    serialized_table_ = buf;
+    *out = buf;
+    return arrow::Status::OK();
+  }
+
+  /* Probe a serialized table in place, no copy or rehash is done. Caller should
+   * make sure the memory of buf is alive while this relation is used. */
+  arrow::Status ImportHashTable(const std::shared_ptr<arrow::Buffer>& buf) {
+    if (buf->size() < (int64_t)sizeof(HashRelationTableHeader)) {
+      return arrow::Status::Invalid("ImportHashTable buffer is too small");
+    }
+    auto data = buf->data();
+    HashRelationTableHeader header;
+    memcpy(&header, data, sizeof(HashRelationTableHeader));
+    if (header.magic != kHashRelationTableMagic ||
+        header.version != kHashRelationTableVersion) {
+      return arrow::Status::Invalid("ImportHashTable unknown format");
+    }
+    auto capacity = header.array_capacity;
+    if (capacity <= 0 || (capacity & (capacity - 1)) != 0) {
+      return arrow::Status::Invalid("ImportHashTable capacity ", capacity,
+                                    " is not a power of two");
+    }
+    if (header.num_keys < 0 || header.num_keys > capacity) {
+      return arrow::Status::Invalid("ImportHashTable ", header.num_keys,
+                                    " keys exceed capacity ", capacity);
+    }
+    if (header.bytes_in_key_array < 8 ||
+        header.key_array_length != (int64_t)capacity * header.bytes_in_key_array) {
+      return arrow::Status::Invalid("ImportHashTable key array size mismatch");
+    }
+    if (header.cursor < 0 || header.bytes_map_length != header.cursor) {
+      return arrow::Status::Invalid("ImportHashTable bytes map size mismatch");
+    }
+    // compare against the remaining size so corrupted offsets cannot overflow
+    if (header.key_array_offset < (int64_t)sizeof(HashRelationTableHeader) ||
+        header.key_array_offset > buf->size() ||
+        header.key_array_length > buf->size() - header.key_array_offset ||
+        header.bytes_map_offset < header.key_array_offset + header.key_array_length ||
+        header.bytes_map_offset > buf->size() ||
+        header.bytes_map_length > buf->size() - header.bytes_map_offset) {
+      return arrow::Status::Invalid("ImportHashTable buffer is truncated");
+    }
+    DestroyHashTables();
+    // a table serialized by this relation is superseded by the imported one
+    serialized_table_.reset();
+    imported_table_.arrayCapacity = header.array_capacity;
+    imported_table_.bytesInKeyArray = header.bytes_in_key_array;
+    imported_table_.mapSize = header.bytes_map_length;
+    imported_table_.cursor = header.cursor;
+    imported_table_.numKeys = header.num_keys;
+    imported_table_.needSpill = false;
+    // read only, lookups never write to the table
+    imported_table_.keyArray = (char*)(data + header.key_array_offset);
+    imported_table_.bytesMap = (char*)(data + header.bytes_map_offset);
+    imported_table_.pool = nullptr;
+    hash_table_ = &imported_table_;
+    imported_buffer_ = buf;
+    unsafe_set = true;
+    return arrow::Status::OK();
+  }
+
+  arrow::Status WriteHashTableFile(const std::string& path) {
+    std::shared_ptr<arrow::Buffer> buf;
+    RETURN_NOT_OK(SerializeHashTable(&buf));
+    ARROW_ASSIGN_OR_RAISE(auto file, arrow::io::FileOutputStream::Open(path));
+    RETURN_NOT_OK(file->Write(buf->data(), buf->size()));
+    serialized_table_.reset();
+    return file->Close();
+  }
+
+  /* Map a file written by WriteHashTableFile and probe it without loading */
+  arrow::Status MmapHashTableFile(const std::string& path) {
+    ARROW_ASSIGN_OR_RAISE(
+        auto file, arrow::io::MemoryMappedFile::Open(path, arrow::io::FileMode::READ));
+    ARROW_ASSIGN_OR_RAISE(auto size, file->GetSize());
+    ARROW_ASSIGN_OR_RAISE(auto buf, file->ReadAt(0, size));
+    RETURN_NOT_OK(ImportHashTable(buf));
+    mapped_file_ = file;
+    return arrow::Status::OK();
+  }
+
+  /* Share hash table and payload columns of other relation, this relation only owns
+   * lookup state (arrayid_list_ etc.), so several copies can be probed concurrently
+   * while the underlying hash table stays read-only. */
+  arrow::Status ShareHashTable(const std::shared_ptr<HashRelation>& other) {
+    if (other->hash_table_ == nullptr) {
+      return arrow::Status::Invalid("ShareHashTable hash_table is null");
+    }
+    hash_relation_column_list_ = other->hash_relation_column_list_;
+    hash_table_ = other->hash_table_;
+    partition_tables_ = other->partition_tables_;
+    partition_bits_ = other->partition_bits_;
+    key_size_ = other->key_size_;
+    num_arrays_ = other->num_arrays_;
+    unsafe_set = true;
+    shared_owner_ = other;
+    return arrow::Status::OK();
+  }
+
+  /* Copy the hash table into pool and drop every reference to memory of the building
+   * task, used before a relation is shared by tasks outliving the builder. If pool is
+   * out of memory, OutOfMemory is returned and the relation is left as it is. */
+  arrow::Status MoveHashTable(arrow::MemoryPool* pool) {
+    if (hash_table_ != nullptr) {
+      std::vector<unsafeHashMap*> moved_tables;
+      std::vector<unsafeHashMap*> tables = partition_tables_;
+      if (partition_bits_ == 0) tables = {hash_table_};
+      for (auto table : tables) {
+        auto moved_table = cloneHashMap(pool, table);
+        if (moved_table == nullptr) {
+          for (auto moved : moved_tables) {
+            destroyHashMap(moved);
+          }
+          return arrow::Status::OutOfMemory("HashRelation MoveHashTable failed.");
+        }
+        moved_tables.push_back(moved_table);
+      }
+      auto partition_bits = partition_bits_;
+      DestroyHashTables();
+      if (partition_bits != 0) {
+        partition_tables_ = moved_tables;
+        partition_bits_ = partition_bits;
+      }
+      hash_table_ = moved_tables[0];
+      unsafe_set = false;
+    }
+    shared_owner_.reset();
+    serialized_table_.reset();
+    imported_buffer_.reset();
+    mapped_file_.reset();
+    pool_ = pool;
+    return arrow::Status::OK();
+  }
+
   arrow::Status DumpHashMap() {
+    RETURN_NOT_OK(MergeHashPartitions());
     dump(hash_table_);
     return arrow::Status::OK();
   }
@@ -406,14 +673,34 @@ class HashRelation {
 
   void TESTGrowAndRehashKeyArray() { growAndRehashKeyArray(hash_table_); }
 
+  /* Bytes the hash table takes once moved by MoveHashTable */
+  int64_t GetHashTableBytes() {
+    if (hash_table_ == nullptr) return 0;
+    std::vector<unsafeHashMap*> tables = partition_tables_;
+    if (partition_bits_ == 0) tables = {hash_table_};
+    int64_t bytes = 0;
+    for (auto table : tables) {
+      bytes += sizeof(unsafeHashMap) +
+               (int64_t)table->arrayCapacity * table->bytesInKeyArray +
+               std::max(table->cursor, 8);
+    }
+    return bytes;
+  }
+
   int GetHashTableSize() {
     assert(hash_table_ != nullptr);
-    return hash_table_->numKeys;
+    if (partition_bits_ == 0) return hash_table_->numKeys;
+    int num_keys = 0;
+    for (auto table : partition_tables_) {
+      num_keys += table->numKeys;
+    }
+    return num_keys;
   }
 
  protected:
   bool unsafe_set = false;
-  arrow::compute::FunctionContext* ctx_;
+  // task pool by default, replaced by MoveHashTable when the relation outlives task
+  arrow::MemoryPool* pool_ = arrow::default_memory_pool();
   uint64_t num_arrays_ = 0;
   std::vector<std::shared_ptr<HashRelationColumn>> hash_relation_column_list_;
   unsafeHashMap* hash_table_ = nullptr;
@@ -423,6 +710,55 @@ class HashRelation {
   std::vector<ArrayItemIndex> arrayid_list_;
   int key_size_;
   char recent_cached_key_[8] = {0};
+  // set by SetHashPartitions, hash_table_ then points to the first partition
+  int partition_bits_ = 0;
+  std::vector<unsafeHashMap*> partition_tables_;
+  // keep the relation whose hash table is shared alive
+  std::shared_ptr<HashRelation> shared_owner_;
+  // serialized or imported table, see HashRelationTableHeader
+  std::shared_ptr<arrow::Buffer> serialized_table_;
+  std::shared_ptr<arrow::Buffer> imported_buffer_;
+  std::shared_ptr<arrow::io::MemoryMappedFile> mapped_file_;
+  unsafeHashMap imported_table_;
+
+  static int64_t AlignTableOffset(int64_t offset) {
+    return (offset + kHashRelationTableAlignment - 1) & ~(kHashRelationTableAlignment - 1);
+  }
+
+  unsafeHashMap* LookupTable(int32_t v) {
+    if (partition_bits_ == 0) return hash_table_;
+    return partition_tables_[(uint32_t)v >> (32 - partition_bits_)];
+  }
+
+  void DestroyHashTables() {
+    if (!unsafe_set) {
+      if (partition_bits_ == 0) {
+        if (hash_table_ != nullptr) destroyHashMap(hash_table_);
+      } else {
+        for (auto table : partition_tables_) {
+          destroyHashMap(table);
+        }
+      }
+    }
+    hash_table_ = nullptr;
+    partition_tables_.clear();
+    partition_bits_ = 0;
+  }
+
+  template <typename VisitFunc>
+  static arrow::Status VisitRows(int64_t length, const std::vector<int32_t>* rows,
+                                 VisitFunc&& visit) {
+    if (rows == nullptr) {
+      for (int i = 0; i < length; i++) {
+        RETURN_NOT_OK(visit(i));
+      }
+    } else {
+      for (auto i : *rows) {
+        RETURN_NOT_OK(visit(i));
+      }
+    }
+    return arrow::Status::OK();
+  }
 
   arrow::Status Insert(int32_t v, std::shared_ptr<UnsafeRow> payload, uint32_t array_id,
                        uint32_t id) {
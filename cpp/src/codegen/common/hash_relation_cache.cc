@@ -0,0 +1,177 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "codegen/common/hash_relation_cache.h"
+
+HashRelationCache& HashRelationCache::GetInstance() {
+  static HashRelationCache instance;
+  return instance;
+}
+
+void HashRelationCache::SetMemoryPool(arrow::MemoryPool* pool, int64_t capacity) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  // relations already published keep their pool, the pool is not expected to change
+  pool_ = pool;
+  capacity_ = capacity;
+}
+
+arrow::Status HashRelationCache::Acquire(int64_t relation_id,
+                                         std::shared_ptr<HashRelation>* out,
+                                         bool* need_build) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  while (true) {
+    auto it = entries_.find(relation_id);
+    if (it == entries_.end()) {
+      // elected as builder, the reference is handed over to the published relation
+      auto entry = std::make_shared<Entry>();
+      entry->ref_count = 1;
+      entries_[relation_id] = entry;
+      *need_build = true;
+      return arrow::Status::OK();
+    }
+    auto entry = it->second;
+    if (entry->ready) {
+      entry->ref_count++;
+      entry->last_used = ++use_clock_;
+      *out = entry->relation;
+      *need_build = false;
+      return arrow::Status::OK();
+    }
+    // someone else is building, wait until it is published or aborted
+    build_done_.wait(lock);
+  }
+}
+
+arrow::Status HashRelationCache::Publish(int64_t relation_id,
+                                         std::shared_ptr<HashRelation> relation,
+                                         bool* cached) {
+  auto bytes = relation->GetHashTableBytes();
+  arrow::MemoryPool* pool;
+  bool fits;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = entries_.find(relation_id);
+    if (it == entries_.end() || it->second->ready) {
+      return arrow::Status::Invalid("HashRelationCache Publish relation ", relation_id,
+                                    " is not under building.");
+    }
+    fits = MakeRoom(bytes);
+    if (fits) {
+      // reserve now, so concurrent publishers don't take the same room
+      it->second->bytes = bytes;
+      cached_bytes_ += bytes;
+    }
+    pool = pool_;
+  }
+  // relation outlives the building task, so it must not keep memory of its pool
+  arrow::Status status;
+  if (fits) {
+    status = relation->MoveHashTable(pool);
+    if (status.IsOutOfMemory()) {
+      // JVM refused the memory, drop every relation no task holds and retry once
+      {
+        std::lock_guard<std::mutex> lock(mtx_);
+        MakeRoom(-1);
+      }
+      status = relation->MoveHashTable(pool);
+    }
+    if (!status.ok() && !status.IsOutOfMemory()) return status;
+  }
+
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto it = entries_.find(relation_id);
+  if (!fits || !status.ok()) {
+    // waiters will retry and one of them becomes the new builder
+    EraseEntry(it);
+    build_done_.notify_all();
+    *cached = false;
+    return arrow::Status::OK();
+  }
+  it->second->relation = relation;
+  it->second->ready = true;
+  it->second->last_used = ++use_clock_;
+  build_done_.notify_all();
+  *cached = true;
+  return arrow::Status::OK();
+}
+
+void HashRelationCache::Abort(int64_t relation_id) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto it = entries_.find(relation_id);
+  if (it != entries_.end() && !it->second->ready) {
+    // waiters will retry and one of them becomes the new builder
+    EraseEntry(it);
+    build_done_.notify_all();
+  }
+}
+
+void HashRelationCache::Release(int64_t relation_id) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto it = entries_.find(relation_id);
+  if (it == entries_.end()) return;
+  auto entry = it->second;
+  entry->ref_count--;
+  if (entry->ref_count <= 0 && entry->evicted) {
+    EraseEntry(it);
+  }
+}
+
+void HashRelationCache::Evict(int64_t relation_id) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto it = entries_.find(relation_id);
+  if (it == entries_.end()) return;
+  auto entry = it->second;
+  if (entry->ref_count <= 0) {
+    EraseEntry(it);
+  } else {
+    entry->evicted = true;
+  }
+}
+
+int HashRelationCache::GetRefCount(int64_t relation_id) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto it = entries_.find(relation_id);
+  if (it == entries_.end()) return 0;
+  return it->second->ref_count;
+}
+
+int64_t HashRelationCache::GetCachedBytes() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return cached_bytes_;
+}
+
+void HashRelationCache::EraseEntry(EntryMap::iterator it) {
+  cached_bytes_ -= it->second->bytes;
+  entries_.erase(it);
+}
+
+bool HashRelationCache::MakeRoom(int64_t bytes) {
+  if (bytes >= 0 && capacity_ > 0 && bytes > capacity_) return false;
+  while (bytes < 0 || (capacity_ > 0 && cached_bytes_ + bytes > capacity_)) {
+    auto victim = entries_.end();
+    for (auto it = entries_.begin(); it != entries_.end(); it++) {
+      auto& entry = it->second;
+      if (!entry->ready || entry->ref_count > 0) continue;
+      if (victim == entries_.end() || entry->last_used < victim->second->last_used) {
+        victim = it;
+      }
+    }
+    if (victim == entries_.end()) break;
+    EraseEntry(victim);
+  }
+  return bytes < 0 || capacity_ <= 0 || cached_bytes_ + bytes <= capacity_;
+}
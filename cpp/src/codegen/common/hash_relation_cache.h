@@ -0,0 +1,120 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/status.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "codegen/common/hash_relation.h"
+#include "codegen/common/result_iterator.h"
+
+/** HashRelationCache
+ *
+ * Process-wide cache of broadcast HashRelation, keyed by relation id.
+ * The first task acquiring an id is elected to build the relation, other tasks
+ * block until it is published and then share it read-only.
+ * Each successful Acquire holds one reference which is released by Release; an
+ * evicted relation is freed once the last reference is released.
+ * Published relations are moved to the pool given by SetMemoryPool, which reports to
+ * the JVM, and kept under its capacity: relations no task holds are evicted, least
+ * recently used first, when a new one needs room or the pool is out of memory.
+ **/
+class HashRelationCache {
+ public:
+  static HashRelationCache& GetInstance();
+
+  /* capacity is in bytes, 0 means only limited by pool */
+  void SetMemoryPool(arrow::MemoryPool* pool, int64_t capacity);
+
+  /* If the relation is published, *out is set and *need_build is false.
+   * Otherwise caller is elected as builder, *need_build is true and caller should
+   * call Publish or Abort later. */
+  arrow::Status Acquire(int64_t relation_id, std::shared_ptr<HashRelation>* out,
+                        bool* need_build);
+  /* If no room can be made for relation, *cached is false and the entry is dropped,
+   * relation then stays in the pool of its builder and is only used by it, tasks
+   * waiting for it retry and one of them is elected as builder. */
+  arrow::Status Publish(int64_t relation_id, std::shared_ptr<HashRelation> relation,
+                        bool* cached);
+  void Abort(int64_t relation_id);
+  void Release(int64_t relation_id);
+  void Evict(int64_t relation_id);
+  int GetRefCount(int64_t relation_id);
+  int64_t GetCachedBytes();
+
+ private:
+  HashRelationCache() {}
+
+  struct Entry {
+    bool ready = false;
+    bool evicted = false;
+    int ref_count = 0;
+    // reserved by Publish before the relation is moved
+    int64_t bytes = 0;
+    uint64_t last_used = 0;
+    std::shared_ptr<HashRelation> relation;
+  };
+  using EntryMap = std::unordered_map<int64_t, std::shared_ptr<Entry>>;
+
+  void EraseEntry(EntryMap::iterator it);
+  /* Evicts relations no task holds until bytes more fit in capacity_, or all of them
+   * if bytes is negative. Returns whether bytes fit. */
+  bool MakeRoom(int64_t bytes);
+
+  std::mutex mtx_;
+  std::condition_variable build_done_;
+  EntryMap entries_;
+  arrow::MemoryPool* pool_ = arrow::default_memory_pool();
+  int64_t capacity_ = 0;
+  int64_t cached_bytes_ = 0;
+  uint64_t use_clock_ = 0;
+};
+
+/* ResultIterator holding one reference of a cached relation, each Next returns a
+ * shallow copy with its own lookup state so concurrent tasks never share mutable
+ * state. Reference is released on destruction. A relation Publish didn't cache holds
+ * no reference, its iterator is made with cached false. */
+class CachedHashRelationResultIterator : public ResultIterator<HashRelation> {
+ public:
+  CachedHashRelationResultIterator(int64_t relation_id,
+                                   std::shared_ptr<HashRelation> relation,
+                                   bool cached = true)
+      : relation_id_(relation_id), relation_(relation), cached_(cached) {}
+  ~CachedHashRelationResultIterator() {
+    if (cached_) HashRelationCache::GetInstance().Release(relation_id_);
+  }
+
+  arrow::Status Next(std::shared_ptr<HashRelation>* out) override {
+    auto relation_copy =
+        std::make_shared<HashRelation>(std::vector<std::shared_ptr<HashRelationColumn>>());
+    RETURN_NOT_OK(relation_copy->ShareHashTable(relation_));
+    *out = relation_copy;
+    return arrow::Status::OK();
+  }
+
+  std::string ToString() override { return "CachedHashRelationResultIterator"; }
+
+ private:
+  int64_t relation_id_;
+  std::shared_ptr<HashRelation> relation_;
+  bool cached_;
+};
@@ -0,0 +1,99 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/memory_pool.h>
+#include <arrow/status.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/** OperatorMemoryPool
+ *
+ * Child pool of one operator: allocations go to the parent pool and are also counted
+ * here, so bytes_allocated() and max_memory() are the current and peak bytes of the
+ * operator alone.
+ * Buffers may outlive the operator, e.g. output batches still held by the JVM, and
+ * free themselves through this pool. So the pool is reference counted: every handle
+ * from Make or Share and every live allocation holds one reference, and the pool is
+ * deleted when the last one is gone. Only handle holders allocate, so no allocation
+ * can come after that.
+ * The parent is the pool of the task and is not owned. Buffers must not outlive the
+ * task, memory kept longer has to be moved to a pool outliving the task first, as
+ * HashRelationCache::Publish does.
+ **/
+class OperatorMemoryPool : public arrow::MemoryPool {
+ public:
+  static std::shared_ptr<OperatorMemoryPool> Make(arrow::MemoryPool* parent) {
+    return (new OperatorMemoryPool(parent))->Share();
+  }
+
+  /* Another handle, e.g. for a result iterator which may outlive the operator */
+  std::shared_ptr<OperatorMemoryPool> Share() {
+    references_.fetch_add(1);
+    return std::shared_ptr<OperatorMemoryPool>(
+        this, [](OperatorMemoryPool* pool) { pool->Unref(); });
+  }
+
+  arrow::Status Allocate(int64_t size, uint8_t** out) override {
+    RETURN_NOT_OK(parent_->Allocate(size, out));
+    references_.fetch_add(1);
+    UpdateAllocatedBytes(size);
+    return arrow::Status::OK();
+  }
+
+  arrow::Status Reallocate(int64_t old_size, int64_t new_size, uint8_t** ptr) override {
+    RETURN_NOT_OK(parent_->Reallocate(old_size, new_size, ptr));
+    UpdateAllocatedBytes(new_size - old_size);
+    return arrow::Status::OK();
+  }
+
+  void Free(uint8_t* buffer, int64_t size) override {
+    parent_->Free(buffer, size);
+    UpdateAllocatedBytes(-size);
+    Unref();
+  }
+
+  int64_t bytes_allocated() const override { return bytes_allocated_.load(); }
+
+  int64_t max_memory() const override { return max_memory_.load(); }
+
+  std::string backend_name() const override { return parent_->backend_name(); }
+
+ private:
+  explicit OperatorMemoryPool(arrow::MemoryPool* parent) : parent_(parent) {}
+
+  void UpdateAllocatedBytes(int64_t diff) {
+    int64_t allocated = bytes_allocated_.fetch_add(diff) + diff;
+    int64_t max_memory = max_memory_.load();
+    while (allocated > max_memory &&
+           !max_memory_.compare_exchange_weak(max_memory, allocated)) {
+    }
+  }
+
+  void Unref() {
+    if (references_.fetch_sub(1) == 1) delete this;
+  }
+
+  arrow::MemoryPool* parent_;
+  std::atomic<int64_t> references_{0};
+  std::atomic<int64_t> bytes_allocated_{0};
+  std::atomic<int64_t> max_memory_{0};
+};
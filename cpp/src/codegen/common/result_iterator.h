@@ -24,6 +24,9 @@ struct Metrics {
   int num_metrics;
   long* process_time;
   long* output_length;
+  // bytes held by the memory pool of the operator, now and at its peak
+  long current_memory = 0;
+  long peak_memory = 0;
   Metrics(int size) : num_metrics(size) {
     process_time = new long[num_metrics];
     output_length = new long[num_metrics];
@@ -37,6 +40,9 @@ struct Metrics {
 class ResultIteratorBase {
  public:
   virtual bool HasNext() { return false; }
+  /* Whether output is ready before all input is processed, e.g. groups a partial
+   * aggregate flushed to free its state. Next() returns it before any other output. */
+  virtual bool HasFlushedOutput() { return false; }
   virtual arrow::Status GetMetrics(std::shared_ptr<Metrics>* out) {
     return arrow::Status::NotImplemented("ResultIterator abstract GetMetrics");
   }
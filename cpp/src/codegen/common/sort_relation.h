@@ -24,6 +24,7 @@
 
 #include "codegen/arrow_compute/ext/array_item_index.h"
 #include "codegen/common/relation_column.h"
+#include "codegen/common/result_iterator.h"
 #include "precompile/type_traits.h"
 
 using sparkcolumnarplugin::codegen::arrowcompute::extra::ArrayItemIndexS;
@@ -60,6 +61,20 @@ class SortRelation {
     std::shared_ptr<arrow::FixedSizeBinaryType> out_type;
   }
 
+  /* Relation over rows already in order, indices_buf holds items_total
+   * ArrayItemIndexS in that order. Columns are only read through indices_buf, so
+   * payload columns are never reordered and each row is read only if asked for. */
+  SortRelation(
+      arrow::compute::FunctionContext* ctx, uint64_t items_total,
+      std::shared_ptr<arrow::Buffer> indices_buf,
+      const std::vector<std::shared_ptr<RelationColumn>>& sort_relation_key_list,
+      const std::vector<std::shared_ptr<RelationColumn>>& sort_relation_payload_list)
+      : ctx_(ctx), indices_buf_(indices_buf), items_total_(items_total) {
+    sort_relation_key_list_ = sort_relation_key_list;
+    sort_relation_payload_list_ = sort_relation_payload_list;
+    indices_begin_ = reinterpret_cast<ArrayItemIndexS*>(indices_buf_->mutable_data());
+  }
+
   ~SortRelation() {}
 
   ArrayItemIndexS GetItemIndexWithShift(int shift) {
@@ -124,4 +139,18 @@ class SortRelation {
   int range_cache_ = -1;
   std::vector<std::shared_ptr<RelationColumn>> sort_relation_key_list_;
   std::vector<std::shared_ptr<RelationColumn>> sort_relation_payload_list_;
-};
\ No newline at end of file
+};
+
+/* ResultIterator handing out one SortRelation, shared by the kernels which build it */
+class SortRelationResultIterator : public ResultIterator<SortRelation> {
+ public:
+  SortRelationResultIterator(std::shared_ptr<SortRelation> sort_relation)
+      : sort_relation_(sort_relation) {}
+  arrow::Status Next(std::shared_ptr<SortRelation>* out) override {
+    *out = sort_relation_;
+    return arrow::Status::OK();
+  }
+
+ private:
+  std::shared_ptr<SortRelation> sort_relation_;
+};
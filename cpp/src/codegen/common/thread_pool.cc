@@ -0,0 +1,129 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "codegen/common/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace {
+std::mutex hooks_mtx;
+std::function<void()> thread_start_hook;
+std::function<void()> thread_exit_hook;
+}  // namespace
+
+struct ThreadPool::Job {
+  int num_tasks;
+  std::function<void(int)> task;
+  std::atomic<int> next{0};
+  std::mutex mtx;
+  std::condition_variable done_cv;
+  int num_done = 0;
+};
+
+ThreadPool::ThreadPool(int num_threads) {
+  for (int i = 0; i < num_threads; i++) {
+    workers_.emplace_back([this] { WorkerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stopped_ = true;
+  }
+  work_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::SetThreadHooks(std::function<void()> on_start,
+                                std::function<void()> on_exit) {
+  std::lock_guard<std::mutex> lock(hooks_mtx);
+  thread_start_hook = on_start;
+  thread_exit_hook = on_exit;
+}
+
+ThreadPool* ThreadPool::Default() {
+  // never destroyed, workers may still be attached to the JVM at process exit
+  static ThreadPool* pool =
+      new ThreadPool(std::max(1, (int)std::thread::hardware_concurrency()) - 1);
+  return pool;
+}
+
+void ThreadPool::ParallelFor(int num_tasks, const std::function<void(int)>& task) {
+  if (num_tasks <= 0) return;
+  auto job = std::make_shared<Job>();
+  job->num_tasks = num_tasks;
+  job->task = task;
+  bool queued = num_tasks > 1 && !workers_.empty();
+  if (queued) {
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      jobs_.push_back(job);
+    }
+    work_cv_.notify_all();
+  }
+  RunJob(job);
+  {
+    std::unique_lock<std::mutex> lock(job->mtx);
+    job->done_cv.wait(lock, [&job] { return job->num_done == job->num_tasks; });
+  }
+  if (queued) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = std::find(jobs_.begin(), jobs_.end(), job);
+    if (it != jobs_.end()) jobs_.erase(it);
+  }
+}
+
+void ThreadPool::RunJob(const std::shared_ptr<Job>& job) {
+  int i;
+  while ((i = job->next.fetch_add(1)) < job->num_tasks) {
+    job->task(i);
+    std::lock_guard<std::mutex> lock(job->mtx);
+    if (++job->num_done == job->num_tasks) {
+      job->done_cv.notify_all();
+    }
+  }
+}
+
+void ThreadPool::WorkerLoop() {
+  std::function<void()> on_start, on_exit;
+  {
+    std::lock_guard<std::mutex> lock(hooks_mtx);
+    on_start = thread_start_hook;
+    on_exit = thread_exit_hook;
+  }
+  if (on_start) on_start();
+  while (true) {
+    std::shared_ptr<Job> job;
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      work_cv_.wait(lock, [this] { return stopped_ || !jobs_.empty(); });
+      if (stopped_) break;
+      job = jobs_.front();
+      if (job->next.load() >= job->num_tasks) {
+        // all tasks are taken, the caller removes it once they are done
+        jobs_.pop_front();
+        continue;
+      }
+    }
+    RunJob(job);
+  }
+  if (on_exit) on_exit();
+}
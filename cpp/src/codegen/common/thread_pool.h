@@ -0,0 +1,67 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** ThreadPool
+ *
+ * Fixed set of persistent workers for operators splitting one task across threads.
+ * Workers run the hooks registered by SetThreadHooks when they start and before
+ * they exit, JNI uses them to attach workers to the JVM so memory pools reporting
+ * to the JVM can be used from any worker.
+ **/
+class ThreadPool {
+ public:
+  explicit ThreadPool(int num_threads);
+  ~ThreadPool();
+
+  /* Runs task(0) ... task(num_tasks - 1) and returns when all of them are done.
+   * Calling thread takes tasks as well, so a pool of n workers runs n + 1 tasks
+   * at a time. Several threads may call ParallelFor concurrently, jobs are served
+   * in order and every caller keeps working on its own job, so one job never
+   * waits for the workers to be free. */
+  void ParallelFor(int num_tasks, const std::function<void(int)>& task);
+
+  int num_threads() { return workers_.size(); }
+
+  /* Process wide pool with one worker less than hardware threads, shared by
+   * operators instead of creating threads per call. */
+  static ThreadPool* Default();
+
+  static void SetThreadHooks(std::function<void()> on_start,
+                             std::function<void()> on_exit);
+
+ private:
+  struct Job;
+
+  void WorkerLoop();
+  static void RunJob(const std::shared_ptr<Job>& job);
+
+  std::mutex mtx_;
+  std::condition_variable work_cv_;
+  std::deque<std::shared_ptr<Job>> jobs_;
+  bool stopped_ = false;
+  std::vector<std::thread> workers_;
+};
@@ -32,9 +32,12 @@
 #include <memory>
 #include <string>
 
+#include "codegen/arrow_compute/ext/hyperloglog_plusplus.h"
 #include "codegen/code_generator_factory.h"
 #include "codegen/common/hash_relation.h"
+#include "codegen/common/hash_relation_cache.h"
 #include "codegen/common/result_iterator.h"
+#include "codegen/common/thread_pool.h"
 #include "data_source/parquet/adapter.h"
 #include "jni/concurrent_map.h"
 #include "jni/jni_common.h"
@@ -221,7 +224,15 @@ jint JNI_OnLoad(JavaVM* vm, void* reserved) {
   metrics_builder_class =
       CreateGlobalClassReference(env, "Lcom/intel/oap/vectorized/MetricsObject;");
   metrics_builder_constructor =
-      GetMethodID(env, metrics_builder_class, "<init>", "([J[J)V");
+      GetMethodID(env, metrics_builder_class, "<init>", "([J[JJJ)V");
+
+  // native workers allocate from memory pools reporting to the JVM
+  ThreadPool::SetThreadHooks(
+      [vm] {
+        JNIEnv* worker_env;
+        vm->AttachCurrentThreadAsDaemon(reinterpret_cast<void**>(&worker_env), nullptr);
+      },
+      [vm] { vm->DetachCurrentThread(); });
 
   return JNI_VERSION;
 }
@@ -270,6 +281,83 @@ Java_com_intel_oap_vectorized_ExpressionEvaluatorJniWrapper_nativeSetMetricsTime
   setenv("NATIVESQL_METRICS_TIME", (is_enable ? "true" : "false"), 1);
 }
 
+JNIEXPORT void JNICALL
+Java_com_intel_oap_vectorized_ExpressionEvaluatorJniWrapper_nativeSetBatchAccumulate(
+    JNIEnv* env, jobject obj, jboolean is_enable) {
+  setenv("NATIVESQL_AGGR_BATCH_ACCUMULATE", (is_enable ? "true" : "false"), 1);
+}
+
+JNIEXPORT void JNICALL
+Java_com_intel_oap_vectorized_ExpressionEvaluatorJniWrapper_nativeSetAdaptiveAggregate(
+    JNIEnv* env, jobject obj, jboolean is_enable, jlong min_rows, jdouble ratio,
+    jlong memory_budget) {
+  setenv("NATIVESQL_AGGR_ADAPTIVE", (is_enable ? "true" : "false"), 1);
+  setenv("NATIVESQL_AGGR_ADAPTIVE_MIN_ROWS", std::to_string(min_rows).c_str(), 1);
+  setenv("NATIVESQL_AGGR_ADAPTIVE_RATIO", std::to_string(ratio).c_str(), 1);
+  setenv("NATIVESQL_AGGR_MEMORY_BUDGET", std::to_string(memory_budget).c_str(), 1);
+}
+
+JNIEXPORT void JNICALL
+Java_com_intel_oap_vectorized_ExpressionEvaluatorJniWrapper_nativeSetAggregateThreads(
+    JNIEnv* env, jobject obj, jint num_threads) {
+  setenv("NATIVESQL_AGGR_THREADS", std::to_string(num_threads).c_str(), 1);
+}
+
+JNIEXPORT void JNICALL
+Java_com_intel_oap_vectorized_ExpressionEvaluatorJniWrapper_nativeSetDistinctAggregateMemoryBudget(
+    JNIEnv* env, jobject obj, jlong memory_budget) {
+  setenv("NATIVESQL_AGGR_DISTINCT_MEMORY_BUDGET", std::to_string(memory_budget).c_str(),
+         1);
+}
+
+JNIEXPORT void JNICALL
+Java_com_intel_oap_vectorized_ExpressionEvaluatorJniWrapper_nativeSetKahanSum(
+    JNIEnv* env, jobject obj, jboolean is_enable) {
+  setenv("NATIVESQL_AGGR_KAHAN_SUM", (is_enable ? "true" : "false"), 1);
+}
+
+JNIEXPORT void JNICALL
+Java_com_intel_oap_vectorized_ExpressionEvaluatorJniWrapper_nativeSetSortNormalizedKey(
+    JNIEnv* env, jobject obj, jboolean is_enable) {
+  setenv("NATIVESQL_SORT_NORMALIZED_KEY", (is_enable ? "true" : "false"), 1);
+}
+
+JNIEXPORT void JNICALL
+Java_com_intel_oap_vectorized_ExpressionEvaluatorJniWrapper_nativeSetSortThreads(
+    JNIEnv* env, jobject obj, jint num_threads) {
+  setenv("NATIVESQL_SORT_THREADS", std::to_string(num_threads).c_str(), 1);
+}
+
+JNIEXPORT void JNICALL
+Java_com_intel_oap_vectorized_ExpressionEvaluatorJniWrapper_nativeSetHllBiasData(
+    JNIEnv* env, jobject obj, jobjectArray raw_estimate_data, jobjectArray bias_data) {
+  using sparkcolumnarplugin::codegen::arrowcompute::extra::HllBiasTable;
+  using sparkcolumnarplugin::codegen::arrowcompute::extra::SetHllBiasTables;
+  auto read_doubles = [env](jobjectArray arrays, int i, std::vector<double>* out) {
+    auto array = static_cast<jdoubleArray>(env->GetObjectArrayElement(arrays, i));
+    out->resize(env->GetArrayLength(array));
+    env->GetDoubleArrayRegion(array, 0, out->size(), out->data());
+    env->DeleteLocalRef(array);
+  };
+  int num_tables = env->GetArrayLength(raw_estimate_data);
+  if (env->GetArrayLength(bias_data) != num_tables) {
+    env->ThrowNew(illegal_argument_exception_class,
+                  "nativeSetHllBiasData: raw estimates and biases differ in precisions");
+    return;
+  }
+  std::vector<HllBiasTable> tables(num_tables);
+  for (int i = 0; i < num_tables; i++) {
+    read_doubles(raw_estimate_data, i, &tables[i].raw_estimates);
+    read_doubles(bias_data, i, &tables[i].biases);
+  }
+  auto status = SetHllBiasTables(std::move(tables));
+  if (!status.ok()) {
+    std::string error_message =
+        "nativeSetHllBiasData: failed with error msg " + status.ToString();
+    env->ThrowNew(illegal_argument_exception_class, error_message.c_str());
+  }
+}
+
 JNIEXPORT jlong JNICALL
 Java_com_intel_oap_vectorized_ExpressionEvaluatorJniWrapper_nativeBuild(
     JNIEnv* env, jobject obj, jlong memory_pool_id, jbyteArray schema_arr,
@@ -450,6 +538,25 @@ Java_com_intel_oap_vectorized_ExpressionEvaluatorJniWrapper_nativeSpill(
   return spilled_size;
 }
 
+JNIEXPORT jlongArray JNICALL
+Java_com_intel_oap_vectorized_ExpressionEvaluatorJniWrapper_nativeGetMemoryUsage(
+    JNIEnv* env, jobject obj, jlong id) {
+  std::shared_ptr<CodeGenerator> handler = GetCodeGenerator(env, id);
+  int64_t bytes_allocated;
+  int64_t peak_bytes;
+  arrow::Status status = handler->GetMemoryUsage(&bytes_allocated, &peak_bytes);
+  if (!status.ok()) {
+    std::string error_message =
+        "nativeGetMemoryUsage: failed with error msg " + status.ToString();
+    env->ThrowNew(io_exception_class, error_message.c_str());
+    return nullptr;
+  }
+  jlong usage[2] = {bytes_allocated, peak_bytes};
+  auto usage_array = env->NewLongArray(2);
+  env->SetLongArrayRegion(usage_array, 0, 2, usage);
+  return usage_array;
+}
+
 JNIEXPORT jobject JNICALL
 Java_com_intel_oap_vectorized_ExpressionEvaluatorJniWrapper_nativeEvaluate(
     JNIEnv* env, jobject obj, jlong id, jint num_rows, jlongArray buf_addrs,
@@ -663,6 +770,13 @@ JNIEXPORT jboolean JNICALL Java_com_intel_oap_vectorized_BatchIterator_nativeHas
   return iter->HasNext();
 }
 
+JNIEXPORT jboolean JNICALL
+Java_com_intel_oap_vectorized_BatchIterator_nativeHasFlushedOutput(
+    JNIEnv* env, jobject obj, jlong id) {
+  auto iter = GetBatchIterator(env, id);
+  return iter->HasFlushedOutput();
+}
+
 JNIEXPORT jobject JNICALL Java_com_intel_oap_vectorized_BatchIterator_nativeFetchMetrics(
     JNIEnv* env, jobject obj, jlong id) {
   auto iter = GetBatchIterator(env, id);
@@ -675,7 +789,9 @@ JNIEXPORT jobject JNICALL Java_com_intel_oap_vectorized_BatchIterator_nativeFetc
   env->SetLongArrayRegion(process_time_list, 0, metrics->num_metrics,
                           metrics->process_time);
   return env->NewObject(metrics_builder_class, metrics_builder_constructor,
-                        output_length_list, process_time_list);
+                        output_length_list, process_time_list,
+                        static_cast<jlong>(metrics->current_memory),
+                        static_cast<jlong>(metrics->peak_memory));
 }
 
 JNIEXPORT jobject JNICALL Java_com_intel_oap_vectorized_BatchIterator_nativeNext(
@@ -708,19 +824,21 @@ Java_com_intel_oap_vectorized_BatchIterator_nativeNextHashRelation(JNIEnv* env,
     env->ThrowNew(io_exception_class, error_message.c_str());
   }
 
-  int src_sizes[3];
-  long src_addrs[3];
-  status = out->UnsafeGetHashTableObject(src_addrs, src_sizes);
-  if (!status.ok()) {
+  // ship the table as one position independent buffer, executors probe it in place
+  std::shared_ptr<arrow::Buffer> serialized_table;
+  status = out->SerializeHashTable(&serialized_table);
+  if (!status.ok() || serialized_table->size() > INT32_MAX) {
     auto memory_addrs = env->NewLongArray(0);
     auto sizes = env->NewIntArray(0);
     return env->NewObject(serializable_obj_builder_class,
                           serializable_obj_builder_constructor, memory_addrs, sizes);
   }
-  auto memory_addrs = env->NewLongArray(3);
-  auto sizes = env->NewIntArray(3);
-  env->SetLongArrayRegion(memory_addrs, 0, 3, src_addrs);
-  env->SetIntArrayRegion(sizes, 0, 3, src_sizes);
+  jlong src_addrs[1] = {(jlong)serialized_table->data()};
+  jint src_sizes[1] = {(jint)serialized_table->size()};
+  auto memory_addrs = env->NewLongArray(1);
+  auto sizes = env->NewIntArray(1);
+  env->SetLongArrayRegion(memory_addrs, 0, 1, src_addrs);
+  env->SetIntArrayRegion(sizes, 0, 1, src_sizes);
   return env->NewObject(serializable_obj_builder_class,
                         serializable_obj_builder_constructor, memory_addrs, sizes);
 }
@@ -740,9 +858,74 @@ JNIEXPORT void JNICALL Java_com_intel_oap_vectorized_BatchIterator_nativeSetHash
   int in_len = env->GetArrayLength(memory_addrs);
   jlong* in_addrs = env->GetLongArrayElements(memory_addrs, 0);
   jint* in_sizes = env->GetIntArrayElements(sizes, 0);
-  out->UnsafeSetHashTableObject(in_len, in_addrs, in_sizes);
+  status = out->UnsafeSetHashTableObject(in_len, in_addrs, in_sizes);
   env->ReleaseLongArrayElements(memory_addrs, in_addrs, JNI_ABORT);
   env->ReleaseIntArrayElements(sizes, in_sizes, JNI_ABORT);
+  if (!status.ok()) {
+    std::string error_message =
+        "nativeSetHashRelation: set hash table failed with error msg " +
+        status.ToString();
+    env->ThrowNew(io_exception_class, error_message.c_str());
+  }
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_intel_oap_vectorized_BatchIterator_nativeAcquireCachedHashRelation(
+    JNIEnv* env, jclass this_cls, jlong relation_id) {
+  std::shared_ptr<HashRelation> relation;
+  bool need_build;
+  auto status =
+      HashRelationCache::GetInstance().Acquire(relation_id, &relation, &need_build);
+  if (!status.ok()) {
+    std::string error_message =
+        "nativeAcquireCachedHashRelation: failed with error msg " + status.ToString();
+    env->ThrowNew(io_exception_class, error_message.c_str());
+  }
+  if (need_build) return -1;
+  std::shared_ptr<ResultIteratorBase> iter =
+      std::make_shared<CachedHashRelationResultIterator>(relation_id, relation);
+  return batch_iterator_holder_.Insert(std::move(iter));
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_intel_oap_vectorized_BatchIterator_nativePublishCachedHashRelation(
+    JNIEnv* env, jobject obj, jlong id, jlong relation_id) {
+  auto iter = GetBatchIterator<HashRelation>(env, id);
+  std::shared_ptr<HashRelation> relation;
+  bool cached = false;
+  auto status = iter->Next(&relation);
+  if (status.ok()) {
+    status = HashRelationCache::GetInstance().Publish(relation_id, relation, &cached);
+  }
+  if (!status.ok()) {
+    HashRelationCache::GetInstance().Abort(relation_id);
+    std::string error_message =
+        "nativePublishCachedHashRelation: failed with error msg " + status.ToString();
+    env->ThrowNew(io_exception_class, error_message.c_str());
+    return -1;
+  }
+  std::shared_ptr<ResultIteratorBase> cached_iter =
+      std::make_shared<CachedHashRelationResultIterator>(relation_id, relation, cached);
+  return batch_iterator_holder_.Insert(std::move(cached_iter));
+}
+
+JNIEXPORT void JNICALL
+Java_com_intel_oap_vectorized_BatchIterator_nativeSetCachedHashRelationPool(
+    JNIEnv* env, jclass this_cls, jlong memory_pool_id, jlong capacity) {
+  auto pool = reinterpret_cast<arrow::MemoryPool*>(memory_pool_id);
+  HashRelationCache::GetInstance().SetMemoryPool(pool, capacity);
+}
+
+JNIEXPORT void JNICALL
+Java_com_intel_oap_vectorized_BatchIterator_nativeAbortCachedHashRelation(
+    JNIEnv* env, jclass this_cls, jlong relation_id) {
+  HashRelationCache::GetInstance().Abort(relation_id);
+}
+
+JNIEXPORT void JNICALL
+Java_com_intel_oap_vectorized_BatchIterator_nativeEvictCachedHashRelation(
+    JNIEnv* env, jclass this_cls, jlong relation_id) {
+  HashRelationCache::GetInstance().Evict(relation_id);
 }
 
 JNIEXPORT jobject JNICALL Java_com_intel_oap_vectorized_BatchIterator_nativeProcess(
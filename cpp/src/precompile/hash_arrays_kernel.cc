@@ -1,12 +1,301 @@
 #include "precompile/hash_arrays_kernel.h"
 
+#include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <arrow/type_traits.h>
 #include <gandiva/node.h>
 #include <gandiva/projector.h>
 #include <gandiva/tree_expr_builder.h>
+#include <string.h>
+
+#if defined(COLUMNAR_PLUGIN_USE_AVX512) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 namespace sparkcolumnarplugin {
 namespace precompile {
 
+namespace {
+
+constexpr uint32_t kMurmur3C1 = 0xcc9e2d51;
+constexpr uint32_t kMurmur3C2 = 0x1b873593;
+
+inline uint32_t RotateLeft32(uint32_t v, int r) { return (v << r) | (v >> (32 - r)); }
+
+inline uint32_t Murmur3MixK1(uint32_t k1) {
+  k1 *= kMurmur3C1;
+  k1 = RotateLeft32(k1, 15);
+  return k1 * kMurmur3C2;
+}
+
+inline uint32_t Murmur3MixH1(uint32_t h1, uint32_t k1) {
+  h1 ^= k1;
+  h1 = RotateLeft32(h1, 13);
+  return h1 * 5 + 0xe6546b64;
+}
+
+inline uint32_t Murmur3Fmix(uint32_t h1, uint32_t len) {
+  h1 ^= len;
+  h1 ^= h1 >> 16;
+  h1 *= 0x85ebca6b;
+  h1 ^= h1 >> 13;
+  h1 *= 0xc2b2ae35;
+  h1 ^= h1 >> 16;
+  return h1;
+}
+
+inline int32_t Murmur3Long(int64_t v, int32_t seed) {
+  uint32_t h1 = (uint32_t)seed;
+  h1 = Murmur3MixH1(h1, Murmur3MixK1((uint32_t)v));
+  h1 = Murmur3MixH1(h1, Murmur3MixK1((uint32_t)((uint64_t)v >> 32)));
+  return (int32_t)Murmur3Fmix(h1, 8);
+}
+
+/* Keeps the int64 arithmetic of murmurhash32::hash32(std::string) so results are
+ * bit identical with it, including how a negative seed is widened. */
+inline int32_t Murmur3Bytes(const uint8_t* key, int32_t len, int32_t seed) {
+  const int64_t c1 = 0xcc9e2d51ull;
+  const int64_t c2 = 0x1b873593ull;
+  const int64_t UINT_MASK = 0xffffffffull;
+  int64_t lh1 = seed;
+  int nblocks = len / 4;
+  const uint8_t* tail = key + nblocks * 4;
+  for (int i = 0; i < nblocks; i++) {
+    int32_t block;
+    memcpy(&block, key + i * 4, sizeof(int32_t));
+    int64_t lk1 = static_cast<int64_t>(block);
+    lk1 *= c1;
+    lk1 &= UINT_MASK;
+    lk1 = ((lk1 << 15) & UINT_MASK) | (lk1 >> 17);
+    lk1 *= c2;
+    lk1 = lk1 & UINT_MASK;
+    lh1 ^= lk1;
+    lh1 = ((lh1 << 13) & UINT_MASK) | (lh1 >> 19);
+    lh1 = lh1 * 5 + 0xe6546b64ull;
+    lh1 = UINT_MASK & lh1;
+  }
+  int64_t lk1 = 0;
+  switch (len & 3) {
+    case 3:
+      lk1 = (tail[2] & 0xff) << 16;
+    case 2:
+      lk1 |= (tail[1] & 0xff) << 8;
+    case 1:
+      lk1 |= (tail[0] & 0xff);
+      lk1 *= c1;
+      lk1 = UINT_MASK & lk1;
+      lk1 = ((lk1 << 15) & UINT_MASK) | (lk1 >> 17);
+      lk1 *= c2;
+      lk1 = lk1 & UINT_MASK;
+      lh1 ^= lk1;
+  }
+  lh1 ^= len;
+  lh1 ^= lh1 >> 16;
+  lh1 *= 0x85ebca6b;
+  lh1 = UINT_MASK & lh1;
+  lh1 ^= lh1 >> 13;
+  lh1 *= 0xc2b2ae35;
+  lh1 = UINT_MASK & lh1;
+  lh1 ^= lh1 >> 16;
+  return static_cast<int32_t>(lh1 & UINT_MASK);
+}
+
+#if defined(COLUMNAR_PLUGIN_USE_AVX512)
+template <int R>
+inline __m512i RotateLeft32x16(__m512i v) {
+  return _mm512_or_si512(_mm512_slli_epi32(v, R), _mm512_srli_epi32(v, 32 - R));
+}
+
+inline __m512i Murmur3MixH1x16(__m512i h1, __m512i k1) {
+  k1 = _mm512_mullo_epi32(k1, _mm512_set1_epi32(kMurmur3C1));
+  k1 = RotateLeft32x16<15>(k1);
+  k1 = _mm512_mullo_epi32(k1, _mm512_set1_epi32(kMurmur3C2));
+  h1 = _mm512_xor_si512(h1, k1);
+  h1 = RotateLeft32x16<13>(h1);
+  return _mm512_add_epi32(_mm512_mullo_epi32(h1, _mm512_set1_epi32(5)),
+                          _mm512_set1_epi32(0xe6546b64));
+}
+
+inline __m512i Murmur3Fmixx16(__m512i h1) {
+  h1 = _mm512_xor_si512(h1, _mm512_set1_epi32(8));
+  h1 = _mm512_xor_si512(h1, _mm512_srli_epi32(h1, 16));
+  h1 = _mm512_mullo_epi32(h1, _mm512_set1_epi32(0x85ebca6b));
+  h1 = _mm512_xor_si512(h1, _mm512_srli_epi32(h1, 13));
+  h1 = _mm512_mullo_epi32(h1, _mm512_set1_epi32(0xc2b2ae35));
+  return _mm512_xor_si512(h1, _mm512_srli_epi32(h1, 16));
+}
+#elif defined(__AVX2__)
+template <int R>
+inline __m256i RotateLeft32x8(__m256i v) {
+  return _mm256_or_si256(_mm256_slli_epi32(v, R), _mm256_srli_epi32(v, 32 - R));
+}
+
+inline __m256i Murmur3MixH1x8(__m256i h1, __m256i k1) {
+  k1 = _mm256_mullo_epi32(k1, _mm256_set1_epi32(kMurmur3C1));
+  k1 = RotateLeft32x8<15>(k1);
+  k1 = _mm256_mullo_epi32(k1, _mm256_set1_epi32(kMurmur3C2));
+  h1 = _mm256_xor_si256(h1, k1);
+  h1 = RotateLeft32x8<13>(h1);
+  return _mm256_add_epi32(_mm256_mullo_epi32(h1, _mm256_set1_epi32(5)),
+                          _mm256_set1_epi32(0xe6546b64));
+}
+
+inline __m256i Murmur3Fmixx8(__m256i h1) {
+  h1 = _mm256_xor_si256(h1, _mm256_set1_epi32(8));
+  h1 = _mm256_xor_si256(h1, _mm256_srli_epi32(h1, 16));
+  h1 = _mm256_mullo_epi32(h1, _mm256_set1_epi32(0x85ebca6b));
+  h1 = _mm256_xor_si256(h1, _mm256_srli_epi32(h1, 13));
+  h1 = _mm256_mullo_epi32(h1, _mm256_set1_epi32(0xc2b2ae35));
+  return _mm256_xor_si256(h1, _mm256_srli_epi32(h1, 16));
+}
+#endif
+
+/* hashes holds the seeds on input and the hashes of in on output */
+void Murmur3LongBatch(const int64_t* in, int32_t* hashes, int64_t length) {
+  int64_t i = 0;
+#if defined(COLUMNAR_PLUGIN_USE_AVX512)
+  for (; i + 16 <= length; i += 16) {
+    __m512i a = _mm512_loadu_si512(in + i);
+    __m512i b = _mm512_loadu_si512(in + i + 8);
+    __m512i lo = _mm512_inserti64x4(_mm512_castsi256_si512(_mm512_cvtepi64_epi32(a)),
+                                    _mm512_cvtepi64_epi32(b), 1);
+    __m512i hi = _mm512_inserti64x4(
+        _mm512_castsi256_si512(_mm512_cvtepi64_epi32(_mm512_srli_epi64(a, 32))),
+        _mm512_cvtepi64_epi32(_mm512_srli_epi64(b, 32)), 1);
+    __m512i h1 = _mm512_loadu_si512(hashes + i);
+    h1 = Murmur3MixH1x16(h1, lo);
+    h1 = Murmur3MixH1x16(h1, hi);
+    _mm512_storeu_si512(hashes + i, Murmur3Fmixx16(h1));
+  }
+#elif defined(__AVX2__)
+  // gather low and high 32 bits of each 64 bits value into separate lanes
+  const __m256i deinterleave = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+  for (; i + 8 <= length; i += 8) {
+    __m256i a = _mm256_permutevar8x32_epi32(
+        _mm256_loadu_si256((const __m256i*)(in + i)), deinterleave);
+    __m256i b = _mm256_permutevar8x32_epi32(
+        _mm256_loadu_si256((const __m256i*)(in + i + 4)), deinterleave);
+    __m256i lo = _mm256_permute2x128_si256(a, b, 0x20);
+    __m256i hi = _mm256_permute2x128_si256(a, b, 0x31);
+    __m256i h1 = _mm256_loadu_si256((const __m256i*)(hashes + i));
+    h1 = Murmur3MixH1x8(h1, lo);
+    h1 = Murmur3MixH1x8(h1, hi);
+    _mm256_storeu_si256((__m256i*)(hashes + i), Murmur3Fmixx8(h1));
+  }
+#endif
+  for (; i < length; i++) {
+    hashes[i] = Murmur3Long(in[i], hashes[i]);
+  }
+}
+
+/* Numeric keys are hashed as the bits of their double value, same as hash32 */
+template <typename ArrowType>
+void ToDoubleBits(const arrow::Array& in, int64_t* out) {
+  using ArrayType = typename arrow::TypeTraits<ArrowType>::ArrayType;
+  auto values = static_cast<const ArrayType&>(in).raw_values();
+  for (int64_t i = 0; i < in.length(); i++) {
+    double v = static_cast<double>(values[i]);
+    memcpy(out + i, &v, sizeof(double));
+  }
+}
+
+template <>
+void ToDoubleBits<arrow::BooleanType>(const arrow::Array& in, int64_t* out) {
+  auto& typed_in = static_cast<const arrow::BooleanArray&>(in);
+  for (int64_t i = 0; i < in.length(); i++) {
+    double v = typed_in.Value(i) ? 1.0 : 0.0;
+    memcpy(out + i, &v, sizeof(double));
+  }
+}
+
+#define PROCESS_SUPPORTED_TYPES(PROCESS) \
+  PROCESS(arrow::BooleanType)            \
+  PROCESS(arrow::UInt8Type)              \
+  PROCESS(arrow::Int8Type)               \
+  PROCESS(arrow::UInt16Type)             \
+  PROCESS(arrow::Int16Type)              \
+  PROCESS(arrow::UInt32Type)             \
+  PROCESS(arrow::Int32Type)              \
+  PROCESS(arrow::UInt64Type)             \
+  PROCESS(arrow::Int64Type)              \
+  PROCESS(arrow::FloatType)              \
+  PROCESS(arrow::DoubleType)             \
+  PROCESS(arrow::Date32Type)             \
+  PROCESS(arrow::Date64Type)
+
+arrow::Status Murmur3HashArray(const arrow::Array& in, int32_t* hashes,
+                               std::vector<int64_t>* bits_buffer) {
+  auto length = in.length();
+  if (in.type_id() == arrow::Type::STRING) {
+    auto& typed_in = static_cast<const arrow::StringArray&>(in);
+    auto has_null = in.null_count() > 0;
+    for (int64_t i = 0; i < length; i++) {
+      if (has_null && in.IsNull(i)) continue;
+      int32_t len;
+      auto value = typed_in.GetValue(i, &len);
+      hashes[i] = Murmur3Bytes(value, len, hashes[i]);
+    }
+    return arrow::Status::OK();
+  }
+  bits_buffer->resize(length);
+  auto bits = bits_buffer->data();
+  switch (in.type_id()) {
+#define PROCESS(InType)                 \
+  case InType::type_id: {               \
+    ToDoubleBits<InType>(in, bits);     \
+  } break;
+    PROCESS_SUPPORTED_TYPES(PROCESS)
+#undef PROCESS
+    default: {
+      return arrow::Status::NotImplemented("Murmur3HashArrays doesn't support type ",
+                                           in.type()->ToString());
+    }
+  }
+  if (in.null_count() == 0) {
+    Murmur3LongBatch(bits, hashes, length);
+    return arrow::Status::OK();
+  }
+  // null slot keeps its seed
+  std::vector<int32_t> seeds(hashes, hashes + length);
+  Murmur3LongBatch(bits, hashes, length);
+  for (int64_t i = 0; i < length; i++) {
+    if (in.IsNull(i)) hashes[i] = seeds[i];
+  }
+  return arrow::Status::OK();
+}
+
+}  // namespace
+
+bool IsVectorizedHashSupported(const std::shared_ptr<arrow::DataType>& type) {
+  switch (type->id()) {
+#define PROCESS(InType) case InType::type_id:
+    PROCESS_SUPPORTED_TYPES(PROCESS)
+#undef PROCESS
+    case arrow::Type::STRING:
+      return true;
+    default:
+      return false;
+  }
+}
+#undef PROCESS_SUPPORTED_TYPES
+
+arrow::Status Murmur3HashArrays(arrow::MemoryPool* pool,
+                                const std::vector<std::shared_ptr<arrow::Array>>& in,
+                                std::shared_ptr<arrow::Array>* out) {
+  auto length = in.size() > 0 ? in[0]->length() : 0;
+  std::shared_ptr<arrow::Buffer> buf;
+  RETURN_NOT_OK(arrow::AllocateBuffer(pool, length * sizeof(int32_t), &buf));
+  auto hashes = reinterpret_cast<int32_t*>(buf->mutable_data());
+  // first column uses 0 as seed, following ones use hash of previous columns
+  memset(hashes, 0, length * sizeof(int32_t));
+  std::vector<int64_t> bits_buffer;
+  for (auto arr : in) {
+    RETURN_NOT_OK(Murmur3HashArray(*arr, hashes, &bits_buffer));
+  }
+  *out = std::make_shared<arrow::Int32Array>(length, buf);
+  return arrow::Status::OK();
+}
+
 class HashArraysKernel::Impl {
  public:
   Impl(arrow::MemoryPool* pool,
@@ -1,7 +1,19 @@
+#pragma once
+
 #include <arrow/type_fwd.h>
 namespace sparkcolumnarplugin {
 namespace precompile {
 
+/* Hash whole arrays in one call, multi-column keys are combined by using the hash
+ * of previous column as seed of the next one, null slot keeps the seed.
+ * Murmur3HashArrays returns int32 array identical to per-row chained
+ * murmurhash32::hash32 (and Gandiva hash32), so it can replace them on either side
+ * of a join. */
+bool IsVectorizedHashSupported(const std::shared_ptr<arrow::DataType>& type);
+arrow::Status Murmur3HashArrays(arrow::MemoryPool* pool,
+                                const std::vector<std::shared_ptr<arrow::Array>>& in,
+                                std::shared_ptr<arrow::Array>* out);
+
 class HashArraysKernel {
  public:
   HashArraysKernel(arrow::MemoryPool* pool,
@@ -14,4 +26,4 @@ class HashArraysKernel {
   std::shared_ptr<Impl> impl_;
 };
 }  // namespace precompile
-}  // namespace sparkcolumnarplugin
\ No newline at end of file
+}  // namespace sparkcolumnarplugin
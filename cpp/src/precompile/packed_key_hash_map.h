@@ -0,0 +1,292 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/memory_pool.h>
+#include <arrow/status.h>
+#include <arrow/util/string_view.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "codegen/arrow_compute/ext/aggregate_arena.h"
+#include "sparsehash/dense_hash_map"
+
+namespace sparkcolumnarplugin {
+namespace precompile {
+
+/** Packed group keys
+ *
+ * Multi-column group keys whose columns are all fixed width are packed into one
+ * uint64_t or one PackedKey128 by codegen instead of being serialized into an
+ * UnsafeRow. Each key column owns a bit range of the packed key, and the highest
+ * num_keys bits of the last word are null flags. A null column leaves its range as
+ * zero, so a packed key can never be all ones, which is used as the empty key.
+ **/
+struct PackedKey128 {
+  uint64_t lo = 0;
+  uint64_t hi = 0;
+
+  bool operator==(const PackedKey128& other) const {
+    return lo == other.lo && hi == other.hi;
+  }
+};
+
+/* Bits of a fixed width value, zero extended to 64 bits. */
+template <typename T>
+inline uint64_t ToPackedBits(const T& value) {
+  static_assert(sizeof(T) <= 8, "packed key column should be at most 8 bytes");
+  using BitsType = typename std::conditional<
+      sizeof(T) == 1, uint8_t,
+      typename std::conditional<
+          sizeof(T) == 2, uint16_t,
+          typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type>::type>::
+      type;
+  BitsType bits;
+  std::memcpy(&bits, &value, sizeof(T));
+  return bits;
+}
+
+struct PackedKeyHash {
+  // finalizer of murmur3, packed keys are far from uniform in their low bits
+  static inline uint64_t Mix(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+  }
+
+  size_t operator()(const uint64_t& key) const { return Mix(key); }
+
+  size_t operator()(const PackedKey128& key) const {
+    return Mix(key.lo ^ Mix(key.hi + 0x9e3779b97f4a7c15ULL));
+  }
+
+  size_t operator()(const arrow::util::string_view& key) const {
+    uint64_t hash = key.size();
+    size_t i = 0;
+    for (; i + 8 <= key.size(); i += 8) {
+      uint64_t word;
+      std::memcpy(&word, key.data() + i, 8);
+      hash = (hash ^ Mix(word)) * 0x9e3779b97f4a7c15ULL;
+    }
+    if (i < key.size()) {
+      uint64_t word = 0;
+      std::memcpy(&word, key.data() + i, key.size() - i);
+      hash = (hash ^ Mix(word)) * 0x9e3779b97f4a7c15ULL;
+    }
+    return Mix(hash);
+  }
+};
+
+/* STL allocator over a memory pool, so the buckets of a hash map are tracked */
+template <typename T>
+class PoolAllocator {
+ public:
+  typedef T value_type;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+
+  template <typename U>
+  struct rebind {
+    typedef PoolAllocator<U> other;
+  };
+
+  explicit PoolAllocator(arrow::MemoryPool* pool) : pool_(pool) {}
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U>& other) : pool_(other.pool()) {}
+
+  pointer allocate(size_type n, const void* hint = nullptr) {
+    uint8_t* data;
+    if (!pool_->Allocate(n * sizeof(T), &data).ok()) throw std::bad_alloc();
+    return reinterpret_cast<pointer>(data);
+  }
+
+  void deallocate(pointer p, size_type n) {
+    pool_->Free(reinterpret_cast<uint8_t*>(p), n * sizeof(T));
+  }
+
+  size_type max_size() const { return std::numeric_limits<size_type>::max() / sizeof(T); }
+
+  arrow::MemoryPool* pool() const { return pool_; }
+
+  template <typename U>
+  bool operator==(const PoolAllocator<U>& other) const {
+    return pool_ == other.pool();
+  }
+  template <typename U>
+  bool operator!=(const PoolAllocator<U>& other) const {
+    return pool_ != other.pool();
+  }
+
+ private:
+  arrow::MemoryPool* pool_;
+};
+
+template <typename KeyType>
+class PackedKeyHashMap {
+ public:
+  PackedKeyHashMap(arrow::MemoryPool* pool)
+      : dense_map_(0, PackedKeyHash(), std::equal_to<KeyType>(), Allocator(pool)) {
+    dense_map_.set_empty_key(EmptyKey());
+  }
+
+  template <typename Func1, typename Func2>
+  arrow::Status GetOrInsert(const KeyType& value, Func1&& on_found, Func2&& on_not_found,
+                            int32_t* out_memo_index) {
+    auto ret = dense_map_.insert(std::make_pair(value, size_));
+    if (ret.second) {
+      *out_memo_index = size_++;
+      on_not_found(*out_memo_index);
+    } else {
+      *out_memo_index = ret.first->second;
+      on_found(*out_memo_index);
+    }
+    return arrow::Status::OK();
+  }
+
+  template <typename Func1, typename Func2>
+  int32_t GetOrInsertNull(Func1&& on_found, Func2&& on_not_found) {
+    if (!null_index_set_) {
+      null_index_set_ = true;
+      null_index_ = size_++;
+      on_not_found(null_index_);
+    } else {
+      on_found(null_index_);
+    }
+    return null_index_;
+  }
+
+  int32_t Get(const KeyType& value) {
+    auto it = dense_map_.find(value);
+    if (it == dense_map_.end()) return -1;
+    return it->second;
+  }
+
+  int32_t GetNull() { return null_index_set_ ? null_index_ : -1; }
+
+ private:
+  using Allocator = PoolAllocator<std::pair<const KeyType, int32_t>>;
+
+  static KeyType EmptyKey();
+
+  google::dense_hash_map<KeyType, int32_t, PackedKeyHash, std::equal_to<KeyType>,
+                         Allocator>
+      dense_map_;
+  int32_t size_ = 0;
+  bool null_index_set_ = false;
+  int32_t null_index_;
+};
+
+template <>
+inline uint64_t PackedKeyHashMap<uint64_t>::EmptyKey() {
+  return std::numeric_limits<uint64_t>::max();
+}
+
+template <>
+inline PackedKey128 PackedKeyHashMap<PackedKey128>::EmptyKey() {
+  PackedKey128 key;
+  key.lo = std::numeric_limits<uint64_t>::max();
+  key.hi = std::numeric_limits<uint64_t>::max();
+  return key;
+}
+
+/** Normalized group keys
+ *
+ * Multi-column group keys with a variable width column are serialized into an
+ * UnsafeRow, whose bytes are the normalized key. The map looks keys up by a
+ * string_view over the reused row buffer and copies a key into an arena only when a
+ * new group is inserted, so keys live in a few large chunks of the memory pool rather
+ * than in one allocation each. An UnsafeRow holds at least its null bitset, so the
+ * empty string is free to be the empty key.
+ **/
+class NormalizedKeyHashMap {
+ public:
+  NormalizedKeyHashMap(arrow::MemoryPool* pool)
+      : arena_(pool),
+        dense_map_(0, PackedKeyHash(), std::equal_to<arrow::util::string_view>(),
+                   Allocator(pool)) {
+    dense_map_.set_empty_key(arrow::util::string_view());
+  }
+
+  template <typename Func1, typename Func2>
+  arrow::Status GetOrInsert(const arrow::util::string_view& value, Func1&& on_found,
+                            Func2&& on_not_found, int32_t* out_memo_index) {
+    auto it = dense_map_.find(value);
+    if (it != dense_map_.end()) {
+      *out_memo_index = it->second;
+      on_found(*out_memo_index);
+      return arrow::Status::OK();
+    }
+    arrow::util::string_view key;
+    RETURN_NOT_OK(arena_.CopyString(value, &key));
+    dense_map_.insert(std::make_pair(key, size_));
+    *out_memo_index = size_++;
+    on_not_found(*out_memo_index);
+    return arrow::Status::OK();
+  }
+
+  template <typename Func1, typename Func2>
+  int32_t GetOrInsertNull(Func1&& on_found, Func2&& on_not_found) {
+    if (!null_index_set_) {
+      null_index_set_ = true;
+      null_index_ = size_++;
+      on_not_found(null_index_);
+    } else {
+      on_found(null_index_);
+    }
+    return null_index_;
+  }
+
+  int32_t Get(const arrow::util::string_view& value) {
+    auto it = dense_map_.find(value);
+    if (it == dense_map_.end()) return -1;
+    return it->second;
+  }
+
+  int32_t GetNull() { return null_index_set_ ? null_index_ : -1; }
+
+  /* bytes of the copied keys */
+  int64_t key_bytes_allocated() const { return arena_.bytes_allocated(); }
+
+ private:
+  using Allocator = PoolAllocator<std::pair<const arrow::util::string_view, int32_t>>;
+
+  codegen::arrowcompute::extra::AggregateArena arena_;
+  google::dense_hash_map<arrow::util::string_view, int32_t, PackedKeyHash,
+                         std::equal_to<arrow::util::string_view>, Allocator>
+      dense_map_;
+  int32_t size_ = 0;
+  bool null_index_set_ = false;
+  int32_t null_index_;
+};
+
+}  // namespace precompile
+}  // namespace sparkcolumnarplugin
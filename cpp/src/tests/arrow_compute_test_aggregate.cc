@@ -18,8 +18,14 @@
 #include <arrow/array.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "codegen/arrow_compute/ext/hyperloglog_plusplus.h"
 #include "codegen/code_generator.h"
 #include "codegen/code_generator_factory.h"
 #include "tests/test_utils.h"
@@ -91,6 +97,86 @@ TEST(TestArrowCompute, AggregatewithMultipleBatchTest) {
   ASSERT_NOT_OK(Equals(*expected_result.get(), *(result_batch[0]).get()));
 }
 
+TEST(TestArrowCompute, AggregateSumWithNullsTest) {
+  ////////////////////// prepare expr_vector ///////////////////////
+  auto f0 = field("f0", int32());
+  auto f1 = field("f1", float64());
+  auto f2 = field("f2", decimal128(10, 2));
+  auto f3 = field("f3", int64());
+  auto f_sum = field("sum", int64());
+  auto f_count = field("count", int64());
+  auto f_float = field("float", float64());
+  auto f_decimal = field("decimal", decimal128(20, 2));
+  auto arg_0 = TreeExprBuilder::MakeField(f0);
+  auto arg_1 = TreeExprBuilder::MakeField(f1);
+  auto arg_2 = TreeExprBuilder::MakeField(f2);
+  auto arg_3 = TreeExprBuilder::MakeField(f3);
+  auto n_sum_0 = TreeExprBuilder::MakeFunction("sum", {arg_0}, int64());
+  auto n_count_0 = TreeExprBuilder::MakeFunction("count", {arg_0}, int64());
+  auto n_sum_1 = TreeExprBuilder::MakeFunction("sum", {arg_1}, float64());
+  auto n_sum_count_1 = TreeExprBuilder::MakeFunction("sum_count", {arg_1}, float64());
+  auto n_sum_2 = TreeExprBuilder::MakeFunction("sum", {arg_2}, decimal128(20, 2));
+  auto n_sum_3 = TreeExprBuilder::MakeFunction("sum", {arg_3}, int64());
+  auto n_count_3 = TreeExprBuilder::MakeFunction("count", {arg_3}, int64());
+
+  std::vector<std::shared_ptr<::gandiva::Expression>> expr_vector = {
+      TreeExprBuilder::MakeExpression(n_sum_0, f_sum),
+      TreeExprBuilder::MakeExpression(n_count_0, f_count),
+      TreeExprBuilder::MakeExpression(n_sum_1, f_float),
+      TreeExprBuilder::MakeExpression(n_sum_count_1, f_float),
+      TreeExprBuilder::MakeExpression(n_sum_2, f_decimal),
+      TreeExprBuilder::MakeExpression(n_sum_3, f_sum),
+      TreeExprBuilder::MakeExpression(n_count_3, f_count)};
+  auto sch = arrow::schema({f0, f1, f2, f3});
+  std::vector<std::shared_ptr<Field>> ret_types = {
+      f_sum, f_count, f_float, f_float, f_count, f_decimal, f_sum, f_count};
+  ///////////////////// Calculation //////////////////
+  std::shared_ptr<CodeGenerator> expr;
+  arrow::compute::FunctionContext ctx;
+  ASSERT_NOT_OK(
+      CreateCodeGenerator(ctx.memory_pool(), sch, expr_vector, ret_types, &expr, true));
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> result_batch;
+  // 70 rows, so validity bitmap has one full word and one partial word
+  std::vector<std::string> input_data_string = {
+      "[null, -193, -186, null, -172, -165, null, -151, -144, null, -130, -123, null, "
+      "-109, -102, null, -88, -81, null, -67, -60, null, -46, -39, null, -25, -18, "
+      "null, -4, 3, null, 17, 24, null, 38, 45, null, 59, 66, null, 80, 87, null, 101, "
+      "108, null, 122, 129, null, 143, 150, null, 164, 171, null, 185, 192, null, 206, "
+      "213, null, 227, 234, null, 248, 255, null, 269, 276, null]",
+      "[0.0, null, 1.0, 1.5, 2.0, 2.5, null, 3.5, 4.0, 4.5, 5.0, null, 6.0, 6.5, 7.0, "
+      "7.5, null, 8.5, 9.0, 9.5, 10.0, null, 11.0, 11.5, 12.0, 12.5, null, 13.5, 14.0, "
+      "14.5, 15.0, null, 16.0, 16.5, 17.0, 17.5, null, 18.5, 19.0, 19.5, 20.0, null, "
+      "21.0, 21.5, 22.0, 22.5, null, 23.5, 24.0, 24.5, 25.0, null, 26.0, 26.5, 27.0, "
+      "27.5, null, 28.5, 29.0, 29.5, 30.0, null, 31.0, 31.5, 32.0, 32.5, null, 33.5, "
+      "34.0, 34.5]",
+      "[\"-300.00\", \"-289.99\", null, \"-269.97\", \"-259.96\", \"-249.95\", null, "
+      "\"-229.93\", \"-219.92\", \"-209.91\", null, \"-189.89\", \"-179.88\", "
+      "\"-169.87\", null, \"-149.85\", \"-139.84\", \"-129.83\", null, \"-109.81\", "
+      "\"-99.80\", \"-89.79\", null, \"-69.77\", \"-59.76\", \"-49.75\", null, "
+      "\"-29.73\", \"-19.72\", \"-9.71\", null, \"10.31\", \"20.32\", \"30.33\", null, "
+      "\"50.35\", \"60.36\", \"70.37\", null, \"90.39\", \"100.40\", \"110.41\", null, "
+      "\"130.43\", \"140.44\", \"150.45\", null, \"170.47\", \"180.48\", \"190.49\", "
+      "null, \"210.51\", \"220.52\", \"230.53\", null, \"250.55\", \"260.56\", "
+      "\"270.57\", null, \"290.59\", \"300.60\", \"310.61\", null, \"330.63\", "
+      "\"340.64\", \"350.65\", null, \"370.67\", \"380.68\", \"390.69\"]",
+      "[null"};
+  for (int i = 1; i < 70; i++) input_data_string[3] += ", null";
+  input_data_string[3] += "]";
+  MakeInputBatch(input_data_string, sch, &input_batch);
+  ASSERT_NOT_OK(expr->evaluate(input_batch, &result_batch));
+  ASSERT_NOT_OK(expr->evaluate(input_batch, &result_batch));
+  ASSERT_NOT_OK(expr->finish(&result_batch));
+
+  std::shared_ptr<arrow::RecordBatch> expected_result;
+  std::vector<std::string> expected_result_string = {
+      "[3818]", "[92]", "[1946]", "[1946]", "[112]", "[\"4976.74\"]", "[null]", "[0]"};
+  auto res_sch = arrow::schema(
+      {f_sum, f_count, f_float, f_float, f_count, f_decimal, f_sum, f_count});
+  MakeInputBatch(expected_result_string, res_sch, &expected_result);
+  ASSERT_NOT_OK(Equals(*expected_result.get(), *(result_batch[0]).get()));
+}
+
 TEST(TestArrowCompute, GroupByAggregateWithMultipleBatchTest) {
   ////////////////////// prepare expr_vector ///////////////////////
   auto f0 = field("f0", uint32());
@@ -799,5 +885,77 @@ TEST(TestArrowCompute, GroupbySumCountMergeTest) {
   ASSERT_NOT_OK(Equals(*expected_result.get(), *(result_batch[0]).get()));
 }
 
+TEST(TestArrowCompute, HyperLogLogPlusPlusHashTest) {
+  using arrowcompute::extra::HyperLogLogPlusPlus;
+  // Spark: SELECT xxhash64('Spark', array(123), 2) = 5602566077635097486, each column
+  // is hashed with the previous hash as seed starting from 42
+  uint64_t hash = HyperLogLogPlusPlus::Hash(std::string("Spark"));
+  int32_t value = 123;
+  uint64_t chained = XXH64(&value, sizeof(value), hash);
+  value = 2;
+  chained = XXH64(&value, sizeof(value), chained);
+  ASSERT_EQ(static_cast<int64_t>(chained), 5602566077635097486LL);
+
+  // with p = 9 the top 9 bits 392 pick the register, which lives in bits 12..17 of
+  // word 39, and its value is the leading zeros of the other bits plus one
+  HyperLogLogPlusPlus hll(0.05);
+  std::vector<int64_t> words(hll.num_words(), 0);
+  hll.Update(words.data(), hash);
+  for (int i = 0; i < hll.num_words(); i++) {
+    ASSERT_EQ(words[i], i == 39 ? 1LL << 12 : 0);
+  }
+  ASSERT_EQ(hll.Query(words.data()), 1);
+}
+
+TEST(TestArrowCompute, HyperLogLogPlusPlusBiasCorrectionTest) {
+  using arrowcompute::extra::HyperLogLogPlusPlus;
+  // with p = 9 linear counting stops at 400 and the bias is corrected up to 5 * 512,
+  // where the raw estimate overshoots by 30% at 400 and 4% at 1120
+  HyperLogLogPlusPlus hll(0.05);
+  std::vector<int64_t> words(hll.num_words());
+  for (int n : {400, 640, 880, 1120, 1600, 2560}) {
+    double error_sum = 0.0;
+    int num_sketches = 20;
+    for (int r = 0; r < num_sketches; r++) {
+      std::fill(words.begin(), words.end(), 0);
+      for (int64_t i = 0; i < n; i++) {
+        hll.Update(words.data(), HyperLogLogPlusPlus::Hash(i + r * 1000000LL));
+      }
+      auto estimate = hll.Query(words.data());
+      ASSERT_LT(std::abs(estimate - n), 0.15 * n);
+      error_sum += static_cast<double>(estimate - n) / n;
+    }
+    ASSERT_LT(std::abs(error_sum / num_sketches), 0.03);
+  }
+}
+
+TEST(TestArrowCompute, HyperLogLogPlusPlusSetBiasTablesTest) {
+  using arrowcompute::extra::GetHllBiasTables;
+  using arrowcompute::extra::HllBiasTable;
+  using arrowcompute::extra::HyperLogLogPlusPlus;
+  using arrowcompute::extra::SetHllBiasTables;
+  auto builtin_tables = GetHllBiasTables();
+  ASSERT_FALSE(SetHllBiasTables(std::vector<HllBiasTable>(14)).ok());
+  ASSERT_FALSE(SetHllBiasTables(std::vector<HllBiasTable>(15)).ok());
+
+  // with p = 9, 1000 values are in the range corrected by bias, the estimate of a
+  // sketch moves by the bias of the table it was created with
+  HyperLogLogPlusPlus builtin_hll(0.05);
+  std::vector<int64_t> words(builtin_hll.num_words(), 0);
+  for (int64_t i = 0; i < 1000; i++) {
+    builtin_hll.Update(words.data(), HyperLogLogPlusPlus::Hash(i));
+  }
+  auto builtin_estimate = builtin_hll.Query(words.data());
+  auto tables = *builtin_tables;
+  for (auto& bias : tables[9 - 4].biases) {
+    bias -= 100.0;
+  }
+  ASSERT_NOT_OK(SetHllBiasTables(tables));
+  HyperLogLogPlusPlus hll(0.05);
+  ASSERT_EQ(hll.Query(words.data()), builtin_estimate + 100);
+  ASSERT_EQ(builtin_hll.Query(words.data()), builtin_estimate);
+  ASSERT_NOT_OK(SetHllBiasTables(*builtin_tables));
+}
+
 }  // namespace codegen
 }  // namespace sparkcolumnarplugin
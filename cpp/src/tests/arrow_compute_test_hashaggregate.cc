@@ -16,12 +16,18 @@
  */
 
 #include <arrow/array.h>
+#include <arrow/memory_pool.h>
 #include <gtest/gtest.h>
 
+#include <cstdlib>
 #include <memory>
+#include <string>
 
+#include "codegen/arrow_compute/ext/actions_impl.h"
+#include "codegen/arrow_compute/ext/aggregate_arena.h"
 #include "codegen/code_generator.h"
 #include "codegen/code_generator_factory.h"
+#include "precompile/packed_key_hash_map.h"
 #include "tests/test_utils.h"
 
 namespace sparkcolumnarplugin {
@@ -785,6 +791,78 @@ TEST(TestArrowCompute, GroupByHashAggregateWithProjectedKeyTest) {
   }
 }
 
+TEST(TestArrowCompute, GroupByHashAggregateWithTwoFixedWidthKeyTest) {
+  ////////////////////// prepare expr_vector ///////////////////////
+  auto f_unique_0 = field("unique_0", uint32());
+  auto f_unique_1 = field("unique_1", int64());
+  auto f_sum = field("sum", int64());
+  auto f_count_all = field("count_all", int64());
+  auto f_res = field("dummy_res", uint32());
+
+  auto arg_unique_0 = TreeExprBuilder::MakeField(f_unique_0);
+  auto arg_unique_1 = TreeExprBuilder::MakeField(f_unique_1);
+  auto arg_sum = TreeExprBuilder::MakeField(f_sum);
+  auto n_groupby_0 =
+      TreeExprBuilder::MakeFunction("action_groupby", {arg_unique_0}, uint32());
+  auto n_groupby_1 =
+      TreeExprBuilder::MakeFunction("action_groupby", {arg_unique_1}, uint32());
+  auto n_sum = TreeExprBuilder::MakeFunction("action_sum", {arg_sum}, uint32());
+  auto n_count_all = TreeExprBuilder::MakeFunction("action_countLiteral_1", {}, uint32());
+  auto n_schema = TreeExprBuilder::MakeFunction(
+      "codegen_schema", {arg_unique_0, arg_unique_1, arg_sum}, uint32());
+  auto n_aggr = TreeExprBuilder::MakeFunction(
+      "hashAggregateArrays", {n_groupby_0, n_groupby_1, n_sum, n_count_all}, uint32());
+  auto n_codegen_aggr =
+      TreeExprBuilder::MakeFunction("codegen_withOneInput", {n_aggr, n_schema}, uint32());
+
+  auto aggr_expr = TreeExprBuilder::MakeExpression(n_codegen_aggr, f_res);
+
+  std::vector<std::shared_ptr<::gandiva::Expression>> expr_vector = {aggr_expr};
+
+  auto sch = arrow::schema({f_unique_0, f_unique_1, f_sum});
+  std::vector<std::shared_ptr<Field>> ret_types = {f_unique_0, f_unique_1, f_sum,
+                                                   f_count_all};
+
+  /////////////////////// Create Expression Evaluator ////////////////////
+  std::shared_ptr<CodeGenerator> expr;
+  arrow::compute::FunctionContext ctx;
+  ASSERT_NOT_OK(CreateCodeGenerator(ctx.memory_pool(), sch, expr_vector, ret_types, &expr, true));
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> output_batch_list;
+
+  ////////////////////// calculation /////////////////////
+  std::vector<std::string> input_data = {"[1, 1, 2, null, 1, null]",
+                                         "[10, 20, 10, 10, 10, null]",
+                                         "[1, 2, 3, 4, 5, 6]"};
+  MakeInputBatch(input_data, sch, &input_batch);
+  ASSERT_NOT_OK(expr->evaluate(input_batch, &output_batch_list));
+
+  // (0, 10) should not be mixed up with (null, 10)
+  std::vector<std::string> input_data_2 = {"[2, null, 1, 3, 0]", "[10, null, 20, null, 10]",
+                                           "[7, 8, 9, 10, 11]"};
+  MakeInputBatch(input_data_2, sch, &input_batch);
+  ASSERT_NOT_OK(expr->evaluate(input_batch, &output_batch_list));
+
+  ////////////////////// Finish //////////////////////////
+  std::shared_ptr<arrow::RecordBatch> result_batch;
+  std::shared_ptr<ResultIterator<arrow::RecordBatch>> aggr_result_iterator;
+  std::shared_ptr<ResultIteratorBase> aggr_result_iterator_base;
+  ASSERT_NOT_OK(expr->finish(&aggr_result_iterator_base));
+  aggr_result_iterator = std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+      aggr_result_iterator_base);
+
+  std::shared_ptr<arrow::RecordBatch> expected_result;
+  std::vector<std::string> expected_result_string = {
+      "[1, 1, 2, null, null, 3, 0]", "[10, 20, 10, 10, null, null, 10]",
+      "[6, 11, 10, 4, 14, 10, 11]", "[2, 2, 2, 1, 2, 1, 1]"};
+  auto res_sch = arrow::schema(ret_types);
+  MakeInputBatch(expected_result_string, res_sch, &expected_result);
+  ASSERT_TRUE(aggr_result_iterator->HasNext());
+  ASSERT_NOT_OK(aggr_result_iterator->Next(&result_batch));
+  ASSERT_NOT_OK(Equals(*expected_result.get(), *result_batch.get()));
+  ASSERT_FALSE(aggr_result_iterator->HasNext());
+}
+
 TEST(TestArrowCompute, GroupByStddevSampPartialHashAggregateTest) {
   ////////////////////// prepare expr_vector ///////////////////////
   auto f0 = field("f0", uint32());
@@ -957,5 +1035,208 @@ TEST(TestArrowCompute, GroupByStddevSampFinalHashAggregateTest) {
   }
 }
 
+TEST(TestArrowCompute, GroupByHashAggregateBatchAccumulateTest) {
+  setenv("NATIVESQL_AGGR_BATCH_ACCUMULATE", "true", 1);
+  ////////////////////// prepare expr_vector ///////////////////////
+  auto f0 = field("f0", uint32());
+  auto f1 = field("f1", uint32());
+  auto f_unique = field("unique", uint32());
+  auto f_sum = field("sum", int64());
+  auto f_count = field("count", uint64());
+  auto f_avg = field("avg", float64());
+  auto f_min = field("min", uint32());
+  auto f_max = field("max", uint32());
+  auto f_res = field("res", uint32());
+
+  auto arg0 = TreeExprBuilder::MakeField(f0);
+  auto arg1 = TreeExprBuilder::MakeField(f1);
+  auto n_groupby = TreeExprBuilder::MakeFunction("action_groupby", {arg0}, uint32());
+  auto n_sum = TreeExprBuilder::MakeFunction("action_sum", {arg1}, uint32());
+  auto n_count = TreeExprBuilder::MakeFunction("action_count", {arg1}, uint32());
+  auto n_avg = TreeExprBuilder::MakeFunction("action_avg", {arg1}, uint32());
+  auto n_min = TreeExprBuilder::MakeFunction("action_min", {arg1}, uint32());
+  auto n_max = TreeExprBuilder::MakeFunction("action_max", {arg1}, uint32());
+  auto n_schema = TreeExprBuilder::MakeFunction(
+      "codegen_schema", {TreeExprBuilder::MakeField(f0), TreeExprBuilder::MakeField(f1)},
+      uint32());
+  auto n_aggr = TreeExprBuilder::MakeFunction(
+      "hashAggregateArrays", {n_groupby, n_sum, n_count, n_avg, n_min, n_max}, uint32());
+  auto n_codegen_aggr =
+      TreeExprBuilder::MakeFunction("codegen_withOneInput", {n_aggr, n_schema}, uint32());
+
+  auto aggr_expr = TreeExprBuilder::MakeExpression(n_codegen_aggr, f_res);
+
+  std::vector<std::shared_ptr<::gandiva::Expression>> expr_vector = {aggr_expr};
+
+  auto sch = arrow::schema({f0, f1});
+  std::vector<std::shared_ptr<Field>> ret_types = {f_unique, f_sum, f_count,
+                                                   f_avg,    f_min, f_max};
+
+  /////////////////////// Create Expression Evaluator ////////////////////
+  std::shared_ptr<CodeGenerator> expr;
+  arrow::compute::FunctionContext ctx;
+  ASSERT_NOT_OK(CreateCodeGenerator(ctx.memory_pool(), sch, expr_vector, ret_types, &expr, true));
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> output_batch_list;
+
+  ////////////////////// calculation /////////////////////
+  std::vector<std::string> input_data = {"[1, 2, 3, 1, 2, null]",
+                                         "[1, null, 3, 4, null, 6]"};
+  MakeInputBatch(input_data, sch, &input_batch);
+  ASSERT_NOT_OK(expr->evaluate(input_batch, &output_batch_list));
+
+  std::vector<std::string> input_data_2 = {"[3, 1, 4, 4, null]", "[5, 1, null, null, 7]"};
+  MakeInputBatch(input_data_2, sch, &input_batch);
+  ASSERT_NOT_OK(expr->evaluate(input_batch, &output_batch_list));
+
+  ////////////////////// Finish //////////////////////////
+  std::shared_ptr<arrow::RecordBatch> result_batch;
+  std::shared_ptr<ResultIteratorBase> aggr_result_iterator_base;
+  std::shared_ptr<ResultIterator<arrow::RecordBatch>> aggr_result_iterator;
+  ASSERT_NOT_OK(expr->finish(&aggr_result_iterator_base));
+  aggr_result_iterator = std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+      aggr_result_iterator_base);
+  unsetenv("NATIVESQL_AGGR_BATCH_ACCUMULATE");
+
+  std::shared_ptr<arrow::RecordBatch> expected_result;
+  std::vector<std::string> expected_result_string = {
+      "[1, 2, 3, null, 4]",    "[6, null, 8, 13, null]", "[3, 0, 2, 2, 0]",
+      "[2, null, 4, 6.5, null]", "[1, null, 3, 6, null]", "[4, null, 5, 7, null]"};
+  auto res_sch = arrow::schema(ret_types);
+  MakeInputBatch(expected_result_string, res_sch, &expected_result);
+  if (aggr_result_iterator->HasNext()) {
+    ASSERT_NOT_OK(aggr_result_iterator->Next(&result_batch));
+    ASSERT_NOT_OK(Equals(*expected_result.get(), *result_batch.get()));
+  }
+}
+
+TEST(TestArrowCompute, NormalizedKeyHashMapTest) {
+  auto pool = std::make_shared<arrow::ProxyMemoryPool>(arrow::default_memory_pool());
+  {
+    precompile::NormalizedKeyHashMap hash_map(pool.get());
+    // keys are looked up through a reused buffer, like the UnsafeRow of a batch
+    std::string row;
+    int32_t memo_index;
+    int num_inserted = 0;
+    auto on_found = [](int32_t) {};
+    auto on_not_found = [&num_inserted](int32_t) { num_inserted++; };
+    for (int i = 0; i < 10000; i++) {
+      row = std::string(8, '\0') + "key_" + std::to_string(i % 5000);
+      ASSERT_NOT_OK(hash_map.GetOrInsert(arrow::util::string_view(row), on_found,
+                                         on_not_found, &memo_index));
+      ASSERT_EQ(memo_index, i % 5000);
+    }
+    ASSERT_EQ(num_inserted, 5000);
+    ASSERT_EQ(hash_map.GetOrInsertNull(on_found, on_not_found), 5000);
+    ASSERT_EQ(hash_map.GetNull(), 5000);
+    row = std::string(8, '\0') + "key_4999";
+    ASSERT_EQ(hash_map.Get(arrow::util::string_view(row)), 4999);
+    row = std::string(8, '\0') + "key_5000";
+    ASSERT_EQ(hash_map.Get(arrow::util::string_view(row)), -1);
+    // buckets and copied keys both come from the pool
+    ASSERT_GT(hash_map.key_bytes_allocated(), 0);
+    ASSERT_GT(pool->bytes_allocated(), hash_map.key_bytes_allocated());
+  }
+  ASSERT_EQ(pool->bytes_allocated(), 0);
+}
+
+TEST(TestArrowCompute, ArenaVectorAcrossSlabsTest) {
+  using arrowcompute::extra::AggregateArena;
+  using arrowcompute::extra::AppendArenaValues;
+  using arrowcompute::extra::ArenaVector;
+  constexpr size_t kSlabSize = ArenaVector<int64_t>::kSlabSize;
+  auto pool = std::make_shared<arrow::ProxyMemoryPool>(arrow::default_memory_pool());
+  {
+    AggregateArena arena(pool.get());
+    ArenaVector<int64_t> values(&arena);
+    ArenaVector<uint8_t> validity(&arena);
+    // Grow adds a whole slab filled with the given value
+    ASSERT_NOT_OK(values.Grow(0, -1));
+    ASSERT_NOT_OK(validity.Grow(0, 0));
+    ASSERT_EQ(values.size(), kSlabSize);
+    const int64_t* first_slab = &values[0];
+    size_t num_groups = 3 * kSlabSize + 100;
+    for (size_t i = 0; i < num_groups; i++) {
+      ASSERT_NOT_OK(values.Grow(i, -1));
+      ASSERT_NOT_OK(validity.Grow(i, 0));
+      ASSERT_EQ(values[i], -1);
+      ASSERT_EQ(validity[i], 0);
+      values[i] = i;
+      validity[i] = i % 3 != 0;
+    }
+    ASSERT_EQ(values.size(), 4 * kSlabSize);
+    ASSERT_EQ(validity.size(), 4 * kSlabSize);
+    // growing never moves what is already stored
+    ASSERT_EQ(&values[0], first_slab);
+    ASSERT_GT(arena.bytes_allocated(), 0);
+
+    // range starts and ends in the middle of slabs
+    size_t offset = kSlabSize - 10;
+    size_t length = 2 * kSlabSize + 20;
+    std::shared_ptr<arrow::Array> out;
+    arrow::Int64Builder builder(pool.get());
+    ASSERT_NOT_OK(AppendArenaValues(&builder, values, validity, offset, length));
+    ASSERT_NOT_OK(builder.Finish(&out));
+    ASSERT_EQ(out->length(), static_cast<int64_t>(length));
+    auto typed_out = std::dynamic_pointer_cast<arrow::Int64Array>(out);
+    for (size_t i = 0; i < length; i++) {
+      auto group_id = offset + i;
+      ASSERT_EQ(typed_out->IsValid(i), group_id % 3 != 0);
+      if (typed_out->IsValid(i)) {
+        ASSERT_EQ(typed_out->Value(i), static_cast<int64_t>(group_id));
+      }
+    }
+
+    ASSERT_NOT_OK(AppendArenaValues(&builder, values, offset, length));
+    ASSERT_NOT_OK(builder.Finish(&out));
+    ASSERT_EQ(out->null_count(), 0);
+    typed_out = std::dynamic_pointer_cast<arrow::Int64Array>(out);
+    for (size_t i = 0; i < length; i++) {
+      ASSERT_EQ(typed_out->Value(i), static_cast<int64_t>(offset + i));
+    }
+  }
+  ASSERT_EQ(pool->bytes_allocated(), 0);
+}
+
+TEST(TestArrowCompute, UniqueActionStringAcrossSlabsTest) {
+  auto pool = std::make_shared<arrow::ProxyMemoryPool>(arrow::default_memory_pool());
+  {
+    arrow::compute::FunctionContext ctx(pool.get());
+    std::shared_ptr<arrowcompute::extra::ActionBase> action;
+    ASSERT_NOT_OK(arrowcompute::extra::MakeUniqueAction(&ctx, arrow::utf8(), &action));
+    int num_groups = 2 * 4096 + 300;
+    arrow::StringBuilder expected_builder(pool.get());
+    // input buffer is reused by every row, so the action has to copy what it keeps
+    std::string input;
+    for (int i = 0; i < num_groups; i++) {
+      if (i % 7 == 0) {
+        ASSERT_NOT_OK(action->EvaluateNull(i));
+        ASSERT_NOT_OK(expected_builder.AppendNull());
+      } else {
+        input = "group_" + std::to_string(i) + (i % 2 ? std::string(40, 'x') : "");
+        ASSERT_NOT_OK(action->Evaluate(i, &input));
+        ASSERT_NOT_OK(expected_builder.Append(input));
+      }
+    }
+    // later rows of a group keep its first value
+    for (int i = 1; i < num_groups; i += 7) {
+      input = "other";
+      ASSERT_NOT_OK(action->Evaluate(i, &input));
+    }
+    input.assign(input.size(), '\0');
+    std::shared_ptr<arrow::Array> expected;
+    ASSERT_NOT_OK(expected_builder.Finish(&expected));
+
+    std::vector<std::shared_ptr<arrow::Array>> out;
+    ASSERT_NOT_OK(action->Finish(&out));
+    ASSERT_NOT_OK(Equals(*expected.get(), *out[0].get()));
+
+    out.clear();
+    ASSERT_NOT_OK(action->Finish(4096 - 5, 4096 + 10, &out));
+    ASSERT_NOT_OK(Equals(*expected->Slice(4096 - 5, 4096 + 10).get(), *out[0].get()));
+  }
+  ASSERT_EQ(pool->bytes_allocated(), 0);
+}
+
 }  // namespace codegen
 }  // namespace sparkcolumnarplugin
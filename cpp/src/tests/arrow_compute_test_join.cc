@@ -17,6 +17,7 @@
 
 #include <arrow/array.h>
 #include <arrow/ipc/json_simple.h>
+#include <arrow/memory_pool.h>
 #include <arrow/record_batch.h>
 #include <gandiva/tree_expr_builder.h>
 #include <gtest/gtest.h>
@@ -25,6 +26,7 @@
 
 #include "codegen/code_generator.h"
 #include "codegen/code_generator_factory.h"
+#include "codegen/common/hash_relation_cache.h"
 #include "tests/test_utils.h"
 
 using arrow::int64;
@@ -914,5 +916,152 @@ TEST(TestArrowComputeJoin, JoinTestUsingInnerJoinWithProjectedCondition) {
   }
 }
 
+TEST(TestArrowComputeJoin, HashRelationCacheSharedByTasksTest) {
+  auto& cache = HashRelationCache::GetInstance();
+  const int64_t relation_id = 1000;
+  std::shared_ptr<HashRelation> relation;
+  bool need_build;
+
+  // first task is elected as builder
+  ASSERT_NOT_OK(cache.Acquire(relation_id, &relation, &need_build));
+  ASSERT_TRUE(need_build);
+  auto built =
+      std::make_shared<HashRelation>(std::vector<std::shared_ptr<HashRelationColumn>>());
+  bool cached;
+  ASSERT_NOT_OK(cache.Publish(relation_id, built, &cached));
+  ASSERT_TRUE(cached);
+  ASSERT_EQ(cache.GetRefCount(relation_id), 1);
+
+  // following tasks share the published relation
+  ASSERT_NOT_OK(cache.Acquire(relation_id, &relation, &need_build));
+  ASSERT_FALSE(need_build);
+  ASSERT_EQ(relation, built);
+  ASSERT_EQ(cache.GetRefCount(relation_id), 2);
+
+  // evicted relation is kept until the last reference is released
+  cache.Evict(relation_id);
+  cache.Release(relation_id);
+  ASSERT_EQ(cache.GetRefCount(relation_id), 1);
+  cache.Release(relation_id);
+  ASSERT_EQ(cache.GetRefCount(relation_id), 0);
+
+  // aborted build lets next task rebuild
+  ASSERT_NOT_OK(cache.Acquire(relation_id, &relation, &need_build));
+  ASSERT_TRUE(need_build);
+  cache.Abort(relation_id);
+  ASSERT_NOT_OK(cache.Acquire(relation_id, &relation, &need_build));
+  ASSERT_TRUE(need_build);
+  cache.Abort(relation_id);
+}
+
+TEST(TestArrowComputeJoin, HashRelationCacheOutlivesBuildingTaskTest) {
+  auto& cache = HashRelationCache::GetInstance();
+  const int64_t relation_id = 1001;
+  std::shared_ptr<HashRelation> relation;
+  bool need_build;
+
+  // building task has its own context and pool, both are gone before probing
+  {
+    auto task_pool =
+        std::make_shared<arrow::ProxyMemoryPool>(arrow::default_memory_pool());
+    arrow::compute::FunctionContext task_ctx(task_pool.get());
+    ASSERT_NOT_OK(cache.Acquire(relation_id, &relation, &need_build));
+    ASSERT_TRUE(need_build);
+    auto built = std::make_shared<HashRelation>(
+        &task_ctx, std::vector<std::shared_ptr<HashRelationColumn>>(), 4);
+    ASSERT_NOT_OK(built->InitHashTable(128, 1024));
+    std::shared_ptr<arrow::Array> keys;
+    ASSERT_NOT_OK(arrow::ipc::internal::json::ArrayFromJSON(arrow::int32(),
+                                                            "[1, 7, 42, 7]", &keys));
+    // keys are used as their own hash values
+    ASSERT_NOT_OK(
+        built->AppendKeyColumn(keys, std::dynamic_pointer_cast<arrow::Int32Array>(keys)));
+    ASSERT_GT(task_pool->bytes_allocated(), 0);
+    bool cached;
+    ASSERT_NOT_OK(cache.Publish(relation_id, built, &cached));
+    ASSERT_TRUE(cached);
+    ASSERT_EQ(task_pool->bytes_allocated(), 0);
+  }
+
+  // another task probes through its own shallow copy and evicts
+  {
+    ASSERT_NOT_OK(cache.Acquire(relation_id, &relation, &need_build));
+    ASSERT_FALSE(need_build);
+    CachedHashRelationResultIterator iter(relation_id, relation);
+    std::shared_ptr<HashRelation> probe_relation;
+    ASSERT_NOT_OK(iter.Next(&probe_relation));
+    ASSERT_EQ(probe_relation->Get(7, (int32_t)7), 0);
+    ASSERT_EQ(probe_relation->GetItemListByIndex(0).size(), 2);
+    ASSERT_EQ(probe_relation->Get(42, (int32_t)42), 0);
+    ASSERT_EQ(probe_relation->Get(3, (int32_t)3), -1);
+    cache.Evict(relation_id);
+    // the reference of the builder
+    cache.Release(relation_id);
+  }
+  ASSERT_EQ(cache.GetRefCount(relation_id), 0);
+}
+
+TEST(TestArrowComputeJoin, HashRelationCacheEvictsUnusedRelationsTest) {
+  auto& cache = HashRelationCache::GetInstance();
+  arrow::compute::FunctionContext task_ctx;
+  auto cache_pool = std::make_shared<arrow::ProxyMemoryPool>(arrow::default_memory_pool());
+  std::shared_ptr<arrow::Array> keys;
+  ASSERT_NOT_OK(
+      arrow::ipc::internal::json::ArrayFromJSON(arrow::int32(), "[1, 7, 42]", &keys));
+  auto build = [&](std::shared_ptr<HashRelation>* out) {
+    auto built = std::make_shared<HashRelation>(
+        &task_ctx, std::vector<std::shared_ptr<HashRelationColumn>>(), 4);
+    ASSERT_NOT_OK(built->InitHashTable(128, 1024));
+    ASSERT_NOT_OK(
+        built->AppendKeyColumn(keys, std::dynamic_pointer_cast<arrow::Int32Array>(keys)));
+    *out = built;
+  };
+  std::shared_ptr<HashRelation> relation;
+  build(&relation);
+  auto bytes = relation->GetHashTableBytes();
+  // room for one relation only
+  cache.SetMemoryPool(cache_pool.get(), bytes + bytes / 2);
+
+  auto publish = [&](int64_t relation_id, bool* cached) {
+    std::shared_ptr<HashRelation> acquired;
+    bool need_build;
+    ASSERT_NOT_OK(cache.Acquire(relation_id, &acquired, &need_build));
+    ASSERT_TRUE(need_build);
+    std::shared_ptr<HashRelation> built;
+    build(&built);
+    ASSERT_NOT_OK(cache.Publish(relation_id, built, cached));
+  };
+  bool cached;
+  publish(2000, &cached);
+  ASSERT_TRUE(cached);
+  ASSERT_EQ(cache.GetCachedBytes(), bytes);
+  ASSERT_EQ(cache_pool->bytes_allocated(), bytes);
+  // unused relations stay cached until room is needed
+  cache.Release(2000);
+  ASSERT_EQ(cache.GetCachedBytes(), bytes);
+
+  publish(2001, &cached);
+  ASSERT_TRUE(cached);
+  ASSERT_EQ(cache.GetCachedBytes(), bytes);
+  ASSERT_EQ(cache_pool->bytes_allocated(), bytes);
+  std::shared_ptr<HashRelation> acquired;
+  bool need_build;
+  ASSERT_NOT_OK(cache.Acquire(2000, &acquired, &need_build));
+  ASSERT_TRUE(need_build);
+  cache.Abort(2000);
+
+  // 2001 is still held by its builder, so 2002 is left to its builder uncached
+  publish(2002, &cached);
+  ASSERT_FALSE(cached);
+  ASSERT_EQ(cache.GetRefCount(2002), 0);
+  ASSERT_EQ(cache.GetCachedBytes(), bytes);
+
+  cache.Evict(2001);
+  cache.Release(2001);
+  ASSERT_EQ(cache.GetCachedBytes(), 0);
+  ASSERT_EQ(cache_pool->bytes_allocated(), 0);
+  cache.SetMemoryPool(arrow::default_memory_pool(), 0);
+}
+
 }  // namespace codegen
 }  // namespace sparkcolumnarplugin
@@ -18,11 +18,14 @@
 #include <arrow/array.h>
 #include <arrow/ipc/json_simple.h>
 #include <arrow/record_batch.h>
+#include <arrow/util/io_util.h>
 #include <gandiva/tree_expr_builder.h>
 #include <gtest/gtest.h>
 
+#include <functional>
 #include <memory>
 
+#include "codegen/arrow_compute/ext/array_appender.h"
 #include "codegen/code_generator.h"
 #include "codegen/code_generator_factory.h"
 #include "codegen/common/hash_relation.h"
@@ -1865,7 +1868,139 @@ TEST(TestArrowComputeWSCG, JoinWOCGTestInnerJoinType2WithUInt16) {
   }
 }
 
-TEST(TestArrowComputeWSCG, JoinWOCGTestStringInnerJoinType2LoadHashRelation) {
+TEST(TestArrowComputeWSCG, JoinWOCGTestInnerJoinType2ParallelBuild) {
+  ////////////////////// prepare expr_vector ///////////////////////
+  auto table0_f0 = field("table0_f0", uint32());
+  auto table0_f1 = field("table0_f1", uint32());
+  auto table0_f2 = field("table0_f2", uint32());
+  auto table1_f0 = field("table1_f0", uint32());
+  auto table1_f1 = field("table1_f1", utf8());
+
+  ///////////////////////////////////////////
+  auto n_left = TreeExprBuilder::MakeFunction(
+      "codegen_left_schema",
+      {TreeExprBuilder::MakeField(table0_f0), TreeExprBuilder::MakeField(table0_f1),
+       TreeExprBuilder::MakeField(table0_f2)},
+      uint32());
+  auto n_right = TreeExprBuilder::MakeFunction(
+      "codegen_right_schema",
+      {TreeExprBuilder::MakeField(table1_f0), TreeExprBuilder::MakeField(table1_f1)},
+      uint32());
+  auto f_res = field("res", uint32());
+
+  auto n_left_key = TreeExprBuilder::MakeFunction(
+      "codegen_left_key_schema", {TreeExprBuilder::MakeField(table0_f0)}, uint32());
+  auto n_right_key = TreeExprBuilder::MakeFunction(
+      "codegen_right_key_schema", {TreeExprBuilder::MakeField(table1_f0)}, uint32());
+  auto n_result = TreeExprBuilder::MakeFunction(
+      "result",
+      {TreeExprBuilder::MakeField(table1_f0), TreeExprBuilder::MakeField(table1_f1)},
+      uint32());
+  auto n_hash_config = TreeExprBuilder::MakeFunction(
+      "build_keys_config_node", {TreeExprBuilder::MakeLiteral((int)1)}, uint32());
+  auto n_probeArrays = TreeExprBuilder::MakeFunction(
+      "conditionedProbeArraysInner",
+      {n_left, n_right, n_left_key, n_right_key, n_result, n_hash_config}, uint32());
+  auto n_standalone =
+      TreeExprBuilder::MakeFunction("standalone", {n_probeArrays}, uint32());
+  auto probeArrays_expr = TreeExprBuilder::MakeExpression(n_standalone, f_res);
+
+  auto schema_table_0 = arrow::schema({table0_f0, table0_f1, table0_f2});
+  auto schema_table_1 = arrow::schema({table1_f0, table1_f1});
+  auto schema_table = arrow::schema({table1_f0, table1_f1});
+
+  // 4 build threads and no minimal rows, so the partitioned build is always used
+  auto n_parallel_hash_config = TreeExprBuilder::MakeFunction(
+      "build_keys_config_node",
+      {TreeExprBuilder::MakeLiteral((int)1), TreeExprBuilder::MakeLiteral((int)4),
+       TreeExprBuilder::MakeLiteral((int64_t)0)},
+      uint32());
+  auto n_hash_kernel = TreeExprBuilder::MakeFunction(
+      "HashRelation", {n_left_key, n_parallel_hash_config}, uint32());
+  auto n_hash = TreeExprBuilder::MakeFunction("standalone", {n_hash_kernel}, uint32());
+  auto hashRelation_expr = TreeExprBuilder::MakeExpression(n_hash, f_res);
+  std::shared_ptr<CodeGenerator> expr_build;
+  arrow::compute::FunctionContext ctx;
+  ASSERT_NOT_OK(CreateCodeGenerator(ctx.memory_pool(), schema_table_0,
+                                    {hashRelation_expr}, {}, &expr_build, true));
+  std::shared_ptr<CodeGenerator> expr_probe;
+  ASSERT_NOT_OK(CreateCodeGenerator(ctx.memory_pool(), schema_table_1, {probeArrays_expr},
+                                    {table1_f0, table1_f1}, &expr_probe, true));
+  ///////////////////// Calculation //////////////////
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+
+  std::vector<std::shared_ptr<arrow::RecordBatch>> dummy_result_batches;
+
+  std::vector<std::shared_ptr<arrow::RecordBatch>> table_0;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> table_1;
+
+  std::vector<std::string> input_data_string = {
+      "[10, 3, 1, 2, 3, 1]", "[10, 3, 1, 2, 13, 11]", "[10, 3, 1, 2, 13, 11]"};
+  MakeInputBatch(input_data_string, schema_table_0, &input_batch);
+  table_0.push_back(input_batch);
+
+  input_data_string = {"[6, 12, 5, 8, 6, 10]", "[6, 12, 5, 8, 16, 110]",
+                       "[6, 12, 5, 8, 16, 110]"};
+  MakeInputBatch(input_data_string, schema_table_0, &input_batch);
+  table_0.push_back(input_batch);
+
+  std::vector<std::string> input_data_2_string = {"[1, 3, 4, 5, 6]",
+                                                  R"(["BJ", "TY", "NY", "SH", "HZ"])"};
+  MakeInputBatch(input_data_2_string, schema_table_1, &input_batch);
+  table_1.push_back(input_batch);
+
+  input_data_2_string = {"[7, 8, 9, 10, 11, 12]",
+                         R"(["SH", "NY", "BJ", "IT", "BR", "TL"])"};
+  MakeInputBatch(input_data_2_string, schema_table_1, &input_batch);
+  table_1.push_back(input_batch);
+
+  //////////////////////// data prepared /////////////////////////
+
+  auto res_sch = arrow::schema({table1_f0, table1_f1});
+  std::vector<std::shared_ptr<RecordBatch>> expected_table;
+  std::shared_ptr<arrow::RecordBatch> expected_result;
+  std::vector<std::string> expected_result_string = {
+      "[1, 1, 3, 3, 5, 6, 6]", R"(["BJ", "BJ", "TY", "TY","SH", "HZ", "HZ"])"};
+  MakeInputBatch(expected_result_string, res_sch, &expected_result);
+  expected_table.push_back(expected_result);
+
+  expected_result_string = {"[8, 10, 10, 12]", R"(["NY", "IT", "IT","TL"])"};
+  MakeInputBatch(expected_result_string, res_sch, &expected_result);
+  expected_table.push_back(expected_result);
+
+  ////////////////////// evaluate //////////////////////
+  for (auto batch : table_0) {
+    ASSERT_NOT_OK(expr_build->evaluate(batch, &dummy_result_batches));
+  }
+  std::shared_ptr<ResultIteratorBase> build_result_iterator_base;
+  ASSERT_NOT_OK(expr_build->finish(&build_result_iterator_base));
+  std::shared_ptr<ResultIteratorBase> probe_result_iterator_base;
+  ASSERT_NOT_OK(expr_probe->finish(&probe_result_iterator_base));
+
+  auto probe_result_iterator =
+      std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+          probe_result_iterator_base);
+  probe_result_iterator->SetDependencies({build_result_iterator_base});
+
+  for (int i = 0; i < 2; i++) {
+    auto right_batch = table_1[i];
+
+    std::shared_ptr<arrow::RecordBatch> result_batch;
+    std::vector<std::shared_ptr<arrow::Array>> input;
+    for (int i = 0; i < right_batch->num_columns(); i++) {
+      input.push_back(right_batch->column(i));
+    }
+
+    ASSERT_NOT_OK(probe_result_iterator->Process(input, &result_batch));
+    ASSERT_NOT_OK(Equals(*(expected_table[i]).get(), *result_batch.get()));
+  }
+}
+
+/* Builds the same relation twice, load copies the hash table of the first one into
+ * the second one, which is then probed. */
+void StringInnerJoinType2WithLoadedHashRelation(
+    const std::function<void(std::shared_ptr<HashRelation>,
+                             std::shared_ptr<HashRelation>)>& load) {
   ////////////////////// prepare expr_vector ///////////////////////
   auto table0_f0 = field("table0_f0", utf8());
   auto table0_f1 = field("table0_f1", utf8());
@@ -2006,10 +2141,8 @@ TEST(TestArrowComputeWSCG, JoinWOCGTestStringInnerJoinType2LoadHashRelation) {
   std::shared_ptr<HashRelation> hash_relation;
   ASSERT_NOT_OK(build_result_iterator->Next(&hash_relation));
   hash_relation_pre->TESTGrowAndRehashKeyArray();
-  int64_t addrs[3];
-  int sizes[3];
-  ASSERT_NOT_OK(hash_relation_pre->UnsafeGetHashTableObject(addrs, sizes));
-  ASSERT_NOT_OK(hash_relation->UnsafeSetHashTableObject(3, addrs, sizes));
+  load(hash_relation_pre, hash_relation);
+  if (::testing::Test::HasFatalFailure()) return;
   ASSERT_NOT_OK(probe_result_iterator->SetDependencies({build_result_iterator_base}));
   // ASSERT_NOT_OK(probe_result_iterator->SetDependencies({build_result_iterator_base_pre}));
 
@@ -2027,5 +2160,201 @@ TEST(TestArrowComputeWSCG, JoinWOCGTestStringInnerJoinType2LoadHashRelation) {
   }
 }
 
+TEST(TestArrowComputeWSCG, JoinWOCGTestStringInnerJoinType2LoadHashRelation) {
+  StringInnerJoinType2WithLoadedHashRelation([](std::shared_ptr<HashRelation> from,
+                                                std::shared_ptr<HashRelation> to) {
+    int64_t addrs[3];
+    int sizes[3];
+    ASSERT_NOT_OK(from->UnsafeGetHashTableObject(addrs, sizes));
+    ASSERT_NOT_OK(to->UnsafeSetHashTableObject(3, addrs, sizes));
+  });
+}
+
+TEST(TestArrowComputeWSCG, JoinWOCGTestStringInnerJoinType2MmapHashRelation) {
+  std::unique_ptr<arrow::internal::TemporaryDir> tmp_dir;
+  ARROW_ASSIGN_OR_THROW(tmp_dir, arrow::internal::TemporaryDir::Make("hash_relation-"));
+  auto path = tmp_dir->path().ToString() + "/table.bin";
+  StringInnerJoinType2WithLoadedHashRelation(
+      [&path](std::shared_ptr<HashRelation> from, std::shared_ptr<HashRelation> to) {
+        ASSERT_NOT_OK(from->WriteHashTableFile(path));
+        ASSERT_NOT_OK(to->MmapHashTableFile(path));
+      });
+}
+
+TEST(TestArrowComputeWSCG, JoinWOCGTestImportCorruptedHashTable) {
+  arrow::compute::FunctionContext ctx;
+  auto relation = std::make_shared<HashRelation>(
+      &ctx, std::vector<std::shared_ptr<HashRelationColumn>>(), 4);
+  ASSERT_NOT_OK(relation->InitHashTable(128, 1024));
+  std::shared_ptr<arrow::Array> keys;
+  ASSERT_NOT_OK(
+      arrow::ipc::internal::json::ArrayFromJSON(arrow::int32(), "[1, 7, 42]", &keys));
+  ASSERT_NOT_OK(
+      relation->AppendKeyColumn(keys, std::dynamic_pointer_cast<arrow::Int32Array>(keys)));
+  std::shared_ptr<arrow::Buffer> serialized;
+  ASSERT_NOT_OK(relation->SerializeHashTable(&serialized));
+
+  auto import_with = [&serialized](std::function<void(HashRelationTableHeader*)> corrupt) {
+    std::shared_ptr<arrow::Buffer> copy;
+    ASSERT_NOT_OK(serialized->Copy(0, serialized->size(), &copy));
+    corrupt(reinterpret_cast<HashRelationTableHeader*>(copy->mutable_data()));
+    HashRelation imported(std::vector<std::shared_ptr<HashRelationColumn>>{});
+    ASSERT_TRUE(imported.ImportHashTable(copy).IsInvalid());
+  };
+  import_with([](HashRelationTableHeader* h) { h->array_capacity = 100; });
+  import_with([](HashRelationTableHeader* h) { h->array_capacity = 0; });
+  import_with([](HashRelationTableHeader* h) { h->num_keys = h->array_capacity + 1; });
+  import_with([](HashRelationTableHeader* h) { h->bytes_in_key_array = 4; });
+  import_with([](HashRelationTableHeader* h) { h->key_array_length *= 2; });
+  import_with([](HashRelationTableHeader* h) { h->cursor = h->bytes_map_length + 1; });
+  import_with([](HashRelationTableHeader* h) { h->bytes_map_offset = INT64_MAX; });
+  import_with([](HashRelationTableHeader* h) { h->key_array_offset = -64; });
+
+  HashRelation imported(std::vector<std::shared_ptr<HashRelationColumn>>{});
+  ASSERT_NOT_OK(imported.ImportHashTable(serialized));
+  ASSERT_EQ(imported.GetHashTableSize(), 3);
+}
+
+TEST(TestArrowComputeWSCG, JoinWOCGTestProbeHashPartitions) {
+  arrow::compute::FunctionContext ctx;
+  // key is used as its own hash, so -3 is the only key with the top bit set
+  std::shared_ptr<arrow::Array> keys;
+  ASSERT_NOT_OK(
+      arrow::ipc::internal::json::ArrayFromJSON(arrow::int32(), "[1, -3, 7, 42]", &keys));
+  auto typed_keys = std::dynamic_pointer_cast<arrow::Int32Array>(keys);
+  std::vector<std::vector<int32_t>> partition_rows = {{0, 2, 3}, {1}};
+  std::vector<std::shared_ptr<HashRelation>> partitions;
+  for (auto& rows : partition_rows) {
+    auto partition = std::make_shared<HashRelation>(
+        &ctx, std::vector<std::shared_ptr<HashRelationColumn>>(), 4);
+    ASSERT_NOT_OK(partition->InitHashTable(128, 1024));
+    ASSERT_NOT_OK(partition->AppendKeyColumn(keys, typed_keys, &rows));
+    partitions.push_back(partition);
+  }
+  auto relation = std::make_shared<HashRelation>(
+      &ctx, std::vector<std::shared_ptr<HashRelationColumn>>(), 4);
+  ASSERT_NOT_OK(relation->SetHashPartitions(1, partitions));
+  ASSERT_EQ(relation->GetHashTableSize(), 4);
+  for (int key : {1, -3, 7, 42}) {
+    ASSERT_NE(relation->IfExists(key, key), -1);
+  }
+  ASSERT_EQ(relation->IfExists(5, 5), -1);
+
+  // shipping the relation merges partitions into one table
+  std::shared_ptr<arrow::Buffer> serialized;
+  ASSERT_NOT_OK(relation->SerializeHashTable(&serialized));
+  HashRelation imported(std::vector<std::shared_ptr<HashRelationColumn>>{});
+  ASSERT_NOT_OK(imported.ImportHashTable(serialized));
+  ASSERT_EQ(imported.GetHashTableSize(), 4);
+  for (int key : {1, -3, 7, 42}) {
+    ASSERT_NE(imported.IfExists(key, key), -1);
+  }
+}
+
+/* Probes one batch through the non-codegen probe of join_function, whose matches are
+ * recorded first and then gathered column by column, and compares every result column
+ * with expected. */
+void CheckJoinMatches(const std::string& join_function, bool with_build_columns,
+                      const std::vector<std::string>& expected_json) {
+  auto table0_f0 = field("table0_f0", uint32());
+  auto table0_f1 = field("table0_f1", utf8());
+  auto table0_f2 = field("table0_f2", uint32());
+  auto table1_f0 = field("table1_f0", uint32());
+  auto table1_f1 = field("table1_f1", uint32());
+
+  auto n_left = TreeExprBuilder::MakeFunction(
+      "codegen_left_schema",
+      {TreeExprBuilder::MakeField(table0_f0), TreeExprBuilder::MakeField(table0_f1),
+       TreeExprBuilder::MakeField(table0_f2)},
+      uint32());
+  auto n_right = TreeExprBuilder::MakeFunction(
+      "codegen_right_schema",
+      {TreeExprBuilder::MakeField(table1_f0), TreeExprBuilder::MakeField(table1_f1)},
+      uint32());
+  auto f_res = field("res", uint32());
+
+  auto n_left_key = TreeExprBuilder::MakeFunction(
+      "codegen_left_key_schema", {TreeExprBuilder::MakeField(table0_f0)}, uint32());
+  auto n_right_key = TreeExprBuilder::MakeFunction(
+      "codegen_right_key_schema", {TreeExprBuilder::MakeField(table1_f0)}, uint32());
+  gandiva::FieldVector result_fields = {table1_f0, table1_f1};
+  if (with_build_columns) {
+    result_fields = {table0_f1, table0_f2, table1_f0, table1_f1};
+  }
+  gandiva::NodeVector result_nodes;
+  for (auto result_field : result_fields) {
+    result_nodes.push_back(TreeExprBuilder::MakeField(result_field));
+  }
+  auto n_result = TreeExprBuilder::MakeFunction("result", result_nodes, uint32());
+  auto n_hash_config = TreeExprBuilder::MakeFunction(
+      "build_keys_config_node", {TreeExprBuilder::MakeLiteral((int)1)}, uint32());
+  auto n_probeArrays = TreeExprBuilder::MakeFunction(
+      join_function, {n_left, n_right, n_left_key, n_right_key, n_result, n_hash_config},
+      uint32());
+  auto n_standalone =
+      TreeExprBuilder::MakeFunction("standalone", {n_probeArrays}, uint32());
+  auto probeArrays_expr = TreeExprBuilder::MakeExpression(n_standalone, f_res);
+
+  auto schema_table_0 = arrow::schema({table0_f0, table0_f1, table0_f2});
+  auto schema_table_1 = arrow::schema({table1_f0, table1_f1});
+
+  auto n_hash_kernel = TreeExprBuilder::MakeFunction(
+      "HashRelation", {n_left_key, n_hash_config}, uint32());
+  auto n_hash = TreeExprBuilder::MakeFunction("standalone", {n_hash_kernel}, uint32());
+  auto hashRelation_expr = TreeExprBuilder::MakeExpression(n_hash, f_res);
+  std::shared_ptr<CodeGenerator> expr_build;
+  arrow::compute::FunctionContext ctx;
+  ASSERT_NOT_OK(CreateCodeGenerator(ctx.memory_pool(), schema_table_0,
+                                    {hashRelation_expr}, {}, &expr_build, true));
+  std::shared_ptr<CodeGenerator> expr_probe;
+  ASSERT_NOT_OK(CreateCodeGenerator(ctx.memory_pool(), schema_table_1,
+                                    {probeArrays_expr}, result_fields, &expr_probe,
+                                    true));
+
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> dummy_result_batches;
+  MakeInputBatch({"[1, 2, 3, 6, 5]", R"(["a", "b", "c", "d", "e"])",
+                  "[10, 20, 30, 40, 50]"},
+                 schema_table_0, &input_batch);
+  ASSERT_NOT_OK(expr_build->evaluate(input_batch, &dummy_result_batches));
+  std::shared_ptr<ResultIteratorBase> build_result_iterator;
+  std::shared_ptr<ResultIteratorBase> probe_result_iterator_base;
+  ASSERT_NOT_OK(expr_build->finish(&build_result_iterator));
+  ASSERT_NOT_OK(expr_probe->finish(&probe_result_iterator_base));
+  auto probe_result_iterator =
+      std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+          probe_result_iterator_base);
+  ASSERT_NOT_OK(probe_result_iterator->SetDependencies({build_result_iterator}));
+
+  MakeInputBatch({"[2, 4, 5, null, 1]", "[100, 200, 300, 400, 500]"}, schema_table_1,
+                 &input_batch);
+  std::shared_ptr<arrow::RecordBatch> result_batch;
+  ASSERT_NOT_OK(probe_result_iterator->Process(input_batch->columns(), &result_batch));
+
+  std::shared_ptr<arrow::RecordBatch> expected_batch;
+  MakeInputBatch(expected_json, arrow::schema(result_fields), &expected_batch);
+  ASSERT_NOT_OK(Equals(*expected_batch.get(), *result_batch.get()));
+}
+
+TEST(TestArrowComputeWSCG, JoinWOCGTestInnerJoinMatches) {
+  CheckJoinMatches(
+      "conditionedProbeArraysInner", true,
+      {R"(["b", "e", "a"])", "[20, 50, 10]", "[2, 5, 1]", "[100, 300, 500]"});
+}
+
+TEST(TestArrowComputeWSCG, JoinWOCGTestOuterJoinMatches) {
+  CheckJoinMatches("conditionedProbeArraysOuter", true,
+                   {R"(["b", null, "e", null, "a"])", "[20, null, 50, null, 10]",
+                    "[2, 4, 5, null, 1]", "[100, 200, 300, 400, 500]"});
+}
+
+TEST(TestArrowComputeWSCG, JoinWOCGTestAntiJoinMatches) {
+  CheckJoinMatches("conditionedProbeArraysAnti", false, {"[4, null]", "[200, 400]"});
+}
+
+TEST(TestArrowComputeWSCG, JoinWOCGTestSemiJoinMatches) {
+  CheckJoinMatches("conditionedProbeArraysSemi", false, {"[2, 5, 1]", "[100, 300, 500]"});
+}
+
 }  // namespace codegen
 }  // namespace sparkcolumnarplugin
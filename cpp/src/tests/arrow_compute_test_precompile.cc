@@ -20,6 +20,8 @@
 #include <gtest/gtest.h>
 
 #include "precompile/array.h"
+#include "precompile/hash_arrays_kernel.h"
+#include "third_party/murmurhash/murmurhash32.h"
 #include "tests/test_utils.h"
 
 namespace sparkcolumnarplugin {
@@ -41,5 +43,34 @@ TEST(TestArrowCompute, BooleanArrayTest) {
     }
   }
 }
+
+TEST(TestArrowCompute, Murmur3HashArraysTest) {
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+  auto sch = arrow::schema({field("int_col", arrow::int64()),
+                            field("str_col", arrow::utf8()),
+                            field("double_col", arrow::float64())});
+  std::vector<std::string> input_data = {
+      "[1, -2, null, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17]",
+      R"(["a", "bb", "ccc", null, "eeeee", "f", "g", "h", "i", "j", "k", "l", "m",
+          "nnnnnnnnn", "o", "p", "q"])",
+      "[0.5, 1.5, 2.5, 3.5, null, 5.5, 6.5, 7.5, 8.5, 9.5, 10.5, 11.5, 12.5, 13.5, "
+      "14.5, 15.5, 16.5]"};
+  MakeInputBatch(input_data, sch, &input_batch);
+
+  std::shared_ptr<arrow::Array> out;
+  ASSERT_NOT_OK(precompile::Murmur3HashArrays(arrow::default_memory_pool(),
+                                              input_batch->columns(), &out));
+  auto hashes = std::dynamic_pointer_cast<arrow::Int32Array>(out);
+  auto int_arr = std::dynamic_pointer_cast<arrow::Int64Array>(input_batch->column(0));
+  auto str_arr = std::dynamic_pointer_cast<arrow::StringArray>(input_batch->column(1));
+  auto dbl_arr = std::dynamic_pointer_cast<arrow::DoubleArray>(input_batch->column(2));
+  for (int i = 0; i < input_batch->num_rows(); i++) {
+    using thirdparty::murmurhash32::hash32;
+    int32_t expected = hash32(int_arr->Value(i), int_arr->IsValid(i), 0);
+    expected = hash32(str_arr->GetString(i), str_arr->IsValid(i), expected);
+    expected = hash32(dbl_arr->Value(i), dbl_arr->IsValid(i), expected);
+    ASSERT_EQ(hashes->Value(i), expected);
+  }
+}
 }  // namespace codegen
-}  // namespace sparkcolumnarplugin
\ No newline at end of file
+}  // namespace sparkcolumnarplugin
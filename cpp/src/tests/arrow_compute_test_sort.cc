@@ -16,14 +16,27 @@
  */
 
 #include <arrow/array.h>
+#include <arrow/array/concatenate.h>
+#include <arrow/builder.h>
+#include <arrow/buffer.h>
 #include <arrow/ipc/json_simple.h>
+#include <arrow/memory_pool.h>
 #include <arrow/record_batch.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include "codegen/arrow_compute/ext/array_appender.h"
+#include "codegen/arrow_compute/ext/array_gather.h"
+#include "codegen/arrow_compute/ext/parallel_sort.h"
 #include "codegen/code_generator.h"
 #include "codegen/code_generator_factory.h"
+#include "codegen/common/operator_memory_pool.h"
+#include "codegen/common/sort_relation.h"
 #include "tests/test_utils.h"
 
 namespace sparkcolumnarplugin {
@@ -1826,5 +1839,920 @@ TEST(TestArrowComputeSort, SortTestMultipleKeysNaNWithoutCodegen) {
   }
 }
 
+TEST(TestArrowComputeSort, SortTestMultipleKeysLongStringWithoutCodegen) {
+  ////////////////////// prepare expr_vector ///////////////////////
+  auto f0 = field("f0", utf8());
+  auto f1 = field("f1", int32());
+  auto f2 = field("f2", float64());
+  auto arg_0 = TreeExprBuilder::MakeField(f0);
+  auto arg_1 = TreeExprBuilder::MakeField(f1);
+  auto true_literal = TreeExprBuilder::MakeLiteral(true);
+  auto false_literal = TreeExprBuilder::MakeLiteral(false);
+  auto f_res = field("res", uint32());
+
+  auto n_key_func = TreeExprBuilder::MakeFunction(
+      "key_function", {arg_0, arg_1}, uint32());
+  auto n_key_field = TreeExprBuilder::MakeFunction(
+      "key_field", {arg_0, arg_1}, uint32());
+  auto n_dir = TreeExprBuilder::MakeFunction(
+      "sort_directions", {true_literal, false_literal}, uint32());
+  auto n_nulls_order = TreeExprBuilder::MakeFunction(
+      "sort_nulls_order", {false_literal, true_literal}, uint32());
+  auto NaN_check = TreeExprBuilder::MakeFunction(
+      "NaN_check", {true_literal}, uint32());
+  auto do_codegen = TreeExprBuilder::MakeFunction(
+      "codegen", {false_literal}, uint32());
+  auto n_sort_to_indices = TreeExprBuilder::MakeFunction(
+      "sortArraysToIndices", 
+      {n_key_func, n_key_field, n_dir, n_nulls_order, NaN_check, do_codegen}, uint32());
+  auto n_sort = TreeExprBuilder::MakeFunction(
+      "standalone", {n_sort_to_indices}, uint32());
+  auto sortArrays_expr = TreeExprBuilder::MakeExpression(n_sort, f_res);
+
+  auto sch = arrow::schema({f0, f1, f2});
+  std::vector<std::shared_ptr<Field>> ret_types = {f0, f1, f2};
+  ///////////////////// Calculation //////////////////
+  std::shared_ptr<CodeGenerator> sort_expr;
+  arrow::compute::FunctionContext ctx;
+  ASSERT_NOT_OK(CreateCodeGenerator(
+      ctx.memory_pool(), sch, {sortArrays_expr}, ret_types, &sort_expr, true));
+
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> input_batch_list;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> dummy_result_batches;
+
+  // strings longer than the normalized key prefix are ordered by the comparator
+  std::vector<std::string> input_data_string = {
+      R"(["abcdefghijklmnopqrstB", "x", null, "abcdefghijklmnopqrstA",
+          "abcdefghijklmnopqrstB", "x"])",
+      "[1, 5, 3, null, 2, null]", "[1, 2, 3, 4, 5, 6]"};
+  MakeInputBatch(input_data_string, sch, &input_batch);
+  input_batch_list.push_back(input_batch);
+
+  std::vector<std::string> input_data_string_2 = {
+      R"(["abcdefghijklmnopqrstA", null, "abc", "x", "abcdefghijklmnopqrstB"])",
+      "[7, 0, 9, 5, 1]", "[7, 8, 9, 10, 11]"};
+  MakeInputBatch(input_data_string_2, sch, &input_batch);
+  input_batch_list.push_back(input_batch);
+
+  ////////////////////////////////// calculation ///////////////////////////////////
+  std::shared_ptr<arrow::RecordBatch> expected_result;
+  std::vector<std::string> expected_result_string = {
+      R"(["abc", "abcdefghijklmnopqrstA", "abcdefghijklmnopqrstA",
+          "abcdefghijklmnopqrstB", "abcdefghijklmnopqrstB", "abcdefghijklmnopqrstB",
+          "x", "x", "x", null, null])",
+      "[9, null, 7, 2, 1, 1, null, 5, 5, 3, 0]", "[9, 4, 7, 5, 1, 11, 6, 2, 10, 3, 8]"};
+  MakeInputBatch(expected_result_string, sch, &expected_result);
+
+  for (auto batch : input_batch_list) {
+    ASSERT_NOT_OK(sort_expr->evaluate(batch, &dummy_result_batches));
+  }
+  std::shared_ptr<ResultIterator<arrow::RecordBatch>> sort_result_iterator;
+  std::shared_ptr<ResultIteratorBase> sort_result_iterator_base;
+  ASSERT_NOT_OK(sort_expr->finish(&sort_result_iterator_base));
+  sort_result_iterator = std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+      sort_result_iterator_base);
+
+  std::shared_ptr<arrow::RecordBatch> result_batch;
+  ASSERT_TRUE(sort_result_iterator->HasNext());
+  ASSERT_NOT_OK(sort_result_iterator->Next(&result_batch));
+  ASSERT_NOT_OK(Equals(*expected_result.get(), *result_batch.get()));
+}
+
+TEST(TestArrowComputeSort, SortTestMultipleKeysTopK) {
+  ////////////////////// prepare expr_vector ///////////////////////
+  auto f0 = field("f0", utf8());
+  auto f1 = field("f1", int32());
+  auto f2 = field("f2", float64());
+  auto arg_0 = TreeExprBuilder::MakeField(f0);
+  auto arg_1 = TreeExprBuilder::MakeField(f1);
+  auto true_literal = TreeExprBuilder::MakeLiteral(true);
+  auto false_literal = TreeExprBuilder::MakeLiteral(false);
+  auto f_res = field("res", uint32());
+
+  auto n_key_func = TreeExprBuilder::MakeFunction(
+      "key_function", {arg_0, arg_1}, uint32());
+  auto n_key_field = TreeExprBuilder::MakeFunction(
+      "key_field", {arg_0, arg_1}, uint32());
+  auto n_dir = TreeExprBuilder::MakeFunction(
+      "sort_directions", {true_literal, false_literal}, uint32());
+  auto n_nulls_order = TreeExprBuilder::MakeFunction(
+      "sort_nulls_order", {false_literal, true_literal}, uint32());
+  auto NaN_check = TreeExprBuilder::MakeFunction(
+      "NaN_check", {true_literal}, uint32());
+  auto do_codegen = TreeExprBuilder::MakeFunction(
+      "codegen", {false_literal}, uint32());
+  auto n_limit = TreeExprBuilder::MakeFunction(
+      "sort_limit", {TreeExprBuilder::MakeLiteral((int)4)}, uint32());
+  auto n_sort_to_indices = TreeExprBuilder::MakeFunction(
+      "sortArraysToIndices",
+      {n_key_func, n_key_field, n_dir, n_nulls_order, NaN_check, do_codegen, n_limit},
+      uint32());
+  auto n_sort = TreeExprBuilder::MakeFunction(
+      "standalone", {n_sort_to_indices}, uint32());
+  auto sortArrays_expr = TreeExprBuilder::MakeExpression(n_sort, f_res);
+
+  auto sch = arrow::schema({f0, f1, f2});
+  std::vector<std::shared_ptr<Field>> ret_types = {f0, f1, f2};
+  ///////////////////// Calculation //////////////////
+  std::shared_ptr<CodeGenerator> sort_expr;
+  arrow::compute::FunctionContext ctx;
+  ASSERT_NOT_OK(CreateCodeGenerator(
+      ctx.memory_pool(), sch, {sortArrays_expr}, ret_types, &sort_expr, true));
+
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> input_batch_list;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> dummy_result_batches;
+
+  std::vector<std::string> input_data_string = {
+      R"(["b", "a", null, "c"])", "[1, 2, 3, 4]", "[1, 2, 3, 4]"};
+  MakeInputBatch(input_data_string, sch, &input_batch);
+  input_batch_list.push_back(input_batch);
+
+  std::vector<std::string> input_data_string_2 = {
+      R"(["a", "a", "d"])", "[5, null, 6]", "[5, 6, 7]"};
+  MakeInputBatch(input_data_string_2, sch, &input_batch);
+  input_batch_list.push_back(input_batch);
+
+  // every row is after the 4th row so far
+  std::vector<std::string> input_data_string_3 = {
+      R"(["e", null, "f"])", "[1, 2, 3]", "[8, 9, 10]"};
+  MakeInputBatch(input_data_string_3, sch, &input_batch);
+  input_batch_list.push_back(input_batch);
+
+  ////////////////////////////////// calculation ///////////////////////////////////
+  std::shared_ptr<arrow::RecordBatch> expected_result;
+  std::vector<std::string> expected_result_string = {
+      R"(["a", "a", "a", "b"])", "[null, 5, 2, 1]", "[6, 5, 2, 1]"};
+  MakeInputBatch(expected_result_string, sch, &expected_result);
+
+  for (auto batch : input_batch_list) {
+    ASSERT_NOT_OK(sort_expr->evaluate(batch, &dummy_result_batches));
+  }
+  std::shared_ptr<ResultIterator<arrow::RecordBatch>> sort_result_iterator;
+  std::shared_ptr<ResultIteratorBase> sort_result_iterator_base;
+  ASSERT_NOT_OK(sort_expr->finish(&sort_result_iterator_base));
+  sort_result_iterator = std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+      sort_result_iterator_base);
+
+  std::shared_ptr<arrow::RecordBatch> result_batch;
+  ASSERT_TRUE(sort_result_iterator->HasNext());
+  ASSERT_NOT_OK(sort_result_iterator->Next(&result_batch));
+  ASSERT_NOT_OK(Equals(*expected_result.get(), *result_batch.get()));
+  ASSERT_FALSE(sort_result_iterator->HasNext());
+}
+
+TEST(TestArrowComputeSort, SortTestTopKSkipsBatches) {
+  // heap is selected every 2 * 4 retained rows, batches after its top are then dropped
+  ScopedEnv batch_size("NATIVESQL_BATCH_SIZE", "4");
+  auto f0 = field("f0", float64());
+  auto f1 = field("f1", int32());
+  auto arg_0 = TreeExprBuilder::MakeField(f0);
+  auto true_literal = TreeExprBuilder::MakeLiteral(true);
+  auto false_literal = TreeExprBuilder::MakeLiteral(false);
+  auto f_res = field("res", uint32());
+
+  auto n_key_func = TreeExprBuilder::MakeFunction("key_function", {arg_0}, uint32());
+  auto n_key_field = TreeExprBuilder::MakeFunction("key_field", {arg_0}, uint32());
+  auto n_dir = TreeExprBuilder::MakeFunction("sort_directions", {true_literal}, uint32());
+  auto n_nulls_order =
+      TreeExprBuilder::MakeFunction("sort_nulls_order", {false_literal}, uint32());
+  auto NaN_check = TreeExprBuilder::MakeFunction("NaN_check", {true_literal}, uint32());
+  auto do_codegen = TreeExprBuilder::MakeFunction("codegen", {false_literal}, uint32());
+  auto n_limit = TreeExprBuilder::MakeFunction(
+      "sort_limit", {TreeExprBuilder::MakeLiteral((int)3)}, uint32());
+  auto n_sort_to_indices = TreeExprBuilder::MakeFunction(
+      "sortArraysToIndices",
+      {n_key_func, n_key_field, n_dir, n_nulls_order, NaN_check, do_codegen, n_limit},
+      uint32());
+  auto n_sort =
+      TreeExprBuilder::MakeFunction("standalone", {n_sort_to_indices}, uint32());
+  auto sortArrays_expr = TreeExprBuilder::MakeExpression(n_sort, f_res);
+
+  auto sch = arrow::schema({f0, f1});
+  std::vector<std::shared_ptr<Field>> ret_types = {f0, f1};
+  std::shared_ptr<CodeGenerator> sort_expr;
+  arrow::compute::FunctionContext ctx;
+  ASSERT_NOT_OK(CreateCodeGenerator(
+      ctx.memory_pool(), sch, {sortArrays_expr}, ret_types, &sort_expr, true));
+
+  std::vector<std::vector<std::string>> input_data_list = {
+      {"[5, 3, 9, 7]", "[10, 11, 12, 13]"},
+      {"[8, 6, null, 4]", "[20, 21, 22, 23]"},
+      // after the 3rd row 5, dropped
+      {"[10, 11, null, 12]", "[30, 31, 32, 33]"},
+      // NaN and a tie with the 3rd row are kept
+      {"[NaN, 6, 5, 20]", "[40, 41, 42, 43]"},
+      {"[1, 100, 2, 50]", "[50, 51, 52, 53]"},
+      // after the 3rd row 3, dropped
+      {"[4, 4, 4, 4]", "[60, 61, 62, 63]"}};
+  std::vector<std::shared_ptr<arrow::RecordBatch>> dummy_result_batches;
+  for (auto& input_data : input_data_list) {
+    std::shared_ptr<arrow::RecordBatch> input_batch;
+    MakeInputBatch(input_data, sch, &input_batch);
+    ASSERT_NOT_OK(sort_expr->evaluate(input_batch, &dummy_result_batches));
+  }
+
+  std::shared_ptr<arrow::RecordBatch> expected_result;
+  MakeInputBatch({"[1, 2, 3]", "[50, 52, 11]"}, sch, &expected_result);
+
+  std::shared_ptr<ResultIteratorBase> sort_result_iterator_base;
+  ASSERT_NOT_OK(sort_expr->finish(&sort_result_iterator_base));
+  auto sort_result_iterator =
+      std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+          sort_result_iterator_base);
+
+  std::shared_ptr<arrow::RecordBatch> result_batch;
+  ASSERT_TRUE(sort_result_iterator->HasNext());
+  ASSERT_NOT_OK(sort_result_iterator->Next(&result_batch));
+  ASSERT_NOT_OK(Equals(*expected_result.get(), *result_batch.get()));
+  ASSERT_FALSE(sort_result_iterator->HasNext());
+}
+
+TEST(TestArrowComputeSort, ArrayGatherNullsStringsAndBooleans) {
+  using arrowcompute::extra::AppenderBase;
+  using arrowcompute::extra::ArrayGatherer;
+  using arrowcompute::extra::ArrayItemIndexS;
+  using arrowcompute::extra::GatherArrays;
+  using arrowcompute::extra::MakeAppender;
+  using arrowcompute::extra::MakeArrayGatherer;
+  // per type: no nulls, some nulls, all nulls, and one sliced by a row below
+  std::vector<std::pair<std::shared_ptr<arrow::DataType>, std::vector<std::string>>>
+      columns = {
+          {int64(),
+           {"[1, 2, 3, 4, 5]", "[null, 7, null, 9]", "[null, null]",
+            "[10, 11, null, 13, 14]"}},
+          {float64(),
+           {"[1.5, 2.5, 3.5, 4.5, 5.5]", "[null, 7.5, null, 9.5]", "[null, null]",
+            "[10.5, 11.5, null, 13.5, 14.5]"}},
+          {boolean(),
+           {"[true, false, true, true, false]", "[null, false, null, true]",
+            "[null, null]", "[true, true, null, false, true]"}},
+          {utf8(),
+           {R"(["a", "bb", "", "dddd", "e"])", R"([null, "ff", null, "hhh"])",
+            "[null, null]", R"(["i", "jj", null, "", "mmmmm"])"}},
+          {date32(),
+           {"[1, 2, 3, 4, 5]", "[null, 7, null, 9]", "[null, null]",
+            "[10, 11, null, 13, 14]"}}};
+  std::vector<int> lengths = {5, 4, 2, 4};
+
+  // more rows than a gather block, every cached array is visited in turn
+  std::vector<ArrayItemIndexS> indices;
+  for (int i = 0; i < 3000; i++) {
+    int array_id = i % 4;
+    indices.emplace_back(array_id, (i * 7 + i / 4) % lengths[array_id]);
+  }
+
+  arrow::compute::FunctionContext ctx;
+  for (auto& column : columns) {
+    auto type = column.first;
+    std::shared_ptr<ArrayGatherer> gatherer;
+    std::shared_ptr<AppenderBase> appender;
+    ASSERT_NOT_OK(MakeArrayGatherer(ctx.memory_pool(), type, &gatherer));
+    ASSERT_NOT_OK(MakeAppender(&ctx, type, AppenderBase::left, &appender));
+    for (int i = 0; i < column.second.size(); i++) {
+      std::shared_ptr<arrow::Array> array;
+      ASSERT_NOT_OK(arrow::ipc::internal::json::ArrayFromJSON(
+          type, column.second[i].c_str(), &array));
+      if (i == 3) array = array->Slice(1);
+      gatherer->AddArray(array);
+      ASSERT_NOT_OK(appender->AddArray(array));
+    }
+
+    std::vector<std::shared_ptr<arrow::Array>> gathered;
+    ASSERT_NOT_OK(GatherArrays({gatherer}, indices.data(), indices.size(), &gathered));
+    for (auto& index : indices) {
+      ASSERT_NOT_OK(appender->Append(index.array_id, index.id));
+    }
+    std::shared_ptr<arrow::Array> appended;
+    ASSERT_NOT_OK(appender->Finish(&appended));
+
+    auto sch = arrow::schema({field("f", type)});
+    auto expected = arrow::RecordBatch::Make(sch, indices.size(), {appended});
+    auto actual = arrow::RecordBatch::Make(sch, indices.size(), gathered);
+    ASSERT_NOT_OK(Equals(*expected.get(), *actual.get()));
+  }
+
+  // strings of the sliced array start from its offset
+  std::shared_ptr<ArrayGatherer> gatherer;
+  ASSERT_NOT_OK(MakeArrayGatherer(ctx.memory_pool(), utf8(), &gatherer));
+  for (int i = 0; i < columns[3].second.size(); i++) {
+    std::shared_ptr<arrow::Array> array;
+    ASSERT_NOT_OK(arrow::ipc::internal::json::ArrayFromJSON(
+        utf8(), columns[3].second[i].c_str(), &array));
+    if (i == 3) array = array->Slice(1);
+    gatherer->AddArray(array);
+  }
+  std::vector<ArrayItemIndexS> string_indices = {{1, 1}, {3, 0}, {0, 3}, {2, 1}, {3, 1}};
+  std::vector<std::shared_ptr<arrow::Array>> gathered;
+  ASSERT_NOT_OK(GatherArrays({gatherer}, string_indices.data(), string_indices.size(),
+                             &gathered));
+  auto sch = arrow::schema({field("f", utf8())});
+  std::shared_ptr<arrow::RecordBatch> expected;
+  MakeInputBatch({R"(["ff", "jj", "dddd", null, null])"}, sch, &expected);
+  auto actual = arrow::RecordBatch::Make(sch, string_indices.size(), gathered);
+  ASSERT_NOT_OK(Equals(*expected.get(), *actual.get()));
+}
+
+TEST(TestArrowComputeSort, SortTestMultipleKeysSortRelation) {
+  ////////////////////// prepare expr_vector ///////////////////////
+  auto f0 = field("f0", utf8());
+  auto f1 = field("f1", int32());
+  auto f2 = field("f2", float64());
+  auto arg_0 = TreeExprBuilder::MakeField(f0);
+  auto arg_1 = TreeExprBuilder::MakeField(f1);
+  auto true_literal = TreeExprBuilder::MakeLiteral(true);
+  auto false_literal = TreeExprBuilder::MakeLiteral(false);
+  auto f_res = field("res", uint32());
+
+  auto n_key_func = TreeExprBuilder::MakeFunction(
+      "key_function", {arg_0, arg_1}, uint32());
+  auto n_key_field = TreeExprBuilder::MakeFunction(
+      "key_field", {arg_0, arg_1}, uint32());
+  auto n_dir = TreeExprBuilder::MakeFunction(
+      "sort_directions", {true_literal, true_literal}, uint32());
+  auto n_nulls_order = TreeExprBuilder::MakeFunction(
+      "sort_nulls_order", {true_literal, true_literal}, uint32());
+  auto NaN_check = TreeExprBuilder::MakeFunction(
+      "NaN_check", {true_literal}, uint32());
+  // a SortRelation is never built by codegen sort, the request is ignored
+  auto do_codegen = TreeExprBuilder::MakeFunction(
+      "codegen", {true_literal}, uint32());
+  auto n_result_type = TreeExprBuilder::MakeFunction(
+      "result_type", {TreeExprBuilder::MakeLiteral((int)1)}, uint32());
+  auto n_sort_to_indices = TreeExprBuilder::MakeFunction(
+      "sortArraysToIndices",
+      {n_key_func, n_key_field, n_dir, n_nulls_order, NaN_check, do_codegen,
+       n_result_type},
+      uint32());
+  auto n_sort = TreeExprBuilder::MakeFunction(
+      "standalone", {n_sort_to_indices}, uint32());
+  auto sortArrays_expr = TreeExprBuilder::MakeExpression(n_sort, f_res);
+
+  auto sch = arrow::schema({f0, f1, f2});
+  std::vector<std::shared_ptr<Field>> ret_types = {f0, f1, f2};
+  ///////////////////// Calculation //////////////////
+  std::shared_ptr<CodeGenerator> sort_expr;
+  arrow::compute::FunctionContext ctx;
+  ASSERT_NOT_OK(CreateCodeGenerator(
+      ctx.memory_pool(), sch, {sortArrays_expr}, ret_types, &sort_expr, true));
+
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> input_batch_list;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> dummy_result_batches;
+
+  std::vector<std::string> input_data_string = {
+      R"(["b", "a", "b", "a"])", "[1, 2, 1, 2]", "[1, 2, 3, 4]"};
+  MakeInputBatch(input_data_string, sch, &input_batch);
+  input_batch_list.push_back(input_batch);
+
+  std::vector<std::string> input_data_string_2 = {
+      R"(["a", "c"])", "[1, 2]", "[5, 6]"};
+  MakeInputBatch(input_data_string_2, sch, &input_batch);
+  input_batch_list.push_back(input_batch);
+
+  ////////////////////////////////// calculation ///////////////////////////////////
+  for (auto batch : input_batch_list) {
+    ASSERT_NOT_OK(sort_expr->evaluate(batch, &dummy_result_batches));
+  }
+  std::shared_ptr<ResultIterator<SortRelation>> sort_result_iterator;
+  std::shared_ptr<ResultIteratorBase> sort_result_iterator_base;
+  ASSERT_NOT_OK(sort_expr->finish(&sort_result_iterator_base));
+  sort_result_iterator = std::dynamic_pointer_cast<ResultIterator<SortRelation>>(
+      sort_result_iterator_base);
+  ASSERT_TRUE(sort_result_iterator != nullptr);
+
+  std::shared_ptr<SortRelation> sort_relation;
+  ASSERT_NOT_OK(sort_result_iterator->Next(&sort_relation));
+  std::shared_ptr<TypedRelationColumn<arrow::StringType>> key_col;
+  std::shared_ptr<TypedRelationColumn<arrow::DoubleType>> payload_col;
+  ASSERT_NOT_OK(sort_relation->GetColumn(0, &key_col));
+  ASSERT_NOT_OK(sort_relation->GetColumn(2, &payload_col));
+
+  // rows of the same keys may come in any order, so payload is checked by sum
+  std::vector<std::string> expected_keys = {"a", "a", "b", "c"};
+  std::vector<int> expected_ranges = {1, 2, 2, 1};
+  std::vector<double> expected_sums = {5, 6, 4, 6};
+  for (int i = 0; i < expected_keys.size(); i++) {
+    auto range = sort_relation->GetSameKeyRange();
+    ASSERT_EQ(range, expected_ranges[i]);
+    double sum = 0;
+    for (int j = 0; j < range; j++) {
+      auto item = sort_relation->GetItemIndexWithShift(j);
+      ASSERT_EQ(key_col->GetValue(item.array_id, item.id), expected_keys[i]);
+      sum += payload_col->GetValue(item.array_id, item.id);
+    }
+    ASSERT_EQ(sum, expected_sums[i]);
+    ASSERT_EQ(sort_relation->NextNewKey(), i + 1 < expected_keys.size());
+  }
+}
+
+TEST(TestArrowComputeSort, SortTestOneKeyStrDictionary) {
+  ////////////////////// prepare expr_vector ///////////////////////
+  auto f0 = field("f0", utf8());
+  auto arg_0 = TreeExprBuilder::MakeField(f0);
+  auto true_literal = TreeExprBuilder::MakeLiteral(true);
+  auto false_literal = TreeExprBuilder::MakeLiteral(false);
+  auto f_res = field("res", uint32());
+
+  auto n_key_func = TreeExprBuilder::MakeFunction(
+      "key_function", {arg_0}, uint32());
+  auto n_key_field = TreeExprBuilder::MakeFunction(
+      "key_field", {arg_0}, uint32());
+  auto n_dir = TreeExprBuilder::MakeFunction(
+      "sort_directions", {false_literal}, uint32());
+  auto n_nulls_order = TreeExprBuilder::MakeFunction(
+      "sort_nulls_order", {false_literal}, uint32());
+  auto NaN_check = TreeExprBuilder::MakeFunction(
+      "NaN_check", {true_literal}, uint32());
+  auto do_codegen = TreeExprBuilder::MakeFunction(
+      "codegen", {false_literal}, uint32());
+  auto n_sort_to_indices = TreeExprBuilder::MakeFunction(
+      "sortArraysToIndices",
+      {n_key_func, n_key_field, n_dir, n_nulls_order, NaN_check, do_codegen}, uint32());
+  auto n_sort = TreeExprBuilder::MakeFunction(
+      "standalone", {n_sort_to_indices}, uint32());
+  auto sortArrays_expr = TreeExprBuilder::MakeExpression(n_sort, f_res);
+
+  auto sch = arrow::schema({f0});
+  std::vector<std::shared_ptr<Field>> ret_types = {f0};
+  ///////////////////// Calculation //////////////////
+  std::shared_ptr<CodeGenerator> sort_expr;
+  arrow::compute::FunctionContext ctx;
+  ASSERT_NOT_OK(CreateCodeGenerator(
+      ctx.memory_pool(), sch, {sortArrays_expr}, ret_types, &sort_expr, true));
+
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> input_batch_list;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> dummy_result_batches;
+
+  // few distinct values, so the key is sorted by its dictionary codes
+  std::vector<std::string> input_data_string = {
+      R"(["us", "cn", null, "us", "cn", "us", "cn", "us"])"};
+  MakeInputBatch(input_data_string, sch, &input_batch);
+  input_batch_list.push_back(input_batch);
+
+  std::vector<std::string> input_data_string_2 = {
+      R"(["cn", "us", "cn", null, "us", "cn", "us", "cn"])"};
+  MakeInputBatch(input_data_string_2, sch, &input_batch);
+  input_batch_list.push_back(input_batch);
+
+  ////////////////////////////////// calculation ///////////////////////////////////
+  std::shared_ptr<arrow::RecordBatch> expected_result;
+  std::vector<std::string> expected_result_string = {
+      R"(["us", "us", "us", "us", "us", "us", "us", "cn", "cn", "cn", "cn", "cn", "cn",
+          "cn", null, null])"};
+  MakeInputBatch(expected_result_string, sch, &expected_result);
+
+  for (auto batch : input_batch_list) {
+    ASSERT_NOT_OK(sort_expr->evaluate(batch, &dummy_result_batches));
+  }
+  std::shared_ptr<ResultIterator<arrow::RecordBatch>> sort_result_iterator;
+  std::shared_ptr<ResultIteratorBase> sort_result_iterator_base;
+  ASSERT_NOT_OK(sort_expr->finish(&sort_result_iterator_base));
+  sort_result_iterator = std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+      sort_result_iterator_base);
+
+  std::shared_ptr<arrow::RecordBatch> result_batch;
+  ASSERT_TRUE(sort_result_iterator->HasNext());
+  ASSERT_NOT_OK(sort_result_iterator->Next(&result_batch));
+  ASSERT_NOT_OK(Equals(*expected_result.get(), *result_batch.get()));
+}
+
+TEST(TestArrowComputeSort, SortTestMultipleKeysStrDictionary) {
+  ////////////////////// prepare expr_vector ///////////////////////
+  auto f0 = field("f0", utf8());
+  auto f1 = field("f1", int32());
+  auto f2 = field("f2", float64());
+  auto arg_0 = TreeExprBuilder::MakeField(f0);
+  auto arg_1 = TreeExprBuilder::MakeField(f1);
+  auto true_literal = TreeExprBuilder::MakeLiteral(true);
+  auto false_literal = TreeExprBuilder::MakeLiteral(false);
+  auto f_res = field("res", uint32());
+
+  auto sch = arrow::schema({f0, f1, f2});
+  std::vector<std::shared_ptr<Field>> ret_types = {f0, f1, f2};
+
+  // few distinct values of f0, so it is compared by its dictionary codes
+  std::vector<std::string> input_data_string = {
+      R"(["b", "a", "b", "a", "b", "a", "b", "a"])", "[8, 7, 6, 5, 4, 3, 2, 1]",
+      "[1, 2, 3, 4, 5, 6, 7, 8]"};
+  std::vector<std::string> input_data_string_2 = {
+      R"(["a", "b", null, "a", "b", "a", "b", "a"])",
+      "[9, 10, 11, 12, 13, 14, 15, 16]", "[9, 10, 11, 12, 13, 14, 15, 16]"};
+  std::vector<std::string> expected_result_string = {
+      R"(["b", "b", "b", "b", "b", "b", "b", "a", "a", "a", "a", "a", "a", "a", "a",
+          null])",
+      "[2, 4, 6, 8, 10, 13, 15, 1, 3, 5, 7, 9, 12, 14, 16, 11]",
+      "[7, 5, 3, 1, 10, 13, 15, 8, 6, 4, 2, 9, 12, 14, 16, 11]"};
+  std::shared_ptr<arrow::RecordBatch> expected_result;
+  MakeInputBatch(expected_result_string, sch, &expected_result);
+
+  for (auto codegen : {true, false}) {
+    auto n_key_func = TreeExprBuilder::MakeFunction(
+        "key_function", {arg_0, arg_1}, uint32());
+    auto n_key_field = TreeExprBuilder::MakeFunction(
+        "key_field", {arg_0, arg_1}, uint32());
+    auto n_dir = TreeExprBuilder::MakeFunction(
+        "sort_directions", {false_literal, true_literal}, uint32());
+    auto n_nulls_order = TreeExprBuilder::MakeFunction(
+        "sort_nulls_order", {false_literal, true_literal}, uint32());
+    auto NaN_check = TreeExprBuilder::MakeFunction(
+        "NaN_check", {true_literal}, uint32());
+    auto do_codegen = TreeExprBuilder::MakeFunction(
+        "codegen", {TreeExprBuilder::MakeLiteral(codegen)}, uint32());
+    auto n_sort_to_indices = TreeExprBuilder::MakeFunction(
+        "sortArraysToIndices",
+        {n_key_func, n_key_field, n_dir, n_nulls_order, NaN_check, do_codegen},
+        uint32());
+    auto n_sort = TreeExprBuilder::MakeFunction(
+        "standalone", {n_sort_to_indices}, uint32());
+    auto sortArrays_expr = TreeExprBuilder::MakeExpression(n_sort, f_res);
+    ///////////////////// Calculation //////////////////
+    std::shared_ptr<CodeGenerator> sort_expr;
+    arrow::compute::FunctionContext ctx;
+    ASSERT_NOT_OK(CreateCodeGenerator(
+        ctx.memory_pool(), sch, {sortArrays_expr}, ret_types, &sort_expr, true));
+
+    std::shared_ptr<arrow::RecordBatch> input_batch;
+    std::vector<std::shared_ptr<arrow::RecordBatch>> dummy_result_batches;
+    MakeInputBatch(input_data_string, sch, &input_batch);
+    ASSERT_NOT_OK(sort_expr->evaluate(input_batch, &dummy_result_batches));
+    MakeInputBatch(input_data_string_2, sch, &input_batch);
+    ASSERT_NOT_OK(sort_expr->evaluate(input_batch, &dummy_result_batches));
+
+    std::shared_ptr<ResultIterator<arrow::RecordBatch>> sort_result_iterator;
+    std::shared_ptr<ResultIteratorBase> sort_result_iterator_base;
+    ASSERT_NOT_OK(sort_expr->finish(&sort_result_iterator_base));
+    sort_result_iterator = std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+        sort_result_iterator_base);
+
+    std::shared_ptr<arrow::RecordBatch> result_batch;
+    ASSERT_TRUE(sort_result_iterator->HasNext());
+    ASSERT_NOT_OK(sort_result_iterator->Next(&result_batch));
+    ASSERT_NOT_OK(Equals(*expected_result.get(), *result_batch.get()));
+  }
+}
+
+TEST(TestArrowComputeSort, SortTestMultipleKeysPreSortedBatches) {
+  ////////////////////// prepare expr_vector ///////////////////////
+  auto f0 = field("f0", int32());
+  auto f1 = field("f1", int32());
+  auto f2 = field("f2", float64());
+  auto arg_0 = TreeExprBuilder::MakeField(f0);
+  auto arg_1 = TreeExprBuilder::MakeField(f1);
+  auto true_literal = TreeExprBuilder::MakeLiteral(true);
+  auto false_literal = TreeExprBuilder::MakeLiteral(false);
+  auto f_res = field("res", uint32());
+
+  auto n_key_func = TreeExprBuilder::MakeFunction(
+      "key_function", {arg_0, arg_1}, uint32());
+  auto n_key_field = TreeExprBuilder::MakeFunction(
+      "key_field", {arg_0, arg_1}, uint32());
+  auto n_dir = TreeExprBuilder::MakeFunction(
+      "sort_directions", {true_literal, false_literal}, uint32());
+  auto n_nulls_order = TreeExprBuilder::MakeFunction(
+      "sort_nulls_order", {true_literal, true_literal}, uint32());
+  auto NaN_check = TreeExprBuilder::MakeFunction(
+      "NaN_check", {true_literal}, uint32());
+  auto do_codegen = TreeExprBuilder::MakeFunction(
+      "codegen", {false_literal}, uint32());
+  auto n_sort_to_indices = TreeExprBuilder::MakeFunction(
+      "sortArraysToIndices",
+      {n_key_func, n_key_field, n_dir, n_nulls_order, NaN_check, do_codegen}, uint32());
+  auto n_sort = TreeExprBuilder::MakeFunction(
+      "standalone", {n_sort_to_indices}, uint32());
+  auto sortArrays_expr = TreeExprBuilder::MakeExpression(n_sort, f_res);
+
+  auto sch = arrow::schema({f0, f1, f2});
+  std::vector<std::shared_ptr<Field>> ret_types = {f0, f1, f2};
+  ///////////////////// Calculation //////////////////
+  std::shared_ptr<CodeGenerator> sort_expr;
+  arrow::compute::FunctionContext ctx;
+  ASSERT_NOT_OK(CreateCodeGenerator(
+      ctx.memory_pool(), sch, {sortArrays_expr}, ret_types, &sort_expr, true));
+
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> input_batch_list;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> dummy_result_batches;
+
+  // every batch is in sort order, so batches are only merged
+  std::vector<std::string> input_data_string = {
+      "[1, 1, 3, 5]", "[9, 2, 4, 4]", "[1, 2, 3, 4]"};
+  MakeInputBatch(input_data_string, sch, &input_batch);
+  input_batch_list.push_back(input_batch);
+
+  std::vector<std::string> input_data_string_2 = {
+      "[null, 2, 3, 3]", "[1, 7, 8, 1]", "[5, 6, 7, 8]"};
+  MakeInputBatch(input_data_string_2, sch, &input_batch);
+  input_batch_list.push_back(input_batch);
+
+  std::vector<std::string> input_data_string_3 = {
+      "[1, 4, 5]", "[5, 0, 6]", "[9, 10, 11]"};
+  MakeInputBatch(input_data_string_3, sch, &input_batch);
+  input_batch_list.push_back(input_batch);
+
+  ////////////////////////////////// calculation ///////////////////////////////////
+  std::shared_ptr<arrow::RecordBatch> expected_result;
+  std::vector<std::string> expected_result_string = {
+      "[null, 1, 1, 1, 2, 3, 3, 3, 4, 5, 5]", "[1, 9, 5, 2, 7, 8, 4, 1, 0, 6, 4]",
+      "[5, 1, 9, 2, 6, 7, 3, 8, 10, 11, 4]"};
+  MakeInputBatch(expected_result_string, sch, &expected_result);
+
+  for (auto batch : input_batch_list) {
+    ASSERT_NOT_OK(sort_expr->evaluate(batch, &dummy_result_batches));
+  }
+  std::shared_ptr<ResultIterator<arrow::RecordBatch>> sort_result_iterator;
+  std::shared_ptr<ResultIteratorBase> sort_result_iterator_base;
+  ASSERT_NOT_OK(sort_expr->finish(&sort_result_iterator_base));
+  sort_result_iterator = std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+      sort_result_iterator_base);
+
+  std::shared_ptr<arrow::RecordBatch> result_batch;
+  ASSERT_TRUE(sort_result_iterator->HasNext());
+  ASSERT_NOT_OK(sort_result_iterator->Next(&result_batch));
+  ASSERT_NOT_OK(Equals(*expected_result.get(), *result_batch.get()));
+}
+
+TEST(TestArrowComputeSort, SortTestMemoryUsage) {
+  ////////////////////// prepare expr_vector ///////////////////////
+  auto f0 = field("f0", int32());
+  auto f1 = field("f1", float64());
+  auto arg_0 = TreeExprBuilder::MakeField(f0);
+  auto true_literal = TreeExprBuilder::MakeLiteral(true);
+  auto false_literal = TreeExprBuilder::MakeLiteral(false);
+  auto f_res = field("res", uint32());
+
+  auto n_key_func = TreeExprBuilder::MakeFunction("key_function", {arg_0}, uint32());
+  auto n_key_field = TreeExprBuilder::MakeFunction("key_field", {arg_0}, uint32());
+  auto n_dir = TreeExprBuilder::MakeFunction("sort_directions", {true_literal}, uint32());
+  auto n_nulls_order =
+      TreeExprBuilder::MakeFunction("sort_nulls_order", {true_literal}, uint32());
+  auto NaN_check = TreeExprBuilder::MakeFunction("NaN_check", {true_literal}, uint32());
+  auto do_codegen = TreeExprBuilder::MakeFunction("codegen", {false_literal}, uint32());
+  auto n_sort_to_indices = TreeExprBuilder::MakeFunction(
+      "sortArraysToIndices",
+      {n_key_func, n_key_field, n_dir, n_nulls_order, NaN_check, do_codegen}, uint32());
+  auto n_sort = TreeExprBuilder::MakeFunction(
+      "standalone", {n_sort_to_indices}, uint32());
+  auto sortArrays_expr = TreeExprBuilder::MakeExpression(n_sort, f_res);
+
+  auto sch = arrow::schema({f0, f1});
+  std::vector<std::shared_ptr<Field>> ret_types = {f0, f1};
+  ///////////////////// Calculation //////////////////
+  std::shared_ptr<CodeGenerator> sort_expr;
+  arrow::compute::FunctionContext ctx;
+  ASSERT_NOT_OK(CreateCodeGenerator(
+      ctx.memory_pool(), sch, {sortArrays_expr}, ret_types, &sort_expr, true));
+
+  int64_t bytes_allocated;
+  int64_t peak_bytes;
+  ASSERT_NOT_OK(sort_expr->GetMemoryUsage(&bytes_allocated, &peak_bytes));
+  ASSERT_EQ(peak_bytes, 0);
+
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> dummy_result_batches;
+  std::vector<std::string> input_data_string = {"[10, 2, null, 7, 3]",
+                                                "[1, 2, 3, 4, 5]"};
+  MakeInputBatch(input_data_string, sch, &input_batch);
+  ASSERT_NOT_OK(sort_expr->evaluate(input_batch, &dummy_result_batches));
+
+  std::shared_ptr<ResultIteratorBase> sort_result_iterator_base;
+  ASSERT_NOT_OK(sort_expr->finish(&sort_result_iterator_base));
+  auto sort_result_iterator =
+      std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+          sort_result_iterator_base);
+  std::shared_ptr<arrow::RecordBatch> result_batch;
+  ASSERT_TRUE(sort_result_iterator->HasNext());
+  ASSERT_NOT_OK(sort_result_iterator->Next(&result_batch));
+
+  // indices and output columns are allocated by the operator, inputs are not
+  ASSERT_NOT_OK(sort_expr->GetMemoryUsage(&bytes_allocated, &peak_bytes));
+  ASSERT_GT(bytes_allocated, 0);
+  ASSERT_GE(peak_bytes, bytes_allocated);
+
+  // output may outlive the operator which allocated it
+  sort_result_iterator.reset();
+  sort_result_iterator_base.reset();
+  sort_expr.reset();
+  std::shared_ptr<arrow::RecordBatch> expected_result;
+  std::vector<std::string> expected_result_string = {"[null, 2, 3, 7, 10]",
+                                                     "[3, 2, 5, 4, 1]"};
+  MakeInputBatch(expected_result_string, sch, &expected_result);
+  ASSERT_NOT_OK(Equals(*expected_result.get(), *result_batch.get()));
+  result_batch.reset();
+}
+
+TEST(TestArrowComputeSort, OperatorMemoryPoolOutlivesOperator) {
+  auto parent = std::make_shared<arrow::ProxyMemoryPool>(arrow::default_memory_pool());
+  auto pool = OperatorMemoryPool::Make(parent.get());
+  auto iterator_pool = pool->Share();
+
+  std::shared_ptr<arrow::Buffer> output;
+  ASSERT_NOT_OK(arrow::AllocateBuffer(pool.get(), 1024, &output));
+  ASSERT_EQ(pool->bytes_allocated(), 1024);
+  ASSERT_EQ(parent->bytes_allocated(), 1024);
+
+  // operator is closed while its iterator still allocates and the JVM holds output
+  OperatorMemoryPool* raw_pool = pool.get();
+  pool.reset();
+  std::shared_ptr<arrow::ResizableBuffer> late;
+  ASSERT_NOT_OK(arrow::AllocateResizableBuffer(iterator_pool.get(), 4096, &late));
+  ASSERT_EQ(raw_pool->bytes_allocated(), 1024 + 4096);
+  ASSERT_NOT_OK(late->Resize(0));
+  iterator_pool.reset();
+  ASSERT_EQ(raw_pool->max_memory(), 1024 + 4096);
+
+  // a buffer resized to nothing still holds the pool until it is freed
+  output.reset();
+  ASSERT_EQ(parent->bytes_allocated(), 0);
+  late.reset();
+  ASSERT_EQ(parent->bytes_allocated(), 0);
+}
+
+TEST(TestArrowComputeSort, OperatorMemoryPoolConcurrentAllocations) {
+  auto parent = std::make_shared<arrow::ProxyMemoryPool>(arrow::default_memory_pool());
+  auto pool = OperatorMemoryPool::Make(parent.get());
+  const int num_threads = 4;
+  const int num_buffers = 1000;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < num_threads; t++) {
+    workers.emplace_back([&pool]() {
+      std::vector<std::shared_ptr<arrow::Buffer>> buffers;
+      for (int i = 0; i < num_buffers; i++) {
+        std::shared_ptr<arrow::Buffer> buffer;
+        if (!arrow::AllocateBuffer(pool.get(), 64, &buffer).ok()) return;
+        buffers.push_back(buffer);
+      }
+    });
+  }
+  for (auto& worker : workers) worker.join();
+  ASSERT_EQ(pool->bytes_allocated(), 0);
+  ASSERT_GE(pool->max_memory(), num_buffers * 64);
+  ASSERT_LE(pool->max_memory(), num_threads * num_buffers * 64);
+  ASSERT_EQ(parent->bytes_allocated(), 0);
+}
+
+TEST(TestArrowComputeSort, ParallelSortStableWithDuplicateKeys) {
+  using arrowcompute::extra::kMinParallelSortRows;
+  using arrowcompute::extra::ParallelSort;
+  using Row = std::pair<int32_t, int32_t>;
+  auto key_less = [](const Row& x, const Row& y) { return x.first < y.first; };
+  auto stable_sort = [&key_less](Row* begin, Row* end) {
+    std::stable_sort(begin, end, key_less);
+  };
+  // second is the input position, so equal keys have to keep it ascending
+  auto make_rows = [](int64_t length) {
+    std::vector<Row> rows;
+    for (int64_t i = 0; i < length; i++) {
+      rows.emplace_back(static_cast<int32_t>((i * 7919) % 97), static_cast<int32_t>(i));
+    }
+    return rows;
+  };
+
+  // at least two chunks of kMinParallelSortRows
+  int64_t length = 2 * kMinParallelSortRows + 12345;
+  auto expected = make_rows(length);
+  std::stable_sort(expected.begin(), expected.end(), key_less);
+  for (int num_threads : {2, 3, 4}) {
+    auto rows = make_rows(length);
+    ASSERT_NOT_OK(ParallelSort(arrow::default_memory_pool(), rows.data(),
+                               rows.data() + rows.size(), num_threads, stable_sort,
+                               key_less));
+    ASSERT_TRUE(rows == expected) << "num_threads " << num_threads;
+  }
+
+  // uneven chunk counts take a merge round with an unpaired chunk
+  length = 10007;
+  expected = make_rows(length);
+  std::stable_sort(expected.begin(), expected.end(), key_less);
+  for (int num_threads : {3, 5, 7}) {
+    auto rows = make_rows(length);
+    ASSERT_NOT_OK(ParallelSort(arrow::default_memory_pool(), rows.data(),
+                               rows.data() + rows.size(), num_threads, stable_sort,
+                               key_less, 1000));
+    ASSERT_TRUE(rows == expected) << "num_threads " << num_threads;
+  }
+}
+
+TEST(TestArrowComputeSort, SortTestMultipleKeysParallel) {
+  ////////////////////// prepare expr_vector ///////////////////////
+  auto f0 = field("f0", int32());
+  auto f1 = field("f1", int32());
+  auto f2 = field("f2", float64());
+  auto arg_0 = TreeExprBuilder::MakeField(f0);
+  auto arg_1 = TreeExprBuilder::MakeField(f1);
+  auto true_literal = TreeExprBuilder::MakeLiteral(true);
+  auto false_literal = TreeExprBuilder::MakeLiteral(false);
+  auto f_res = field("res", uint32());
+
+  auto n_key_func = TreeExprBuilder::MakeFunction(
+      "key_function", {arg_0, arg_1}, uint32());
+  auto n_key_field = TreeExprBuilder::MakeFunction(
+      "key_field", {arg_0, arg_1}, uint32());
+  auto n_dir = TreeExprBuilder::MakeFunction(
+      "sort_directions", {true_literal, false_literal}, uint32());
+  auto n_nulls_order = TreeExprBuilder::MakeFunction(
+      "sort_nulls_order", {true_literal, true_literal}, uint32());
+  auto NaN_check = TreeExprBuilder::MakeFunction(
+      "NaN_check", {true_literal}, uint32());
+  auto do_codegen = TreeExprBuilder::MakeFunction(
+      "codegen", {false_literal}, uint32());
+  auto n_sort_to_indices = TreeExprBuilder::MakeFunction(
+      "sortArraysToIndices",
+      {n_key_func, n_key_field, n_dir, n_nulls_order, NaN_check, do_codegen}, uint32());
+  auto n_sort = TreeExprBuilder::MakeFunction(
+      "standalone", {n_sort_to_indices}, uint32());
+  auto sortArrays_expr = TreeExprBuilder::MakeExpression(n_sort, f_res);
+
+  auto sch = arrow::schema({f0, f1, f2});
+  std::vector<std::shared_ptr<Field>> ret_types = {f0, f1, f2};
+
+  // f0 has few distinct values and nulls, f1 is unique so the order is total
+  std::vector<std::shared_ptr<arrow::RecordBatch>> input_batch_list;
+  int64_t batch_length = 50000;
+  for (int b = 0; b < 3; b++) {
+    arrow::Int32Builder key_builder;
+    arrow::Int32Builder id_builder;
+    arrow::DoubleBuilder payload_builder;
+    for (int64_t i = 0; i < batch_length; i++) {
+      int64_t row = b * batch_length + i;
+      if (row % 101 == 0) {
+        ASSERT_NOT_OK(key_builder.AppendNull());
+      } else {
+        ASSERT_NOT_OK(key_builder.Append(static_cast<int32_t>((row * 31) % 17)));
+      }
+      ASSERT_NOT_OK(id_builder.Append(static_cast<int32_t>((row * 7919) % 150001)));
+      ASSERT_NOT_OK(payload_builder.Append(static_cast<double>(row)));
+    }
+    std::shared_ptr<arrow::Array> key_array;
+    std::shared_ptr<arrow::Array> id_array;
+    std::shared_ptr<arrow::Array> payload_array;
+    ASSERT_NOT_OK(key_builder.Finish(&key_array));
+    ASSERT_NOT_OK(id_builder.Finish(&id_array));
+    ASSERT_NOT_OK(payload_builder.Finish(&payload_array));
+    input_batch_list.push_back(arrow::RecordBatch::Make(
+        sch, batch_length, {key_array, id_array, payload_array}));
+  }
+  ASSERT_GE(3 * batch_length, 2 * arrowcompute::extra::kMinParallelSortRows);
+
+  auto run_sort = [&](const std::string& num_threads,
+                      std::shared_ptr<arrow::RecordBatch>* out) {
+    ScopedEnv sort_threads("NATIVESQL_SORT_THREADS", num_threads);
+    std::shared_ptr<CodeGenerator> sort_expr;
+    arrow::compute::FunctionContext ctx;
+    ASSERT_NOT_OK(CreateCodeGenerator(
+        ctx.memory_pool(), sch, {sortArrays_expr}, ret_types, &sort_expr, true));
+    std::vector<std::shared_ptr<arrow::RecordBatch>> dummy_result_batches;
+    for (auto batch : input_batch_list) {
+      ASSERT_NOT_OK(sort_expr->evaluate(batch, &dummy_result_batches));
+    }
+    std::shared_ptr<ResultIteratorBase> sort_result_iterator_base;
+    ASSERT_NOT_OK(sort_expr->finish(&sort_result_iterator_base));
+    auto sort_result_iterator =
+        std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+            sort_result_iterator_base);
+    std::vector<std::shared_ptr<arrow::RecordBatch>> result_batches;
+    while (sort_result_iterator->HasNext()) {
+      std::shared_ptr<arrow::RecordBatch> result_batch;
+      ASSERT_NOT_OK(sort_result_iterator->Next(&result_batch));
+      result_batches.push_back(result_batch);
+    }
+    std::vector<std::shared_ptr<arrow::Array>> columns;
+    for (int i = 0; i < sch->num_fields(); i++) {
+      arrow::ArrayVector chunks;
+      for (auto batch : result_batches) chunks.push_back(batch->column(i));
+      std::shared_ptr<arrow::Array> column;
+      ASSERT_NOT_OK(arrow::Concatenate(chunks, ctx.memory_pool(), &column));
+      columns.push_back(column);
+    }
+    *out = arrow::RecordBatch::Make(sch, columns[0]->length(), columns);
+  };
+
+  ////////////////////////////////// calculation ///////////////////////////////////
+  std::shared_ptr<arrow::RecordBatch> expected_result;
+  run_sort("1", &expected_result);
+  ASSERT_EQ(expected_result->num_rows(), 3 * batch_length);
+  auto keys = std::dynamic_pointer_cast<arrow::Int32Array>(expected_result->column(0));
+  auto ids = std::dynamic_pointer_cast<arrow::Int32Array>(expected_result->column(1));
+  for (int64_t i = 1; i < keys->length(); i++) {
+    if (keys->IsNull(i)) {
+      ASSERT_TRUE(keys->IsNull(i - 1));
+    } else if (!keys->IsNull(i - 1)) {
+      ASSERT_LE(keys->Value(i - 1), keys->Value(i));
+    }
+    if (keys->IsNull(i) == keys->IsNull(i - 1) &&
+        (keys->IsNull(i) || keys->Value(i) == keys->Value(i - 1))) {
+      ASSERT_GT(ids->Value(i - 1), ids->Value(i));
+    }
+  }
+
+  for (auto num_threads : {"2", "4"}) {
+    std::shared_ptr<arrow::RecordBatch> result_batch;
+    run_sort(num_threads, &result_batch);
+    ASSERT_NOT_OK(Equals(*expected_result.get(), *result_batch.get()));
+  }
+}
+
 }  // namespace codegen
 }  // namespace sparkcolumnarplugin
@@ -0,0 +1,401 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <arrow/array.h>
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "codegen/code_generator.h"
+#include "codegen/code_generator_factory.h"
+#include "tests/test_utils.h"
+
+namespace sparkcolumnarplugin {
+namespace codegen {
+
+/* Runs window over input, out gets the output batches of evaluate and finish */
+void RunWindow(std::shared_ptr<arrow::Schema> sch,
+               std::vector<std::shared_ptr<gandiva::Node>> window_children,
+               std::vector<std::shared_ptr<Field>> ret_types, bool streaming,
+               const std::vector<std::shared_ptr<RecordBatch>>& input,
+               std::vector<std::shared_ptr<RecordBatch>>* out) {
+  if (streaming) {
+    window_children.push_back(TreeExprBuilder::MakeFunction("streaming", {}, uint32()));
+  }
+  auto n_window = TreeExprBuilder::MakeFunction("window", window_children, binary());
+  auto window_expr =
+      TreeExprBuilder::MakeExpression(n_window, field("window_res", binary()));
+  std::shared_ptr<CodeGenerator> expr;
+  arrow::compute::FunctionContext ctx;
+  ASSERT_NOT_OK(CreateCodeGenerator(ctx.memory_pool(), sch, {window_expr}, ret_types,
+                                    &expr, !streaming));
+  for (auto& batch : input) {
+    ASSERT_NOT_OK(expr->evaluate(batch, out));
+  }
+  ASSERT_NOT_OK(expr->finish(out));
+}
+
+void CheckWindowResults(std::vector<std::shared_ptr<Field>> ret_types,
+                        const std::vector<std::vector<std::string>>& expected_data,
+                        const std::vector<std::shared_ptr<RecordBatch>>& results) {
+  ASSERT_EQ(results.size(), expected_data.size());
+  auto res_sch = arrow::schema(ret_types);
+  for (int i = 0; i < results.size(); i++) {
+    std::shared_ptr<arrow::RecordBatch> expected_result;
+    MakeInputBatch(expected_data[i], res_sch, &expected_result);
+    ASSERT_NOT_OK(Equals(*expected_result.get(), *results[i].get()));
+  }
+}
+
+std::shared_ptr<gandiva::Node> MakeOrderSpec(std::vector<std::shared_ptr<Field>> keys,
+                                             bool asc, bool nulls_first) {
+  std::vector<std::shared_ptr<gandiva::Node>> key_fields;
+  std::vector<std::shared_ptr<gandiva::Node>> directions;
+  std::vector<std::shared_ptr<gandiva::Node>> nulls_order;
+  for (auto& key : keys) {
+    key_fields.push_back(TreeExprBuilder::MakeField(key));
+    directions.push_back(TreeExprBuilder::MakeLiteral(asc));
+    nulls_order.push_back(TreeExprBuilder::MakeLiteral(nulls_first));
+  }
+  return TreeExprBuilder::MakeFunction(
+      "orderSpec",
+      {TreeExprBuilder::MakeFunction("key_field", key_fields, uint32()),
+       TreeExprBuilder::MakeFunction("sort_directions", directions, uint32()),
+       TreeExprBuilder::MakeFunction("sort_nulls_order", nulls_order, uint32())},
+      uint32());
+}
+
+std::shared_ptr<gandiva::Node> MakeFrameSpec(bool is_range, double lower, double upper) {
+  return TreeExprBuilder::MakeFunction(
+      "frameSpec",
+      {TreeExprBuilder::MakeLiteral(is_range), TreeExprBuilder::MakeLiteral(lower),
+       TreeExprBuilder::MakeLiteral(upper)},
+      uint32());
+}
+
+TEST(TestArrowComputeWindow, StreamingPartitionSpanningBatches) {
+  auto f_k = field("k", int32());
+  auto f_o = field("o", int32());
+  auto f_v = field("v", int64());
+  auto sch = arrow::schema({f_k, f_o, f_v});
+  auto arg_k = TreeExprBuilder::MakeField(f_k);
+  auto arg_o = TreeExprBuilder::MakeField(f_o);
+  auto arg_v = TreeExprBuilder::MakeField(f_v);
+  std::vector<std::shared_ptr<gandiva::Node>> window_children = {
+      TreeExprBuilder::MakeFunction("sum", {arg_v}, int64()),
+      TreeExprBuilder::MakeFunction("rank_asc", {arg_o}, int32()),
+      // ROWS BETWEEN 1 PRECEDING AND CURRENT ROW
+      TreeExprBuilder::MakeFunction("count", {arg_v, MakeFrameSpec(false, -1, 0)},
+                                    int64()),
+      TreeExprBuilder::MakeFunction("partitionSpec", {arg_k}, uint32()),
+      MakeOrderSpec({f_o}, true, true)};
+  std::vector<std::shared_ptr<Field>> ret_types = {
+      field("sum", int64()), field("rank", int32()), field("count", int64())};
+
+  // partition 1 goes on over an empty batch, partition 3 ends with the input
+  std::vector<std::vector<std::string>> input_data = {
+      {"[1, 1, 1]", "[1, 2, 3]", "[1, 2, 3]"},
+      {"[]", "[]", "[]"},
+      {"[1, 1, 1]", "[3, 4, 5]", "[4, 5, 6]"},
+      {"[2, 3, 3]", "[1, 1, 2]", "[7, 8, 9]"}};
+  std::vector<std::shared_ptr<RecordBatch>> input;
+  for (auto& data : input_data) {
+    std::shared_ptr<arrow::RecordBatch> input_batch;
+    MakeInputBatch(data, sch, &input_batch);
+    input.push_back(input_batch);
+  }
+  std::vector<std::vector<std::string>> expected_data = {
+      {"[21, 21, 21]", "[1, 2, 3]", "[1, 2, 2]"},
+      {"[]", "[]", "[]"},
+      {"[21, 21, 21]", "[3, 5, 6]", "[2, 2, 2]"},
+      {"[7, 17, 17]", "[1, 1, 2]", "[1, 1, 2]"}};
+
+  for (bool streaming : {false, true}) {
+    std::vector<std::shared_ptr<RecordBatch>> results;
+    RunWindow(sch, window_children, ret_types, streaming, input, &results);
+    CheckWindowResults(ret_types, expected_data, results);
+  }
+}
+
+TEST(TestArrowComputeWindow, StreamingNullAndNaNPartitionKeys) {
+  auto f_k = field("k", float64());
+  auto f_v = field("v", int64());
+  auto sch = arrow::schema({f_k, f_v});
+  auto arg_k = TreeExprBuilder::MakeField(f_k);
+  auto arg_v = TreeExprBuilder::MakeField(f_v);
+  std::vector<std::shared_ptr<gandiva::Node>> window_children = {
+      TreeExprBuilder::MakeFunction("sum", {arg_v}, int64()),
+      TreeExprBuilder::MakeFunction("partitionSpec", {arg_k}, uint32())};
+  std::vector<std::shared_ptr<Field>> ret_types = {field("sum", int64())};
+
+  // sorted as in Spark, nulls first and NaN after all other values; nulls are one
+  // partition and so are NaNs
+  std::vector<std::vector<std::string>> input_data = {
+      {"[null, null, -1.5]", "[1, 2, 3]"},
+      {"[-1.5, 2.0, NaN]", "[4, 5, 6]"},
+      {"[]", "[]"},
+      {"[NaN, NaN]", "[7, 8]"}};
+  std::vector<std::shared_ptr<RecordBatch>> input;
+  for (auto& data : input_data) {
+    std::shared_ptr<arrow::RecordBatch> input_batch;
+    MakeInputBatch(data, sch, &input_batch);
+    input.push_back(input_batch);
+  }
+  std::vector<std::vector<std::string>> expected_data = {
+      {"[3, 3, 7]"}, {"[7, 5, 21]"}, {"[]"}, {"[21, 21]"}};
+
+  std::vector<std::shared_ptr<RecordBatch>> results;
+  RunWindow(sch, window_children, ret_types, true, input, &results);
+  CheckWindowResults(ret_types, expected_data, results);
+}
+
+TEST(TestArrowComputeWindow, StreamingWithoutPartitionKeys) {
+  auto f_o = field("o", int32());
+  auto f_v = field("v", int64());
+  auto sch = arrow::schema({f_o, f_v});
+  auto arg_o = TreeExprBuilder::MakeField(f_o);
+  auto arg_v = TreeExprBuilder::MakeField(f_v);
+  std::vector<std::shared_ptr<gandiva::Node>> window_children = {
+      TreeExprBuilder::MakeFunction("sum", {arg_v}, int64()),
+      TreeExprBuilder::MakeFunction("rank_asc", {arg_o}, int32()),
+      TreeExprBuilder::MakeFunction("partitionSpec", {}, uint32())};
+  std::vector<std::shared_ptr<Field>> ret_types = {field("sum", int64()),
+                                                   field("rank", int32())};
+
+  // every row is in one partition, which only ends with the input
+  std::vector<std::vector<std::string>> input_data = {
+      {"[]", "[]"}, {"[1, 2]", "[1, 2]"}, {"[]", "[]"}, {"[2, 4, 5]", "[3, 4, 5]"}};
+  std::vector<std::shared_ptr<RecordBatch>> input;
+  for (auto& data : input_data) {
+    std::shared_ptr<arrow::RecordBatch> input_batch;
+    MakeInputBatch(data, sch, &input_batch);
+    input.push_back(input_batch);
+  }
+  std::vector<std::vector<std::string>> expected_data = {
+      {"[]", "[]"}, {"[15, 15]", "[1, 2]"}, {"[]", "[]"}, {"[15, 15, 15]", "[2, 4, 5]"}};
+
+  std::vector<std::shared_ptr<RecordBatch>> results;
+  RunWindow(sch, window_children, ret_types, true, input, &results);
+  CheckWindowResults(ret_types, expected_data, results);
+}
+
+TEST(TestArrowComputeWindow, FrameRowsFunctions) {
+  auto f_k = field("k", int32());
+  auto f_o = field("o", int32());
+  auto f_v = field("v", int64());
+  auto sch = arrow::schema({f_k, f_o, f_v});
+  auto arg_k = TreeExprBuilder::MakeField(f_k);
+  auto arg_v = TreeExprBuilder::MakeField(f_v);
+  auto MakeFrameFunctions = [&](bool asc, bool nulls_first) {
+    std::vector<std::shared_ptr<gandiva::Node>> window_children;
+    // ROWS BETWEEN 1 PRECEDING AND 1 FOLLOWING
+    for (std::string name : {"min", "max", "count", "avg"}) {
+      window_children.push_back(TreeExprBuilder::MakeFunction(
+          name, {arg_v, MakeFrameSpec(false, -1, 1)}, int64()));
+    }
+    // ROWS BETWEEN 1 FOLLOWING AND 2 FOLLOWING, empty at the end of a partition
+    for (std::string name : {"count", "sum"}) {
+      window_children.push_back(TreeExprBuilder::MakeFunction(
+          name, {arg_v, MakeFrameSpec(false, 1, 2)}, int64()));
+    }
+    // lower bound after upper bound, always empty
+    for (std::string name : {"count", "max"}) {
+      window_children.push_back(TreeExprBuilder::MakeFunction(
+          name, {arg_v, MakeFrameSpec(false, 1, -1)}, int64()));
+    }
+    window_children.push_back(
+        TreeExprBuilder::MakeFunction("partitionSpec", {arg_k}, uint32()));
+    window_children.push_back(MakeOrderSpec({f_o}, asc, nulls_first));
+    return window_children;
+  };
+  std::vector<std::shared_ptr<Field>> ret_types = {
+      field("min", int64()),    field("max", int64()),    field("count", int64()),
+      field("avg", float64()),  field("count2", int64()), field("sum2", int64()),
+      field("count3", int64()), field("max3", int64())};
+
+  // input is not sorted, partition 1 has a null order key and a null value
+  std::vector<std::vector<std::string>> input_data = {
+      {"[1, 2, 1, 1]", "[3, 6, null, 1]", "[30, null, 50, 10]"},
+      {"[1, 2, 1]", "[2, 5, 4]", "[null, 5, 40]"}};
+  std::vector<std::shared_ptr<RecordBatch>> input;
+  for (auto& data : input_data) {
+    std::shared_ptr<arrow::RecordBatch> input_batch;
+    MakeInputBatch(data, sch, &input_batch);
+    input.push_back(input_batch);
+  }
+
+  // partition 1 is 4, 3, 2, 1, null and partition 2 is 6, 5
+  std::vector<std::vector<std::string>> expected_desc_nulls_last = {
+      {"[30, 5, 10, 10]", "[40, 5, 50, 50]", "[2, 1, 2, 2]", "[35, 5, 30, 30]",
+       "[1, 1, 0, 1]", "[10, 5, null, 50]", "[0, 0, 0, 0]",
+       "[null, null, null, null]"},
+      {"[10, 5, 30]", "[30, 5, 40]", "[2, 1, 2]", "[20, 5, 35]", "[2, 0, 1]",
+       "[60, null, 30]", "[0, 0, 0]", "[null, null, null]"}};
+  std::vector<std::shared_ptr<RecordBatch>> results;
+  RunWindow(sch, MakeFrameFunctions(false, false), ret_types, false, input, &results);
+  CheckWindowResults(ret_types, expected_desc_nulls_last, results);
+
+  // partition 1 is null, 1, 2, 3, 4 and partition 2 is 5, 6
+  std::vector<std::vector<std::string>> expected_asc_nulls_first = {
+      {"[30, 5, 10, 10]", "[40, 5, 50, 50]", "[2, 1, 2, 2]", "[35, 5, 30, 30]",
+       "[1, 0, 1, 1]", "[40, null, 10, 30]", "[0, 0, 0, 0]",
+       "[null, null, null, null]"},
+      {"[10, 5, 30]", "[30, 5, 40]", "[2, 1, 2]", "[20, 5, 35]", "[2, 0, 0]",
+       "[70, null, null]", "[0, 0, 0]", "[null, null, null]"}};
+  results.clear();
+  RunWindow(sch, MakeFrameFunctions(true, true), ret_types, false, input, &results);
+  CheckWindowResults(ret_types, expected_asc_nulls_first, results);
+}
+
+TEST(TestArrowComputeWindow, FrameSumOfFloatingValues) {
+  auto f_k = field("k", int32());
+  auto f_o = field("o", int32());
+  auto f_v = field("v", float64());
+  auto sch = arrow::schema({f_k, f_o, f_v});
+  auto arg_k = TreeExprBuilder::MakeField(f_k);
+  auto arg_v = TreeExprBuilder::MakeField(f_v);
+  double unbounded = std::numeric_limits<double>::infinity();
+  std::vector<std::shared_ptr<gandiva::Node>> window_children = {
+      // ROWS BETWEEN 1 PRECEDING AND CURRENT ROW
+      TreeExprBuilder::MakeFunction("sum", {arg_v, MakeFrameSpec(false, -1, 0)},
+                                    float64()),
+      TreeExprBuilder::MakeFunction("avg", {arg_v, MakeFrameSpec(false, -1, 0)},
+                                    float64()),
+      // ROWS BETWEEN UNBOUNDED PRECEDING AND CURRENT ROW
+      TreeExprBuilder::MakeFunction(
+          "sum", {arg_v, MakeFrameSpec(false, -unbounded, 0)}, float64()),
+      TreeExprBuilder::MakeFunction("partitionSpec", {arg_k}, uint32()),
+      MakeOrderSpec({f_o}, true, true)};
+  std::vector<std::shared_ptr<Field>> ret_types = {
+      field("sum", float64()), field("avg", float64()), field("running_sum", float64())};
+
+  // 1 is lost next to 1e20, but not once 1e20 leaves the frame; the frame is Inf or NaN
+  // only while Inf or NaN are in it
+  std::vector<std::vector<std::string>> input_data = {
+      {"[1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 3, 3, 3]",
+       "[1, 2, 3, 4, 5, 6, 7, 8, 1, 2, 3, 1, 2, 3]",
+       "[1e20, 1, 1, Infinity, 1, -Infinity, 1, 1, NaN, 2, 3, Infinity, -Infinity, "
+       "4]"}};
+  std::vector<std::shared_ptr<RecordBatch>> input;
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+  MakeInputBatch(input_data[0], sch, &input_batch);
+  input.push_back(input_batch);
+  std::vector<std::vector<std::string>> expected_data = {
+      {"[1e20, 1e20, 2, Infinity, Infinity, -Infinity, -Infinity, 2, NaN, NaN, 5, "
+       "Infinity, NaN, -Infinity]",
+       "[1e20, 5e19, 1, Infinity, Infinity, -Infinity, -Infinity, 1, NaN, NaN, 2.5, "
+       "Infinity, NaN, -Infinity]",
+       "[1e20, 1e20, 1e20, Infinity, Infinity, NaN, NaN, NaN, NaN, NaN, NaN, "
+       "Infinity, NaN, NaN]"}};
+
+  for (bool streaming : {false, true}) {
+    std::vector<std::shared_ptr<RecordBatch>> results;
+    RunWindow(sch, window_children, ret_types, streaming, input, &results);
+    CheckWindowResults(ret_types, expected_data, results);
+  }
+}
+
+TEST(TestArrowComputeWindow, FrameRangeWithNullAndNaNKeys) {
+  auto f_k = field("k", int32());
+  auto f_o = field("o", float64());
+  auto f_v = field("v", int64());
+  auto sch = arrow::schema({f_k, f_o, f_v});
+  auto arg_k = TreeExprBuilder::MakeField(f_k);
+  auto arg_v = TreeExprBuilder::MakeField(f_v);
+  auto MakeRangeFunctions = [&](bool asc, bool nulls_first) {
+    return std::vector<std::shared_ptr<gandiva::Node>>{
+        // RANGE BETWEEN 1 PRECEDING AND CURRENT ROW
+        TreeExprBuilder::MakeFunction("sum", {arg_v, MakeFrameSpec(true, -1, 0)},
+                                      int64()),
+        // RANGE BETWEEN CURRENT ROW AND 1.5 FOLLOWING
+        TreeExprBuilder::MakeFunction("count", {arg_v, MakeFrameSpec(true, 0, 1.5)},
+                                      int64()),
+        TreeExprBuilder::MakeFunction("partitionSpec", {arg_k}, uint32()),
+        MakeOrderSpec({f_o}, asc, nulls_first)};
+  };
+  std::vector<std::shared_ptr<Field>> ret_types = {field("sum", int64()),
+                                                   field("count", int64())};
+
+  // nulls are only peers of nulls and NaNs of NaNs, whatever the offsets
+  std::vector<std::vector<std::string>> input_data = {
+      {"[1, 1, 1, 1, 1, 1, 1, 1]", "[2.5, null, NaN, 1.0, 4.0, null, NaN, 2.0]",
+       "[5, 1, 7, 3, 6, 2, 8, 4]"}};
+  std::vector<std::shared_ptr<RecordBatch>> input;
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+  MakeInputBatch(input_data[0], sch, &input_batch);
+  input.push_back(input_batch);
+
+  std::vector<std::shared_ptr<RecordBatch>> results;
+  RunWindow(sch, MakeRangeFunctions(true, true), ret_types, false, input, &results);
+  CheckWindowResults(ret_types,
+                     {{"[9, 3, 15, 3, 6, 3, 15, 7]", "[2, 2, 2, 3, 1, 2, 2, 2]"}},
+                     results);
+
+  // descending, a row's frame holds keys from its own up to 1 more
+  results.clear();
+  RunWindow(sch, MakeRangeFunctions(false, false), ret_types, false, input, &results);
+  CheckWindowResults(ret_types,
+                     {{"[5, 3, 15, 7, 6, 3, 15, 9]", "[3, 2, 2, 1, 2, 2, 2, 2]"}},
+                     results);
+}
+
+TEST(TestArrowComputeWindow, FrameRangeDateOffsets) {
+  auto f_k = field("k", int32());
+  auto f_d = field("d", date32());
+  auto f_v = field("v", int64());
+  auto sch = arrow::schema({f_k, f_d, f_v});
+  auto arg_k = TreeExprBuilder::MakeField(f_k);
+  auto arg_d = TreeExprBuilder::MakeField(f_d);
+  auto arg_v = TreeExprBuilder::MakeField(f_v);
+  std::vector<std::shared_ptr<gandiva::Node>> window_children = {
+      // RANGE BETWEEN 2 PRECEDING AND CURRENT ROW, in days
+      TreeExprBuilder::MakeFunction("sum", {arg_v, MakeFrameSpec(true, -2, 0)}, int64()),
+      TreeExprBuilder::MakeFunction("min", {arg_d, MakeFrameSpec(true, -2, 0)},
+                                    date32()),
+      // RANGE BETWEEN 1 FOLLOWING AND 2 FOLLOWING, empty without keys in it
+      TreeExprBuilder::MakeFunction("count", {arg_v, MakeFrameSpec(true, 1, 2)},
+                                    int64()),
+      TreeExprBuilder::MakeFunction("sum", {arg_v, MakeFrameSpec(true, 1, 2)}, int64()),
+      TreeExprBuilder::MakeFunction("partitionSpec", {arg_k}, uint32()),
+      MakeOrderSpec({f_d}, true, true)};
+  std::vector<std::shared_ptr<Field>> ret_types = {
+      field("sum", int64()), field("min", date32()), field("count2", int64()),
+      field("sum2", int64())};
+
+  std::vector<std::vector<std::string>> input_data = {
+      {"[1, 1, 1, 1, 1]", "[3, 0, 10, 1, 4]", "[3, 1, 5, 2, 4]"}};
+  std::vector<std::shared_ptr<RecordBatch>> input;
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+  MakeInputBatch(input_data[0], sch, &input_batch);
+  input.push_back(input_batch);
+
+  for (bool streaming : {false, true}) {
+    std::vector<std::shared_ptr<RecordBatch>> results;
+    RunWindow(sch, window_children, ret_types, streaming, input, &results);
+    CheckWindowResults(
+        ret_types,
+        {{"[5, 1, 5, 3, 7]", "[1, 0, 10, 0, 3]", "[1, 1, 0, 1, 0]",
+          "[4, 2, null, 3, null]"}},
+        results);
+  }
+}
+
+}  // namespace codegen
+}  // namespace sparkcolumnarplugin
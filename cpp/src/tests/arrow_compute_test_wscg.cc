@@ -16,11 +16,14 @@
  */
 
 #include <arrow/array.h>
+#include <arrow/builder.h>
 #include <arrow/ipc/json_simple.h>
 #include <arrow/record_batch.h>
 #include <gandiva/tree_expr_builder.h>
 #include <gtest/gtest.h>
 
+#include <cstdlib>
+#include <map>
 #include <memory>
 
 #include "codegen/code_generator.h"
@@ -4051,6 +4054,696 @@ TEST(TestArrowComputeWSCG, WSCGTestGroupbyHashAggregate) {
   }
 }
 
+TEST(TestArrowComputeWSCG, WSCGTestPartialHashAggregateBypass) {
+  setenv("NATIVESQL_AGGR_ADAPTIVE", "true", 1);
+  setenv("NATIVESQL_AGGR_ADAPTIVE_MIN_ROWS", "4", 1);
+  setenv("NATIVESQL_AGGR_ADAPTIVE_RATIO", "0.5", 1);
+  ////////////////////// prepare expr_vector ///////////////////////
+  auto f0 = field("f0", int64());
+  auto f1 = field("f1", int64());
+
+  auto f_unique = field("unique", int64());
+  auto f_sum = field("sum", int64());
+  auto f_count = field("count", int64());
+  auto f_res = field("res", uint32());
+
+  auto arg0 = TreeExprBuilder::MakeField(f0);
+  auto arg1 = TreeExprBuilder::MakeField(f1);
+
+  auto n_groupby = TreeExprBuilder::MakeFunction("action_groupby", {arg0}, uint32());
+  auto n_sum = TreeExprBuilder::MakeFunction("action_sum", {arg1}, uint32());
+  auto n_count = TreeExprBuilder::MakeFunction("action_countLiteral_1", {}, uint32());
+  auto n_proj =
+      TreeExprBuilder::MakeFunction("aggregateExpressions", {arg0, arg1}, uint32());
+  auto n_action = TreeExprBuilder::MakeFunction("aggregateActions",
+                                                {n_groupby, n_sum, n_count}, uint32());
+  auto n_result = TreeExprBuilder::MakeFunction("resultSchema", {}, uint32());
+  auto n_result_expr = TreeExprBuilder::MakeFunction("resultExpressions", {}, uint32());
+  auto n_partial = TreeExprBuilder::MakeFunction("partialAggregate", {}, uint32());
+
+  auto n_aggr = TreeExprBuilder::MakeFunction(
+      "hashAggregateArrays", {n_proj, n_action, n_result, n_result_expr, n_partial},
+      uint32());
+  auto n_child = TreeExprBuilder::MakeFunction("child", {n_aggr}, uint32());
+  auto n_wscg = TreeExprBuilder::MakeFunction("wholestagecodegen", {n_child}, uint32());
+  auto aggr_expr = TreeExprBuilder::MakeExpression(n_wscg, f_res);
+
+  std::vector<std::shared_ptr<::gandiva::Expression>> expr_vector = {aggr_expr};
+
+  auto sch = arrow::schema({f0, f1});
+  std::vector<std::shared_ptr<Field>> ret_types = {f_unique, f_sum, f_count};
+
+  /////////////////////// Create Expression Evaluator ////////////////////
+  std::shared_ptr<CodeGenerator> expr;
+  arrow::compute::FunctionContext ctx;
+  ASSERT_NOT_OK(
+      CreateCodeGenerator(ctx.memory_pool(), sch, expr_vector, ret_types, &expr, true));
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> output_batch_list;
+
+  std::shared_ptr<ResultIterator<arrow::RecordBatch>> aggr_result_iterator;
+  std::shared_ptr<ResultIteratorBase> aggr_result_iterator_base;
+  ASSERT_NOT_OK(expr->finish(&aggr_result_iterator_base));
+  aggr_result_iterator = std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+      aggr_result_iterator_base);
+  unsetenv("NATIVESQL_AGGR_ADAPTIVE");
+  unsetenv("NATIVESQL_AGGR_ADAPTIVE_MIN_ROWS");
+  unsetenv("NATIVESQL_AGGR_ADAPTIVE_RATIO");
+
+  ////////////////////// calculation /////////////////////
+  // 5 groups out of 6 rows is over ratio, so groups so far are flushed and each row of
+  // the 2nd batch is its own group, flushed at the end of the batch
+  auto res_sch = arrow::schema(ret_types);
+  std::shared_ptr<arrow::RecordBatch> result_batch;
+  std::shared_ptr<arrow::RecordBatch> expected_result;
+  std::vector<std::string> input_data = {"[1, 2, 3, 4, 5, 1]", "[1, 2, 3, 4, 5, 6]"};
+  MakeInputBatch(input_data, sch, &input_batch);
+  ASSERT_NOT_OK(aggr_result_iterator->ProcessAndCacheOne(input_batch->columns()));
+  ASSERT_TRUE(aggr_result_iterator->HasFlushedOutput());
+  ASSERT_NOT_OK(aggr_result_iterator->Next(&result_batch));
+  MakeInputBatch({"[1, 2, 3, 4, 5]", "[7, 2, 3, 4, 5]", "[2, 1, 1, 1, 1]"}, res_sch,
+                 &expected_result);
+  ASSERT_NOT_OK(Equals(*expected_result.get(), *result_batch.get()));
+  ASSERT_FALSE(aggr_result_iterator->HasFlushedOutput());
+
+  std::vector<std::string> input_data_2 = {"[1, 1, null, 2]", "[10, 20, 30, 40]"};
+  MakeInputBatch(input_data_2, sch, &input_batch);
+  ASSERT_NOT_OK(aggr_result_iterator->ProcessAndCacheOne(input_batch->columns()));
+  ASSERT_TRUE(aggr_result_iterator->HasFlushedOutput());
+  ASSERT_NOT_OK(aggr_result_iterator->Next(&result_batch));
+  MakeInputBatch({"[1, 1, null, 2]", "[10, 20, 30, 40]", "[1, 1, 1, 1]"}, res_sch,
+                 &expected_result);
+  ASSERT_NOT_OK(Equals(*expected_result.get(), *result_batch.get()));
+
+  ////////////////////// Finish //////////////////////////
+  // nothing is left after the last flush
+  while (aggr_result_iterator->HasNext()) {
+    ASSERT_NOT_OK(aggr_result_iterator->Next(&result_batch));
+    ASSERT_EQ(result_batch->num_rows(), 0);
+  }
+}
+
+TEST(TestArrowComputeWSCG, WSCGTestPartialHashAggregateMemoryBudget) {
+  setenv("NATIVESQL_AGGR_ADAPTIVE", "true", 1);
+  setenv("NATIVESQL_AGGR_MEMORY_BUDGET", "1", 1);
+  ////////////////////// prepare expr_vector ///////////////////////
+  auto f0 = field("f0", int64());
+  auto f1 = field("f1", int64());
+
+  auto f_unique = field("unique", int64());
+  auto f_sum = field("sum", int64());
+  auto f_count = field("count", int64());
+  auto f_res = field("res", uint32());
+
+  auto arg0 = TreeExprBuilder::MakeField(f0);
+  auto arg1 = TreeExprBuilder::MakeField(f1);
+
+  auto n_groupby = TreeExprBuilder::MakeFunction("action_groupby", {arg0}, uint32());
+  auto n_sum = TreeExprBuilder::MakeFunction("action_sum", {arg1}, uint32());
+  auto n_count = TreeExprBuilder::MakeFunction("action_countLiteral_1", {}, uint32());
+  auto n_proj =
+      TreeExprBuilder::MakeFunction("aggregateExpressions", {arg0, arg1}, uint32());
+  auto n_action = TreeExprBuilder::MakeFunction("aggregateActions",
+                                                {n_groupby, n_sum, n_count}, uint32());
+  auto n_result = TreeExprBuilder::MakeFunction("resultSchema", {}, uint32());
+  auto n_result_expr = TreeExprBuilder::MakeFunction("resultExpressions", {}, uint32());
+  auto n_partial = TreeExprBuilder::MakeFunction("partialAggregate", {}, uint32());
+
+  auto n_aggr = TreeExprBuilder::MakeFunction(
+      "hashAggregateArrays", {n_proj, n_action, n_result, n_result_expr, n_partial},
+      uint32());
+  auto n_child = TreeExprBuilder::MakeFunction("child", {n_aggr}, uint32());
+  auto n_wscg = TreeExprBuilder::MakeFunction("wholestagecodegen", {n_child}, uint32());
+  auto aggr_expr = TreeExprBuilder::MakeExpression(n_wscg, f_res);
+
+  std::vector<std::shared_ptr<::gandiva::Expression>> expr_vector = {aggr_expr};
+
+  auto sch = arrow::schema({f0, f1});
+  std::vector<std::shared_ptr<Field>> ret_types = {f_unique, f_sum, f_count};
+
+  /////////////////////// Create Expression Evaluator ////////////////////
+  std::shared_ptr<CodeGenerator> expr;
+  arrow::compute::FunctionContext ctx;
+  ASSERT_NOT_OK(
+      CreateCodeGenerator(ctx.memory_pool(), sch, expr_vector, ret_types, &expr, true));
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+  std::vector<std::shared_ptr<arrow::RecordBatch>> output_batch_list;
+
+  std::shared_ptr<ResultIterator<arrow::RecordBatch>> aggr_result_iterator;
+  std::shared_ptr<ResultIteratorBase> aggr_result_iterator_base;
+  ASSERT_NOT_OK(expr->finish(&aggr_result_iterator_base));
+  aggr_result_iterator = std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+      aggr_result_iterator_base);
+  unsetenv("NATIVESQL_AGGR_ADAPTIVE");
+  unsetenv("NATIVESQL_AGGR_MEMORY_BUDGET");
+
+  ////////////////////// calculation /////////////////////
+  // groups are over budget after each batch, so they are flushed and the next batch
+  // starts over
+  std::vector<std::string> input_data = {"[1, 1, 2, null]", "[1, 2, 3, 4]"};
+  MakeInputBatch(input_data, sch, &input_batch);
+  ASSERT_NOT_OK(aggr_result_iterator->ProcessAndCacheOne(input_batch->columns()));
+
+  std::vector<std::string> input_data_2 = {"[2, 1, 2, null]", "[10, 20, 30, 40]"};
+  MakeInputBatch(input_data_2, sch, &input_batch);
+  ASSERT_NOT_OK(aggr_result_iterator->ProcessAndCacheOne(input_batch->columns()));
+
+  ////////////////////// Finish //////////////////////////
+  std::shared_ptr<arrow::RecordBatch> result_batch;
+  std::shared_ptr<arrow::RecordBatch> expected_result;
+  std::vector<std::vector<std::string>> expected_result_list = {
+      {"[1, 2, null]", "[3, 3, 4]", "[2, 1, 1]"},
+      {"[2, 1, null]", "[40, 20, 40]", "[2, 1, 1]"}};
+  auto res_sch = arrow::schema(ret_types);
+  for (auto expected_result_string : expected_result_list) {
+    ASSERT_TRUE(aggr_result_iterator->HasFlushedOutput());
+    ASSERT_NOT_OK(aggr_result_iterator->Next(&result_batch));
+    MakeInputBatch(expected_result_string, res_sch, &expected_result);
+    ASSERT_NOT_OK(Equals(*expected_result.get(), *result_batch.get()));
+  }
+  while (aggr_result_iterator->HasNext()) {
+    ASSERT_NOT_OK(aggr_result_iterator->Next(&result_batch));
+    ASSERT_EQ(result_batch->num_rows(), 0);
+  }
+}
+
+TEST(TestArrowComputeWSCG, WSCGTestPartialHashAggregateBoundedMemory) {
+  const int64_t memory_budget = 1 << 20;
+  ScopedEnv adaptive("NATIVESQL_AGGR_ADAPTIVE", "true");
+  ScopedEnv budget("NATIVESQL_AGGR_MEMORY_BUDGET", std::to_string(memory_budget));
+  ////////////////////// prepare expr_vector ///////////////////////
+  auto f0 = field("f0", int64());
+  auto f1 = field("f1", int64());
+
+  auto f_unique = field("unique", int64());
+  auto f_sum = field("sum", int64());
+  auto f_count = field("count", int64());
+  auto f_res = field("res", uint32());
+
+  auto arg0 = TreeExprBuilder::MakeField(f0);
+  auto arg1 = TreeExprBuilder::MakeField(f1);
+
+  auto n_groupby = TreeExprBuilder::MakeFunction("action_groupby", {arg0}, uint32());
+  auto n_sum = TreeExprBuilder::MakeFunction("action_sum", {arg1}, uint32());
+  auto n_count = TreeExprBuilder::MakeFunction("action_countLiteral_1", {}, uint32());
+  auto n_proj =
+      TreeExprBuilder::MakeFunction("aggregateExpressions", {arg0, arg1}, uint32());
+  auto n_action = TreeExprBuilder::MakeFunction("aggregateActions",
+                                                {n_groupby, n_sum, n_count}, uint32());
+  auto n_result = TreeExprBuilder::MakeFunction("resultSchema", {}, uint32());
+  auto n_result_expr = TreeExprBuilder::MakeFunction("resultExpressions", {}, uint32());
+  auto n_partial = TreeExprBuilder::MakeFunction("partialAggregate", {}, uint32());
+
+  auto n_aggr = TreeExprBuilder::MakeFunction(
+      "hashAggregateArrays", {n_proj, n_action, n_result, n_result_expr, n_partial},
+      uint32());
+  auto n_child = TreeExprBuilder::MakeFunction("child", {n_aggr}, uint32());
+  auto n_wscg = TreeExprBuilder::MakeFunction("wholestagecodegen", {n_child}, uint32());
+  auto aggr_expr = TreeExprBuilder::MakeExpression(n_wscg, f_res);
+
+  std::vector<std::shared_ptr<::gandiva::Expression>> expr_vector = {aggr_expr};
+
+  auto sch = arrow::schema({f0, f1});
+  std::vector<std::shared_ptr<Field>> ret_types = {f_unique, f_sum, f_count};
+
+  /////////////////////// Create Expression Evaluator ////////////////////
+  auto pool = std::make_shared<arrow::ProxyMemoryPool>(arrow::default_memory_pool());
+  std::shared_ptr<CodeGenerator> expr;
+  ASSERT_NOT_OK(
+      CreateCodeGenerator(pool.get(), sch, expr_vector, ret_types, &expr, true));
+
+  std::shared_ptr<ResultIterator<arrow::RecordBatch>> aggr_result_iterator;
+  std::shared_ptr<ResultIteratorBase> aggr_result_iterator_base;
+  ASSERT_NOT_OK(expr->finish(&aggr_result_iterator_base));
+  aggr_result_iterator = std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+      aggr_result_iterator_base);
+
+  ////////////////////// calculation /////////////////////
+  // every key is distinct, so groups are flushed over budget and then bypassed, and
+  // the pool never holds the state of all 500k groups
+  const int num_batches = 50;
+  const int batch_size = 10000;
+  int64_t num_output_rows = 0;
+  std::shared_ptr<arrow::RecordBatch> result_batch;
+  for (int b = 0; b < num_batches; b++) {
+    arrow::Int64Builder key_builder;
+    arrow::Int64Builder value_builder;
+    for (int i = 0; i < batch_size; i++) {
+      ASSERT_NOT_OK(key_builder.Append((int64_t)b * batch_size + i));
+      ASSERT_NOT_OK(value_builder.Append(i));
+    }
+    std::shared_ptr<arrow::Array> key_array;
+    std::shared_ptr<arrow::Array> value_array;
+    ASSERT_NOT_OK(key_builder.Finish(&key_array));
+    ASSERT_NOT_OK(value_builder.Finish(&value_array));
+    ASSERT_NOT_OK(aggr_result_iterator->ProcessAndCacheOne({key_array, value_array}));
+    while (aggr_result_iterator->HasFlushedOutput()) {
+      ASSERT_NOT_OK(aggr_result_iterator->Next(&result_batch));
+      num_output_rows += result_batch->num_rows();
+    }
+  }
+
+  ////////////////////// Finish //////////////////////////
+  while (aggr_result_iterator->HasNext()) {
+    ASSERT_NOT_OK(aggr_result_iterator->Next(&result_batch));
+    num_output_rows += result_batch->num_rows();
+  }
+  result_batch.reset();
+  ASSERT_EQ(num_output_rows, num_batches * batch_size);
+  ASSERT_LT(pool->max_memory(), 4 * memory_budget);
+}
+
+TEST(TestArrowComputeWSCG, WSCGTestSortedInputHashAggregate) {
+  ////////////////////// prepare expr_vector ///////////////////////
+  auto f0 = field("f0", int64());
+  auto f1 = field("f1", int64());
+
+  auto f_unique = field("unique", int64());
+  auto f_sum = field("sum", int64());
+  auto f_count = field("count", int64());
+  auto f_res = field("res", uint32());
+
+  auto arg0 = TreeExprBuilder::MakeField(f0);
+  auto arg1 = TreeExprBuilder::MakeField(f1);
+
+  auto n_groupby = TreeExprBuilder::MakeFunction("action_groupby", {arg0}, uint32());
+  auto n_sum = TreeExprBuilder::MakeFunction("action_sum", {arg1}, uint32());
+  auto n_count = TreeExprBuilder::MakeFunction("action_countLiteral_1", {}, uint32());
+  auto n_proj =
+      TreeExprBuilder::MakeFunction("aggregateExpressions", {arg0, arg1}, uint32());
+  auto n_action = TreeExprBuilder::MakeFunction("aggregateActions",
+                                                {n_groupby, n_sum, n_count}, uint32());
+  auto n_result = TreeExprBuilder::MakeFunction("resultSchema", {}, uint32());
+  auto n_result_expr = TreeExprBuilder::MakeFunction("resultExpressions", {}, uint32());
+  auto n_sorted = TreeExprBuilder::MakeFunction("sortedAggregate", {}, uint32());
+
+  auto n_aggr = TreeExprBuilder::MakeFunction(
+      "hashAggregateArrays", {n_proj, n_action, n_result, n_result_expr, n_sorted},
+      uint32());
+  auto n_child = TreeExprBuilder::MakeFunction("child", {n_aggr}, uint32());
+  auto n_wscg = TreeExprBuilder::MakeFunction("wholestagecodegen", {n_child}, uint32());
+  auto aggr_expr = TreeExprBuilder::MakeExpression(n_wscg, f_res);
+
+  std::vector<std::shared_ptr<::gandiva::Expression>> expr_vector = {aggr_expr};
+
+  auto sch = arrow::schema({f0, f1});
+  std::vector<std::shared_ptr<Field>> ret_types = {f_unique, f_sum, f_count};
+
+  /////////////////////// Create Expression Evaluator ////////////////////
+  std::shared_ptr<CodeGenerator> expr;
+  arrow::compute::FunctionContext ctx;
+  ASSERT_NOT_OK(
+      CreateCodeGenerator(ctx.memory_pool(), sch, expr_vector, ret_types, &expr, true));
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+
+  std::shared_ptr<ResultIterator<arrow::RecordBatch>> aggr_result_iterator;
+  std::shared_ptr<ResultIteratorBase> aggr_result_iterator_base;
+  ASSERT_NOT_OK(expr->finish(&aggr_result_iterator_base));
+  aggr_result_iterator = std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+      aggr_result_iterator_base);
+
+  ////////////////////// calculation /////////////////////
+  // key 2 spans both batches, and null keys are sorted last
+  std::vector<std::string> input_data = {"[1, 1, 2, 2]", "[1, 2, 3, 4]"};
+  MakeInputBatch(input_data, sch, &input_batch);
+  ASSERT_NOT_OK(aggr_result_iterator->ProcessAndCacheOne(input_batch->columns()));
+
+  std::vector<std::string> input_data_2 = {"[2, 3, null, null]", "[5, 6, 7, null]"};
+  MakeInputBatch(input_data_2, sch, &input_batch);
+  ASSERT_NOT_OK(aggr_result_iterator->ProcessAndCacheOne(input_batch->columns()));
+
+  ////////////////////// Finish //////////////////////////
+  std::shared_ptr<arrow::RecordBatch> result_batch;
+  std::shared_ptr<arrow::RecordBatch> expected_result;
+  std::vector<std::string> expected_result_string = {"[1, 2, 3, null]", "[3, 12, 6, 7]",
+                                                     "[2, 3, 1, 2]"};
+  auto res_sch = arrow::schema(ret_types);
+  MakeInputBatch(expected_result_string, res_sch, &expected_result);
+  ASSERT_TRUE(aggr_result_iterator->HasNext());
+  ASSERT_NOT_OK(aggr_result_iterator->Next(&result_batch));
+  ASSERT_NOT_OK(Equals(*expected_result.get(), *result_batch.get()));
+}
+
+TEST(TestArrowComputeWSCG, WSCGTestParallelHashAggregate) {
+  ScopedEnv aggr_threads("NATIVESQL_AGGR_THREADS", "4");
+  ////////////////////// prepare expr_vector ///////////////////////
+  auto f0 = field("f0", int64());
+  auto f1 = field("f1", int64());
+
+  auto f_unique = field("unique", int64());
+  auto f_sum = field("sum", int64());
+  auto f_count = field("count", int64());
+  auto f_res = field("res", uint32());
+
+  auto arg0 = TreeExprBuilder::MakeField(f0);
+  auto arg1 = TreeExprBuilder::MakeField(f1);
+
+  auto n_groupby = TreeExprBuilder::MakeFunction("action_groupby", {arg0}, uint32());
+  auto n_sum = TreeExprBuilder::MakeFunction("action_sum", {arg1}, uint32());
+  auto n_count = TreeExprBuilder::MakeFunction("action_countLiteral_1", {}, uint32());
+  auto n_proj =
+      TreeExprBuilder::MakeFunction("aggregateExpressions", {arg0, arg1}, uint32());
+  auto n_action = TreeExprBuilder::MakeFunction("aggregateActions",
+                                                {n_groupby, n_sum, n_count}, uint32());
+
+  auto n_aggr =
+      TreeExprBuilder::MakeFunction("hashAggregateArrays", {n_proj, n_action}, uint32());
+  auto n_child = TreeExprBuilder::MakeFunction("child", {n_aggr}, uint32());
+  auto n_wscg = TreeExprBuilder::MakeFunction("wholestagecodegen", {n_child}, uint32());
+  auto aggr_expr = TreeExprBuilder::MakeExpression(n_wscg, f_res);
+
+  std::vector<std::shared_ptr<::gandiva::Expression>> expr_vector = {aggr_expr};
+
+  auto sch = arrow::schema({f0, f1});
+  std::vector<std::shared_ptr<Field>> ret_types = {f_unique, f_sum, f_count};
+
+  /////////////////////// Create Expression Evaluator ////////////////////
+  std::shared_ptr<CodeGenerator> expr;
+  arrow::compute::FunctionContext ctx;
+  ASSERT_NOT_OK(
+      CreateCodeGenerator(ctx.memory_pool(), sch, expr_vector, ret_types, &expr, true));
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+
+  std::shared_ptr<ResultIterator<arrow::RecordBatch>> aggr_result_iterator;
+  std::shared_ptr<ResultIteratorBase> aggr_result_iterator_base;
+  ASSERT_NOT_OK(expr->finish(&aggr_result_iterator_base));
+  aggr_result_iterator = std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+      aggr_result_iterator_base);
+
+  ////////////////////// calculation /////////////////////
+  std::vector<std::string> input_data = {"[1, 2, 3, 4, 5, null, 6, 7, 8, 1, 2, 3]",
+                                         "[1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12]"};
+  MakeInputBatch(input_data, sch, &input_batch);
+  ASSERT_NOT_OK(aggr_result_iterator->ProcessAndCacheOne(input_batch->columns()));
+
+  std::vector<std::string> input_data_2 = {"[8, 7, 6, 5, null, 9, 10, 1]",
+                                           "[10, 20, 30, 40, 50, 60, 70, 80]"};
+  MakeInputBatch(input_data_2, sch, &input_batch);
+  ASSERT_NOT_OK(aggr_result_iterator->ProcessAndCacheOne(input_batch->columns()));
+
+  ////////////////////// Finish //////////////////////////
+  // partitions are concatenated, so groups are compared regardless of order
+  std::map<int64_t, std::pair<int64_t, int64_t>> expected_groups = {
+      {1, {91, 3}}, {2, {13, 2}}, {3, {15, 2}}, {4, {4, 1}},   {5, {45, 2}},
+      {6, {37, 2}}, {7, {28, 2}}, {8, {19, 2}}, {9, {60, 1}}, {10, {70, 1}}};
+  std::pair<int64_t, int64_t> expected_null_group = {56, 2};
+  std::map<int64_t, std::pair<int64_t, int64_t>> result_groups;
+  std::pair<int64_t, int64_t> result_null_group = {0, 0};
+  std::shared_ptr<arrow::RecordBatch> result_batch;
+  while (aggr_result_iterator->HasNext()) {
+    ASSERT_NOT_OK(aggr_result_iterator->Next(&result_batch));
+    auto keys = std::dynamic_pointer_cast<arrow::Int64Array>(result_batch->column(0));
+    auto sums = std::dynamic_pointer_cast<arrow::Int64Array>(result_batch->column(1));
+    auto counts = std::dynamic_pointer_cast<arrow::Int64Array>(result_batch->column(2));
+    for (int i = 0; i < result_batch->num_rows(); i++) {
+      auto group = std::make_pair(sums->Value(i), counts->Value(i));
+      if (keys->IsNull(i)) {
+        result_null_group = group;
+      } else {
+        ASSERT_EQ(result_groups.count(keys->Value(i)), 0);
+        result_groups[keys->Value(i)] = group;
+      }
+    }
+  }
+  ASSERT_EQ(expected_groups, result_groups);
+  ASSERT_EQ(expected_null_group, result_null_group);
+}
+
+TEST(TestArrowComputeWSCG, WSCGTestParallelHashAggregateWithSelection) {
+  ScopedEnv aggr_threads("NATIVESQL_AGGR_THREADS", "4");
+  ////////////////////// prepare expr_vector ///////////////////////
+  auto f0 = field("f0", int64());
+  auto f1 = field("f1", int64());
+
+  auto f_unique = field("unique", int64());
+  auto f_sum = field("sum", int64());
+  auto f_count = field("count", int64());
+  auto f_res = field("res", uint32());
+
+  auto arg0 = TreeExprBuilder::MakeField(f0);
+  auto arg1 = TreeExprBuilder::MakeField(f1);
+
+  auto n_groupby = TreeExprBuilder::MakeFunction("action_groupby", {arg0}, uint32());
+  auto n_sum = TreeExprBuilder::MakeFunction("action_sum", {arg1}, uint32());
+  auto n_count = TreeExprBuilder::MakeFunction("action_countLiteral_1", {}, uint32());
+  auto n_proj =
+      TreeExprBuilder::MakeFunction("aggregateExpressions", {arg0, arg1}, uint32());
+  auto n_action = TreeExprBuilder::MakeFunction("aggregateActions",
+                                                {n_groupby, n_sum, n_count}, uint32());
+
+  auto n_aggr =
+      TreeExprBuilder::MakeFunction("hashAggregateArrays", {n_proj, n_action}, uint32());
+  auto n_child = TreeExprBuilder::MakeFunction("child", {n_aggr}, uint32());
+  auto n_wscg = TreeExprBuilder::MakeFunction("wholestagecodegen", {n_child}, uint32());
+  auto aggr_expr = TreeExprBuilder::MakeExpression(n_wscg, f_res);
+
+  std::vector<std::shared_ptr<::gandiva::Expression>> expr_vector = {aggr_expr};
+
+  auto sch = arrow::schema({f0, f1});
+  std::vector<std::shared_ptr<Field>> ret_types = {f_unique, f_sum, f_count};
+
+  /////////////////////// Create Expression Evaluator ////////////////////
+  std::shared_ptr<CodeGenerator> expr;
+  arrow::compute::FunctionContext ctx;
+  ASSERT_NOT_OK(
+      CreateCodeGenerator(ctx.memory_pool(), sch, expr_vector, ret_types, &expr, true));
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+
+  std::shared_ptr<ResultIterator<arrow::RecordBatch>> aggr_result_iterator;
+  std::shared_ptr<ResultIteratorBase> aggr_result_iterator_base;
+  ASSERT_NOT_OK(expr->finish(&aggr_result_iterator_base));
+  aggr_result_iterator = std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+      aggr_result_iterator_base);
+
+  ////////////////////// calculation /////////////////////
+  // only the selected rows are aggregated, rows are partitioned after selecting
+  std::vector<std::string> input_data = {"[1, 2, 3, 4, 5, null, 6, 7, 8, 1, 2, 3]",
+                                         "[1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12]"};
+  MakeInputBatch(input_data, sch, &input_batch);
+  std::shared_ptr<arrow::Array> selection;
+  ASSERT_NOT_OK(arrow::ipc::internal::json::ArrayFromJSON(
+      arrow::uint16(), "[0, 2, 5, 9, 11]", &selection));
+  ASSERT_NOT_OK(
+      aggr_result_iterator->ProcessAndCacheOne(input_batch->columns(), selection));
+
+  std::vector<std::string> input_data_2 = {"[8, 7, 1]", "[10, 20, 30]"};
+  MakeInputBatch(input_data_2, sch, &input_batch);
+  ASSERT_NOT_OK(aggr_result_iterator->ProcessAndCacheOne(input_batch->columns()));
+
+  ////////////////////// Finish //////////////////////////
+  // partitions are concatenated, so groups are compared regardless of order
+  std::map<int64_t, std::pair<int64_t, int64_t>> expected_groups = {
+      {1, {41, 3}}, {3, {15, 2}}, {7, {20, 1}}, {8, {10, 1}}};
+  std::pair<int64_t, int64_t> expected_null_group = {6, 1};
+  std::map<int64_t, std::pair<int64_t, int64_t>> result_groups;
+  std::pair<int64_t, int64_t> result_null_group = {0, 0};
+  std::shared_ptr<arrow::RecordBatch> result_batch;
+  while (aggr_result_iterator->HasNext()) {
+    ASSERT_NOT_OK(aggr_result_iterator->Next(&result_batch));
+    auto keys = std::dynamic_pointer_cast<arrow::Int64Array>(result_batch->column(0));
+    auto sums = std::dynamic_pointer_cast<arrow::Int64Array>(result_batch->column(1));
+    auto counts = std::dynamic_pointer_cast<arrow::Int64Array>(result_batch->column(2));
+    for (int i = 0; i < result_batch->num_rows(); i++) {
+      auto group = std::make_pair(sums->Value(i), counts->Value(i));
+      if (keys->IsNull(i)) {
+        result_null_group = group;
+      } else {
+        ASSERT_EQ(result_groups.count(keys->Value(i)), 0);
+        result_groups[keys->Value(i)] = group;
+      }
+    }
+  }
+  ASSERT_EQ(expected_groups, result_groups);
+  ASSERT_EQ(expected_null_group, result_null_group);
+}
+
+TEST(TestArrowComputeWSCG, WSCGTestApproxCountDistinctHashAggregate) {
+  ////////////////////// prepare partial expr_vector ///////////////////////
+  auto f0 = field("f0", int64());
+  auto f1 = field("f1", int64());
+  auto f_res = field("res", uint32());
+
+  auto arg0 = TreeExprBuilder::MakeField(f0);
+  auto arg1 = TreeExprBuilder::MakeField(f1);
+
+  auto n_groupby = TreeExprBuilder::MakeFunction("action_groupby", {arg0}, uint32());
+  auto n_hll_partial = TreeExprBuilder::MakeFunction(
+      "action_approx_count_distinct_partial_0.05", {arg1}, uint32());
+  auto n_proj =
+      TreeExprBuilder::MakeFunction("aggregateExpressions", {arg0, arg1}, uint32());
+  auto n_action = TreeExprBuilder::MakeFunction("aggregateActions",
+                                                {n_groupby, n_hll_partial}, uint32());
+  auto n_result = TreeExprBuilder::MakeFunction("resultSchema", {}, uint32());
+  auto n_result_expr = TreeExprBuilder::MakeFunction("resultExpressions", {}, uint32());
+  auto n_aggr = TreeExprBuilder::MakeFunction(
+      "hashAggregateArrays", {n_proj, n_action, n_result, n_result_expr}, uint32());
+  auto n_child = TreeExprBuilder::MakeFunction("child", {n_aggr}, uint32());
+  auto n_wscg = TreeExprBuilder::MakeFunction("wholestagecodegen", {n_child}, uint32());
+  auto aggr_expr = TreeExprBuilder::MakeExpression(n_wscg, f_res);
+
+  // relative sd 0.05 uses 2^9 registers packed into 52 words, as Spark does
+  int num_words = 52;
+  auto sch = arrow::schema({f0, f1});
+  std::vector<std::shared_ptr<Field>> partial_ret_types = {field("unique", int64())};
+  for (int i = 0; i < num_words; i++) {
+    partial_ret_types.push_back(field("MS[" + std::to_string(i) + "]", int64()));
+  }
+
+  ////////////////////// prepare final expr_vector ///////////////////////
+  std::vector<gandiva::NodePtr> final_args;
+  for (auto f : partial_ret_types) {
+    final_args.push_back(TreeExprBuilder::MakeField(f));
+  }
+  auto n_final_groupby =
+      TreeExprBuilder::MakeFunction("action_groupby", {final_args[0]}, uint32());
+  auto n_hll_final = TreeExprBuilder::MakeFunction(
+      "action_approx_count_distinct_final_0.05",
+      std::vector<gandiva::NodePtr>(final_args.begin() + 1, final_args.end()), uint32());
+  auto n_final_proj =
+      TreeExprBuilder::MakeFunction("aggregateExpressions", final_args, uint32());
+  auto n_final_action = TreeExprBuilder::MakeFunction(
+      "aggregateActions", {n_final_groupby, n_hll_final}, uint32());
+  auto n_final_aggr = TreeExprBuilder::MakeFunction(
+      "hashAggregateArrays", {n_final_proj, n_final_action, n_result, n_result_expr},
+      uint32());
+  auto n_final_child = TreeExprBuilder::MakeFunction("child", {n_final_aggr}, uint32());
+  auto n_final_wscg =
+      TreeExprBuilder::MakeFunction("wholestagecodegen", {n_final_child}, uint32());
+  auto final_aggr_expr = TreeExprBuilder::MakeExpression(n_final_wscg, f_res);
+
+  auto final_sch = arrow::schema(partial_ret_types);
+  std::vector<std::shared_ptr<Field>> ret_types = {field("unique", int64()),
+                                                   field("approx_count", int64())};
+
+  /////////////////////// Create Expression Evaluator ////////////////////
+  arrow::compute::FunctionContext ctx;
+  std::shared_ptr<CodeGenerator> final_expr;
+  ASSERT_NOT_OK(CreateCodeGenerator(ctx.memory_pool(), final_sch, {final_aggr_expr},
+                                    ret_types, &final_expr, true));
+  std::shared_ptr<ResultIteratorBase> final_result_iterator_base;
+  ASSERT_NOT_OK(final_expr->finish(&final_result_iterator_base));
+  auto final_result_iterator =
+      std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+          final_result_iterator_base);
+
+  ////////////////////// calculation /////////////////////
+  // each input batch is pre-aggregated by its own partial aggregation, and the
+  // sketches of the same key are merged by final aggregation
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+  std::vector<std::vector<std::string>> input_data_list = {
+      {"[1, 2, 1, 3, 2]", "[10, 5, 20, 40, null]"},
+      {"[1, 2, 1, 4]", "[10, 5, 30, null]"}};
+  for (auto input_data : input_data_list) {
+    std::shared_ptr<CodeGenerator> expr;
+    ASSERT_NOT_OK(CreateCodeGenerator(ctx.memory_pool(), sch, {aggr_expr},
+                                      partial_ret_types, &expr, true));
+    std::shared_ptr<ResultIteratorBase> aggr_result_iterator_base;
+    ASSERT_NOT_OK(expr->finish(&aggr_result_iterator_base));
+    auto aggr_result_iterator =
+        std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+            aggr_result_iterator_base);
+    MakeInputBatch(input_data, sch, &input_batch);
+    ASSERT_NOT_OK(aggr_result_iterator->ProcessAndCacheOne(input_batch->columns()));
+    while (aggr_result_iterator->HasNext()) {
+      std::shared_ptr<arrow::RecordBatch> partial_batch;
+      ASSERT_NOT_OK(aggr_result_iterator->Next(&partial_batch));
+      ASSERT_EQ(partial_batch->num_columns(), num_words + 1);
+      ASSERT_NOT_OK(final_result_iterator->ProcessAndCacheOne(partial_batch->columns()));
+    }
+  }
+
+  ////////////////////// Finish //////////////////////////
+  std::shared_ptr<arrow::RecordBatch> result_batch;
+  std::shared_ptr<arrow::RecordBatch> expected_result;
+  std::vector<std::string> expected_result_string = {"[1, 2, 3, 4]", "[3, 1, 1, 0]"};
+  MakeInputBatch(expected_result_string, arrow::schema(ret_types), &expected_result);
+  ASSERT_TRUE(final_result_iterator->HasNext());
+  ASSERT_NOT_OK(final_result_iterator->Next(&result_batch));
+  ASSERT_NOT_OK(Equals(*expected_result.get(), *result_batch.get()));
+}
+
+TEST(TestArrowComputeWSCG, WSCGTestDistinctHashAggregateWithSpill) {
+  // distinct values are spilled on every insert with a 1 byte budget, and every
+  // partition is split again while it is folded
+  ScopedEnv budget("NATIVESQL_AGGR_DISTINCT_MEMORY_BUDGET", "1");
+  ////////////////////// prepare expr_vector ///////////////////////
+  auto f0 = field("f0", int64());
+  auto f1 = field("f1", int64());
+  auto f2 = field("f2", utf8());
+
+  auto f_unique = field("unique", int64());
+  auto f_count_distinct = field("count_distinct", int64());
+  auto f_sum_distinct = field("sum_distinct", int64());
+  auto f_count_distinct_str = field("count_distinct_str", int64());
+  auto f_res = field("res", uint32());
+
+  auto arg0 = TreeExprBuilder::MakeField(f0);
+  auto arg1 = TreeExprBuilder::MakeField(f1);
+  auto arg2 = TreeExprBuilder::MakeField(f2);
+
+  auto n_groupby = TreeExprBuilder::MakeFunction("action_groupby", {arg0}, uint32());
+  auto n_count_distinct =
+      TreeExprBuilder::MakeFunction("action_count_distinct", {arg1}, uint32());
+  auto n_sum_distinct =
+      TreeExprBuilder::MakeFunction("action_sum_distinct", {arg1}, uint32());
+  auto n_count_distinct_str =
+      TreeExprBuilder::MakeFunction("action_count_distinct", {arg2}, uint32());
+  auto n_proj =
+      TreeExprBuilder::MakeFunction("aggregateExpressions", {arg0, arg1, arg2}, uint32());
+  auto n_action = TreeExprBuilder::MakeFunction(
+      "aggregateActions",
+      {n_groupby, n_count_distinct, n_sum_distinct, n_count_distinct_str}, uint32());
+  auto n_result = TreeExprBuilder::MakeFunction("resultSchema", {}, uint32());
+  auto n_result_expr = TreeExprBuilder::MakeFunction("resultExpressions", {}, uint32());
+
+  auto n_aggr = TreeExprBuilder::MakeFunction(
+      "hashAggregateArrays", {n_proj, n_action, n_result, n_result_expr}, uint32());
+  auto n_child = TreeExprBuilder::MakeFunction("child", {n_aggr}, uint32());
+  auto n_wscg = TreeExprBuilder::MakeFunction("wholestagecodegen", {n_child}, uint32());
+  auto aggr_expr = TreeExprBuilder::MakeExpression(n_wscg, f_res);
+
+  std::vector<std::shared_ptr<::gandiva::Expression>> expr_vector = {aggr_expr};
+
+  auto sch = arrow::schema({f0, f1, f2});
+  std::vector<std::shared_ptr<Field>> ret_types = {
+      f_unique, f_count_distinct, f_sum_distinct, f_count_distinct_str};
+
+  /////////////////////// Create Expression Evaluator ////////////////////
+  std::shared_ptr<CodeGenerator> expr;
+  arrow::compute::FunctionContext ctx;
+  ASSERT_NOT_OK(
+      CreateCodeGenerator(ctx.memory_pool(), sch, expr_vector, ret_types, &expr, true));
+  std::shared_ptr<arrow::RecordBatch> input_batch;
+
+  std::shared_ptr<ResultIterator<arrow::RecordBatch>> aggr_result_iterator;
+  std::shared_ptr<ResultIteratorBase> aggr_result_iterator_base;
+  ASSERT_NOT_OK(expr->finish(&aggr_result_iterator_base));
+  aggr_result_iterator = std::dynamic_pointer_cast<ResultIterator<arrow::RecordBatch>>(
+      aggr_result_iterator_base);
+
+  ////////////////////// calculation /////////////////////
+  std::vector<std::string> input_data = {"[1, 2, 1, 3, 1]", "[10, 5, 10, null, 20]",
+                                         R"(["a", "b", "a", null, "c"])"};
+  MakeInputBatch(input_data, sch, &input_batch);
+  ASSERT_NOT_OK(aggr_result_iterator->ProcessAndCacheOne(input_batch->columns()));
+
+  std::vector<std::string> input_data_2 = {"[2, 1, 3, 2]", "[5, 30, null, 6]",
+                                           R"(["b", "a", null, "d"])"};
+  MakeInputBatch(input_data_2, sch, &input_batch);
+  ASSERT_NOT_OK(aggr_result_iterator->ProcessAndCacheOne(input_batch->columns()));
+
+  ////////////////////// Finish //////////////////////////
+  std::shared_ptr<arrow::RecordBatch> result_batch;
+  std::shared_ptr<arrow::RecordBatch> expected_result;
+  std::vector<std::string> expected_result_string = {"[1, 2, 3]", "[3, 2, 0]",
+                                                     "[60, 11, null]", "[2, 2, 0]"};
+  auto res_sch = arrow::schema(ret_types);
+  MakeInputBatch(expected_result_string, res_sch, &expected_result);
+  ASSERT_TRUE(aggr_result_iterator->HasNext());
+  ASSERT_NOT_OK(aggr_result_iterator->Next(&result_batch));
+  ASSERT_NOT_OK(Equals(*expected_result.get(), *result_batch.get()));
+}
+
 TEST(TestArrowComputeWSCG, WSCGTestInnerJoinWithGroupbyAggregate) {
   ////////////////////// prepare expr_vector ///////////////////////
   auto table0_f0 = field("table0_f0", uint32());
@@ -25,9 +25,11 @@
 #include <arrow/type.h>
 #include <gandiva/node.h>
 #include <gandiva/tree_expr_builder.h>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
 #include <sstream>
+#include <string>
 #include "utils/macros.h"
 using namespace arrow;
 
@@ -58,6 +60,36 @@ using FunctionNode = gandiva::FunctionNode;
   ARROW_ASSIGN_OR_THROW_IMPL(ARROW_ASSIGN_OR_THROW_NAME(_error_or_value, __COUNTER__), \
                              lhs, rexpr);
 
+/* Sets an environment variable until the end of the scope, so the previous value is
+ * restored even if an assertion fails first */
+class ScopedEnv {
+ public:
+  ScopedEnv(const std::string& name, const std::string& value) : name_(name) {
+    auto old_value = std::getenv(name.c_str());
+    if (old_value != nullptr) {
+      has_old_value_ = true;
+      old_value_ = old_value;
+    }
+    setenv(name.c_str(), value.c_str(), 1);
+  }
+
+  ~ScopedEnv() {
+    if (has_old_value_) {
+      setenv(name_.c_str(), old_value_.c_str(), 1);
+    } else {
+      unsetenv(name_.c_str());
+    }
+  }
+
+  ScopedEnv(const ScopedEnv&) = delete;
+  ScopedEnv& operator=(const ScopedEnv&) = delete;
+
+ private:
+  std::string name_;
+  bool has_old_value_ = false;
+  std::string old_value_;
+};
+
 template <typename T>
 Status Equals(const T& expected, const T& actual) {
   if (expected.Equals(actual)) {
@@ -123,15 +123,23 @@ static inline unsafeHashMap* createUnsafeHashMap(arrow::MemoryPool* pool,
                                                  int initialHashCapacity,
                                                  int keySize = -1) {
   unsafeHashMap* hashMap;
-  pool->Allocate(sizeof(unsafeHashMap), (uint8_t**)&hashMap);
+  if (!pool->Allocate(sizeof(unsafeHashMap), (uint8_t**)&hashMap).ok()) return NULL;
   uint8_t bytesInKeyArray = (keySize == -1) ? 8 : 8 + keySize;
   hashMap->bytesInKeyArray = bytesInKeyArray;
-  pool->Allocate(initArrayCapacity * bytesInKeyArray, (uint8_t**)&hashMap->keyArray);
+  if (!pool->Allocate(initArrayCapacity * bytesInKeyArray, (uint8_t**)&hashMap->keyArray)
+           .ok()) {
+    pool->Free((uint8_t*)hashMap, sizeof(unsafeHashMap));
+    return NULL;
+  }
   hashMap->arrayCapacity = initArrayCapacity;
   memset(hashMap->keyArray, -1, initArrayCapacity * bytesInKeyArray);
 
   // hashMap->bytesMap = (char*)nativeMalloc(initialHashCapacity, MEMTYPE_HASHMAP);
-  pool->Allocate(initialHashCapacity, (uint8_t**)&hashMap->bytesMap);
+  if (!pool->Allocate(initialHashCapacity, (uint8_t**)&hashMap->bytesMap).ok()) {
+    pool->Free((uint8_t*)hashMap->keyArray, initArrayCapacity * bytesInKeyArray);
+    pool->Free((uint8_t*)hashMap, sizeof(unsafeHashMap));
+    return NULL;
+  }
   hashMap->mapSize = initialHashCapacity;
 
   hashMap->cursor = 0;
@@ -244,15 +252,16 @@ static inline bool growAndRehashKeyArray(unsafeHashMap* hashMap) {
   int keySizeInBytes = hashMap->bytesInKeyArray;
   if (keySizeInBytes > 8) {
     // Rehash the map
+    // offset first bit is used as bytesMap offset flag here, so only -1 is empty
     for (int pos = 0; pos < oldCapacity; pos++) {
       int keyOffset = *(int*)(origKeyArray + pos * keySizeInBytes);
       int hashcode = *(int*)(origKeyArray + pos * keySizeInBytes + 4);
 
-      if (keyOffset < 0) continue;
+      if (keyOffset == -1) continue;
 
       int newPos = hashcode & mask;
       int step = 1;
-      while (*(int*)(hashMap->keyArray + newPos * keySizeInBytes) >= 0) {
+      while (*(int*)(hashMap->keyArray + newPos * keySizeInBytes) != -1) {
         newPos = (newPos + step) & mask;
         step++;
       }
@@ -851,3 +860,90 @@ static inline bool append(unsafeHashMap* hashMap, const char* keyRow, size_t key
 
   return true;
 }
+
+/**
+ * mergeIntoHashMap is used to combine sub hashMaps which are built from disjoint key
+ * sets (e.g. partitioned by hash bits), so no key comparison is needed here.
+ * src bytesMap is appended to dst bytesMap, all bytesMap offsets are relocated and
+ * src keyArray slots are re-placed into dst keyArray.
+ *
+ * return should be a flag of succession of the merge.
+ **/
+static inline bool mergeIntoHashMap(unsafeHashMap* dst, unsafeHashMap* src) {
+  assert(dst->keyArray != NULL && src->keyArray != NULL);
+  assert(dst->bytesInKeyArray == src->bytesInKeyArray);
+
+  while (dst->cursor + src->cursor >= dst->mapSize) {
+    if (!growHashBytesMap(dst)) return false;
+  }
+  while ((dst->numKeys + src->numKeys) > (int)(dst->arrayCapacity * loadFactor) &&
+         dst->arrayCapacity < MAX_HASH_MAP_CAPACITY) {
+    if (!growAndRehashKeyArray(dst)) return false;
+  }
+
+  // copy bytesMap and relocate next ptr of each record
+  const int base = dst->cursor;
+  char* dstBytesMap = dst->bytesMap + base;
+  memcpy(dstBytesMap, src->bytesMap, src->cursor);
+  int pos = 0;
+  while (pos < src->cursor) {
+    char* record = dstBytesMap + pos;
+    int totalLength = getTotalLength(record);
+    int* nextOffset = (int*)(record + totalLength - 4);
+    if (*nextOffset != 0) *nextOffset += base;
+    pos += totalLength;
+  }
+  dst->cursor += src->cursor;
+
+  // re-place keyArray slots
+  const int keySizeInBytes = dst->bytesInKeyArray;
+  const int mask = dst->arrayCapacity - 1;
+  char* srcKeyArrayBase = src->keyArray;
+  char* dstKeyArrayBase = dst->keyArray;
+  for (int i = 0; i < src->arrayCapacity; i++) {
+    char* srcSlot = srcKeyArrayBase + i * keySizeInBytes;
+    int KeyAddressOffset = *(int*)srcSlot;
+    int hashVal = *(int*)(srcSlot + 4);
+    if (keySizeInBytes > 8) {
+      // key is stored in keyArray, offset first bit indicates bytesMap offset
+      if (KeyAddressOffset == -1) continue;
+      if ((KeyAddressOffset >> 31) != 0) {
+        KeyAddressOffset = ((KeyAddressOffset & 0x7FFFFFFF) + base) | 0x80000000;
+      }
+    } else {
+      if (KeyAddressOffset < 0) continue;
+      KeyAddressOffset += base;
+    }
+
+    int newPos = hashVal & mask;
+    int step = 1;
+    while (*(int*)(dstKeyArrayBase + newPos * keySizeInBytes) != -1) {
+      newPos = (newPos + step) & mask;
+      step++;
+    }
+    char* dstSlot = dstKeyArrayBase + newPos * keySizeInBytes;
+    memcpy(dstSlot, srcSlot, keySizeInBytes);
+    *(int*)dstSlot = KeyAddressOffset;
+  }
+  dst->numKeys += src->numKeys;
+  return true;
+}
+
+/**
+ * cloneHashMap copies src into a new hashMap allocated from pool, slots and bytesMap
+ * offsets are kept as is so no rehash is needed. Used to hand a hashMap over to an
+ * owner living longer than the pool it was built from. Returns NULL if pool is out of
+ * memory.
+ **/
+static inline unsafeHashMap* cloneHashMap(arrow::MemoryPool* pool, unsafeHashMap* src) {
+  assert(src->keyArray != NULL);
+  int keySize = (src->bytesInKeyArray == 8) ? -1 : (src->bytesInKeyArray - 8);
+  int mapSize = src->cursor > 0 ? src->cursor : 8;
+  unsafeHashMap* dst = createUnsafeHashMap(pool, src->arrayCapacity, mapSize, keySize);
+  if (dst == NULL) return NULL;
+  memcpy(dst->keyArray, src->keyArray, src->arrayCapacity * src->bytesInKeyArray);
+  memcpy(dst->bytesMap, src->bytesMap, src->cursor);
+  dst->cursor = src->cursor;
+  dst->numKeys = src->numKeys;
+  return dst;
+}